@@ -359,3 +359,83 @@ kernel void DecodeCMPR_RGBA(global uchar *dst,
     decodeCMPRBlock_RGBA(dst + 16 * width, src, width); src += 8;
     decodeCMPRBlock_RGBA(dst + 16 * (width + 1), src, width);
 }
+
+// Palette entries are big endian, tlutfmt is 0 = IA8, 1 = RGB565, 2 = RGB5A3.
+uint DecodePaletteRGBA(const global uchar *tlut, uint index, int tlutfmt)
+{
+    uint val = (uint)(tlut[index * 2]) << 8 | tlut[index * 2 + 1];
+    uint r, g, b, a;
+    if (tlutfmt == 0)
+    {
+        a = val >> 8;
+        r = g = b = val & 0xFF;
+    }
+    else if (tlutfmt == 1)
+    {
+        r = val >> 11 & 0x1F; r = r << 3 | r >> 2;
+        g = val >> 5 & 0x3F;  g = g << 2 | g >> 4;
+        b = val & 0x1F;       b = b << 3 | b >> 2;
+        a = 0xFF;
+    }
+    else if (val & 0x8000)
+    {
+        r = val >> 10 & 0x1F; r = r << 3 | r >> 2;
+        g = val >> 5 & 0x1F;  g = g << 3 | g >> 2;
+        b = val & 0x1F;       b = b << 3 | b >> 2;
+        a = 0xFF;
+    }
+    else
+    {
+        a = val >> 12 & 0x7;  a = a << 5 | a << 2 | a >> 1;
+        r = val >> 8 & 0xF;   r = r << 4 | r;
+        g = val >> 4 & 0xF;   g = g << 4 | g;
+        b = val & 0xF;        b = b << 4 | b;
+    }
+    return r | g << 8 | b << 16 | a << 24;
+}
+
+kernel void DecodeC4_RGBA(global uint *dst,
+                          const global uchar *src, int width,
+                          const global uchar *tlut, int tlutfmt)
+{
+    int x = get_global_id(0) * 8, y = get_global_id(1) * 8;
+    int srcOffset = (x * 8 + y * width) / 2;
+    for (int iy = 0; iy < 8; iy++)
+    {
+        for (int ix = 0; ix < 4; ix++)
+        {
+            uchar val = src[srcOffset++];
+            dst[(y + iy) * width + x + ix * 2] = DecodePaletteRGBA(tlut, val >> 4, tlutfmt);
+            dst[(y + iy) * width + x + ix * 2 + 1] = DecodePaletteRGBA(tlut, val & 0xF, tlutfmt);
+        }
+    }
+}
+
+kernel void DecodeC8_RGBA(global uint *dst,
+                          const global uchar *src, int width,
+                          const global uchar *tlut, int tlutfmt)
+{
+    int x = get_global_id(0) * 8, y = get_global_id(1) * 4;
+    int srcOffset = x * 4 + y * width;
+    for (int iy = 0; iy < 4; iy++)
+    {
+        for (int ix = 0; ix < 8; ix++)
+            dst[(y + iy) * width + x + ix] = DecodePaletteRGBA(tlut, src[srcOffset++], tlutfmt);
+    }
+}
+
+kernel void DecodeC14X2_RGBA(global uint *dst,
+                             const global uchar *src, int width,
+                             const global uchar *tlut, int tlutfmt)
+{
+    int x = get_global_id(0) * 4, y = get_global_id(1) * 4;
+    int srcOffset = (x * 4 + y * width) * 2;
+    for (int iy = 0; iy < 4; iy++)
+    {
+        for (int ix = 0; ix < 4; ix++, srcOffset += 2)
+        {
+            uint index = ((uint)(src[srcOffset]) << 8 | src[srcOffset + 1]) & 0x3FFF;
+            dst[(y + iy) * width + x + ix] = DecodePaletteRGBA(tlut, index, tlutfmt);
+        }
+    }
+}
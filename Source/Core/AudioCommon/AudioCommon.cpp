@@ -98,6 +98,15 @@ void ShutdownSoundStream()
   {
     g_sound_stream->Stop();
 
+    CMixer::FifoStats dma, streaming, wiimote_speaker;
+    g_sound_stream->GetMixer()->GetFifoStats(&dma, &streaming, &wiimote_speaker);
+    INFO_LOG(AUDIO, "Mixer FIFO underruns/overruns: DMA %llu/%llu, streaming %llu/%llu, "
+                    "Wiimote speaker %llu/%llu",
+             (unsigned long long)dma.underruns, (unsigned long long)dma.overruns,
+             (unsigned long long)streaming.underruns, (unsigned long long)streaming.overruns,
+             (unsigned long long)wiimote_speaker.underruns,
+             (unsigned long long)wiimote_speaker.overruns);
+
     if (SConfig::GetInstance().m_DumpAudio && s_audio_dump_start)
       StopAudioDump();
 
@@ -257,4 +266,14 @@ void ToggleMuteVolume()
   isMuted = !isMuted;
   UpdateSoundStream();
 }
+
+bool GetMeasuredLatency(float* mixer_ms, float* output_ms)
+{
+  if (!g_sound_stream)
+    return false;
+
+  *mixer_ms = g_sound_stream->GetMixer()->GetBufferedLatency();
+  *output_ms = g_sound_stream->GetOutputLatency();
+  return true;
+}
 }
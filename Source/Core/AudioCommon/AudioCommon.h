@@ -29,4 +29,7 @@ void StopAudioDump();
 void IncreaseVolume(unsigned short offset);
 void DecreaseVolume(unsigned short offset);
 void ToggleMuteVolume();
+// Measured latency of the audio output in ms, split into what is queued in
+// the mixer and what is queued in the backend. Returns false without a stream.
+bool GetMeasuredLatency(float* mixer_ms, float* output_ms);
 }
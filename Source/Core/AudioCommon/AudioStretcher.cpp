@@ -0,0 +1,87 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+
+#include "AudioCommon/AudioStretcher.h"
+#include "Common/MathUtil.h"
+#include "Core/ConfigManager.h"
+
+// Time constants of the stretch ratio and target latency filters, in seconds
+static constexpr double RATIO_TIME_SCALE = 1.0;
+static constexpr double LATENCY_TIME_SCALE = 10.0;
+// Underruns can raise the target latency up to this many times the setting
+static constexpr double MAX_LATENCY_FACTOR = 4.0;
+
+AudioStretcher::AudioStretcher(u32 sample_rate) : m_sample_rate(sample_rate)
+{
+	m_sound_touch.setChannels(2);
+	m_sound_touch.setSampleRate(sample_rate);
+	m_sound_touch.setPitch(1.0);
+	m_sound_touch.setTempo(1.0);
+	m_sound_touch.setSetting(SETTING_USE_QUICKSEEK, 0);
+	m_sound_touch.setSetting(SETTING_USE_AA_FILTER, 1);
+}
+
+void AudioStretcher::Clear()
+{
+	m_sound_touch.clear();
+	m_stretch_ratio = 1.0;
+	m_latency_ms = 0.0;
+	m_last_sample.fill(0.0f);
+}
+
+void AudioStretcher::ProcessSamples(const float* in, u32 num_in, u32 num_out)
+{
+	const double min_latency_ms = std::max(SConfig::GetInstance().iTimeStretchLatency, 1);
+	const double time_delta = static_cast<double>(num_out) / m_sample_rate;
+
+	// Let the target latency decay back to the setting while nothing underruns
+	const double latency_gain = 1.0 - std::exp(-time_delta / LATENCY_TIME_SCALE);
+	m_latency_ms = MathUtil::Clamp(m_latency_ms - latency_gain * (m_latency_ms - min_latency_ms),
+		min_latency_ms, min_latency_ms * MAX_LATENCY_FACTOR);
+
+	// We were given num_in samples for num_out requested ones. Nudge that
+	// ratio so the backlog settles at the target latency.
+	double current_ratio = num_out ? static_cast<double>(num_in) / num_out : 1.0;
+	const double target_backlog = m_sample_rate * m_latency_ms / 1000.0;
+	const double backlog_fullness = m_sound_touch.numSamples() / target_backlog;
+	if (backlog_fullness > 5.0)
+		current_ratio = 4.0;  // Way behind, just catch up
+	else
+		current_ratio *= MathUtil::Clamp(1.0 + 0.25 * (backlog_fullness - 1.0), 0.5, 2.0);
+
+	// Smooth the ratio out so tempo changes don't wobble. The 10% floor keeps
+	// the silence while a game boots from being stretched without end.
+	const double ratio_gain = 1.0 - std::exp(-time_delta / RATIO_TIME_SCALE);
+	m_stretch_ratio += ratio_gain * (current_ratio - m_stretch_ratio);
+	m_stretch_ratio = std::max(m_stretch_ratio, 0.1);
+
+	m_sound_touch.setTempo(m_stretch_ratio);
+	if (num_in)
+		m_sound_touch.putSamples(in, num_in);
+}
+
+void AudioStretcher::GetStretchedSamples(float* out, u32 num_out)
+{
+	const u32 received = m_sound_touch.receiveSamples(out, num_out);
+	if (received)
+	{
+		m_last_sample[0] = out[received * 2 - 2];
+		m_last_sample[1] = out[received * 2 - 1];
+	}
+
+	if (received < num_out)
+	{
+		// Underrun: hold the last sample and aim for more latency
+		for (u32 i = received; i < num_out; ++i)
+		{
+			out[i * 2] = m_last_sample[0];
+			out[i * 2 + 1] = m_last_sample[1];
+		}
+		const double min_latency_ms = std::max(SConfig::GetInstance().iTimeStretchLatency, 1);
+		m_latency_ms = std::min(m_latency_ms * 1.5, min_latency_ms * MAX_LATENCY_FACTOR);
+	}
+}
@@ -0,0 +1,58 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+
+#ifdef __APPLE__
+// Avoid conflict with objc.h (on Windows, ST uses the system BOOL type, so this doesn't work)
+#define BOOL SoundTouch_BOOL
+#endif
+#include <soundtouch/SoundTouch.h>
+#ifdef __APPLE__
+#undef BOOL
+#endif
+
+#include "Common/CommonTypes.h"
+
+// Time stretching stage of the mixer. Audio is mixed at the rate it is
+// emulated and stretched to the rate the backend plays it at, so slowdowns
+// change the tempo instead of the pitch.
+//
+// The stretcher keeps a backlog of stretched samples around the configured
+// latency. Underruns raise the latency it aims for, which then decays back to
+// the configured value while playback is smooth.
+class AudioStretcher
+{
+public:
+	explicit AudioStretcher(u32 sample_rate);
+
+	// Adds num_in stereo samples, num_out is the number of samples about to be
+	// requested from GetStretchedSamples.
+	void ProcessSamples(const float* in, u32 num_in, u32 num_out);
+	// Gets num_out stretched stereo samples, repeating the last one if the
+	// backlog runs dry.
+	void GetStretchedSamples(float* out, u32 num_out);
+	void Clear();
+
+	// Latency currently aimed for, in ms.
+	double GetTargetLatency() const
+	{
+		return m_latency_ms;
+	}
+	// Samples held back by SoundTouch, including the ones still being
+	// processed.
+	u32 GetBufferedSamples() const
+	{
+		return m_sound_touch.numSamples() + m_sound_touch.numUnprocessedSamples();
+	}
+
+private:
+	u32 m_sample_rate;
+	soundtouch::SoundTouch m_sound_touch;
+	double m_stretch_ratio = 1.0;
+	double m_latency_ms = 0.0;
+	std::array<float, 2> m_last_sample{};
+};
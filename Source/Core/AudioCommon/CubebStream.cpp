@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include <cubeb/cubeb.h>
 
 #include "AudioCommon/CubebStream.h"
@@ -41,8 +43,17 @@ bool CubebStream::Start()
   params.format = CUBEB_SAMPLE_S16NE;
   params.layout = CUBEB_LAYOUT_STEREO;
 
+  // Cubeb can't resize the buffer of a running stream, underruns are taken up
+  // by the mixer when time stretching
+  u32 minimum_latency = 0;
+  if (cubeb_get_min_latency(m_ctx.get(), &params, &minimum_latency) != CUBEB_OK)
+    ERROR_LOG(AUDIO, "Error getting minimum latency");
+  const u32 latency =
+      std::max(minimum_latency, SConfig::GetInstance().iLatency * params.rate / 1000);
+  INFO_LOG(AUDIO, "Latency: %u frames", latency);
+
   if (cubeb_stream_init(m_ctx.get(), &m_stream, "Dolphin Audio Output", nullptr, nullptr, nullptr,
-                        &params, 1, DataCallback,
+                        &params, latency, DataCallback,
                         StateCallback, this) != CUBEB_OK)
   {
     ERROR_LOG(AUDIO, "Error initializing cubeb stream");
@@ -72,6 +83,14 @@ void CubebStream::Stop()
   m_ctx.reset();
 }
 
+float CubebStream::GetOutputLatency()
+{
+  u32 latency = 0;
+  if (!m_stream || cubeb_stream_get_latency(m_stream, &latency) != CUBEB_OK)
+    return 0.f;
+  return latency * 1000.f / m_mixer->GetSampleRate();
+}
+
 void CubebStream::SetVolume(int volume)
 {
   cubeb_stream_set_volume(m_stream, volume / 100.0f);
@@ -18,6 +18,7 @@ public:
   bool Start() override;
   void Stop() override;
   void SetVolume(int) override;
+  float GetOutputLatency() override;
 
 private:
   std::shared_ptr<cubeb> m_ctx;
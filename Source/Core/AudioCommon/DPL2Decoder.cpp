@@ -18,6 +18,12 @@
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
 
+#if defined(_M_X86)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -33,56 +39,44 @@ static float l_fwr, r_fwr, lpr_fwr, lmr_fwr;
 static std::vector<float> fwrbuf_l, fwrbuf_r;
 static float adapt_l_gain, adapt_r_gain, adapt_lpr_gain, adapt_lmr_gain;
 static std::vector<float> lf, rf, lr, rr, cf, cr;
-static float LFE_buf[256];
+static const unsigned int LFE_FILTER_LENGTH = 256;
+// The LFE history is stored twice in a row, so the filter window starting at
+// lfe_pos is always contiguous and the FIR needs no wrap around
+static float LFE_buf[LFE_FILTER_LENGTH * 2];
 static unsigned int lfe_pos;
 static float *filter_coefs_lfe;
 static unsigned int len125;
 
-template<class T, class _ftype_t>
-static _ftype_t DotProduct(int count, const T *buf, const _ftype_t *coefficients)
+static float DotProduct(int count, const float *buf, const float *coefficients)
 {
-	int i;
-	float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+	int i = 0;
+	float sum = 0.0f;
 
-	// Unrolled loop
-	for (i = 0; (i + 3) < count; i += 4)
+#if defined(_M_X86)
+	__m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+	for (; i + 8 <= count; i += 8)
 	{
-		sum0 += buf[i + 0] * coefficients[i + 0];
-		sum1 += buf[i + 1] * coefficients[i + 1];
-		sum2 += buf[i + 2] * coefficients[i + 2];
-		sum3 += buf[i + 3] * coefficients[i + 3];
+		sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(buf + i), _mm_loadu_ps(coefficients + i)));
+		sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(buf + i + 4), _mm_loadu_ps(coefficients + i + 4)));
 	}
-
-	// Epilogue of unrolled loop
-	for (; i < count; i++)
-		sum0 += buf[i] * coefficients[i];
-
-	return sum0 + sum1 + sum2 + sum3;
-}
-
-template<class T>
-static T FIRFilter(const T *buf, int pos, int len, int count, const float *coefficients)
-{
-	int count1, count2;
-
-	if (pos >= count)
-	{
-		pos -= count;
-		count1 = count; count2 = 0;
-	}
-	else
+	sum0 = _mm_add_ps(sum0, sum1);
+	sum0 = _mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0));
+	sum0 = _mm_add_ss(sum0, _mm_shuffle_ps(sum0, sum0, 1));
+	sum = _mm_cvtss_f32(sum0);
+#elif defined(_M_ARM_64)
+	float32x4_t sum0 = vdupq_n_f32(0.0f), sum1 = vdupq_n_f32(0.0f);
+	for (; i + 8 <= count; i += 8)
 	{
-		count2 = pos;
-		count1 = count - pos;
-		pos = len - count1;
+		sum0 = vfmaq_f32(sum0, vld1q_f32(buf + i), vld1q_f32(coefficients + i));
+		sum1 = vfmaq_f32(sum1, vld1q_f32(buf + i + 4), vld1q_f32(coefficients + i + 4));
 	}
+	sum = vaddvq_f32(vaddq_f32(sum0, sum1));
+#endif
 
-	// high part of window
-	const T *ptr = &buf[pos];
+	for (; i < count; i++)
+		sum += buf[i] * coefficients[i];
 
-	float r1 = DotProduct(count1, ptr, coefficients); coefficients += count1;
-	float r2 = DotProduct(count2, buf, coefficients);
-	return T(r1 + r2);
+	return sum;
 }
 
 /*
@@ -206,7 +200,7 @@ static void Done()
 
 static float* CalculateCoefficients125HzLowpass(int rate)
 {
-	len125 = 256;
+	len125 = LFE_FILTER_LENGTH;
 	float f = 125.0f / (rate / 2);
 	float *coeffs = DesignFIR(&len125, &f, 0);
 	static const float M3_01DB = 0.7071067812f;
@@ -367,8 +361,8 @@ void DPL2Decode(float *samples, int numsamples, float *out)
 		out[cur + 0] = lf[k];
 		out[cur + 1] = rf[k];
 		out[cur + 2] = cf[k];
-		LFE_buf[lfe_pos] = (lf[k] + rf[k] + 2.0f * cf[k] + lr[k] + rr[k]) / 2.0f;
-		out[cur + 3] = FIRFilter(LFE_buf, lfe_pos, len125, len125, filter_coefs_lfe);
+		LFE_buf[lfe_pos] = LFE_buf[lfe_pos + len125] = (lf[k] + rf[k] + 2.0f * cf[k] + lr[k] + rr[k]) / 2.0f;
+		out[cur + 3] = DotProduct(len125, &LFE_buf[lfe_pos], filter_coefs_lfe);
 		lfe_pos++;
 		if (lfe_pos == len125)
 		{
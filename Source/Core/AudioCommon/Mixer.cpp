@@ -4,15 +4,23 @@
 // Modified For Ishiiruka By Tino
 
 #include "AudioCommon/AudioCommon.h"
+#include "AudioCommon/AudioStretcher.h"
 #include "AudioCommon/Mixer.h"
 #include "Common/Atomic.h"
 #include "Common/CPUDetect.h"
 #include "Common/MathUtil.h"
+#include "Common/TraceEvents.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/VideoInterface.h"
 
+#if defined(_M_X86)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -29,10 +37,16 @@ CMixer::CMixer(u32 BackendSampleRate)
 	, m_log_dtk_audio(0)
 	, m_log_dsp_audio(0)
 	, m_speed(0)
+	, m_buffered_latency(0)
+	, m_stretcher(std::make_unique<AudioStretcher>(BackendSampleRate))
 {
 	INFO_LOG(AUDIO_INTERFACE, "Mixer is initialized");
 }
 
+CMixer::~CMixer()
+{
+}
+
 void CMixer::LinearMixerFifo::Interpolate(u32 left_input_index, float* left_output, float* right_output)
 {
 	*left_output = (1 - m_fraction) * m_float_buffer[left_input_index & INDEX_MASK]
@@ -74,20 +88,21 @@ void CMixer::MixerFifo::Mix(float* samples, u32 numSamples, bool consider_framel
 {
 	u32 current_sample = 0;
 	// Cache access in non-volatile variable so interpolation loop can be optimized
-	u32 read_index = m_read_index.load();
-	const u32 write_index = m_write_index.load();
+	u32 read_index = m_read_index.load(std::memory_order_relaxed);
+	const u32 write_index = m_write_index.load(std::memory_order_acquire);
+	const u32 input_sample_rate = m_input_sample_rate.load(std::memory_order_relaxed);
 	// Sync input rate by fifo size
 	float num_left = (float)(((write_index - read_index) & INDEX_MASK) / 2);
 	m_num_left_i = (num_left + m_num_left_i * (CONTROL_AVG - 1)) / CONTROL_AVG;
 
-	u32 low_waterwark = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
+	u32 low_waterwark = input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
 	low_waterwark = std::min(low_waterwark, MAX_SAMPLES / 2);
 
 	float offset = (m_num_left_i - low_waterwark) * CONTROL_FACTOR;
 	offset = MathUtil::Clamp(offset, -MAX_FREQ_SHIFT, MAX_FREQ_SHIFT);
 	// adjust framerate with framelimit
 	float emulationspeed = SConfig::GetInstance().m_EmulationSpeed;
-	float aid_sample_rate = m_input_sample_rate + offset;
+	float aid_sample_rate = input_sample_rate + offset;
 	if (consider_framelimit && emulationspeed > 0.0f)
 	{
 		aid_sample_rate = aid_sample_rate * emulationspeed;
@@ -96,8 +111,8 @@ void CMixer::MixerFifo::Mix(float* samples, u32 numSamples, bool consider_framel
 	// e.g. going from 32khz to 48khz is 1 / (3 / 2) = 2 / 3
 	// note because of syncing and framelimit, ratio will rarely be exactly 2 / 3
 	float ratio = aid_sample_rate / (float)m_mixer->m_sample_rate;
-	float l_volume = (float)m_lvolume.load() / 256.f;
-	float r_volume = (float)m_rvolume.load() / 256.f;
+	float l_volume = (float)m_lvolume.load(std::memory_order_relaxed) / 256.f;
+	float r_volume = (float)m_rvolume.load(std::memory_order_relaxed) / 256.f;
 	// for each output sample pair (left and right),
 	// linear interpolate between current and next sample
 	// increment output sample position
@@ -115,6 +130,8 @@ void CMixer::MixerFifo::Mix(float* samples, u32 numSamples, bool consider_framel
 		m_fraction = m_fraction - (s32)m_fraction;
 	}
 	// pad output if not enough input samples
+	if (current_sample < numSamples * 2)
+		m_underruns.store(m_underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 	float s[2];
 	s[0] = m_float_buffer[(read_index - 1) & INDEX_MASK] * r_volume;
 	s[1] = m_float_buffer[(read_index - 2) & INDEX_MASK] * l_volume;
@@ -123,16 +140,26 @@ void CMixer::MixerFifo::Mix(float* samples, u32 numSamples, bool consider_framel
 		samples[current_sample] += s[0];
 		samples[current_sample + 1] += s[1];
 	}
-	// update read index
-	m_read_index.store(read_index);
+	// update read index, releasing the slots to the producer
+	m_read_index.store(read_index, std::memory_order_release);
+}
+
+u32 CMixer::MixerFifo::AvailableSamples() const
+{
+	const u32 write_index = m_write_index.load(std::memory_order_acquire);
+	const u32 read_index = m_read_index.load(std::memory_order_relaxed);
+	return ((write_index - read_index) & INDEX_MASK) * 48000 / (2 * m_input_sample_rate.load(std::memory_order_relaxed));
 }
 
-u32 CMixer::MixerFifo::AvailableSamples()
+CMixer::FifoStats CMixer::MixerFifo::GetStats() const
 {
-	return ((m_write_index.load() - m_read_index.load()) & INDEX_MASK) * 48000 / (2 * m_input_sample_rate);
+	FifoStats stats;
+	stats.underruns = m_underruns.load(std::memory_order_relaxed);
+	stats.overruns = m_overruns.load(std::memory_order_relaxed);
+	return stats;
 }
 
-u32 CMixer::AvailableSamples()
+u32 CMixer::AvailableSamples() const
 {
 	u32 samples = m_dma_mixer.AvailableSamples();
 	if (samples == 0)
@@ -150,49 +177,158 @@ u32 CMixer::Mix(s16* samples, u32 num_samples, bool consider_framelimit)
 {
 	if (!samples)
 		return 0;
-	std::lock_guard<std::mutex> lk(m_cs_mixing);
-	// reset float output buffer
 	m_output_buffer.resize(num_samples * 2);
-	std::fill_n(m_output_buffer.begin(), num_samples * 2, 0.f);
-	m_dma_mixer.Mix(m_output_buffer.data(), num_samples, consider_framelimit);
-	m_streaming_mixer.Mix(m_output_buffer.data(), num_samples, consider_framelimit);
-	m_wiimote_speaker_mixer.Mix(m_output_buffer.data(), num_samples, consider_framelimit);
-	// dither and clamp
-	for (u32 i = 0; i < num_samples * 2; i += 2)
+	Mix(m_output_buffer.data(), num_samples, consider_framelimit);
+	FloatToSigned16(samples, m_output_buffer.data(), num_samples * 2);
+	return num_samples;
+}
+
+void FloatToSigned16(s16* dst, const float* src, u32 count)
+{
+	u32 i = 0;
+	// Clamping before the conversion keeps out of range values from turning
+	// into the "integer indefinite" result
+#if defined(_M_X86)
+	const __m128 scale = _mm_set1_ps(32768.0f);
+	const __m128 min = _mm_set1_ps(-32768.0f);
+	const __m128 max = _mm_set1_ps(32767.0f);
+	for (; i + 8 <= count; i += 8)
 	{
-		float r_output = m_output_buffer[i] * 32768.0f;
-		float l_output = m_output_buffer[i + 1] * 32768.0f;
-		l_output = MathUtil::Clamp(l_output, -32768.f, 32767.f);
-		r_output = MathUtil::Clamp(r_output, -32768.f, 32767.f);
-		samples[i] = s16(r_output);
-		samples[i + 1] = s16(l_output);
+		__m128 lo = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+		__m128 hi = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale);
+		lo = _mm_min_ps(_mm_max_ps(lo, min), max);
+		hi = _mm_min_ps(_mm_max_ps(hi, min), max);
+		const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
 	}
-	return num_samples;
+#elif defined(_M_ARM_64)
+	const float32x4_t min = vdupq_n_f32(-32768.0f);
+	const float32x4_t max = vdupq_n_f32(32767.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		float32x4_t lo = vmulq_n_f32(vld1q_f32(src + i), 32768.0f);
+		float32x4_t hi = vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0f);
+		lo = vminq_f32(vmaxq_f32(lo, min), max);
+		hi = vminq_f32(vmaxq_f32(hi, min), max);
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi))));
+	}
+#endif
+	for (; i < count; i++)
+		dst[i] = s16(MathUtil::Clamp(src[i] * 32768.0f, -32768.f, 32767.f));
+}
+
+void Signed16ToFloat(float* dst, const s16* src, u32 count)
+{
+	u32 i = 0;
+#if defined(_M_X86)
+	const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		// Sign extend by unpacking into the high halves and shifting back down
+		const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+		_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+#elif defined(_M_ARM_64)
+	for (; i + 8 <= count; i += 8)
+	{
+		const int16x8_t in = vld1q_s16(src + i);
+		vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(in))), 1.0f / 32768.0f));
+		vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), 1.0f / 32768.0f));
+	}
+#endif
+	for (; i < count; i++)
+		dst[i] = Signed16ToFloat(src[i]);
+}
+
+void ScaleSigned16(s16* samples, u32 count, float volume)
+{
+	u32 i = 0;
+#if defined(_M_X86)
+	const __m128 scale = _mm_set1_ps(volume);
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+		const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+		const __m128i lo_scaled = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		const __m128i hi_scaled = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(samples + i), _mm_packs_epi32(lo_scaled, hi_scaled));
+	}
+#elif defined(_M_ARM_64)
+	for (; i + 8 <= count; i += 8)
+	{
+		const int16x8_t in = vld1q_s16(samples + i);
+		const int32x4_t lo = vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(in))), volume));
+		const int32x4_t hi = vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), volume));
+		vst1q_s16(samples + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+	}
+#endif
+	for (; i < count; i++)
+		samples[i] = static_cast<s16>(samples[i] * volume);
 }
 
 u32 CMixer::Mix(float* samples, u32 num_samples, bool consider_framelimit)
 {
+	TRACE_SCOPE("Mixer::Mix");
 	if (!samples)
 		return 0;
-	std::lock_guard<std::mutex> lk(m_cs_mixing);
 	memset(samples, 0, num_samples * 2 * sizeof(float));
+	if (SConfig::GetInstance().bTimeStretching)
+	{
+		MixStretched(samples, num_samples);
+		m_buffered_latency.store(m_stretcher->GetBufferedSamples() * 1000.f / m_sample_rate, std::memory_order_relaxed);
+		return num_samples;
+	}
+	m_stretching = false;
 	m_dma_mixer.Mix(samples, num_samples, consider_framelimit);
 	m_streaming_mixer.Mix(samples, num_samples, consider_framelimit);
 	m_wiimote_speaker_mixer.Mix(samples, num_samples, consider_framelimit);
+	// AvailableSamples counts at 48 kHz
+	m_buffered_latency.store(AvailableSamples() / 48.f, std::memory_order_relaxed);
 	return num_samples;
 }
 
+void CMixer::MixStretched(float* samples, u32 num_samples)
+{
+	if (!m_stretching)
+	{
+		m_stretcher->Clear();
+		m_stretching = true;
+	}
+
+	// Mix what was emulated since the last call at its own rate, leaving the
+	// interpolation window in the FIFOs so nothing gets padded.
+	u32 available = std::min(AvailableSamples(), MAX_SAMPLES);
+	available -= std::min(available, 8u);
+	m_stretch_buffer.assign(available * 2, 0.f);
+	if (available)
+	{
+		m_dma_mixer.Mix(m_stretch_buffer.data(), available, false);
+		m_streaming_mixer.Mix(m_stretch_buffer.data(), available, false);
+		m_wiimote_speaker_mixer.Mix(m_stretch_buffer.data(), available, false);
+	}
+
+	m_stretcher->ProcessSamples(m_stretch_buffer.data(), available, num_samples);
+	m_stretcher->GetStretchedSamples(samples, num_samples);
+}
+
 
 void CMixer::MixerFifo::PushSamples(const s16* samples, u32 num_samples)
 {
 	// Cache access in non-volatile variable
 	// indexR isn't allowed to cache in the audio throttling loop as it
 	// needs to get updates to not deadlock.
-	u32 current_write_index = m_write_index.load();
+	u32 current_write_index = m_write_index.load(std::memory_order_relaxed);
 	// Check if we have enough free space
 	// indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-	if (num_samples * 2 + ((current_write_index - m_read_index.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
+	if (num_samples * 2 + ((current_write_index - m_read_index.load(std::memory_order_acquire)) & INDEX_MASK) >= MAX_SAMPLES * 2)
+	{
+		m_overruns.store(m_overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 		return;
+	}
 	// AyuanX: Actual re-sampling work has been moved to sound thread
 	// to alleviate the workload on main thread
 	// convert to float while copying to buffer
@@ -200,7 +336,8 @@ void CMixer::MixerFifo::PushSamples(const s16* samples, u32 num_samples)
 	{
 		m_float_buffer[(current_write_index + i) & INDEX_MASK] = Signed16ToFloat(Common::swap16(samples[i]));
 	}
-	m_write_index.fetch_add(num_samples * 2);
+	// Publish the samples to the consumer
+	m_write_index.store(current_write_index + num_samples * 2, std::memory_order_release);
 	return;
 }
 
@@ -238,6 +375,13 @@ void CMixer::PushWiimoteSpeakerSamples(const s16 *samples, u32 num_samples, u32
 	}
 }
 
+void CMixer::GetFifoStats(FifoStats* dma, FifoStats* streaming, FifoStats* wiimote_speaker) const
+{
+	*dma = m_dma_mixer.GetStats();
+	*streaming = m_streaming_mixer.GetStats();
+	*wiimote_speaker = m_wiimote_speaker_mixer.GetStats();
+}
+
 void CMixer::SetDMAInputSampleRate(u32 rate)
 {
 	m_dma_mixer.SetInputSampleRate(rate);
@@ -260,7 +404,7 @@ void CMixer::SetWiimoteSpeakerVolume(u32 lvolume, u32 rvolume)
 
 void CMixer::MixerFifo::SetInputSampleRate(u32 rate)
 {
-	m_input_sample_rate = rate;
+	m_input_sample_rate.store(rate, std::memory_order_relaxed);
 }
 
 void CMixer::MixerFifo::SetVolume(u32 lvolume, u32 rvolume)
@@ -351,5 +495,5 @@ void CMixer::StopLogDSPAudio()
 
 unsigned int CMixer::MixerFifo::GetInputSampleRate() const
 {
-	return m_input_sample_rate;
+	return m_input_sample_rate.load(std::memory_order_relaxed);
 }
\ No newline at end of file
@@ -7,10 +7,13 @@
 #include <atomic>
 #include <cstring>
 #include <array>
-#include <mutex>
+#include <memory>
 #include <vector>
 
 #include "AudioCommon/WaveFile.h"
+#include "Common/CommonTypes.h"
+
+class AudioStretcher;
 
 // converts [-32768, 32767] -> [-1.0, 1.0)
 inline float Signed16ToFloat(const s16 s)
@@ -18,6 +21,13 @@ inline float Signed16ToFloat(const s16 s)
 	return s * 0.000030517578125f;//(1.0f/32768.0f)
 }
 
+// Block conversions for the backends, vectorized where possible. Floats are
+// scaled by 32768, clamped and truncated like the scalar mixer output was.
+void FloatToSigned16(s16* dst, const float* src, u32 count);
+void Signed16ToFloat(float* dst, const s16* src, u32 count);
+// Scales s16 samples by volume in [0.0, 1.0], truncating the result
+void ScaleSigned16(s16* samples, u32 count, float volume);
+
 class CMixer
 {
 
@@ -30,13 +40,22 @@ public:
 	static const float CONTROL_FACTOR;
 	static const float CONTROL_AVG;
 
-	virtual ~CMixer()
-	{}
+	// Underruns count the Mix calls that ran out of input samples, overruns
+	// count the pushes dropped because the FIFO was full.
+	struct FifoStats
+	{
+		u64 underruns = 0;
+		u64 overruns = 0;
+	};
+
+	virtual ~CMixer();
 
-	// Called from audio threads
+	// Called from the audio thread of the backend, only one at a time. With
+	// time stretching enabled, everything mixed since the last call is
+	// stretched to numSamples and consider_framelimit is ignored.
 	u32 Mix(s16* samples, u32 numSamples, bool consider_framelimit = true);
 	u32 Mix(float* samples, u32 numSamples, bool consider_framelimit = true);
-	u32 AvailableSamples();
+	u32 AvailableSamples() const;
 	// Called from main thread
 	virtual void PushSamples(const s16* samples, u32 num_samples);
 	virtual void PushStreamingSamples(const s16* samples, u32 num_samples);
@@ -57,9 +76,12 @@ public:
 	void StartLogDSPAudio(const std::string& filename);
 	void StopLogDSPAudio();
 
-	std::mutex& MixerCritical()
+	void GetFifoStats(FifoStats* dma, FifoStats* streaming, FifoStats* wiimote_speaker) const;
+
+	// Audio queued in the mixer after the last Mix call, in ms
+	float GetBufferedLatency() const
 	{
-		return m_cs_mixing;
+		return m_buffered_latency.load(std::memory_order_relaxed);
 	}
 
 	float GetCurrentSpeed() const
@@ -72,6 +94,9 @@ public:
 	}
 
 protected:
+	// Wait-free ring with a single producer (emulation) and a single consumer
+	// (audio thread). Each side owns one of the indices, they are kept on
+	// separate cache lines.
 	class MixerFifo
 	{
 	public:
@@ -79,11 +104,13 @@ protected:
 			: m_mixer(mixer)
 			, m_input_sample_rate(sample_rate)
 			, m_write_index(0)
+			, m_overruns(0)
 			, m_read_index(0)
-			, m_lvolume(255)
-			, m_rvolume(255)
+			, m_underruns(0)
 			, m_num_left_i(0.0f)
 			, m_fraction(0)
+			, m_lvolume(255)
+			, m_rvolume(255)
 		{
 			srand((u32)time(nullptr));
 			m_float_buffer.fill(0.0f);
@@ -96,22 +123,30 @@ protected:
 		unsigned int GetInputSampleRate() const;
 		void SetVolume(u32 lvolume, u32 rvolume);
 		void GetVolume(u32* lvolume, u32* rvolume) const;
-		u32 AvailableSamples();
+		u32 AvailableSamples() const;
+		FifoStats GetStats() const;
 	protected:
 		CMixer *m_mixer;
-		unsigned m_input_sample_rate;
+		std::atomic<u32> m_input_sample_rate;
 
 		std::array<float, MAX_SAMPLES * 2> m_float_buffer;
 
+		// Producer side. The padding keeps both sides off each other's cache
+		// line without needing an over-aligned CMixer allocation.
 		std::atomic<u32> m_write_index;
+		std::atomic<u64> m_overruns;
+		u8 m_producer_padding[64];
+
+		// Consumer side
 		std::atomic<u32> m_read_index;
+		std::atomic<u64> m_underruns;
+		float m_num_left_i;
+		float m_fraction;
+		u8 m_consumer_padding[64];
 
 		// Volume ranges from 0-255
 		std::atomic<s32> m_lvolume;
 		std::atomic<s32> m_rvolume;
-
-		float m_num_left_i;
-		float m_fraction;
 	};
 
 	class LinearMixerFifo: public MixerFifo
@@ -153,12 +188,17 @@ protected:
 	bool m_log_dtk_audio;
 	bool m_log_dsp_audio;
 
-	std::mutex m_cs_mixing;
-
 	std::atomic<float> m_speed; // Current rate of the emulation (1.0 = 100% speed)
+	std::atomic<float> m_buffered_latency;
 
 private:
+	void MixStretched(float* samples, u32 num_samples);
 
 	std::vector<float> m_output_buffer;
+
+	// Consumer side time stretching state
+	std::unique_ptr<AudioStretcher> m_stretcher;
+	std::vector<float> m_stretch_buffer;
+	bool m_stretching = false;
 };
 
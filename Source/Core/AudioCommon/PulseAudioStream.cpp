@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 
 #include "AudioCommon/DPL2Decoder.h"
@@ -119,9 +120,12 @@ bool PulseAudio::PulseInit()
 	// limit buffersize to reduce latency
 	m_pa_ba.fragsize = -1;
 	m_pa_ba.maxlength = -1;          // max buffer, so also max latency
-	m_pa_ba.minreq = -1;             // don't read every byte, try to group them _a bit_
-	m_pa_ba.prebuf = -1;             // start as early as possible
-	m_pa_ba.tlength = m_channels * m_bytespersample; // designed latency, only change this flag for low latency output
+	m_pa_ba.prebuf = -1;             // refill the whole target before (re)starting playback
+	// designed latency, starts at the configured latency and adapts to underflows
+	m_pa_ba.tlength = std::max(SConfig::GetInstance().iLatency * ss.rate / 1000, 1u) * m_channels * m_bytespersample;
+	m_pa_ba.minreq = GetMinRequest(m_pa_ba.tlength);
+	m_min_tlength = m_pa_ba.tlength;
+	m_frames_since_underflow = 0;
 	pa_stream_flags flags = pa_stream_flags(PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_ADJUST_LATENCY | PA_STREAM_AUTO_TIMING_UPDATE);
 	m_pa_error = pa_stream_connect_playback(m_pa_s, nullptr, &m_pa_ba, flags, nullptr, nullptr);
 	if (m_pa_error < 0)
@@ -160,13 +164,33 @@ void PulseAudio::StateCallback(pa_context* c)
 // on underflow, increase pulseaudio latency in ~1ms steps
 void PulseAudio::UnderflowCallback(pa_stream* s)
 {
-	m_pa_ba.tlength += 32 * m_channels * m_bytespersample;
+	m_pa_ba.tlength += LATENCY_STEP_FRAMES * m_channels * m_bytespersample;
+	m_pa_ba.minreq = GetMinRequest(m_pa_ba.tlength);
+	m_frames_since_underflow = 0;
 	pa_operation* op = pa_stream_set_buffer_attr(s, &m_pa_ba, nullptr, nullptr);
 	pa_operation_unref(op);
 
 	WARN_LOG(AUDIO, "pulseaudio underflow, new latency: %d bytes", m_pa_ba.tlength);
 }
 
+// after a while without underflows, give the latency back in the same steps
+void PulseAudio::ReduceLatency(pa_stream* s, int frames)
+{
+	m_frames_since_underflow += frames;
+	if (m_pa_ba.tlength <= m_min_tlength ||
+		m_frames_since_underflow < LATENCY_DECAY_SECONDS * m_mixer->GetSampleRate())
+		return;
+
+	const u32 step = LATENCY_STEP_FRAMES * m_channels * m_bytespersample;
+	m_pa_ba.tlength = std::max(m_pa_ba.tlength - std::min(m_pa_ba.tlength, step), m_min_tlength);
+	m_pa_ba.minreq = GetMinRequest(m_pa_ba.tlength);
+	m_frames_since_underflow = 0;
+	pa_operation* op = pa_stream_set_buffer_attr(s, &m_pa_ba, nullptr, nullptr);
+	pa_operation_unref(op);
+
+	INFO_LOG(AUDIO, "pulseaudio latency lowered to %d bytes", m_pa_ba.tlength);
+}
+
 void PulseAudio::WriteCallback(pa_stream* s, size_t length)
 {
 	int bytes_per_frame = m_channels * m_bytespersample;
@@ -187,16 +211,9 @@ void PulseAudio::WriteCallback(pa_stream* s, size_t length)
 	}
 	else
 	{
-		// get a floating point mix
-		s16 s16buffer_stereo[frames * 2];
-		m_mixer->Mix(s16buffer_stereo, frames); // implicitly mixes to 16-bit stereo
-
+		// get a floating point mix, skipping the round trip through s16
 		float floatbuffer_stereo[frames * 2];
-		// s16 to float
-		for (int i=0; i < frames * 2; ++i)
-		{
-			floatbuffer_stereo[i] = s16buffer_stereo[i] / float(1 << 15);
-		}
+		m_mixer->Mix(floatbuffer_stereo, frames);
 
 		if (m_channels == 5) // Extract dpl2/5.0 Surround
 		{
@@ -223,6 +240,21 @@ void PulseAudio::WriteCallback(pa_stream* s, size_t length)
 	}
 
 	m_pa_error = pa_stream_write(s, buffer, trunc_length, nullptr, 0, PA_SEEK_RELATIVE);
+	ReduceLatency(s, frames);
+
+	// timing info is kept up to date by PA_STREAM_AUTO_TIMING_UPDATE
+	pa_usec_t latency;
+	int negative;
+	if (pa_stream_get_latency(s, &latency, &negative) >= 0)
+		m_output_latency.store(negative ? 0.f : latency / 1000.f, std::memory_order_relaxed);
+}
+
+// Ask for data in quarters of the target so the server never waits on a
+// single large request, which matters once tlength is only a few ms.
+u32 PulseAudio::GetMinRequest(u32 tlength) const
+{
+	const u32 bytes_per_frame = m_channels * m_bytespersample;
+	return std::max(tlength / 4 / bytes_per_frame, 1u) * bytes_per_frame;
 }
 
 // Callbacks that forward to internal methods (required because PulseAudio is a C API).
@@ -8,6 +8,8 @@
 #include <pulse/pulseaudio.h>
 #endif
 
+#include <atomic>
+
 #include "AudioCommon/SoundStream.h"
 #include "Common/CommonTypes.h"
 #include "Common/Flag.h"
@@ -22,6 +24,10 @@ public:
 	bool Start() override;
 	void Stop() override;
 	void Update() override;
+	float GetOutputLatency() override
+	{
+		return m_output_latency.load(std::memory_order_relaxed);
+	}
 
 	static bool isValid()
 	{
@@ -33,6 +39,13 @@ public:
 	void UnderflowCallback(pa_stream *s);
 
 private:
+	// Latency is raised by this many frames on underflows, and lowered again
+	// after this many seconds without one
+	static constexpr u32 LATENCY_STEP_FRAMES = 32;
+	static constexpr u32 LATENCY_DECAY_SECONDS = 10;
+
+	void ReduceLatency(pa_stream *s, int frames);
+	u32 GetMinRequest(u32 tlength) const;
 	virtual void SoundLoop() override;
 
 	bool PulseInit();
@@ -57,5 +70,8 @@ private:
 	pa_context *m_pa_ctx;
 	pa_stream *m_pa_s;
 	pa_buffer_attr m_pa_ba;
+	u32 m_min_tlength;
+	u64 m_frames_since_underflow;
+	std::atomic<float> m_output_latency{0.f};
 #endif
 };
@@ -5,15 +5,6 @@
 #ifdef _WIN32
 #include <windows.h>
 #endif
-#ifdef __APPLE__
-// Avoid conflict with objc.h (on Windows, ST uses the system BOOL type, so this doesn't work)
-#define BOOL SoundTouch_BOOL
-#endif
-#include <soundtouch/SoundTouch.h>
-#include <soundtouch/STTypes.h>
-#ifdef __APPLE__
-#undef BOOL
-#endif
 #include "Core/Core.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
@@ -91,115 +82,49 @@ void SoundStream::Stop()
 }
 
 alignas(16) static short realtimeBuffer[SOUND_MAX_FRAME_SIZE];
-alignas(16) static soundtouch::SAMPLETYPE dpl2buffer[SOUND_MAX_FRAME_SIZE];
-alignas(16) static soundtouch::SAMPLETYPE samplebuffer[SOUND_MAX_FRAME_SIZE];
-
-inline void floatTos16(s16* dst, const float *src, u32 numsamples, u32 numchannels)
-{
-	for (u32 i = 0; i < numsamples * numchannels; i++)
-	{
-		float sample = src[i] * 32768.0f;
-		sample = MathUtil::Clamp(sample, -32768.f, 32767.f);
-		dst[i] = s16(sample);
-	}
-}
-
-inline void s16ToFloat(float* dst, const s16 *src, u32 numsamples)
-{
-	for (u32 i = 0; i < numsamples; i++)
-	{
-		s16 sample = src[i];
-		dst[i] = Signed16ToFloat(sample);
-	}
-}
+alignas(16) static float dpl2buffer[SOUND_MAX_FRAME_SIZE];
+alignas(16) static float samplebuffer[SOUND_MAX_FRAME_SIZE];
 
 // The audio thread.
 void SoundStream::SoundLoop()
 {
 	Common::SetCurrentThreadName("Audio thread");
+#ifndef _WIN32
+	// Windows already runs this thread at THREAD_PRIORITY_TIME_CRITICAL, see Start()
+	if (SConfig::GetInstance().bRaiseThreadPriority)
+		Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+#endif
 	InitializeSoundLoop();
 	bool surroundSupported = SupportSurroundOutput() && SConfig::GetInstance().bDPL2Decoder;
 	memset(realtimeBuffer, 0, SOUND_MAX_FRAME_SIZE * sizeof(u16));
-	memset(dpl2buffer, 0, SOUND_MAX_FRAME_SIZE * sizeof(soundtouch::SAMPLETYPE));
-	memset(samplebuffer, 0, SOUND_MAX_FRAME_SIZE * sizeof(soundtouch::SAMPLETYPE));
+	memset(dpl2buffer, 0, SOUND_MAX_FRAME_SIZE * sizeof(float));
+	memset(samplebuffer, 0, SOUND_MAX_FRAME_SIZE * sizeof(float));
 	u32 channelmultiplier = surroundSupported ? SOUND_SAMPLES_SURROUND : SOUND_SAMPLES_STEREO;
 	CMixer* mixer = GetMixer();
-	if (SConfig::GetInstance().bTimeStretching)
+	while (threadData.load())
 	{
-		float ratemultiplier = 1.0f;
-		soundtouch::SoundTouch sTouch;
-		sTouch.setChannels(2);
-		sTouch.setSampleRate(mixer->GetSampleRate());
-		sTouch.setTempo(1.0);
-		sTouch.setSetting(SETTING_USE_QUICKSEEK, 0);
-		sTouch.setSetting(SETTING_USE_AA_FILTER, 1);
-		while (threadData.load())
+		u32 neededsamples = std::min(SamplesNeeded(), SOUND_FRAME_SIZE);
+		// With time stretching the mixer always delivers what is asked for
+		u32 availablesamples = SConfig::GetInstance().bTimeStretching ?
+			neededsamples : mixer->AvailableSamples() & (~(0xF));
+		if (neededsamples == SOUND_FRAME_SIZE && availablesamples > 0)
 		{
-			u32 availablesamples = mixer->AvailableSamples();
-			u32 numsamples = std::min(availablesamples, 400u);
-			if (numsamples == 400u)
-			{
-				float rate = mixer->GetCurrentSpeed();
-				if (rate <= 0)
-				{
-					rate = 1.0f;
-				}
-				numsamples = mixer->Mix(samplebuffer, numsamples);
-				rate *= ratemultiplier;
-				rate = rate < 0.5f ? 0.5f : rate;
-				rate = roundf(rate * 16.0f) / 16.0f;
-				sTouch.setTempo(rate);
-				sTouch.putSamples(samplebuffer, numsamples);
-			}
-			u32 samplesneeded = SamplesNeeded();
-			availablesamples = sTouch.numSamples();
-			if (samplesneeded >= SOUND_FRAME_SIZE && availablesamples > 0)
+			u32 numsamples = std::min(availablesamples, neededsamples);
+			if (surroundSupported)
 			{
-				ratemultiplier = std::fmaxf(std::fminf((float)availablesamples / (float)samplesneeded, 1.1f), 0.9f);
-				numsamples = std::min(availablesamples, SOUND_FRAME_SIZE);
-				if (surroundSupported)
-				{
-					numsamples = sTouch.receiveSamples(dpl2buffer, numsamples);
-					DPL2Decode(dpl2buffer, numsamples, samplebuffer);
-				}
-				else
-				{
-					numsamples = sTouch.receiveSamples(samplebuffer, numsamples);
-				}
-				floatTos16(realtimeBuffer, samplebuffer, numsamples, channelmultiplier);
-				WriteSamples(realtimeBuffer, numsamples);
+				numsamples = mixer->Mix(dpl2buffer, numsamples);
+				DPL2Decode(dpl2buffer, numsamples, samplebuffer);
+				FloatToSigned16(realtimeBuffer, samplebuffer, numsamples * channelmultiplier);
 			}
 			else
 			{
-				Common::SleepCurrentThread(1);
+				numsamples = mixer->Mix(realtimeBuffer, numsamples);
 			}
+			WriteSamples(realtimeBuffer, numsamples);
 		}
-	}
-	else
-	{
-		while (threadData.load())
+		else
 		{
-			u32 neededsamples = std::min(SamplesNeeded(), SOUND_FRAME_SIZE);
-			u32 availablesamples = mixer->AvailableSamples() & (~(0xF));
-			if (neededsamples == SOUND_FRAME_SIZE && availablesamples > 0)
-			{
-				u32 numsamples = std::min(availablesamples, neededsamples);
-				if (surroundSupported)
-				{
-					numsamples = mixer->Mix(dpl2buffer, numsamples);
-					DPL2Decode(dpl2buffer, numsamples, samplebuffer);
-					floatTos16(realtimeBuffer, samplebuffer, numsamples, channelmultiplier);
-				}
-				else
-				{
-					numsamples = mixer->Mix(realtimeBuffer, numsamples);
-				}
-				WriteSamples(realtimeBuffer, numsamples);
-			}
-			else
-			{
-				Common::SleepCurrentThread(1);
-			}
+			Common::SleepCurrentThread(1);
 		}
 	}
 }
\ No newline at end of file
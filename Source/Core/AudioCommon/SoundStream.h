@@ -67,6 +67,12 @@ public:
 	virtual void Clear(bool mute);
 	virtual void Update()
 	{};
+	// Latency between the mixer output and the speakers in ms, as last
+	// measured by the backend. 0 if the backend can't tell.
+	virtual float GetOutputLatency()
+	{
+		return 0.f;
+	}
 	bool IsMuted() const
 	{
 		return m_muted;
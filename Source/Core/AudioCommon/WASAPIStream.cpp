@@ -194,7 +194,8 @@ bool WASAPIStream::Start()
 		m_exclusive_mode ? &device_period : nullptr
 	);
 
-	device_period += SConfig::GetInstance().iLatency * (10000 / fmt.Format.nChannels);
+	// REFERENCE_TIME counts 100 ns units
+	device_period += SConfig::GetInstance().iLatency * 10000;
 
 	if(FAILED(hr))
 	{
@@ -297,16 +298,18 @@ bool WASAPIStream::Start()
 		ERROR_LOG(AUDIO, "WASAPIStream: HRESULT %s", wasapi_hresult_to_string(hr).c_str());
 		ERROR_LOG(AUDIO, "WASAPIStream: Couldn't get buffer size.");
 
-		m_audio_client = nullptr;
 		m_audio_client->Release();
+		m_audio_client = nullptr;
 
 		return false;
 	}
 
+	// Latency added by the audio engine and the driver on top of the buffer
+	m_audio_client->GetStreamLatency(&m_stream_latency);
+
 	device_period = static_cast<REFERENCE_TIME>(10000.0 * 1000 * frames_in_buffer / fmt.Format.nSamplesPerSec + 0.5) + SConfig::GetInstance().iLatency * 10000;
 
-	if(m_exclusive_mode)
-		OSD::AddMessage("WASAPI exclusive mode latency configured to " + std::to_string(device_period / 10000.0f) + " ms", 6000U);
+	OSD::AddMessage(std::string("WASAPI ") + (m_exclusive_mode ? "exclusive" : "shared") + " mode latency configured to " + std::to_string(device_period / 10000.0f) + " ms", 6000U);
 
 	m_need_data_event = CreateEvent(NULL, FALSE, FALSE, NULL);
 	m_audio_client->SetEventHandle(m_need_data_event);
@@ -354,7 +357,7 @@ void WASAPIStream::SoundLoop()
 {
 	if(m_audio_client && m_renderer && m_need_data_event)
 	{
-		Common::SetCurrentThreadName("WASAPI Exclusive Event Thread");
+		Common::SetCurrentThreadName(m_exclusive_mode ? "WASAPI Exclusive Event Thread" : "WASAPI Shared Event Thread");
 
 		u8* data = nullptr;
 
@@ -367,15 +370,26 @@ void WASAPIStream::SoundLoop()
 			if(!threadData.load())
 				return;
 
-			m_renderer->GetBuffer(frames_in_buffer, &data);
-			m_mixer->Mix(reinterpret_cast<s16*>(data), frames_in_buffer);
+			// In exclusive mode every event hands over the whole buffer, in shared
+			// mode only the part the engine already consumed can be refilled
+			u32 padding = 0;
+			if(!m_exclusive_mode && FAILED(m_audio_client->GetCurrentPadding(&padding)))
+				continue;
+			const u32 frames = frames_in_buffer - padding;
+			if(frames == 0 || FAILED(m_renderer->GetBuffer(frames, &data)))
+				continue;
+
+			m_mixer->Mix(reinterpret_cast<s16*>(data), frames);
 
 			float volume = SConfig::GetInstance().m_IsMuted ? 0 : SConfig::GetInstance().m_Volume / 100.0f;
 
-			for(u32 i = 0; i < frames_in_buffer * 2; i++)
-				reinterpret_cast<s16*>(data)[i] = static_cast<s16>(reinterpret_cast<s16*>(data)[i] * volume);
+			ScaleSigned16(reinterpret_cast<s16*>(data), frames * 2, volume);
+
+			m_renderer->ReleaseBuffer(frames, Core::GetState() != Core::CORE_RUN ? AUDCLNT_BUFFERFLAGS_SILENT : 0);
 
-			m_renderer->ReleaseBuffer(frames_in_buffer, Core::GetState() != Core::CORE_RUN ? AUDCLNT_BUFFERFLAGS_SILENT : 0);
+			// The buffer is full again, what was just written plays after all of it
+			m_output_latency.store(frames_in_buffer * 1000.f / fmt.Format.nSamplesPerSec + m_stream_latency / 10000.f,
+				std::memory_order_relaxed);
 		}
 	}
 }
@@ -37,6 +37,10 @@ public:
 	bool Start() override;
 	void SoundLoop() override;
 	void Stop() override;
+	float GetOutputLatency() override
+	{
+		return m_output_latency.load(std::memory_order_relaxed);
+	}
 
 	static bool isValid()
 	{
@@ -53,6 +57,8 @@ private:
 	HANDLE m_need_data_event = nullptr;
 
 	u32 frames_in_buffer = 0;
+	REFERENCE_TIME m_stream_latency = 0;
+	std::atomic<float> m_output_latency{0.f};
 
 	WAVEFORMATEXTENSIBLE fmt;
 
@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include <cstdio>
+#include <memory>
 #include <string>
 #include <curl/curl.h>
 
@@ -139,16 +140,52 @@ AnalyticsReporter::~AnalyticsReporter()
 	m_reporter_stop_request.Set();
 	m_reporter_event.Set();
 	m_reporter_thread.join();
+
+	QueuedReport* node = m_queued_reports.exchange(nullptr);
+	while (node)
+	{
+		QueuedReport* next = node->next;
+		delete node;
+		node = next;
+	}
 }
 
 void AnalyticsReporter::Send(AnalyticsReportBuilder&& report)
 {
 	// Put a bound on the size of the queue to avoid uncontrolled memory growth.
 	constexpr u32 QUEUE_SIZE_LIMIT = 25;
-	if (m_reports_queue.Size() < QUEUE_SIZE_LIMIT)
+	constexpr size_t QUEUE_BYTES_LIMIT = 256 * 1024;
+
+	std::string data = report.Consume();
+	if (m_queued_count.fetch_add(1) >= QUEUE_SIZE_LIMIT)
+	{
+		m_queued_count--;
+		return;
+	}
+	if (m_queued_bytes.fetch_add(data.size()) + data.size() > QUEUE_BYTES_LIMIT)
+	{
+		m_queued_bytes -= data.size();
+		m_queued_count--;
+		return;
+	}
+
+	QueuedReport* node = new QueuedReport{std::move(data), m_queued_reports.load()};
+	while (!m_queued_reports.compare_exchange_weak(node->next, node))
+	{
+	}
+	m_reporter_event.Set();
+}
+
+void AnalyticsReporter::TakeQueuedReports()
+{
+	QueuedReport* node = m_queued_reports.exchange(nullptr);
+	const size_t insert_at = m_pending_reports.size();
+	while (node)
 	{
-		m_reports_queue.Push(report.Consume());
-		m_reporter_event.Set();
+		m_pending_reports.insert(m_pending_reports.begin() + insert_at, std::move(node->report));
+		QueuedReport* next = node->next;
+		delete node;
+		node = next;
 	}
 }
 
@@ -162,14 +199,19 @@ void AnalyticsReporter::ThreadProc()
 			return;
 		}
 
-		while (!m_reports_queue.Empty())
+		// Everything queued since the last wake up is sent in one go, over the
+		// connection the backend keeps open.
+		TakeQueuedReports();
+		while (!m_pending_reports.empty())
 		{
-			std::shared_ptr<AnalyticsReportingBackend> backend(m_backend);
+			std::shared_ptr<AnalyticsReportingBackend> backend(std::atomic_load(&m_backend));
 
 			if (backend)
 			{
-				std::string report;
-				m_reports_queue.Pop(report);
+				std::string report = std::move(m_pending_reports.front());
+				m_pending_reports.pop_front();
+				m_queued_bytes -= report.size();
+				m_queued_count--;
 				backend->Send(std::move(report));
 			}
 			else
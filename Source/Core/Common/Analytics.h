@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -15,7 +18,6 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
-#include "Common/FifoQueue.h"
 #include "Common/Flag.h"
 
 // Utilities for analytics reporting in Dolphin. This reporting is designed to
@@ -133,7 +135,7 @@ public:
 	// backend without user consent.
 	void SetBackend(std::unique_ptr<AnalyticsReportingBackend> backend)
 	{
-		m_backend = std::move(backend);
+		std::atomic_store(&m_backend, std::shared_ptr<AnalyticsReportingBackend>(std::move(backend)));
 		m_reporter_event.Set();  // In case reports are waiting queued.
 	}
 
@@ -143,21 +145,38 @@ public:
 	AnalyticsReportBuilder& BaseBuilder() { return m_base_builder; }
 	// Gets a cloned builder that can be used to send a report.
 	AnalyticsReportBuilder Builder() const { return m_base_builder; }
-	// Enqueues a report for sending. Consumes the report builder.
+	// Enqueues a report for sending. Consumes the report builder. Safe to call
+	// from any thread without locking, reports over the queue limits are dropped.
 	void Send(AnalyticsReportBuilder&& report);
 
 	// For convenience.
 	void Send(AnalyticsReportBuilder& report) { Send(std::move(report)); }
 protected:
+	struct QueuedReport
+	{
+		std::string report;
+		QueuedReport* next;
+	};
+
 	void ThreadProc();
+	// Moves the reports pushed by Send to m_pending_reports, oldest first.
+	void TakeQueuedReports();
 
+	// Accessed with std::atomic_load/store, it's replaced while the thread sends.
 	std::shared_ptr<AnalyticsReportingBackend> m_backend;
 	AnalyticsReportBuilder m_base_builder;
 
 	std::thread m_reporter_thread;
 	Common::Event m_reporter_event;
 	Common::Flag m_reporter_stop_request;
-	FifoQueue<std::string> m_reports_queue;
+
+	// Lock-free stack pushed to by Send, newest first. The counters include
+	// the reports pending on the thread.
+	std::atomic<QueuedReport*> m_queued_reports{nullptr};
+	std::atomic<u32> m_queued_count{0};
+	std::atomic<size_t> m_queued_bytes{0};
+	// Only used by the reporter thread.
+	std::deque<std::string> m_pending_reports;
 };
 
 // Analytics backend to be used for debugging purpose, which dumps reports to
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <functional>
 
 #include "Common/ArmCommon.h"
@@ -359,7 +360,12 @@ private:
 	void EncodeLoadStoreUnscaled(u32 size, u32 op, ARM64Reg Rt, ARM64Reg Rn, s32 imm);
 
 protected:
-	void Write32(u32 value);
+	// Every instruction goes through here, keep it inline
+	void Write32(u32 value)
+	{
+		std::memcpy(m_code, &value, sizeof(u32));
+		m_code += sizeof(u32);
+	}
 
 public:
 	ARM64XEmitter()
@@ -819,7 +825,10 @@ public:
 	void FDIV(u8 size, ARM64Reg Rd, ARM64Reg Rn, ARM64Reg Rm);
 	void FMUL(u8 size, ARM64Reg Rd, ARM64Reg Rn, ARM64Reg Rm);
 	void FNEG(u8 size, ARM64Reg Rd, ARM64Reg Rn);
+	void FRECPE(u8 size, ARM64Reg Rd, ARM64Reg Rn);
+	void FRECPS(u8 size, ARM64Reg Rd, ARM64Reg Rn, ARM64Reg Rm);
 	void FRSQRTE(u8 size, ARM64Reg Rd, ARM64Reg Rn);
+	void FRSQRTS(u8 size, ARM64Reg Rd, ARM64Reg Rn, ARM64Reg Rm);
 	void FSUB(u8 size, ARM64Reg Rd, ARM64Reg Rn, ARM64Reg Rm);
 	void NOT(ARM64Reg Rd, ARM64Reg Rn);
 	void ORR(ARM64Reg Rd, ARM64Reg Rn, ARM64Reg Rm);
@@ -51,6 +51,15 @@
 #error No version of is_trivially_copyable
 #endif
 
+// Contiguous containers of these are serialized with a single copy. Unlike IsTriviallyCopyable this
+// must never give a false positive, and bools are left out since Do(bool) stores them as a u8.
+#ifdef _MSC_VER
+#define IsBulkCopyable(T)                                                                          \
+  (std::is_trivially_copyable<T>::value && !std::is_same<T, bool>::value)
+#else
+#define IsBulkCopyable(T) (IsTriviallyCopyable(T) && !std::is_same<T, bool>::value)
+#endif
+
 // Wrapper class
 class PointerWrap
 {
@@ -65,11 +74,15 @@ public:
 
 	u8** ptr;
 	Mode mode;
+	// When set, MODE_WRITE switches to MODE_MEASURE instead of writing past this point, so a
+	// buffer sized from a previous save can be tried without measuring first.
+	u8* write_limit = nullptr;
 
 public:
 	PointerWrap(u8** ptr_, Mode mode_) : ptr(ptr_), mode(mode_) {}
 	void SetMode(Mode mode_) { mode = mode_; }
 	Mode GetMode() const { return mode; }
+	void SetWriteLimit(u8* limit) { write_limit = limit; }
 	template <typename K, class V>
 	void Do(std::map<K, V>& x)
 	{
@@ -131,7 +144,7 @@ public:
 	template <typename T>
 	void Do(std::vector<T>& x)
 	{
-		DoContainer(x);
+		DoContiguousContainer(x, std::integral_constant<bool, IsBulkCopyable(T)>());
 	}
 
 	template <typename T>
@@ -149,7 +162,7 @@ public:
 	template <typename T>
 	void Do(std::basic_string<T>& x)
 	{
-		DoContainer(x);
+		DoContiguousContainer(x, std::integral_constant<bool, IsBulkCopyable(T)>());
 	}
 
 	template <typename T, typename U>
@@ -270,6 +283,23 @@ private:
 		DoEachElement(x, [](PointerWrap& p, typename T::value_type& elem) { p.Do(elem); });
 	}
 
+	template <typename T>
+	void DoContiguousContainer(T& x, std::false_type)
+	{
+		DoContainer(x);
+	}
+
+	// Same layout as DoContainer, the size followed by every element, in a single copy
+	template <typename T>
+	void DoContiguousContainer(T& x, std::true_type)
+	{
+		u32 size = static_cast<u32>(x.size());
+		Do(size);
+		x.resize(size);
+		if (size != 0)
+			DoArray(&x[0], size);
+	}
+
 	__forceinline void DoVoid(void* data, u32 size)
 	{
 		switch (mode)
@@ -279,6 +309,12 @@ private:
 			break;
 
 		case MODE_WRITE:
+			if (write_limit && size > static_cast<size_t>(write_limit - *ptr))
+			{
+				// Out of room, finish as a measurement so the caller learns the real size
+				mode = MODE_MEASURE;
+				break;
+			}
 			memcpy(*ptr, data, size);
 			break;
 
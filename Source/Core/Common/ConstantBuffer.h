@@ -32,6 +32,7 @@
 
 #pragma once
 #include <algorithm>
+#include <cstring>
 #include <utility>
 #include <vector>
 #include "Common.h"
@@ -43,7 +44,7 @@ struct ConstatBuffer
 private:
 	void* m_buffer;
 	regionvector m_dirtyRegions;
-	//size_t m_size;
+	size_t m_size;
 	bool m_dirty;
 	bool m_dirtyregiondisabled;
 	__forceinline void AddDirtyRegion(u32 const_number, u32 size)
@@ -74,11 +75,23 @@ private:
 		}
 		m_dirtyRegions.push_back(std::pair<u32, u32>(x, y));
 	}
+	// Games resend the same values for most draws, so only vectors whose contents
+	// actually change are marked dirty.
+	__forceinline void UpdateVector(u32 const_number, const void* value)
+	{
+		u8* buff = &((u8*)m_buffer)[const_number * VECTOR_SIZE];
+		if (memcmp(buff, value, VECTOR_SIZE) == 0)
+			return;
+		memcpy(buff, value, VECTOR_SIZE);
+		AddDirtyRegion(const_number, 1);
+	}
 public:
+	static const u32 VECTOR_SIZE = 16;
+
 	ConstatBuffer(void* buffer, size_t size) :
 		m_buffer(buffer),
 		m_dirtyRegions(),
-		//m_size(size),
+		m_size(size),
 		m_dirty(false),
 		m_dirtyregiondisabled(false)
 	{
@@ -91,52 +104,32 @@ public:
 	template<typename T>
 	__forceinline void SetConstant4(unsigned int const_number, T f1, T f2, T f3, T f4)
 	{
-		u32 idx = const_number * 4;
-		T* buff = &((T*)m_buffer)[idx];
-		*buff++ = f1;
-		*buff++ = f2;
-		*buff++ = f3;
-		*buff = f4;
-		AddDirtyRegion(const_number, 1);
+		static_assert(sizeof(T) * 4 == VECTOR_SIZE, "Constants are made of four 32-bit values");
+		const T value[4] = { f1, f2, f3, f4 };
+		UpdateVector(const_number, value);
 	}
 	template<typename T>
 	__forceinline void SetConstant3v(unsigned int const_number, const T *f)
 	{
-		u32 idx = const_number * 4;
-		T* buff = &((T*)m_buffer)[idx];
-		*buff++ = *f++;
-		*buff++ = *f++;
-		*buff++ = *f++;
-		*buff = T(0);
-		AddDirtyRegion(const_number, 1);
+		SetConstant4<T>(const_number, f[0], f[1], f[2], T(0));
 	}
 	template<typename T>
 	__forceinline void SetConstant4v(unsigned int const_number, const T *f)
 	{
-		u32 idx = const_number * 4;
-		memcpy(&((T*)m_buffer)[idx], f, sizeof(T) * 4);
-		AddDirtyRegion(const_number, 1);
+		static_assert(sizeof(T) * 4 == VECTOR_SIZE, "Constants are made of four 32-bit values");
+		UpdateVector(const_number, f);
 	}
 	template<typename T>
 	__forceinline void SetMultiConstant3v(unsigned int const_number, unsigned int count, const T *f)
 	{
-		u32 idx = const_number * 4;
-		T* buff = &((T*)m_buffer)[idx];
-		for (unsigned int i = 0; i < count; i++)
-		{
-			*buff++ = *f++;
-			*buff++ = *f++;
-			*buff++ = *f++;
-			*buff++ = T(0);
-		}
-		AddDirtyRegion(const_number, count);
+		for (unsigned int i = 0; i < count; i++, f += 3)
+			SetConstant3v<T>(const_number + i, f);
 	}
 	template<typename T>
 	__forceinline void SetMultiConstant4v(unsigned int const_number, unsigned int count, const T *f)
 	{
-		u32 idx = const_number * 4;
-		memcpy(&((T*)m_buffer)[idx], f, sizeof(T) * 4 * count);
-		AddDirtyRegion(const_number, count);
+		for (unsigned int i = 0; i < count; i++, f += 4)
+			SetConstant4v<T>(const_number + i, f);
 	}
 	
 	template<typename T>
@@ -154,6 +147,12 @@ public:
 		return &((T*)m_buffer)[idx];
 	}
 
+	// Forces a full upload, e.g. after loading a state, even if nothing changed.
+	__forceinline void SetAllDirty()
+	{
+		AddDirtyRegion(0, static_cast<u32>(m_size / 4));
+	}
+
 	__forceinline bool IsDirty()
 	{
 		return m_dirty;
@@ -424,6 +424,18 @@ u64 GetSize(FILE* f)
 	return size;
 }
 
+u64 GetModificationTime(const std::string& filename)
+{
+	struct stat buf;
+#ifdef _WIN32
+	if (_tstat64(UTF8ToTStr(filename).c_str(), &buf) != 0)
+#else
+	if (stat(filename.c_str(), &buf) != 0)
+#endif
+		return 0;
+	return static_cast<u64>(buf.st_mtime);
+}
+
 // creates an empty file filename, returns true on success
 bool CreateEmptyFile(const std::string& filename)
 {
@@ -961,6 +961,14 @@ PFNDOLOBJECTPTRLABELPROC dolObjectPtrLabel;
 PFNDOLPOPDEBUGGROUPPROC dolPopDebugGroup;
 PFNDOLPUSHDEBUGGROUPPROC dolPushDebugGroup;
 
+// KHR_parallel_shader_compile
+PFNDOLMAXSHADERCOMPILERTHREADSPROC dolMaxShaderCompilerThreads;
+
+// ARB_timer_query
+PFNDOLQUERYCOUNTERPROC dolQueryCounter;
+PFNDOLGETQUERYOBJECTI64VPROC dolGetQueryObjecti64v;
+PFNDOLGETQUERYOBJECTUI64VPROC dolGetQueryObjectui64v;
+
 // ARB_buffer_storage
 PFNDOLBUFFERSTORAGEPROC dolBufferStorage;
 
@@ -1804,6 +1812,16 @@ const GLFunc gl_function_array[] = {
 	GLFUNC_REQUIRES(glPushDebugGroup,
 					"GL_KHR_debug !VERSION_GLES_3 !VERSION_GL_4_3 |VERSION_GLES_3_2"),
 
+	// KHR_parallel_shader_compile
+	GLFUNC_SUFFIX(glMaxShaderCompilerThreads, KHR, "GL_KHR_parallel_shader_compile"),
+	GLFUNC_SUFFIX(glMaxShaderCompilerThreads, ARB,
+				  "GL_ARB_parallel_shader_compile !GL_KHR_parallel_shader_compile"),
+
+	// ARB_timer_query
+	GLFUNC_REQUIRES(glQueryCounter, "GL_ARB_timer_query"),
+	GLFUNC_REQUIRES(glGetQueryObjecti64v, "GL_ARB_timer_query"),
+	GLFUNC_REQUIRES(glGetQueryObjectui64v, "GL_ARB_timer_query"),
+
 	// ARB_buffer_storage
 	GLFUNC_REQUIRES(glBufferStorage, "GL_ARB_buffer_storage !VERSION_4_4"),
 	GLFUNC_SUFFIX(glNamedBufferStorage, EXT,
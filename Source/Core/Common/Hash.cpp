@@ -226,7 +226,28 @@ u64 GetMurmurHash3(const u8* src, u32 len, u32 samples)
 }
 
 
-// CRC32 hash using the SSE4.2 instruction
+#if _M_SSE >= 0x402 || defined(_M_ARM_64)
+// Both hosts use the CRC32C polynomial, so the hashes are the same on x86 and ARM.
+static inline u64 CRC32C_u64(u64 crc, u64 value)
+{
+#if _M_SSE >= 0x402
+	return _mm_crc32_u64(crc, value);
+#else
+	// We should be able to use intrinsics for this
+	// Too bad the intrinsics for this instruction was added in GCC 4.9.1
+	// The Android NDK (as of r10e) only has GCC 4.9
+	// Once the Android NDK has a newer GCC version, update these to use intrinsics
+	u32 result;
+	asm("crc32cx %w[res], %w[two], %x[three]"
+		: [res] "=r" (result)
+		: [two] "r" (static_cast<u32>(crc)),
+		[three] "r" (value));
+	return result;
+#endif
+}
+#endif
+
+// CRC32 hash using the SSE4.2 or ARMv8 CRC32 instructions
 u64 GetCRC32(const u8* src, u32 len, u32 samples)
 {
 #if _M_SSE >= 0x402 || defined(_M_ARM_64)
@@ -239,90 +260,52 @@ u64 GetCRC32(const u8* src, u32 len, u32 samples)
 	Step = Step / samples;
 	if (Step < 1)
 		Step = 1;
-#endif
 
-#if _M_SSE >= 0x402
-	while (data < end - Step * 3)
+	// Full hashes (the common case) take 64 bytes per iteration, the lanes get the same words
+	// as in the loop below so the result doesn't change.
+	if (Step == 1)
 	{
-		h[0] = _mm_crc32_u64(h[0], data[Step * 0]);
-		h[1] = _mm_crc32_u64(h[1], data[Step * 1]);
-		h[2] = _mm_crc32_u64(h[2], data[Step * 2]);
-		h[3] = _mm_crc32_u64(h[3], data[Step * 3]);
-		data += Step * 4;
+		while (end - data >= 8)
+		{
+			h[0] = CRC32C_u64(h[0], data[0]);
+			h[1] = CRC32C_u64(h[1], data[1]);
+			h[2] = CRC32C_u64(h[2], data[2]);
+			h[3] = CRC32C_u64(h[3], data[3]);
+			h[0] = CRC32C_u64(h[0], data[4]);
+			h[1] = CRC32C_u64(h[1], data[5]);
+			h[2] = CRC32C_u64(h[2], data[6]);
+			h[3] = CRC32C_u64(h[3], data[7]);
+			data += 8;
+		}
 	}
-	if (data < end - Step * 0)
-		h[0] = _mm_crc32_u64(h[0], data[Step * 0]);
-	if (data < end - Step * 1)
-		h[1] = _mm_crc32_u64(h[1], data[Step * 1]);
-	if (data < end - Step * 2)
-		h[2] = _mm_crc32_u64(h[2], data[Step * 2]);
 
-	if (len & 7)
-	{
-		u64 temp = 0;
-		memcpy(&temp, end, len & 7);
-		h[0] = _mm_crc32_u64(h[0], temp);
-	}
-#elif defined(_M_ARM_64)
-	// We should be able to use intrinsics for this
-	// Too bad the intrinsics for this instruction was added in GCC 4.9.1
-	// The Android NDK (as of r10e) only has GCC 4.9
-	// Once the Android NDK has a newer GCC version, update these to use intrinsics
 	while (data < end - Step * 3)
 	{
-		asm("crc32x %w[res], %w[two], %x[three]"
-			: [res] "=r" (h[0])
-			: [two] "r" (h[0]),
-			[three] "r" (data[Step * 0]));
-		asm("crc32x %w[res], %w[two], %x[three]"
-			: [res] "=r" (h[1])
-			: [two] "r" (h[1]),
-			[three] "r" (data[Step * 1]));
-		asm("crc32x %w[res], %w[two], %x[three]"
-			: [res] "=r" (h[2])
-			: [two] "r" (h[2]),
-			[three] "r" (data[Step * 2]));
-		asm("crc32x %w[res], %w[two], %x[three]"
-			: [res] "=r" (h[3])
-			: [two] "r" (h[3]),
-			[three] "r" (data[Step * 3]));
-
+		h[0] = CRC32C_u64(h[0], data[Step * 0]);
+		h[1] = CRC32C_u64(h[1], data[Step * 1]);
+		h[2] = CRC32C_u64(h[2], data[Step * 2]);
+		h[3] = CRC32C_u64(h[3], data[Step * 3]);
 		data += Step * 4;
 	}
 	if (data < end - Step * 0)
-		asm("crc32x %w[res], %w[two], %x[three]"
-			: [res] "=r" (h[0])
-			: [two] "r" (h[0]),
-			[three] "r" (data[Step * 0]));
+		h[0] = CRC32C_u64(h[0], data[Step * 0]);
 	if (data < end - Step * 1)
-		asm("crc32x %w[res], %w[two], %x[three]"
-			: [res] "=r" (h[1])
-			: [two] "r" (h[1]),
-			[three] "r" (data[Step * 1]));
+		h[1] = CRC32C_u64(h[1], data[Step * 1]);
 	if (data < end - Step * 2)
-		asm("crc32x %w[res], %w[two], %x[three]"
-			: [res] "=r" (h[2])
-			: [two] "r" (h[2]),
-			[three] "r" (data[Step * 2]));
+		h[2] = CRC32C_u64(h[2], data[Step * 2]);
 
 	if (len & 7)
 	{
 		u64 temp = 0;
 		memcpy(&temp, end, len & 7);
-		asm("crc32x %w[res], %w[two], %x[three]"
-			: [res] "=r" (h[0])
-			: [two] "r" (h[0]),
-			[three] "r" (temp));
+		h[0] = CRC32C_u64(h[0], temp);
 	}
-#endif
 
-#if _M_SSE >= 0x402 || defined(_M_ARM_64)
 	// FIXME: is there a better way to combine these partial hashes?
 	return h[0] + (h[1] << 10) + (h[2] << 21) + (h[3] << 32);
 #else
 	return 0;
 #endif
-
 }
 
 
@@ -0,0 +1,381 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+
+// On disk format:
+//header{
+// u32 'DCIY';
+// u16 sizeof(key_type);
+// u16 sizeof(value_type);
+// char ver[40]; // scm_rev
+//}
+
+//entry{
+// u32 value_size;
+// u32 checksum; // adler32 of the value
+// u32 uses; // lookups over all sessions, drives eviction
+// key_type   key;
+// value_type[value_size]   value;
+//}
+
+// Default key hashing for trivially copyable keys without a hasher of their own.
+template <typename K>
+struct IndexedDiskCacheKeyHasher
+{
+	size_t operator()(const K& key) const
+	{
+		return static_cast<size_t>(GetMurmurHash3(reinterpret_cast<const u8*>(&key), sizeof(K), 0));
+	}
+};
+
+template <typename K>
+struct IndexedDiskCacheKeyEqual
+{
+	bool operator()(const K& lhs, const K& rhs) const
+	{
+		return std::memcmp(&lhs, &rhs, sizeof(K)) == 0;
+	}
+};
+
+// Key-value store with random read access, a replacement for LinearDiskCache when only some of
+// the entries are needed. Open only walks the entry headers to build an in-memory index,
+// values are read and checksummed when they are looked up.
+// Entries appended for a key that is already stored replace it, the stale copies are dropped
+// when Close finds that they take up a large part of the file.
+// With a size limit set, Close also evicts the least used entries until the file fits.
+//
+// K and V are some POD type
+// K : the key type
+// V : value array type
+template <typename K, typename V, class Hasher = IndexedDiskCacheKeyHasher<K>,
+	class KeyEqual = IndexedDiskCacheKeyEqual<K>>
+class IndexedDiskCache
+{
+public:
+	// return number of indexed entries
+	u32 Open(const std::string& filename)
+	{
+		using std::ios_base;
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 5
+		static_assert(std::has_trivial_copy_constructor<K>::value, "K must be a trivially copyable type");
+#else
+		static_assert(std::is_trivially_copyable<K>::value, "K must be a trivially copyable type");
+#endif
+
+		Close();
+		m_filename = filename;
+		m_index.clear();
+		m_stale_bytes = 0;
+		m_uses_dirty = false;
+
+		OpenFStream(m_file, filename, ios_base::in | ios_base::out | ios_base::binary);
+		m_header.Init();
+		if (m_file.is_open() && ValidateHeader())
+		{
+			m_file.seekg(0, std::ios::end);
+			const u64 file_size = static_cast<u64>(m_file.tellg());
+			u64 pos = sizeof(Header);
+			m_file.seekg(pos);
+
+			EntryHeader entry;
+			K key;
+			while (Read(&entry) && Read(&key))
+			{
+				const u64 value_offset = pos + sizeof(EntryHeader) + sizeof(K);
+				const u64 value_bytes = u64(entry.value_size) * sizeof(V);
+				// A torn write at the end of the file, everything before it is still good
+				if (value_bytes > file_size - value_offset)
+					break;
+
+				Location location = {value_offset, entry.value_size, entry.checksum, entry.uses};
+				auto it = m_index.find(key);
+				if (it != m_index.end())
+				{
+					m_stale_bytes += EntrySize(it->second.value_size);
+					it->second = location;
+				}
+				else
+				{
+					m_index.emplace(key, location);
+				}
+
+				pos = value_offset + value_bytes;
+				m_file.seekg(pos);
+			}
+			m_file.clear();
+			m_end_pos = pos;
+			return static_cast<u32>(m_index.size());
+		}
+
+		// failed to open file for reading or bad header
+		// close and recreate file
+		Close();
+		m_file.open(filename, ios_base::in | ios_base::out | ios_base::trunc | ios_base::binary);
+		Write(&m_header);
+		m_end_pos = sizeof(Header);
+		return 0;
+	}
+
+	bool Contains(const K& key) const
+	{
+		return m_index.find(key) != m_index.end();
+	}
+
+	// Reads the value stored for key, entries that fail the checksum are forgotten.
+	bool Lookup(const K& key, std::vector<V>* value)
+	{
+		auto it = m_index.find(key);
+		if (it == m_index.end())
+			return false;
+
+		Location& location = it->second;
+		value->resize(location.value_size);
+		m_file.seekg(location.value_offset);
+		if (!Read(value->data(), location.value_size) ||
+			Checksum(value->data(), location.value_size) != location.checksum)
+		{
+			m_file.clear();
+			m_stale_bytes += EntrySize(location.value_size);
+			m_index.erase(it);
+			return false;
+		}
+		MarkUsed(location);
+		return true;
+	}
+
+	// Counts a use of an entry that is needed but was not read through Lookup.
+	void MarkUsed(const K& key)
+	{
+		auto it = m_index.find(key);
+		if (it != m_index.end())
+			MarkUsed(it->second);
+	}
+
+	// Upper bound for the file size in bytes enforced on Close, 0 means unlimited.
+	void SetSizeLimit(u64 size_limit)
+	{
+		m_size_limit = size_limit;
+	}
+
+	// Calls func(key) for every indexed entry, values are not read.
+	void ForEachKey(const std::function<void(const K&)>& func) const
+	{
+		for (const auto& it : m_index)
+			func(it.first);
+	}
+
+	// Appends a key-value pair to the store, replacing any earlier value for key.
+	// A replaced entry keeps its use count.
+	void Append(const K& key, const V* value, u32 value_size)
+	{
+		auto it = m_index.find(key);
+		EntryHeader entry = {value_size, Checksum(value, value_size), it != m_index.end() ? it->second.uses : 1};
+		m_file.seekp(m_end_pos);
+		if (!Write(&entry) || !Write(&key) || !Write(value, value_size))
+		{
+			m_file.clear();
+			return;
+		}
+
+		Location location = {m_end_pos + sizeof(EntryHeader) + sizeof(K), value_size, entry.checksum, entry.uses};
+		if (it != m_index.end())
+		{
+			m_stale_bytes += EntrySize(it->second.value_size);
+			it->second = location;
+		}
+		else
+		{
+			m_index.emplace(key, location);
+		}
+		m_end_pos = location.value_offset + u64(value_size) * sizeof(V);
+	}
+
+	void Sync()
+	{
+		m_file.flush();
+	}
+
+	void Close()
+	{
+		if (m_file.is_open())
+		{
+			// Rewriting is only worth it once stale entries make up half of the file
+			if ((m_stale_bytes > 0 && m_stale_bytes * 2 >= m_end_pos) ||
+				(m_size_limit > 0 && m_end_pos > m_size_limit))
+				Compact();
+			else if (m_uses_dirty)
+				WriteUses();
+			m_file.close();
+		}
+		// clear any error flags
+		m_file.clear();
+		m_index.clear();
+		m_stale_bytes = 0;
+		m_uses_dirty = false;
+	}
+
+private:
+	struct EntryHeader
+	{
+		u32 value_size;
+		u32 checksum;
+		u32 uses;
+	};
+
+	struct Location
+	{
+		u64 value_offset;
+		u32 value_size;
+		u32 checksum;
+		u32 uses;
+		bool uses_dirty;
+	};
+
+	void MarkUsed(Location& location)
+	{
+		if (location.uses < UINT32_MAX)
+			location.uses++;
+		location.uses_dirty = true;
+		m_uses_dirty = true;
+	}
+
+	// Updates the use counters in place, offsetof(EntryHeader, uses) before the key.
+	void WriteUses()
+	{
+		for (auto& it : m_index)
+		{
+			Location& location = it.second;
+			if (!location.uses_dirty)
+				continue;
+			m_file.seekp(location.value_offset - sizeof(K) - sizeof(u32));
+			if (!Write(&location.uses))
+			{
+				m_file.clear();
+				return;
+			}
+			location.uses_dirty = false;
+		}
+	}
+
+	static u64 EntrySize(u32 value_size)
+	{
+		return sizeof(EntryHeader) + sizeof(K) + u64(value_size) * sizeof(V);
+	}
+
+	static u32 Checksum(const V* value, u32 value_size)
+	{
+		return HashAdler32(reinterpret_cast<const u8*>(value), value_size * sizeof(V));
+	}
+
+	// Writes the live entries to a new file and swaps it in, dropping the least used ones when
+	// they don't fit the size limit.
+	void Compact()
+	{
+		const std::string temp_filename = m_filename + ".tmp";
+		std::fstream out;
+		OpenFStream(out, temp_filename, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+		if (!out.is_open())
+			return;
+
+		out.write(reinterpret_cast<const char*>(&m_header), sizeof(Header));
+
+		std::vector<const std::pair<const K, Location>*> entries;
+		entries.reserve(m_index.size());
+		for (const auto& it : m_index)
+			entries.push_back(&it);
+		std::sort(entries.begin(), entries.end(), [](const std::pair<const K, Location>* lhs, const std::pair<const K, Location>* rhs) {
+			return lhs->second.uses > rhs->second.uses;
+		});
+
+		u64 size = sizeof(Header);
+		std::vector<V> value;
+		for (const auto* it : entries)
+		{
+			const Location& location = it->second;
+			// Entries are sorted by use, once one doesn't fit smaller ones may still do
+			if (m_size_limit > 0 && size + EntrySize(location.value_size) > m_size_limit)
+				continue;
+			value.resize(location.value_size);
+			m_file.seekg(location.value_offset);
+			if (!Read(value.data(), location.value_size))
+			{
+				m_file.clear();
+				continue;
+			}
+			EntryHeader entry = {location.value_size, location.checksum, location.uses};
+			out.write(reinterpret_cast<const char*>(&entry), sizeof(EntryHeader));
+			out.write(reinterpret_cast<const char*>(&it->first), sizeof(K));
+			out.write(reinterpret_cast<const char*>(value.data()), location.value_size * sizeof(V));
+			size += EntrySize(location.value_size);
+		}
+		const bool good = out.good();
+		out.close();
+
+		m_file.close();
+		if (good && File::Delete(m_filename) && File::Rename(temp_filename, m_filename))
+			return;
+		File::Delete(temp_filename);
+	}
+
+	bool ValidateHeader()
+	{
+		char file_header[sizeof(Header)];
+
+		return (Read(file_header, sizeof(Header)) &&
+			!memcmp((const char*)&m_header, file_header, sizeof(Header)));
+	}
+
+	template <typename D>
+	bool Write(const D* data, u32 count = 1)
+	{
+		return m_file.write((const char*)data, count * sizeof(D)).good();
+	}
+
+	template <typename D>
+	bool Read(const D* data, u32 count = 1)
+	{
+		return m_file.read((char*)data, count * sizeof(D)).good();
+	}
+
+	struct Header
+	{
+		void Init()
+		{
+			// Null-terminator is intentionally not copied.
+			std::memcpy(&id, "DCIY", sizeof(u32));
+			std::memcpy(ver, scm_rev_cache_str.c_str(), std::min(scm_rev_cache_str.size(), sizeof(ver)));
+		}
+
+		u32 id;
+		const u16 key_t_size = sizeof(K);
+		const u16 value_t_size = sizeof(V);
+		char ver[40] = {};
+
+	} m_header;
+
+	std::fstream m_file;
+	std::string m_filename;
+	std::unordered_map<K, Location, Hasher, KeyEqual> m_index;
+	u64 m_end_pos = 0;
+	u64 m_stale_bytes = 0;
+	u64 m_size_limit = 0;
+	bool m_uses_dirty = false;
+};
@@ -318,39 +318,30 @@ bool IniFile::Load(const std::string& filename, bool keep_current_data)
 		sections.clear();
 	// first section consists of the comments before the first real section
 
-	// Open file
-	std::ifstream in;
-	OpenFStream(in, filename, std::ios::in);
-
-	if (in.fail())
+	// Reading the whole file at once and splitting it here is a lot faster than std::getline on
+	// an ifstream, which matters for the game INIs loaded on every boot and game list query.
+	std::string contents;
+	if (!File::ReadFileToString(filename, contents))
 		return false;
 
 	Section* current_section = nullptr;
-	bool first_line = true;
-	while (!in.eof())
-	{
-		std::string line;
+	size_t line_start = 0;
+	// Skips the UTF-8 BOM at the start of files. Notepad likes to add this.
+	if (contents.compare(0, 3, "\xEF\xBB\xBF") == 0)
+		line_start = 3;
 
-		if (!std::getline(in, line))
-		{
-			if (in.eof())
-				return true;
-			else
-				return false;
-		}
-
-		// Skips the UTF-8 BOM at the start of files. Notepad likes to add this.
-		if (first_line && line.substr(0, 3) == "\xEF\xBB\xBF")
-			line = line.substr(3);
-		first_line = false;
+	std::string line;
+	while (line_start < contents.size())
+	{
+		size_t line_end = contents.find('\n', line_start);
+		if (line_end == std::string::npos)
+			line_end = contents.size();
+		line.assign(contents, line_start, line_end - line_start);
+		line_start = line_end + 1;
 
-#ifndef _WIN32
-		// Check for CRLF eol and convert it to LF
-		if (!line.empty() && line.at(line.size() - 1) == '\r')
-		{
-			line.erase(line.size() - 1);
-		}
-#endif
+		// Check for CRLF eol and convert it to LF, the file is read in binary mode on every platform
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
 
 		if (line.size() > 0)
 		{
@@ -388,7 +379,6 @@ bool IniFile::Load(const std::string& filename, bool keep_current_data)
 		}
 	}
 
-	in.close();
 	return true;
 }
 
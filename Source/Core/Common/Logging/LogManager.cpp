@@ -114,10 +114,18 @@ LogManager::LogManager()
 	}
 
 	m_path_cutoff_point = DeterminePathCutOffPoint();
+	m_dispatch_thread = std::thread(&LogManager::DispatchThread, this);
 }
 
 LogManager::~LogManager()
 {
+	{
+		std::lock_guard<std::mutex> lk(m_queue_lock);
+		m_dispatch_shutdown = true;
+	}
+	m_queue_cv.notify_one();
+	m_dispatch_thread.join();
+
 	for (LogContainer* container : m_Log)
 		delete container;
 
@@ -143,8 +151,53 @@ void LogManager::Log(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const
 		"%s %s:%u %c[%s]: %s\n", Common::Timer::GetTimeFormatted().c_str(), path_to_print, line,
 		LogTypes::LOG_LEVEL_TO_CHAR[(int)level], log->GetShortName().c_str(), temp);
 
-	for (auto listener_id : *log)
-		m_listeners[listener_id]->Log(level, msg.c_str());
+	{
+		// If the listeners can't keep up, slow the logging threads down rather than queueing forever
+		static const size_t MAX_QUEUED_MESSAGES = 0x10000;
+		std::unique_lock<std::mutex> lk(m_queue_lock);
+		if (m_queue.size() >= MAX_QUEUED_MESSAGES)
+			m_queue_drained.wait(lk, [this] { return m_queue.size() < MAX_QUEUED_MESSAGES; });
+		m_queue.push_back({level, log->GetListeners(), std::move(msg)});
+	}
+	m_queue_cv.notify_one();
+
+	// Don't lose errors if the process is about to go down
+	if (level == LogTypes::LERROR)
+		Flush();
+}
+
+void LogManager::Flush()
+{
+	std::unique_lock<std::mutex> lk(m_queue_lock);
+	m_queue_drained.wait(lk, [this] { return m_queue.empty() && !m_dispatching; });
+}
+
+void LogManager::DispatchThread()
+{
+	std::vector<QueuedMessage> batch;
+	std::unique_lock<std::mutex> lk(m_queue_lock);
+	while (true)
+	{
+		m_queue_cv.wait(lk, [this] { return m_dispatch_shutdown || !m_queue.empty(); });
+		// Shutting down still delivers whatever was logged before
+		if (m_queue.empty())
+			return;
+
+		batch.swap(m_queue);
+		m_dispatching = true;
+		lk.unlock();
+
+		for (const QueuedMessage& message : batch)
+		{
+			for (auto listener_id : message.listener_ids)
+				m_listeners[listener_id]->Log(message.level, message.text.c_str());
+		}
+		batch.clear();
+
+		lk.lock();
+		m_dispatching = false;
+		m_queue_drained.notify_all();
+	}
 }
 
 void LogManager::Init()
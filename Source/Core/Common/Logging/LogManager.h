@@ -5,11 +5,14 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
 #include <cstdarg>
 #include <fstream>
 #include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/BitSet.h"
 #include "Common/CommonTypes.h"
@@ -68,6 +71,7 @@ public:
 	LogTypes::LOG_LEVELS GetLevel() const { return m_level; }
 	void SetLevel(LogTypes::LOG_LEVELS level) { m_level = level; }
 	bool HasListeners() const { return bool(m_listener_ids); }
+	BitSet32 GetListeners() const { return m_listener_ids; }
 	typedef class BitSet32::Iterator iterator;
 	iterator begin() const { return m_listener_ids.begin(); }
 	iterator end() const { return m_listener_ids.end(); }
@@ -89,8 +93,25 @@ private:
 	std::array<LogListener*, LogListener::NUMBER_OF_LISTENERS> m_listeners;
 	size_t m_path_cutoff_point = 0;
 
+	// Messages are formatted by the thread that logs them, but handed to the listeners (file and
+	// console I/O, the log window) on a background thread.
+	struct QueuedMessage
+	{
+		LogTypes::LOG_LEVELS level;
+		BitSet32 listener_ids;
+		std::string text;
+	};
+	std::thread m_dispatch_thread;
+	std::mutex m_queue_lock;
+	std::condition_variable m_queue_cv;
+	std::condition_variable m_queue_drained;
+	std::vector<QueuedMessage> m_queue;
+	bool m_dispatching = false;
+	bool m_dispatch_shutdown = false;
+
 	LogManager();
 	~LogManager();
+	void DispatchThread();
 
 public:
 	static u32 GetMaxLevel() { return MAX_LOGLEVEL; }
@@ -123,8 +144,13 @@ public:
 	void RemoveListener(LogTypes::LOG_TYPE type, LogListener::LISTENER id)
 	{
 		m_Log[type]->RemoveListener(id);
+		// Messages queued before this may still target the listener, which the caller might free
+		Flush();
 	}
 
+	// Waits until every queued message has reached its listeners
+	void Flush();
+
 	static LogManager* GetInstance() { return m_logManager; }
 	static void SetInstance(LogManager* logManager) { m_logManager = logManager; }
 	static void Init();
@@ -9,6 +9,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Logging/Log.h"
@@ -51,9 +52,18 @@ static int AshmemCreateFileMapping(const char* name, size_t size)
 }
 #endif
 
-void MemArena::GrabSHMSegment(size_t size)
+void MemArena::GrabSHMSegment(size_t size, const std::string& name)
 {
 #ifdef _WIN32
+	if (!name.empty())
+	{
+		hMemoryMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)(size), name.c_str());
+		if (hMemoryMapping && GetLastError() != ERROR_ALREADY_EXISTS)
+			return;
+		if (hMemoryMapping)
+			CloseHandle(hMemoryMapping);
+		WARN_LOG(MEMMAP, "Could not create shared memory %s", name.c_str());
+	}
 	hMemoryMapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)(size), nullptr);
 #elif defined(ANDROID)
 	fd = AshmemCreateFileMapping("Dolphin-emu", size);
@@ -63,14 +73,23 @@ void MemArena::GrabSHMSegment(size_t size)
 		return;
 	}
 #else
-	for (int i = 0; i < 10000; i++)
+	m_shm_name.clear();
+	fd = -1;
+	if (!name.empty())
+	{
+		fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+		if (fd != -1)
+			m_shm_name = name;
+		else
+			WARN_LOG(MEMMAP, "Could not create shared memory %s: %s", name.c_str(), strerror(errno));
+	}
+	for (int i = 0; fd == -1 && i < 10000; i++)
 	{
 		std::string file_name = StringFromFormat("/dolphinmem.%d", i);
 		fd = shm_open(file_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
 		if (fd != -1)
 		{
 			shm_unlink(file_name.c_str());
-			break;
 		}
 		else if (errno != EEXIST)
 		{
@@ -91,6 +110,11 @@ void MemArena::ReleaseSHMSegment()
 	hMemoryMapping = 0;
 #else
 	close(fd);
+	if (!m_shm_name.empty())
+	{
+		shm_unlink(m_shm_name.c_str());
+		m_shm_name.clear();
+	}
 #endif
 }
 
@@ -113,6 +137,8 @@ void* MemArena::CreateView(s64 offset, size_t size, void* base)
 	}
 	else
 	{
+		// Only the large physical RAM views qualify, the 4 KiB logical page views are skipped
+		Common::AdviseHugePages(retval, size);
 		return retval;
 	}
 #endif
@@ -245,11 +271,12 @@ static u32 MemoryMap_InitializeViews(MemoryView* views, int num_views, u32 flags
 	return shm_position;
 }
 
-u8* MemoryMap_Setup(MemoryView* views, int num_views, u32 flags, MemArena* arena)
+u8* MemoryMap_Setup(MemoryView* views, int num_views, u32 flags, MemArena* arena,
+	const std::string& shm_name)
 {
 	u32 total_mem = MemoryMap_InitializeViews(views, num_views, flags);
 
-	arena->GrabSHMSegment(total_mem);
+	arena->GrabSHMSegment(total_mem, shm_name);
 
 	// Now, create views in high memory where there's plenty of space.
 	u8* base = MemArena::FindMemoryBase();
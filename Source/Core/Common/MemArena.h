@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -19,7 +20,9 @@
 class MemArena
 {
 public:
-	void GrabSHMSegment(size_t size);
+	// A non-empty name makes the segment visible to other processes under that name until it is
+	// released. Falls back to an anonymous segment when the name is taken.
+	void GrabSHMSegment(size_t size, const std::string& name = "");
 	void ReleaseSHMSegment();
 	void* CreateView(s64 offset, size_t size, void* base = nullptr);
 	void ReleaseView(void* view, size_t size);
@@ -32,6 +35,7 @@ private:
 	HANDLE hMemoryMapping;
 #else
 	int fd;
+	std::string m_shm_name;
 #endif
 };
 
@@ -55,5 +59,6 @@ struct MemoryView
 
 // Uses a memory arena to set up an emulator-friendly memory map according to
 // a passed-in list of MemoryView structures.
-u8* MemoryMap_Setup(MemoryView* views, int num_views, u32 flags, MemArena* arena);
+u8* MemoryMap_Setup(MemoryView* views, int num_views, u32 flags, MemArena* arena,
+	const std::string& shm_name = "");
 void MemoryMap_Shutdown(MemoryView* views, int num_views, u32 flags, MemArena* arena);
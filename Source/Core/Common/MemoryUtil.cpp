@@ -42,6 +42,25 @@ static uintptr_t RoundPage(uintptr_t addr)
 }
 #endif
 
+static bool s_huge_pages_enabled = false;
+
+void SetHugePagesEnabled(bool enabled)
+{
+	s_huge_pages_enabled = enabled;
+}
+
+void AdviseHugePages(void* ptr, size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	// Nothing below one huge page can be backed by one anyway
+	static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+	if (!s_huge_pages_enabled || ptr == nullptr || size < HUGE_PAGE_SIZE)
+		return;
+	if (madvise(ptr, size, MADV_HUGEPAGE) != 0)
+		DEBUG_LOG(MEMMAP, "madvise(MADV_HUGEPAGE) failed for %p (%zu bytes)", ptr, size);
+#endif
+}
+
 // This is purposely not a full wrapper for virtualalloc/mmap, but it
 // provides exactly the primitive operations that Dolphin needs.
 
@@ -96,6 +115,7 @@ void* AllocateExecutableMemory(size_t size, bool low)
 		PanicAlert("Executable memory ended up above 2GB!");
 #endif
 
+	AdviseHugePages(ptr, size);
 	return ptr;
 	}
 
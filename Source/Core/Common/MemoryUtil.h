@@ -20,6 +20,12 @@ void UnWriteProtectMemory(void* ptr, size_t size, bool allowExecute = false);
 std::string MemUsage();
 size_t MemPhysical();
 
+// Large allocations (the JIT code space and the emulated RAM views) ask the kernel to back them
+// with 2 MiB pages when this is on. Only Linux transparent huge pages are used, elsewhere and when
+// the kernel declines, the memory simply stays on regular pages.
+void SetHugePagesEnabled(bool enabled);
+void AdviseHugePages(void* ptr, size_t size);
+
 template <typename T>
 class SimpleBuf
 {
@@ -5,6 +5,7 @@
 #include "Common/Thread.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/TraceEvents.h"
 
 #ifndef _WIN32
 #include <unistd.h>
@@ -12,6 +13,10 @@
 
 #ifdef __APPLE__
 #include <mach/mach.h>
+#include <pthread/qos.h>
+#elif defined __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #elif defined BSD4_4 || defined __FreeBSD__ || defined __OpenBSD__
 #include <pthread_np.h>
 #endif
@@ -46,6 +51,40 @@ void SetCurrentThreadAffinity(u32 mask)
 	SetThreadAffinityMask(GetCurrentThread(), mask);
 }
 
+void SetCurrentThreadPriority(ThreadPriority priority)
+{
+	int thread_priority = THREAD_PRIORITY_NORMAL;
+	if (priority == ThreadPriority::Background)
+		thread_priority = THREAD_PRIORITY_BELOW_NORMAL;
+	else if (priority == ThreadPriority::High)
+		thread_priority = THREAD_PRIORITY_ABOVE_NORMAL;
+	SetThreadPriority(GetCurrentThread(), thread_priority);
+
+	// EcoQoS decides whether the scheduler prefers efficiency cores for a thread. The API only
+	// exists since Windows 10 1709, so it is looked up at runtime.
+	struct PowerThrottlingState
+	{
+		ULONG Version;
+		ULONG ControlMask;
+		ULONG StateMask;
+	};
+	typedef BOOL(WINAPI * SetThreadInformationFunc)(HANDLE, int, LPVOID, DWORD);
+	static const SetThreadInformationFunc set_thread_information =
+		(SetThreadInformationFunc)GetProcAddress(GetModuleHandleW(L"kernel32.dll"),
+			"SetThreadInformation");
+	if (!set_thread_information)
+		return;
+
+	static const int THREAD_POWER_THROTTLING_CLASS = 3;  // ThreadPowerThrottling
+	static const ULONG EXECUTION_SPEED = 0x1;              // THREAD_POWER_THROTTLING_EXECUTION_SPEED
+	PowerThrottlingState state = {};
+	state.Version = 1;
+	// Normal hands the decision back to the OS
+	state.ControlMask = priority == ThreadPriority::Normal ? 0 : EXECUTION_SPEED;
+	state.StateMask = priority == ThreadPriority::Background ? EXECUTION_SPEED : 0;
+	set_thread_information(GetCurrentThread(), THREAD_POWER_THROTTLING_CLASS, &state, sizeof(state));
+}
+
 // Supporting functions
 void SleepCurrentThread(int ms)
 {
@@ -65,6 +104,8 @@ void SwitchCurrentThread()
 // http://msdn.microsoft.com/en-us/library/xcb2z8hs(VS.100).aspx
 void SetCurrentThreadName(const char* szThreadName)
 {
+	Trace::SetThreadName(szThreadName);
+
 	static const DWORD MS_VC_EXCEPTION = 0x406D1388;
 
 #pragma pack(push, 8)
@@ -118,6 +159,26 @@ void SetCurrentThreadAffinity(u32 mask)
 	SetThreadAffinity(pthread_self(), mask);
 }
 
+void SetCurrentThreadPriority(ThreadPriority priority)
+{
+#ifdef __APPLE__
+	qos_class_t qos_class = QOS_CLASS_DEFAULT;
+	if (priority == ThreadPriority::Background)
+		qos_class = QOS_CLASS_UTILITY;
+	else if (priority == ThreadPriority::High)
+		qos_class = QOS_CLASS_USER_INTERACTIVE;
+	pthread_set_qos_class_self_np(qos_class, 0);
+#elif defined __linux__
+	// Linux threads have their own nice value. Going below 0 needs CAP_SYS_NICE or RLIMIT_NICE.
+	int nice_value = 0;
+	if (priority == ThreadPriority::Background)
+		nice_value = 5;
+	else if (priority == ThreadPriority::High)
+		nice_value = -5;
+	setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), nice_value);
+#endif
+}
+
 void SleepCurrentThread(int ms)
 {
 	usleep(1000 * ms);
@@ -130,6 +191,8 @@ void SwitchCurrentThread()
 
 void SetCurrentThreadName(const char* szThreadName)
 {
+	Trace::SetThreadName(szThreadName);
+
 #ifdef __APPLE__
 	pthread_setname_np(szThreadName);
 #elif defined __FreeBSD__ || defined __OpenBSD__
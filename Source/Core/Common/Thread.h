@@ -24,6 +24,18 @@ int CurrentThreadId();
 void SetThreadAffinity(std::thread::native_handle_type thread, u32 mask);
 void SetCurrentThreadAffinity(u32 mask);
 
+enum class ThreadPriority
+{
+	Background,
+	Normal,
+	High,
+};
+
+// Changes the scheduling priority of the calling thread. High also asks the OS to keep the thread
+// on performance cores of hybrid CPUs where it exposes that (EcoQoS on Windows, QoS classes on
+// macOS). Raising the priority may need privileges on Linux, failures are ignored.
+void SetCurrentThreadPriority(ThreadPriority priority);
+
 void SleepCurrentThread(int ms);
 void SwitchCurrentThread(); // On Linux, this is equal to sleep 1ms
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "Common/Common.h"
 #include "Common/CPUDetect.h"
 #include "Common/ThreadPool.h"
@@ -6,12 +8,12 @@
 #endif
 using namespace Common;
 
-ThreadPool::ThreadPool(): m_workflag(0), m_workercount(0), m_workers(16)
+ThreadPool::ThreadPool(): m_workflag(0), m_workercount(0), m_workers(16), m_parkedcount(0)
 {
 	m_working.store(true);
 	int workers = cpu_info.logical_cpu_count - 1;
 	workers = workers < 1 ? 1 : workers;
-	for (size_t i = 0; i < workers; i++)
+	for (s32 i = 0; i < workers; i++)
 	{
 		std::thread* current = new std::thread(&ThreadPool::Workloop, std::ref(*this), i);
 		m_workerThreads.push_back(std::unique_ptr<std::thread>(current));
@@ -23,7 +25,11 @@ ThreadPool::ThreadPool(): m_workflag(0), m_workercount(0), m_workers(16)
 
 ThreadPool::~ThreadPool()
 {
-	m_working.store(false);
+	{
+		std::lock_guard<std::mutex> lk(m_parkMutex);
+		m_working.store(false);
+	}
+	m_parkCondition.notify_all();
 	for (u32 i = 0; i < m_workerThreads.size(); i++)
 	{
 		std::thread* current = m_workerThreads[i].get();
@@ -42,9 +48,31 @@ ThreadPool& ThreadPool::Getinstance()
 
 void ThreadPool::NotifyWorkPending()
 {
-	ThreadPool::Getinstance().m_workflag.fetch_add(2);
+	ThreadPool& instance = ThreadPool::Getinstance();
+	instance.m_workflag.fetch_add(2);
+	if (instance.m_parkedcount.load() > 0)
+	{
+		std::lock_guard<std::mutex> lk(instance.m_parkMutex);
+		instance.m_parkCondition.notify_all();
+	}
 }
 
+// The flag is only a hint of how much work is queued, never let it go negative or idle workers
+// would keep seeing pending work.
+bool ThreadPool::ConsumeWorkFlag()
+{
+	s32 current = m_workflag.load();
+	while (current > 0)
+	{
+		if (m_workflag.compare_exchange_weak(current, current - 1))
+			return true;
+	}
+	return false;
+}
+
+// Set on the pool's own threads, see ExecuteAsync
+static thread_local bool s_is_pool_thread = false;
+
 static SpinLock<true> workerLock;
 void ThreadPool::RegisterWorker(IWorker* worker)
 {
@@ -73,9 +101,9 @@ void ThreadPool::UnregisterWorker(IWorker* worker)
 	workerLock.unlock();
 }
 
-void ThreadPool::Workloop(ThreadPool &state, size_t ID)
+void ThreadPool::Workloop(ThreadPool &state, s32 ID)
 {
-	u32 rest_time = 1;
+	s_is_pool_thread = true;
 	while (state.m_working.load())
 	{
 		if (state.m_workflag.load() > ID)
@@ -90,7 +118,7 @@ void ThreadPool::Workloop(ThreadPool &state, size_t ID)
 					if (worker->NextTask())
 					{
 						worked = true;
-						state.m_workflag.fetch_sub(1);
+						state.ConsumeWorkFlag();
 					}
 				}
 			}
@@ -101,16 +129,18 @@ void ThreadPool::Workloop(ThreadPool &state, size_t ID)
 			}
 			else if (state.m_workflag.load() > ID)
 			{
-				state.m_workflag.fetch_sub(1);
+				state.ConsumeWorkFlag();
 			}
-			rest_time = 1;
-		}
-		else
-		{
-			rest_time++;
-			rest_time = rest_time > 5 ? 5 : rest_time;
+			continue;
 		}
-		SleepCurrentThread(rest_time);
+
+		// Nothing for this worker, sleep until work is queued
+		std::unique_lock<std::mutex> lk(state.m_parkMutex);
+		state.m_parkedcount.fetch_add(1);
+		state.m_parkCondition.wait(lk, [&state, ID] {
+			return !state.m_working.load() || state.m_workflag.load() > ID;
+		});
+		state.m_parkedcount.fetch_sub(1);
 	}
 }
 
@@ -149,8 +179,66 @@ void AsyncWorker::ExecuteAsync(std::function<void()> &&func)
 {
 	AsyncWorker& instance = Getinstance();
 	instance.m_inputsize.fetch_add(1);
-	instance.m_TaskQueue.push(std::move(func));
+	// The queue has a fixed capacity, wait for the workers to make room instead of dropping the
+	// task. A task queueing more work runs queued tasks itself, it might be the only worker.
+	size_t count = 0;
+	while (!instance.m_TaskQueue.push(std::move(func)))
+	{
+		ThreadPool::NotifyWorkPending();
+		if (!s_is_pool_thread || !instance.NextTask())
+			cYield(count++);
+	}
 	ThreadPool::NotifyWorkPending();
 }
 
+void AsyncWorker::ExecuteParallel(const std::function<void(int, int)> &loop, int lower, int upper, int min_block_size)
+{
+	const int range = upper - lower;
+	const int max_blocks = std::max(cpu_info.logical_cpu_count, 1) * 2;
+	const int block_count = std::min(std::max(range / std::max(min_block_size, 1), 1), max_blocks);
+	if (range <= 0 || block_count == 1)
+	{
+		if (range > 0)
+			loop(lower, upper);
+		return;
+	}
 
+	// Tasks that start after the caller ran out of blocks only touch this state, so it is shared.
+	struct ParallelState
+	{
+		std::function<void(int, int)> loop;
+		std::atomic<int> next_block;
+		std::atomic<int> pending_blocks;
+		int lower;
+		int upper;
+		int block_count;
+		int block_size;
+		bool RunBlock()
+		{
+			int block = next_block.fetch_add(1);
+			if (block >= block_count)
+				return false;
+			int block_lower = lower + block * block_size;
+			loop(block_lower, std::min(block_lower + block_size, upper));
+			pending_blocks.fetch_sub(1);
+			return true;
+		}
+	};
+	auto state = std::make_shared<ParallelState>();
+	state->loop = loop;
+	state->next_block = 0;
+	state->lower = lower;
+	state->upper = upper;
+	state->block_size = (range + block_count - 1) / block_count;
+	state->block_count = (range + state->block_size - 1) / state->block_size;
+	state->pending_blocks = state->block_count;
+
+	for (int i = 1; i < state->block_count; i++)
+		ExecuteAsync([state] { while (state->RunBlock()) {} });
+
+	// Don't wait on the pool, it may be busy with shader compiles.
+	while (state->RunBlock()) {}
+	size_t count = 0;
+	while (state->pending_blocks.load() > 0)
+		cYield(count++);
+}
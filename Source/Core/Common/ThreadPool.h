@@ -31,8 +31,10 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 #include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "Common/Thread.h"
@@ -447,7 +449,13 @@ private:
 	std::atomic<s32> m_workflag;
 	std::atomic<s32> m_workercount;
 	std::atomic<bool> m_working;
-	static void Workloop(ThreadPool &state, size_t ID);
+	// Idle workers park here instead of polling, NotifyWorkPending only takes the lock when
+	// someone is parked.
+	std::mutex m_parkMutex;
+	std::condition_variable m_parkCondition;
+	std::atomic<s32> m_parkedcount;
+	static void Workloop(ThreadPool &state, s32 ID);
+	bool ConsumeWorkFlag();
 	static ThreadPool &Getinstance();
 	ThreadPool(ThreadPool const&);
 	void operator=(ThreadPool const&);
@@ -470,5 +478,8 @@ public:
 	virtual ~AsyncWorker();
 	bool NextTask() override;
 	static void ExecuteAsync(std::function<void()> &&func);
+	// Splits [lower, upper) into blocks of at least min_block_size and runs loop(block_lower, block_upper)
+	// on the pool, the calling thread takes blocks too. Returns once the whole range is done.
+	static void ExecuteParallel(const std::function<void(int, int)> &loop, int lower, int upper, int min_block_size);
 };
 }
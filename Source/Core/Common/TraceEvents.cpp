@@ -0,0 +1,179 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/TraceEvents.h"
+
+namespace Common
+{
+namespace Trace
+{
+// Per thread, about 6 MiB of events
+static constexpr size_t EVENTS_PER_THREAD = 1 << 18;
+
+struct Event
+{
+	const char* name;
+	u64 begin_us;
+	u64 duration_us;
+};
+
+struct ThreadBuffer
+{
+	// Written by the owning thread only, count publishes the events before it
+	std::unique_ptr<Event[]> events;
+	std::atomic<size_t> count{0};
+	std::atomic<u64> dropped{0};
+	std::atomic<u64> session{0};
+	u32 id = 0;
+	std::string name;  // guarded by s_mutex
+};
+
+std::atomic<bool> g_recording{false};
+
+static std::mutex s_mutex;
+static std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+static std::atomic<u64> s_session{0};
+static u64 s_start_us = 0;
+static std::vector<std::pair<std::string, std::string>> s_other_data;
+
+static thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+static thread_local std::string t_name;
+
+static ThreadBuffer* GetThreadBuffer()
+{
+	if (!t_buffer)
+	{
+		t_buffer = std::make_shared<ThreadBuffer>();
+		t_buffer->events.reset(new Event[EVENTS_PER_THREAD]);
+		std::lock_guard<std::mutex> lk(s_mutex);
+		t_buffer->id = static_cast<u32>(s_buffers.size() + 1);
+		t_buffer->name = t_name.empty() ? StringFromFormat("Thread %u", t_buffer->id) : t_name;
+		s_buffers.push_back(t_buffer);
+	}
+	return t_buffer.get();
+}
+
+void Start()
+{
+	std::lock_guard<std::mutex> lk(s_mutex);
+	// Buffers notice the new session and drop old events themselves
+	s_session++;
+	s_start_us = Common::Timer::GetTimeUs();
+	s_other_data.clear();
+	g_recording.store(true);
+}
+
+void SetOtherData(const std::string& name, const std::string& value)
+{
+	std::lock_guard<std::mutex> lk(s_mutex);
+	s_other_data.emplace_back(name, value);
+}
+
+void SetThreadName(const char* name)
+{
+	t_name = name;
+	if (t_buffer)
+	{
+		std::lock_guard<std::mutex> lk(s_mutex);
+		t_buffer->name = t_name;
+	}
+}
+
+void Record(const char* name, u64 begin_us, u64 end_us)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+	const u64 session = s_session.load(std::memory_order_relaxed);
+	if (buffer->session.load(std::memory_order_relaxed) != session)
+	{
+		buffer->count.store(0, std::memory_order_relaxed);
+		buffer->dropped.store(0, std::memory_order_relaxed);
+		buffer->session.store(session, std::memory_order_release);
+	}
+
+	const size_t index = buffer->count.load(std::memory_order_relaxed);
+	if (index >= EVENTS_PER_THREAD)
+	{
+		buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	buffer->events[index] = {name, begin_us, end_us - begin_us};
+	buffer->count.store(index + 1, std::memory_order_release);
+}
+
+static std::string EscapeJSON(const std::string& str)
+{
+	std::string escaped;
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		if (static_cast<unsigned char>(c) >= 0x20)
+			escaped += c;
+	}
+	return escaped;
+}
+
+bool Stop(const std::string& path)
+{
+	if (!g_recording.exchange(false))
+		return false;
+
+	std::ofstream out;
+	OpenFStream(out, path, std::ios_base::out | std::ios_base::trunc);
+	if (!out.is_open())
+	{
+		ERROR_LOG(COMMON, "Could not write trace to %s", path.c_str());
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lk(s_mutex);
+	const u64 session = s_session.load();
+	u64 total = 0;
+	u64 dropped = 0;
+	out << "{\"traceEvents\":[\n";
+	bool first = true;
+	for (const auto& buffer : s_buffers)
+	{
+		out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+			<< ",\"args\":{\"name\":\"" << EscapeJSON(buffer->name) << "\"}}";
+		first = false;
+
+		// A thread that recorded nothing since Start still holds the previous session's events
+		if (buffer->session.load(std::memory_order_acquire) != session)
+			continue;
+		const size_t count = buffer->count.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++)
+		{
+			const Event& event = buffer->events[i];
+			if (event.begin_us < s_start_us)
+				continue;
+			out << ",\n{\"name\":\"" << EscapeJSON(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+				<< ",\"ts\":" << (event.begin_us - s_start_us) << ",\"dur\":" << event.duration_us << "}";
+		}
+		total += count;
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+	}
+	out << "\n],\"otherData\":{";
+	first = true;
+	for (const auto& data : s_other_data)
+	{
+		out << (first ? "" : ",") << "\"" << EscapeJSON(data.first) << "\":\"" << EscapeJSON(data.second) << "\"";
+		first = false;
+	}
+	out << "}}\n";
+
+	NOTICE_LOG(COMMON, "Wrote %llu trace events to %s (%llu dropped)", static_cast<unsigned long long>(total),
+		path.c_str(), static_cast<unsigned long long>(dropped));
+	return out.good();
+}
+}
+}
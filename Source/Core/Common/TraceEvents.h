@@ -0,0 +1,65 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Timer.h"
+
+// Timeline of scopes on all threads, written as Chrome trace JSON (load it in chrome://tracing)
+// to find stalls between threads. Every thread records into a buffer of its own without locking,
+// the buffers are only read after recording stopped.
+// Unlike Common::Profiler this is safe to use from any thread and costs one atomic load when
+// recording is off.
+namespace Common
+{
+namespace Trace
+{
+extern std::atomic<bool> g_recording;
+
+inline bool IsRecording()
+{
+	return g_recording.load(std::memory_order_relaxed);
+}
+
+void Start();
+// Stops recording and writes what was recorded since Start to path.
+bool Stop(const std::string& path);
+
+// Called by SetCurrentThreadName, names the thread's row in the trace.
+void SetThreadName(const char* name);
+
+// Written to the otherData of the trace by the next Stop, Start clears it.
+void SetOtherData(const std::string& name, const std::string& value);
+
+// name must outlive the recording, e.g. a string literal.
+void Record(const char* name, u64 begin_us, u64 end_us);
+
+class Scope
+{
+public:
+	Scope(const char* name) : m_name(IsRecording() ? name : nullptr)
+	{
+		if (m_name)
+			m_begin_us = Common::Timer::GetTimeUs();
+	}
+	~Scope()
+	{
+		if (m_name)
+			Record(m_name, m_begin_us, Common::Timer::GetTimeUs());
+	}
+
+private:
+	const char* m_name;
+	u64 m_begin_us = 0;
+};
+}
+}
+
+#define TRACE_SCOPE(name) Common::Trace::Scope trace_scope(name)
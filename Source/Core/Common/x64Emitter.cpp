@@ -93,33 +93,12 @@ u8* XEmitter::GetWritableCodePtr()
 	return code;
 }
 
-void XEmitter::Write8(u8 value)
-{
-	*code++ = value;
-}
-
-void XEmitter::Write16(u16 value)
-{
-	std::memcpy(code, &value, sizeof(u16));
-	code += sizeof(u16);
-}
-
-void XEmitter::Write32(u32 value)
-{
-	std::memcpy(code, &value, sizeof(u32));
-	code += sizeof(u32);
-}
-
-void XEmitter::Write64(u64 value)
-{
-	std::memcpy(code, &value, sizeof(u64));
-	code += sizeof(u64);
-}
-
 void XEmitter::ReserveCodeSpace(int bytes)
 {
-	for (int i = 0; i < bytes; i++)
-		*code++ = 0xCC;
+	if (bytes <= 0)
+		return;
+	std::memset(code, 0xCC, bytes);
+	code += bytes;
 }
 
 const u8* XEmitter::AlignCode4()
@@ -146,14 +125,6 @@ const u8* XEmitter::AlignCodePage()
 	return code;
 }
 
-// This operation modifies flags; check to see the flags are locked.
-// If the flags are locked, we should immediately and loudly fail before
-// causing a subtle JIT bug.
-void XEmitter::CheckFlags()
-{
-	_assert_msg_(DYNA_REC, !flags_locked, "Attempt to modify flags while flags locked!");
-}
-
 void XEmitter::WriteModRM(int mod, int reg, int rm)
 {
 	Write8((u8)((mod << 6) | ((reg & 7) << 3) | (rm & 7)));
@@ -1430,12 +1401,11 @@ static int GetVEXpp(u8 opPrefix)
 		return 0;
 }
 
-void XEmitter::WriteVEXOp(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W, int extrabytes)
+void XEmitter::WriteVEXOp(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W, int extrabytes, int L)
 {
 	int mmmmm = GetVEXmmmmm(op);
 	int pp = GetVEXpp(opPrefix);
-	// FIXME: we currently don't support 256-bit instructions, and "size" is not the vector size here
-	arg.WriteVEX(this, regOp1, regOp2, 0, pp, mmmmm, W);
+	arg.WriteVEX(this, regOp1, regOp2, L, pp, mmmmm, W);
 	Write8(op & 0xFF);
 	arg.WriteRest(this, extrabytes, regOp1);
 }
@@ -1460,6 +1430,13 @@ void XEmitter::WriteAVXOp4(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, co
 	WriteVEXOp4(opPrefix, op, regOp1, regOp2, arg, regOp3, W);
 }
 
+void XEmitter::WriteAVX2Op256(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W, int extrabytes)
+{
+	if (!cpu_info.bAVX2)
+		PanicAlert("Trying to use AVX2 on a system that doesn't support it. Bad programmer.");
+	WriteVEXOp(opPrefix, op, regOp1, regOp2, arg, W, extrabytes, 1);
+}
+
 void XEmitter::WriteFMA3Op(u8 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W)
 {
 	if (!cpu_info.bFMA)
@@ -1927,6 +1904,44 @@ void XEmitter::VPANDN(X64Reg regOp1, X64Reg regOp2, const OpArg& arg)   { WriteA
 void XEmitter::VPOR(X64Reg regOp1, X64Reg regOp2, const OpArg& arg)     { WriteAVXOp(0x66, 0xEB, regOp1, regOp2, arg); }
 void XEmitter::VPXOR(X64Reg regOp1, X64Reg regOp2, const OpArg& arg)    { WriteAVXOp(0x66, 0xEF, regOp1, regOp2, arg); }
 
+void XEmitter::VMOVD_xmm(X64Reg dest, const OpArg& arg)  { WriteAVXOp(0x66, 0x6E, dest, INVALID_REG, arg); }
+void XEmitter::VMOVQ_xmm(X64Reg dest, const OpArg& arg)  { WriteAVXOp(0xF3, 0x7E, dest, INVALID_REG, arg); }
+void XEmitter::VMOVDQU(X64Reg dest, const OpArg& arg)    { WriteAVXOp(0xF3, sseMOVDQfromRM, dest, INVALID_REG, arg); }
+void XEmitter::VMOVSS(const OpArg& arg, X64Reg src)      { WriteAVXOp(0xF3, sseMOVUPtoRM, src, INVALID_REG, arg); }
+void XEmitter::VMOVLPS(const OpArg& arg, X64Reg src)     { WriteAVXOp(0x00, sseMOVLPtoRM, src, INVALID_REG, arg); }
+void XEmitter::VMOVUPS(const OpArg& arg, X64Reg src)     { WriteAVXOp(0x00, sseMOVUPtoRM, src, INVALID_REG, arg); }
+
+void XEmitter::VBROADCASTF128(X64Reg dest, const OpArg& arg) { WriteAVX2Op256(0x66, 0x381A, dest, INVALID_REG, arg); }
+void XEmitter::VBROADCASTI128(X64Reg dest, const OpArg& arg) { WriteAVX2Op256(0x66, 0x385A, dest, INVALID_REG, arg); }
+void XEmitter::VPSHUFB_ymm(X64Reg regOp1, X64Reg regOp2, const OpArg& arg)   { WriteAVX2Op256(0x66, 0x3800, regOp1, regOp2, arg); }
+void XEmitter::VCVTDQ2PS_ymm(X64Reg regOp1, const OpArg& arg)                { WriteAVX2Op256(0x00, 0x5B, regOp1, INVALID_REG, arg); }
+void XEmitter::VMULPS_ymm(X64Reg regOp1, X64Reg regOp2, const OpArg& arg)    { WriteAVX2Op256(0x00, sseMUL, regOp1, regOp2, arg); }
+
+void XEmitter::VPSRAD_ymm(X64Reg regOp1, X64Reg regOp2, u8 shift)
+{
+	WriteAVX2Op256(0x66, 0x72, (X64Reg)4, regOp1, R(regOp2), 0, 1);
+	Write8(shift);
+}
+
+void XEmitter::VINSERTI128(X64Reg regOp1, X64Reg regOp2, const OpArg& arg, u8 lane)
+{
+	WriteAVX2Op256(0x66, 0x3A38, regOp1, regOp2, arg, 0, 1);
+	Write8(lane);
+}
+
+void XEmitter::VEXTRACTI128(const OpArg& arg, X64Reg regOp1, u8 lane)
+{
+	WriteAVX2Op256(0x66, 0x3A39, regOp1, INVALID_REG, arg, 0, 1);
+	Write8(lane);
+}
+
+void XEmitter::VZEROUPPER()
+{
+	Write8(0xC5);
+	Write8(0xF8);
+	Write8(0x77);
+}
+
 void XEmitter::VFMADD132PS(X64Reg regOp1, X64Reg regOp2, const OpArg& arg)    { WriteFMA3Op(0x98, regOp1, regOp2, arg); }
 void XEmitter::VFMADD213PS(X64Reg regOp1, X64Reg regOp2, const OpArg& arg)    { WriteFMA3Op(0xA8, regOp1, regOp2, arg); }
 void XEmitter::VFMADD231PS(X64Reg regOp1, X64Reg regOp2, const OpArg& arg)    { WriteFMA3Op(0xB8, regOp1, regOp2, arg); }
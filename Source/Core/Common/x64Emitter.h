@@ -269,7 +269,11 @@ private:
 	u8* code;
 	bool flags_locked;
 
-	void CheckFlags();
+	// This operation modifies flags; check to see the flags are locked.
+	// If the flags are locked, we should immediately and loudly fail before
+	// causing a subtle JIT bug. This runs for nearly every emitted instruction, so only
+	// debug builds pay for it.
+	void CheckFlags() { _dbg_assert_msg_(DYNA_REC, !flags_locked, "Attempt to modify flags while flags locked!"); }
 
 	void Rex(int w, int r, int x, int b);
 	void WriteModRM(int mod, int rm, int reg);
@@ -284,10 +288,11 @@ private:
 	void WriteSSEOp(u8 opPrefix, u16 op, X64Reg regOp, OpArg arg, int extrabytes = 0);
 	void WriteSSSE3Op(u8 opPrefix, u16 op, X64Reg regOp, const OpArg& arg, int extrabytes = 0);
 	void WriteSSE41Op(u8 opPrefix, u16 op, X64Reg regOp, const OpArg& arg, int extrabytes = 0);
-	void WriteVEXOp(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W = 0, int extrabytes = 0);
+	void WriteVEXOp(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W = 0, int extrabytes = 0, int L = 0);
 	void WriteVEXOp4(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, X64Reg regOp3, int W = 0);
 	void WriteAVXOp(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W = 0, int extrabytes = 0);
 	void WriteAVXOp4(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, X64Reg regOp3, int W = 0);
+	void WriteAVX2Op256(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W = 0, int extrabytes = 0);
 	void WriteFMA3Op(u8 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W = 0);
 	void WriteFMA4Op(u8 op, X64Reg dest, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int W = 0);
 	void WriteBMIOp(int size, u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, const OpArg& arg, int extrabytes = 0);
@@ -300,10 +305,29 @@ private:
 	void ABI_CalculateFrameSize(BitSet32 mask, size_t rsp_alignment, size_t needed_frame_size, size_t* shadowp, size_t* subtractionp, size_t* xmm_offsetp);
 
 protected:
-	void Write8(u8 value);
-	void Write16(u16 value);
-	void Write32(u32 value);
-	void Write64(u64 value);
+	// Kept inline so the JITs' own emitters don't pay a call for every byte they write
+	void Write8(u8 value)
+	{
+		*code++ = value;
+	}
+
+	void Write16(u16 value)
+	{
+		std::memcpy(code, &value, sizeof(u16));
+		code += sizeof(u16);
+	}
+
+	void Write32(u32 value)
+	{
+		std::memcpy(code, &value, sizeof(u32));
+		code += sizeof(u32);
+	}
+
+	void Write64(u64 value)
+	{
+		std::memcpy(code, &value, sizeof(u64));
+		code += sizeof(u64);
+	}
 
 public:
 	XEmitter() { code = nullptr; flags_locked = false; }
@@ -792,6 +816,25 @@ public:
 	void VPOR(X64Reg regOp1, X64Reg regOp2, const OpArg& arg);
 	void VPXOR(X64Reg regOp1, X64Reg regOp2, const OpArg& arg);
 
+	void VMOVD_xmm(X64Reg dest, const OpArg& arg);
+	void VMOVQ_xmm(X64Reg dest, const OpArg& arg);
+	void VMOVDQU(X64Reg dest, const OpArg& arg);
+	void VMOVSS(const OpArg& arg, X64Reg src);
+	void VMOVLPS(const OpArg& arg, X64Reg src);
+	void VMOVUPS(const OpArg& arg, X64Reg src);
+
+	// AVX2, 256-bit forms. The upper halves are left dirty, so call VZEROUPPER before
+	// going back to non-VEX SSE code.
+	void VBROADCASTF128(X64Reg dest, const OpArg& arg);
+	void VBROADCASTI128(X64Reg dest, const OpArg& arg);
+	void VPSHUFB_ymm(X64Reg regOp1, X64Reg regOp2, const OpArg& arg);
+	void VPSRAD_ymm(X64Reg regOp1, X64Reg regOp2, u8 shift);
+	void VCVTDQ2PS_ymm(X64Reg regOp1, const OpArg& arg);
+	void VMULPS_ymm(X64Reg regOp1, X64Reg regOp2, const OpArg& arg);
+	void VINSERTI128(X64Reg regOp1, X64Reg regOp2, const OpArg& arg, u8 lane);
+	void VEXTRACTI128(const OpArg& arg, X64Reg regOp1, u8 lane);
+	void VZEROUPPER();
+
 	// FMA3
 	void VFMADD132PS(X64Reg regOp1, X64Reg regOp2, const OpArg& arg);
 	void VFMADD213PS(X64Reg regOp1, X64Reg regOp2, const OpArg& arg);
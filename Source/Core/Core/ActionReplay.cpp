@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <iterator>
 #include <mutex>
 #include <string>
@@ -28,6 +29,7 @@
 #include <utility>
 #include <vector>
 
+#include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/IniFile.h"
 #include "Common/MsgHandler.h"
@@ -38,6 +40,7 @@
 #include "Core/ARDecrypt.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/PowerPC.h"
 
 namespace ActionReplay
@@ -79,9 +82,27 @@ enum
 	SUB_MASTER_CODE = 0x03,
 };
 
+// A RAM write (and fill) line of a code that only consists of those, resolved to its offset in
+// MEM1 when the code is applied
+struct CompiledWrite
+{
+	u32 offset;
+	u32 value;
+	u32 count;
+	u32 size;
+};
+
+struct ActiveCode
+{
+	ARCode code;
+	// Codes made of nothing but RAM writes skip the interpreter, which decodes every line each
+	// frame. Empty for all other codes.
+	std::vector<CompiledWrite> compiled_writes;
+};
+
 // General lock. Protects codes list and internal log.
 static std::mutex s_lock;
-static std::vector<ARCode> s_active_codes;
+static std::vector<ActiveCode> s_active_codes;
 static std::vector<std::string> s_internal_log;
 static std::atomic<bool> s_use_internal_log{ false };
 // pointer to the code currently being run, (used by log messages that include the code name)
@@ -114,6 +135,45 @@ struct ARAddr
 	}
 };
 
+static std::vector<CompiledWrite> CompileCode(const ARCode& code)
+{
+	std::vector<CompiledWrite> writes;
+	for (const AREntry& entry : code.ops)
+	{
+		const ARAddr addr(entry.cmd_addr);
+		// Zero codes, conditionals, pointer and add codes and AR self modification all keep
+		// going through the interpreter
+		if (addr == 0 || (addr >= 0x00002000 && addr < 0x00003000) || addr.type != 0 ||
+			addr.subtype != SUB_RAM_WRITE)
+		{
+			return {};
+		}
+
+		// Same as RAM writes to segment 8 in WriteToHardware
+		const u32 offset = addr.GCAddress() & Memory::RAM_MASK;
+		switch (addr.size)
+		{
+		case DATATYPE_8BIT:
+			writes.push_back({ offset, entry.value & 0xFF, (entry.value >> 8) + 1, 1 });
+			break;
+		case DATATYPE_16BIT:
+			writes.push_back({ offset, entry.value & 0xFFFF, (entry.value >> 16) + 1, 2 });
+			break;
+		default:
+			writes.push_back({ offset, entry.value, 1, 4 });
+			break;
+		}
+	}
+	return writes;
+}
+
+static ActiveCode MakeActiveCode(ARCode code)
+{
+	ActiveCode active{ std::move(code), {} };
+	active.compiled_writes = CompileCode(active.code);
+	return active;
+}
+
 // ----------------------
 // AR Remote Functions
 void ApplyCodes(const std::vector<ARCode>& codes)
@@ -124,10 +184,11 @@ void ApplyCodes(const std::vector<ARCode>& codes)
 	std::lock_guard<std::mutex> guard(s_lock);
 	s_disable_logging = false;
 	s_active_codes.clear();
-	std::copy_if(codes.begin(), codes.end(), std::back_inserter(s_active_codes), [](const ARCode& code)
+	for (const ARCode& code : codes)
 	{
-		return code.active;
-	});
+		if (code.active)
+			s_active_codes.push_back(MakeActiveCode(code));
+	}
 	s_active_codes.shrink_to_fit();
 }
 
@@ -140,7 +201,7 @@ void AddCode(ARCode code)
 	{
 		std::lock_guard<std::mutex> guard(s_lock);
 		s_disable_logging = false;
-		s_active_codes.emplace_back(std::move(code));
+		s_active_codes.push_back(MakeActiveCode(std::move(code)));
 	}
 }
 
@@ -936,6 +997,34 @@ static bool RunCodeLocked(const ARCode& arcode)
 	return true;
 }
 
+static void RunCompiledWrites(const std::vector<CompiledWrite>& writes)
+{
+	u8* const ram = Memory::m_pRAM;
+	for (const CompiledWrite& write : writes)
+	{
+		switch (write.size)
+		{
+		case 1:
+			for (u32 i = 0; i < write.count; ++i)
+				ram[(write.offset + i) & Memory::RAM_MASK] = static_cast<u8>(write.value);
+			break;
+		case 2:
+		{
+			const u16 value = Common::swap16(static_cast<u16>(write.value));
+			for (u32 i = 0; i < write.count; ++i)
+				std::memcpy(&ram[(write.offset + i * 2) & Memory::RAM_MASK], &value, sizeof(value));
+			break;
+		}
+		default:
+		{
+			const u32 value = Common::swap32(write.value);
+			std::memcpy(&ram[write.offset], &value, sizeof(value));
+			break;
+		}
+		}
+	}
+}
+
 void RunAllActive()
 {
 	if (!SConfig::GetInstance().bEnableCheats)
@@ -945,9 +1034,17 @@ void RunAllActive()
 	// are only atomic ops unless contested. It should be rare for this to
 	// be contested.
 	std::lock_guard<std::mutex> guard(s_lock);
-	s_active_codes.erase(std::remove_if(s_active_codes.begin(), s_active_codes.end(), [](const ARCode& code)
+	// The first run after the codes change is interpreted so it gets logged. The compiled writes
+	// also assume the segment 8 mapping WriteToHardware uses while data translation is on.
+	const bool use_compiled = s_disable_logging && UReg_MSR(MSR).DR;
+	s_active_codes.erase(std::remove_if(s_active_codes.begin(), s_active_codes.end(), [use_compiled](const ActiveCode& active)
 	{
-		bool success = RunCodeLocked(code);
+		if (use_compiled && !active.compiled_writes.empty())
+		{
+			RunCompiledWrites(active.compiled_writes);
+			return false;
+		}
+		bool success = RunCodeLocked(active.code);
 		LogInfo("\n");
 		return !success;
 	}), s_active_codes.end());
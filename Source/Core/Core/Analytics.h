@@ -33,11 +33,10 @@ public:
 	// per-game base data.
 	void ReportGameStart();
 
-	// Forward Send method calls to the reporter.
+	// Forward Send method calls to the reporter, which queues without locking.
 	template <typename T>
 	void Send(T report)
 	{
-		std::lock_guard<std::mutex> lk(m_reporter_mutex);
 		m_reporter.Send(report);
 	}
 
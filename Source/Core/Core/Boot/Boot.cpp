@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <cinttypes>
+#include <string>
 #include <vector>
 
 #include <zlib.h>
@@ -10,6 +12,7 @@
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/Hash.h"
 #include "Common/MsgHandler.h"
 #include "Common/MathUtil.h"
 #include "Common/StringUtil.h"
@@ -152,6 +155,19 @@ bool CBoot::FindMapFile(std::string* existing_map_file, std::string* writable_ma
 	return found;
 }
 
+// Generating the symbols of a game takes seconds on large executables, so the result is kept per
+// game and per hash of the scanned code and loaded instead on later boots of the same executable
+static std::string GetSymbolCachePath(u32 start_addr, u32 end_addr)
+{
+	const u8* code = Memory::GetPointer(start_addr);
+	if (!code || SConfig::GetInstance().GetGameID().empty())
+		return "";
+
+	u64 hash = GetMurmurHash3(code, end_addr - start_addr, 0);
+	return File::GetUserPath(D_CACHE_IDX) + "Symbols" DIR_SEP + SConfig::GetInstance().GetGameID() +
+		StringFromFormat("_%016" PRIx64 ".map", hash);
+}
+
 bool CBoot::LoadMapFromFilename()
 {
 	std::string strMapFilename;
@@ -307,13 +323,24 @@ bool CBoot::BootUp()
 		// Scan for common HLE functions
 		if (_StartupPara.bHLE_BS2 && !_StartupPara.bEnableDebugging)
 		{
-			PPCAnalyst::FindFunctions(0x80004000, 0x811fffff, &g_symbolDB);
-			SignatureDB db;
-			if (db.Load(File::GetSysDirectory() + TOTALDB))
+			const std::string cache_path = GetSymbolCachePath(0x80004000, 0x811fffff);
+			if (!cache_path.empty() && File::Exists(cache_path) && g_symbolDB.LoadMap(cache_path))
 			{
-				db.Apply(&g_symbolDB);
 				HLE::PatchFunctions();
-				db.Clear();
+			}
+			else
+			{
+				PPCAnalyst::FindFunctions(0x80004000, 0x811fffff, &g_symbolDB);
+				SignatureDB db;
+				if (db.Load(File::GetSysDirectory() + TOTALDB))
+				{
+					db.Apply(&g_symbolDB);
+					HLE::PatchFunctions();
+					db.Clear();
+
+					if (!cache_path.empty() && !g_symbolDB.Symbols().empty() && File::CreateFullPath(cache_path))
+						g_symbolDB.SaveMap(cache_path);
+				}
 			}
 		}
 
@@ -253,18 +253,38 @@ void SConfig::SaveCoreSettings(IniFile& ini)
 	IniFile::Section* core = ini.GetOrCreateSection("Core");
 
 	core->Set("HLE_BS2", bHLE_BS2);
+	core->Set("HLESDKFunctions", bHLESDKFunctions);
+	core->Set("HLESDKDisabled", m_hle_sdk_disabled);
+	core->Set("HLESDKValidate", bHLESDKValidate);
 	core->Set("TimingVariance", iTimingVariance);
+	core->Set("LowLatencyFramePacing", bLowLatencyFramePacing);
 	core->Set("CPUCore", iCPUCore);
 	core->Set("Fastmem", bFastmem);
 	core->Set("CPUThread", bCPUThread);
+	core->Set("RaiseThreadPriority", bRaiseThreadPriority);
+	core->Set("HugePages", bHugePages);
+	core->Set("MemoryWatcherBinary", bMemoryWatcherBinary);
+	core->Set("ExportGuestMemory", bExportGuestMemory);
 	core->Set("DSPHLE", bDSPHLE);
 	core->Set("SyncOnSkipIdle", bSyncGPUOnSkipIdleHack);
 	core->Set("SyncGPU", bSyncGPU);
 	core->Set("SyncGpuMaxDistance", iSyncGpuMaxDistance);
 	core->Set("SyncGpuMinDistance", iSyncGpuMinDistance);
 	core->Set("SyncGpuOverclock", fSyncGpuOverclock);
+	core->Set("JITPersistentCache", bJITPersistentCache);
+	core->Set("JITTieredCompilation", bJITTieredCompilation);
+	core->Set("JITBackgroundAnalysis", bJITBackgroundAnalysis);
+	core->Set("JITSuperblocks", bJITSuperblocks);
+	core->Set("JITCodeCacheSize", iJITCodeCacheSize);
+	core->Set("JITSampleProfiler", bJITSampleProfiler);
+	core->Set("TraceEvents", bTraceEvents);
+	core->Set("JITIdleLoopDetection", bJITIdleLoopDetection);
 	core->Set("FPRF", bFPRF);
 	core->Set("AccurateNaNs", bAccurateNaNs);
+	core->Set("Rewind", bRewind);
+	core->Set("RewindInterval", iRewindInterval);
+	core->Set("RewindMemory", iRewindMemory);
+	core->Set("IncrementalSavestates", bIncrementalSavestates);
 	core->Set("DefaultISO", m_strDefaultISO);
 	core->Set("DVDRoot", m_strDVDRoot);
 	core->Set("Apploader", m_strApploader);
@@ -275,6 +295,7 @@ void SConfig::SaveCoreSettings(IniFile& ini)
 	core->Set("TimeStretching", bTimeStretching);
 	core->Set("RSHACK", bRSHACK);
 	core->Set("Latency", iLatency);
+	core->Set("TimeStretchLatency", iTimeStretchLatency);
 	core->Set("MemcardAPath", m_strMemoryCardA);
 	core->Set("MemcardBPath", m_strMemoryCardB);
 	core->Set("AgpCartAPath", m_strGbaCartA);
@@ -566,6 +587,10 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	IniFile::Section* core = ini.GetOrCreateSection("Core");
 
 	core->Get("HLE_BS2", &bHLE_BS2, false);
+	core->Get("HLESDKFunctions", &bHLESDKFunctions, false);
+	m_hle_sdk_disabled.clear();
+	core->Get("HLESDKDisabled", &m_hle_sdk_disabled);
+	core->Get("HLESDKValidate", &bHLESDKValidate, false);
 #ifdef _M_X86
 	core->Get("CPUCore", &iCPUCore, PowerPC::CORE_JIT64);
 #elif _M_ARM_64
@@ -576,7 +601,12 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("Fastmem", &bFastmem, true);
 	core->Get("DSPHLE", &bDSPHLE, true);
 	core->Get("TimingVariance", &iTimingVariance, 40);
+	core->Get("LowLatencyFramePacing", &bLowLatencyFramePacing, false);
 	core->Get("CPUThread", &bCPUThread, true);
+	core->Get("RaiseThreadPriority", &bRaiseThreadPriority, false);
+	core->Get("HugePages", &bHugePages, false);
+	core->Get("MemoryWatcherBinary", &bMemoryWatcherBinary, false);
+	core->Get("ExportGuestMemory", &bExportGuestMemory, false);
 	core->Get("SyncOnSkipIdle", &bSyncGPUOnSkipIdleHack, true);
 	core->Get("DefaultISO", &m_strDefaultISO);
 	core->Get("DVDRoot", &m_strDVDRoot);
@@ -588,6 +618,7 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("TimeStretching", &bTimeStretching, false);
 	core->Get("RSHACK", &bRSHACK, false);
 	core->Get("Latency", &iLatency, 2);
+	core->Get("TimeStretchLatency", &iTimeStretchLatency, 80);
 	core->Get("MemcardAPath", &m_strMemoryCardA);
 	core->Get("MemcardBPath", &m_strMemoryCardB);
 	core->Get("AgpCartAPath", &m_strGbaCartA);
@@ -619,8 +650,20 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("SyncGpuOverclock", &fSyncGpuOverclock, 1.0);
 	core->Get("FastDiscSpeed", &bFastDiscSpeed, false);
 	core->Get("DCBZ", &bDCBZOFF, false);
+	core->Get("JITPersistentCache", &bJITPersistentCache, false);
+	core->Get("JITTieredCompilation", &bJITTieredCompilation, false);
+	core->Get("JITBackgroundAnalysis", &bJITBackgroundAnalysis, false);
+	core->Get("JITSuperblocks", &bJITSuperblocks, false);
+	core->Get("JITCodeCacheSize", &iJITCodeCacheSize, 32);
+	core->Get("JITSampleProfiler", &bJITSampleProfiler, false);
+	core->Get("TraceEvents", &bTraceEvents, false);
+	core->Get("JITIdleLoopDetection", &bJITIdleLoopDetection, false);
 	core->Get("FPRF", &bFPRF, false);
 	core->Get("AccurateNaNs", &bAccurateNaNs, false);
+	core->Get("Rewind", &bRewind, false);
+	core->Get("RewindInterval", &iRewindInterval, 10);
+	core->Get("RewindMemory", &iRewindMemory, 256);
+	core->Get("IncrementalSavestates", &bIncrementalSavestates, false);
 	core->Get("EmulationSpeed", &m_EmulationSpeed, 1.0f);
 	core->Get("Overclock", &m_OCFactor, 1.0f);
 	core->Get("OverclockEnable", &m_OCEnable, false);
@@ -764,6 +807,7 @@ void SConfig::LoadDefaults()
 
 	iCPUCore = PowerPC::CORE_JIT64;
 	iTimingVariance = 40;
+	bLowLatencyFramePacing = false;
 	bCPUThread = false;
 	bSyncGPUOnSkipIdleHack = true;
 	bRunCompareServer = false;
@@ -788,6 +832,7 @@ void SConfig::LoadDefaults()
 	bTimeStretching = false;
 	bRSHACK = false;
 	iLatency = 14;
+	iTimeStretchLatency = 80;
 
 	iPosX = INT_MIN;
 	iPosY = INT_MIN;
@@ -87,6 +87,16 @@ struct SConfig : NonCopyable
 	// JIT (shared between JIT and JITIL)
 	bool bJITNoBlockCache = false;
 	bool bJITNoBlockLinking = false;
+	bool bJITPersistentCache = false;
+	bool bJITTieredCompilation = false;
+	bool bJITBackgroundAnalysis = false;
+	bool bJITSuperblocks = false;
+	bool bJITSampleProfiler = false;
+	// Size of the x86 JIT code cache in MiB, rounded down to a multiple of 32
+	int iJITCodeCacheSize = 32;
+	// Records a Chrome trace of the emulation threads to Logs/trace.json while a game runs.
+	bool bTraceEvents = false;
+	bool bJITIdleLoopDetection = false;
 	bool bJITOff = false;
 	bool bJITLoadStoreOff = false;
 	bool bJITLoadStorelXzOff = false;
@@ -107,13 +117,29 @@ struct SConfig : NonCopyable
 	bool bAccurateNaNs = false;
 
 	int iTimingVariance = 40;  // in milli secounds
+	bool bLowLatencyFramePacing = false;
 	bool bCPUThread = true;
+	// Runs the CPU, GPU, DSP, audio and Wiimote threads at a raised priority and asks the OS to keep
+	// them on performance cores.
+	bool bRaiseThreadPriority = false;
+	// Backs emulated RAM and the JIT code space with transparent huge pages where the OS allows it.
+	bool bHugePages = false;
+	// Sends MemoryWatcher changes as batched binary datagrams instead of one text message each
+	bool bMemoryWatcherBinary = false;
+	// Shares emulated RAM with other processes, see Memory::ExportedMemoryInfo
+	bool bExportGuestMemory = false;
 	bool bDSPThread = false;
 	bool bDSPHLE = true;
 	bool bSyncGPUOnSkipIdleHack = true;
 	bool bNTSC = false;
 	bool bForceNTSCJ = false;
 	bool bHLE_BS2 = true;
+	// Runs common SDK routines (memcpy, memset, matrix copies, cache range flushes) natively
+	bool bHLESDKFunctions = false;
+	// Names of the SDK routines above that keep running as guest code, e.g. "memcpy,PSMTXCopy"
+	std::vector<std::string> m_hle_sdk_disabled;
+	// Runs the guest code again after each SDK replacement and logs where the results differ
+	bool bHLESDKValidate = false;
 	bool bEnableCheats = false;
 	bool bEnableMemcardSdWriting = true;
 	bool bAllowAllNetplayVersions = false;
@@ -124,6 +150,8 @@ struct SConfig : NonCopyable
 	bool bTimeStretching = false;
 	bool bRSHACK = false;
 	int iLatency = 14;
+	// Ms of stretched audio buffered when time stretching
+	int iTimeStretchLatency = 80;
 
 	bool bRunCompareServer = false;
 	bool bRunCompareClient = false;
@@ -132,6 +160,12 @@ struct SConfig : NonCopyable
 	bool bDCBZOFF = false;
 	int iBBDumpPort = 0;
 	bool bFastDiscSpeed = false;
+	// In-memory savestate history for the rewind hotkey
+	bool bRewind = false;
+	int iRewindInterval = 10;  // frames between captures
+	int iRewindMemory = 256;   // MiB
+	// Copy only the written MEM1 pages when saving over the previous state
+	bool bIncrementalSavestates = false;
 	int iVideoRate = 8;
 	bool bHalfAudioRate = false;
 
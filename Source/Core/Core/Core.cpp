@@ -4,6 +4,7 @@
 
 #include <atomic>
 #include <cctype>
+#include <cinttypes>
 #include <cstring>
 #include <mutex>
 #include <queue>
@@ -26,6 +27,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/Analytics.h"
 #include "Core/BootManager.h"
@@ -76,6 +78,7 @@
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/VideoBackendBase.h"
+#include "VideoCommon/VideoConfig.h"
 
 // Android and OSX haven't implemented the keyword yet.
 #if defined __ANDROID__ || defined __APPLE__
@@ -156,6 +159,7 @@ void SetStateFileName(const std::string& val)
 
 void FrameUpdateOnCPUThread()
 {
+	Memory::UpdateExportedFrameCount();
 	if (NetPlay::IsNetPlayRunning())
 		NetPlayClient::SendTimeBase();
 }
@@ -358,12 +362,22 @@ static void CpuThread()
 		Common::SetCurrentThreadName("CPU-GPU thread");
 		video_backend->Video_Prepare();
 	}
+	if (_CoreParameter.bRaiseThreadPriority)
+		Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
 
 	// This needs to be delayed until after the video backend is ready.
 	DolphinAnalytics::Instance()->ReportGameStart();
 
 	if (_CoreParameter.bFastmem)
+	{
 		EMM::InstallExceptionHandler();  // Let's run under memory watch
+#ifndef __APPLE__
+		// Wii IOS reads files straight into guest memory, which can't go through the fault handler.
+		if (!_CoreParameter.bWii &&
+			(g_ActiveConfig.bTrackTextureWrites || _CoreParameter.bIncrementalSavestates))
+			Memory::SetWriteTrackingEnabled(true);
+#endif
+	}
 
 	if (!s_state_filename.empty())
 	{
@@ -379,6 +393,7 @@ static void CpuThread()
 
 	s_is_started = true;
 	CPUSetInitialExecutionState();
+	JitInterface::WarmUpBlockCache();
 
 #ifdef USE_GDBSTUB
 #ifndef _WIN32
@@ -410,7 +425,10 @@ static void CpuThread()
 		video_backend->Video_Cleanup();
 
 	if (_CoreParameter.bFastmem)
+	{
+		Memory::SetWriteTrackingEnabled(false);
 		EMM::UninstallExceptionHandler();
+	}
 
 	return;
 }
@@ -489,6 +507,8 @@ void EmuThread()
 
 	Movie::Init();
 
+	// Emulated RAM and the JIT code space are allocated during HW::Init
+	Common::SetHugePagesEnabled(core_parameter.bHugePages);
 	HW::Init();
 
 	if (!video_backend->Initialize(s_window_handle))
@@ -589,12 +609,20 @@ void EmuThread()
 	else
 		cpuThreadFunc = CpuThread;
 
+	if (core_parameter.bTraceEvents)
+	{
+		Common::Trace::Start();
+		CoreTiming::SetEventProfiling(true);
+	}
+
 	// ENTER THE VIDEO THREAD LOOP
 	if (core_parameter.bCPUThread)
 	{
 		// This thread, after creating the EmuWindow, spawns a CPU
 		// thread, and then takes over and becomes the video thread
 		Common::SetCurrentThreadName("Video thread");
+		if (core_parameter.bRaiseThreadPriority)
+			Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
 
 		video_backend->Video_Prepare();
 
@@ -641,6 +669,21 @@ void EmuThread()
 
 	INFO_LOG(CONSOLE, "%s", StopMessage(true, "CPU thread stopped.").c_str());
 
+	if (core_parameter.bTraceEvents)
+	{
+		// Still registered until HW shutdown
+		for (const CoreTiming::EventProfile& event : CoreTiming::GetEventProfile())
+		{
+			Common::Trace::SetOtherData("CoreTiming " + event.name,
+				StringFromFormat("%" PRIu64 " scheduled, %" PRIu64 " calls, %.1f ms, %" PRIu64 " cycles late on average%s",
+					event.scheduled, event.count, event.time_us / 1000.0,
+					event.count ? event.late_cycles / event.count : 0,
+					event.high_frequency ? ", high frequency" : ""));
+		}
+		Common::Trace::Stop(File::GetUserPath(D_LOGS_IDX) + "trace.json");
+		CoreTiming::SetEventProfiling(false);
+	}
+
 	if (core_parameter.bCPUThread)
 		video_backend->Video_Cleanup();
 
@@ -891,6 +934,7 @@ void Callback_VideoCopiedToXFB(bool video_update)
 		s_drawn_frame++;
 
 	Movie::FrameUpdate();
+	State::RewindFrameUpdate();
 }
 
 void UpdateTitle()
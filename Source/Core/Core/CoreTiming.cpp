@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cinttypes>
 #include <mutex>
 #include <string>
@@ -10,18 +12,23 @@
 #include <vector>
 
 #include "Common/Assert.h"
+#include "Common/BitHelpers.h"
 #include "Common/ChunkFile.h"
 #include "Common/FifoQueue.h"
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
+#include "Common/Timer.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/PowerPC/PowerPC.h"
 
+#include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/VideoBackendBase.h"
 
 namespace CoreTiming
@@ -30,6 +37,10 @@ struct EventType
 {
 	TimedCallback callback;
 	const std::string* name;
+	u64 profile_count;
+	u64 profile_time_us;
+	u64 profile_scheduled;
+	u64 profile_late_cycles;
 };
 
 struct Event
@@ -50,16 +61,167 @@ static bool operator<(const Event& left, const Event& right)
 	return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
 }
 
+// Pending events, ordered by (time, fifo_order).
+// Nearly every event is scheduled less than a few frames of emulated VI lines ahead, so instead of
+// one binary heap the short horizon is split into a timing wheel of BUCKET_COUNT buckets of
+// 2^BUCKET_SHIFT cycles each. A bucket is a small vector kept sorted with the earliest event at the
+// back, and a bit mask tracks which buckets are occupied, so finding and popping the next event
+// doesn't have to shuffle a heap. Events past the wheel's horizon wait in an overflow min-heap and
+// move into the wheel as it turns.
+class EventQueue
+{
+public:
+	bool empty() const { return m_size == 0; }
+	size_t size() const { return m_size; }
+
+	void clear()
+	{
+		for (auto& bucket : m_buckets)
+			bucket.clear();
+		m_overflow.clear();
+		m_occupied = 0;
+		m_base = 0;
+		m_size = 0;
+	}
+
+	void push(const Event& ev)
+	{
+		m_size++;
+		Insert(ev);
+	}
+
+	// Must not be called on an empty queue.
+	const Event& top()
+	{
+		if (!m_occupied)
+			Turn();
+		return m_buckets[FirstBucket()].back();
+	}
+
+	void pop()
+	{
+		if (!m_occupied)
+			Turn();
+		size_t index = FirstBucket();
+		auto& bucket = m_buckets[index];
+		bucket.pop_back();
+		m_size--;
+		if (bucket.empty())
+		{
+			m_occupied &= ~(1ULL << index);
+			if (!m_overflow.empty())
+				Turn();
+		}
+	}
+
+	template <typename Pred>
+	void remove_if(Pred pred)
+	{
+		for (size_t i = 0; i < BUCKET_COUNT; i++)
+		{
+			auto& bucket = m_buckets[i];
+			bucket.erase(std::remove_if(bucket.begin(), bucket.end(), pred), bucket.end());
+			if (bucket.empty())
+				m_occupied &= ~(1ULL << i);
+		}
+
+		auto itr = std::remove_if(m_overflow.begin(), m_overflow.end(), pred);
+		if (itr != m_overflow.end())
+		{
+			m_overflow.erase(itr, m_overflow.end());
+			// Removing random items breaks the invariant so we have to re-establish it.
+			std::make_heap(m_overflow.begin(), m_overflow.end(), std::greater<Event>());
+		}
+
+		m_size = m_overflow.size();
+		for (const auto& bucket : m_buckets)
+			m_size += bucket.size();
+	}
+
+	// Returns every pending event, in no particular order.
+	std::vector<Event> ToVector() const
+	{
+		std::vector<Event> events(m_overflow);
+		for (const auto& bucket : m_buckets)
+			events.insert(events.end(), bucket.begin(), bucket.end());
+		return events;
+	}
+
+	void Assign(const std::vector<Event>& events)
+	{
+		clear();
+		for (const Event& ev : events)
+			push(ev);
+	}
+
+private:
+	static constexpr int BUCKET_SHIFT = 12;
+	static constexpr size_t BUCKET_COUNT = 64;
+
+	static s64 BucketOf(s64 time) { return time >> BUCKET_SHIFT; }
+	size_t FirstBucket() const
+	{
+		// Rotate the mask so that bit 0 is the wheel's current bucket.
+		size_t base = static_cast<size_t>(m_base) & (BUCKET_COUNT - 1);
+		u64 rotated = base ? (m_occupied >> base) | (m_occupied << (BUCKET_COUNT - base)) : m_occupied;
+		return (base + LeastSignificantSetBit(rotated)) & (BUCKET_COUNT - 1);
+	}
+
+	void Insert(const Event& ev)
+	{
+		// Events in the past go to the current bucket, which keeps them ordered before everything else.
+		s64 bucket_index = std::max(BucketOf(ev.time), m_base);
+		if (bucket_index - m_base >= static_cast<s64>(BUCKET_COUNT))
+		{
+			m_overflow.push_back(ev);
+			std::push_heap(m_overflow.begin(), m_overflow.end(), std::greater<Event>());
+			return;
+		}
+
+		size_t index = static_cast<size_t>(bucket_index) & (BUCKET_COUNT - 1);
+		auto& bucket = m_buckets[index];
+		bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), ev, std::greater<Event>()), ev);
+		m_occupied |= 1ULL << index;
+	}
+
+	// Moves the wheel forward to the earliest pending event and pulls the overflow events that now
+	// fall within its horizon into the buckets.
+	void Turn()
+	{
+		if (m_occupied)
+			m_base += (FirstBucket() - static_cast<size_t>(m_base)) & (BUCKET_COUNT - 1);
+		else
+			m_base = BucketOf(m_overflow.front().time);
+		while (!m_overflow.empty() &&
+			BucketOf(m_overflow.front().time) - m_base < static_cast<s64>(BUCKET_COUNT))
+		{
+			std::pop_heap(m_overflow.begin(), m_overflow.end(), std::greater<Event>());
+			Insert(m_overflow.back());
+			m_overflow.pop_back();
+		}
+	}
+
+	std::array<std::vector<Event>, BUCKET_COUNT> m_buckets;
+	std::vector<Event> m_overflow;
+	u64 m_occupied = 0;
+	s64 m_base = 0;
+	size_t m_size = 0;
+};
+
 // unordered_map stores each element separately as a linked list node so pointers to elements
 // remain stable regardless of rehashes/resizing.
 static std::unordered_map<std::string, EventType> s_event_types;
+static bool s_event_profiling = false;
+// Profiling can be requested by several users, the CPU thread applies changes in Advance
+static std::atomic<int> s_event_profiling_users{0};
+static std::atomic<bool> s_event_profile_reset{false};
+static s64 s_event_profile_start;
+
+// Events scheduled more often than this on average are flagged in the profile
+static constexpr s64 HIGH_FREQUENCY_EVENT_CYCLES = 2000;
 
 // STATE_TO_SAVE
-// The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-// We don't use std::priority_queue because we need to be able to serialize, unserialize and
-// erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't accomodated
-// by the standard adaptor class.
-static std::vector<Event> s_event_queue;
+static EventQueue s_event_queue;
 static u64 s_event_fifo_id;
 static std::mutex s_ts_write_lock;
 static Common::FifoQueue<Event, false> s_ts_queue;
@@ -168,7 +330,9 @@ void DoState(PointerWrap& p)
 	p.DoMarker("CoreTimingData");
 
 	MoveEvents();
-	p.DoEachElement(s_event_queue, [](PointerWrap& pw, Event& ev) {
+	// Saved as a flat list so the layout of the queue doesn't leak into save states.
+	std::vector<Event> events = s_event_queue.ToVector();
+	p.DoEachElement(events, [](PointerWrap& pw, Event& ev) {
 		pw.Do(ev.time);
 		pw.Do(ev.fifo_order);
 		// this is why we can't have (nice things) pointers as userdata
@@ -201,10 +365,8 @@ void DoState(PointerWrap& p)
 	p.DoMarker("CoreTimingEvents");
 
 	// When loading from a save state, we must assume the Event order is random and meaningless.
-	// The exact layout of the heap in memory is implementation defined, therefore it is platform
-	// and library version specific.
 	if (p.GetMode() == PointerWrap::MODE_READ)
-		std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+		s_event_queue.Assign(events);
 }
 
 // This should only be called from the CPU thread. If you are calling
@@ -249,13 +411,14 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
 	if (from_cpu_thread)
 	{
 		s64 timeout = GetTicks() + cycles_into_future;
+		if (s_event_profiling)
+			event_type->profile_scheduled++;
 
 		// If this event needs to be scheduled before the next advance(), force one early
 		if (!s_is_global_timer_sane)
 			ForceExceptionCheck(cycles_into_future);
 
-		s_event_queue.emplace_back(Event{ timeout, s_event_fifo_id++, userdata, event_type });
-		std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+		s_event_queue.push(Event{ timeout, s_event_fifo_id++, userdata, event_type });
 	}
 	else
 	{
@@ -273,15 +436,7 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
 
 void RemoveEvent(EventType* event_type)
 {
-	auto itr = std::remove_if(s_event_queue.begin(), s_event_queue.end(),
-		[&](const Event& e) { return e.type == event_type; });
-
-	// Removing random items breaks the invariant so we have to re-establish it.
-	if (itr != s_event_queue.end())
-	{
-		s_event_queue.erase(itr, s_event_queue.end());
-		std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-	}
+	s_event_queue.remove_if([&](const Event& e) { return e.type == event_type; });
 }
 
 void RemoveAllEvents(EventType* event_type)
@@ -294,13 +449,14 @@ void RemoveAllEvents(EventType* event_type)
 void ProcessFifoWaitEvents()
 {
 	MoveEvents();
-	while (!s_event_queue.empty() && s_event_queue.front().time <= g_global_timer)
+	DeliverGPUInterrupts();
+	while (!s_event_queue.empty() && s_event_queue.top().time <= g_global_timer)
 	{
-		Event evt = std::move(s_event_queue.front());
-		std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-		s_event_queue.pop_back();
+		Event evt = s_event_queue.top();
+		s_event_queue.pop();
 		// NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
 		//            g_global_timer, evt.time);
+		Common::Trace::Scope event_scope(evt.type->name->c_str());
 		evt.type->callback(evt.userdata, g_global_timer - evt.time);
 	}
 }
@@ -317,18 +473,44 @@ void ForceExceptionCheck(s64 cycles)
 	}
 }
 
+void DeliverGPUInterrupts()
+{
+	// Posted without a lock by the GPU thread in dual core, delivered where the events scheduled
+	// from other threads would have run
+	CommandProcessor::DeliverPendingInterrupts();
+	PixelEngine::DeliverPendingInterrupts();
+}
+
 void MoveEvents()
 {
 	for (Event ev; s_ts_queue.Pop(ev);)
 	{
+		// Counted here, the types must not be written from other threads
+		if (s_event_profiling)
+			ev.type->profile_scheduled++;
 		ev.fifo_order = s_event_fifo_id++;
-		s_event_queue.emplace_back(std::move(ev));
-		std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+		s_event_queue.push(ev);
+	}
+}
+
+static void ResetEventProfile()
+{
+	for (auto& entry : s_event_types)
+	{
+		entry.second.profile_count = 0;
+		entry.second.profile_time_us = 0;
+		entry.second.profile_scheduled = 0;
+		entry.second.profile_late_cycles = 0;
 	}
+	s_event_profile_start = g_global_timer;
 }
 
 void Advance()
 {
+	TRACE_SCOPE("CoreTiming::Advance");
+	s_event_profiling = s_event_profiling_users.load(std::memory_order_relaxed) > 0;
+	if (s_event_profiling && s_event_profile_reset.exchange(false))
+		ResetEventProfile();
 	MoveEvents();
 
 	int cyclesExecuted = g_slice_length - DowncountToCycles(PowerPC::ppcState.downcount);
@@ -339,14 +521,26 @@ void Advance()
 
 	s_is_global_timer_sane = true;
 
-	while (!s_event_queue.empty() && s_event_queue.front().time <= g_global_timer)
+	DeliverGPUInterrupts();
+
+	while (!s_event_queue.empty() && s_event_queue.top().time <= g_global_timer)
 	{
-		Event evt = std::move(s_event_queue.front());
-		std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-		s_event_queue.pop_back();
+		Event evt = s_event_queue.top();
+		s_event_queue.pop();
 		// NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
 		//            g_global_timer, evt.time);
+		Common::Trace::Scope event_scope(evt.type->name->c_str());
+		if (!s_event_profiling)
+		{
+			evt.type->callback(evt.userdata, g_global_timer - evt.time);
+			continue;
+		}
+
+		const u64 begin_us = Common::Timer::GetTimeUs();
 		evt.type->callback(evt.userdata, g_global_timer - evt.time);
+		evt.type->profile_count++;
+		evt.type->profile_late_cycles += g_global_timer - evt.time;
+		evt.type->profile_time_us += Common::Timer::GetTimeUs() - begin_us;
 	}
 
 	s_is_global_timer_sane = false;
@@ -355,7 +549,7 @@ void Advance()
 	if (!s_event_queue.empty())
 	{
 		g_slice_length = static_cast<int>(
-			std::min<s64>(s_event_queue.front().time - g_global_timer, MAX_SLICE_LENGTH));
+			std::min<s64>(s_event_queue.top().time - g_global_timer, MAX_SLICE_LENGTH));
 	}
 
 	PowerPC::ppcState.downcount = CyclesToDowncount(g_slice_length);
@@ -369,7 +563,7 @@ void Advance()
 
 void LogPendingEvents()
 {
-	auto clone = s_event_queue;
+	auto clone = s_event_queue.ToVector();
 	std::sort(clone.begin(), clone.end());
 	for (const Event& ev : clone)
 	{
@@ -392,12 +586,56 @@ void Idle()
 	PowerPC::ppcState.downcount = 0;
 }
 
+void SetEventProfiling(bool enabled)
+{
+	if (!enabled)
+		s_event_profiling_users--;
+	else if (s_event_profiling_users++ == 0)
+		s_event_profile_reset.store(true);
+}
+
+std::vector<EventProfile> GetEventProfile()
+{
+	const s64 elapsed = g_global_timer - s_event_profile_start;
+	std::vector<EventProfile> profile;
+	for (const auto& entry : s_event_types)
+	{
+		const EventType& type = entry.second;
+		if (!type.profile_count && !type.profile_scheduled)
+			continue;
+		const bool high_frequency =
+			type.profile_scheduled && elapsed / static_cast<s64>(type.profile_scheduled) < HIGH_FREQUENCY_EVENT_CYCLES;
+		profile.push_back({entry.first, type.profile_count, type.profile_time_us, type.profile_scheduled,
+			type.profile_late_cycles, high_frequency});
+	}
+	std::sort(profile.begin(), profile.end(),
+		[](const EventProfile& a, const EventProfile& b) { return a.time_us > b.time_us; });
+	return profile;
+}
+
+std::string GetEventProfileString(size_t max_events)
+{
+	const std::vector<EventProfile> profile = GetEventProfile();
+	if (profile.empty())
+		return "";
+
+	std::string text = StringFromFormat("%-24s %10s %10s %9s %9s\n", "Event", "scheduled", "calls", "ms", "late");
+	for (size_t i = 0; i < profile.size() && i < max_events; i++)
+	{
+		const EventProfile& event = profile[i];
+		text += StringFromFormat("%-24s %10" PRIu64 " %10" PRIu64 " %9.1f %9" PRIu64 "%s\n", event.name.c_str(),
+			event.scheduled, event.count, event.time_us / 1000.0,
+			event.count ? event.late_cycles / event.count : 0, event.high_frequency ? " high frequency" : "");
+	}
+	return text;
+}
+
 std::string GetScheduledEventsSummary()
 {
 	std::string text = "Scheduled events\n";
 	text.reserve(1000);
 
-	auto clone = s_event_queue;
+	auto clone = s_event_queue.ToVector();
 	std::sort(clone.begin(), clone.end());
 	for (const Event& ev : clone)
 	{
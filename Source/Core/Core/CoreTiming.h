@@ -18,6 +18,8 @@
 //   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
 
 #include <string>
+#include <vector>
+
 #include "Common/CommonTypes.h"
 
 class PointerWrap;
@@ -80,6 +82,8 @@ void RemoveAllEvents(EventType* event_type);
 // NOTE: Advance updates the PowerPC downcount and performs a PPC external exception check.
 void Advance();
 void MoveEvents();
+// Delivers the CP and PE interrupts the GPU thread posted since the last call
+void DeliverGPUInterrupts();
 void ProcessFifoWaitEvents();
 
 // Pretend that the main CPU has executed enough cycles to reach the next event.
@@ -92,6 +96,27 @@ void LogPendingEvents();
 
 std::string GetScheduledEventsSummary();
 
+// Wall clock time spent in the callbacks of every event type, how often it was scheduled and how
+// many cycles its callbacks ran late in total, since profiling was enabled.
+struct EventProfile
+{
+	std::string name;
+	u64 count;
+	u64 time_us;
+	u64 scheduled;
+	u64 late_cycles;
+	// Scheduled more than once every few thousand cycles on average
+	bool high_frequency;
+};
+// Calls must be paired, profiling stays on while anybody enabled it. The counters restart at the
+// next slice when it is turned on.
+void SetEventProfiling(bool enabled);
+// Sorted by time, most expensive first. Safe to call from other threads, the counters of the
+// running slice may be slightly out of date.
+std::vector<EventProfile> GetEventProfile();
+// The most expensive events as a table, with the average lateness in cycles
+std::string GetEventProfileString(size_t max_events = 10);
+
 u32 GetFakeDecStartValue();
 void SetFakeDecStartValue(u32 val);
 u64 GetFakeDecStartTicks();
@@ -7,6 +7,7 @@
 #include <array>
 #include <cstddef>
 
+#include "Common/CommonFuncs.h"
 #include "Common/Logging/Log.h"
 
 #include "Core/DSP/DSPMemoryMap.h"
@@ -26,50 +27,94 @@ std::array<u8, ISPACE> code_flags;
 // as well give up its time slice immediately, after executing once.
 
 // Max signature length is 6. A 0 in a signature is ignored.
-constexpr size_t NUM_IDLE_SIGS = 8;
 constexpr size_t MAX_IDLE_SIG_SIZE = 6;
 
-// 0xFFFF means ignore.
-constexpr u16 idle_skip_sigs[NUM_IDLE_SIGS][MAX_IDLE_SIG_SIZE + 1] = {
+struct IdleSignature
+{
+	// 0xFFFF means ignore.
+	u16 code[MAX_IDLE_SIG_SIZE + 1];
+	IdleWait wait;
+};
+
+constexpr IdleSignature idle_skip_sigs[] = {
 	// From AX:
-	{0x26fc,          // LRS   $30, @DMBH
-	 0x02c0, 0x8000,  // ANDCF $30, #0x8000
-	 0x029d, 0xFFFF,  // JLZ 0x027a
-	 0, 0},           // RET
-	{0x27fc,          // LRS   $31, @DMBH
-	 0x03c0, 0x8000,  // ANDCF $31, #0x8000
-	 0x029d, 0xFFFF,  // JLZ 0x027a
-	 0, 0},           // RET
-	{0x26fe,          // LRS   $30, @CMBH
-	 0x02c0, 0x8000,  // ANDCF $30, #0x8000
-	 0x029c, 0xFFFF,  // JLNZ 0x0280
-	 0, 0},           // RET
-	{0x27fe,          // LRS   $31, @CMBH
-	 0x03c0, 0x8000,  // ANDCF $31, #0x8000
-	 0x029c, 0xFFFF,  // JLNZ 0x0280
-	 0, 0},           // RET
-	{0x26fc,          // LRS  $AC0.M, @DMBH
-	 0x02a0, 0x8000,  // ANDF $AC0.M, #0x8000
-	 0x029c, 0xFFFF,  // JLNZ 0x????
-	 0, 0},
-	{0x27fc,          // LRS  $AC1.M, @DMBH
-	 0x03a0, 0x8000,  // ANDF $AC1.M, #0x8000
-	 0x029c, 0xFFFF,  // JLNZ 0x????
-	 0, 0},
-	 // From Zelda:
-	 {0x00de, 0xFFFE,  // LR    $AC0.M, @CMBH
-		0x02c0, 0x8000,  // ANDCF $AC0.M, #0x8000
-		0x029c, 0xFFFF,  // JLNZ 0x05cf
-		0},
-		// From Zelda - experimental
-		{0x00da, 0x0352,  // LR     $AX0.H, @0x0352
-		 0x8600,          // TSTAXH $AX0.H
-		 0x0295, 0xFFFF,  // JZ    0x????
-		 0, 0} };
+	{{0x26fc,          // LRS   $30, @DMBH
+	  0x02c0, 0x8000,  // ANDCF $30, #0x8000
+	  0x029d, 0xFFFF,  // JLZ 0x027a
+	  0, 0},           // RET
+	 IdleWait::DSPMailRead},
+	{{0x27fc,          // LRS   $31, @DMBH
+	  0x03c0, 0x8000,  // ANDCF $31, #0x8000
+	  0x029d, 0xFFFF,  // JLZ 0x027a
+	  0, 0},           // RET
+	 IdleWait::DSPMailRead},
+	{{0x26fe,          // LRS   $30, @CMBH
+	  0x02c0, 0x8000,  // ANDCF $30, #0x8000
+	  0x029c, 0xFFFF,  // JLNZ 0x0280
+	  0, 0},           // RET
+	 IdleWait::CPUMail},
+	{{0x27fe,          // LRS   $31, @CMBH
+	  0x03c0, 0x8000,  // ANDCF $31, #0x8000
+	  0x029c, 0xFFFF,  // JLNZ 0x0280
+	  0, 0},           // RET
+	 IdleWait::CPUMail},
+	{{0x26fc,          // LRS  $AC0.M, @DMBH
+	  0x02a0, 0x8000,  // ANDF $AC0.M, #0x8000
+	  0x029c, 0xFFFF,  // JLNZ 0x????
+	  0, 0},
+	 IdleWait::DSPMailRead},
+	{{0x27fc,          // LRS  $AC1.M, @DMBH
+	  0x03a0, 0x8000,  // ANDF $AC1.M, #0x8000
+	  0x029c, 0xFFFF,  // JLNZ 0x????
+	  0, 0},
+	 IdleWait::DSPMailRead},
+	// The ANDF variant of the CMBH loops
+	{{0x26fe,          // LRS  $AC0.M, @CMBH
+	  0x02a0, 0x8000,  // ANDF $AC0.M, #0x8000
+	  0x029d, 0xFFFF,  // JLZ 0x????
+	  0, 0},
+	 IdleWait::CPUMail},
+	{{0x27fe,          // LRS  $AC1.M, @CMBH
+	  0x03a0, 0x8000,  // ANDF $AC1.M, #0x8000
+	  0x029d, 0xFFFF,  // JLZ 0x????
+	  0, 0},
+	 IdleWait::CPUMail},
+	// From Zelda:
+	{{0x00de, 0xFFFE,  // LR    $AC0.M, @CMBH
+	  0x02c0, 0x8000,  // ANDCF $AC0.M, #0x8000
+	  0x029c, 0xFFFF,  // JLNZ 0x05cf
+	  0},
+	 IdleWait::CPUMail},
+	// Long form of the loops above with the other accumulator or mailbox
+	{{0x00df, 0xFFFE,  // LR    $AC1.M, @CMBH
+	  0x03c0, 0x8000,  // ANDCF $AC1.M, #0x8000
+	  0x029c, 0xFFFF,  // JLNZ 0x????
+	  0},
+	 IdleWait::CPUMail},
+	{{0x00de, 0xFFFC,  // LR    $AC0.M, @DMBH
+	  0x02c0, 0x8000,  // ANDCF $AC0.M, #0x8000
+	  0x029d, 0xFFFF,  // JLZ 0x????
+	  0},
+	 IdleWait::DSPMailRead},
+	{{0x00df, 0xFFFC,  // LR    $AC1.M, @DMBH
+	  0x03c0, 0x8000,  // ANDCF $AC1.M, #0x8000
+	  0x029d, 0xFFFF,  // JLZ 0x????
+	  0},
+	 IdleWait::DSPMailRead},
+	// From Zelda - experimental, waits for DRAM written by the ucode itself
+	{{0x00da, 0x0352,  // LR     $AX0.H, @0x0352
+	  0x8600,          // TSTAXH $AX0.H
+	  0x0295, 0xFFFF,  // JZ    0x????
+	  0, 0},
+	 IdleWait::None} };
+
+// What the idle loops found by the analysis wait for.
+std::array<IdleWait, ISPACE> idle_waits;
 
 void Reset()
 {
 	code_flags.fill(0);
+	idle_waits.fill(IdleWait::None);
 }
 
 void AnalyzeRange(u16 start_addr, u16 end_addr)
@@ -128,24 +173,26 @@ void AnalyzeRange(u16 start_addr, u16 end_addr)
 	}
 
 	// Next, we'll scan for potential idle skips.
-	for (int s = 0; s < NUM_IDLE_SIGS; s++)
+	for (size_t s = 0; s < ArraySize(idle_skip_sigs); s++)
 	{
+		const IdleSignature& sig = idle_skip_sigs[s];
 		for (u16 addr = start_addr; addr < end_addr; addr++)
 		{
 			bool found = false;
-			for (int i = 0; i < MAX_IDLE_SIG_SIZE + 1; i++)
+			for (size_t i = 0; i < MAX_IDLE_SIG_SIZE + 1; i++)
 			{
-				if (idle_skip_sigs[s][i] == 0)
+				if (sig.code[i] == 0)
 					found = true;
-				if (idle_skip_sigs[s][i] == 0xFFFF)
+				if (sig.code[i] == 0xFFFF)
 					continue;
-				if (idle_skip_sigs[s][i] != dsp_imem_read(addr + i))
+				if (sig.code[i] != dsp_imem_read(addr + i))
 					break;
 			}
 			if (found)
 			{
-				INFO_LOG(DSPLLE, "Idle skip location found at %02x (sigNum:%d)", addr, s + 1);
+				INFO_LOG(DSPLLE, "Idle skip location found at %02x (sigNum:%zu)", addr, s + 1);
 				code_flags[addr] |= CODE_IDLE_SKIP;
+				idle_waits[addr] = sig.wait;
 			}
 		}
 	}
@@ -165,4 +212,9 @@ u8 GetCodeFlags(u16 address)
 	return code_flags[address];
 }
 
+IdleWait GetIdleWait(u16 address)
+{
+	return idle_waits[address];
+}
+
 }  // namespace DSPAnalyzer
@@ -22,6 +22,14 @@ enum
 	CODE_CHECK_INT = 32,
 };
 
+// What an idle skip location polls the mailboxes for.
+enum class IdleWait : u8
+{
+	None,         // Unknown, the loop has to keep running
+	CPUMail,      // Until the CPU writes a new mail (CMBH bit 15 set)
+	DSPMailRead,  // Until the CPU read the DSP's mail (DMBH bit 15 cleared)
+};
+
 // This one should be called every time IRAM changes - which is basically
 // every time that a new ucode gets uploaded, and never else. At that point,
 // we can do as much static analysis as we want - but we should always throw
@@ -33,4 +41,7 @@ void Analyze();
 // Retrieves the flags set during analysis for code in memory.
 u8 GetCodeFlags(u16 address);
 
+// IdleWait::None unless address has CODE_IDLE_SKIP set.
+IdleWait GetIdleWait(u16 address);
+
 }  // namespace DSPAnalyzer
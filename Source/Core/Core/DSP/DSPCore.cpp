@@ -146,9 +146,12 @@ bool DSPCore_Init(const DSPInitOptions& opts)
 	// in new ucodes.
 	Common::WriteProtectMemory(g_dsp.iram, DSP_IRAM_BYTE_SIZE, false);
 
-	// Initialize JIT, if necessary
+	// Initialize JIT, if necessary. The DSP recompiler only emits x86-64 code, so other
+	// hosts always run the interpreter.
+#if defined(_M_X86_64)
 	if (opts.core_type == DSPInitOptions::CORE_JIT)
 		g_dsp_jit = std::make_unique<DSPEmitter>();
+#endif
 
 	g_dsp_cap.reset(opts.capture_logger);
 
@@ -253,6 +253,7 @@ void DSPEmitter::Compile(u16 start_addr)
 			// end of each block and in this order
 			DSPJitRegCache c(gpr);
 			HandleLoop();
+			WriteDynamicBlockLink();
 			gpr.SaveRegs();
 			if (!DSPHost::OnThread() &&
 				DSPAnalyzer::GetCodeFlags(start_addr) & DSPAnalyzer::CODE_IDLE_SKIP)
@@ -288,6 +289,7 @@ void DSPEmitter::Compile(u16 start_addr)
 
 				DSPJitRegCache c(gpr);
 				// don't update g_dsp.pc -- the branch insn already did
+				WriteDynamicBlockLink();
 				gpr.SaveRegs();
 				if (!DSPHost::OnThread() &&
 					DSPAnalyzer::GetCodeFlags(start_addr) & DSPAnalyzer::CODE_IDLE_SKIP)
@@ -352,6 +354,7 @@ void DSPEmitter::Compile(u16 start_addr)
 		blockSize[start_addr] = 1;
 	}
 
+	WriteDynamicBlockLink();
 	gpr.SaveRegs();
 	if (!DSPHost::OnThread() && DSPAnalyzer::GetCodeFlags(start_addr) & DSPAnalyzer::CODE_IDLE_SKIP)
 	{
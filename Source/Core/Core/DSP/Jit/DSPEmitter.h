@@ -120,6 +120,7 @@ public:
 
 	// Branch
 	void HandleLoop();
+	void WriteDynamicBlockLink();
 	void jcc(const UDSPInstruction opc);
 	void jmprcc(const UDSPInstruction opc);
 	void call(const UDSPInstruction opc);
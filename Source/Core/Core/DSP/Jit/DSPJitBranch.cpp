@@ -6,6 +6,7 @@
 
 #include "Core/DSP/DSPAnalyzer.h"
 #include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPHost.h"
 #include "Core/DSP/DSPMemoryMap.h"
 #include "Core/DSP/DSPTables.h"
 #include "Core/DSP/Jit/DSPEmitter.h"
@@ -80,6 +81,7 @@ static void ReJitConditional(const UDSPInstruction opc, DSPEmitter& emitter)
 static void WriteBranchExit(DSPEmitter& emitter)
 {
 	DSPJitRegCache c(emitter.gpr);
+	emitter.WriteDynamicBlockLink();
 	emitter.gpr.SaveRegs();
 	if (DSPAnalyzer::GetCodeFlags(emitter.startAddr) & DSPAnalyzer::CODE_IDLE_SKIP)
 	{
@@ -122,6 +124,52 @@ static void WriteBlockLink(DSPEmitter& emitter, u16 dest)
 	}
 }
 
+// For exits whose destination is only known at runtime (returns, indirect jumps, loops and
+// falling through into the next block). Jumps straight into the block at g_dsp.pc if it is
+// linkable and enough cycles are left, like WriteBlockLink does for constant destinations,
+// otherwise falls through to the dispatcher exit. Leaves gpr flushed either way.
+void DSPEmitter::WriteDynamicBlockLink()
+{
+	// Idle skipping blocks have to go through the dispatcher to give up their cycles
+	if (DSPAnalyzer::GetCodeFlags(startAddr) & DSPAnalyzer::CODE_IDLE_SKIP)
+		return;
+
+	gpr.FlushRegs();
+
+	// The dispatcher checks these before running a block
+	TEST(8, M(&g_dsp.cr), Imm8(CR_HALT));
+	FixupBranch halted = J_CC(CC_NZ);
+	FixupBranch interrupted;
+	if (DSPHost::OnThread())
+	{
+		CMP(8, M(const_cast<bool*>(&g_dsp.external_interrupt_waiting)), Imm8(0));
+		interrupted = J_CC(CC_NE);
+	}
+
+	MOVZX(64, 16, RCX, M(&g_dsp.pc));
+	MOV(64, R(RAX), ImmPtr(blockLinks.data()));
+	MOV(64, R(RAX), MComplex(RAX, RCX, SCALE_8, 0));
+	TEST(64, R(RAX), R(RAX));
+	FixupBranch notLinkable = J_CC(CC_Z);
+
+	// Check if we have enough cycles to execute the next block
+	MOV(64, R(RDX), ImmPtr(blockSize.data()));
+	MOVZX(32, 16, EDX, MComplex(RDX, RCX, SCALE_2, 0));
+	ADD(32, R(EDX), Imm32(blockSize[startAddr]));
+	MOVZX(32, 16, ECX, M(&g_cycles_left));
+	CMP(32, R(ECX), R(EDX));
+	FixupBranch notEnoughCycles = J_CC(CC_BE);
+
+	SUB(16, M(&g_cycles_left), Imm16(blockSize[startAddr]));
+	JMPptr(R(RAX));
+
+	SetJumpTarget(halted);
+	if (DSPHost::OnThread())
+		SetJumpTarget(interrupted);
+	SetJumpTarget(notLinkable);
+	SetJumpTarget(notEnoughCycles);
+}
+
 static void r_jcc(const UDSPInstruction opc, DSPEmitter& emitter)
 {
 	u16 dest = dsp_imem_read(emitter.compilePC + 1);
@@ -18,8 +18,8 @@
 
 namespace FifoAnalyzer
 {
-bool s_DrawingObject;
-FifoAnalyzer::CPMemory s_CpMem;
+thread_local bool s_DrawingObject;
+thread_local FifoAnalyzer::CPMemory s_CpMem;
 
 void Init()
 {
@@ -36,6 +36,7 @@ void LoadCPReg(u32 subCmd, u32 value, CPMemory& cpMem);
 
 void CalculateVertexElementSizes(int sizes[], int vatIndex, const CPMemory& cpMem);
 
-extern bool s_DrawingObject;
-extern FifoAnalyzer::CPMemory s_CpMem;
+// Per thread, so playback analysis can run frames on several threads
+extern thread_local bool s_DrawingObject;
+extern thread_local FifoAnalyzer::CPMemory s_CpMem;
 }
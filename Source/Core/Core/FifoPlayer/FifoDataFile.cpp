@@ -3,7 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <map>
 #include <string>
+#include <utility>
 
 #include "Common/FileUtil.h"
 
@@ -35,9 +37,9 @@ bool FifoDataFile::GetIsWii() const
 	return GetFlag(FLAG_IS_WII);
 }
 
-void FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
+void FifoDataFile::AddFrame(FifoFrameInfo frameInfo)
 {
-	m_Frames.push_back(frameInfo);
+	m_Frames.push_back(std::move(frameInfo));
 }
 
 bool FifoDataFile::Save(const std::string& filename)
@@ -97,6 +99,9 @@ bool FifoDataFile::Save(const std::string& filename)
 	file.Seek(0, SEEK_SET);
 	file.WriteBytes(&header, sizeof(FileHeader));
 
+	// Shared update data is only written once, the updates point at the same offset
+	std::map<const std::vector<u8>*, u64> writtenData;
+
 	// Write frames list
 	for (unsigned int i = 0; i < m_Frames.size(); ++i)
 	{
@@ -107,7 +112,7 @@ bool FifoDataFile::Save(const std::string& filename)
 		u64 dataOffset = file.Tell();
 		file.WriteBytes(srcFrame.fifoData.data(), srcFrame.fifoData.size());
 
-		u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, file);
+		u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, writtenData, file);
 
 		FileFrameInfo dstFrame;
 		dstFrame.fifoDataSize = static_cast<u32>(srcFrame.fifoData.size());
@@ -181,6 +186,9 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
 		file.ReadArray(dataFile->m_TexMem, size);
 	}
 
+	// Updates written from the same data are shared again
+	std::map<std::pair<u64, u32>, std::shared_ptr<const std::vector<u8>>> readData;
+
 	// Read frames
 	for (u32 i = 0; i < header.frameCount; ++i)
 	{
@@ -198,9 +206,9 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
 		file.ReadBytes(dstFrame.fifoData.data(), srcFrame.fifoDataSize);
 
 		ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates,
-			dstFrame.memoryUpdates, file);
+			dstFrame.memoryUpdates, readData, file);
 
-		dataFile->AddFrame(dstFrame);
+		dataFile->AddFrame(std::move(dstFrame));
 	}
 
 	file.Close();
@@ -228,6 +236,7 @@ bool FifoDataFile::GetFlag(u32 flag) const
 }
 
 u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
+	std::map<const std::vector<u8>*, u64>& writtenData,
 	File::IOFile& file)
 {
 	// Add space for memory update list
@@ -238,15 +247,25 @@ u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates
 	{
 		const MemoryUpdate& srcUpdate = memUpdates[i];
 
-		// Write memory
-		file.Seek(0, SEEK_END);
-		u64 dataOffset = file.Tell();
-		file.WriteBytes(srcUpdate.data.data(), srcUpdate.data.size());
+		// Write memory, unless an earlier update already wrote the same data
+		u64 dataOffset;
+		auto written = writtenData.find(srcUpdate.data.get());
+		if (written != writtenData.end())
+		{
+			dataOffset = written->second;
+		}
+		else
+		{
+			file.Seek(0, SEEK_END);
+			dataOffset = file.Tell();
+			file.WriteBytes(srcUpdate.data->data(), srcUpdate.data->size());
+			writtenData.emplace(srcUpdate.data.get(), dataOffset);
+		}
 
 		FileMemoryUpdate dstUpdate;
 		dstUpdate.address = srcUpdate.address;
 		dstUpdate.dataOffset = dataOffset;
-		dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
+		dstUpdate.dataSize = static_cast<u32>(srcUpdate.data->size());
 		dstUpdate.fifoPosition = srcUpdate.fifoPosition;
 		dstUpdate.type = srcUpdate.type;
 
@@ -259,7 +278,9 @@ u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates
 }
 
 void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
-	std::vector<MemoryUpdate>& memUpdates, File::IOFile& file)
+	std::vector<MemoryUpdate>& memUpdates,
+	std::map<std::pair<u64, u32>, std::shared_ptr<const std::vector<u8>>>& readData,
+	File::IOFile& file)
 {
 	memUpdates.resize(numUpdates);
 
@@ -273,10 +294,17 @@ void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
 		MemoryUpdate& dstUpdate = memUpdates[i];
 		dstUpdate.address = srcUpdate.address;
 		dstUpdate.fifoPosition = srcUpdate.fifoPosition;
-		dstUpdate.data.resize(srcUpdate.dataSize);
 		dstUpdate.type = static_cast<MemoryUpdate::Type>(srcUpdate.type);
 
-		file.Seek(srcUpdate.dataOffset, SEEK_SET);
-		file.ReadBytes(dstUpdate.data.data(), srcUpdate.dataSize);
+		std::shared_ptr<const std::vector<u8>>& data =
+			readData[std::make_pair(srcUpdate.dataOffset, srcUpdate.dataSize)];
+		if (!data)
+		{
+			auto newData = std::make_shared<std::vector<u8>>(srcUpdate.dataSize);
+			file.Seek(srcUpdate.dataOffset, SEEK_SET);
+			file.ReadBytes(newData->data(), srcUpdate.dataSize);
+			data = std::move(newData);
+		}
+		dstUpdate.data = data;
 	}
 }
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -27,7 +29,9 @@ struct MemoryUpdate
 
 	u32 fifoPosition;
 	u32 address;
-	std::vector<u8> data;
+	// Updates with the same contents share it, games often switch between a few textures or
+	// vertex buffers at one address every frame
+	std::shared_ptr<const std::vector<u8>> data;
 	Type type;
 };
 
@@ -66,7 +70,7 @@ public:
 	u32* GetXFMem() { return m_XFMem; }
 	u32* GetXFRegs() { return m_XFRegs; }
 	u8* GetTexMem() { return m_TexMem; }
-	void AddFrame(const FifoFrameInfo& frameInfo);
+	void AddFrame(FifoFrameInfo frameInfo);
 	const FifoFrameInfo& GetFrame(u32 frame) const { return m_Frames[frame]; }
 	u32 GetFrameCount() const { return static_cast<u32>(m_Frames.size()); }
 	bool Save(const std::string& filename);
@@ -84,9 +88,12 @@ private:
 	void SetFlag(u32 flag, bool set);
 	bool GetFlag(u32 flag) const;
 
-	u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
+	u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
+		std::map<const std::vector<u8>*, u64>& writtenData, File::IOFile& file);
 	static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
-		std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
+		std::vector<MemoryUpdate>& memUpdates,
+		std::map<std::pair<u64, u32>, std::shared_ptr<const std::vector<u8>>>& readData,
+		File::IOFile& file);
 
 	u32 m_BPMem[BP_MEM_SIZE];
 	u32 m_CPMem[CP_MEM_SIZE];
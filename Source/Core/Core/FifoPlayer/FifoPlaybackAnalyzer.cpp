@@ -4,7 +4,12 @@
 
 #include "Core/FifoPlayer/FifoPlaybackAnalyzer.h"
 
+#include <algorithm>
+
+#include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+#include "Common/ThreadPool.h"
 #include "Core/FifoPlayer/FifoAnalyzer.h"
 #include "Core/FifoPlayer/FifoDataFile.h"
 
@@ -19,82 +24,236 @@ struct CmdData
 	const u8* ptr;
 };
 
-void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
-	std::vector<AnalyzedFrameInfo>& frameInfo)
+// Bump this whenever the analysis results change
+static const u32 ANALYSIS_CACHE_REVISION = 1;
+
+namespace
 {
-	u32* cpMem = file->GetCPMem();
-	FifoAnalyzer::LoadCPReg(0x50, cpMem[0x50], s_CpMem);
-	FifoAnalyzer::LoadCPReg(0x60, cpMem[0x60], s_CpMem);
+// Analysis results as stored next to the log. Memory updates are kept as a count, they are
+// always a prefix of the frame's updates.
+struct AnalysisCache
+{
+	u64 file_hash = 0;
+	std::vector<std::vector<u32>> object_starts;
+	std::vector<std::vector<u32>> object_ends;
+	std::vector<u32> memory_update_counts;
 
-	for (int i = 0; i < 8; ++i)
+	void DoState(PointerWrap& p)
 	{
-		FifoAnalyzer::LoadCPReg(0x70 + i, cpMem[0x70 + i], s_CpMem);
-		FifoAnalyzer::LoadCPReg(0x80 + i, cpMem[0x80 + i], s_CpMem);
-		FifoAnalyzer::LoadCPReg(0x90 + i, cpMem[0x90 + i], s_CpMem);
+		p.Do(file_hash);
+		p.Do(object_starts);
+		p.Do(object_ends);
+		p.Do(memory_update_counts);
 	}
+};
+}
 
-	frameInfo.clear();
-	frameInfo.resize(file->GetFrameCount());
+static std::string GetCachePath(const std::string& filename)
+{
+	return filename + ".analysis";
+}
 
-	for (u32 frameIdx = 0; frameIdx < file->GetFrameCount(); ++frameIdx)
+static u64 HashFrames(const FifoDataFile* file)
+{
+	u64 hash = file->GetFrameCount();
+	for (u32 i = 0; i < file->GetFrameCount(); ++i)
 	{
-		const FifoFrameInfo& frame = file->GetFrame(frameIdx);
-		AnalyzedFrameInfo& analyzed = frameInfo[frameIdx];
+		const FifoFrameInfo& frame = file->GetFrame(i);
+		const u64 frame_hash = frame.fifoData.empty() ?
+			0 :
+			GetHash64(frame.fifoData.data(), static_cast<u32>(frame.fifoData.size()), 0);
+		hash = hash * 31 + frame_hash + frame.memoryUpdates.size();
+	}
+	return hash;
+}
 
-		s_DrawingObject = false;
+// Only these affect the size of the commands during playback
+static bool SameVertexState(const CPMemory& a, const CPMemory& b)
+{
+	if (a.vtxDesc.Hex != b.vtxDesc.Hex)
+		return false;
+	for (int i = 0; i < 8; ++i)
+	{
+		if (a.vtxAttr[i].g0.Hex != b.vtxAttr[i].g0.Hex || a.vtxAttr[i].g1.Hex != b.vtxAttr[i].g1.Hex ||
+			a.vtxAttr[i].g2.Hex != b.vtxAttr[i].g2.Hex)
+			return false;
+	}
+	return true;
+}
+
+// Analyzes one frame starting from the CP state in s_CpMem, which is left at the state the frame
+// ends with. Returns false if the frame contains a command that can't be decoded.
+static bool AnalyzeFrame(const FifoFrameInfo& frame, AnalyzedFrameInfo& analyzed)
+{
+	analyzed = AnalyzedFrameInfo();
 
-		u32 cmdStart = 0;
-		u32 nextMemUpdate = 0;
+	s_DrawingObject = false;
+
+	u32 cmdStart = 0;
+	u32 nextMemUpdate = 0;
 
 #if LOG_FIFO_CMDS
-		// Debugging
-		std::vector<CmdData> prevCmds;
+	// Debugging
+	std::vector<CmdData> prevCmds;
 #endif
 
-		while (cmdStart < frame.fifoData.size())
+	while (cmdStart < frame.fifoData.size())
+	{
+		// Add memory updates that have occurred before this point in the frame
+		while (nextMemUpdate < frame.memoryUpdates.size() &&
+			frame.memoryUpdates[nextMemUpdate].fifoPosition <= cmdStart)
 		{
-			// Add memory updates that have occurred before this point in the frame
-			while (nextMemUpdate < frame.memoryUpdates.size() &&
-				frame.memoryUpdates[nextMemUpdate].fifoPosition <= cmdStart)
-			{
-				analyzed.memoryUpdates.push_back(frame.memoryUpdates[nextMemUpdate]);
-				++nextMemUpdate;
-			}
+			analyzed.memoryUpdates.push_back(frame.memoryUpdates[nextMemUpdate]);
+			++nextMemUpdate;
+		}
 
-			bool wasDrawing = s_DrawingObject;
+		bool wasDrawing = s_DrawingObject;
 
-			u32 cmdSize = FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DECODE_PLAYBACK);
+		u32 cmdSize = FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DECODE_PLAYBACK);
 
 #if LOG_FIFO_CMDS
-			CmdData cmdData;
-			cmdData.offset = cmdStart;
-			cmdData.ptr = &frame.fifoData[cmdStart];
-			cmdData.size = cmdSize;
-			prevCmds.push_back(cmdData);
+		CmdData cmdData;
+		cmdData.offset = cmdStart;
+		cmdData.ptr = &frame.fifoData[cmdStart];
+		cmdData.size = cmdSize;
+		prevCmds.push_back(cmdData);
 #endif
 
-			// Check for error
-			if (cmdSize == 0)
-			{
-				// Clean up frame analysis
-				analyzed.objectStarts.clear();
-				analyzed.objectEnds.clear();
+		// Check for error
+		if (cmdSize == 0)
+		{
+			// Clean up frame analysis
+			analyzed.objectStarts.clear();
+			analyzed.objectEnds.clear();
 
-				return;
-			}
+			return false;
+		}
+
+		if (wasDrawing != s_DrawingObject)
+		{
+			if (s_DrawingObject)
+				analyzed.objectStarts.push_back(cmdStart);
+			else
+				analyzed.objectEnds.push_back(cmdStart);
+		}
+
+		cmdStart += cmdSize;
+	}
+
+	if (analyzed.objectEnds.size() < analyzed.objectStarts.size())
+		analyzed.objectEnds.push_back(cmdStart);
 
-			if (wasDrawing != s_DrawingObject)
+	return true;
+}
+
+void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
+	std::vector<AnalyzedFrameInfo>& frameInfo)
+{
+	u32* cpMem = file->GetCPMem();
+	CPMemory startState = CPMemory();
+	FifoAnalyzer::LoadCPReg(0x50, cpMem[0x50], startState);
+	FifoAnalyzer::LoadCPReg(0x60, cpMem[0x60], startState);
+
+	for (int i = 0; i < 8; ++i)
+	{
+		FifoAnalyzer::LoadCPReg(0x70 + i, cpMem[0x70 + i], startState);
+		FifoAnalyzer::LoadCPReg(0x80 + i, cpMem[0x80 + i], startState);
+		FifoAnalyzer::LoadCPReg(0x90 + i, cpMem[0x90 + i], startState);
+	}
+
+	const u32 frameCount = file->GetFrameCount();
+	frameInfo.clear();
+	frameInfo.resize(frameCount);
+	if (frameCount == 0)
+		return;
+
+	// Each frame depends on the vertex formats the frames before it left set, but games usually
+	// end every frame with the same ones. The first frame is analyzed on its own and the others
+	// in parallel, assuming they start where it ended. Frames that turn out to start from another
+	// state are redone in order afterwards.
+	s_CpMem = startState;
+	if (!AnalyzeFrame(file->GetFrame(0), frameInfo[0]))
+		return;
+	const CPMemory guess = s_CpMem;
+
+	std::vector<CPMemory> endStates(frameCount, guess);
+	std::vector<u8> succeeded(frameCount, 1);
+	Common::AsyncWorker::ExecuteParallel(
+		[&](int lower, int upper) {
+			for (int i = lower; i < upper; ++i)
 			{
-				if (s_DrawingObject)
-					analyzed.objectStarts.push_back(cmdStart);
-				else
-					analyzed.objectEnds.push_back(cmdStart);
+				s_CpMem = guess;
+				succeeded[i] = AnalyzeFrame(file->GetFrame(i), frameInfo[i]);
+				endStates[i] = s_CpMem;
 			}
+		},
+		1, frameCount, 16);
 
-			cmdStart += cmdSize;
+	for (u32 i = 1; i < frameCount; ++i)
+	{
+		if (!SameVertexState(endStates[i - 1], guess))
+		{
+			s_CpMem = endStates[i - 1];
+			succeeded[i] = AnalyzeFrame(file->GetFrame(i), frameInfo[i]);
+			endStates[i] = s_CpMem;
 		}
 
-		if (analyzed.objectEnds.size() < analyzed.objectStarts.size())
-			analyzed.objectEnds.push_back(cmdStart);
+		// Analysis stops at the first frame that fails, the ones after it stay empty
+		if (!succeeded[i])
+		{
+			std::fill(frameInfo.begin() + i + 1, frameInfo.end(), AnalyzedFrameInfo());
+			return;
+		}
 	}
 }
+
+bool FifoPlaybackAnalyzer::LoadAnalysis(const std::string& filename, FifoDataFile* file,
+	std::vector<AnalyzedFrameInfo>& frameInfo)
+{
+	AnalysisCache cache;
+	if (!CChunkFileReader::Load<AnalysisCache>(GetCachePath(filename), ANALYSIS_CACHE_REVISION,
+		cache))
+		return false;
+
+	const u32 frameCount = file->GetFrameCount();
+	if (cache.object_starts.size() != frameCount || cache.object_ends.size() != frameCount ||
+		cache.memory_update_counts.size() != frameCount || cache.file_hash != HashFrames(file))
+		return false;
+
+	frameInfo.clear();
+	frameInfo.resize(frameCount);
+	for (u32 i = 0; i < frameCount; ++i)
+	{
+		const FifoFrameInfo& frame = file->GetFrame(i);
+		AnalyzedFrameInfo& analyzed = frameInfo[i];
+		if (cache.memory_update_counts[i] > frame.memoryUpdates.size() ||
+			cache.object_starts[i].size() != cache.object_ends[i].size())
+		{
+			frameInfo.clear();
+			return false;
+		}
+
+		analyzed.objectStarts = std::move(cache.object_starts[i]);
+		analyzed.objectEnds = std::move(cache.object_ends[i]);
+		analyzed.memoryUpdates.assign(frame.memoryUpdates.begin(),
+			frame.memoryUpdates.begin() + cache.memory_update_counts[i]);
+	}
+
+	return true;
+}
+
+void FifoPlaybackAnalyzer::SaveAnalysis(const std::string& filename, const FifoDataFile* file,
+	const std::vector<AnalyzedFrameInfo>& frameInfo)
+{
+	AnalysisCache cache;
+	cache.file_hash = HashFrames(file);
+	for (const AnalyzedFrameInfo& analyzed : frameInfo)
+	{
+		cache.object_starts.push_back(analyzed.objectStarts);
+		cache.object_ends.push_back(analyzed.objectEnds);
+		cache.memory_update_counts.push_back(static_cast<u32>(analyzed.memoryUpdates.size()));
+	}
+
+	// The log may be somewhere read-only, the analysis is simply redone next time then
+	CChunkFileReader::Save<AnalysisCache>(GetCachePath(filename), ANALYSIS_CACHE_REVISION, cache);
+}
@@ -19,4 +19,11 @@ struct AnalyzedFrameInfo
 namespace FifoPlaybackAnalyzer
 {
 void AnalyzeFrames(FifoDataFile* file, std::vector<AnalyzedFrameInfo>& frameInfo);
+
+// Results of an earlier analysis of the log at filename, kept in a file next to it. Loading
+// fails if the log has changed since.
+bool LoadAnalysis(const std::string& filename, FifoDataFile* file,
+	std::vector<AnalyzedFrameInfo>& frameInfo);
+void SaveAnalysis(const std::string& filename, const FifoDataFile* file,
+	const std::vector<AnalyzedFrameInfo>& frameInfo);
 }  // namespace FifoPlaybackAnalyzer
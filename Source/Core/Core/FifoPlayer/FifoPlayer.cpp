@@ -43,8 +43,12 @@ bool FifoPlayer::Open(const std::string& filename)
 
 	if (m_File)
 	{
-		FifoAnalyzer::Init();
-		FifoPlaybackAnalyzer::AnalyzeFrames(m_File.get(), m_FrameInfo);
+		if (!FifoPlaybackAnalyzer::LoadAnalysis(filename, m_File.get(), m_FrameInfo))
+		{
+			FifoAnalyzer::Init();
+			FifoPlaybackAnalyzer::AnalyzeFrames(m_File.get(), m_FrameInfo);
+			FifoPlaybackAnalyzer::SaveAnalysis(filename, m_File.get(), m_FrameInfo);
+		}
 
 		m_FrameRangeEnd = m_File->GetFrameCount();
 	}
@@ -76,6 +80,7 @@ public:
 		IsPlayingBackFifologWithBrokenEFBCopies = m_parent->m_File->HasBrokenEFBCopies();
 
 		m_parent->m_CurrentFrame = m_parent->m_FrameRangeStart;
+		m_parent->m_LoopsPlayed = 0;
 		m_parent->LoadMemory();
 	}
 
@@ -120,7 +125,8 @@ int FifoPlayer::AdvanceFrame()
 {
 	if (m_CurrentFrame >= m_FrameRangeEnd)
 	{
-		if (!m_Loop)
+		m_LoopsPlayed++;
+		if (m_LoopCount ? m_LoopsPlayed >= m_LoopCount : !m_Loop)
 			return CPU::CPU_POWERDOWN;
 		// If there are zero frames in the range then sleep instead of busy spinning
 		if (m_FrameRangeStart >= m_FrameRangeEnd)
@@ -206,7 +212,7 @@ FifoPlayer& FifoPlayer::GetInstance()
 }
 
 FifoPlayer::FifoPlayer()
-	: m_CurrentFrame(0), m_FrameRangeStart(0), m_FrameRangeEnd(0), m_ObjectRangeStart(0),
+	: m_LoopCount(0), m_LoopsPlayed(0), m_CurrentFrame(0), m_FrameRangeStart(0), m_FrameRangeEnd(0), m_ObjectRangeStart(0),
 	m_ObjectRangeEnd(10000), m_EarlyMemoryUpdates(false), m_FileLoadedCb(nullptr),
 	m_FrameWrittenCb(nullptr), m_File(nullptr)
 {
@@ -334,7 +340,7 @@ void FifoPlayer::WriteMemory(const MemoryUpdate& memUpdate)
 	else
 		mem = &Memory::m_pRAM[memUpdate.address & Memory::RAM_MASK];
 
-	std::copy(memUpdate.data.begin(), memUpdate.data.end(), mem);
+	std::copy(memUpdate.data->begin(), memUpdate.data->end(), mem);
 }
 
 void FifoPlayer::WriteFifo(const u8* data, u32 start, u32 end)
@@ -84,6 +84,9 @@ public:
 	// If enabled then all memory updates happen at once before the first frame
 	// Default is disabled
 	void SetEarlyMemoryUpdates(bool enabled) { m_EarlyMemoryUpdates = enabled; }
+	// Stops playback after the frame range was played this many times, 0 follows the loop setting
+	void SetLoopCount(u32 loops) { m_LoopCount = loops; }
+	u32 GetLoopsPlayed() const { return m_LoopsPlayed; }
 	// Callbacks
 	void SetFileLoadedCallback(CallbackFunc callback) { m_FileLoadedCb = callback; }
 	void SetFrameWrittenCallback(CallbackFunc callback) { m_FrameWrittenCb = callback; }
@@ -129,6 +132,8 @@ private:
 	static bool IsHighWatermarkSet();
 
 	bool m_Loop;
+	u32 m_LoopCount;
+	u32 m_LoopsPlayed;
 
 	u32 m_CurrentFrame;
 	u32 m_FrameRangeStart;
@@ -7,6 +7,7 @@
 
 #include "Core/FifoPlayer/FifoRecorder.h"
 
+#include "Common/Hash.h"
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 #include "Core/ConfigManager.h"
@@ -39,6 +40,7 @@ void FifoRecorder::StartRecording(s32 numFrames, CallbackFunc finishedCb)
 	FifoAnalyzer::Init();
 
 	m_File = new FifoDataFile;
+	m_UpdateData.clear();
 	std::fill(m_Ram.begin(), m_Ram.end(), 0);
 	std::fill(m_ExRam.begin(), m_ExRam.end(), 0);
 
@@ -88,7 +90,7 @@ void FifoRecorder::WriteGPCommand(const u8* data, u32 size)
 
 			// Copy frame to file
 			// The file will be responsible for freeing the memory allocated for each frame's fifoData
-			m_File->AddFrame(m_CurrentFrame);
+			m_File->AddFrame(std::move(m_CurrentFrame));
 
 			if (m_FinishedCb && m_RequestedRecordingEnd)
 				m_FinishedCb();
@@ -127,8 +129,7 @@ void FifoRecorder::UseMemory(u32 address, u32 size, MemoryUpdate::Type type, boo
 		memUpdate.address = address;
 		memUpdate.fifoPosition = (u32)(m_FifoData.size());
 		memUpdate.type = type;
-		memUpdate.data.resize(size);
-		std::copy(newData, newData + size, memUpdate.data.begin());
+		memUpdate.data = GetUpdateData(newData, size);
 
 		m_CurrentFrame.memoryUpdates.push_back(std::move(memUpdate));
 	}
@@ -139,6 +140,24 @@ void FifoRecorder::UseMemory(u32 address, u32 size, MemoryUpdate::Type type, boo
 	}
 }
 
+// An update with the same contents as an earlier one shares its data, so each distinct upload
+// is kept once no matter how often the game switches back to it.
+std::shared_ptr<const std::vector<u8>> FifoRecorder::GetUpdateData(const u8* data, u32 size)
+{
+	const u64 hash = GetHash64(data, size, 0);
+	auto range = m_UpdateData.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		const std::vector<u8>& existing = *it->second;
+		if (existing.size() == size && std::equal(existing.begin(), existing.end(), data))
+			return it->second;
+	}
+
+	auto newData = std::make_shared<const std::vector<u8>>(data, data + size);
+	m_UpdateData.emplace(hash, newData);
+	return newData;
+}
+
 void FifoRecorder::EndFrame(u32 fifoStart, u32 fifoEnd)
 {
 	// m_IsRecording is assumed to be true at this point, otherwise this function would not be called
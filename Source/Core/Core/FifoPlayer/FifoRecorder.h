@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "Core/FifoPlayer/FifoDataFile.h"
@@ -44,6 +46,8 @@ public:
 	static FifoRecorder& GetInstance();
 
 private:
+	std::shared_ptr<const std::vector<u8>> GetUpdateData(const u8* data, u32 size);
+
 	// Accessed from both GUI and video threads
 
 	// True if video thread should send data
@@ -65,4 +69,6 @@ private:
 	std::vector<u8> m_FifoData;
 	std::vector<u8> m_Ram;
 	std::vector<u8> m_ExRam;
+	// Data of every memory update recorded so far, keyed by hash
+	std::unordered_multimap<u64, std::shared_ptr<const std::vector<u8>>> m_UpdateData;
 };
@@ -154,14 +154,8 @@ static bool InstallCodeHandler()
 	PowerPC::HostWrite_U8(1, INSTALLER_BASE_ADDRESS + 7);
 
 	// Invalidate the icache and any asm codes
-	for (unsigned int j = 0; j < (INSTALLER_END_ADDRESS - INSTALLER_BASE_ADDRESS); j += 32)
-	{
-		PowerPC::ppcState.iCache.Invalidate(INSTALLER_BASE_ADDRESS + j);
-	}
-	for (unsigned int k = codelist_base_address; k < codelist_end_address; k += 32)
-	{
-		PowerPC::ppcState.iCache.Invalidate(k);
-	}
+	PowerPC::ppcState.iCache.InvalidateRange(INSTALLER_BASE_ADDRESS, INSTALLER_END_ADDRESS - INSTALLER_BASE_ADDRESS);
+	PowerPC::ppcState.iCache.InvalidateRange(codelist_base_address, codelist_end_address - codelist_base_address);
 	return true;
 }
 
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "Common/CommonTypes.h"
 
 #include "Core/ConfigManager.h"
@@ -10,6 +12,7 @@
 #include "Core/HLE/HLE.h"
 #include "Core/HLE/HLE_Misc.h"
 #include "Core/HLE/HLE_OS.h"
+#include "Core/HLE/HLE_SDK.h"
 #include "Core/HW/Memmap.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device_es.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -61,6 +64,15 @@ static const SPatch OSPatches[] =
 	{ "___blank",             HLE_OS::HLE_GeneralDebugPrint,   HLE_HOOK_REPLACE, HLE_TYPE_DEBUG },
 	{ "__write_console",      HLE_OS::HLE_write_console,       HLE_HOOK_REPLACE, HLE_TYPE_DEBUG }, // used by sysmenu (+more?)
 	{ "GeckoCodehandler",     HLE_Misc::HLEGeckoCodehandler,   HLE_HOOK_START,   HLE_TYPE_GENERIC },
+
+	// SDK routines
+	{ "memcpy",               HLE_SDK::HLE_memcpy,             HLE_HOOK_REPLACE, HLE_TYPE_SDK },
+	{ "memset",               HLE_SDK::HLE_memset,             HLE_HOOK_REPLACE, HLE_TYPE_SDK },
+	{ "PSMTXIdentity",        HLE_SDK::HLE_PSMTXIdentity,      HLE_HOOK_REPLACE, HLE_TYPE_SDK },
+	{ "PSMTXCopy",            HLE_SDK::HLE_PSMTXCopy,          HLE_HOOK_REPLACE, HLE_TYPE_SDK },
+	{ "DCFlushRange",         HLE_SDK::HLE_DCFlushRange,       HLE_HOOK_REPLACE, HLE_TYPE_SDK },
+	{ "DCStoreRange",         HLE_SDK::HLE_DCFlushRange,       HLE_HOOK_REPLACE, HLE_TYPE_SDK },
+	{ "DCInvalidateRange",    HLE_SDK::HLE_DCFlushRange,       HLE_HOOK_REPLACE, HLE_TYPE_SDK },
 };
 
 static const SPatch OSBreakPoints[] =
@@ -68,12 +80,22 @@ static const SPatch OSBreakPoints[] =
 	{ "FAKE_TO_SKIP_0", HLE_Misc::UnimplementedFunction },
 };
 
+// SDK routines can be turned off one by one with HLESDKDisabled
+static bool IsPatchDisabled(const SPatch& patch)
+{
+	const std::vector<std::string>& disabled = SConfig::GetInstance().m_hle_sdk_disabled;
+	return patch.flags == HLE_TYPE_SDK &&
+		std::find(disabled.begin(), disabled.end(), patch.m_szPatchName) != disabled.end();
+}
+
 void Patch(u32 addr, const char *hle_func_name)
 {
 	for (u32 i = 0; i < sizeof(OSPatches) / sizeof(SPatch); i++)
 	{
 		if (!strcmp(OSPatches[i].m_szPatchName, hle_func_name))
 		{
+			if (IsPatchDisabled(OSPatches[i]))
+				return;
 			s_original_instructions[addr] = i;
 			return;
 		}
@@ -85,6 +107,9 @@ void PatchFunctions()
 	s_original_instructions.clear();
 	for (u32 i = 0; i < sizeof(OSPatches) / sizeof(SPatch); i++)
 	{
+		if (IsPatchDisabled(OSPatches[i]))
+			continue;
+
 		Symbol *symbol = g_symbolDB.GetSymbolFromName(OSPatches[i].m_szPatchName);
 		if (symbol)
 		{
@@ -117,6 +142,8 @@ void Execute(u32 _CurrentPC, u32 _Instruction)
 	unsigned int FunctionIndex = _Instruction & 0xFFFFF;
 	if ((FunctionIndex > 0) && (FunctionIndex < (sizeof(OSPatches) / sizeof(SPatch))))
 	{
+		// The JITs don't store PC before the call, the SDK routines may run the guest code from there
+		PC = _CurrentPC;
 		OSPatches[FunctionIndex].PatchFunction();
 	}
 	else
@@ -147,6 +174,8 @@ bool IsEnabled(int flags)
 {
 	if (flags == HLE::HLE_TYPE_DEBUG && !SConfig::GetInstance().bEnableDebugging && PowerPC::GetMode() != MODE_INTERPRETER)
 		return false;
+	if (flags == HLE::HLE_TYPE_SDK && (!SConfig::GetInstance().bHLESDKFunctions || HLE_SDK::IsRunningGuestCode()))
+		return false;
 
 	return true;
 }
@@ -158,10 +187,8 @@ u32 UnPatch(const std::string& patchName)
 	if (symbol)
 	{
 		for (u32 addr = symbol->address; addr < symbol->address + symbol->size; addr += 4)
-		{
 			s_original_instructions[addr] = 0;
-			PowerPC::ppcState.iCache.Invalidate(addr);
-		}
+		PowerPC::ppcState.iCache.InvalidateRange(symbol->address, symbol->size);
 		return symbol->address;
 	}
 
@@ -21,6 +21,7 @@ enum
 {
 	HLE_TYPE_GENERIC = 0,    // Miscellaneous function
 	HLE_TYPE_DEBUG = 1,    // Debug output function
+	HLE_TYPE_SDK = 2,    // Replacement for an SDK routine, enabled by HLESDKFunctions unless listed in HLESDKDisabled
 };
 
 void PatchFunctions();
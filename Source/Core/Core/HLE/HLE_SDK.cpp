@@ -0,0 +1,216 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "Common/CommonFuncs.h"
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "Core/ConfigManager.h"
+#include "Core/HLE/HLE_SDK.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace HLE_SDK
+{
+
+// Set while the guest's own code runs instead of a replacement
+static bool s_running_guest_code = false;
+
+bool IsRunningGuestCode()
+{
+	return s_running_guest_code;
+}
+
+// Returns the host pointer for a range of guest RAM if every byte of it goes to RAM the same way
+// WriteToHardware would send it there, nullptr if the range has to go through the MMU.
+static u8* GetRAMPointer(u32 address, u32 size)
+{
+	if (!UReg_MSR(MSR).DR)
+		return nullptr;
+
+	const u32 segment = address >> 28;
+	if (segment == 0x8 || segment == 0xC)
+	{
+		const u32 offset = address & Memory::RAM_MASK;
+		if (offset + u64(size) <= Memory::RAM_SIZE)
+			return Memory::m_pRAM + offset;
+	}
+	else if (Memory::m_pEXRAM && (segment == 0x9 || segment == 0xD))
+	{
+		const u32 offset = address & 0x0FFFFFFF;
+		if (offset + u64(size) <= Memory::EXRAM_SIZE)
+			return Memory::m_pEXRAM + offset;
+	}
+	return nullptr;
+}
+
+static bool Overlaps(u32 a, u32 b, u32 size)
+{
+	return a != b && (a < b ? b - a : a - b) < size;
+}
+
+// Runs the routine at PC as guest code in the interpreter until it returns to LR. It is used for
+// the cases a replacement can't do the same as the original. The SDK patches are off meanwhile,
+// so the original instructions run, and the cycles are taken from the downcount afterwards.
+static void RunGuestCode()
+{
+	constexpr u32 MAX_GUEST_STEPS = 0x4000000;
+
+	const u32 start = PC;
+	const u32 return_address = LR;
+	Interpreter* const interpreter = Interpreter::getInstance();
+	int cycles = 0;
+	u32 steps = 0;
+
+	s_running_guest_code = true;
+	while (PC != return_address && steps++ < MAX_GUEST_STEPS)
+		cycles += interpreter->SingleStepInner();
+	s_running_guest_code = false;
+
+	if (PC != return_address)
+		ERROR_LOG(OSHLE, "Guest code at %08x didn't return to %08x", start, return_address);
+
+	PowerPC::ppcState.downcount -= cycles;
+	NPC = PC;
+}
+
+// Runs a replacement that writes [dst, dst + size). With HLESDKValidate the guest code then runs
+// again on the same memory and keeps its result, and any difference is logged.
+template <typename Replacement>
+static void RunReplacement(const char* name, u32 dst, u8* dst_ptr, u32 size, bool returns_dst,
+	Replacement replacement)
+{
+	if (!SConfig::GetInstance().bHLESDKValidate)
+	{
+		replacement();
+		// r3 already holds dst, the return value
+		NPC = LR;
+		return;
+	}
+
+	const std::vector<u8> original(dst_ptr, dst_ptr + size);
+	replacement();
+	const std::vector<u8> expected(dst_ptr, dst_ptr + size);
+	std::copy(original.begin(), original.end(), dst_ptr);
+
+	RunGuestCode();
+
+	const auto mismatch = std::mismatch(expected.begin(), expected.end(), dst_ptr);
+	if (mismatch.first != expected.end())
+	{
+		const u32 offset = static_cast<u32>(mismatch.first - expected.begin());
+		ERROR_LOG(OSHLE, "HLE %s differs from the guest code at %08x: %02x instead of %02x", name,
+			dst + offset, *mismatch.first, *mismatch.second);
+	}
+	if (returns_dst && GPR(3) != dst)
+		ERROR_LOG(OSHLE, "HLE %s returns %08x, the guest code %08x", name, dst, GPR(3));
+}
+
+// void* memcpy(void* dst, const void* src, size_t n)
+void HLE_memcpy()
+{
+	const u32 dst = GPR(3);
+	const u32 src = GPR(4);
+	const u32 size = GPR(5);
+
+	// How overlapping ranges are copied depends on the SDK's implementation
+	u8* dst_ptr = GetRAMPointer(dst, size);
+	const u8* src_ptr = GetRAMPointer(src, size);
+	if (!dst_ptr || !src_ptr || Overlaps(dst, src, size))
+	{
+		RunGuestCode();
+		return;
+	}
+
+	RunReplacement("memcpy", dst, dst_ptr, size, true,
+		[&] { std::memmove(dst_ptr, src_ptr, size); });
+}
+
+// void* memset(void* dst, int c, size_t n)
+void HLE_memset()
+{
+	const u32 dst = GPR(3);
+	const u8 value = static_cast<u8>(GPR(4));
+	const u32 size = GPR(5);
+
+	u8* dst_ptr = GetRAMPointer(dst, size);
+	if (!dst_ptr)
+	{
+		RunGuestCode();
+		return;
+	}
+
+	RunReplacement("memset", dst, dst_ptr, size, true,
+		[&] { std::memset(dst_ptr, value, size); });
+}
+
+// Both matrix routines use psq_l/psq_st with GQR0, which the SDK sets up for plain floats
+static constexpr u32 MTX_SIZE = 3 * 4 * sizeof(u32);
+
+// void PSMTXIdentity(Mtx m)
+void HLE_PSMTXIdentity()
+{
+	const u32 dst = GPR(3);
+
+	u8* dst_ptr = GetRAMPointer(dst, MTX_SIZE);
+	if (!dst_ptr || GQR(0) != 0)
+	{
+		RunGuestCode();
+		return;
+	}
+
+	RunReplacement("PSMTXIdentity", dst, dst_ptr, MTX_SIZE, false, [&] {
+		for (u32 row = 0; row < 3; ++row)
+		{
+			for (u32 column = 0; column < 4; ++column)
+			{
+				const u32 value = Common::swap32(row == column ? 0x3F800000 : 0);
+				std::memcpy(dst_ptr + (row * 4 + column) * 4, &value, sizeof(value));
+			}
+		}
+	});
+}
+
+// void PSMTXCopy(const Mtx src, Mtx dst)
+void HLE_PSMTXCopy()
+{
+	const u32 src = GPR(3);
+	const u32 dst = GPR(4);
+
+	u8* dst_ptr = GetRAMPointer(dst, MTX_SIZE);
+	const u8* src_ptr = GetRAMPointer(src, MTX_SIZE);
+	if (!dst_ptr || !src_ptr || Overlaps(dst, src, MTX_SIZE) || GQR(0) != 0)
+	{
+		RunGuestCode();
+		return;
+	}
+
+	RunReplacement("PSMTXCopy", dst, dst_ptr, MTX_SIZE, false,
+		[&] { std::memmove(dst_ptr, src_ptr, MTX_SIZE); });
+}
+
+// void DCFlushRange(void* start, u32 nBytes), also DCStoreRange and DCInvalidateRange.
+// The guest loops dcbf/dcbst/dcbi over the cache lines, and all Dolphin does for those is drop
+// the JIT blocks there. Doing that once for the range is the same. There is nothing in memory to
+// compare, so HLESDKValidate doesn't check these.
+void HLE_DCFlushRange()
+{
+	const u32 start = GPR(3);
+	const u32 size = GPR(4);
+	if (size != 0)
+	{
+		const u32 first_line = start & ~31;
+		const u32 end = (start + size + 31) & ~31;
+		JitInterface::InvalidateICache(first_line, end - first_line, false);
+	}
+
+	NPC = LR;
+}
+
+}
@@ -0,0 +1,20 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// Replacements for hot SDK routines. They only do what the guest code does to memory and the
+// JIT cache. Whenever that depends on the SDK's implementation, e.g. for overlapping copies, or
+// the memory isn't plain RAM, they run the original code in the interpreter instead.
+namespace HLE_SDK
+{
+// True while a replacement runs the original code, which has to skip the SDK patches
+bool IsRunningGuestCode();
+
+void HLE_memcpy();
+void HLE_memset();
+void HLE_PSMTXIdentity();
+void HLE_PSMTXCopy();
+void HLE_DCFlushRange();
+}
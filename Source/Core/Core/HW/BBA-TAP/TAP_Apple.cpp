@@ -46,7 +46,7 @@ bool CEXIETHERNET::IsActivated()
 
 bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
 {
-  INFO_LOG(SP1, "SendFrame %x\n%s", size, ArrayToString(frame, size, 0x10).c_str());
+  DEBUG_LOG(SP1, "SendFrame %x\n%s", size, ArrayToString(frame, size, 0x10).c_str());
 
   int writtenBytes = write(fd, frame, size);
   if ((u32)writtenBytes != size)
@@ -82,8 +82,8 @@ static void ReadThreadHandler(CEXIETHERNET* self)
     }
     else if (self->readEnabled.IsSet())
     {
-      INFO_LOG(SP1, "Read data: %s",
-               ArrayToString(self->mRecvBuffer.get(), readBytes, 0x10).c_str());
+      DEBUG_LOG(SP1, "Read data: %s",
+                ArrayToString(self->mRecvBuffer.get(), readBytes, 0x10).c_str());
       self->mRecvBufferLength = readBytes;
       self->RecvHandlePacket();
     }
@@ -223,11 +223,18 @@ bool CEXIETHERNET::Activate()
 
 	/* initialize read/write events */
 	mReadOverlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
-	mWriteOverlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
-	if (mReadOverlapped.hEvent == nullptr || mWriteOverlapped.hEvent == nullptr)
+	if (mReadOverlapped.hEvent == nullptr)
 		return false;
+	for (WriteSlot& slot : mWriteSlots)
+	{
+		slot.overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+		if (slot.overlapped.hEvent == nullptr)
+			return false;
+		slot.buffer.reserve(1518);
+		slot.pending = false;
+	}
+	mNextWriteSlot = 0;
 
-	mWriteBuffer.reserve(1518);
 	return RecvInit();
 }
 
@@ -249,11 +256,16 @@ void CEXIETHERNET::Deactivate()
 
 	// Clean-up handles
 	CloseHandle(mReadOverlapped.hEvent);
-	CloseHandle(mWriteOverlapped.hEvent);
+	for (WriteSlot& slot : mWriteSlots)
+	{
+		if (slot.overlapped.hEvent != nullptr)
+			CloseHandle(slot.overlapped.hEvent);
+		memset(&slot.overlapped, 0, sizeof(slot.overlapped));
+		slot.pending = false;
+	}
 	CloseHandle(mHAdapter);
 	mHAdapter = INVALID_HANDLE_VALUE;
 	memset(&mReadOverlapped, 0, sizeof(mReadOverlapped));
-	memset(&mWriteOverlapped, 0, sizeof(mWriteOverlapped));
 }
 
 bool CEXIETHERNET::IsActivated()
@@ -311,24 +323,28 @@ bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
 {
 	DEBUG_LOG(SP1, "SendFrame %u bytes:\n%s", size, ArrayToString(frame, size, 0x10).c_str());
 
-	// Check for a background write. We can't issue another one until this one has completed.
+	// Slots are reused in order, so the next one holds the oldest write that may still be in flight.
+	// Only block when the whole ring is busy.
+	WriteSlot& slot = mWriteSlots[mNextWriteSlot];
+	mNextWriteSlot = (mNextWriteSlot + 1) % WRITE_SLOT_COUNT;
+
 	DWORD transferred;
-	if (mWritePending)
+	if (slot.pending)
 	{
-		// Wait for previous write to complete.
-		if (!GetOverlappedResult(mHAdapter, &mWriteOverlapped, &transferred, TRUE))
+		if (!GetOverlappedResult(mHAdapter, &slot.overlapped, &transferred, TRUE))
 			ERROR_LOG(SP1, "GetOverlappedResult failed (err=0x%X)", GetLastError());
 	}
 
 	// Copy to write buffer.
-	mWriteBuffer.assign(frame, frame + size);
-	mWritePending = true;
+	slot.buffer.assign(frame, frame + size);
+	slot.pending = true;
 
 	// Queue async write.
-	if (WriteFile(mHAdapter, mWriteBuffer.data(), size, &transferred, &mWriteOverlapped))
+	if (WriteFile(mHAdapter, slot.buffer.data(), size, &transferred, &slot.overlapped))
 	{
 		// Returning immediately is not likely to happen, but if so, reset the event state manually.
-		ResetEvent(mWriteOverlapped.hEvent);
+		ResetEvent(slot.overlapped.hEvent);
+		slot.pending = false;
 	}
 	else
 	{
@@ -336,8 +352,8 @@ bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
 		if (GetLastError() != ERROR_IO_PENDING)
 		{
 			ERROR_LOG(SP1, "WriteFile failed (err=0x%X)", GetLastError());
-			ResetEvent(mWriteOverlapped.hEvent);
-			mWritePending = false;
+			ResetEvent(slot.overlapped.hEvent);
+			slot.pending = false;
 			return false;
 		}
 	}
@@ -409,18 +409,32 @@ void AXUCode::ProcessPBList(u32 pb_addr)
 	// 32KHz to 48KHz, but AX always process at 32KHz.
 	const u32 spms = 32;
 
-	AXPB pb;
-
+	// Walk the list first. Updates can change next_pb, so they are applied to
+	// a copy of each PB to find the next one.
+	std::vector<u32> pb_addrs;
+	std::vector<AXPB> pbs;
 	while (pb_addr)
 	{
-		AXBuffers buffers = { { m_samples_left, m_samples_right, m_samples_surround, m_samples_auxA_left,
-			m_samples_auxA_right, m_samples_auxA_surround, m_samples_auxB_left,
-			m_samples_auxB_right, m_samples_auxB_surround } };
-
+		AXPB pb;
 		ReadPB(pb_addr, pb);
+		pb_addrs.push_back(pb_addr);
+		pbs.push_back(pb);
+
+		u16* updates = (u16*)HLEMemory_Get_Pointer(HILO_TO_32(pb.updates.data));
+		for (int curr_ms = 0; curr_ms < 5; ++curr_ms)
+			ApplyUpdatesForMs(curr_ms, (u16*)&pb, pb.updates.num_updates, updates);
+		pb_addr = HILO_TO_32(pb.next_pb);
+	}
+
+	AXBuffers output = { { m_samples_left, m_samples_right, m_samples_surround, m_samples_auxA_left,
+		m_samples_auxA_right, m_samples_auxA_surround, m_samples_auxB_left,
+		m_samples_auxB_right, m_samples_auxB_surround } };
+	u32 buffer_sizes[ArraySize(output.ptrs)];
+	std::fill(std::begin(buffer_sizes), std::end(buffer_sizes), 5 * spms);
 
-		u32 updates_addr = HILO_TO_32(pb.updates.data);
-		u16* updates = (u16*)HLEMemory_Get_Pointer(updates_addr);
+	ProcessVoices(static_cast<u32>(pbs.size()), output, buffer_sizes, [&](u32 voice, AXBuffers buffers) {
+		AXPB& pb = pbs[voice];
+		u16* updates = (u16*)HLEMemory_Get_Pointer(HILO_TO_32(pb.updates.data));
 
 		for (int curr_ms = 0; curr_ms < 5; ++curr_ms)
 		{
@@ -433,10 +447,10 @@ void AXUCode::ProcessPBList(u32 pb_addr)
 			for (size_t i = 0; i < ArraySize(buffers.ptrs); ++i)
 				buffers.ptrs[i] += spms;
 		}
+	});
 
-		WritePB(pb_addr, pb);
-		pb_addr = HILO_TO_32(pb.next_pb);
-	}
+	for (size_t i = 0; i < pbs.size(); ++i)
+		WritePB(pb_addrs[i], pbs[i]);
 }
 
 void AXUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
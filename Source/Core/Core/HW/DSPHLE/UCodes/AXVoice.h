@@ -12,10 +12,18 @@
 #error AXVoice.h included without specifying version
 #endif
 
-#include <functional>
+#if defined(_M_X86)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
+#include "Common/ThreadPool.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/UCodes/AX.h"
@@ -112,11 +120,15 @@ void DumpPB(const PB_TYPE& pb)
 }
 #endif
 
-// Simulated accelerator state.
-static u32 acc_loop_addr, acc_end_addr;
-static u32* acc_cur_addr;
-static PB_TYPE* acc_pb;
-static bool acc_end_reached;
+// Simulated accelerator state, per thread as voices are processed in parallel.
+static thread_local u32 acc_loop_addr, acc_end_addr;
+static thread_local u32* acc_cur_addr;
+static thread_local PB_TYPE* acc_pb;
+static thread_local bool acc_end_reached;
+
+// Input samples decoded at once per voice and frame. Higher sample rate
+// ratios read from the accelerator one sample at a time.
+constexpr u32 MAX_INPUT_SAMPLES_PER_FRAME = 1024;
 
 // Sets up the simulated accelerator.
 void AcceleratorSetup(PB_TYPE* pb, u32* cur_addr)
@@ -128,6 +140,81 @@ void AcceleratorSetup(PB_TYPE* pb, u32* cur_addr)
 	acc_end_reached = false;
 }
 
+// Handles the accelerator reaching the end address: loops back to loop_addr
+// or stops the voice.
+//
+// On real hardware, this would raise an interrupt that is handled by the
+// UCode. We simulate what this interrupt does here.
+void AcceleratorHandleEnd()
+{
+	// loop back to loop_addr.
+	*acc_cur_addr = acc_loop_addr;
+
+	if (acc_pb->audio_addr.looping)
+	{
+		// Set the ADPCM infos to continue processing at loop_addr.
+		//
+		// For some reason, yn1 and yn2 aren't set if the voice is not of
+		// stream type. This is what the AX UCode does and I don't really
+		// know why.
+		acc_pb->adpcm.pred_scale = acc_pb->adpcm_loop_info.pred_scale;
+		if (SConfig::GetInstance().bRSHACK)
+		{
+			acc_pb->adpcm.yn1 = acc_pb->adpcm_loop_info.yn1;
+			acc_pb->adpcm.yn2 = acc_pb->adpcm_loop_info.yn2;
+			if (acc_pb->is_stream)
+			{
+				// HORRIBLE HACK: this behavior changed between versions at some point; needs some sort
+				// of branch. delroth says anyone who submits this code as a serious PR will be banned
+				// from Dolphin.
+				// needed for RS2
+				acc_pb->lpf.enabled += 1;
+				// needed for RS3
+				acc_pb->padding[0] += 1;
+			}
+		}
+		else
+		{
+			if (!acc_pb->is_stream)
+			{
+				acc_pb->adpcm.yn1 = acc_pb->adpcm_loop_info.yn1;
+				acc_pb->adpcm.yn2 = acc_pb->adpcm_loop_info.yn2;
+			}
+		}
+	}
+	else
+	{
+		// Non looping voice reached the end -> running = 0.
+		acc_pb->running = 0;
+
+#ifdef AX_WII
+		// One of the few meaningful differences between AXGC and AXWii:
+		// while AXGC handles non looping voices ending by having 0000
+		// samples at the loop address, AXWii has the 0000 samples
+		// internally in DRAM and use an internal pointer to it (loop addr
+		// does not contain 0000 samples on AXWii!).
+		acc_end_reached = true;
+#endif
+	}
+}
+
+// Returns the step size of the end address check for the current format.
+u8 AcceleratorGetStepSize()
+{
+	if (acc_pb->audio_addr.sample_format != 0x00)
+		return 2;
+
+	switch (acc_end_addr & 15)
+	{
+	case 0:  // Tom and Jerry
+		return 1;
+	case 1:  // Blazing Angels
+		return 0;
+	default:
+		return 2;
+	}
+}
+
 // Reads a sample from the simulated accelerator. Also handles looping and
 // disabling streams that reached the end (this is done by an exception raised
 // by the accelerator on real hardware).
@@ -151,18 +238,7 @@ u16 AcceleratorGetSample()
 			*acc_cur_addr += 2;
 		}
 
-		switch (acc_end_addr & 15)
-		{
-		case 0:  // Tom and Jerry
-			step_size_bytes = 1;
-			break;
-		case 1:  // Blazing Angels
-			step_size_bytes = 0;
-			break;
-		default:
-			step_size_bytes = 2;
-			break;
-		}
+		step_size_bytes = AcceleratorGetStepSize();
 
 		int scale = 1 << (acc_pb->adpcm.pred_scale & 0xF);
 		int coef_idx = (acc_pb->adpcm.pred_scale >> 4) & 0x7;
@@ -209,63 +285,107 @@ u16 AcceleratorGetSample()
 	}
 
 	// Have we reached the end address?
-	//
-	// On real hardware, this would raise an interrupt that is handled by the
-	// UCode. We simulate what this interrupt does here.
 	if (*acc_cur_addr == (acc_end_addr + step_size_bytes - 1))
+		AcceleratorHandleEnd();
+
+	return ret;
+}
+
+// Reads PCM samples up to <count>, or up to the end address. The end check is
+// done once for the whole segment instead of once per sample.
+template <bool PCM16>
+u32 AcceleratorGetPCMSegment(s16* output, u32 count)
+{
+	// Number of samples until the address hits the end check, wrapping like
+	// the per sample comparison does.
+	u32 addr = *acc_cur_addr;
+	const u32 end_addr = acc_end_addr + 2 - 1;
+	const u32 until_end = end_addr - addr;
+	const u32 segment = (until_end == 0 || until_end > count) ? count : until_end;
+
+	for (u32 i = 0; i < segment; ++i, ++addr)
 	{
-		// loop back to loop_addr.
-		*acc_cur_addr = acc_loop_addr;
+		if (PCM16)
+			output[i] = (DSP::ReadARAM(addr * 2) << 8) | DSP::ReadARAM(addr * 2 + 1);
+		else
+			output[i] = DSP::ReadARAM(addr) << 8;
+	}
 
-		if (acc_pb->audio_addr.looping)
+	acc_pb->adpcm.yn2 = segment > 1 ? output[segment - 2] : acc_pb->adpcm.yn1;
+	acc_pb->adpcm.yn1 = output[segment - 1];
+	*acc_cur_addr = addr;
+	if (addr == end_addr)
+		AcceleratorHandleEnd();
+	return segment;
+}
+
+// Reads <count> samples from the simulated accelerator. Same as calling
+// AcceleratorGetSample <count> times, but ADPCM is decoded one frame at a time
+// with the predictor state kept in locals, and PCM in segments up to the end
+// address.
+void AcceleratorGetSamples(s16* output, u32 count)
+{
+	u32 i = 0;
+	while (i < count && !acc_end_reached)
+	{
+		if (acc_pb->audio_addr.sample_format == 0x0A)
 		{
-			// Set the ADPCM infos to continue processing at loop_addr.
-			//
-			// For some reason, yn1 and yn2 aren't set if the voice is not of
-			// stream type. This is what the AX UCode does and I don't really
-			// know why.
-			acc_pb->adpcm.pred_scale = acc_pb->adpcm_loop_info.pred_scale;
-			if (SConfig::GetInstance().bRSHACK)
-			{
-				acc_pb->adpcm.yn1 = acc_pb->adpcm_loop_info.yn1;
-				acc_pb->adpcm.yn2 = acc_pb->adpcm_loop_info.yn2;
-				if (acc_pb->is_stream)
-				{
-					// HORRIBLE HACK: this behavior changed between versions at some point; needs some sort
-					// of branch. delroth says anyone who submits this code as a serious PR will be banned
-					// from Dolphin.
-					// needed for RS2
-					acc_pb->lpf.enabled += 1;
-					// needed for RS3
-					acc_pb->padding[0] += 1;
-				}
-			}
-			else
-			{
-				if (!acc_pb->is_stream)
-				{
-					acc_pb->adpcm.yn1 = acc_pb->adpcm_loop_info.yn1;
-					acc_pb->adpcm.yn2 = acc_pb->adpcm_loop_info.yn2;
-				}
-			}
+			i += AcceleratorGetPCMSegment<true>(output + i, count - i);
+			continue;
 		}
-		else
+		if (acc_pb->audio_addr.sample_format == 0x19)
 		{
-			// Non looping voice reached the end -> running = 0.
-			acc_pb->running = 0;
+			i += AcceleratorGetPCMSegment<false>(output + i, count - i);
+			continue;
+		}
+		if (acc_pb->audio_addr.sample_format != 0x00)
+		{
+			output[i++] = AcceleratorGetSample();
+			continue;
+		}
 
-#ifdef AX_WII
-			// One of the few meaningful differences between AXGC and AXWii:
-			// while AXGC handles non looping voices ending by having 0000
-			// samples at the loop address, AXWii has the 0000 samples
-			// internally in DRAM and use an internal pointer to it (loop addr
-			// does not contain 0000 samples on AXWii!).
-			acc_end_reached = true;
-#endif
+		if ((*acc_cur_addr & 15) == 0)
+		{
+			acc_pb->adpcm.pred_scale = DSP::ReadARAM((*acc_cur_addr & ~15) >> 1);
+			*acc_cur_addr += 2;
 		}
+
+		const u32 end_addr = acc_end_addr + AcceleratorGetStepSize() - 1;
+		const int scale = 1 << (acc_pb->adpcm.pred_scale & 0xF);
+		const int coef_idx = (acc_pb->adpcm.pred_scale >> 4) & 0x7;
+		const s32 coef1 = acc_pb->adpcm.coefs[coef_idx * 2 + 0];
+		const s32 coef2 = acc_pb->adpcm.coefs[coef_idx * 2 + 1];
+		s32 yn1 = (s16)acc_pb->adpcm.yn1;
+		s32 yn2 = (s16)acc_pb->adpcm.yn2;
+		u32 addr = *acc_cur_addr;
+		bool end = false;
+
+		// Decode up to the end of the frame, the end address or <count>.
+		do
+		{
+			int temp = (addr & 1) ? (DSP::ReadARAM(addr >> 1) & 0xF) : (DSP::ReadARAM(addr >> 1) >> 4);
+			if (temp >= 8)
+				temp -= 16;
+
+			int val = (scale * temp) + ((0x400 + coef1 * yn1 + coef2 * yn2) >> 11);
+			val = MathUtil::Clamp(val, -0x7FFF, 0x7FFF);
+
+			yn2 = yn1;
+			yn1 = val;
+			output[i++] = val;
+			addr++;
+			end = addr == end_addr;
+		} while (i < count && !end && (addr & 15) != 0);
+
+		acc_pb->adpcm.yn1 = yn1;
+		acc_pb->adpcm.yn2 = yn2;
+		*acc_cur_addr = addr;
+		if (end)
+			AcceleratorHandleEnd();
 	}
 
-	return ret;
+	for (; i < count; ++i)
+		output[i] = 0;
 }
 
 // Reads samples from the input callback, resamples them to <count> samples at
@@ -288,7 +408,8 @@ u16 AcceleratorGetSample()
 // We start getting samples not from sample 0, but 0.<curr_pos_frac>. This
 // avoids discontinuities in the audio stream, especially with very low ratios
 // which interpolate a lot of values between two "real" samples.
-u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count, s16* last_samples,
+template <typename InputCallback>
+u32 ResampleAudio(InputCallback input_callback, s16* output, u32 count, s16* last_samples,
 	u32 curr_pos, u32 ratio, int srctype, const s16* coeffs)
 {
 	int read_samples_count = 0;
@@ -412,9 +533,28 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
 
 	if (coeffs)
 		coeffs += pb.coef_select * 0x200;
-	u32 curr_pos =
-		ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count, pb.src.last_samples,
-			pb.src.cur_addr_frac, HILO_TO_32(pb.src.ratio), pb.src_type, coeffs);
+
+	// The resampler consumes one input sample each time the position crosses
+	// an integer, so the number of input samples is known beforehand. Decode
+	// them all at once unless the ratio is absurdly high.
+	const u32 ratio = HILO_TO_32(pb.src.ratio);
+	u64 input_count = count;
+	if (pb.src_type == SRCTYPE_LINEAR || pb.src_type == SRCTYPE_POLYPHASE)
+		input_count = (pb.src.cur_addr_frac + (u64)ratio * count) >> 16;
+
+	u32 curr_pos;
+	if (input_count <= MAX_INPUT_SAMPLES_PER_FRAME)
+	{
+		s16 input[MAX_INPUT_SAMPLES_PER_FRAME];
+		AcceleratorGetSamples(input, (u32)input_count);
+		curr_pos = ResampleAudio([&input](u32 i) { return input[i]; }, samples, count,
+			pb.src.last_samples, pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
+	}
+	else
+	{
+		curr_pos = ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count,
+			pb.src.last_samples, pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
+	}
 	pb.src.cur_addr_frac = (curr_pos & 0xFFFF);
 
 	// Update current position in the PB.
@@ -434,7 +574,69 @@ void MixAdd(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ra
 	if (!ramp)
 		volume_delta = 0;
 
-	for (u32 i = 0; i < count; ++i)
+	u32 i = 0;
+#if defined(_M_X86)
+	// 8 samples at a time. The volume is unsigned, so the high half of the
+	// signed * unsigned product is fixed up from the unsigned multiply.
+	if (count >= 8)
+	{
+		__m128i vol = _mm_setr_epi16(volume, volume + volume_delta, volume + 2 * volume_delta,
+			volume + 3 * volume_delta, volume + 4 * volume_delta, volume + 5 * volume_delta,
+			volume + 6 * volume_delta, volume + 7 * volume_delta);
+		const __m128i vol_step = _mm_set1_epi16((u16)(volume_delta * 8));
+		const __m128i min_sample = _mm_set1_epi16(-32767);
+		__m128i result = _mm_setzero_si128();
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+			const __m128i lo = _mm_mullo_epi16(in, vol);
+			const __m128i hi = _mm_sub_epi16(_mm_mulhi_epu16(in, vol),
+				_mm_and_si128(_mm_srai_epi16(in, 15), vol));
+			const __m128i prod_lo = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+			const __m128i prod_hi = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+			result = _mm_max_epi16(_mm_packs_epi32(prod_lo, prod_hi), min_sample);
+
+			__m128i* dst = reinterpret_cast<__m128i*>(out + i);
+			const __m128i sign = _mm_srai_epi16(result, 15);
+			_mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), _mm_unpacklo_epi16(result, sign)));
+			_mm_storeu_si128(dst + 1,
+				_mm_add_epi32(_mm_loadu_si128(dst + 1), _mm_unpackhi_epi16(result, sign)));
+			vol = _mm_add_epi16(vol, vol_step);
+		}
+		volume += (u16)(volume_delta * i);
+		*dpop = (s16)_mm_extract_epi16(result, 7);
+	}
+#elif defined(_M_ARM_64)
+	if (count >= 8)
+	{
+		const u16 ramp_init[8] = {
+			volume, (u16)(volume + volume_delta), (u16)(volume + 2 * volume_delta),
+			(u16)(volume + 3 * volume_delta), (u16)(volume + 4 * volume_delta),
+			(u16)(volume + 5 * volume_delta), (u16)(volume + 6 * volume_delta),
+			(u16)(volume + 7 * volume_delta)};
+		uint16x8_t vol = vld1q_u16(ramp_init);
+		const uint16x8_t vol_step = vdupq_n_u16((u16)(volume_delta * 8));
+		const int16x8_t min_sample = vdupq_n_s16(-32767);
+		int16x8_t result = vdupq_n_s16(0);
+		for (; i + 8 <= count; i += 8)
+		{
+			const int16x8_t in = vld1q_s16(input + i);
+			const int32x4_t prod_lo = vshrq_n_s32(vmulq_s32(vmovl_s16(vget_low_s16(in)),
+				vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vol)))), 15);
+			const int32x4_t prod_hi = vshrq_n_s32(vmulq_s32(vmovl_s16(vget_high_s16(in)),
+				vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(vol)))), 15);
+			result = vmaxq_s16(vcombine_s16(vqmovn_s32(prod_lo), vqmovn_s32(prod_hi)), min_sample);
+
+			vst1q_s32(out + i, vaddw_s16(vld1q_s32(out + i), vget_low_s16(result)));
+			vst1q_s32(out + i + 4, vaddw_s16(vld1q_s32(out + i + 4), vget_high_s16(result)));
+			vol = vaddq_u16(vol, vol_step);
+		}
+		volume += (u16)(volume_delta * i);
+		*dpop = vgetq_lane_s16(result, 7);
+	}
+#endif
+
+	for (; i < count; ++i)
 	{
 		s64 sample = input[i];
 		sample *= volume;
@@ -591,4 +793,61 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
 #endif
 }
 
+// Voices mixed by one thread pool task.
+constexpr u32 VOICES_PER_TASK = 8;
+
+// Calls process_voice(index, buffers) for <count> voices, in parallel when
+// there are enough of them. Each task mixes its voices in order to its own
+// buffers, which are then added to <output> in task order. Mixing is integer
+// only, so the result is the same for any number of threads.
+//
+// <buffer_sizes> gives the number of samples of each of the output buffers.
+template <typename ProcessFunc>
+void ProcessVoices(u32 count, const AXBuffers& output, const u32* buffer_sizes,
+	ProcessFunc process_voice)
+{
+	const u32 task_count = (count + VOICES_PER_TASK - 1) / VOICES_PER_TASK;
+	if (task_count <= 1)
+	{
+		for (u32 i = 0; i < count; ++i)
+			process_voice(i, output);
+		return;
+	}
+
+	u32 offsets[ArraySize(output.ptrs)];
+	u32 task_size = 0;
+	for (size_t i = 0; i < ArraySize(output.ptrs); ++i)
+	{
+		offsets[i] = task_size;
+		task_size += buffer_sizes[i];
+	}
+
+	std::vector<int> task_samples(task_size * task_count, 0);
+	Common::AsyncWorker::ExecuteParallel(
+		[&](int lower, int upper) {
+			for (int task = lower; task < upper; ++task)
+			{
+				AXBuffers buffers;
+				int* samples = &task_samples[task * task_size];
+				for (size_t i = 0; i < ArraySize(buffers.ptrs); ++i)
+					buffers.ptrs[i] = samples + offsets[i];
+
+				const u32 end = std::min(count, (task + 1) * VOICES_PER_TASK);
+				for (u32 voice = task * VOICES_PER_TASK; voice < end; ++voice)
+					process_voice(voice, buffers);
+			}
+		},
+		0, task_count, 1);
+
+	for (u32 task = 0; task < task_count; ++task)
+	{
+		const int* samples = &task_samples[task * task_size];
+		for (size_t i = 0; i < ArraySize(output.ptrs); ++i)
+		{
+			for (u32 j = 0; j < buffer_sizes[i]; ++j)
+				output.ptrs[i][j] += samples[offsets[i] + j];
+		}
+	}
+}
+
 }  // namespace
@@ -433,24 +433,46 @@ void AXWiiUCode::ReinjectUpdatesFields(AXPBWii& pb, u16* num_updates, u32 update
 
 void AXWiiUCode::ProcessPBList(u32 pb_addr)
 {
-	AXPBWii pb;
-
+	// Walk the list first. Updates can change next_pb, so they are applied to
+	// a copy of each PB to find the next one.
+	std::vector<u32> pb_addrs;
+	std::vector<AXPBWii> pbs;
 	while (pb_addr)
 	{
-		AXBuffers buffers = 
+		AXPBWii pb;
+		ReadPB(pb_addr, pb);
+		pb_addrs.push_back(pb_addr);
+		pbs.push_back(pb);
+
+		u16 num_updates[3];
+		u16 updates[1024];
+		u32 updates_addr;
+		if (ExtractUpdatesFields(pb, num_updates, updates, &updates_addr))
 		{
-			{
-				m_samples_left,      m_samples_right,      m_samples_surround,
-				m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
-				m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
-				m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
-				m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
-				m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
-				m_samples_wm3,       m_samples_aux3
-			}
-		};
+			for (int curr_ms = 0; curr_ms < 3; ++curr_ms)
+				ApplyUpdatesForMs(curr_ms, (u16*)&pb, num_updates, updates);
+		}
+		pb_addr = HILO_TO_32(pb.next_pb);
+	}
 
-		ReadPB(pb_addr, pb);
+	AXBuffers output = 
+	{
+		{
+			m_samples_left,      m_samples_right,      m_samples_surround,
+			m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+			m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
+			m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
+			m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
+			m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
+			m_samples_wm3,       m_samples_aux3
+		}
+	};
+	u32 buffer_sizes[ArraySize(output.ptrs)];
+	std::fill(std::begin(buffer_sizes), std::begin(buffer_sizes) + 12, 32 * 3);
+	std::fill(std::begin(buffer_sizes) + 12, std::end(buffer_sizes), 6 * 3);
+
+	ProcessVoices(static_cast<u32>(pbs.size()), output, buffer_sizes, [&](u32 voice, AXBuffers buffers) {
+		AXPBWii& pb = pbs[voice];
 
 		u16 num_updates[3];
 		u16 updates[1024];
@@ -474,10 +496,10 @@ void AXWiiUCode::ProcessPBList(u32 pb_addr)
 			ProcessVoice(pb, buffers, 96, ConvertMixerControl(HILO_TO_32(pb.mixer_control)),
 				m_coeffs_available ? m_coeffs : nullptr);
 		}
+	});
 
-		WritePB(pb_addr, pb);
-		pb_addr = HILO_TO_32(pb.next_pb);
-	}
+	for (size_t i = 0; i < pbs.size(); ++i)
+		WritePB(pb_addrs[i], pbs[i]);
 }
 
 void AXWiiUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr, u16 volume)
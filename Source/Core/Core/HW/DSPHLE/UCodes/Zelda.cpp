@@ -1383,29 +1383,43 @@ void ZeldaAudioRenderer::LoadInputSamples(MixingBuffer* buffer, VPB* vpb)
 	{
 		const u16 PATTERN_SIZE = 0x40;
 
-		struct PatternInfo
+		u16 pattern_idx;
+		switch (vpb->samples_source_type)
 		{
-			u16 idx;
-			bool variable_step;
-		};
-		std::map<u16, PatternInfo> samples_source_to_pattern = {
-			{ VPB::SRC_CONST_PATTERN_0,{ 0, false } },{ VPB::SRC_CONST_PATTERN_0_VARIABLE_STEP,{ 0, true } },
-			{ VPB::SRC_CONST_PATTERN_1,{ 1, false } },{ VPB::SRC_CONST_PATTERN_2,{ 2, false } },
-			{ VPB::SRC_CONST_PATTERN_3,{ 3, false } },
-		};
-		auto& pattern_info = samples_source_to_pattern[vpb->samples_source_type];
-		u16 pattern_offset = pattern_info.idx * PATTERN_SIZE;
-		s16* pattern = m_const_patterns.data() + pattern_offset;
+		case VPB::SRC_CONST_PATTERN_1:
+			pattern_idx = 1;
+			break;
+		case VPB::SRC_CONST_PATTERN_2:
+			pattern_idx = 2;
+			break;
+		case VPB::SRC_CONST_PATTERN_3:
+			pattern_idx = 3;
+			break;
+		default:
+			pattern_idx = 0;
+			break;
+		}
+		const s16* pattern = m_const_patterns.data() + pattern_idx * PATTERN_SIZE;
 
 		u32 pos = vpb->current_pos_frac << 6;  // log2(PATTERN_SIZE)
 		u32 step = vpb->resampling_ratio << 5;
 
-		for (size_t i = 0; i < buffer->size(); ++i)
+		if (vpb->samples_source_type == VPB::SRC_CONST_PATTERN_0_VARIABLE_STEP)
 		{
-			(*buffer)[i] = pattern[pos >> 16];
-			pos = (pos + step) % (PATTERN_SIZE << 16);
-			if (pattern_info.variable_step)
+			for (size_t i = 0; i < buffer->size(); ++i)
+			{
+				(*buffer)[i] = pattern[pos >> 16];
+				pos = (pos + step) % (PATTERN_SIZE << 16);
 				pos = ((pos << 10) + m_buf_back_right[i] * vpb->resampling_ratio) >> 10;
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < buffer->size(); ++i)
+			{
+				(*buffer)[i] = pattern[pos >> 16];
+				pos = (pos + step) % (PATTERN_SIZE << 16);
+			}
 		}
 
 		vpb->current_pos_frac = pos >> 6;
@@ -1668,64 +1682,66 @@ void ZeldaAudioRenderer::DownloadAFCSamplesFromARAM(s16* dst, VPB* vpb, u16 requ
 void ZeldaAudioRenderer::DecodeAFC(VPB* vpb, s16* dst, size_t block_count)
 {
 	u32 addr = vpb->GetCurrentARAMAddr();
-	u8* src = (u8*)GetARAMPtr() + addr;
+	const u8* src = (u8*)GetARAMPtr() + addr;
 	vpb->SetCurrentARAMAddr(addr + (u32)block_count * vpb->samples_source_type);
 
+	if (vpb->samples_source_type == VPB::SRC_AFC_HQ_FROM_ARAM)
+		DecodeAFCBlocks<true>(vpb, src, dst, block_count);
+	else
+		DecodeAFCBlocks<false>(vpb, src, dst, block_count);
+}
+
+template <bool HighQuality>
+void ZeldaAudioRenderer::DecodeAFCBlocks(VPB* vpb, const u8* src, s16* dst, size_t block_count)
+{
+	// The history lives in the VPB, keep it in registers for the whole batch.
+	s32 yn1 = *vpb->AFCYN1(), yn2 = *vpb->AFCYN2();
+
 	for (size_t b = 0; b < block_count; ++b)
 	{
-		s16 nibbles[16];
-		s16 delta = 1 << ((*src >> 4) & 0xF);
-		s16 idx = (*src & 0xF);
+		s32 nibbles[16];
+		// A scale of 15 wraps to -0x8000, like it does on the 16 bit DSP
+		const s32 delta = (s16)(1 << ((*src >> 4) & 0xF));
+		const s32 coef1 = m_afc_coeffs[(*src & 0xF) * 2];
+		const s32 coef2 = m_afc_coeffs[(*src & 0xF) * 2 + 1];
 		src++;
 
-		if (vpb->samples_source_type == VPB::SRC_AFC_HQ_FROM_ARAM)
+		// Sign extend the 4 or 2 bit values by shifting them to the top of an
+		// s32 and back down, straight into their 5.11 position.
+		if (HighQuality)
 		{
 			for (size_t i = 0; i < 16; i += 2)
 			{
-				nibbles[i + 0] = *src >> 4;
-				nibbles[i + 1] = *src & 0xF;
+				nibbles[i + 0] = ((s32)((u32)*src << 24) >> 28) << 11;
+				nibbles[i + 1] = ((s32)((u32)*src << 28) >> 28) << 11;
 				src++;
 			}
-			for (auto& nibble : nibbles)
-			{
-				if (nibble >= 8)
-					nibble -= 16;
-				nibble <<= 11;
-			}
 		}
 		else
 		{
 			for (size_t i = 0; i < 16; i += 4)
 			{
-				nibbles[i + 0] = (*src >> 6) & 3;
-				nibbles[i + 1] = (*src >> 4) & 3;
-				nibbles[i + 2] = (*src >> 2) & 3;
-				nibbles[i + 3] = (*src >> 0) & 3;
+				nibbles[i + 0] = ((s32)((u32)*src << 24) >> 30) << 13;
+				nibbles[i + 1] = ((s32)((u32)*src << 26) >> 30) << 13;
+				nibbles[i + 2] = ((s32)((u32)*src << 28) >> 30) << 13;
+				nibbles[i + 3] = ((s32)((u32)*src << 30) >> 30) << 13;
 				src++;
 			}
-			for (auto& nibble : nibbles)
-			{
-				if (nibble >= 2)
-					nibble -= 4;
-				nibble <<= 13;
-			}
 		}
 
-		s32 yn1 = *vpb->AFCYN1(), yn2 = *vpb->AFCYN2();
 		for (size_t i = 0; i < 16; ++i)
 		{
-			s32 sample =
-				delta * nibbles[i] + yn1 * m_afc_coeffs[idx * 2] + yn2 * m_afc_coeffs[idx * 2 + 1];
+			s32 sample = delta * nibbles[i] + yn1 * coef1 + yn2 * coef2;
 			sample >>= 11;
 			sample = MathUtil::Clamp(sample, -0x8000, 0x7fff);
 			*dst++ = (s16)sample;
 			yn2 = yn1;
 			yn1 = sample;
 		}
-
-		*vpb->AFCYN2() = yn2;
-		*vpb->AFCYN1() = yn1;
 	}
+
+	*vpb->AFCYN2() = yn2;
+	*vpb->AFCYN1() = yn1;
 }
 
 void ZeldaAudioRenderer::DownloadRawSamplesFromMRAM(s16* dst, VPB* vpb, u16 requested_samples_count)
@@ -4,6 +4,12 @@
 
 #pragma once
 
+#if defined(_M_X86)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
@@ -72,7 +78,45 @@ private:
 		if (!vol && !step)
 			return vol;
 
-		for (size_t i = 0; i < N; ++i)
+		// Only the integer part of the 1.31 volume is used, it fits a 16 bit
+		// lane and the product is the high half of a 16x16 multiply.
+		size_t i = 0;
+#if defined(_M_X86)
+		__m128i vol_lo = _mm_setr_epi32(vol, (s32)((u32)vol + (u32)step), (s32)((u32)vol + 2 * (u32)step),
+			(s32)((u32)vol + 3 * (u32)step));
+		const __m128i step4 = _mm_set1_epi32((s32)(4 * (u32)step));
+		__m128i vol_hi = _mm_add_epi32(vol_lo, step4);
+		const __m128i step8 = _mm_add_epi32(step4, step4);
+		for (; i + 8 <= N; i += 8)
+		{
+			const __m128i volumes = _mm_packs_epi32(_mm_srai_epi32(vol_lo, 16), _mm_srai_epi32(vol_hi, 16));
+			const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i]));
+			__m128i* out = reinterpret_cast<__m128i*>(&(*dst)[i]);
+			_mm_storeu_si128(out, _mm_add_epi16(_mm_loadu_si128(out), _mm_mulhi_epi16(volumes, samples)));
+			vol_lo = _mm_add_epi32(vol_lo, step8);
+			vol_hi = _mm_add_epi32(vol_hi, step8);
+		}
+		vol = (s32)((u32)vol + (u32)step * (u32)i);
+#elif defined(_M_ARM_64)
+		const s32 initial[4] = { vol, (s32)((u32)vol + (u32)step), (s32)((u32)vol + 2 * (u32)step),
+			(s32)((u32)vol + 3 * (u32)step) };
+		int32x4_t vol_lo = vld1q_s32(initial);
+		const int32x4_t step4 = vdupq_n_s32((s32)(4 * (u32)step));
+		int32x4_t vol_hi = vaddq_s32(vol_lo, step4);
+		const int32x4_t step8 = vaddq_s32(step4, step4);
+		for (; i + 8 <= N; i += 8)
+		{
+			const int16x8_t samples = vld1q_s16(&src[i]);
+			const int32x4_t lo = vmull_s16(vshrn_n_s32(vol_lo, 16), vget_low_s16(samples));
+			const int32x4_t hi = vmull_s16(vshrn_n_s32(vol_hi, 16), vget_high_s16(samples));
+			const int16x8_t product = vcombine_s16(vshrn_n_s32(lo, 16), vshrn_n_s32(hi, 16));
+			vst1q_s16(&(*dst)[i], vaddq_s16(vld1q_s16(&(*dst)[i]), product));
+			vol_lo = vaddq_s32(vol_lo, step8);
+			vol_hi = vaddq_s32(vol_hi, step8);
+		}
+		vol = (s32)((u32)vol + (u32)step * (u32)i);
+#endif
+		for (; i < N; ++i)
 		{
 			(*dst)[i] += ((vol >> 16) * src[i]) >> 16;
 			vol += step;
@@ -164,6 +208,10 @@ private:
 	// and other parameters appropriately.
 	void DownloadAFCSamplesFromARAM(s16* dst, VPB* vpb, u16 requested_samples_count);
 	void DecodeAFC(VPB* vpb, s16* dst, size_t block_count);
+	// One decoder per AFC flavour (9 or 5 bytes per 16 samples) so the block
+	// loop has no format checks.
+	template <bool HighQuality>
+	void DecodeAFCBlocks(VPB* vpb, const u8* src, s16* dst, size_t block_count);
 	std::array<s16, 0x20> m_afc_coeffs{};
 
 	// Downloads samples from MRAM while handling appropriate length / looping
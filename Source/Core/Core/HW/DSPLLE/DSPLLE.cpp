@@ -4,6 +4,7 @@
 
 #include "Core/HW/DSPLLE/DSPLLE.h"
 
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -15,8 +16,10 @@
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/Thread.h"
+#include "Common/TraceEvents.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/DSP/DSPAnalyzer.h"
 #include "Core/DSP/DSPCaptureLogger.h"
 #include "Core/DSP/DSPCore.h"
 #include "Core/DSP/DSPHWInterface.h"
@@ -31,6 +34,34 @@ static Common::Event dspEvent;
 static Common::Event ppcEvent;
 static bool requestDisableThread;
 
+// Set when the DSP stopped in a mailbox wait loop. Only written while the DSP is not running,
+// DSP_Update skips running it until the mailbox it polls changes.
+static std::atomic<bool> s_waiting_for_mail{false};
+
+static void UpdateWaitingForMail()
+{
+	s_waiting_for_mail.store(DSPAnalyzer::GetIdleWait(g_dsp.pc) != DSPAnalyzer::IdleWait::None,
+		std::memory_order_release);
+}
+
+static bool IsWaitingForMail()
+{
+	if (!s_waiting_for_mail.load(std::memory_order_acquire))
+		return false;
+	if (g_dsp.exceptions || g_dsp.external_interrupt_waiting || (g_dsp.cr & CR_HALT))
+		return false;
+
+	switch (DSPAnalyzer::GetIdleWait(g_dsp.pc))
+	{
+	case DSPAnalyzer::IdleWait::CPUMail:
+		return !(gdsp_mbox_peek(MAILBOX_CPU) & 0x80000000);
+	case DSPAnalyzer::IdleWait::DSPMailRead:
+		return (gdsp_mbox_peek(MAILBOX_DSP) & 0x80000000) != 0;
+	default:
+		return false;
+	}
+}
+
 DSPLLE::DSPLLE() = default;
 
 void DSPLLE::DoState(PointerWrap& p)
@@ -72,12 +103,16 @@ void DSPLLE::DoState(PointerWrap& p)
 	p.Do(g_cycles_left);
 	p.Do(g_init_hax);
 	p.Do(m_cycle_count);
+	if (p.GetMode() == PointerWrap::MODE_READ)
+		s_waiting_for_mail.store(false);
 }
 
 // Regular thread
 void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 {
 	Common::SetCurrentThreadName("DSP thread");
+	if (SConfig::GetInstance().bRaiseThreadPriority)
+		Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
 
 	while (dsp_lle->m_bIsRunning.IsSet())
 	{
@@ -85,6 +120,7 @@ void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 		if (cycles > 0)
 		{
 			std::lock_guard<std::mutex> dsp_thread_lock(dsp_lle->m_csDSPThreadActive);
+			TRACE_SCOPE("DSP::RunCycles");
 			if (g_dsp_jit)
 			{
 				DSPCore_RunCycles(cycles);
@@ -93,6 +129,7 @@ void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 			{
 				DSPInterpreter::RunCyclesThread(cycles);
 			}
+			UpdateWaitingForMail();
 			dsp_lle->m_cycle_count.store(0);
 		}
 		else
@@ -153,6 +190,7 @@ static bool FillDSPInitOptions(DSPInitOptions* opts)
 bool DSPLLE::Initialize(bool wii, bool dsp_thread)
 {
 	requestDisableThread = false;
+	s_waiting_for_mail.store(false);
 
 	DSPInitOptions opts;
 	if (!FillDSPInitOptions(&opts))
@@ -312,16 +350,23 @@ void DSPLLE::DSP_Update(int cycles)
 		}
 	}
 
+	// Running the wait loop would only burn these cycles. Nothing but the CPU changes what the
+	// loop polls, so skipping it does not change the outcome and stays deterministic.
+	if (IsWaitingForMail())
+		return;
+
 	// If we're not on a thread, run cycles here.
 	if (!m_bDSPThread)
 	{
 		// ~1/6th as many cycles as the period PPC-side.
 		DSPCore_RunCycles(dsp_cycles);
+		UpdateWaitingForMail();
 	}
 	else
 	{
 		// Wait for DSP thread to complete its cycle. Note: this logic should be thought through.
 		ppcEvent.Wait();
+		s_waiting_for_mail.store(false);
 		m_cycle_count.fetch_add(dsp_cycles);
 		dspEvent.Set();
 	}
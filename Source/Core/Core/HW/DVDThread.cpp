@@ -2,7 +2,9 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstring>
 #include <map>
 #include <mutex>
 #include <thread>
@@ -18,6 +20,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -56,10 +59,37 @@ struct ReadRequest
 
 using ReadResult = std::pair<ReadRequest, std::vector<u8>>;
 
+// Host-side read state of the DVD thread. None of this affects emulated
+// timing, FinishRead is still scheduled by the CPU thread as before.
+struct PrefetchState
+{
+	// Data read past the end of a sequential stream while the thread was idle
+	u64 offset = 0;
+	bool decrypt = false;
+	std::vector<u8> data;
+
+	// Where the most recent read ended and whether it continued the one before
+	u64 last_end = 0;
+	bool last_decrypt = false;
+	bool sequential = false;
+};
+
+// Pending requests that touch or overlap are served by one volume read,
+// as long as the combined range stays below this size.
+static constexpr u64 MAX_COALESCED_READ = 1024 * 1024;
+static constexpr size_t MAX_BATCHED_REQUESTS = 16;
+// How far past a sequential stream is read while idle, and in which steps.
+// The thread checks for new requests between steps, so they are not delayed
+// by more than one step.
+static constexpr size_t PREFETCH_SIZE = 512 * 1024;
+static constexpr size_t PREFETCH_STEP = 64 * 1024;
+
 static void StartDVDThread();
 static void StopDVDThread();
 
 static void DVDThread();
+static void ProcessRequests(std::vector<ReadRequest>& requests, PrefetchState& state);
+static void Prefetch(PrefetchState& state);
 
 static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offset, u32 length,
 	bool decrypt, DVDInterface::ReplyType reply_type,
@@ -263,10 +293,131 @@ static void FinishRead(u64 id, s64 cycles_late)
 		buffer);
 }
 
+static bool ReadDisc(const DiscIO::IVolume& volume, PrefetchState& state, u64 offset,
+	u64 length, u8* out_ptr, bool decrypt)
+{
+	state.sequential = offset == state.last_end && decrypt == state.last_decrypt;
+	state.last_end = offset + length;
+	state.last_decrypt = decrypt;
+
+	if (decrypt == state.decrypt && offset >= state.offset &&
+		offset + length <= state.offset + state.data.size())
+	{
+		std::memcpy(out_ptr, &state.data[offset - state.offset], static_cast<size_t>(length));
+		return true;
+	}
+
+	TRACE_SCOPE("DVD::Read");
+	return volume.Read(offset, length, out_ptr, decrypt);
+}
+
+static void ProcessRequests(std::vector<ReadRequest>& requests, PrefetchState& state)
+{
+	const DiscIO::IVolume& volume = DVDInterface::GetVolume();
+
+	size_t i = 0;
+	while (i < requests.size())
+	{
+		// Extend the range while the following requests touch it
+		u64 start = requests[i].dvd_offset;
+		u64 end = start + requests[i].length;
+		const bool decrypt = requests[i].decrypt;
+		size_t last = i + 1;
+		for (; last < requests.size() && requests[last].decrypt == decrypt; ++last)
+		{
+			const ReadRequest& next = requests[last];
+			const u64 new_start = std::min(start, next.dvd_offset);
+			const u64 new_end = std::max(end, next.dvd_offset + next.length);
+			if (next.dvd_offset > end || next.dvd_offset + next.length < start ||
+				new_end - new_start > MAX_COALESCED_READ)
+			{
+				break;
+			}
+			start = new_start;
+			end = new_end;
+		}
+
+		// If the combined read fails, every request is retried on its own so
+		// that only the broken ones report an error.
+		std::vector<u8> span;
+		if (last - i > 1)
+		{
+			span.resize(static_cast<size_t>(end - start));
+			if (!ReadDisc(volume, state, start, end - start, span.data(), decrypt))
+				span.clear();
+		}
+
+		for (; i < last; ++i)
+		{
+			ReadRequest& request = requests[i];
+			std::vector<u8> buffer(request.length);
+			if (!span.empty())
+			{
+				std::copy_n(&span[static_cast<size_t>(request.dvd_offset - start)], request.length,
+					buffer.begin());
+			}
+			else if (!ReadDisc(volume, state, request.dvd_offset, request.length, buffer.data(),
+				request.decrypt))
+			{
+				buffer.resize(0);
+			}
+
+			request.realtime_done_us = Common::Timer::GetTimeUs();
+
+			s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
+			s_result_queue_expanded.Set();
+		}
+	}
+}
+
+static void Prefetch(PrefetchState& state)
+{
+	if (!state.sequential)
+		return;
+
+	// Keep whatever was already read past the end of the stream
+	const u64 start = state.last_end;
+	if (state.decrypt != state.last_decrypt || start < state.offset ||
+		start > state.offset + state.data.size())
+	{
+		state.data.clear();
+	}
+	else
+	{
+		state.data.erase(state.data.begin(),
+			state.data.begin() + static_cast<size_t>(start - state.offset));
+	}
+	state.offset = start;
+	state.decrypt = state.last_decrypt;
+
+	const DiscIO::IVolume& volume = DVDInterface::GetVolume();
+	while (state.data.size() < PREFETCH_SIZE)
+	{
+		if (!s_request_queue.Empty() || s_dvd_thread_exiting.IsSet())
+			return;
+
+		const size_t filled = state.data.size();
+		state.data.resize(filled + PREFETCH_STEP);
+		TRACE_SCOPE("DVD::Prefetch");
+		if (!volume.Read(state.offset + filled, PREFETCH_STEP, &state.data[filled], state.decrypt))
+		{
+			// Most likely the end of the disc or partition
+			state.data.resize(filled);
+			break;
+		}
+	}
+	state.sequential = false;
+}
+
 static void DVDThread()
 {
 	Common::SetCurrentThreadName("DVD thread");
 
+	// The thread is restarted whenever the disc or partition changes, so
+	// prefetched data never outlives the volume it was read from.
+	PrefetchState state;
+	std::vector<ReadRequest> requests;
+
 	while (true)
 	{
 		s_request_queue_expanded.Wait();
@@ -277,19 +428,19 @@ static void DVDThread()
 		ReadRequest request;
 		while (s_request_queue.Pop(request))
 		{
-			std::vector<u8> buffer(request.length);
-			const DiscIO::IVolume& volume = DVDInterface::GetVolume();
-			if (!volume.Read(request.dvd_offset, request.length, buffer.data(), request.decrypt))
-				buffer.resize(0);
+			requests.clear();
+			requests.push_back(std::move(request));
+			while (requests.size() < MAX_BATCHED_REQUESTS && s_request_queue.Pop(request))
+				requests.push_back(std::move(request));
 
-			request.realtime_done_us = Common::Timer::GetTimeUs();
-
-			s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
-			s_result_queue_expanded.Set();
+			ProcessRequests(requests, state);
 
 			if (s_dvd_thread_exiting.IsSet())
 				return;
 		}
+
+		// Only runs while no request is waiting
+		Prefetch(state);
 	}
 }
 }
@@ -48,8 +48,12 @@ CEXIETHERNET::CEXIETHERNET()
 #if defined(_WIN32)
 	mHAdapter = INVALID_HANDLE_VALUE;
 	memset(&mReadOverlapped, 0, sizeof(mReadOverlapped));
-	memset(&mWriteOverlapped, 0, sizeof(mWriteOverlapped));
-	mWritePending = false;
+	for (WriteSlot& slot : mWriteSlots)
+	{
+		memset(&slot.overlapped, 0, sizeof(slot.overlapped));
+		slot.pending = false;
+	}
+	mNextWriteSlot = 0;
 #elif defined(__linux__) || defined(__APPLE__)
 	fd = -1;
 #endif
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <thread>
 #include <vector>
@@ -324,9 +325,17 @@ public:
 #if defined(_WIN32)
 	HANDLE mHAdapter;
 	OVERLAPPED mReadOverlapped;
-	OVERLAPPED mWriteOverlapped;
-	std::vector<u8> mWriteBuffer;
-	bool mWritePending;
+	// Frames are written asynchronously from a small ring of slots, so the CPU thread only has to
+	// wait on the adapter when every slot still has a write in flight.
+	struct WriteSlot
+	{
+		OVERLAPPED overlapped;
+		std::vector<u8> buffer;
+		bool pending;
+	};
+	static const size_t WRITE_SLOT_COUNT = 8;
+	std::array<WriteSlot, WRITE_SLOT_COUNT> mWriteSlots;
+	size_t mNextWriteSlot;
 #elif defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
 	int fd;
 #endif
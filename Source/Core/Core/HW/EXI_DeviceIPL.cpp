@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 
 #include "Common/Assert.h"
@@ -17,6 +18,7 @@
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/EXI_DeviceIPL.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/Sram.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/Movie.h"
@@ -371,21 +373,7 @@ void CEXIIPL::TransferByte(u8& _uByte)
 					// At the moment, we pre-decrypt the whole thing and
 					// ignore the "enabled" bit - see CEXIIPL::CEXIIPL
 					_uByte = m_pIPL[position];
-
-					if ((position >= 0x001AFF00) && (position <= 0x001FF474) && !m_FontsLoaded)
-					{
-						if (position >= 0x001FCF00)
-						{
-							PanicAlertT("Error: Trying to access Windows-1252 fonts but they are not loaded. "
-								"Games may not show fonts correctly, or crash.");
-						}
-						else
-						{
-							PanicAlertT("Error: Trying to access Shift JIS fonts but they are not loaded. "
-								"Games may not show fonts correctly, or crash.");
-						}
-						m_FontsLoaded = true;  // Don't be a nag :p
-					}
+					WarnIfFontsMissing(position);
 				}
 			}
 			else
@@ -402,6 +390,45 @@ void CEXIIPL::TransferByte(u8& _uByte)
 	m_uPosition++;
 }
 
+void CEXIIPL::WarnIfFontsMissing(u32 position)
+{
+	if ((position >= 0x001AFF00) && (position <= 0x001FF474) && !m_FontsLoaded)
+	{
+		if (position >= 0x001FCF00)
+		{
+			PanicAlertT("Error: Trying to access Windows-1252 fonts but they are not loaded. "
+				"Games may not show fonts correctly, or crash.");
+		}
+		else
+		{
+			PanicAlertT("Error: Trying to access Shift JIS fonts but they are not loaded. "
+				"Games may not show fonts correctly, or crash.");
+		}
+		m_FontsLoaded = true;  // Don't be a nag :p
+	}
+}
+
+// ROM reads (the BIOS fonts, and the IPL itself when booting it) are done with DMA after the
+// address has been sent via ImmWrite. Copy those in one go instead of a byte at a time.
+void CEXIIPL::DMARead(u32 _uAddr, u32 _uSize)
+{
+	// The other regions all live above the ROM address range
+	u32 position = ((m_uAddress >> 6) & ROM_MASK) + m_uRWOffset;
+	if (m_uPosition <= 3 || IsWriteCommand() || (m_uAddress >> 6) >= ROM_SIZE || _uSize == 0 ||
+		position + _uSize > ROM_SIZE)
+	{
+		IEXIDevice::DMARead(_uAddr, _uSize);
+		return;
+	}
+
+	// Only the first font byte touched matters for the warning
+	WarnIfFontsMissing(std::max<u32>(position, std::min<u32>(0x001AFF00, position + _uSize - 1)));
+
+	Memory::CopyToEmu(_uAddr, m_pIPL + position, _uSize);
+	m_uRWOffset += _uSize;
+	m_uPosition += _uSize;
+}
+
 u32 CEXIIPL::GetEmulatedTime(u32 epoch)
 {
 	u64 ltime = 0;
@@ -18,6 +18,7 @@ public:
 
 	void SetCS(int _iCS) override;
 	bool IsPresent() const override;
+	void DMARead(u32 _uAddr, u32 _uSize) override;
 	void DoState(PointerWrap& p) override;
 
 	static constexpr u32 UNIX_EPOCH = 0;          // 1970-01-01 00:00:00
@@ -73,6 +74,7 @@ private:
 	void UpdateRTC();
 
 	void TransferByte(u8& _uByte) override;
+	void WarnIfFontsMissing(u32 position);
 	bool IsWriteCommand() const { return !!(m_uAddress & (1 << 31)); }
 	u32 CommandRegion() const { return (m_uAddress & ~(1 << 31)) >> 8; }
 	void LoadFileToIPL(const std::string& filename, u32 offset);
@@ -100,11 +100,9 @@ int GCMemcardDirectory::LoadGCI(const std::string& fileName, DiscIO::Country car
 			return NO_INDEX;
 		}
 
-		if (m_GameId == BE32(gci.m_gci_header.Gamecode))
-		{
-			gci.LoadSaveBlocks();
-		}
-		else
+		// Save blocks, even the current game's, are read on first access in SaveAreaRW, so only the
+		// header of each file is read here
+		if (m_GameId != BE32(gci.m_gci_header.Gamecode))
 		{
 			if (currentGameOnly)
 			{
@@ -149,7 +147,7 @@ GCMemcardDirectory::GCMemcardDirectory(const std::string& directory, int slot, u
 	bool shift_jis, DiscIO::Country card_region, int gameId)
 	: MemoryCardBase(slot, sizeMb), m_GameId(gameId), m_LastBlock(-1),
 	m_hdr(slot, sizeMb, shift_jis), m_bat1(sizeMb), m_saves(0), m_SaveDirectory(directory),
-	m_exiting(false)
+	m_card_region(card_region), m_exiting(false)
 {
 	// Use existing header data if available
 	if (File::Exists(m_SaveDirectory + MC_HDR))
@@ -158,6 +156,13 @@ GCMemcardDirectory::GCMemcardDirectory(const std::string& directory, int slot, u
 		hdrfile.ReadBytes(&m_hdr, BLOCK_SIZE);
 	}
 
+	// Reading every GCI of the folder is left to the flushing thread so it overlaps the rest of
+	// the boot, only the header is needed right away
+	m_flush_thread = std::thread(&GCMemcardDirectory::FlushThread, this);
+}
+
+void GCMemcardDirectory::LoadSaves()
+{
 	std::vector<std::string> rFilenames = DoFileSearch({ ".gci" }, { m_SaveDirectory });
 
 	if (rFilenames.size() > 112)
@@ -177,7 +182,7 @@ GCMemcardDirectory::GCMemcardDirectory(const std::string& directory, int slot, u
 				m_SaveDirectory.c_str());
 			break;
 		}
-		int index = LoadGCI(gciFile, card_region, m_saves.size() > 112);
+		int index = LoadGCI(gciFile, m_card_region, m_saves.size() > 112);
 		if (index != NO_INDEX)
 		{
 			m_loaded_saves.push_back(m_saves.at(index).m_gci_header.GCI_FileName());
@@ -188,12 +193,21 @@ GCMemcardDirectory::GCMemcardDirectory(const std::string& directory, int slot, u
 	m_dir1.fixChecksums();
 	m_dir2 = m_dir1;
 	m_bat2 = m_bat1;
+}
 
-	m_flush_thread = std::thread(&GCMemcardDirectory::FlushThread, this);
+// Only the CPU thread waits here, the flushing thread and the destructor run after the load anyway
+void GCMemcardDirectory::WaitForSaves()
+{
+	if (!m_saves_loaded.IsSet())
+		m_saves_loaded_event.Wait();
 }
 
 void GCMemcardDirectory::FlushThread()
 {
+	LoadSaves();
+	m_saves_loaded.Set();
+	m_saves_loaded_event.Set();
+
 	if (!SConfig::GetInstance().bEnableMemcardSdWriting)
 	{
 		return;
@@ -234,6 +248,10 @@ s32 GCMemcardDirectory::Read(u32 address, s32 length, u8* destaddress)
 	u32 offset = address % BLOCK_SIZE;
 	s32 extra = 0;  // used for read calls that are across multiple blocks
 
+	// The header is there from the start, the card id is read from it during device creation
+	if (block != 0)
+		WaitForSaves();
+
 	if (offset + length > BLOCK_SIZE)
 	{
 		extra = length + offset - BLOCK_SIZE;
@@ -287,6 +305,7 @@ s32 GCMemcardDirectory::Read(u32 address, s32 length, u8* destaddress)
 
 s32 GCMemcardDirectory::Write(u32 destaddress, s32 length, u8* srcaddress)
 {
+	WaitForSaves();
 	std::unique_lock<std::mutex> l(m_write_mutex);
 	if (length != 0x80)
 		INFO_LOG(EXPANSIONINTERFACE, "Writing to 0x%x. Length: 0x%x", destaddress, length);
@@ -355,6 +374,7 @@ s32 GCMemcardDirectory::Write(u32 destaddress, s32 length, u8* srcaddress)
 
 void GCMemcardDirectory::ClearBlock(u32 address)
 {
+	WaitForSaves();
 	if (address % BLOCK_SIZE)
 	{
 		PanicAlertT("GCMemcardDirectory: ClearBlock called with invalid block address");
@@ -546,9 +566,21 @@ bool GCMemcardDirectory::SetUsedBlocks(int saveIndex)
 
 void GCMemcardDirectory::FlushToFile()
 {
+	// Only one flush at a time, but the emulated card must not wait for it.
+	// Modified saves are copied while m_write_mutex is held and hit the disk
+	// after it is released, so a slow SD card no longer stalls the CPU thread.
+	std::lock_guard<std::mutex> flush_lock(m_flush_mutex);
+
+	struct PendingWrite
+	{
+		std::string filename;
+		DEntry header;
+		std::vector<GCMBlock> save_data;
+	};
+	std::vector<PendingWrite> writes;
+	std::vector<std::string> deletes;
+
 	std::unique_lock<std::mutex> l(m_write_mutex);
-	int errors = 0;
-	DEntry invalid;
 	for (u16 i = 0; i < m_saves.size(); ++i)
 	{
 		if (m_saves[i].m_dirty)
@@ -581,36 +613,12 @@ void GCMemcardDirectory::FlushToFile()
 							defaultSaveName.c_str());
 					m_saves[i].m_filename = defaultSaveName;
 				}
-				File::IOFile GCI(m_saves[i].m_filename, "wb");
-				if (GCI)
-				{
-					GCI.WriteBytes(&m_saves[i].m_gci_header, DENTRY_SIZE);
-					GCI.WriteBytes(m_saves[i].m_save_data.data(), BLOCK_SIZE * m_saves[i].m_save_data.size());
-
-					if (GCI.IsGood())
-					{
-						Core::DisplayMessage(
-							StringFromFormat("Wrote save contents to %s", m_saves[i].m_filename.c_str()), 4000);
-					}
-					else
-					{
-						++errors;
-						Core::DisplayMessage(StringFromFormat("Failed to write save contents to %s",
-							m_saves[i].m_filename.c_str()),
-							4000);
-						ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s",
-							m_saves[i].m_filename.c_str());
-					}
-				}
+				writes.push_back({m_saves[i].m_filename, m_saves[i].m_gci_header, m_saves[i].m_save_data});
 			}
 			else if (m_saves[i].m_filename.length() != 0)
 			{
 				m_saves[i].m_dirty = false;
-				std::string& oldname = m_saves[i].m_filename;
-				std::string deletedname = oldname + ".deleted";
-				if (File::Exists(deletedname))
-					File::Delete(deletedname);
-				File::Rename(oldname, deletedname);
+				deletes.push_back(m_saves[i].m_filename);
 				m_saves[i].m_filename.clear();
 				m_saves[i].m_save_data.clear();
 				m_saves[i].m_used_blocks.clear();
@@ -630,6 +638,43 @@ void GCMemcardDirectory::FlushToFile()
 			m_saves[i].m_save_data.clear();
 		}
 	}
+	l.unlock();
+
+	for (const PendingWrite& write : writes)
+	{
+		// Write next to the old file and rename over it, so that a crash or a
+		// full card mid-write never leaves a truncated save behind
+		const std::string temp_name = write.filename + ".tmp";
+		bool good;
+		{
+			File::IOFile GCI(temp_name, "wb");
+			good = GCI && GCI.WriteBytes(&write.header, DENTRY_SIZE) &&
+				GCI.WriteBytes(write.save_data.data(), BLOCK_SIZE * write.save_data.size());
+		}
+		good = good && File::Rename(temp_name, write.filename);
+
+		if (good)
+		{
+			Core::DisplayMessage(
+				StringFromFormat("Wrote save contents to %s", write.filename.c_str()), 4000);
+		}
+		else
+		{
+			File::Delete(temp_name);
+			Core::DisplayMessage(
+				StringFromFormat("Failed to write save contents to %s", write.filename.c_str()), 4000);
+			ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s", write.filename.c_str());
+		}
+	}
+
+	for (const std::string& oldname : deletes)
+	{
+		std::string deletedname = oldname + ".deleted";
+		if (File::Exists(deletedname))
+			File::Delete(deletedname);
+		File::Rename(oldname, deletedname);
+	}
+
 #if _WRITE_MC_HEADER
 	u8 mc[BLOCK_SIZE * MC_FST_BLOCKS];
 	Read(0, BLOCK_SIZE * MC_FST_BLOCKS, mc);
@@ -640,7 +685,18 @@ void GCMemcardDirectory::FlushToFile()
 
 void GCMemcardDirectory::DoState(PointerWrap& p)
 {
+	WaitForSaves();
 	std::unique_lock<std::mutex> l(m_write_mutex);
+	// The save data of the current game always goes into the savestate, also when the game has not
+	// touched it yet
+	if (p.GetMode() != PointerWrap::MODE_READ)
+	{
+		for (GCIFile& save : m_saves)
+		{
+			if (BE32(save.m_gci_header.Gamecode) == m_GameId)
+				save.LoadSaveBlocks();
+		}
+	}
 	m_LastBlock = -1;
 	m_LastBlockAddress = nullptr;
 	p.Do(m_SaveDirectory);
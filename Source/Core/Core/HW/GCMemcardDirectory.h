@@ -36,6 +36,8 @@ public:
 
 private:
 	int LoadGCI(const std::string& fileName, DiscIO::Country card_region, bool currentGameOnly);
+	void LoadSaves();
+	void WaitForSaves();
 	inline s32 SaveAreaRW(u32 block, bool writing = false);
 	// s32 DirectoryRead(u32 offset, u32 length, u8* destaddress);
 	s32 DirectoryWrite(u32 destaddress, u32 length, u8* srcaddress);
@@ -53,9 +55,13 @@ private:
 
 	std::vector<std::string> m_loaded_saves;
 	std::string m_SaveDirectory;
+	DiscIO::Country m_card_region;
 	const std::chrono::seconds flush_interval = std::chrono::seconds(1);
 	Common::Event m_flush_trigger;
 	std::mutex m_write_mutex;
+	std::mutex m_flush_mutex;
 	Common::Flag m_exiting;
+	Common::Flag m_saves_loaded;
+	Common::Event m_saves_loaded_event;
 	std::thread m_flush_thread;
 };
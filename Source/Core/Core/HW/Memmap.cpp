@@ -7,14 +7,23 @@
 // However, if a JITed instruction (for example lwz) wants to access a bad memory area that call
 // may be redirected here (for example to Read_U32()).
 
+#include <atomic>
 #include <cstring>
 #include <memory>
+#include <new>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
+#include "Common/StringUtil.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/DSP.h"
@@ -46,6 +55,10 @@ u8* logical_base = nullptr;
 
 // The MemArena class
 static MemArena g_arena;
+// Shared header describing g_arena to external tools, see ExportedMemoryInfo
+static MemArena s_export_arena;
+static ExportedMemoryInfo* s_export_info = nullptr;
+static const u32 EXPORT_INFO_SIZE = 0x1000;
 // ==============
 
 // STATE_TO_SAVE
@@ -165,6 +178,317 @@ static MemoryView views[] = {
 };
 static const int num_views = sizeof(views) / sizeof(MemoryView);
 
+// Protection is done on host pages, all views of MEM1 have to be protected together.
+static const u32 WRITE_TRACKING_PAGE_SIZE = 0x1000;
+static const u32 WRITE_TRACKING_PAGE_COUNT = RAM_SIZE / WRITE_TRACKING_PAGE_SIZE;
+static std::atomic<bool> s_write_tracking_enabled{ false };
+static std::atomic_flag s_write_tracking_lock = ATOMIC_FLAG_INIT;
+static std::atomic<u64> s_write_sequence{ 1 };
+static std::atomic<u64> s_page_last_write[WRITE_TRACKING_PAGE_COUNT];
+static bool s_page_protected[WRITE_TRACKING_PAGE_COUNT];
+
+// Where the last incremental savestate put MEM1, and the write sequence it was taken at.
+static bool s_incremental_save = false;
+static u8* s_incremental_dest = nullptr;
+static u64 s_incremental_sequence = 0;
+
+static void LockWriteTracking()
+{
+	while (s_write_tracking_lock.test_and_set(std::memory_order_acquire)) {}
+}
+
+static void UnlockWriteTracking()
+{
+	s_write_tracking_lock.clear(std::memory_order_release);
+}
+
+static void SetPageProtection(u32 page, u32 count, bool protect)
+{
+	for (const MemoryView& view : views)
+	{
+		if (!view.mapped_ptr || view.shm_position != views[0].shm_position)
+			continue;
+		u8* ptr = static_cast<u8*>(view.mapped_ptr) + page * WRITE_TRACKING_PAGE_SIZE;
+		if (protect)
+			Common::WriteProtectMemory(ptr, count * WRITE_TRACKING_PAGE_SIZE);
+		else
+			Common::UnWriteProtectMemory(ptr, count * WRITE_TRACKING_PAGE_SIZE);
+	}
+}
+
+// Changes the protection of every page in the range whose state differs, a run at a time,
+// so protecting all of MEM1 again after a few pages were written costs a few calls.
+static void SetRangeProtection(u32 first_page, u32 last_page, bool protect)
+{
+	u32 page = first_page;
+	while (page <= last_page)
+	{
+		if (s_page_protected[page] == protect)
+		{
+			page++;
+			continue;
+		}
+		u32 run_end = page;
+		while (run_end <= last_page && s_page_protected[run_end] != protect)
+			s_page_protected[run_end++] = protect;
+		SetPageProtection(page, run_end - page, protect);
+		page = run_end;
+	}
+}
+
+// Unprotects everything and marks all pages as written.
+static void ResetWriteTracking()
+{
+	LockWriteTracking();
+	u64 sequence = ++s_write_sequence;
+	SetRangeProtection(0, WRITE_TRACKING_PAGE_COUNT - 1, false);
+	for (u32 page = 0; page < WRITE_TRACKING_PAGE_COUNT; page++)
+		s_page_last_write[page] = sequence;
+	UnlockWriteTracking();
+}
+
+void SetWriteTrackingEnabled(bool enabled)
+{
+	// The mirrors are only separate mappings of the same memory on 64-bit hosts.
+#if _ARCH_64
+	if (!enabled)
+		s_write_tracking_enabled = false;
+	else
+		UnmapLogicalPages(0, 0);
+	ResetWriteTracking();
+	if (enabled)
+		s_write_tracking_enabled = true;
+#endif
+}
+
+bool IsWriteTrackingEnabled()
+{
+	return s_write_tracking_enabled.load();
+}
+
+u64 TrackWrites(u32 address, u32 size)
+{
+	address &= 0x3FFFFFFF;
+	if (!s_write_tracking_enabled.load() || size == 0 || address >= REALRAM_SIZE ||
+		size > REALRAM_SIZE - address)
+	{
+		return 0;
+	}
+
+	// Writes after the protection fault and bump the page past the returned sequence.
+	LockWriteTracking();
+	u64 sequence = s_write_sequence.load();
+	SetRangeProtection(address / WRITE_TRACKING_PAGE_SIZE,
+		(address + size - 1) / WRITE_TRACKING_PAGE_SIZE, true);
+	UnlockWriteTracking();
+	return sequence;
+}
+
+bool WasWrittenSince(u32 address, u32 size, u64 sequence)
+{
+	address &= 0x3FFFFFFF;
+	if (!s_write_tracking_enabled.load() || sequence == 0 || size == 0 ||
+		address >= REALRAM_SIZE || size > REALRAM_SIZE - address)
+	{
+		return true;
+	}
+
+	for (u32 page = address / WRITE_TRACKING_PAGE_SIZE;
+		page <= (address + size - 1) / WRITE_TRACKING_PAGE_SIZE; page++)
+	{
+		if (s_page_last_write[page].load() > sequence)
+			return true;
+	}
+	return false;
+}
+
+bool HandleWriteTrackingFault(uintptr_t fault_address)
+{
+	if (!s_write_tracking_enabled.load())
+		return false;
+
+	for (const MemoryView& view : views)
+	{
+		if (!view.mapped_ptr || view.shm_position != views[0].shm_position)
+			continue;
+		uintptr_t base = reinterpret_cast<uintptr_t>(view.mapped_ptr);
+		if (fault_address < base || fault_address >= base + RAM_SIZE)
+			continue;
+
+		// MEM1 is always writable otherwise, so this has to be one of our pages.
+		u32 page = static_cast<u32>((fault_address - base) / WRITE_TRACKING_PAGE_SIZE);
+		LockWriteTracking();
+		if (s_page_protected[page])
+		{
+			SetPageProtection(page, 1, false);
+			s_page_protected[page] = false;
+		}
+		s_page_last_write[page] = ++s_write_sequence;
+		UnlockWriteTracking();
+		return true;
+	}
+	return false;
+}
+
+void SetIncrementalSave(bool incremental)
+{
+	s_incremental_save = incremental;
+}
+
+// Only copies the pages of MEM1 that were written since the previous incremental save, if it
+// went to the same place. Untracked memory past REALRAM_SIZE is always copied.
+static void DoIncrementalRAMState(PointerWrap& p)
+{
+	u8* dest = *p.ptr;
+	const u64 sequence = TrackWrites(0, REALRAM_SIZE);
+	if (dest != s_incremental_dest || s_incremental_sequence == 0)
+	{
+		memcpy(dest, m_pRAM, RAM_SIZE);
+	}
+	else
+	{
+		for (u32 offset = 0; offset < REALRAM_SIZE; offset += WRITE_TRACKING_PAGE_SIZE)
+		{
+			if (WasWrittenSince(offset, WRITE_TRACKING_PAGE_SIZE, s_incremental_sequence))
+				memcpy(dest + offset, m_pRAM + offset, WRITE_TRACKING_PAGE_SIZE);
+		}
+		memcpy(dest + REALRAM_SIZE, m_pRAM + REALRAM_SIZE, RAM_SIZE - REALRAM_SIZE);
+	}
+	*p.ptr += RAM_SIZE;
+	s_incremental_dest = dest;
+	s_incremental_sequence = sequence;
+}
+
+// Pages the MMU translated through the page table, mapped into the logical view so that the
+// JIT's fastmem accesses to them don't fault. Views are placed with emulated page granularity,
+// which Windows can't do (64 KiB), and need the 64-bit address space layout.
+#if _ARCH_64 && !defined(_WIN32)
+static const u32 LOGICAL_PAGE_SIZE = 0x1000;
+// Page address -> mapped writable
+static std::unordered_map<u32, bool> s_logical_pages;
+#endif
+
+void MapLogicalPage(u32 logical_address, u32 physical_address, bool writable)
+{
+#if _ARCH_64 && !defined(_WIN32)
+	// Writes through these views would bypass the protection write tracking relies on
+	if (!logical_base || !SConfig::GetInstance().bFastmem || s_write_tracking_enabled.load())
+		return;
+
+	const u32 page = logical_address & ~(LOGICAL_PAGE_SIZE - 1);
+	const u32 physical_page = physical_address & ~(LOGICAL_PAGE_SIZE - 1);
+	auto it = s_logical_pages.find(page);
+	if (it != s_logical_pages.end() && (it->second || !writable))
+		return;
+
+	const MemoryView* source = nullptr;
+	for (const MemoryView& view : views)
+	{
+		if (!view.mapped_ptr)
+			continue;
+
+		// Never replace part of a fixed logical view
+		if (view.virtual_address >= 0x200000000)
+		{
+			const u64 logical_start = view.virtual_address - 0x200000000;
+			if (page >= logical_start && page < logical_start + view.size)
+				return;
+		}
+		else if (physical_page >= view.virtual_address &&
+			physical_page < view.virtual_address + view.size)
+		{
+			source = &view;
+		}
+	}
+	if (!source)
+		return;
+
+	u8* ptr = logical_base + page;
+	if (!g_arena.CreateView(source->shm_position + (physical_page - source->virtual_address),
+		LOGICAL_PAGE_SIZE, ptr))
+	{
+		return;
+	}
+
+	// Until a write went through the MMU and set the C bit, stores have to take the slow path
+	if (!writable)
+		Common::WriteProtectMemory(ptr, LOGICAL_PAGE_SIZE);
+	s_logical_pages[page] = writable;
+#endif
+}
+
+void UnmapLogicalPages(u32 mask, u32 value)
+{
+#if _ARCH_64 && !defined(_WIN32)
+	for (auto it = s_logical_pages.begin(); it != s_logical_pages.end();)
+	{
+		if ((it->first & mask) == value)
+		{
+			g_arena.ReleaseView(logical_base + it->first, LOGICAL_PAGE_SIZE);
+			it = s_logical_pages.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+#endif
+}
+
+static std::string GetExportName()
+{
+#ifdef _WIN32
+	return StringFromFormat("Local\\dolphin-emu.%lu", GetCurrentProcessId());
+#else
+	return StringFromFormat("/dolphin-emu.%d", static_cast<int>(getpid()));
+#endif
+}
+
+static void InitExport(const std::string& name)
+{
+	s_export_arena.GrabSHMSegment(EXPORT_INFO_SIZE, name + "-info");
+	void* view = s_export_arena.CreateView(0, EXPORT_INFO_SIZE);
+	if (!view)
+	{
+		s_export_arena.ReleaseSHMSegment();
+		return;
+	}
+
+	s_export_info = new (view) ExportedMemoryInfo();
+	s_export_info->mem1_offset = views[0].shm_position;
+	s_export_info->mem1_size = REALRAM_SIZE;
+	s_export_info->mem2_offset = 0;
+	for (const MemoryView& memory_view : views)
+	{
+		if (memory_view.out_ptr == &m_pEXRAM && SConfig::GetInstance().bWii)
+			s_export_info->mem2_offset = memory_view.shm_position;
+	}
+	s_export_info->mem2_size = SConfig::GetInstance().bWii ? EXRAM_SIZE : 0;
+	s_export_info->frame_count.store(0);
+	s_export_info->version = ExportedMemoryInfo::VERSION;
+	// Written last, readers check it before trusting the rest
+	std::atomic_thread_fence(std::memory_order_release);
+	s_export_info->magic = ExportedMemoryInfo::MAGIC;
+	NOTICE_LOG(MEMMAP, "Guest memory exported as %s", name.c_str());
+}
+
+static void ShutdownExport()
+{
+	if (!s_export_info)
+		return;
+	s_export_info->magic = 0;
+	s_export_info->~ExportedMemoryInfo();
+	s_export_arena.ReleaseView(s_export_info, EXPORT_INFO_SIZE);
+	s_export_arena.ReleaseSHMSegment();
+	s_export_info = nullptr;
+}
+
+void UpdateExportedFrameCount()
+{
+	if (s_export_info)
+		s_export_info->frame_count.fetch_add(1, std::memory_order_release);
+}
+
 void Init()
 {
 	bool wii = SConfig::GetInstance().bWii;
@@ -181,7 +505,11 @@ void Init()
 		flags |= MV_WII_ONLY;
 	if (bFakeVMEM)
 		flags |= MV_FAKE_VMEM;
-	physical_base = MemoryMap_Setup(views, num_views, flags, &g_arena);
+	const bool export_memory = SConfig::GetInstance().bExportGuestMemory;
+	const std::string export_name = export_memory ? GetExportName() : "";
+	physical_base = MemoryMap_Setup(views, num_views, flags, &g_arena, export_name);
+	if (export_memory)
+		InitExport(export_name);
 #ifndef _ARCH_32
 	logical_base = physical_base + 0x200000000;
 #endif
@@ -200,7 +528,13 @@ void Init()
 void DoState(PointerWrap& p)
 {
 	bool wii = SConfig::GetInstance().bWii;
-	p.DoArray(m_pRAM, RAM_SIZE);
+	// Avoids a fault for every tracked page while loading.
+	if (p.GetMode() == PointerWrap::MODE_READ && s_write_tracking_enabled.load())
+		ResetWriteTracking();
+	if (p.GetMode() == PointerWrap::MODE_WRITE && s_incremental_save)
+		DoIncrementalRAMState(p);
+	else
+		p.DoArray(m_pRAM, RAM_SIZE);
 	p.DoArray(m_pL1Cache, L1_CACHE_SIZE);
 	p.DoMarker("Memory RAM");
 	if (bFakeVMEM)
@@ -214,6 +548,11 @@ void DoState(PointerWrap& p)
 void Shutdown()
 {
 	m_IsInitialized = false;
+	if (s_write_tracking_enabled.load())
+		SetWriteTrackingEnabled(false);
+	UnmapLogicalPages(0, 0);
+	s_incremental_dest = nullptr;
+	s_incremental_sequence = 0;
 	u32 flags = 0;
 	if (SConfig::GetInstance().bWii)
 		flags |= MV_WII_ONLY;
@@ -221,6 +560,7 @@ void Shutdown()
 		flags |= MV_FAKE_VMEM;
 	MemoryMap_Shutdown(views, num_views, flags, &g_arena);
 	g_arena.ReleaseSHMSegment();
+	ShutdownExport();
 	physical_base = nullptr;
 	logical_base = nullptr;
 	mmio_mapping.reset();
@@ -274,6 +614,33 @@ void CopyFromEmu(void* data, u32 address, size_t size)
 	memcpy(data, pointer, size);
 }
 
+bool TryCopyFromEmu(void* data, u32 address, size_t size)
+{
+	if (size == 0)
+		return true;
+	if (!m_IsInitialized || size >= EXRAM_SIZE)
+		return false;
+
+	// Same checks as GetPointer, without the alert
+	const u32 start = address & 0x3FFFFFFF;
+	const u32 end = start + u32(size) - 1;
+	const u8* pointer = nullptr;
+	if (end < REALRAM_SIZE)
+	{
+		pointer = m_pRAM + start;
+	}
+	else if (SConfig::GetInstance().bWii && (start >> 28) == 0x1 && (end >> 28) == 0x1 &&
+		(end & 0x0fffffff) < EXRAM_SIZE)
+	{
+		pointer = m_pEXRAM + (start & EXRAM_MASK);
+	}
+	if (!pointer)
+		return false;
+
+	memcpy(data, pointer, size);
+	return true;
+}
+
 void CopyToEmu(u32 address, const void* data, size_t size)
 {
 	if (size == 0)
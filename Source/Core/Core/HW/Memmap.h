@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -69,21 +70,70 @@ enum
 // MMIO mapping object.
 extern std::unique_ptr<MMIO::Mapping> mmio_mapping;
 
+// With ExportGuestMemory set, the RAM arena is shared with other processes as
+// "dolphin-emu.<pid>" ("/dolphin-emu.<pid>" for shm_open, "Local\dolphin-emu.<pid>" on Windows),
+// and this header is shared as "dolphin-emu.<pid>-info". Tools map both read-only. The game keeps
+// writing RAM while they read: frame_count is bumped once per emulated frame, so a reader that
+// sees the same count before and after a read knows it did not straddle a frame boundary.
+struct ExportedMemoryInfo
+{
+	enum : u32
+	{
+		MAGIC = 0x4d454d44,  // "DMEM"
+		VERSION = 1,
+	};
+	u32 magic;
+	u32 version;
+	std::atomic<u32> frame_count;
+	// Offsets into the shared arena. MEM2 is 0 sized on the GameCube.
+	u32 mem1_offset;
+	u32 mem1_size;
+	u32 mem2_offset;
+	u32 mem2_size;
+};
+
 // Init and Shutdown
 bool IsInitialized();
 void Init();
 void Shutdown();
 void DoState(PointerWrap& p);
+// Called once per emulated frame on the CPU thread
+void UpdateExportedFrameCount();
 
 void Clear();
 bool AreMemoryBreakpointsActivated();
 
+// Maps a page translated by the MMU into the logical view for fastmem, read-only unless
+// writable. UnmapLogicalPages drops every such page with (address & mask) == value.
+void MapLogicalPage(u32 logical_address, u32 physical_address, bool writable);
+void UnmapLogicalPages(u32 mask, u32 value);
+
+// Write tracking for MEM1 through page protection, so the texture cache can tell that a
+// texture has not been written without rehashing it. Needs the fastmem exception handler.
+void SetWriteTrackingEnabled(bool enabled);
+bool IsWriteTrackingEnabled();
+// Write protects the pages of the range and returns the write sequence to check against later,
+// or 0 if the range is not tracked.
+u64 TrackWrites(u32 address, u32 size);
+// True if the range may have been written since TrackWrites returned sequence.
+bool WasWrittenSince(u32 address, u32 size, u64 sequence);
+// Called by the exception handler, returns true if the fault was a write to a tracked page.
+bool HandleWriteTrackingFault(uintptr_t fault_address);
+// While set, a savestate written to the same place as the previous incremental one only copies
+// the MEM1 pages written since then. The caller guarantees that place still holds that state.
+void SetIncrementalSave(bool incremental);
+
 // Routines to access physically addressed memory, designed for use by
 // emulated hardware outside the CPU. Use "Device_" prefix.
 std::string GetString(u32 em_address, size_t size = 0);
 u8* GetPointer(const u32 address);
 void CopyFromEmu(void* data, u32 address, size_t size);
 void CopyToEmu(u32 address, const void* data, size_t size);
+// For tools that look at guest RAM from other threads while the game runs, such as the memory
+// watcher and the GDB stub. Bypasses the MMU, and returns false instead of raising an alert when
+// the range is not in RAM. An aligned read of up to 4 bytes is done in one access, so it never
+// observes a half written value.
+bool TryCopyFromEmu(void* data, u32 address, size_t size);
 void Memset(u32 address, u8 value, size_t size);
 u8 Read_U8(const u32 address);
 u16 Read_U16(const u32 address);
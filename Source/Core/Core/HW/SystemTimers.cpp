@@ -44,6 +44,12 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 */
 
 #include "Core/HW/SystemTimers.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <chrono>
+#include <thread>
+
 #include "Common/Atomic.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -73,6 +79,13 @@ static CoreTiming::EventType* et_IPC_HLE;
 static CoreTiming::EventType* et_PatchEngine;
 static CoreTiming::EventType* et_Throttle;
 
+// Low latency frame pacing emulates every field in one burst, timed to finish just when the
+// field is due, instead of spreading it over the field's duration. Input is polled right at
+// the start of the burst, so the frame that reaches the screen is based on fresher input.
+static u64 s_field_deadline_us;
+static u64 s_field_start_us;
+static u64 s_field_busy_us;
+
 static u32 s_cpu_core_clock = 486000000u;  // 486 mhz (its not 485, stop bugging me!)
 
 // These two are badly educated guesses.
@@ -184,7 +197,15 @@ static void ThrottleCallback(u64 last_time, s64 cyclesLate)
 	const SConfig& config = SConfig::GetInstance();
 	bool frame_limiter = config.m_EmulationSpeed > 0.0f && !Core::GetIsThrottlerTempDisabled();
 	u32 next_event = GetTicksPerSecond() / 1000;
-	if (frame_limiter)
+	if (frame_limiter && config.bLowLatencyFramePacing)
+	{
+		// PaceField does the sleeping. Keep the timebase current so that turning pacing off
+		// doesn't make us skip ahead.
+		if (config.m_EmulationSpeed != 1.0f)
+			next_event = u32(next_event * config.m_EmulationSpeed);
+		last_time = time;
+	}
+	else if (frame_limiter)
 	{
 		if (config.m_EmulationSpeed != 1.0f)
 			next_event = u32(next_event * config.m_EmulationSpeed);
@@ -201,6 +222,46 @@ static void ThrottleCallback(u64 last_time, s64 cyclesLate)
 	CoreTiming::ScheduleEvent(next_event - cyclesLate, et_Throttle, last_time + 1);
 }
 
+void PaceField()
+{
+	const SConfig& config = SConfig::GetInstance();
+	if (!config.bLowLatencyFramePacing || config.m_EmulationSpeed <= 0.0f ||
+		Core::GetIsThrottlerTempDisabled())
+	{
+		s_field_deadline_us = 0;
+		return;
+	}
+
+	const u64 now = Common::Timer::GetTimeUs();
+	const u64 field_us = static_cast<u64>(VideoInterface::GetTicksPerField() * 1000000.0 /
+		(GetTicksPerSecond() * config.m_EmulationSpeed));
+	if (s_field_deadline_us == 0)
+	{
+		s_field_deadline_us = now;
+		s_field_start_us = now;
+	}
+
+	// How long a burst takes decides how late we can start the next one.
+	s_field_busy_us = (s_field_busy_us * 7 + (now - s_field_start_us)) / 8;
+
+	s_field_deadline_us += field_us;
+	const u64 max_fallback_us = static_cast<u64>(config.iTimingVariance) * 1000;
+	if (now > s_field_deadline_us + max_fallback_us)
+	{
+		DEBUG_LOG(COMMON, "field pacing too slow, %" PRIu64 " us skipped",
+			now - s_field_deadline_us);
+		s_field_deadline_us = now;
+	}
+
+	// Leave a millisecond for the host scheduler and for presentation.
+	const u64 lead_us = std::min(s_field_deadline_us, s_field_busy_us + 1000);
+	const u64 wake_us = s_field_deadline_us - lead_us;
+	if (wake_us > now)
+		std::this_thread::sleep_for(std::chrono::microseconds(wake_us - now));
+
+	s_field_start_us = Common::Timer::GetTimeUs();
+}
+
 // split from Init to break a circular dependency between VideoInterface::Init and
 // SystemTimers::Init
 void PreInit()
@@ -248,6 +309,8 @@ void Init()
 	et_IPC_HLE = CoreTiming::RegisterEvent("IPC_HLE_UpdateCallback", IPC_HLE_UpdateCallback);
 	et_PatchEngine = CoreTiming::RegisterEvent("PatchEngine", PatchEngineCallback);
 	et_Throttle = CoreTiming::RegisterEvent("Throttle", ThrottleCallback);
+	s_field_deadline_us = 0;
+	s_field_busy_us = 0;
 
 	CoreTiming::ScheduleEvent(VideoInterface::GetTicksPerHalfLine(), et_VI);
 	CoreTiming::ScheduleEvent(0, et_DSP);
@@ -34,6 +34,8 @@ enum
 };
 
 u32 GetTicksPerSecond();
+// Called when the VI finishes scanning out a field, sleeps there when frame pacing is enabled.
+void PaceField();
 void PreInit();
 void Init();
 void Shutdown();
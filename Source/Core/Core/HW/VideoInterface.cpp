@@ -712,6 +712,7 @@ static void BeginField(FieldType field, u64 ticks)
 
 static void EndField()
 {
+	SystemTimers::PaceField();
 	Core::VideoThrottle();
 }
 
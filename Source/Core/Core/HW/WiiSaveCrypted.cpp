@@ -7,6 +7,7 @@
 // Licensed under the terms of the GNU GPL, version 2
 // http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstddef>
 #include <cstdio>
@@ -14,7 +15,6 @@
 #include <mbedtls/aes.h>
 #include <mbedtls/md5.h>
 #include <mbedtls/sha1.h>
-#include <memory>
 #include <string>
 #include <vector>
 
@@ -100,6 +100,7 @@ void CWiiSaveCrypted::ExportAllSaves()
 CWiiSaveCrypted::CWiiSaveCrypted(const std::string& filename, u64 title_id)
 	: m_encrypted_save_path(filename), m_title_id(title_id)
 {
+	mbedtls_sha1_init(&m_data_sha1);
 	memcpy(m_sd_iv, "\x21\x67\x12\xE6\xAA\x1F\x68\x9F\x95\xC5\xA2\x23\x24\xDC\x6A\x98", 0x10);
 
 	if (!title_id)  // Import
@@ -293,6 +294,9 @@ void CWiiSaveCrypted::WriteBKHDR()
 	m_bk_hdr.totalSize = Common::swap32(m_size_of_files + FULL_CERT_SZ);
 	m_bk_hdr.SaveGameTitle = Common::swap64(m_title_id);
 
+	mbedtls_sha1_starts(&m_data_sha1);
+	mbedtls_sha1_update(&m_data_sha1, reinterpret_cast<const u8*>(&m_bk_hdr), BK_SZ);
+
 	File::IOFile data_file(m_encrypted_save_path, "ab");
 	if (!data_file.WriteBytes(&m_bk_hdr, BK_SZ))
 	{
@@ -317,6 +321,8 @@ void CWiiSaveCrypted::ImportWiiSaveFiles()
 	data_file.Seek(HEADER_SZ + BK_SZ, SEEK_SET);
 
 	FileHDR file_hdr_tmp;
+	std::vector<u8> file_data(STREAM_SZ);
+	std::vector<u8> file_data_enc(STREAM_SZ);
 
 	for (u32 i = 0; i < m_files_list_size; ++i)
 	{
@@ -347,27 +353,32 @@ void CWiiSaveCrypted::ImportWiiSaveFiles()
 			{
 				file_size = Common::swap32(file_hdr_tmp.size);
 				u32 file_size_rounded = Common::AlignUp(file_size, BLOCK_SZ);
-				std::vector<u8> file_data(file_size_rounded);
-				std::vector<u8> file_data_enc(file_size_rounded);
 
-				if (!data_file.ReadBytes(file_data_enc.data(), file_size_rounded))
+				if (File::Exists(file_path_full) &&
+					!AskYesNoT("%s already exists, overwrite?", file_path_full.c_str()))
 				{
-					ERROR_LOG(CONSOLE, "Failed to read data from file %d", i);
-					m_valid = false;
-					break;
+					data_file.Seek(file_size_rounded, SEEK_CUR);
+					continue;
 				}
 
-				memcpy(m_iv, file_hdr_tmp.IV, 0x10);
-				mbedtls_aes_crypt_cbc(&m_aes_ctx, MBEDTLS_AES_DECRYPT, file_size_rounded, m_iv,
-					static_cast<const u8*>(file_data_enc.data()), file_data.data());
+				INFO_LOG(CONSOLE, "Creating file %s", file_path_full.c_str());
+				File::IOFile raw_save_file(file_path_full, "wb");
 
-				if (!File::Exists(file_path_full) ||
-					AskYesNoT("%s already exists, overwrite?", file_path_full.c_str()))
+				// Decrypted in chunks, the IV carries the CBC chain over to the next one
+				memcpy(m_iv, file_hdr_tmp.IV, 0x10);
+				for (u32 offset = 0; offset < file_size_rounded; offset += STREAM_SZ)
 				{
-					INFO_LOG(CONSOLE, "Creating file %s", file_path_full.c_str());
+					const u32 chunk_size = std::min<u32>(file_size_rounded - offset, STREAM_SZ);
+					if (!data_file.ReadBytes(file_data_enc.data(), chunk_size))
+					{
+						ERROR_LOG(CONSOLE, "Failed to read data from file %d", i);
+						m_valid = false;
+						return;
+					}
 
-					File::IOFile raw_save_file(file_path_full, "wb");
-					raw_save_file.WriteBytes(file_data.data(), file_size);
+					mbedtls_aes_crypt_cbc(&m_aes_ctx, MBEDTLS_AES_DECRYPT, chunk_size, m_iv,
+						static_cast<const u8*>(file_data_enc.data()), file_data.data());
+					raw_save_file.WriteBytes(file_data.data(), std::min(file_size - offset, chunk_size));
 				}
 			}
 			else if (file_hdr_tmp.type == 2)
@@ -393,6 +404,10 @@ void CWiiSaveCrypted::ExportWiiSaveFiles()
 	if (!m_valid)
 		return;
 
+	File::IOFile fpData_bin(m_encrypted_save_path, "ab");
+	std::vector<u8> file_data(STREAM_SZ);
+	std::vector<u8> file_data_enc(STREAM_SZ);
+
 	for (u32 i = 0; i < m_files_list_size; i++)
 	{
 		FileHDR file_hdr_tmp;
@@ -426,10 +441,8 @@ void CWiiSaveCrypted::ExportWiiSaveFiles()
 		}
 		strncpy((char*)file_hdr_tmp.name, name.c_str(), sizeof(file_hdr_tmp.name));
 
-		{
-			File::IOFile fpData_bin(m_encrypted_save_path, "ab");
-			fpData_bin.WriteBytes(&file_hdr_tmp, FILE_HDR_SZ);
-		}
+		fpData_bin.WriteBytes(&file_hdr_tmp, FILE_HDR_SZ);
+		mbedtls_sha1_update(&m_data_sha1, reinterpret_cast<const u8*>(&file_hdr_tmp), FILE_HDR_SZ);
 
 		if (file_hdr_tmp.type == 1)
 		{
@@ -444,24 +457,32 @@ void CWiiSaveCrypted::ExportWiiSaveFiles()
 			{
 				ERROR_LOG(CONSOLE, "%s failed to open", m_files_list[i].c_str());
 				m_valid = false;
+				return;
 			}
 
-			std::vector<u8> file_data(file_size_rounded);
-			std::vector<u8> file_data_enc(file_size_rounded);
-
-			if (!raw_save_file.ReadBytes(file_data.data(), file_size))
+			// Encrypted in chunks, the IV carries the CBC chain over to the next one
+			for (u32 offset = 0; offset < file_size_rounded; offset += STREAM_SZ)
 			{
-				ERROR_LOG(CONSOLE, "Failed to read data from file: %s", m_files_list[i].c_str());
-				m_valid = false;
-			}
+				const u32 chunk_size = std::min<u32>(file_size_rounded - offset, STREAM_SZ);
+				const u32 read_size = std::min(file_size - offset, chunk_size);
+				std::fill(file_data.begin() + read_size, file_data.begin() + chunk_size, 0);
+				if (!raw_save_file.ReadBytes(file_data.data(), read_size))
+				{
+					ERROR_LOG(CONSOLE, "Failed to read data from file: %s", m_files_list[i].c_str());
+					m_valid = false;
+					return;
+				}
 
-			mbedtls_aes_crypt_cbc(&m_aes_ctx, MBEDTLS_AES_ENCRYPT, file_size_rounded, file_hdr_tmp.IV,
-				static_cast<const u8*>(file_data.data()), file_data_enc.data());
+				mbedtls_aes_crypt_cbc(&m_aes_ctx, MBEDTLS_AES_ENCRYPT, chunk_size, file_hdr_tmp.IV,
+					static_cast<const u8*>(file_data.data()), file_data_enc.data());
+				mbedtls_sha1_update(&m_data_sha1, file_data_enc.data(), chunk_size);
 
-			File::IOFile fpData_bin(m_encrypted_save_path, "ab");
-			if (!fpData_bin.WriteBytes(file_data_enc.data(), file_size_rounded))
-			{
-				ERROR_LOG(CONSOLE, "Failed to write data to file: %s", m_encrypted_save_path.c_str());
+				if (!fpData_bin.WriteBytes(file_data_enc.data(), chunk_size))
+				{
+					ERROR_LOG(CONSOLE, "Failed to write data to file: %s", m_encrypted_save_path.c_str());
+					m_valid = false;
+					return;
+				}
 			}
 		}
 	}
@@ -479,7 +500,6 @@ void CWiiSaveCrypted::do_sig()
 	u8 ap_sig[60];
 	char signer[64];
 	char name[64];
-	u32 data_size;
 
 	const u32 ng_key_id = 0x6AAB8C59;
 
@@ -510,27 +530,11 @@ void CWiiSaveCrypted::do_sig()
 	generate_ecdsa(ap_sig, ap_sig + 30, ng_priv, hash);
 	make_ec_cert(ap_cert, ap_sig, signer, name, ap_priv, 0);
 
-	data_size = Common::swap32(m_bk_hdr.sizeOfFiles) + 0x80;
-
-	File::IOFile data_file(m_encrypted_save_path, "rb");
-	if (!data_file)
-	{
-		m_valid = false;
-		return;
-	}
-	auto data = std::make_unique<u8[]>(data_size);
-
-	data_file.Seek(0xf0c0, SEEK_SET);
-	if (!data_file.ReadBytes(data.get(), data_size))
-	{
-		m_valid = false;
-		return;
-	}
-
-	mbedtls_sha1(data.get(), data_size, hash);
+	// The backup header and files, hashed during the export
+	mbedtls_sha1_finish(&m_data_sha1, hash);
 	mbedtls_sha1(hash, 20, hash);
 
-	data_file.Open(m_encrypted_save_path, "ab");
+	File::IOFile data_file(m_encrypted_save_path, "ab");
 	if (!data_file)
 	{
 		m_valid = false;
@@ -657,4 +661,5 @@ void CWiiSaveCrypted::ScanForFiles(const std::string& save_directory,
 
 CWiiSaveCrypted::~CWiiSaveCrypted()
 {
+	mbedtls_sha1_free(&m_data_sha1);
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <mbedtls/aes.h>
+#include <mbedtls/sha1.h>
 #include <string>
 #include <vector>
 
@@ -39,6 +40,8 @@ private:
 	static const u32 s_ng_id;
 
 	mbedtls_aes_context m_aes_ctx;
+	// Everything after the header, hashed while it's written for the signature
+	mbedtls_sha1_context m_data_sha1;
 	u8 m_sd_iv[0x10];
 	std::vector<std::string> m_files_list;
 
@@ -68,6 +71,7 @@ private:
 		BK_LISTED_SZ = 0x70,    // Size before rounding to nearest block
 		BK_SZ = 0x80,
 		FILE_HDR_SZ = 0x80,
+		STREAM_SZ = 0x10000,  // File data is encrypted in chunks of this, a multiple of BLOCK_SZ
 
 		SIG_SZ = 0x40,
 		NG_CERT_SZ = 0x180,
@@ -534,51 +534,66 @@ void Wiimote::GetIRData(u8* const data, bool use_accel)
 
 	m_ir->GetState(&xx, &yy, &zz, true);
 
-	Vertex v[4];
-
-	static const int camWidth = 1024;
-	static const int camHeight = 768;
-	static const double bndup = -0.315447;
-	static const double bnddown = 0.85;
-	static const double bndleft = 0.443364;
-	static const double bndright = -0.443364;
-	static const double dist1 = 100.0 / camWidth;  // this seems the optimal distance for zelda
-	static const double dist2 = 1.2 * dist1;
-
-	for (auto& vtx : v)
+	const IRProjection& last = m_ir_projection;
+	if (m_ir_projection_valid && last.x == xx && last.y == yy && last.z == zz && last.sin == ir_sin &&
+		last.cos == ir_cos && last.sensor_bar_on_top == m_sensor_bar_on_top)
 	{
-		vtx.x = xx * (bndright - bndleft) / 2 + (bndleft + bndright) / 2;
-		if (m_sensor_bar_on_top)
-			vtx.y = yy * (bndup - bnddown) / 2 + (bndup + bnddown) / 2;
-		else
-			vtx.y = yy * (bndup - bnddown) / 2 - (bndup + bnddown) / 2;
-		vtx.z = 0;
+		memcpy(x, last.dot_x, sizeof(x));
+		memcpy(y, last.dot_y, sizeof(y));
 	}
+	else
+	{
+		Vertex v[4];
+
+		static const int camWidth = 1024;
+		static const int camHeight = 768;
+		static const double bndup = -0.315447;
+		static const double bnddown = 0.85;
+		static const double bndleft = 0.443364;
+		static const double bndright = -0.443364;
+		static const double dist1 = 100.0 / camWidth;  // this seems the optimal distance for zelda
+		static const double dist2 = 1.2 * dist1;
+
+		for (auto& vtx : v)
+		{
+			vtx.x = xx * (bndright - bndleft) / 2 + (bndleft + bndright) / 2;
+			if (m_sensor_bar_on_top)
+				vtx.y = yy * (bndup - bnddown) / 2 + (bndup + bnddown) / 2;
+			else
+				vtx.y = yy * (bndup - bnddown) / 2 - (bndup + bnddown) / 2;
+			vtx.z = 0;
+		}
 
-	v[0].x -= (zz * 0.5 + 1) * dist1;
-	v[1].x += (zz * 0.5 + 1) * dist1;
-	v[2].x -= (zz * 0.5 + 1) * dist2;
-	v[3].x += (zz * 0.5 + 1) * dist2;
+		v[0].x -= (zz * 0.5 + 1) * dist1;
+		v[1].x += (zz * 0.5 + 1) * dist1;
+		v[2].x -= (zz * 0.5 + 1) * dist2;
+		v[3].x += (zz * 0.5 + 1) * dist2;
 
 #define printmatrix(m)                                                                             \
   PanicAlert("%f %f %f %f\n%f %f %f %f\n%f %f %f %f\n%f %f %f %f\n", m[0][0], m[0][1], m[0][2],    \
              m[0][3], m[1][0], m[1][1], m[1][2], m[1][3], m[2][0], m[2][1], m[2][2], m[2][3],      \
              m[3][0], m[3][1], m[3][2], m[3][3])
-	Matrix rot, tot;
-	static Matrix scale;
-	MatrixScale(scale, 1, camWidth / camHeight, 1);
-	// MatrixIdentity(scale);
-	MatrixRotationByZ(rot, ir_sin, ir_cos);
-	// MatrixIdentity(rot);
-	MatrixMultiply(tot, scale, rot);
-
-	for (int i = 0; i < 4; i++)
-	{
-		MatrixTransformVertex(tot, v[i]);
-		if ((v[i].x < -1) || (v[i].x > 1) || (v[i].y < -1) || (v[i].y > 1))
-			continue;
-		x[i] = (u16)lround((v[i].x + 1) / 2 * (camWidth - 1));
-		y[i] = (u16)lround((v[i].y + 1) / 2 * (camHeight - 1));
+		Matrix rot, tot;
+		static Matrix scale;
+		MatrixScale(scale, 1, camWidth / camHeight, 1);
+		// MatrixIdentity(scale);
+		MatrixRotationByZ(rot, ir_sin, ir_cos);
+		// MatrixIdentity(rot);
+		MatrixMultiply(tot, scale, rot);
+
+		for (int i = 0; i < 4; i++)
+		{
+			MatrixTransformVertex(tot, v[i]);
+			if ((v[i].x < -1) || (v[i].x > 1) || (v[i].y < -1) || (v[i].y > 1))
+				continue;
+			x[i] = (u16)lround((v[i].x + 1) / 2 * (camWidth - 1));
+			y[i] = (u16)lround((v[i].y + 1) / 2 * (camHeight - 1));
+		}
+
+		m_ir_projection = { xx, yy, zz, ir_sin, ir_cos, m_sensor_bar_on_top };
+		memcpy(m_ir_projection.dot_x, x, sizeof(x));
+		memcpy(m_ir_projection.dot_y, y, sizeof(y));
+		m_ir_projection_valid = true;
 	}
 	// PanicAlert("%f %f\n%f %f\n%f %f\n%f %f\n%d %d\n%d %d\n%d %d\n%d %d",
 	//      v[0].x,v[0].y,v[1].x,v[1].y,v[2].x,v[2].y,v[3].x,v[3].y,
@@ -242,6 +242,17 @@ private:
 
 	double ir_sin, ir_cos;  // for the low pass filter
 
+	// The last IR dot projection, reused while the pointer and the filtered tilt stay the same
+	struct IRProjection
+	{
+		ControlState x, y, z;
+		double sin, cos;
+		bool sensor_bar_on_top;
+		u16 dot_x[4], dot_y[4];
+	};
+	IRProjection m_ir_projection;
+	bool m_ir_projection_valid = false;
+
 	bool m_rumble_on;
 	bool m_speaker_mute;
 	bool m_motion_plus_present;
@@ -72,6 +72,15 @@ void Wiimote::WriteReport(Report rpt)
 		if (WM_RUMBLE == rpt[1] && new_rumble_state == m_rumble_state)
 			return;
 
+		// Games keep resending the same LED state. Drop repeats, unless they change rumble or ask
+		// for an acknowledgement the game will wait for.
+		if (WM_LEDS == rpt[1] && !(rpt[2] & 0x2))
+		{
+			if (rpt == m_last_leds_report && new_rumble_state == m_rumble_state)
+				return;
+			m_last_leds_report = rpt;
+		}
+
 		m_rumble_state = new_rumble_state;
 	}
 
@@ -428,6 +437,7 @@ bool Wiimote::PrepareOnThread()
 
 void Wiimote::EmuStart()
 {
+	m_last_leds_report.clear();
 	DisableDataReporting();
 	EnablePowerAssertionInternal();
 }
@@ -435,6 +445,7 @@ void Wiimote::EmuStart()
 void Wiimote::EmuStop()
 {
 	m_channel = 0;
+	m_last_leds_report.clear();
 
 	DisableDataReporting();
 
@@ -624,6 +635,8 @@ void Wiimote::StopThread()
 void Wiimote::ThreadFunc()
 {
 	Common::SetCurrentThreadName("Wiimote Device Thread");
+	if (SConfig::GetInstance().bRaiseThreadPriority)
+		Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
 
 	bool ok = ConnectInternal();
 
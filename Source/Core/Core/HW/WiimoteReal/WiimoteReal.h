@@ -100,6 +100,8 @@ private:
 	void ThreadFunc();
 
 	bool m_rumble_state;
+	// Last LED report sent, to drop identical ones
+	Report m_last_leds_report;
 
 	std::thread m_wiimote_thread;
 	// Whether to keep running the thread.
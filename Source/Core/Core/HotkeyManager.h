@@ -142,6 +142,7 @@ enum Hotkey
 	HK_UNDO_SAVE_STATE,
 	HK_SAVE_STATE_FILE,
 	HK_LOAD_STATE_FILE,
+	HK_REWIND,
 	HK_RELOAD_POSTPROCESS_SHADERS,
 
 	NUM_HOTKEYS,
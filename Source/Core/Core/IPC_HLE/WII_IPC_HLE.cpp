@@ -179,6 +179,7 @@ void Reset(bool hard)
 		device->Close(0, true);
 		device.reset();
 	}
+	HLE_IPC_WaitForHostIO();
 
 	if (hard)
 	{
@@ -3,20 +3,82 @@
 // Refer to the license.txt file included.
 
 #include <cstdio>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
 #include "Common/NandPaths.h"
+#include "Common/ThreadPool.h"
+#include "Core/Core.h"
 #include "Core/HW/Memmap.h"
 #include "Core/IPC_HLE/WII_IPC_HLE.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device_FileIO.h"
 
 static std::map<std::string, std::weak_ptr<File::IOFile>> openFiles;
+// The last reference to a file may be dropped by a queued write
+static std::mutex s_open_files_lock;
+
+static std::mutex s_host_io_lock;
+static std::deque<std::function<void()>> s_host_io_queue;
+static bool s_host_io_running = false;
+static thread_local bool s_on_host_io_thread = false;
+
+static void RunHostIO()
+{
+	s_on_host_io_thread = true;
+	std::unique_lock<std::mutex> lk(s_host_io_lock);
+	while (!s_host_io_queue.empty())
+	{
+		std::function<void()> work = std::move(s_host_io_queue.front());
+		s_host_io_queue.pop_front();
+		lk.unlock();
+		work();
+		// The work may hold the last reference to a file, whose deleter takes the lock
+		work = nullptr;
+		lk.lock();
+	}
+	s_host_io_running = false;
+	s_on_host_io_thread = false;
+}
+
+void HLE_IPC_QueueHostIO(std::function<void()> work)
+{
+	if (Core::g_want_determinism)
+	{
+		HLE_IPC_WaitForHostIO();
+		work();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lk(s_host_io_lock);
+	s_host_io_queue.push_back(std::move(work));
+	if (!s_host_io_running)
+	{
+		s_host_io_running = true;
+		Common::AsyncWorker::ExecuteAsync(RunHostIO);
+	}
+}
+
+void HLE_IPC_WaitForHostIO()
+{
+	size_t count = 0;
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lk(s_host_io_lock);
+			if (!s_host_io_running)
+				return;
+		}
+		Common::cYield(count++);
+	}
+}
 
 // This is used by several of the FileIO and /dev/fs functions
 std::string HLE_IPC_BuildFilename(const std::string& wii_path)
@@ -80,7 +142,7 @@ IPCCommandResult CWII_IPC_HLE_Device_FileIO::Close(u32 _CommandAddress, bool _bF
 	m_Mode = 0;
 
 	// Let go of our pointer to the file, it will automatically close if we are the last handle
-	// accessing it.
+	// accessing it. The close itself is queued behind any pending writes.
 	m_file.reset();
 
 	m_is_active = false;
@@ -89,6 +151,7 @@ IPCCommandResult CWII_IPC_HLE_Device_FileIO::Close(u32 _CommandAddress, bool _bF
 
 IPCCommandResult CWII_IPC_HLE_Device_FileIO::Open(u32 command_address, u32 mode)
 {
+	HLE_IPC_WaitForHostIO();
 	m_Mode = mode;
 
 	static const char* const Modes[] = { "Unk Mode", "Read only", "Write only", "Read and Write" };
@@ -133,19 +196,33 @@ void CWII_IPC_HLE_Device_FileIO::OpenFile()
 	//    - Wii System Menu (Can't access the system settings, gets stuck on blank screen)
 	//    - The Beatles: Rock Band (saving doesn't work)
 
+	// Drop the old file first, its deleter takes the lock below
+	m_file.reset();
+
 	// Check if the file has already been opened.
+	std::lock_guard<std::mutex> lk(s_open_files_lock);
 	auto search = openFiles.find(m_name);
 	if (search != openFiles.end())
-	{
 		m_file = search->second.lock();  // Lock a shared pointer to use.
-	}
-	else
+
+	// The entry can outlive the file until its deleter got to erase it
+	if (!m_file)
 	{
 		std::string path = m_name;
 		// This code will be called when all references to the shared pointer below have been removed.
 		auto deleter = [path](File::IOFile* ptr) {
-			delete ptr;             // IOFile's deconstructor closes the file.
-			openFiles.erase(path);  // erase the weak pointer from the list of open files.
+			{
+				std::lock_guard<std::mutex> files_lk(s_open_files_lock);
+				// Leave the entry alone if the file was opened again in the meantime
+				auto entry = openFiles.find(path);
+				if (entry != openFiles.end() && entry->second.expired())
+					openFiles.erase(entry);  // erase the weak pointer from the list of open files.
+			}
+			// IOFile's deconstructor closes the file.
+			if (s_on_host_io_thread)
+				delete ptr;
+			else
+				HLE_IPC_QueueHostIO([ptr] { delete ptr; });
 		};
 
 		// All files are opened read/write. Actual access rights will be controlled per handle by the
@@ -160,6 +237,7 @@ void CWII_IPC_HLE_Device_FileIO::OpenFile()
 
 IPCCommandResult CWII_IPC_HLE_Device_FileIO::Seek(u32 _CommandAddress)
 {
+	HLE_IPC_WaitForHostIO();
 	u32 ReturnValue = FS_EINVAL;
 	const s32 SeekPosition = Memory::Read_U32(_CommandAddress + 0xC);
 	const s32 Mode = Memory::Read_U32(_CommandAddress + 0x10);
@@ -225,6 +303,7 @@ IPCCommandResult CWII_IPC_HLE_Device_FileIO::Seek(u32 _CommandAddress)
 
 IPCCommandResult CWII_IPC_HLE_Device_FileIO::Read(u32 _CommandAddress)
 {
+	HLE_IPC_WaitForHostIO();
 	u32 ReturnValue = FS_EACCESS;
 	const u32 Address = Memory::Read_U32(_CommandAddress + 0xC);  // Read to this memory address
 	const u32 Size = Memory::Read_U32(_CommandAddress + 0x10);
@@ -284,10 +363,32 @@ IPCCommandResult CWII_IPC_HLE_Device_FileIO::Write(u32 _CommandAddress)
 		{
 			DEBUG_LOG(WII_IPC_FILEIO, "FileIO: Write 0x%04x bytes from 0x%08x to %s", Size, Address,
 				m_name.c_str());
-			m_file->Seek(m_SeekPos,
-				SEEK_SET);  // File might be opened twice, need to seek before we write
-			if (m_file->WriteBytes(Memory::GetPointer(Address), Size))
+			if (Core::g_want_determinism)
+			{
+				HLE_IPC_WaitForHostIO();
+				m_file->Seek(m_SeekPos,
+					SEEK_SET);  // File might be opened twice, need to seek before we write
+				if (m_file->WriteBytes(Memory::GetPointer(Address), Size))
+				{
+					ReturnValue = Size;
+					m_SeekPos += Size;
+				}
+			}
+			else
 			{
+				// The write is reported as done right away, like a write-back cache.
+				// A host failure is only logged, the game has moved on by then.
+				std::vector<u8> data(Size);
+				Memory::CopyFromEmu(data.data(), Address, Size);
+				std::shared_ptr<File::IOFile> file = m_file;
+				const u32 position = m_SeekPos;
+				const std::string name = m_name;
+				HLE_IPC_QueueHostIO([file, position, data, name] {
+					file->Seek(position, SEEK_SET);
+					if (!file->WriteBytes(data.data(), data.size()))
+						ERROR_LOG(WII_IPC_FILEIO, "FileIO: Failed to write 0x%zx bytes to %s", data.size(),
+							name.c_str());
+				});
 				ReturnValue = Size;
 				m_SeekPos += Size;
 			}
@@ -313,6 +414,7 @@ IPCCommandResult CWII_IPC_HLE_Device_FileIO::IOCtl(u32 _CommandAddress)
 #endif
 	const u32 Parameter = Memory::Read_U32(_CommandAddress + 0xC);
 	u32 ReturnValue = 0;
+	HLE_IPC_WaitForHostIO();
 
 	switch (Parameter)
 	{
@@ -353,6 +455,7 @@ void CWII_IPC_HLE_Device_FileIO::PrepareForState(PointerWrap::Mode mode)
 	// Temporally close the file, to prevent any issues with the savestating of /tmp
 	// it can be opened again with another call to OpenFile()
 	m_file.reset();
+	HLE_IPC_WaitForHostIO();
 }
 
 void CWII_IPC_HLE_Device_FileIO::DoState(PointerWrap& p)
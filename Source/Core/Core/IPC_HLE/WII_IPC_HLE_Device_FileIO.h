@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include "Common/ChunkFile.h"
@@ -21,6 +22,13 @@ class IOFile;
 std::string HLE_IPC_BuildFilename(const std::string& wii_path);
 void HLE_IPC_CreateVirtualFATFilesystem();
 
+// Host writes and closes of NAND files run in order on the thread pool, so
+// slow host storage doesn't stall the CPU thread. Every other NAND access
+// must wait for them first, which keeps all file system operations strongly
+// ordered, as on the Wii. Runs the work right away when determinism is wanted.
+void HLE_IPC_QueueHostIO(std::function<void()> work);
+void HLE_IPC_WaitForHostIO();
+
 class CWII_IPC_HLE_Device_FileIO : public IWII_IPC_HLE_Device
 {
 public:
@@ -45,6 +45,8 @@ IPCCommandResult CWII_IPC_HLE_Device_fs::GetFSReply() const
 
 IPCCommandResult CWII_IPC_HLE_Device_fs::Open(u32 _CommandAddress, u32 _Mode)
 {
+	HLE_IPC_WaitForHostIO();
+
 	// clear tmp folder
 	{
 		std::string Path = HLE_IPC_BuildFilename("/tmp");
@@ -73,6 +75,8 @@ static u64 ComputeTotalFileSize(const File::FSTEntry& parentEntry)
 
 IPCCommandResult CWII_IPC_HLE_Device_fs::IOCtlV(u32 _CommandAddress)
 {
+	HLE_IPC_WaitForHostIO();
+
 	u32 ReturnValue = IPC_SUCCESS;
 	SIOCtlVBuffer CommandBuffer(_CommandAddress);
 
@@ -243,6 +247,8 @@ IPCCommandResult CWII_IPC_HLE_Device_fs::IOCtlV(u32 _CommandAddress)
 
 IPCCommandResult CWII_IPC_HLE_Device_fs::IOCtl(u32 _CommandAddress)
 {
+	HLE_IPC_WaitForHostIO();
+
 	// u32 DeviceID = Memory::Read_U32(_CommandAddress + 8);
 
 	u32 Parameter = Memory::Read_U32(_CommandAddress + 0xC);
@@ -573,6 +579,7 @@ s32 CWII_IPC_HLE_Device_fs::ExecuteCommand(u32 _Parameter, u32 _BufferIn, u32 _B
 
 void CWII_IPC_HLE_Device_fs::DoState(PointerWrap& p)
 {
+	HLE_IPC_WaitForHostIO();
 	DoStateShared(p);
 
 	// handle /tmp
@@ -26,6 +26,7 @@
 #include "Common/Network.h"
 #include "Common/SettingsHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/IPC_HLE/ICMP.h"
@@ -526,6 +527,16 @@ CWII_IPC_HLE_Device_net_ip_top::CWII_IPC_HLE_Device_net_ip_top(u32 _DeviceID,
 
 CWII_IPC_HLE_Device_net_ip_top::~CWII_IPC_HLE_Device_net_ip_top()
 {
+	if (m_lookup_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lk(m_lookup_mutex);
+			m_lookup_thread_shutdown = true;
+		}
+		m_lookup_cv.notify_one();
+		m_lookup_thread.join();
+	}
+
 #ifdef _WIN32
 	WSACleanup();
 #endif
@@ -884,27 +895,17 @@ IPCCommandResult CWII_IPC_HLE_Device_net_ip_top::IOCtl(u32 _CommandAddress)
 
 	case IOCTL_SO_INETATON:
 	{
-		std::string hostname = Memory::GetString(BufferIn);
-		struct hostent* remoteHost = gethostbyname(hostname.c_str());
-
-		if (remoteHost == nullptr || remoteHost->h_addr_list == nullptr ||
-			remoteHost->h_addr_list[0] == nullptr)
-		{
-			INFO_LOG(WII_IPC_NET, "IOCTL_SO_INETATON = -1 "
-				"%s, BufferIn: (%08x, %i), BufferOut: (%08x, %i), IP Found: None",
-				hostname.c_str(), BufferIn, BufferInSize, BufferOut, BufferOutSize);
-			ReturnValue = 0;
-		}
-		else
-		{
-			Memory::Write_U32(Common::swap32(*(u32*)remoteHost->h_addr_list[0]), BufferOut);
-			INFO_LOG(WII_IPC_NET, "IOCTL_SO_INETATON = 0 "
-				"%s, BufferIn: (%08x, %i), BufferOut: (%08x, %i), IP Found: %08X",
-				hostname.c_str(), BufferIn, BufferInSize, BufferOut, BufferOutSize,
-				Common::swap32(*(u32*)remoteHost->h_addr_list[0]));
-			ReturnValue = 1;
-		}
-		break;
+		HostLookup lookup;
+		lookup.type = LOOKUP_INETATON;
+		lookup.command_address = _CommandAddress;
+		lookup.buffer_out = BufferOut;
+		lookup.buffer_out_size = BufferOutSize;
+		lookup.node_name = Memory::GetString(BufferIn);
+		DEBUG_LOG(WII_IPC_NET, "IOCTL_SO_INETATON "
+			"%s, BufferIn: (%08x, %i), BufferOut: (%08x, %i)",
+			lookup.node_name.c_str(), BufferIn, BufferInSize, BufferOut, BufferOutSize);
+		QueueHostLookup(std::move(lookup));
+		return GetNoReply();
 	}
 
 	case IOCTL_SO_INETPTON:
@@ -1014,89 +1015,17 @@ IPCCommandResult CWII_IPC_HLE_Device_net_ip_top::IOCtl(u32 _CommandAddress)
 			break;
 		}
 
-		std::string hostname = Memory::GetString(BufferIn);
-		hostent* remoteHost = gethostbyname(hostname.c_str());
-
+		HostLookup lookup;
+		lookup.type = LOOKUP_GETHOSTBYNAME;
+		lookup.command_address = _CommandAddress;
+		lookup.buffer_out = BufferOut;
+		lookup.buffer_out_size = BufferOutSize;
+		lookup.node_name = Memory::GetString(BufferIn);
 		INFO_LOG(WII_IPC_NET, "IOCTL_SO_GETHOSTBYNAME "
 			"Address: %s, BufferIn: (%08x, %i), BufferOut: (%08x, %i)",
-			hostname.c_str(), BufferIn, BufferInSize, BufferOut, BufferOutSize);
-
-		if (remoteHost)
-		{
-			for (int i = 0; remoteHost->h_aliases[i]; ++i)
-			{
-				DEBUG_LOG(WII_IPC_NET, "alias%i:%s", i, remoteHost->h_aliases[i]);
-			}
-
-			for (int i = 0; remoteHost->h_addr_list[i]; ++i)
-			{
-				u32 ip = Common::swap32(*(u32*)(remoteHost->h_addr_list[i]));
-				std::string ip_s = StringFromFormat("%i.%i.%i.%i", ip >> 24, (ip >> 16) & 0xff,
-					(ip >> 8) & 0xff, ip & 0xff);
-				DEBUG_LOG(WII_IPC_NET, "addr%i:%s", i, ip_s.c_str());
-			}
-
-			Memory::Memset(BufferOut, 0, BufferOutSize);
-
-			// Host name; located immediately after struct
-			static const u32 GETHOSTBYNAME_STRUCT_SIZE = 0x10;
-			static const u32 GETHOSTBYNAME_IP_LIST_OFFSET = 0x110;
-			// Limit host name length to avoid buffer overflow.
-			u32 name_length = (u32)strlen(remoteHost->h_name) + 1;
-			if (name_length > (GETHOSTBYNAME_IP_LIST_OFFSET - GETHOSTBYNAME_STRUCT_SIZE))
-			{
-				ERROR_LOG(WII_IPC_NET, "Hostname too long in IOCTL_SO_GETHOSTBYNAME");
-				ReturnValue = -1;
-				break;
-			}
-			Memory::CopyToEmu(BufferOut + GETHOSTBYNAME_STRUCT_SIZE, remoteHost->h_name, name_length);
-			Memory::Write_U32(BufferOut + GETHOSTBYNAME_STRUCT_SIZE, BufferOut);
-
-			// IP address list; located at offset 0x110.
-			u32 num_ip_addr = 0;
-			while (remoteHost->h_addr_list[num_ip_addr])
-				num_ip_addr++;
-			// Limit number of IP addresses to avoid buffer overflow.
-			// (0x460 - 0x340) / sizeof(pointer) == 72
-			static const u32 GETHOSTBYNAME_MAX_ADDRESSES = 71;
-			num_ip_addr = std::min(num_ip_addr, GETHOSTBYNAME_MAX_ADDRESSES);
-			for (u32 i = 0; i < num_ip_addr; ++i)
-			{
-				u32 addr = BufferOut + GETHOSTBYNAME_IP_LIST_OFFSET + i * 4;
-				Memory::Write_U32_Swap(*(u32*)(remoteHost->h_addr_list[i]), addr);
-			}
-
-			// List of pointers to IP addresses; located at offset 0x340.
-			// This must be exact: PPC code to convert the struct hardcodes
-			// this offset.
-			static const u32 GETHOSTBYNAME_IP_PTR_LIST_OFFSET = 0x340;
-			Memory::Write_U32(BufferOut + GETHOSTBYNAME_IP_PTR_LIST_OFFSET, BufferOut + 12);
-			for (u32 i = 0; i < num_ip_addr; ++i)
-			{
-				u32 addr = BufferOut + GETHOSTBYNAME_IP_PTR_LIST_OFFSET + i * 4;
-				Memory::Write_U32(BufferOut + GETHOSTBYNAME_IP_LIST_OFFSET + i * 4, addr);
-			}
-			Memory::Write_U32(0, BufferOut + GETHOSTBYNAME_IP_PTR_LIST_OFFSET + num_ip_addr * 4);
-
-			// Aliases - empty. (Hardware doesn't return anything.)
-			Memory::Write_U32(BufferOut + GETHOSTBYNAME_IP_PTR_LIST_OFFSET + num_ip_addr * 4,
-				BufferOut + 4);
-
-			// Returned struct must be ipv4.
-			_assert_msg_(WII_IPC_NET,
-				remoteHost->h_addrtype == AF_INET && remoteHost->h_length == sizeof(u32),
-				"returned host info is not IPv4");
-			Memory::Write_U16(AF_INET, BufferOut + 8);
-			Memory::Write_U16(sizeof(u32), BufferOut + 10);
-
-			ReturnValue = 0;
-		}
-		else
-		{
-			ReturnValue = -1;
-		}
-
-		break;
+			lookup.node_name.c_str(), BufferIn, BufferInSize, BufferOut, BufferOutSize);
+		QueueHostLookup(std::move(lookup));
+		return GetNoReply();
 	}
 
 	case IOCTL_SO_ICMPCANCEL:
@@ -1310,96 +1239,33 @@ IPCCommandResult CWII_IPC_HLE_Device_net_ip_top::IOCtlV(u32 CommandAddress)
 	}
 	case IOCTLV_SO_GETADDRINFO:
 	{
-		addrinfo hints;
+		HostLookup lookup;
+		lookup.type = LOOKUP_GETADDRINFO;
+		lookup.command_address = CommandAddress;
+		lookup.buffer_out = _BufferOut;
+		lookup.buffer_out_size = BufferOutSize;
 
 		if (BufferInSize3)
 		{
-			hints.ai_flags = Memory::Read_U32(_BufferIn3);
-			hints.ai_family = Memory::Read_U32(_BufferIn3 + 0x4);
-			hints.ai_socktype = Memory::Read_U32(_BufferIn3 + 0x8);
-			hints.ai_protocol = Memory::Read_U32(_BufferIn3 + 0xC);
-			hints.ai_addrlen = Memory::Read_U32(_BufferIn3 + 0x10);
-			hints.ai_canonname = nullptr;
-			hints.ai_addr = nullptr;
-			hints.ai_next = nullptr;
+			lookup.has_hints = true;
+			for (u32 i = 0; i < 5; ++i)
+				lookup.hints[i] = Memory::Read_U32(_BufferIn3 + i * 4);
 		}
 
 		// getaddrinfo allows a null pointer for the nodeName or serviceName strings
-		// So we have to do a bit of juggling here.
-		std::string nodeNameStr;
-		const char* pNodeName = nullptr;
-		if (BufferInSize > 0)
-		{
-			nodeNameStr = Memory::GetString(_BufferIn, BufferInSize);
-			pNodeName = nodeNameStr.c_str();
-		}
-
-		std::string serviceNameStr;
-		const char* pServiceName = nullptr;
-		if (BufferInSize2 > 0)
-		{
-			serviceNameStr = Memory::GetString(_BufferIn2, BufferInSize2);
-			pServiceName = serviceNameStr.c_str();
-		}
-
-		addrinfo* result = nullptr;
-		int ret = getaddrinfo(pNodeName, pServiceName, BufferInSize3 ? &hints : nullptr, &result);
-		u32 addr = _BufferOut;
-		u32 sockoffset = addr + 0x460;
-		if (ret == 0)
-		{
-			for (addrinfo* result_iter = result; result_iter != nullptr;
-				result_iter = result_iter->ai_next)
-			{
-				Memory::Write_U32(result_iter->ai_flags, addr);
-				Memory::Write_U32(result_iter->ai_family, addr + 0x04);
-				Memory::Write_U32(result_iter->ai_socktype, addr + 0x08);
-				Memory::Write_U32(result_iter->ai_protocol, addr + 0x0C);
-				Memory::Write_U32((u32)result_iter->ai_addrlen, addr + 0x10);
-				// what to do? where to put? the buffer of 0x834 doesn't allow space for this
-				Memory::Write_U32(/*result->ai_cannonname*/ 0, addr + 0x14);
-
-				if (result_iter->ai_addr)
-				{
-					Memory::Write_U32(sockoffset, addr + 0x18);
-					Memory::Write_U16(((result_iter->ai_addr->sa_family & 0xFF) << 8) |
-						(result_iter->ai_addrlen & 0xFF),
-						sockoffset);
-					Memory::CopyToEmu(sockoffset + 0x2, result_iter->ai_addr->sa_data,
-						sizeof(result_iter->ai_addr->sa_data));
-					sockoffset += 0x1C;
-				}
-				else
-				{
-					Memory::Write_U32(0, addr + 0x18);
-				}
-
-				if (result_iter->ai_next)
-				{
-					Memory::Write_U32(addr + sizeof(addrinfo), addr + 0x1C);
-				}
-				else
-				{
-					Memory::Write_U32(0, addr + 0x1C);
-				}
-
-				addr += sizeof(addrinfo);
-			}
-
-			freeaddrinfo(result);
-		}
-		else
-		{
-			// Host not found
-			ret = -305;
-		}
+		lookup.has_node_name = BufferInSize > 0;
+		if (lookup.has_node_name)
+			lookup.node_name = Memory::GetString(_BufferIn, BufferInSize);
+		lookup.has_service_name = BufferInSize2 > 0;
+		if (lookup.has_service_name)
+			lookup.service_name = Memory::GetString(_BufferIn2, BufferInSize2);
 
 		INFO_LOG(WII_IPC_NET, "IOCTLV_SO_GETADDRINFO "
 			"(BufferIn: (%08x, %i), BufferOut: (%08x, %i)",
 			_BufferIn, BufferInSize, _BufferOut, BufferOutSize);
 		INFO_LOG(WII_IPC_NET, "IOCTLV_SO_GETADDRINFO: %s", Memory::GetString(_BufferIn).c_str());
-		ReturnValue = ret;
-		break;
+		QueueHostLookup(std::move(lookup));
+		return GetNoReply();
 	}
 	case IOCTLV_SO_ICMPPING:
 	{
@@ -1492,4 +1358,258 @@ IPCCommandResult CWII_IPC_HLE_Device_net_ip_top::IOCtlV(u32 CommandAddress)
 void CWII_IPC_HLE_Device_net_ip_top::Update()
 {
 	WiiSockMan::GetInstance().Update();
+
+	if (!m_lookups_completed.load(std::memory_order_acquire))
+		return;
+
+	std::vector<HostLookup> completed;
+	{
+		std::lock_guard<std::mutex> lk(m_lookup_mutex);
+		completed.swap(m_completed_lookups);
+		m_lookups_completed.store(false, std::memory_order_relaxed);
+	}
+	for (const HostLookup& lookup : completed)
+		CompleteHostLookup(lookup);
+}
+
+void CWII_IPC_HLE_Device_net_ip_top::QueueHostLookup(HostLookup lookup)
+{
+	std::lock_guard<std::mutex> lk(m_lookup_mutex);
+	if (!m_lookup_thread.joinable())
+	{
+		m_lookup_thread_shutdown = false;
+		m_lookup_thread = std::thread(&CWII_IPC_HLE_Device_net_ip_top::HostLookupThread, this);
+	}
+	m_pending_lookups.push_back(std::move(lookup));
+	m_lookup_cv.notify_one();
+}
+
+void CWII_IPC_HLE_Device_net_ip_top::HostLookupThread()
+{
+	Common::SetCurrentThreadName("IOS Net Resolver");
+
+	std::unique_lock<std::mutex> lk(m_lookup_mutex);
+	while (true)
+	{
+		m_lookup_cv.wait(lk, [this] { return m_lookup_thread_shutdown || !m_pending_lookups.empty(); });
+		if (m_lookup_thread_shutdown)
+			return;
+
+		HostLookup lookup = std::move(m_pending_lookups.front());
+		m_pending_lookups.pop_front();
+
+		lk.unlock();
+		ResolveHostLookup(lookup);
+		lk.lock();
+
+		m_completed_lookups.push_back(std::move(lookup));
+		m_lookups_completed.store(true, std::memory_order_release);
+	}
+}
+
+// Runs on the resolver thread and must not touch emulated memory.
+void CWII_IPC_HLE_Device_net_ip_top::ResolveHostLookup(HostLookup& lookup)
+{
+	if (lookup.type == LOOKUP_GETADDRINFO)
+	{
+		addrinfo hints = {};
+		if (lookup.has_hints)
+		{
+			hints.ai_flags = lookup.hints[0];
+			hints.ai_family = lookup.hints[1];
+			hints.ai_socktype = lookup.hints[2];
+			hints.ai_protocol = lookup.hints[3];
+			hints.ai_addrlen = lookup.hints[4];
+		}
+
+		addrinfo* result = nullptr;
+		lookup.result = getaddrinfo(lookup.has_node_name ? lookup.node_name.c_str() : nullptr,
+			lookup.has_service_name ? lookup.service_name.c_str() : nullptr,
+			lookup.has_hints ? &hints : nullptr, &result);
+		if (lookup.result != 0)
+			return;
+
+		for (addrinfo* result_iter = result; result_iter != nullptr; result_iter = result_iter->ai_next)
+		{
+			AddrInfoEntry entry = {};
+			entry.flags = result_iter->ai_flags;
+			entry.family = result_iter->ai_family;
+			entry.socktype = result_iter->ai_socktype;
+			entry.protocol = result_iter->ai_protocol;
+			entry.addrlen = (u32)result_iter->ai_addrlen;
+			entry.has_addr = result_iter->ai_addr != nullptr;
+			if (entry.has_addr)
+			{
+				entry.sa_family = result_iter->ai_addr->sa_family;
+				memcpy(entry.sa_data, result_iter->ai_addr->sa_data, sizeof(entry.sa_data));
+			}
+			lookup.addr_info.push_back(entry);
+		}
+		freeaddrinfo(result);
+		return;
+	}
+
+	// gethostbyname returns static storage, so everything needed is copied out here.
+	hostent* remoteHost = gethostbyname(lookup.node_name.c_str());
+	if (remoteHost == nullptr)
+	{
+		lookup.result = -1;
+		return;
+	}
+
+	lookup.result = 0;
+	lookup.host_name = remoteHost->h_name;
+	lookup.addr_type = remoteHost->h_addrtype;
+	lookup.addr_length = remoteHost->h_length;
+	for (int i = 0; remoteHost->h_addr_list && remoteHost->h_addr_list[i]; ++i)
+		lookup.addresses.push_back(*(u32*)(remoteHost->h_addr_list[i]));
+}
+
+void CWII_IPC_HLE_Device_net_ip_top::CompleteHostLookup(const HostLookup& lookup)
+{
+	const u32 BufferOut = lookup.buffer_out;
+	const u32 BufferOutSize = lookup.buffer_out_size;
+	s32 ReturnValue = 0;
+
+	switch (lookup.type)
+	{
+	case LOOKUP_INETATON:
+	{
+		if (lookup.result != 0 || lookup.addresses.empty())
+		{
+			INFO_LOG(WII_IPC_NET, "IOCTL_SO_INETATON = -1 %s, IP Found: None",
+				lookup.node_name.c_str());
+			ReturnValue = 0;
+		}
+		else
+		{
+			Memory::Write_U32(Common::swap32(lookup.addresses[0]), BufferOut);
+			INFO_LOG(WII_IPC_NET, "IOCTL_SO_INETATON = 0 %s, IP Found: %08X", lookup.node_name.c_str(),
+				Common::swap32(lookup.addresses[0]));
+			ReturnValue = 1;
+		}
+		break;
+	}
+
+	case LOOKUP_GETHOSTBYNAME:
+	{
+		if (lookup.result != 0)
+		{
+			ReturnValue = -1;
+			break;
+		}
+
+		for (size_t i = 0; i < lookup.addresses.size(); ++i)
+		{
+			u32 ip = Common::swap32(lookup.addresses[i]);
+			std::string ip_s = StringFromFormat("%i.%i.%i.%i", ip >> 24, (ip >> 16) & 0xff,
+				(ip >> 8) & 0xff, ip & 0xff);
+			DEBUG_LOG(WII_IPC_NET, "addr%i:%s", (int)i, ip_s.c_str());
+		}
+
+		Memory::Memset(BufferOut, 0, BufferOutSize);
+
+		// Host name; located immediately after struct
+		static const u32 GETHOSTBYNAME_STRUCT_SIZE = 0x10;
+		static const u32 GETHOSTBYNAME_IP_LIST_OFFSET = 0x110;
+		// Limit host name length to avoid buffer overflow.
+		u32 name_length = (u32)lookup.host_name.size() + 1;
+		if (name_length > (GETHOSTBYNAME_IP_LIST_OFFSET - GETHOSTBYNAME_STRUCT_SIZE))
+		{
+			ERROR_LOG(WII_IPC_NET, "Hostname too long in IOCTL_SO_GETHOSTBYNAME");
+			ReturnValue = -1;
+			break;
+		}
+		Memory::CopyToEmu(BufferOut + GETHOSTBYNAME_STRUCT_SIZE, lookup.host_name.c_str(), name_length);
+		Memory::Write_U32(BufferOut + GETHOSTBYNAME_STRUCT_SIZE, BufferOut);
+
+		// IP address list; located at offset 0x110.
+		// Limit number of IP addresses to avoid buffer overflow.
+		// (0x460 - 0x340) / sizeof(pointer) == 72
+		static const u32 GETHOSTBYNAME_MAX_ADDRESSES = 71;
+		u32 num_ip_addr = std::min((u32)lookup.addresses.size(), GETHOSTBYNAME_MAX_ADDRESSES);
+		for (u32 i = 0; i < num_ip_addr; ++i)
+		{
+			u32 addr = BufferOut + GETHOSTBYNAME_IP_LIST_OFFSET + i * 4;
+			Memory::Write_U32_Swap(lookup.addresses[i], addr);
+		}
+
+		// List of pointers to IP addresses; located at offset 0x340.
+		// This must be exact: PPC code to convert the struct hardcodes
+		// this offset.
+		static const u32 GETHOSTBYNAME_IP_PTR_LIST_OFFSET = 0x340;
+		Memory::Write_U32(BufferOut + GETHOSTBYNAME_IP_PTR_LIST_OFFSET, BufferOut + 12);
+		for (u32 i = 0; i < num_ip_addr; ++i)
+		{
+			u32 addr = BufferOut + GETHOSTBYNAME_IP_PTR_LIST_OFFSET + i * 4;
+			Memory::Write_U32(BufferOut + GETHOSTBYNAME_IP_LIST_OFFSET + i * 4, addr);
+		}
+		Memory::Write_U32(0, BufferOut + GETHOSTBYNAME_IP_PTR_LIST_OFFSET + num_ip_addr * 4);
+
+		// Aliases - empty. (Hardware doesn't return anything.)
+		Memory::Write_U32(BufferOut + GETHOSTBYNAME_IP_PTR_LIST_OFFSET + num_ip_addr * 4,
+			BufferOut + 4);
+
+		// Returned struct must be ipv4.
+		_assert_msg_(WII_IPC_NET, lookup.addr_type == AF_INET && lookup.addr_length == sizeof(u32),
+			"returned host info is not IPv4");
+		Memory::Write_U16(AF_INET, BufferOut + 8);
+		Memory::Write_U16(sizeof(u32), BufferOut + 10);
+
+		ReturnValue = 0;
+		break;
+	}
+
+	case LOOKUP_GETADDRINFO:
+	{
+		if (lookup.result != 0)
+		{
+			// Host not found
+			ReturnValue = -305;
+			break;
+		}
+
+		u32 addr = BufferOut;
+		u32 sockoffset = addr + 0x460;
+		for (size_t i = 0; i < lookup.addr_info.size(); ++i)
+		{
+			const AddrInfoEntry& entry = lookup.addr_info[i];
+			Memory::Write_U32(entry.flags, addr);
+			Memory::Write_U32(entry.family, addr + 0x04);
+			Memory::Write_U32(entry.socktype, addr + 0x08);
+			Memory::Write_U32(entry.protocol, addr + 0x0C);
+			Memory::Write_U32(entry.addrlen, addr + 0x10);
+			// what to do? where to put? the buffer of 0x834 doesn't allow space for this
+			Memory::Write_U32(/*result->ai_cannonname*/ 0, addr + 0x14);
+
+			if (entry.has_addr)
+			{
+				Memory::Write_U32(sockoffset, addr + 0x18);
+				Memory::Write_U16(((entry.sa_family & 0xFF) << 8) | (entry.addrlen & 0xFF), sockoffset);
+				Memory::CopyToEmu(sockoffset + 0x2, entry.sa_data, sizeof(entry.sa_data));
+				sockoffset += 0x1C;
+			}
+			else
+			{
+				Memory::Write_U32(0, addr + 0x18);
+			}
+
+			if (i + 1 < lookup.addr_info.size())
+			{
+				Memory::Write_U32(addr + sizeof(addrinfo), addr + 0x1C);
+			}
+			else
+			{
+				Memory::Write_U32(0, addr + 0x1C);
+			}
+
+			addr += sizeof(addrinfo);
+		}
+		ReturnValue = 0;
+		break;
+	}
+	}
+
+	Memory::Write_U32(ReturnValue, lookup.command_address + 4);
+	WII_IPC_HLE_Interface::EnqueueReply(lookup.command_address);
 }
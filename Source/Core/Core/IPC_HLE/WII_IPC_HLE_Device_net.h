@@ -4,7 +4,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -213,6 +219,63 @@ public:
 	void Update() override;
 
 private:
+	// Host name lookups can block for seconds, so they are resolved on a worker thread and
+	// answered from Update() once the host resolver has returned.
+	enum LookupType
+	{
+		LOOKUP_INETATON,
+		LOOKUP_GETHOSTBYNAME,
+		LOOKUP_GETADDRINFO,
+	};
+
+	struct AddrInfoEntry
+	{
+		s32 flags;
+		s32 family;
+		s32 socktype;
+		s32 protocol;
+		u32 addrlen;
+		bool has_addr;
+		u16 sa_family;
+		u8 sa_data[14];
+	};
+
+	struct HostLookup
+	{
+		LookupType type;
+		u32 command_address;
+		u32 buffer_out;
+		u32 buffer_out_size;
+
+		std::string node_name;
+		std::string service_name;
+		bool has_node_name = true;
+		bool has_service_name = false;
+		bool has_hints = false;
+		s32 hints[5] = {};  // flags, family, socktype, protocol, addrlen
+
+		// Filled in by the worker thread
+		s32 result = -1;
+		std::string host_name;
+		u16 addr_type = 0;
+		u16 addr_length = 0;
+		std::vector<u32> addresses;  // in network byte order
+		std::vector<AddrInfoEntry> addr_info;
+	};
+
+	void QueueHostLookup(HostLookup lookup);
+	void HostLookupThread();
+	static void ResolveHostLookup(HostLookup& lookup);
+	static void CompleteHostLookup(const HostLookup& lookup);
+
+	std::thread m_lookup_thread;
+	std::mutex m_lookup_mutex;
+	std::condition_variable m_lookup_cv;
+	std::deque<HostLookup> m_pending_lookups;
+	std::vector<HostLookup> m_completed_lookups;
+	std::atomic<bool> m_lookups_completed{false};
+	bool m_lookup_thread_shutdown = false;
+
 #ifdef _WIN32
 	WSADATA InitData;
 #endif
@@ -853,6 +853,14 @@ bool CWII_IPC_HLE_Device_usb_oh1_57e_305_emu::SendEventRoleChange(bdaddr_t _bd,
 
 bool CWII_IPC_HLE_Device_usb_oh1_57e_305_emu::SendEventNumberOfCompletedPackets()
 {
+	// This runs on every Update, and most of the time nothing was sent since the last one.
+	// Don't build (and clear) a whole event buffer for that.
+	if (std::none_of(m_PacketCount, m_PacketCount + m_WiiMotes.size(), [](u32 count) { return count != 0; }))
+	{
+		DEBUG_LOG(WII_IPC_WIIMOTE, "SendEventNumberOfCompletedPackets: no packets; no event");
+		return true;
+	}
+
 	SQueuedEvent Event((u32)(sizeof(hci_event_hdr_t) + sizeof(hci_num_compl_pkts_ep) +
 		(sizeof(hci_num_compl_pkts_info) * m_WiiMotes.size())),
 		0);
@@ -868,8 +876,6 @@ bool CWII_IPC_HLE_Device_usb_oh1_57e_305_emu::SendEventNumberOfCompletedPackets(
 	event_hdr->length = sizeof(hci_num_compl_pkts_ep);
 	event->num_con_handles = 0;
 
-	u32 acc = 0;
-
 	for (unsigned int i = 0; i < m_WiiMotes.size(); i++)
 	{
 		event_hdr->length += sizeof(hci_num_compl_pkts_info);
@@ -880,19 +886,11 @@ bool CWII_IPC_HLE_Device_usb_oh1_57e_305_emu::SendEventNumberOfCompletedPackets(
 		DEBUG_LOG(WII_IPC_WIIMOTE, "  Connection_Handle: 0x%04x", info->con_handle);
 		DEBUG_LOG(WII_IPC_WIIMOTE, "  Number_Of_Completed_Packets: %i", info->compl_pkts);
 
-		acc += info->compl_pkts;
 		m_PacketCount[i] = 0;
 		info++;
 	}
 
-	if (acc)
-	{
-		AddEventToQueue(Event);
-	}
-	else
-	{
-		DEBUG_LOG(WII_IPC_WIIMOTE, "SendEventNumberOfCompletedPackets: no packets; no event");
-	}
+	AddEventToQueue(Event);
 
 	return true;
 }
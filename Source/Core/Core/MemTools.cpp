@@ -44,6 +44,11 @@ LONG NTAPI Handler(PEXCEPTION_POINTERS pPtrs)
 		uintptr_t badAddress = (uintptr_t)pPtrs->ExceptionRecord->ExceptionInformation[1];
 		CONTEXT* ctx = pPtrs->ContextRecord;
 
+		if (Memory::HandleWriteTrackingFault(badAddress))
+		{
+			return (DWORD)EXCEPTION_CONTINUE_EXECUTION;
+		}
+
 		if (JitInterface::HandleFault(badAddress, ctx))
 		{
 			return (DWORD)EXCEPTION_CONTINUE_EXECUTION;
@@ -248,6 +253,10 @@ static void sigsegv_handler(int sig, siginfo_t* info, void* raw_context)
 	}
 	uintptr_t bad_address = (uintptr_t)info->si_addr;
 
+	// Writes to pages protected for the texture cache just unprotect them and retry.
+	if (Memory::HandleWriteTrackingFault(bad_address))
+		return;
+
 	// Get all the information we can out of the context.
 #ifdef __OpenBSD__
 	ucontext_t* ctx = context;
@@ -2,49 +2,44 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <unordered_set>
 #include <unistd.h>
 
+#include "Common/CommonFuncs.h"
 #include "Common/FileUtil.h"
-#include "Core/CoreTiming.h"
+#include "Common/Thread.h"
+#include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
-#include "Core/HW/SystemTimers.h"
 #include "Core/MemoryWatcher.h"
 
 static std::unique_ptr<MemoryWatcher> s_memory_watcher;
-static CoreTiming::EventType* s_event;
 static const int MW_RATE = 600;  // Steps per second
 
-static void MWCallback(u64 userdata, s64 cyclesLate)
-{
-  s_memory_watcher->Step();
-  CoreTiming::ScheduleEvent(SystemTimers::GetTicksPerSecond() / MW_RATE - cyclesLate, s_event);
-}
-
 void MemoryWatcher::Init()
 {
   s_memory_watcher = std::make_unique<MemoryWatcher>();
-  s_event = CoreTiming::RegisterEvent("MemoryWatcher", MWCallback);
-  CoreTiming::ScheduleEvent(0, s_event);
 }
 
 void MemoryWatcher::Shutdown()
 {
-  CoreTiming::RemoveEvent(s_event);
   s_memory_watcher.reset();
 }
 
 MemoryWatcher::MemoryWatcher()
 {
   m_running = false;
+  m_binary = SConfig::GetInstance().bMemoryWatcherBinary;
   if (!LoadAddresses(File::GetUserPath(F_MEMORYWATCHERLOCATIONS_IDX)))
     return;
   if (!OpenSocket(File::GetUserPath(F_MEMORYWATCHERSOCKET_IDX)))
     return;
   m_running = true;
+  m_thread = std::thread(&MemoryWatcher::ThreadFunc, this);
 }
 
 MemoryWatcher::~MemoryWatcher()
@@ -52,33 +47,48 @@ MemoryWatcher::~MemoryWatcher()
   if (!m_running)
     return;
 
+  m_stop_event.Set();
+  m_thread.join();
   m_running = false;
   close(m_fd);
 }
 
+void MemoryWatcher::ThreadFunc()
+{
+  Common::SetCurrentThreadName("MemoryWatcher");
+  while (!m_stop_event.WaitFor(std::chrono::microseconds(1000000 / MW_RATE)))
+    Step();
+}
+
 bool MemoryWatcher::LoadAddresses(const std::string& path)
 {
   std::ifstream locations(path);
   if (!locations)
     return false;
 
+  // Each address is only watched once, under its first line
+  std::unordered_set<std::string> seen;
   std::string line;
-  while (std::getline(locations, line))
-    ParseLine(line);
+  for (u32 line_index = 0; std::getline(locations, line); line_index++)
+  {
+    if (seen.insert(line).second)
+      ParseLine(line, line_index);
+  }
 
-  return m_values.size() > 0;
+  return m_watches.size() > 0;
 }
 
-void MemoryWatcher::ParseLine(const std::string& line)
+void MemoryWatcher::ParseLine(const std::string& line, u32 line_index)
 {
-  m_values[line] = 0;
-  m_addresses[line] = std::vector<u32>();
+  Watch watch{line, line_index, {}, 0};
 
   std::stringstream offsets(line);
   offsets >> std::hex;
   u32 offset;
   while (offsets >> offset)
-    m_addresses[line].push_back(offset);
+    watch.offsets.push_back(offset);
+
+  m_watches.push_back(std::move(watch));
 }
 
 bool MemoryWatcher::OpenSocket(const std::string& path)
@@ -91,11 +101,17 @@ bool MemoryWatcher::OpenSocket(const std::string& path)
   return m_fd >= 0;
 }
 
-u32 MemoryWatcher::ChasePointer(const std::string& line)
+u32 MemoryWatcher::ChasePointer(const std::vector<u32>& offsets)
 {
   u32 value = 0;
-  for (u32 offset : m_addresses[line])
-    value = Memory::Read_U32(value + offset);
+  for (u32 offset : offsets)
+  {
+    // A pointer that does not lead into RAM reads as 0, like a null pointer would
+    u32 data;
+    if (!Memory::TryCopyFromEmu(&data, value + offset, sizeof(data)))
+      return 0;
+    value = Common::swap32(data);
+  }
   return value;
 }
 
@@ -106,24 +122,43 @@ std::string MemoryWatcher::ComposeMessage(const std::string& line, u32 value)
   return message_stream.str();
 }
 
+void MemoryWatcher::Send(const void* data, size_t size)
+{
+  sendto(m_fd, data, size, 0, reinterpret_cast<sockaddr*>(&m_addr), sizeof(m_addr));
+}
+
 void MemoryWatcher::Step()
 {
   if (!m_running)
     return;
 
-  for (auto& entry : m_values)
+  for (Watch& watch : m_watches)
   {
-    std::string address = entry.first;
-    u32& current_value = entry.second;
+    u32 new_value = ChasePointer(watch.offsets);
+    if (new_value == watch.value)
+      continue;
 
-    u32 new_value = ChasePointer(address);
-    if (new_value != current_value)
+    // Update the value
+    watch.value = new_value;
+    if (m_binary)
     {
-      // Update the value
-      current_value = new_value;
-      std::string message = ComposeMessage(address, new_value);
-      sendto(m_fd, message.c_str(), message.size() + 1, 0, reinterpret_cast<sockaddr*>(&m_addr),
-             sizeof(m_addr));
+      m_batch.push_back({watch.line_index, new_value});
+      if (m_batch.size() == MAX_BATCH_ENTRIES)
+      {
+        Send(m_batch.data(), m_batch.size() * sizeof(BatchEntry));
+        m_batch.clear();
+      }
     }
+    else
+    {
+      std::string message = ComposeMessage(watch.line, new_value);
+      Send(message.c_str(), message.size() + 1);
+    }
+  }
+
+  if (!m_batch.empty())
+  {
+    Send(m_batch.data(), m_batch.size() * sizeof(BatchEntry));
+    m_batch.clear();
   }
 }
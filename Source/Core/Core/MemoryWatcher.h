@@ -4,11 +4,15 @@
 
 #pragma once
 
-#include <map>
+#include <string>
+#include <thread>
 #include <vector>
 #include <sys/socket.h>
 #include <sys/un.h>
 
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+
 // MemoryWatcher reads a file containing in-game memory addresses and outputs
 // changes to those memory addresses to a unix domain socket as the game runs.
 //
@@ -17,6 +21,13 @@
 // "ABCD EF" will watch the address at (*0xABCD) + 0xEF.
 // The output to the socket is two lines. The first is the address from the
 // input file, and the second is the new value in hex.
+//
+// With MemoryWatcherBinary set, each poll instead sends the changed values as
+// datagrams of up to MAX_BATCH_ENTRIES (u32 line, u32 value) pairs in host byte
+// order, where line is the zero based line of the address in the input file.
+//
+// The addresses are polled on a thread of their own, straight from guest RAM,
+// so neither the polling nor the socket writes hold up the emulation.
 class MemoryWatcher final
 {
 public:
@@ -28,20 +39,41 @@ public:
 	static void Shutdown();
 
 private:
+	struct Watch
+	{
+		// Address as stored in the file
+		std::string line;
+		u32 line_index;
+		// Offsets to follow
+		std::vector<u32> offsets;
+		u32 value;
+	};
+
+	struct BatchEntry
+	{
+		u32 line_index;
+		u32 value;
+	};
+
+	static const size_t MAX_BATCH_ENTRIES = 1024;
+
 	bool LoadAddresses(const std::string& path);
 	bool OpenSocket(const std::string& path);
 
-	void ParseLine(const std::string& line);
-	u32 ChasePointer(const std::string& line);
+	void ThreadFunc();
+	void ParseLine(const std::string& line, u32 line_index);
+	u32 ChasePointer(const std::vector<u32>& offsets);
 	std::string ComposeMessage(const std::string& line, u32 value);
+	void Send(const void* data, size_t size);
 
 	bool m_running;
+	bool m_binary;
+	std::thread m_thread;
+	Common::Event m_stop_event;
 
 	int m_fd;
 	sockaddr_un m_addr;
 
-	// Address as stored in the file -> list of offsets to follow
-	std::map<std::string, std::vector<u32>> m_addresses;
-	// Address as stored in the file -> current value
-	std::map<std::string, u32> m_values;
+	std::vector<Watch> m_watches;
+	std::vector<BatchEntry> m_batch;
 };
@@ -8,6 +8,7 @@
 #include <iterator>
 #include <mbedtls/config.h>
 #include <mbedtls/md.h>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -45,7 +46,7 @@
 #include "VideoCommon/VideoConfig.h"
 
 // The chunk to allocate movie data in multiples of.
-#define DTM_BASE_LENGTH (1024)
+#define DTM_CHUNK_LENGTH (1024 * 1024)
 
 namespace Movie
 {
@@ -57,8 +58,131 @@ static PlayMode s_playMode = MODE_NONE;
 static u8 s_controllers = 0;
 static ControllerState s_padState;
 static DTMHeader tmpHeader;
-static u8* tmpInput = nullptr;
-static size_t tmpInputAllocated = 0;
+
+// The input log, kept in fixed size chunks. Growing it never copies what was recorded so far
+// and truncating it only drops the chunks past the new end, so a long recording costs its own
+// size in RAM and rerecording from a savestate doesn't touch the rest of it.
+class InputLog
+{
+public:
+	// Empties the log and marks it as holding a movie
+	void Reset()
+	{
+		m_chunks.clear();
+		m_size = 0;
+		m_active = true;
+	}
+
+	void Clear()
+	{
+		m_chunks.clear();
+		m_size = 0;
+		m_active = false;
+	}
+
+	bool IsActive() const { return m_active; }
+	u64 GetSize() const { return m_size; }
+
+	void Truncate(u64 size)
+	{
+		if (size >= m_size)
+			return;
+		m_size = size;
+		m_chunks.resize(static_cast<size_t>((size + DTM_CHUNK_LENGTH - 1) / DTM_CHUNK_LENGTH));
+	}
+
+	// Overwrites or extends the log at offset
+	void Write(u64 offset, const void* data, size_t size)
+	{
+		const u8* src = static_cast<const u8*>(data);
+		const u64 end = offset + size;
+		while (m_chunks.size() * DTM_CHUNK_LENGTH < end)
+			m_chunks.emplace_back(new u8[DTM_CHUNK_LENGTH]);
+		ForEachPiece(offset, size, [&src](u8* chunk_ptr, size_t length) {
+			memcpy(chunk_ptr, src, length);
+			src += length;
+		});
+		m_size = std::max(m_size, end);
+	}
+
+	void Append(const void* data, size_t size) { Write(m_size, data, size); }
+
+	void Read(u64 offset, void* data, size_t size) const
+	{
+		u8* dst = static_cast<u8*>(data);
+		ForEachPiece(offset, size, [&dst](const u8* chunk_ptr, size_t length) {
+			memcpy(dst, chunk_ptr, length);
+			dst += length;
+		});
+	}
+
+	// Returns the offset of the first byte that differs from data, or size if all match
+	size_t Compare(const u8* data, size_t size) const
+	{
+		size_t pos = 0;
+		size_t mismatch = size;
+		ForEachPiece(0, size, [&](const u8* chunk_ptr, size_t length) {
+			if (mismatch == size)
+			{
+				const auto result = std::mismatch(chunk_ptr, chunk_ptr + length, data + pos);
+				if (result.first != chunk_ptr + length)
+					mismatch = pos + (result.first - chunk_ptr);
+			}
+			pos += length;
+		});
+		return mismatch;
+	}
+
+	bool ReadFromFile(File::IOFile& file, u64 size)
+	{
+		Reset();
+		while (m_size < size)
+		{
+			const size_t length = static_cast<size_t>(std::min<u64>(DTM_CHUNK_LENGTH, size - m_size));
+			m_chunks.emplace_back(new u8[DTM_CHUNK_LENGTH]);
+			if (!file.ReadBytes(m_chunks.back().get(), length))
+				return false;
+			m_size += length;
+		}
+		return true;
+	}
+
+	bool WriteToFile(File::IOFile& file, u64 size) const
+	{
+		bool success = true;
+		size = std::min(size, m_size);
+		ForEachPiece(0, static_cast<size_t>(size), [&](const u8* chunk_ptr, size_t length) {
+			success = success && file.WriteBytes(chunk_ptr, length);
+		});
+		return success;
+	}
+
+private:
+	template <typename T, typename F>
+	static void ForEachPieceIn(T& chunks, u64 offset, size_t size, F func)
+	{
+		while (size != 0)
+		{
+			const size_t chunk = static_cast<size_t>(offset / DTM_CHUNK_LENGTH);
+			const size_t chunk_offset = static_cast<size_t>(offset % DTM_CHUNK_LENGTH);
+			const size_t length = std::min<size_t>(size, DTM_CHUNK_LENGTH - chunk_offset);
+			func(chunks[chunk].get() + chunk_offset, length);
+			offset += length;
+			size -= length;
+		}
+	}
+
+	template <typename F>
+	void ForEachPiece(u64 offset, size_t size, F func) { ForEachPieceIn(m_chunks, offset, size, func); }
+	template <typename F>
+	void ForEachPiece(u64 offset, size_t size, F func) const { ForEachPieceIn(m_chunks, offset, size, func); }
+
+	std::vector<std::unique_ptr<u8[]>> m_chunks;
+	u64 m_size = 0;
+	bool m_active = false;
+};
+
+static InputLog s_input_log;
 static u64 s_currentByte = 0, s_totalBytes = 0;
 static u64 s_currentFrame = 0, s_totalFrames = 0;  // VI
 static u64 s_currentLagCount = 0;
@@ -95,28 +219,6 @@ static std::string s_InputDisplay[8];
 static GCManipFunction gcmfunc = nullptr;
 static WiiManipFunction wiimfunc = nullptr;
 
-// NOTE: Host / CPU Thread
-static void EnsureTmpInputSize(size_t bound)
-{
-	if (tmpInputAllocated >= bound)
-		return;
-	// The buffer expands in powers of two of DTM_BASE_LENGTH
-	// (standard exponential buffer growth).
-	size_t newAlloc = DTM_BASE_LENGTH;
-	while (newAlloc < bound)
-		newAlloc *= 2;
-
-	u8* newTmpInput = new u8[newAlloc];
-	tmpInputAllocated = newAlloc;
-	if (tmpInput != nullptr)
-	{
-		if (s_totalBytes > 0)
-			memcpy(newTmpInput, tmpInput, (size_t)s_totalBytes);
-		delete[] tmpInput;
-	}
-	tmpInput = newTmpInput;
-}
-
 static bool IsMovieHeader(u8 magic[4])
 {
 	return magic[0] == 'D' && magic[1] == 'T' && magic[2] == 'M' && magic[3] == 0x1A;
@@ -457,6 +559,11 @@ int GetCPUMode()
 	return s_iCPUCore;
 }
 
+void SetCPUMode(int mode)
+{
+	s_iCPUCore = mode;
+}
+
 u8 GetLanguage()
 {
 	return s_language;
@@ -604,7 +711,7 @@ bool BeginRecordingInput(int controllers)
 
 	s_playMode = MODE_RECORDING;
 	s_author = SConfig::GetInstance().m_strMovieAuthor;
-	EnsureTmpInputSize(1);
+	s_input_log.Reset();
 
 	s_currentByte = s_totalBytes = 0;
 
@@ -869,8 +976,8 @@ void RecordInput(GCPadStatus* PadStatus, int controllerID)
 
 	CheckPadStatus(PadStatus, controllerID);
 
-	EnsureTmpInputSize((size_t)(s_currentByte + 8));
-	memcpy(&(tmpInput[s_currentByte]), &s_padState, 8);
+	s_input_log.Truncate(s_currentByte);
+	s_input_log.Append(&s_padState, 8);
 	s_currentByte += 8;
 	s_totalBytes = s_currentByte;
 }
@@ -891,10 +998,10 @@ void RecordWiimote(int wiimote, u8* data, u8 size)
 		return;
 
 	InputUpdate();
-	EnsureTmpInputSize((size_t)(s_currentByte + size + 1));
-	tmpInput[s_currentByte++] = size;
-	memcpy(&(tmpInput[s_currentByte]), data, size);
-	s_currentByte += size;
+	s_input_log.Truncate(s_currentByte);
+	s_input_log.Append(&size, 1);
+	s_input_log.Append(data, size);
+	s_currentByte += size + 1;
 	s_totalBytes = s_currentByte;
 }
 
@@ -976,8 +1083,7 @@ bool PlayInput(const std::string& filename)
 	Core::UpdateWantDeterminism();
 
 	s_totalBytes = g_recordfd.GetSize() - 256;
-	EnsureTmpInputSize((size_t)s_totalBytes);
-	g_recordfd.ReadArray(tmpInput, (size_t)s_totalBytes);
+	s_input_log.ReadFromFile(g_recordfd, s_totalBytes);
 	s_currentByte = 0;
 	g_recordfd.Close();
 
@@ -1052,16 +1158,15 @@ void LoadInput(const std::string& filename)
 		afterEnd = true;
 	}
 
-	if (!s_bReadOnly || tmpInput == nullptr)
+	if (!s_bReadOnly || !s_input_log.IsActive())
 	{
 		s_totalFrames = tmpHeader.frameCount;
 		s_totalLagCount = tmpHeader.lagCount;
 		s_totalInputCount = tmpHeader.inputCount;
 		s_totalTickCount = s_tickCountAtLastInput = tmpHeader.tickCount;
 
-		EnsureTmpInputSize((size_t)totalSavedBytes);
 		s_totalBytes = totalSavedBytes;
-		t_record.ReadArray(tmpInput, (size_t)s_totalBytes);
+		s_input_log.ReadFromFile(t_record, s_totalBytes);
 	}
 	else if (s_currentByte > 0)
 	{
@@ -1083,11 +1188,11 @@ void LoadInput(const std::string& filename)
 			std::vector<u8> movInput(s_currentByte);
 			t_record.ReadArray(movInput.data(), movInput.size());
 
-			const auto result = std::mismatch(movInput.begin(), movInput.end(), tmpInput);
+			const size_t mismatch = s_input_log.Compare(movInput.data(), movInput.size());
 
-			if (result.first != movInput.end())
+			if (mismatch != movInput.size())
 			{
-				const ptrdiff_t mismatch_index = std::distance(movInput.begin(), result.first);
+				const ptrdiff_t mismatch_index = static_cast<ptrdiff_t>(mismatch);
 
 				// this is a "you did something wrong" alert for the user's benefit.
 				// we'll try to say what's going on in excruciating detail, otherwise the user might not
@@ -1102,13 +1207,13 @@ void LoadInput(const std::string& filename)
 						"read-only mode off. Otherwise you'll probably get a desync.",
 						byte_offset, byte_offset);
 
-					std::copy(movInput.begin(), movInput.end(), tmpInput);
+					s_input_log.Write(0, movInput.data(), movInput.size());
 				}
 				else
 				{
 					const ptrdiff_t frame = mismatch_index / 8;
 					ControllerState curPadState;
-					memcpy(&curPadState, &tmpInput[frame * 8], 8);
+					s_input_log.Read(frame * 8, &curPadState, 8);
 					ControllerState movPadState;
 					memcpy(&movPadState, &movInput[frame * 8], 8);
 					PanicAlertT(
@@ -1187,7 +1292,7 @@ void PlayController(GCPadStatus* PadStatus, int controllerID)
 {
 	// Correct playback is entirely dependent on the emulator polling the controllers
 	// in the same order done during recording
-	if (!IsPlayingInput() || !IsUsingPad(controllerID) || tmpInput == nullptr)
+	if (!IsPlayingInput() || !IsUsingPad(controllerID) || !s_input_log.IsActive())
 		return;
 
 	if (s_currentByte + 8 > s_totalBytes)
@@ -1204,7 +1309,7 @@ void PlayController(GCPadStatus* PadStatus, int controllerID)
 	memset(PadStatus, 0, sizeof(GCPadStatus));
 	PadStatus->err = e;
 
-	memcpy(&s_padState, &(tmpInput[s_currentByte]), 8);
+	s_input_log.Read(s_currentByte, &s_padState, 8);
 	s_currentByte += 8;
 
 	PadStatus->triggerLeft = s_padState.TriggerL;
@@ -1288,7 +1393,7 @@ void PlayController(GCPadStatus* PadStatus, int controllerID)
 bool PlayWiimote(int wiimote, u8* data, const WiimoteEmu::ReportFeatures& rptf, int ext,
 	const wiimote_key key)
 {
-	if (!IsPlayingInput() || !IsUsingWiimote(wiimote) || tmpInput == nullptr)
+	if (!IsPlayingInput() || !IsUsingWiimote(wiimote) || !s_input_log.IsActive())
 		return false;
 
 	if (s_currentByte > s_totalBytes)
@@ -1301,7 +1406,9 @@ bool PlayWiimote(int wiimote, u8* data, const WiimoteEmu::ReportFeatures& rptf,
 
 	u8 size = rptf.size;
 
-	u8 sizeInMovie = tmpInput[s_currentByte];
+	u8 sizeInMovie = 0;
+	if (s_currentByte < s_totalBytes)
+		s_input_log.Read(s_currentByte, &sizeInMovie, 1);
 
 	if (size != sizeInMovie)
 	{
@@ -1325,7 +1432,7 @@ bool PlayWiimote(int wiimote, u8* data, const WiimoteEmu::ReportFeatures& rptf,
 		return false;
 	}
 
-	memcpy(data, &(tmpInput[s_currentByte]), size);
+	s_input_log.Read(s_currentByte, data, size);
 	s_currentByte += size;
 
 	s_currentInputCount++;
@@ -1359,8 +1466,7 @@ void EndPlayInput(bool cont)
 		// we don't clear these things because otherwise we can't resume playback if we load a movie
 		// state later
 		// s_totalFrames = s_totalBytes = 0;
-		// delete tmpInput;
-		// tmpInput = nullptr;
+		// s_input_log.Clear();
 
 		Core::QueueHostJob([=] {
 			Core::UpdateWantDeterminism();
@@ -1429,7 +1535,7 @@ void SaveRecording(const std::string& filename)
 
 	save_record.WriteArray(&header, 1);
 
-	bool success = save_record.WriteArray(tmpInput, (size_t)s_totalBytes);
+	bool success = s_input_log.WriteToFile(save_record, s_totalBytes);
 
 	if (success && s_bRecordingFromSaveState)
 	{
@@ -1576,8 +1682,6 @@ void Shutdown()
 {
 	s_currentInputCount = s_totalInputCount = s_totalFrames = s_totalBytes = s_tickCountAtLastInput =
 		0;
-	delete[] tmpInput;
-	tmpInput = nullptr;
-	tmpInputAllocated = 0;
+	s_input_log.Clear();
 }
 };
@@ -141,6 +141,8 @@ bool IsPAL60();
 bool IsDSPHLE();
 bool IsFastDiscSpeed();
 int GetCPUMode();
+// Replays with another CPU core than the recorded one, call after PlayInput and before booting.
+void SetCPUMode(int mode);
 u8 GetLanguage();
 bool IsStartingFromClearSave();
 bool IsUsingMemcard(int memcard);
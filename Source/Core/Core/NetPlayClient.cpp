@@ -337,14 +337,20 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
 
 	case NP_MSG_PAD_DATA:
 	{
-		PadMapping map = 0;
-		GCPadStatus pad;
-		packet >> map >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
-			pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
+		// One packet carries all pad updates of a player's poll
+		while (!packet.endOfPacket())
+		{
+			PadMapping map = 0;
+			GCPadStatus pad;
+			packet >> map >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
+				pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
+			if (!packet)
+				break;
 
-		// Trusting server for good map value (>=0 && <4)
-		// add to pad buffer
-		m_pad_buffer.at(map).Push(pad);
+			// Trusting server for good map value (>=0 && <4)
+			// add to pad buffer
+			m_pad_buffer.at(map).Push(pad);
+		}
 		m_gc_pad_event.Set();
 	}
 	break;
@@ -725,6 +731,14 @@ void NetPlayClient::ThreadFunc()
 		if (m_traversal_client)
 			m_traversal_client->HandleResends();
 		net = enet_host_service(m_client, &netEvent, 250);
+		{
+			std::lock_guard<std::recursive_mutex> lkq(m_crit.async_queue_write);
+			if (m_pad_packet.getDataSize() != 0)
+			{
+				Send(m_pad_packet);
+				m_pad_packet.clear();
+			}
+		}
 		while (!m_async_queue.Empty())
 		{
 			Send(*(m_async_queue.Front().get()));
@@ -843,15 +857,16 @@ void NetPlayClient::SendChatMessage(const std::string& msg)
 }
 
 // called from ---CPU--- thread
+// Appended to the pending pad packet, SendNetPad wakes the netplay thread once all local pads
+// are in. The packet's storage is reused, so this doesn't allocate once it has grown.
 void NetPlayClient::SendPadState(const int in_game_pad, const GCPadStatus& pad)
 {
-	auto spac = std::make_unique<sf::Packet>();
-	*spac << static_cast<MessageId>(NP_MSG_PAD_DATA);
-	*spac << static_cast<PadMapping>(in_game_pad);
-	*spac << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY << pad.substickX
-		<< pad.substickY << pad.triggerLeft << pad.triggerRight;
-
-	SendAsync(std::move(spac));
+	std::lock_guard<std::recursive_mutex> lkq(m_crit.async_queue_write);
+	if (m_pad_packet.getDataSize() == 0)
+		m_pad_packet << static_cast<MessageId>(NP_MSG_PAD_DATA);
+	m_pad_packet << static_cast<PadMapping>(in_game_pad);
+	m_pad_packet << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY
+		<< pad.substickX << pad.substickY << pad.triggerLeft << pad.triggerRight;
 }
 
 // called from ---CPU--- thread
@@ -1139,6 +1154,14 @@ void NetPlayClient::SendNetPad(int pad_nb)
 			}
 		}
 	}
+
+	bool pads_pending;
+	{
+		std::lock_guard<std::recursive_mutex> lkq(m_crit.async_queue_write);
+		pads_pending = m_pad_packet.getDataSize() != 0;
+	}
+	if (pads_pending)
+		ENetUtil::WakeupThread(m_client);
 }
 
 // called from ---CPU--- thread
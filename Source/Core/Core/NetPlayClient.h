@@ -133,6 +133,8 @@ protected:
 	} m_crit;
 
 	Common::FifoQueue<std::unique_ptr<sf::Packet>, false> m_async_queue;
+	// Pad updates not sent yet, guarded by async_queue_write
+	sf::Packet m_pad_packet;
 
 	std::array<Common::FifoQueue<GCPadStatus>, 4> m_pad_buffer;
 	std::array<Common::FifoQueue<NetWiimote>, 4> m_wiimote_buffer;
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "Core/NetPlayServer.h"
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -88,7 +89,7 @@ NetPlayServer::NetPlayServer(const u16 port, bool traversal, const std::string&
 		ENetAddress serverAddr;
 		serverAddr.host = ENET_HOST_ANY;
 		serverAddr.port = port;
-		m_server = enet_host_create(&serverAddr, 10, 3, 0, 0);
+		m_server = enet_host_create(&serverAddr, MAX_PEERS, 3, 0, 0);
 		if (m_server != nullptr)
 			m_server->intercept = ENetUtil::InterceptCallback;
 	}
@@ -124,7 +125,9 @@ void NetPlayServer::ThreadFunc()
 		int net;
 		if (m_traversal_client)
 			m_traversal_client->HandleResends();
-		net = enet_host_service(m_server, &netEvent, 1000);
+		// Wake up in time for delayed spectator input
+		net = enet_host_service(m_server, &netEvent, m_spectator_queue.empty() ? 1000 : 5);
+		SendDelayedInput();
 		while (!m_async_queue.Empty())
 		{
 			{
@@ -583,25 +586,23 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
 		if (player.current_game != m_current_game)
 			break;
 
-		PadMapping map = 0;
-		GCPadStatus pad;
-		packet >> map >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
-			pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
-
-		// If the data is not from the correct player,
-		// then disconnect them.
-		if (m_pad_map.at(map) != player.pid)
+		while (!packet.endOfPacket())
 		{
-			return 1;
+			PadMapping map = 0;
+			GCPadStatus pad;
+			packet >> map >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
+				pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
+
+			// If the data is not from the correct player,
+			// then disconnect them.
+			if (!packet || m_pad_map.at(map) != player.pid)
+			{
+				return 1;
+			}
 		}
 
-		// Relay to clients
-		sf::Packet spac;
-		spac << (MessageId)NP_MSG_PAD_DATA;
-		spac << map << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY
-			<< pad.substickX << pad.substickY << pad.triggerLeft << pad.triggerRight;
-
-		SendToClients(spac, player.pid);
+		// Relay to clients, the batch is already in the format they expect
+		RelayInput(packet, player.pid);
 	}
 	break;
 
@@ -633,7 +634,7 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
 		for (const u8& byte : data)
 			spac << byte;
 
-		SendToClients(spac, player.pid);
+		RelayInput(spac, player.pid);
 	}
 	break;
 
@@ -903,12 +904,85 @@ bool NetPlayServer::StartGame()
 // called from multiple threads
 void NetPlayServer::SendToClients(sf::Packet& packet, const PlayerId skip_pid)
 {
+	// ENet packets are reference counted, so all clients share one copy of the data
+	ENetPacket* epac = nullptr;
 	for (auto& p : m_players)
 	{
 		if (p.second.pid && p.second.pid != skip_pid)
 		{
-			Send(p.second.socket, packet);
+			if (!epac)
+				epac = enet_packet_create(packet.getData(), packet.getDataSize(), ENET_PACKET_FLAG_RELIABLE);
+			enet_peer_send(p.second.socket, 0, epac);
+		}
+	}
+}
+
+void NetPlayServer::SetSpectatorDelay(u32 delay_ms)
+{
+	m_spectator_delay = delay_ms;
+}
+
+// Spectators are the clients that have no pad or Wiimote mapped
+bool NetPlayServer::IsSpectator(const PlayerId pid) const
+{
+	return std::find(m_pad_map.begin(), m_pad_map.end(), pid) == m_pad_map.end() &&
+		std::find(m_wiimote_map.begin(), m_wiimote_map.end(), pid) == m_wiimote_map.end();
+}
+
+// called from ---NETPLAY--- thread
+// Players get input right away. With a spectator delay, spectators get it from
+// SendDelayedInput once the delay is over, so watchers never hold up the players.
+void NetPlayServer::RelayInput(sf::Packet& packet, const PlayerId skip_pid)
+{
+	if (m_spectator_delay == 0)
+	{
+		SendToClients(packet, skip_pid);
+		return;
+	}
+
+	ENetPacket* epac = nullptr;
+	bool has_spectators = false;
+	for (auto& p : m_players)
+	{
+		if (!p.second.pid || p.second.pid == skip_pid)
+			continue;
+		if (IsSpectator(p.second.pid))
+		{
+			has_spectators = true;
+			continue;
+		}
+		if (!epac)
+			epac = enet_packet_create(packet.getData(), packet.getDataSize(), ENET_PACKET_FLAG_RELIABLE);
+		enet_peer_send(p.second.socket, 0, epac);
+	}
+
+	if (has_spectators)
+		m_spectator_queue.push_back({ Common::Timer::GetTimeMs() + m_spectator_delay, m_current_game, packet });
+}
+
+// called from ---NETPLAY--- thread
+void NetPlayServer::SendDelayedInput()
+{
+	const u32 now = Common::Timer::GetTimeMs();
+	while (!m_spectator_queue.empty() &&
+		static_cast<s32>(now - m_spectator_queue.front().due_time) >= 0)
+	{
+		DelayedInput& input = m_spectator_queue.front();
+		// Input of a game that has since been stopped isn't wanted anymore
+		if (input.game == m_current_game)
+		{
+			ENetPacket* epac = nullptr;
+			for (auto& p : m_players)
+			{
+				if (!p.second.pid || !IsSpectator(p.second.pid))
+					continue;
+				if (!epac)
+					epac = enet_packet_create(input.packet.getData(), input.packet.getDataSize(),
+						ENET_PACKET_FLAG_RELIABLE);
+				enet_peer_send(p.second.socket, 0, epac);
+			}
 		}
+		m_spectator_queue.pop_front();
 	}
 }
 
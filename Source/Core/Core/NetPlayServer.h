@@ -5,6 +5,7 @@
 #pragma once
 
 #include <SFML/Network/Packet.hpp>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <queue>
@@ -29,6 +30,8 @@ enum class PlayerGameStatus;
 class NetPlayServer : public TraversalClientClient
 {
 public:
+	static constexpr size_t MAX_PEERS = 64;
+
 	void ThreadFunc();
 	void SendAsyncToClients(std::unique_ptr<sf::Packet> packet);
 
@@ -51,6 +54,8 @@ public:
 	void SetWiimoteMapping(const PadMappingArray& mappings);
 
 	void AdjustMinimumPadBufferSize(unsigned int size);
+	// Input reaches clients without pads or Wiimotes this many ms after the players
+	void SetSpectatorDelay(u32 delay_ms);
 
 	void KickPlayer(PlayerId player);
 
@@ -91,6 +96,9 @@ private:
 
 	void SendToClients(sf::Packet& packet, const PlayerId skip_pid = 0);
 	void Send(ENetPeer* socket, sf::Packet& packet);
+	void RelayInput(sf::Packet& packet, const PlayerId skip_pid);
+	void SendDelayedInput();
+	bool IsSpectator(const PlayerId pid) const;
 	unsigned int OnConnect(ENetPeer* socket);
 	unsigned int OnDisconnect(Client& player);
 	unsigned int OnData(sf::Packet& packet, Client& player);
@@ -116,6 +124,15 @@ private:
 
 	std::map<PlayerId, Client> m_players;
 
+	struct DelayedInput
+	{
+		u32 due_time;
+		u32 game;
+		sf::Packet packet;
+	};
+	u32 m_spectator_delay = 0;
+	std::deque<DelayedInput> m_spectator_queue;
+
 	std::unordered_map<u32, std::vector<std::pair<PlayerId, u64>>> m_timebase_by_frame;
 	bool m_desync_detected;
 
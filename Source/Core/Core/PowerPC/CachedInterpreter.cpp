@@ -39,6 +39,22 @@ void CachedInterpreter::Run()
 	}
 }
 
+static void EndBlock(UGeckoInstruction data)
+{
+	PC = NPC;
+	PowerPC::ppcState.downcount -= data.hex;
+	if (PowerPC::ppcState.downcount <= 0)
+	{
+		CoreTiming::Advance();
+	}
+}
+
+static void WritePC(UGeckoInstruction data)
+{
+	PC = data.hex;
+	NPC = data.hex + 4;
+}
+
 void CachedInterpreter::SingleStep()
 {
 	int block = GetBlockNumberFromStartAddress(PC);
@@ -58,6 +74,19 @@ void CachedInterpreter::SingleStep()
 				code++;
 				break;
 
+			case Instruction::INSTRUCTION_TYPE_PAIR:
+				code->common_callback(UGeckoInstruction(code->data));
+				code->second_callback(UGeckoInstruction(code->second_data));
+				code++;
+				break;
+
+			case Instruction::INSTRUCTION_TYPE_EXIT:
+				WritePC(code->address);
+				code->common_callback(UGeckoInstruction(code->data));
+				EndBlock(code->downcount);
+				code++;
+				break;
+
 			case Instruction::INSTRUCTION_TYPE_CONDITIONAL:
 				bool ret = code->conditional_callback(code->data);
 				code++;
@@ -71,20 +100,21 @@ void CachedInterpreter::SingleStep()
 	Jit(PC);
 }
 
-static void EndBlock(UGeckoInstruction data)
+void CachedInterpreter::EmitCommon(Instruction::CommonCallback callback, UGeckoInstruction inst,
+	size_t block_start)
 {
-	PC = NPC;
-	PowerPC::ppcState.downcount -= data.hex;
-	if (PowerPC::ppcState.downcount <= 0)
+	// Calling two callbacks from one entry halves the dispatch for straight-line code, such as
+	// load/store runs or a load followed by its compare
+	if (m_code.size() > block_start && m_code.back().type == Instruction::INSTRUCTION_TYPE_COMMON)
 	{
-		CoreTiming::Advance();
+		Instruction& previous = m_code.back();
+		previous.second_callback = callback;
+		previous.second_data = inst.hex;
+		previous.type = Instruction::INSTRUCTION_TYPE_PAIR;
+		return;
 	}
-}
 
-static void WritePC(UGeckoInstruction data)
-{
-	PC = data.hex;
-	NPC = data.hex + 4;
+	m_code.emplace_back(callback, inst);
 }
 
 static bool CheckFPU(u32 data)
@@ -104,7 +134,7 @@ void CachedInterpreter::Jit(u32 address)
 {
 	if (m_code.size() >= CODE_SIZE / sizeof(Instruction) - 0x1000 || IsFull() || SConfig::GetInstance().bJITNoBlockCache)
 	{
-		ClearCache();
+		ClearFullCache();
 	}
 
 	u32 nextPC = analyzer.Analyze(PC, &code_block, &code_buffer, code_buffer.GetSize());
@@ -128,6 +158,7 @@ void CachedInterpreter::Jit(u32 address)
 	js.curBlock = b;
 
 	PPCAnalyst::CodeOp *ops = code_buffer.codebuffer;
+	const size_t block_start = m_code.size();
 
 	b->checkedEntry = GetCodePtr();
 	b->normalEntry = GetCodePtr();
@@ -146,11 +177,11 @@ void CachedInterpreter::Jit(u32 address)
 				int flags = HLE::GetFunctionFlagsByIndex(function);
 				if (HLE::IsEnabled(flags))
 				{
-					m_code.emplace_back(WritePC, ops[i].address);
-					m_code.emplace_back(Interpreter::HLEFunction, ops[i].inst);
+					EmitCommon(WritePC, ops[i].address, block_start);
+					EmitCommon(Interpreter::HLEFunction, ops[i].inst, block_start);
 					if (type == HLE::HLE_HOOK_REPLACE)
 					{
-						m_code.emplace_back(EndBlock, js.downcountAmount);
+						EmitCommon(EndBlock, js.downcountAmount, block_start);
 						m_code.emplace_back();
 						break;
 					}
@@ -167,16 +198,15 @@ void CachedInterpreter::Jit(u32 address)
 			}
 
 			if (ops[i].opinfo->flags & FL_ENDBLOCK)
-				m_code.emplace_back(WritePC, ops[i].address);
-			m_code.emplace_back(GetInterpreterOp(ops[i].inst), ops[i].inst);
-			if (ops[i].opinfo->flags & FL_ENDBLOCK)
-				m_code.emplace_back(EndBlock, js.downcountAmount);
+				m_code.emplace_back(GetInterpreterOp(ops[i].inst), ops[i].inst, ops[i].address, js.downcountAmount);
+			else
+				EmitCommon(GetInterpreterOp(ops[i].inst), ops[i].inst, block_start);
 		}
 	}
 	if (code_block.m_broken)
 	{
-		m_code.emplace_back(WritePC, nextPC);
-		m_code.emplace_back(EndBlock, js.downcountAmount);
+		EmitCommon(WritePC, nextPC, block_start);
+		EmitCommon(EndBlock, js.downcountAmount, block_start);
 	}
 	m_code.emplace_back();
 
@@ -50,24 +50,41 @@ private:
 		Instruction() : type(INSTRUCTION_ABORT) {};
 		Instruction(const CommonCallback c, UGeckoInstruction i) : common_callback(c), data(i.hex), type(INSTRUCTION_TYPE_COMMON) {};
 		Instruction(const ConditionalCallback c, u32 d) : conditional_callback(c), data(d), type(INSTRUCTION_TYPE_CONDITIONAL) {};
+		// The last instruction of a block together with the PC write before it and the downcount
+		// update after it
+		Instruction(const CommonCallback c, UGeckoInstruction i, u32 exit_pc, u32 exit_downcount)
+			: common_callback(c), data(i.hex), address(exit_pc), downcount(exit_downcount), type(INSTRUCTION_TYPE_EXIT) {};
 
 		union
 		{
-			const CommonCallback common_callback;
-			const ConditionalCallback conditional_callback;
+			CommonCallback common_callback;
+			ConditionalCallback conditional_callback;
 
 		};
+		// Second callback of a fused pair
+		CommonCallback second_callback = nullptr;
 		u32 data;
+		union
+		{
+			u32 second_data;
+			u32 address;
+		};
+		u32 downcount = 0;
 		enum
 		{
 			INSTRUCTION_ABORT,
 			INSTRUCTION_TYPE_COMMON,
 			INSTRUCTION_TYPE_CONDITIONAL,
+			INSTRUCTION_TYPE_PAIR,
+			INSTRUCTION_TYPE_EXIT,
 		} type;
 	};
 
 	const u8* GetCodePtr() { return (u8*)(m_code.data() + m_code.size()); }
 
+	// Appends a common callback, fusing it with the previous entry of the block if that is one too
+	void EmitCommon(Instruction::CommonCallback callback, UGeckoInstruction inst, size_t block_start);
+
 	std::vector<Instruction> m_code;
 
 	PPCAnalyst::CodeBuffer code_buffer;
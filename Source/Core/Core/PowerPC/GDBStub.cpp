@@ -589,10 +589,11 @@ static void gdb_read_mem()
 		len = (len << 4) | hex2char(cmd_bfr[i++]);
 	DEBUG_LOG(GDB_STUB, "gdb: read memory: %08x bytes from %08x\n", len, addr);
 
-	if (len*2 > sizeof reply)
-		gdb_reply("E01");
-	u8 * data = Memory::GetPointer(addr);
-	if (!data)
+	if (len*2 >= sizeof reply)
+		return gdb_reply("E01");
+	// Unmapped addresses are an error for GDB, not something to alert the user about
+	static u8 data[sizeof reply / 2];
+	if (!Memory::TryCopyFromEmu(data, addr, len))
 		return gdb_reply("E0");
 	mem2hex(reply, data, len);
 	reply[len*2] = '\0';
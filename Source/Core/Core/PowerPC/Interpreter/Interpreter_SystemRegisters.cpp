@@ -7,6 +7,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/Logging/Log.h"
 #include "Core/HW/GPFifo.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/Interpreter/Interpreter.h"
@@ -172,6 +173,9 @@ void Interpreter::mtmsr(UGeckoInstruction _inst)
 static void SetSR(int index, u32 value)
 {
 	DEBUG_LOG(POWERPC, "%08x: MMU: Segment register %i set to %08x", PowerPC::ppcState.pc, index, value);
+	// Pages of the segment mapped for fastmem were translated with the old VSID
+	if (PowerPC::ppcState.sr[index] != value)
+		Memory::UnmapLogicalPages(0xF0000000, static_cast<u32>(index) << 28);
 	PowerPC::ppcState.sr[index] = value;
 }
 
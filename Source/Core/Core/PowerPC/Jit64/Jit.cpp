@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <map>
 #include <string>
 
@@ -216,13 +217,16 @@ void Jit64::Init()
 	gpr.SetEmitter(this);
 	fpr.SetEmitter(this);
 
-	trampolines.Init(jo.memcheck ? TRAMPOLINE_CODE_SIZE_MMU : TRAMPOLINE_CODE_SIZE);
-	AllocCodeSpace(CODE_SIZE);
+	const int scale = GetCodeCacheScale();
+	trampolines.Init((jo.memcheck ? TRAMPOLINE_CODE_SIZE_MMU : TRAMPOLINE_CODE_SIZE) * scale);
+	AllocCodeSpace(CODE_SIZE * scale);
 
 	// BLR optimization has the same consequences as block linking, as well as
 	// depending on the fault handler to be safe in the event of excessive BL.
 	m_enable_blr_optimization = jo.enableBlocklink && SConfig::GetInstance().bFastmem && !SConfig::GetInstance().bEnableDebugging;
 	m_cleanup_after_stackfault = false;
+	m_tiered_compilation = SConfig::GetInstance().bJITTieredCompilation && !SConfig::GetInstance().bEnableDebugging;
+	m_superblocks = SConfig::GetInstance().bJITSuperblocks && !SConfig::GetInstance().bEnableDebugging;
 
 	m_stack = nullptr;
 	if (m_enable_blr_optimization)
@@ -233,8 +237,9 @@ void Jit64::Init()
 
 	// important: do this *after* generating the global asm routines, because we can't use farcode in them.
 	// it'll crash because the farcode functions get cleared on JIT clears.
-	farcode.Init(jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE);
+	farcode.Init((jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE) * scale);
 	Clear();
+	InitAnalysisWorker(code_buffer.GetSize());
 
 	code_block.m_stats = &js.st;
 	code_block.m_gpa = &js.gpa;
@@ -254,6 +259,7 @@ void Jit64::ClearCache()
 
 void Jit64::Shutdown()
 {
+	analysis_worker.Shutdown();
 	FreeStack();
 	FreeCodeSpace();
 
@@ -340,9 +346,13 @@ bool Jit64::Cleanup()
 
 	if (jo.optimizeGatherPipe && js.fifoBytesThisBlock > 0)
 	{
+		// Only call out when a burst is ready.
+		CMP(32, M(&GPFifo::m_gatherPipeCount), Imm8(GPFifo::GATHER_PIPE_SIZE));
+		FixupBranch no_burst = J_CC(CC_B);
 		ABI_PushRegistersAndAdjustStack({}, 0);
 		ABI_CallFunction((void *)&GPFifo::FastCheckGatherPipe);
 		ABI_PopRegistersAndAdjustStack({}, 0);
+		SetJumpTarget(no_burst);
 		did_something = true;
 	}
 
@@ -443,6 +453,30 @@ void Jit64::WriteExitDestInRSCRATCH(bool bl, u32 after)
 	}
 }
 
+void Jit64::WriteIndirectExit(bool bl, u32 after)
+{
+	if (!jo.enableBlocklink)
+	{
+		WriteExitDestInRSCRATCH(bl, after);
+		return;
+	}
+
+	// Predict the target taken last time, or failing that the current CTR, and exit through a
+	// linkable jump when it matches. Function pointer calls and virtual calls rarely change target.
+	u32* last_target = &m_indirect_branch_targets.emplace(js.compilerPC, CTR & ~3).first->second;
+	if (*last_target != 0)
+	{
+		CMP(32, R(RSCRATCH), Imm32(*last_target));
+		FixupBranch miss = J_CC(CC_NZ, true);
+		WriteExit(*last_target, bl, after);
+		SetJumpTarget(miss);
+	}
+
+	MOV(64, R(RSCRATCH2), ImmPtr(last_target));
+	MOV(32, MatR(RSCRATCH2), R(RSCRATCH));
+	WriteExitDestInRSCRATCH(bl, after);
+}
+
 void Jit64::WriteBLRExit()
 {
 	if (!m_enable_blr_optimization)
@@ -548,7 +582,7 @@ void Jit64::Jit(u32 em_address)
 		blocks.IsFull() ||
 		SConfig::GetInstance().bJITNoBlockCache)
 	{
-		ClearCache();
+		ClearFullCache();
 	}
 
 	int blockSize = code_buffer.GetSize();
@@ -577,9 +611,18 @@ void Jit64::Jit(u32 em_address)
 		}
 	}
 
+	// With tiered compilation, blocks are first compiled without branch following and instruction
+	// merging, which keeps them short and cheap to emit. Once a block has run often enough it is
+	// recompiled with all optimizations.
+	bool first_tier = m_tiered_compilation && js.hotBlockAddresses.find(em_address) == js.hotBlockAddresses.end();
+	u32 base_options = analyzer.GetOptions();
+	analyzer.SetOptions(GetAnalyzerOptions(base_options, first_tier));
+
 	// Analyze the block, collect all instructions it is made of (including inlining,
 	// if that is enabled), reorder instructions for optimal performance, and join joinable instructions.
-	u32 nextPC = analyzer.Analyze(em_address, &code_block, &code_buffer, blockSize);
+	u32 nextPC = AnalyzeBlock(em_address, &code_buffer, blockSize);
+
+	analyzer.SetOptions(base_options);
 
 	if (code_block.m_memory_exception)
 	{
@@ -593,7 +636,30 @@ void Jit64::Jit(u32 em_address)
 
 	int block_num = blocks.AllocateBlock(em_address);
 	JitBlock *b = blocks.GetBlock(block_num);
+	b->tierUpCounter = first_tier ? TIER_UP_THRESHOLD : 0;
 	blocks.FinalizeBlock(block_num, jo.enableBlocklink, DoJit(em_address, &code_buffer, b, nextPC));
+
+	// Exit targets are analyzed with the options of a block that is not hot yet.
+	analyzer.SetOptions(GetAnalyzerOptions(base_options, m_tiered_compilation));
+	RequestExitAnalysis(*b, blockSize);
+	analyzer.SetOptions(base_options);
+}
+
+u32 Jit64::GetAnalyzerOptions(u32 base_options, bool first_tier) const
+{
+	if (first_tier)
+	{
+		return base_options & ~(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE |
+			PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE |
+			PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE |
+			PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+	}
+
+	// Superblocks are only built for hot blocks when tiered compilation is enabled.
+	if (m_superblocks && blocks.CanAddTraceBlock())
+		return base_options | PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW;
+
+	return base_options;
 }
 
 const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBlock *b, u32 nextPC)
@@ -639,6 +705,24 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		// get start tic
 		PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStart);
 	}
+	// Count down the executions of a first tier block. When the counter hits zero, the block is
+	// invalidated and the dispatcher recompiles it as a hot block.
+	if (b->tierUpCounter)
+	{
+		MOV(64, R(RSCRATCH), Imm64((u64)&b->tierUpCounter));
+		SUB(32, MatR(RSCRATCH), Imm8(1));
+		FixupBranch tier_up = J_CC(CC_Z, true);
+		SwitchToFarCode();
+		SetJumpTarget(tier_up);
+		MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+		ABI_PushRegistersAndAdjustStack({}, 0);
+		ABI_CallFunctionC((void *)&JitInterface::CompileExceptionCheck,
+			(u32)JitInterface::ExceptionType::EXCEPTIONS_HOT_BLOCK);
+		ABI_PopRegistersAndAdjustStack({}, 0);
+		JMP(asm_routines.dispatcher, true);
+		SwitchToNearCode();
+	}
+
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
 	// should help logged stack-traces become more accurate
 	MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
@@ -723,9 +807,13 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		{
 			js.fifoBytesThisBlock -= 32;
 			BitSet32 registersInUse = CallerSavedRegistersInUse();
+			// Skip saving the registers when there is no burst to copy yet.
+			CMP(32, M(&GPFifo::m_gatherPipeCount), Imm8(GPFifo::GATHER_PIPE_SIZE));
+			FixupBranch no_burst = J_CC(CC_B);
 			ABI_PushRegistersAndAdjustStack(registersInUse, 0);
 			ABI_CallFunction((void *)&GPFifo::FastCheckGatherPipe);
 			ABI_PopRegistersAndAdjustStack(registersInUse, 0);
+			SetJumpTarget(no_burst);
 			gatherPipeIntCheck = true;
 		}
 
@@ -919,6 +1007,16 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	b->codeSize = (u32)(GetCodePtr() - start);
 	b->originalSize = code_block.m_num_instructions;
 
+	// With followed branches, the block covers everything up to its last instruction.
+	u32 last_address = em_address;
+	for (u32 i = 0; i < code_block.m_num_instructions; i++)
+		last_address = std::max(last_address, ops[i].address);
+	if (last_address - em_address >= 4 * code_block.m_num_instructions)
+	{
+		b->originalSize = (last_address - em_address) / 4 + 1;
+		b->followsBranches = true;
+	}
+
 #ifdef JIT_LOG_X86
 	LogGeneratedX86(code_block.m_num_instructions, code_buf, start, b);
 #endif
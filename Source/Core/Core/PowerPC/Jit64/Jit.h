@@ -18,6 +18,8 @@
 // ----------
 #pragma once
 
+#include <unordered_map>
+
 #include "Common/CommonTypes.h"
 #include "Common/x64Emitter.h"
 #include "Core/PowerPC/PPCAnalyst.h"
@@ -42,8 +44,22 @@ private:
 
 	bool m_enable_blr_optimization;
 	bool m_cleanup_after_stackfault;
+	bool m_tiered_compilation;
+	bool m_superblocks;
 	u8* m_stack;
 
+	// Number of executions after which a first tier block is recompiled with all optimizations.
+	static const int TIER_UP_THRESHOLD = 64;
+
+	u32 GetAnalyzerOptions(u32 base_options, bool first_tier) const;
+
+	// Fast-forwards to the next event before taking the branch of a detected busy wait loop.
+	void WriteIdleLoopSkip(const PPCAnalyst::CodeOp& branch);
+
+	// Last target taken by each bcctr, keyed by its address. The generated code stores into the
+	// elements directly, so entries are never erased (their addresses have to stay valid).
+	std::unordered_map<u32, u32> m_indirect_branch_targets;
+
 public:
 	Jit64() : code_buffer(32000) {}
 	~Jit64() {}
@@ -92,6 +108,8 @@ public:
 	void WriteExit(u32 destination, bool bl = false, u32 after = 0);
 	void JustWriteExit(u32 destination, bool bl, u32 after);
 	void WriteExitDestInRSCRATCH(bool bl = false, u32 after = 0);
+	// Exit of an indirect branch with its destination in RSCRATCH, linked to the predicted target
+	void WriteIndirectExit(bool bl, u32 after);
 	void WriteBLRExit();
 	void WriteExceptionExit();
 	void WriteExternalExceptionExit();
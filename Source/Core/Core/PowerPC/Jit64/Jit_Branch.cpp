@@ -6,6 +6,8 @@
 #include "Common/CommonTypes.h"
 #include "Common/x64Emitter.h"
 #include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/CPU.h"
 #include "Core/PowerPC/Gekko.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/PPCAnalyst.h"
@@ -99,6 +101,17 @@ void Jit64::bx(UGeckoInstruction inst)
 	WriteExit(destination, inst.LK, js.compilerPC + 4);
 }
 
+void Jit64::WriteIdleLoopSkip(const PPCAnalyst::CodeOp& branch)
+{
+	if (!branch.branchIsIdleLoop || !SConfig::GetInstance().bJITIdleLoopDetection || CPU::GetState() == CPU::CPU_STEPPING)
+		return;
+
+	// All guest registers are flushed at this point, and the exit only uses immediates.
+	ABI_PushRegistersAndAdjustStack({}, 0);
+	ABI_CallFunction((void *)&CoreTiming::Idle);
+	ABI_PopRegistersAndAdjustStack({}, 0);
+}
+
 // TODO - optimize to hell and beyond
 // TODO - make nice easy to optimize special cases for the most common
 // variants of this instruction.
@@ -137,6 +150,7 @@ void Jit64::bcx(UGeckoInstruction inst)
 
 	gpr.Flush(FLUSH_MAINTAIN_STATE);
 	fpr.Flush(FLUSH_MAINTAIN_STATE);
+	WriteIdleLoopSkip(*js.op);
 	WriteExit(destination, inst.LK, js.compilerPC + 4);
 
 	if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
@@ -172,7 +186,7 @@ void Jit64::bcctrx(UGeckoInstruction inst)
 		if (inst.LK_3)
 			MOV(32, PPCSTATE_LR, Imm32(js.compilerPC + 4)); // LR = PC + 4;
 		AND(32, R(RSCRATCH), Imm32(0xFFFFFFFC));
-		WriteExitDestInRSCRATCH(inst.LK_3, js.compilerPC + 4);
+		WriteIndirectExit(inst.LK_3, js.compilerPC + 4);
 	}
 	else
 	{
@@ -191,7 +205,7 @@ void Jit64::bcctrx(UGeckoInstruction inst)
 
 		gpr.Flush(FLUSH_MAINTAIN_STATE);
 		fpr.Flush(FLUSH_MAINTAIN_STATE);
-		WriteExitDestInRSCRATCH(inst.LK_3, js.compilerPC + 4);
+		WriteIndirectExit(inst.LK_3, js.compilerPC + 4);
 		// Would really like to continue the block here, but it ends. TODO.
 		SetJumpTarget(b);
 
@@ -365,6 +365,7 @@ void Jit64::DoMergedBranch()
 			destination = SignExt16(next.BD << 2);
 		else
 			destination = nextPC + SignExt16(next.BD << 2);
+		WriteIdleLoopSkip(js.op[1]);
 		WriteExit(destination, next.LK, nextPC + 4);
 	}
 	else if ((next.OPCD == 19) && (next.SUBOP10 == 528)) // bcctrx
@@ -253,12 +253,13 @@ void JitIL::Init()
 	jo.accurateSinglePrecision = false;
 	UpdateMemoryOptions();
 
-	trampolines.Init(jo.memcheck ? TRAMPOLINE_CODE_SIZE_MMU : TRAMPOLINE_CODE_SIZE);
-	AllocCodeSpace(CODE_SIZE);
+	const int scale = GetCodeCacheScale();
+	trampolines.Init((jo.memcheck ? TRAMPOLINE_CODE_SIZE_MMU : TRAMPOLINE_CODE_SIZE) * scale);
+	AllocCodeSpace(CODE_SIZE * scale);
 	blocks.Init();
 	asm_routines.Init(nullptr);
 
-	farcode.Init(jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE);
+	farcode.Init((jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE) * scale);
 	Clear();
 
 	code_block.m_stats = &js.st;
@@ -466,7 +467,7 @@ void JitIL::Jit(u32 em_address)
 	if (IsAlmostFull() || farcode.IsAlmostFull() || trampolines.IsAlmostFull() || blocks.IsFull() ||
 		SConfig::GetInstance().bJITNoBlockCache)
 	{
-		ClearCache();
+		ClearFullCache();
 	}
 
 	int blockSize = code_buffer.GetSize();
@@ -55,6 +55,7 @@ void JitArm64::Init()
 	code_block.m_gpa = &js.gpa;
 	code_block.m_fpa = &js.fpa;
 	analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+	InitAnalysisWorker(code_buffer.GetSize());
 
 	m_supports_cycle_counter = HasCycleCounters();
 }
@@ -74,6 +75,7 @@ void JitArm64::ClearCache()
 
 void JitArm64::Shutdown()
 {
+	analysis_worker.Shutdown();
 	FreeCodeSpace();
 	blocks.Shutdown();
 }
@@ -359,15 +361,14 @@ void JitArm64::SingleStep()
 	pExecAddr();
 }
 
-void JitArm64::Jit(u32)
+void JitArm64::Jit(u32 em_address)
 {
 	if (IsAlmostFull() || farcode.IsAlmostFull() || blocks.IsFull() || SConfig::GetInstance().bJITNoBlockCache)
 	{
-		ClearCache();
+		ClearFullCache();
 	}
 
 	int blockSize = code_buffer.GetSize();
-	u32 em_address = PowerPC::ppcState.pc;
 
 	if (SConfig::GetInstance().bEnableDebugging)
 	{
@@ -377,7 +378,7 @@ void JitArm64::Jit(u32)
 
 	// Analyze the block, collect all instructions it is made of (including inlining,
 	// if that is enabled), reorder instructions for optimal performance, and join joinable instructions.
-	u32 nextPC = analyzer.Analyze(em_address, &code_block, &code_buffer, blockSize);
+	u32 nextPC = AnalyzeBlock(em_address, &code_buffer, blockSize);
 
 	if (code_block.m_memory_exception)
 	{
@@ -393,6 +394,7 @@ void JitArm64::Jit(u32)
 	JitBlock *b = blocks.GetBlock(block_num);
 	const u8* BlockPtr = DoJit(em_address, &code_buffer, b, nextPC);
 	blocks.FinalizeBlock(block_num, jo.enableBlocklink, BlockPtr);
+	RequestExitAnalysis(*b, blockSize);
 }
 
 const u8* JitArm64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBlock *b, u32 nextPC)
@@ -108,9 +108,7 @@ public:
 	void mfmsr(UGeckoInstruction inst);
 	void mcrf(UGeckoInstruction inst);
 	void mfsr(UGeckoInstruction inst);
-	void mtsr(UGeckoInstruction inst);
 	void mfsrin(UGeckoInstruction inst);
-	void mtsrin(UGeckoInstruction inst);
 	void twx(UGeckoInstruction inst);
 	void mfspr(UGeckoInstruction inst);
 	void mftb(UGeckoInstruction inst);
@@ -144,7 +142,6 @@ public:
 	void ps_maddXX(UGeckoInstruction inst);
 	void ps_mergeXX(UGeckoInstruction inst);
 	void ps_mulsX(UGeckoInstruction inst);
-	void ps_res(UGeckoInstruction inst);
 	void ps_sel(UGeckoInstruction inst);
 	void ps_sumX(UGeckoInstruction inst);
 
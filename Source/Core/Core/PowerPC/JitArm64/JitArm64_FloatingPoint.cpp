@@ -211,12 +211,33 @@ void JitArm64::fcmpX(UGeckoInstruction inst)
 	u32 a = inst.FA, b = inst.FB;
 	int crf = inst.CRFD;
 
-	bool singles = fpr.IsSingle(a, true) && fpr.IsSingle(b, true);
+	// ps_cmpu1 and ps_cmpo1 compare the upper halves of the pairs
+	bool upper = inst.OPCD == 4 && (inst.SUBOP10 & 64);
+
+	bool singles = upper ? fpr.IsSingle(a) && fpr.IsSingle(b) :
+	                       fpr.IsSingle(a, true) && fpr.IsSingle(b, true);
 	RegType type = singles ? REG_LOWER_PAIR_SINGLE : REG_LOWER_PAIR;
+	if (upper)
+		type = singles ? REG_REG_SINGLE : REG_REG;
 	ARM64Reg (*reg_encoder)(ARM64Reg) = singles ? EncodeRegToSingle : EncodeRegToDouble;
 
-	ARM64Reg VA = reg_encoder(fpr.R(a, type));
-	ARM64Reg VB = reg_encoder(fpr.R(b, type));
+	ARM64Reg VA = fpr.R(a, type);
+	ARM64Reg VB = fpr.R(b, type);
+
+	ARM64Reg V0Q = INVALID_REG, V1Q = INVALID_REG;
+	if (upper)
+	{
+		u8 size = singles ? 32 : 64;
+		V0Q = fpr.GetReg();
+		V1Q = fpr.GetReg();
+		m_float_emit.DUP(size, V0Q, EncodeRegToQuad(VA), 1);
+		m_float_emit.DUP(size, V1Q, EncodeRegToQuad(VB), 1);
+		VA = V0Q;
+		VB = V1Q;
+	}
+
+	VA = reg_encoder(VA);
+	VB = reg_encoder(VB);
 
 	ARM64Reg WA = gpr.GetReg();
 	ARM64Reg XA = EncodeRegTo64(WA);
@@ -266,6 +287,8 @@ void JitArm64::fcmpX(UGeckoInstruction inst)
 	STR(INDEX_UNSIGNED, XA, PPC_REG, PPCSTATE_OFF(cr_val[0]) + (sizeof(PowerPC::ppcState.cr_val[0]) * crf));
 
 	gpr.Unlock(WA);
+	if (upper)
+		fpr.Unlock(V0Q, V1Q);
 }
 
 void JitArm64::fctiwzx(UGeckoInstruction inst)
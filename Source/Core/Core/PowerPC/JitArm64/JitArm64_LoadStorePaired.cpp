@@ -29,8 +29,13 @@ void JitArm64::psq_l(UGeckoInstruction inst)
 	// X2 is a temporary
 	// Q0 is the return register
 	// Q1 is a temporary
-	bool update = inst.OPCD == 57;
+	// Also handles the indexed forms (psq_lx, psq_lux), which take the
+	// GQR and W bits from different fields.
+	bool indexed = inst.OPCD == 4;
+	bool update = indexed ? !!(inst.SUBOP6 & 32) : inst.OPCD == 57;
 	s32 offset = inst.SIMM_12;
+	u32 gqr = indexed ? inst.Ix : inst.I;
+	bool w = indexed ? !!inst.Wx : !!inst.W;
 
 	gpr.Lock(W0, W1, W2, W30);
 	fpr.Lock(Q0, Q1);
@@ -41,7 +46,14 @@ void JitArm64::psq_l(UGeckoInstruction inst)
 	ARM64Reg type_reg = W2;
 	ARM64Reg VS;
 
-	if (inst.RA || update) // Always uses the register on update
+	if (indexed)
+	{
+		if (inst.RA || update)
+			ADD(addr_reg, arm_addr, gpr.R(inst.RB));
+		else
+			MOV(addr_reg, gpr.R(inst.RB));
+	}
+	else if (inst.RA || update) // Always uses the register on update
 	{
 		if (offset >= 0)
 			ADD(addr_reg, arm_addr, offset);
@@ -62,7 +74,7 @@ void JitArm64::psq_l(UGeckoInstruction inst)
 	if (js.assumeNoPairedQuantize)
 	{
 		VS = fpr.RW(inst.RS, REG_REG_SINGLE);
-		if (!inst.W)
+		if (!w)
 		{
 			ADD(EncodeRegTo64(addr_reg), EncodeRegTo64(addr_reg), MEM_REG);
 			m_float_emit.LD1(32, 1, EncodeRegToDouble(VS), EncodeRegTo64(addr_reg));
@@ -75,11 +87,11 @@ void JitArm64::psq_l(UGeckoInstruction inst)
 	}
 	else
 	{
-		LDR(INDEX_UNSIGNED, scale_reg, PPC_REG, PPCSTATE_OFF(spr[SPR_GQR0 + inst.I]));
+		LDR(INDEX_UNSIGNED, scale_reg, PPC_REG, PPCSTATE_OFF(spr[SPR_GQR0 + gqr]));
 		UBFM(type_reg, scale_reg, 16, 18); // Type
 		UBFM(scale_reg, scale_reg, 24, 29); // Scale
 
-		MOVI2R(X30, (u64)&pairedLoadQuantized[inst.W * 8]);
+		MOVI2R(X30, (u64)&pairedLoadQuantized[w * 8]);
 		LDR(X30, X30, ArithOption(EncodeRegTo64(type_reg), true));
 		BLR(X30);
 
@@ -87,7 +99,7 @@ void JitArm64::psq_l(UGeckoInstruction inst)
 		m_float_emit.ORR(EncodeRegToDouble(VS), D0, D0);
 	}
 
-	if (inst.W)
+	if (w)
 	{
 		m_float_emit.FMOV(S0, 0x70); // 1.0 as a Single
 		m_float_emit.INS(32, VS, 1, Q0, 0);
@@ -108,8 +120,13 @@ void JitArm64::psq_st(UGeckoInstruction inst)
 	// X1 is the address
 	// Q0 is the store register
 
-	bool update = inst.OPCD == 61;
+	// Also handles the indexed forms (psq_stx, psq_stux), which take the
+	// GQR and W bits from different fields.
+	bool indexed = inst.OPCD == 4;
+	bool update = indexed ? !!(inst.SUBOP6 & 32) : inst.OPCD == 61;
 	s32 offset = inst.SIMM_12;
+	u32 gqr = indexed ? inst.Ix : inst.I;
+	bool w = indexed ? !!inst.Wx : !!inst.W;
 
 	gpr.Lock(W0, W1, W2, W30);
 	fpr.Lock(Q0, Q1);
@@ -130,7 +147,14 @@ void JitArm64::psq_st(UGeckoInstruction inst)
 	gprs_in_use &= BitSet32(~7);
 	fprs_in_use &= BitSet32(~3);
 
-	if (inst.RA || update) // Always uses the register on update
+	if (indexed)
+	{
+		if (inst.RA || update)
+			ADD(addr_reg, gpr.R(inst.RA), gpr.R(inst.RB));
+		else
+			MOV(addr_reg, gpr.R(inst.RB));
+	}
+	else if (inst.RA || update) // Always uses the register on update
 	{
 		if (offset >= 0)
 			ADD(addr_reg, gpr.R(inst.RA), offset);
@@ -153,9 +177,9 @@ void JitArm64::psq_st(UGeckoInstruction inst)
 		u32 flags = BackPatchInfo::FLAG_STORE;
 
 		if (single)
-			flags |= (inst.W ? BackPatchInfo::FLAG_SIZE_F32I : BackPatchInfo::FLAG_SIZE_F32X2I);
+			flags |= (w ? BackPatchInfo::FLAG_SIZE_F32I : BackPatchInfo::FLAG_SIZE_F32X2I);
 		else
-			flags |= (inst.W ? BackPatchInfo::FLAG_SIZE_F32 : BackPatchInfo::FLAG_SIZE_F32X2);
+			flags |= (w ? BackPatchInfo::FLAG_SIZE_F32 : BackPatchInfo::FLAG_SIZE_F32X2);
 
 		EmitBackpatchRoutine(flags,
 			jo.fastmem,
@@ -172,13 +196,13 @@ void JitArm64::psq_st(UGeckoInstruction inst)
 		}
 		else
 		{
-			if (inst.W)
+			if (w)
 				m_float_emit.FCVT(32, 64, D0, VS);
 			else
 				m_float_emit.FCVTN(32, D0, VS);
 		}
 
-		LDR(INDEX_UNSIGNED, scale_reg, PPC_REG, PPCSTATE_OFF(spr[SPR_GQR0 + inst.I]));
+		LDR(INDEX_UNSIGNED, scale_reg, PPC_REG, PPCSTATE_OFF(spr[SPR_GQR0 + gqr]));
 		UBFM(type_reg, scale_reg, 0, 2); // Type
 		UBFM(scale_reg, scale_reg, 8, 13); // Scale
 
@@ -190,7 +214,7 @@ void JitArm64::psq_st(UGeckoInstruction inst)
 		SwitchToFarCode();
 			SetJumpTarget(fail);
 			// Slow
-			MOVI2R(X30, (u64)&pairedStoreQuantized[16 + inst.W * 8]);
+			MOVI2R(X30, (u64)&pairedStoreQuantized[16 + w * 8]);
 			LDR(EncodeRegTo64(type_reg), X30, ArithOption(EncodeRegTo64(type_reg), true));
 
 			ABI_PushRegisters(gprs_in_use);
@@ -203,7 +227,7 @@ void JitArm64::psq_st(UGeckoInstruction inst)
 		SetJumpTarget(pass);
 
 		// Fast
-		MOVI2R(X30, (u64)&pairedStoreQuantized[inst.W * 8]);
+		MOVI2R(X30, (u64)&pairedStoreQuantized[w * 8]);
 		LDR(EncodeRegTo64(type_reg), X30, ArithOption(EncodeRegTo64(type_reg), true));
 		BLR(EncodeRegTo64(type_reg));
 
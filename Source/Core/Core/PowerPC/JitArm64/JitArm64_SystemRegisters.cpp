@@ -93,15 +93,6 @@ void JitArm64::mfsr(UGeckoInstruction inst)
 	LDR(INDEX_UNSIGNED, gpr.R(inst.RD), PPC_REG, PPCSTATE_OFF(sr[inst.SR]));
 }
 
-void JitArm64::mtsr(UGeckoInstruction inst)
-{
-	INSTRUCTION_START
-	JITDISABLE(bJITSystemRegistersOff);
-
-	gpr.BindToRegister(inst.RS, true);
-	STR(INDEX_UNSIGNED, gpr.R(inst.RS), PPC_REG, PPCSTATE_OFF(sr[inst.SR]));
-}
-
 void JitArm64::mfsrin(UGeckoInstruction inst)
 {
 	INSTRUCTION_START
@@ -121,25 +112,6 @@ void JitArm64::mfsrin(UGeckoInstruction inst)
 	gpr.Unlock(index);
 }
 
-void JitArm64::mtsrin(UGeckoInstruction inst)
-{
-	INSTRUCTION_START
-	JITDISABLE(bJITSystemRegistersOff);
-
-	u32 b = inst.RB, d = inst.RD;
-	gpr.BindToRegister(d, d == b);
-
-	ARM64Reg index = gpr.GetReg();
-	ARM64Reg index64 = EncodeRegTo64(index);
-	ARM64Reg RB = gpr.R(b);
-
-	UBFM(index, RB, 28, 31);
-	ADD(index64, PPC_REG, index64, ArithOption(index64, ST_LSL, 2));
-	STR(INDEX_UNSIGNED, gpr.R(d), index64, PPCSTATE_OFF(sr[0]));
-
-	gpr.Unlock(index);
-}
-
 void JitArm64::twx(UGeckoInstruction inst)
 {
 	INSTRUCTION_START
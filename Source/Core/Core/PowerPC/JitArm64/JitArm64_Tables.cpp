@@ -102,14 +102,14 @@ static GekkoOPTemplate primarytable[] =
 
 static GekkoOPTemplate table4[] =
 {    //SUBOP10
-	{0,    &JitArm64::FallBackToInterpreter},   // ps_cmpu0
-	{32,   &JitArm64::FallBackToInterpreter},   // ps_cmpo0
+	{0,    &JitArm64::fcmpX},                   // ps_cmpu0
+	{32,   &JitArm64::fcmpX},                   // ps_cmpo0
 	{40,   &JitArm64::fp_logic},                // ps_neg
 	{136,  &JitArm64::fp_logic},                // ps_nabs
 	{264,  &JitArm64::fp_logic},                // ps_abs
-	{64,   &JitArm64::FallBackToInterpreter},   // ps_cmpu1
+	{64,   &JitArm64::fcmpX},                   // ps_cmpu1
 	{72,   &JitArm64::fp_logic},                // ps_mr
-	{96,   &JitArm64::FallBackToInterpreter},   // ps_cmpo1
+	{96,   &JitArm64::fcmpX},                   // ps_cmpo1
 	{528,  &JitArm64::ps_mergeXX},              // ps_merge00
 	{560,  &JitArm64::ps_mergeXX},              // ps_merge01
 	{592,  &JitArm64::ps_mergeXX},              // ps_merge10
@@ -130,7 +130,7 @@ static GekkoOPTemplate table4_2[] =
 	{20, &JitArm64::fp_arith},                  // ps_sub
 	{21, &JitArm64::fp_arith},                  // ps_add
 	{23, &JitArm64::ps_sel},                    // ps_sel
-	{24, &JitArm64::ps_res},                    // ps_res
+	{24, &JitArm64::FallBackToInterpreter},     // ps_res
 	{25, &JitArm64::fp_arith},                  // ps_mul
 	{26, &JitArm64::FallBackToInterpreter},     // ps_rsqrte
 	{28, &JitArm64::ps_maddXX},                 // ps_msub
@@ -142,10 +142,10 @@ static GekkoOPTemplate table4_2[] =
 
 static GekkoOPTemplate table4_3[] =
 {
-	{6,  &JitArm64::FallBackToInterpreter},     // psq_lx
-	{7,  &JitArm64::FallBackToInterpreter},     // psq_stx
-	{38, &JitArm64::FallBackToInterpreter},     // psq_lux
-	{39, &JitArm64::FallBackToInterpreter},     // psq_stux
+	{6,  &JitArm64::psq_l},                     // psq_lx
+	{7,  &JitArm64::psq_st},                    // psq_stx
+	{38, &JitArm64::psq_l},                     // psq_lux
+	{39, &JitArm64::psq_st},                    // psq_stux
 };
 
 static GekkoOPTemplate table19[] =
@@ -290,8 +290,8 @@ static GekkoOPTemplate table31[] =
 	{83,  &JitArm64::mfmsr},                    // mfmsr
 	{144, &JitArm64::mtcrf},                    // mtcrf
 	{146, &JitArm64::mtmsr},                    // mtmsr
-	{210, &JitArm64::mtsr},                     // mtsr
-	{242, &JitArm64::mtsrin},                   // mtsrin
+	{210, &JitArm64::FallBackToInterpreter},    // mtsr
+	{242, &JitArm64::FallBackToInterpreter},    // mtsrin
 	{339, &JitArm64::mfspr},                    // mfspr
 	{467, &JitArm64::mtspr},                    // mtspr
 	{371, &JitArm64::mftb},                     // mftb
@@ -90,6 +90,7 @@ void JitArm64::GenerateAsm()
 		SetJumpTarget(JitBlock);
 
 		STR(INDEX_UNSIGNED, DISPATCHER_PC, PPC_REG, PPCSTATE_OFF(pc));
+		MOV(W0, DISPATCHER_PC);
 		MOVI2R(X30, (u64)&::Jit);
 		BLR(X30);
 
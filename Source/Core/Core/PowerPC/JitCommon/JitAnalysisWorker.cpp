@@ -0,0 +1,145 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/Thread.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/JitCommon/JitAnalysisWorker.h"
+
+// Keep the queue short: targets are only useful if they are analyzed before the CPU gets there.
+static const size_t MAX_QUEUED_JOBS = 256;
+static const size_t MAX_RESULTS = 4096;
+
+void JitAnalysisWorker::Init(int buffer_size)
+{
+	Shutdown();
+	m_buffer_size = buffer_size;
+	m_buffer = std::make_unique<PPCAnalyst::CodeBuffer>(buffer_size);
+	m_exit = false;
+	m_thread = std::thread(&JitAnalysisWorker::ThreadMain, this);
+}
+
+void JitAnalysisWorker::Shutdown()
+{
+	if (!m_thread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lk(m_lock);
+		m_exit = true;
+	}
+	m_wakeup.notify_one();
+	m_thread.join();
+	Clear();
+	m_buffer.reset();
+}
+
+void JitAnalysisWorker::Clear()
+{
+	std::lock_guard<std::mutex> lk(m_lock);
+	m_queue.clear();
+	m_queued.clear();
+	m_results.clear();
+}
+
+void JitAnalysisWorker::Request(u32 address, u32 options, u32 block_size)
+{
+	if (!IsRunning() || block_size > static_cast<u32>(m_buffer_size))
+		return;
+	{
+		std::lock_guard<std::mutex> lk(m_lock);
+		if (m_queue.size() >= MAX_QUEUED_JOBS || m_results.count(address) || !m_queued.insert(address).second)
+			return;
+		m_queue.push_back({ address, options, block_size });
+	}
+	m_wakeup.notify_one();
+}
+
+bool JitAnalysisWorker::Take(u32 address, u32 options, u32 block_size, PPCAnalyst::CodeBlock* block,
+	PPCAnalyst::CodeBuffer* buffer, u32* next_pc)
+{
+	if (!IsRunning())
+		return false;
+
+	Result result;
+	{
+		std::lock_guard<std::mutex> lk(m_lock);
+		auto it = m_results.find(address);
+		if (it == m_results.end())
+			return false;
+		result = std::move(it->second);
+		m_results.erase(it);
+	}
+
+	if (result.options != options || result.block_size != block_size ||
+		result.ops.size() > static_cast<size_t>(buffer->GetSize()))
+		return false;
+
+	// The guest may have overwritten the code since it was analyzed.
+	for (const PPCAnalyst::CodeOp& op : result.ops)
+	{
+		auto read = PowerPC::TryReadInstruction(op.address);
+		if (!read.valid || read.hex != op.inst.hex)
+			return false;
+	}
+
+	std::copy(result.ops.begin(), result.ops.end(), buffer->codebuffer);
+	*block->m_stats = result.stats;
+	*block->m_gpa = result.gpa;
+	*block->m_fpa = result.fpa;
+	block->m_address = address;
+	block->m_num_instructions = static_cast<u32>(result.ops.size());
+	block->m_broken = false;
+	block->m_memory_exception = false;
+	block->m_gqr_used = result.gqr_used;
+	block->m_gqr_modified = result.gqr_modified;
+	*next_pc = result.next_pc;
+	return true;
+}
+
+void JitAnalysisWorker::ThreadMain()
+{
+	Common::SetCurrentThreadName("JIT analysis");
+
+	PPCAnalyst::PPCAnalyzer analyzer;
+	PPCAnalyst::CodeBlock block;
+	Result result;
+	block.m_stats = &result.stats;
+	block.m_gpa = &result.gpa;
+	block.m_fpa = &result.fpa;
+
+	std::unique_lock<std::mutex> lk(m_lock);
+	while (true)
+	{
+		m_wakeup.wait(lk, [this] { return m_exit || !m_queue.empty(); });
+		if (m_exit)
+			return;
+
+		Job job = m_queue.front();
+		m_queue.pop_front();
+		lk.unlock();
+
+		analyzer.SetOptions(job.options);
+		result.next_pc = analyzer.Analyze(job.address, &block, m_buffer.get(), job.block_size);
+
+		// Blocks that hit a translation failure or the size limit depend on more than their
+		// instructions, so they are left to the CPU thread.
+		bool usable = !block.m_memory_exception && !block.m_broken;
+		if (usable)
+		{
+			result.options = job.options;
+			result.block_size = job.block_size;
+			result.gqr_used = block.m_gqr_used;
+			result.gqr_modified = block.m_gqr_modified;
+			result.ops.assign(m_buffer->codebuffer, m_buffer->codebuffer + block.m_num_instructions);
+		}
+
+		lk.lock();
+		m_queued.erase(job.address);
+		if (usable)
+		{
+			if (m_results.size() >= MAX_RESULTS)
+				m_results.clear();
+			m_results[job.address] = result;
+		}
+	}
+}
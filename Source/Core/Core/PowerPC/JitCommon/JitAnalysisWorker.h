@@ -0,0 +1,78 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+
+// Runs the PPCAnalyst front end of the JIT on a worker thread.
+// After a block is compiled, the targets of its exits that have no block yet are queued,
+// so that by the time the CPU thread reaches them the analysis is usually done and only
+// code emission and linking are left. Results are verified against guest memory before use.
+class JitAnalysisWorker final
+{
+public:
+	JitAnalysisWorker() = default;
+	~JitAnalysisWorker() { Shutdown(); }
+
+	void Init(int buffer_size);
+	void Shutdown();
+	bool IsRunning() const { return m_thread.joinable(); }
+
+	// Drops all queued requests and finished results.
+	void Clear();
+
+	// Called on the CPU thread. Queues the analysis of the block starting at address.
+	void Request(u32 address, u32 options, u32 block_size);
+
+	// Called on the CPU thread. If the block was analyzed with the same options and its
+	// instructions are unchanged, copies the analysis into block/buffer and returns true.
+	bool Take(u32 address, u32 options, u32 block_size, PPCAnalyst::CodeBlock* block,
+		PPCAnalyst::CodeBuffer* buffer, u32* next_pc);
+
+private:
+	struct Job
+	{
+		u32 address;
+		u32 options;
+		u32 block_size;
+	};
+
+	struct Result
+	{
+		u32 options;
+		u32 block_size;
+		u32 next_pc;
+		PPCAnalyst::BlockStats stats;
+		PPCAnalyst::BlockRegStats gpa;
+		PPCAnalyst::BlockRegStats fpa;
+		BitSet8 gqr_used;
+		BitSet8 gqr_modified;
+		std::vector<PPCAnalyst::CodeOp> ops;
+	};
+
+	void ThreadMain();
+
+	std::thread m_thread;
+	std::mutex m_lock;
+	std::condition_variable m_wakeup;
+	bool m_exit = false;
+
+	std::deque<Job> m_queue;
+	std::unordered_set<u32> m_queued;
+	std::unordered_map<u32, Result> m_results;
+
+	std::unique_ptr<PPCAnalyst::CodeBuffer> m_buffer;
+	int m_buffer_size = 0;
+};
@@ -15,6 +15,7 @@
 #include "Common/x64Analyzer.h"
 #include "Common/x64Emitter.h"
 #include "Core/HW/Memmap.h"
+#include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 using namespace Gen;
@@ -186,6 +187,16 @@ bool Jitx86Base::BackPatch(u32 emAddress, SContext* ctx)
 	}
 	else
 	{
+		// A load that faulted on an MMIO register will most likely keep doing so. Remember the
+		// address and recompile the block, so the next version inlines the MMIO handler.
+		auto it3 = pcAtLoc.find(codePtr);
+		if (it3 != pcAtLoc.end() && info.operandSize < 8 && !jit->jo.memcheck &&
+			PowerPC::IsOptimizableMMIOAccess(emAddress, info.operandSize * 8) &&
+			jit->js.mmioLoadAddresses.emplace(it3->second, emAddress).second)
+		{
+			jit->GetBlockCache()->InvalidateICache(it3->second, 4, true);
+		}
+
 		trampoline = trampolines.GenerateReadTrampoline(info, registersInUse, exceptionHandler, returnPtr);
 	}
 
@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 
@@ -10,6 +11,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/GekkoDisassembler.h"
 #include "Common/StringUtil.h"
+#include "Common/Timer.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/CPU.h"
@@ -19,9 +21,62 @@
 
 JitBase *jit;
 
+void JitBase::InitAnalysisWorker(int buffer_size)
+{
+	// Guest instructions are read without locking, which is only safe without MMU emulation
+	// (no TLB state is touched).
+	if (SConfig::GetInstance().bJITBackgroundAnalysis && !SConfig::GetInstance().bMMU &&
+		!SConfig::GetInstance().bEnableDebugging)
+		analysis_worker.Init(buffer_size);
+}
+
+u32 JitBase::AnalyzeBlock(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, u32 block_size)
+{
+	u32 next_pc;
+	if (analysis_worker.Take(em_address, analyzer.GetOptions(), block_size, &code_block, code_buf, &next_pc))
+		return next_pc;
+	return analyzer.Analyze(em_address, &code_block, code_buf, block_size);
+}
+
+void JitBase::RequestExitAnalysis(const JitBlock& block, u32 block_size)
+{
+	if (!analysis_worker.IsRunning())
+		return;
+	for (const JitBlock::LinkData& link : block.linkData)
+	{
+		if (GetBlockCache()->GetBlockNumberFromStartAddress(link.exitAddress) < 0)
+			analysis_worker.Request(link.exitAddress, analyzer.GetOptions(), block_size);
+	}
+}
+
+void JitBase::ClearFullCache()
+{
+	std::unordered_set<u32> fifo_writes = std::move(js.fifoWriteAddresses);
+	std::unordered_set<u32> paired_quantizes = std::move(js.pairedQuantizeAddresses);
+	std::unordered_set<u32> hot_blocks = std::move(js.hotBlockAddresses);
+	std::unordered_map<u32, u32> mmio_loads = std::move(js.mmioLoadAddresses);
+
+	ClearCache();
+
+	js.fifoWriteAddresses = std::move(fifo_writes);
+	js.pairedQuantizeAddresses = std::move(paired_quantizes);
+	js.hotBlockAddresses = std::move(hot_blocks);
+	js.mmioLoadAddresses = std::move(mmio_loads);
+}
+
+int JitBase::GetCodeCacheScale()
+{
+	// Everything is reached with rel32 jumps, so stay well inside 2 GiB.
+	int scale = SConfig::GetInstance().iJITCodeCacheSize / (CODE_SIZE / (1024 * 1024));
+	return std::min(std::max(scale, 1), 8);
+}
+
 void Jit(u32 em_address)
 {
+	const u64 begin_us = Common::Timer::GetTimeUs();
 	jit->Jit(em_address);
+	jit->compile_stats.blocks++;
+	jit->compile_stats.time_us += Common::Timer::GetTimeUs() - begin_us;
 }
 
 u32 Helper_Mask(u8 mb, u8 me)
@@ -8,6 +8,7 @@
 //#define JIT_LOG_GPR     // Enables logging of the PPC general purpose regs
 //#define JIT_LOG_FPR     // Enables logging of the PPC floating point regs
 
+#include <unordered_map>
 #include <unordered_set>
 
 #include "Common/CommonTypes.h"
@@ -17,6 +18,7 @@
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/Jit64Common/Jit64AsmCommon.h"
+#include "Core/PowerPC/JitCommon/JitAnalysisWorker.h"
 #include "Core/PowerPC/JitCommon/Jit_Util.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
 #include "Core/PowerPC/JitCommon/TrampolineCache.h"
@@ -97,20 +99,47 @@ protected:
 
 		std::unordered_set<u32> fifoWriteAddresses;
 		std::unordered_set<u32> pairedQuantizeAddresses;
+		// Start addresses of blocks that ran often enough to be compiled with all optimizations.
+		std::unordered_set<u32> hotBlockAddresses;
+		// Guest address last seen by loads that faulted on an MMIO register, keyed by their PC.
+		std::unordered_map<u32, u32> mmioLoadAddresses;
 	};
 
 	PPCAnalyst::CodeBlock code_block;
 	PPCAnalyst::PPCAnalyzer analyzer;
+	JitAnalysisWorker analysis_worker;
+
+	// Starts the background analysis of block exit targets if it is enabled and safe to use.
+	void InitAnalysisWorker(int buffer_size);
+	// Analyzes a block, using the result of the background analysis if there is one.
+	u32 AnalyzeBlock(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, u32 block_size);
+	// Queues the exit targets of a freshly compiled block that are not compiled yet.
+	void RequestExitAnalysis(const JitBlock& block, u32 block_size);
 
 	bool MergeAllowedNextInstructions(int count);
 
 	void UpdateMemoryOptions();
 
+	// Clears the cache because it ran out of space. Unlike ClearCache, what was learnt about the
+	// guest code (FIFO writes, hot blocks, ...) is kept, since it is still valid.
+	void ClearFullCache();
+
+	// How many times the default code, far code and trampoline space the x86 JITs allocate.
+	static int GetCodeCacheScale();
+
 public:
 	// This should probably be removed from public:
 	JitOptions jo;
 	JitState js;
 
+	// Blocks compiled through Jit() and the wall clock time that took
+	struct CompileStats
+	{
+		u64 blocks = 0;
+		u64 time_us = 0;
+	};
+	CompileStats compile_stats;
+
 	virtual JitBaseBlockCache *GetBlockCache() = 0;
 
 	virtual void Jit(u32 em_address) = 0;
@@ -9,6 +9,7 @@
 // performance hit, it's not enabled by default, but it's useful for
 // locating performance issues.
 
+#include <algorithm>
 #include <cstring>
 #include <map>
 #include <utility>
@@ -70,12 +71,15 @@ void JitBaseBlockCache::Clear()
 #endif
 	jit->js.fifoWriteAddresses.clear();
 	jit->js.pairedQuantizeAddresses.clear();
+	jit->js.hotBlockAddresses.clear();
+	jit->js.mmioLoadAddresses.clear();
 	for (int i = 0; i < num_blocks; i++)
 	{
 		DestroyBlock(i, false);
 	}
 	links_to.clear();
 	block_map.clear();
+	trace_blocks.clear();
 
 	valid_block.ClearAll();
 
@@ -104,6 +108,8 @@ int JitBaseBlockCache::AllocateBlock(u32 em_address)
 	JitBlock &b = blocks[num_blocks];
 	b.invalid = false;
 	b.originalAddress = em_address;
+	b.tierUpCounter = 0;
+	b.followsBranches = false;
 	b.linkData.clear();
 	num_blocks++; //commit the current block
 	return num_blocks - 1;
@@ -122,7 +128,10 @@ void JitBaseBlockCache::FinalizeBlock(int block_num, bool block_link, const u8 *
 	for (u32 block = pAddr / 32; block <= (pAddr + (b.originalSize - 1) * 4) / 32; ++block)
 		valid_block.Set(block);
 
-	block_map[std::make_pair(pAddr + 4 * b.originalSize - 1, pAddr)] = block_num;
+	if (b.followsBranches)
+		trace_blocks.push_back(block_num);
+	else
+		block_map[std::make_pair(pAddr + 4 * b.originalSize - 1, pAddr)] = block_num;
 
 	if (block_link)
 	{
@@ -282,11 +291,36 @@ void JitBaseBlockCache::InvalidateICache(u32 address, const u32 length, bool for
 		else
 			valid_block.Clear(pAddr / 32);
 	}
+	else if (length != 0 && trace_blocks.empty())
+	{
+		// DMA and overlay loads invalidate large ranges which usually hold no code at all, so
+		// skip the block map search unless a block touches one of the covered 32 byte lines.
+		// Blocks following branches don't mark all the code they cover, so this is only done
+		// without them.
+		u32 last = std::min(pAddr + length - 1, 0x1FFFFFFFu);
+		destroy_block = valid_block.TestRange(pAddr / 32, last / 32);
+	}
 
 	// destroy JIT blocks
 	// !! this works correctly under assumption that any two overlapping blocks end at the same address
 	if (destroy_block)
 	{
+		// Blocks following branches break that assumption, so they are checked one by one.
+		for (auto it = trace_blocks.begin(); it != trace_blocks.end();)
+		{
+			JitBlock &b = blocks[*it];
+			u32 start = b.originalAddress & 0x1FFFFFFF;
+			if (start < pAddr + length && start + 4 * b.originalSize > pAddr)
+			{
+				DestroyBlock(*it, true);
+				it = trace_blocks.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
 		std::map<std::pair<u32, u32>, u32>::iterator it1 = block_map.lower_bound(std::make_pair(pAddr, 0)), it2 = it1;
 		while (it2 != block_map.end() && it2->first.second < pAddr + length)
 		{
@@ -311,6 +345,8 @@ void JitBaseBlockCache::InvalidateICache(u32 address, const u32 length, bool for
 			{
 				jit->js.fifoWriteAddresses.erase(i);
 				jit->js.pairedQuantizeAddresses.erase(i);
+				jit->js.hotBlockAddresses.erase(i);
+				jit->js.mmioLoadAddresses.erase(i);
 			}
 		}
 	}
@@ -32,8 +32,12 @@ struct JitBlock
 	u32 codeSize;
 	u32 originalSize;
 	int runCount;  // for profiling.
+	int tierUpCounter;  // executions left until a first tier block is recompiled, 0 if not used.
 
 	bool invalid;
+	// The block continues at the destination of forward branches (PPCAnalyst OPTION_BRANCH_FOLLOW),
+	// so it may overlap other blocks without ending at the same address.
+	bool followsBranches;
 
 	struct LinkData
 	{
@@ -90,6 +94,25 @@ public:
 	{
 		return (m_valid_block[bit / 32] & (1u << (bit % 32))) != 0;
 	}
+
+	// Whether any bit in [first, last] is set, checking whole words at a time
+	bool TestRange(u32 first, u32 last)
+	{
+		u32 first_word = first / 32;
+		u32 last_word = last / 32;
+		u32 first_mask = ~0u << (first % 32);
+		u32 last_mask = ~0u >> (31 - last % 32);
+		if (first_word == last_word)
+			return (m_valid_block[first_word] & first_mask & last_mask) != 0;
+		if (m_valid_block[first_word] & first_mask)
+			return true;
+		for (u32 word = first_word + 1; word < last_word; ++word)
+		{
+			if (m_valid_block[word])
+				return true;
+		}
+		return (m_valid_block[last_word] & last_mask) != 0;
+	}
 };
 
 class JitBaseBlockCache
@@ -97,6 +120,7 @@ class JitBaseBlockCache
 	enum
 	{
 		MAX_NUM_BLOCKS = 65536 * 2,
+		MAX_NUM_TRACE_BLOCKS = 4096,
 	};
 
 	std::array<const u8*, MAX_NUM_BLOCKS> blockCodePointers;
@@ -104,6 +128,7 @@ class JitBaseBlockCache
 	int num_blocks;
 	std::multimap<u32, int> links_to;
 	std::map<std::pair<u32, u32>, u32> block_map; // (end_addr, start_addr) -> number
+	std::vector<int> trace_blocks; // blocks with followsBranches, kept out of block_map
 	ValidBlockBitSet valid_block;
 
 	bool m_initialized;
@@ -137,6 +162,7 @@ public:
 	void Reset();
 
 	bool IsFull() const;
+	bool CanAddTraceBlock() const { return trace_blocks.size() < MAX_NUM_TRACE_BLOCKS; }
 
 	// Code Cache
 	JitBlock *GetBlock(int block_num);
@@ -8,6 +8,7 @@
 #include "Common/MathUtil.h"
 #include "Common/x64ABI.h"
 #include "Common/x64Emitter.h"
+#include "Core/HW/GPFifo.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/MMIO.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -237,10 +238,35 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 		!opAddress.IsImm() &&
 		!(flags & (SAFE_LOADSTORE_NO_SWAP | SAFE_LOADSTORE_NO_FASTMEM)))
 	{
+		// If this load hit an MMIO register before, inline the handler behind a check that the
+		// address is still the same, so the common case skips the fault and the trampoline.
+		FixupBranch mmio_exit;
+		bool mmio_guard = false;
+		auto mmio_it = jit->js.mmioLoadAddresses.find(jit->js.compilerPC);
+		if (mmio_it != jit->js.mmioLoadAddresses.end() && accessSize != 64 &&
+			!jit->jo.memcheck && opAddress.IsSimpleReg())
+		{
+			u32 mmioAddress = PowerPC::IsOptimizableMMIOAccess(mmio_it->second, accessSize);
+			if (mmioAddress)
+			{
+				CMP(32, opAddress, Imm32(mmio_it->second - offset));
+				FixupBranch miss = J_CC(CC_NZ, true);
+				MMIOLoadToReg(Memory::mmio_mapping.get(), reg_value, registersInUse,
+					mmioAddress, accessSize, signExtend);
+				mmio_exit = J(true);
+				SetJumpTarget(miss);
+				mmio_guard = true;
+			}
+		}
+
 		u8 *mov = UnsafeLoadToReg(reg_value, opAddress, accessSize, offset, signExtend);
 
 		registersInUseAtLoc[mov] = registersInUse;
+		pcAtLoc[mov] = jit->js.compilerPC;
 		jit->js.fastmemLoadStore = mov;
+
+		if (mmio_guard)
+			SetJumpTarget(mmio_exit);
 		return;
 	}
 
@@ -399,23 +425,13 @@ static OpArg FixImmediate(int accessSize, OpArg arg)
 
 void EmuCodeBlock::UnsafeWriteGatherPipe(int accessSize)
 {
-	// No need to protect these, they don't touch any state
-	// question - should we inline them instead? Pro: Lose a CALL   Con: Code bloat
-	switch (accessSize)
-	{
-	case 8:
-		CALL(jit->GetAsmRoutines()->fifoDirectWrite8);
-		break;
-	case 16:
-		CALL(jit->GetAsmRoutines()->fifoDirectWrite16);
-		break;
-	case 32:
-		CALL(jit->GetAsmRoutines()->fifoDirectWrite32);
-		break;
-	case 64:
-		CALL(jit->GetAsmRoutines()->fifoDirectWrite64);
-		break;
-	}
+	// Same code as the fifoDirectWrite routines, inlined to save the CALL on the FIFO heavy
+	// paths. The value is in RSCRATCH, RSCRATCH2 is clobbered.
+	u32 gather_pipe = (u32)(u64)GPFifo::m_gatherPipe;
+	_assert_msg_(DYNA_REC, gather_pipe <= 0x7FFFFFFF, "Gather pipe not in low 2GB of memory!");
+	MOV(32, R(RSCRATCH2), M(&GPFifo::m_gatherPipeCount));
+	SwapAndStore(accessSize, MDisp(RSCRATCH2, gather_pipe), RSCRATCH);
+	ADD(32, M(&GPFifo::m_gatherPipeCount), Imm8(accessSize >> 3));
 	jit->js.fifoBytesThisBlock += accessSize >> 3;
 }
 
@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <cinttypes>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -12,6 +14,9 @@
 #include "Common/PerformanceCounter.h"
 #endif
 
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/StringUtil.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/PowerPC/CachedInterpreter.h"
@@ -34,6 +39,20 @@
 #endif
 
 static bool bFakeVMEM = false;
+static int s_jit_core = -1;
+
+// Persistent block cache file layout: header, block list, fifo write addresses,
+// paired quantize addresses, hot block addresses.
+static const u32 JIT_CACHE_MAGIC = 0x4843424A; // "JBCH"
+static const u32 JIT_CACHE_VERSION = 2;
+static const u32 JIT_CACHE_MAX_BLOCKS = 0x10000;
+
+struct PersistentBlock
+{
+	u32 address;
+	u32 num_instructions;
+	u32 hash;
+};
 
 namespace JitInterface
 {
@@ -45,6 +64,7 @@ void DoState(PointerWrap &p)
 CPUCoreBase *InitJitCore(int core)
 {
 	bFakeVMEM = !SConfig::GetInstance().bMMU;
+	s_jit_core = core;
 
 	CPUCoreBase *ptr = nullptr;
 	switch (core)
@@ -129,6 +149,12 @@ void WriteProfileResults(const std::string& filename)
 	}
 }
 
+void GetCompileStats(u64* blocks, u64* time_us)
+{
+	*blocks = jit ? jit->compile_stats.blocks : 0;
+	*time_us = jit ? jit->compile_stats.time_us : 0;
+}
+
 void GetProfileResults(ProfileStats* prof_stats)
 {
 	// Can't really do this with no jit core available
@@ -264,6 +290,9 @@ void CompileExceptionCheck(ExceptionType type)
 	case ExceptionType::EXCEPTIONS_PAIRED_QUANTIZE:
 		exception_addresses = &jit->js.pairedQuantizeAddresses;
 		break;
+	case ExceptionType::EXCEPTIONS_HOT_BLOCK:
+		exception_addresses = &jit->js.hotBlockAddresses;
+		break;
 	}
 
 	if (PC != 0 && (exception_addresses->find(PC)) == (exception_addresses->end()))
@@ -277,15 +306,130 @@ void CompileExceptionCheck(ExceptionType type)
 		}
 		exception_addresses->insert(PC);
 
-		// Invalidate the JIT block so that it gets recompiled with the external exception check included.
+		// Invalidate the JIT block so that it gets recompiled with the external exception check included
+		// (or, for hot blocks, with all optimizations).
 		jit->GetBlockCache()->InvalidateICache(PC, 4, true);
 	}
 }
 
+static std::string GetPersistentCachePath()
+{
+	return StringFromFormat("%sJIT/%s_%d.jbc", File::GetUserPath(D_CACHE_IDX).c_str(),
+		SConfig::GetInstance().GetGameID().c_str(), s_jit_core);
+}
+
+// Hashes the instructions the block was compiled from, as far as they are contiguous.
+// Returns false if any of them can not be read with the current translation.
+static bool HashGuestCode(u32 address, u32 num_instructions, u32* hash)
+{
+	std::vector<u32> code(num_instructions);
+	for (u32 i = 0; i < num_instructions; i++)
+	{
+		auto result = PowerPC::TryReadInstruction(address + i * 4);
+		if (!result.valid)
+			return false;
+		code[i] = result.hex;
+	}
+	*hash = HashAdler32(reinterpret_cast<const u8*>(code.data()), code.size() * sizeof(u32));
+	return true;
+}
+
+static bool ReadAddressSet(File::IOFile& f, std::unordered_set<u32>* addresses)
+{
+	u32 count;
+	if (!f.ReadArray(&count, 1) || count > JIT_CACHE_MAX_BLOCKS)
+		return false;
+	std::vector<u32> data(count);
+	if (!f.ReadArray(data.data(), count))
+		return false;
+	addresses->insert(data.begin(), data.end());
+	return true;
+}
+
+static void WriteAddressSet(File::IOFile& f, const std::unordered_set<u32>& addresses)
+{
+	std::vector<u32> data(addresses.begin(), addresses.end());
+	u32 count = static_cast<u32>(data.size());
+	f.WriteArray(&count, 1);
+	f.WriteArray(data.data(), count);
+}
+
+void WarmUpBlockCache()
+{
+	if (!jit || !SConfig::GetInstance().bJITPersistentCache || SConfig::GetInstance().bJITNoBlockCache)
+		return;
+
+	File::IOFile f(GetPersistentCachePath(), "rb");
+	u32 header[3];
+	if (!f || !f.ReadArray(header, 3) || header[0] != JIT_CACHE_MAGIC || header[1] != JIT_CACHE_VERSION ||
+		header[2] > JIT_CACHE_MAX_BLOCKS)
+		return;
+	std::vector<PersistentBlock> saved_blocks(header[2]);
+	if (!f.ReadArray(saved_blocks.data(), saved_blocks.size()) ||
+		!ReadAddressSet(f, &jit->js.fifoWriteAddresses) ||
+		!ReadAddressSet(f, &jit->js.pairedQuantizeAddresses) ||
+		!ReadAddressSet(f, &jit->js.hotBlockAddresses))
+	{
+		jit->js.fifoWriteAddresses.clear();
+		jit->js.pairedQuantizeAddresses.clear();
+		jit->js.hotBlockAddresses.clear();
+		return;
+	}
+
+	// Only compile blocks whose code is already in memory and unchanged. Everything else
+	// would be invalidated by InvalidateICache before it runs anyway.
+	u32 compiled = 0;
+	JitBaseBlockCache* block_cache = jit->GetBlockCache();
+	for (const PersistentBlock& saved : saved_blocks)
+	{
+		u32 hash;
+		if (saved.num_instructions == 0 || block_cache->GetBlockNumberFromStartAddress(saved.address) >= 0 ||
+			!HashGuestCode(saved.address, saved.num_instructions, &hash) || hash != saved.hash)
+			continue;
+		jit->Jit(saved.address);
+		compiled++;
+	}
+	NOTICE_LOG(POWERPC, "Precompiled %u of %zu persisted JIT blocks", compiled, saved_blocks.size());
+}
+
+static void SavePersistentBlockCache()
+{
+	if (!SConfig::GetInstance().bJITPersistentCache || SConfig::GetInstance().GetGameID().empty())
+		return;
+
+	std::vector<PersistentBlock> saved_blocks;
+	JitBaseBlockCache* block_cache = jit->GetBlockCache();
+	for (int i = 0; i < block_cache->GetNumBlocks() && saved_blocks.size() < JIT_CACHE_MAX_BLOCKS; i++)
+	{
+		const JitBlock* block = block_cache->GetBlock(i);
+		PersistentBlock saved;
+		saved.address = block->originalAddress;
+		saved.num_instructions = block->originalSize;
+		if (block->invalid || !HashGuestCode(saved.address, saved.num_instructions, &saved.hash))
+			continue;
+		saved_blocks.push_back(saved);
+	}
+	if (saved_blocks.empty())
+		return;
+
+	std::string path = GetPersistentCachePath();
+	File::CreateFullPath(path);
+	File::IOFile f(path, "wb");
+	if (!f)
+		return;
+	u32 header[3] = { JIT_CACHE_MAGIC, JIT_CACHE_VERSION, static_cast<u32>(saved_blocks.size()) };
+	f.WriteArray(header, 3);
+	f.WriteArray(saved_blocks.data(), saved_blocks.size());
+	WriteAddressSet(f, jit->js.fifoWriteAddresses);
+	WriteAddressSet(f, jit->js.pairedQuantizeAddresses);
+	WriteAddressSet(f, jit->js.hotBlockAddresses);
+}
+
 void Shutdown()
 {
 	if (jit)
 	{
+		SavePersistentBlockCache();
 		jit->Shutdown();
 		delete jit;
 		jit = nullptr;
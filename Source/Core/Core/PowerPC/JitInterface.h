@@ -15,7 +15,8 @@ namespace JitInterface
 enum class ExceptionType
 {
 	EXCEPTIONS_FIFO_WRITE,
-	EXCEPTIONS_PAIRED_QUANTIZE
+	EXCEPTIONS_PAIRED_QUANTIZE,
+	EXCEPTIONS_HOT_BLOCK
 };
 
 void DoState(PointerWrap &p);
@@ -27,6 +28,8 @@ CPUCoreBase *GetCore();
 // Debugging
 void WriteProfileResults(const std::string& filename);
 void GetProfileResults(ProfileStats* prof_stats);
+// Blocks compiled since the core started and the time spent compiling them.
+void GetCompileStats(u64* blocks, u64* time_us);
 int GetHostCode(u32* address, const u8** code, u32* code_size);
 
 // Memory Utilities
@@ -43,5 +46,9 @@ void InvalidateICache(u32 address, u32 size, bool forced);
 
 void CompileExceptionCheck(ExceptionType type);
 
+// Compiles the blocks recorded by the persistent block cache of the current game,
+// as long as their code is unchanged. Must be called from the CPU thread before it starts running.
+void WarmUpBlockCache();
+
 void Shutdown();
 }
@@ -946,6 +946,7 @@ void SDRUpdated()
 	}
 	PowerPC::ppcState.pagetable_base = htaborg << 16;
 	PowerPC::ppcState.pagetable_hashmask = ((xx << 10) | 0x3ff);
+	ClearTranslationCache();
 }
 
 enum TLBLookupResult
@@ -955,6 +956,32 @@ enum TLBLookupResult
 	TLB_UPDATE_C
 };
 
+// Host side translation cache in front of the emulated TLB. The TLB only has 64 sets, which MMU
+// titles thrash constantly, each miss costing a page table walk, so successful translations are
+// also kept here, direct mapped by effective page. An entry remembers the segment register it
+// was translated with, so SR writes need no flush.
+struct TranslationCacheEntry
+{
+	u32 tag;
+	u32 sr;
+	u32 paddr;
+	// Writes only hit once a write went through the TLB, that's where the C bit gets set
+	bool written;
+};
+
+static constexpr u32 TRANSLATION_CACHE_SIZE = 1024;
+static TranslationCacheEntry s_translation_cache[NUM_TLBS][TRANSLATION_CACHE_SIZE];
+
+void ClearTranslationCache()
+{
+	for (auto& cache : s_translation_cache)
+	{
+		for (TranslationCacheEntry& entry : cache)
+			entry.tag = TLB_TAG_INVALID;
+	}
+	Memory::UnmapLogicalPages(0, 0);
+}
+
 static __forceinline TLBLookupResult LookupTLBPageAddress(const XCheckTLBFlag flag, const u32 vpa, u32 *paddr)
 {
 	u32 tag = vpa >> HW_PAGE_INDEX_SHIFT;
@@ -1022,6 +1049,15 @@ static __forceinline void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE2 PTE2, c
 
 void InvalidateTLBEntry(u32 address)
 {
+	// tlbie hits every page mapping to the TLB set, so drop all cached pages of that set as well
+	const u32 set = (address >> HW_PAGE_INDEX_SHIFT) & HW_PAGE_INDEX_MASK;
+	for (auto& cache : s_translation_cache)
+	{
+		for (u32 i = set; i < TRANSLATION_CACHE_SIZE; i += HW_PAGE_INDEX_MASK + 1)
+			cache[i].tag = TLB_TAG_INVALID;
+	}
+	Memory::UnmapLogicalPages(HW_PAGE_INDEX_MASK << HW_PAGE_INDEX_SHIFT, set << HW_PAGE_INDEX_SHIFT);
+
 	PowerPC::tlb_entry *tlbe = &PowerPC::ppcState.tlb[0][(address >> HW_PAGE_INDEX_SHIFT) & HW_PAGE_INDEX_MASK];
 	tlbe->tag[0] = TLB_TAG_INVALID;
 	tlbe->tag[1] = TLB_TAG_INVALID;
@@ -1030,18 +1066,48 @@ void InvalidateTLBEntry(u32 address)
 	tlbe_i->tag[1] = TLB_TAG_INVALID;
 }
 
+static __forceinline void UpdateTranslationCache(const XCheckTLBFlag flag, const u32 address,
+	const u32 sr, const u32 translated_address)
+{
+	if (flag == FLAG_NO_EXCEPTION)
+		return;
+
+	const u32 page = address >> HW_PAGE_INDEX_SHIFT;
+	TranslationCacheEntry& entry =
+		s_translation_cache[flag == FLAG_OPCODE][page % TRANSLATION_CACHE_SIZE];
+	entry.tag = page;
+	entry.sr = sr;
+	entry.paddr = translated_address & ~(HW_PAGE_SIZE - 1);
+	entry.written = flag == FLAG_WRITE;
+
+	// Lets later fastmem accesses to the page skip the MMU entirely
+	if (flag != FLAG_OPCODE)
+		Memory::MapLogicalPage(address, translated_address, flag == FLAG_WRITE);
+}
+
 // Page Address Translation
 static __forceinline u32 TranslatePageAddress(const u32 address, const XCheckTLBFlag flag)
 {
+	u32 sr = PowerPC::ppcState.sr[EA_SR(address)];
+
+	const TranslationCacheEntry& cached =
+		s_translation_cache[flag == FLAG_OPCODE][(address >> HW_PAGE_INDEX_SHIFT) % TRANSLATION_CACHE_SIZE];
+	if (cached.tag == address >> HW_PAGE_INDEX_SHIFT && cached.sr == sr &&
+		(flag != FLAG_WRITE || cached.written))
+	{
+		return cached.paddr | (address & (HW_PAGE_SIZE - 1));
+	}
+
 	// TLB cache
 	// This catches 99%+ of lookups in practice, so the actual page table entry code below doesn't benefit
 	// much from optimization.
 	u32 translatedAddress = 0;
 	TLBLookupResult res = LookupTLBPageAddress(flag, address, &translatedAddress);
 	if (res == TLB_FOUND)
+	{
+		UpdateTranslationCache(flag, address, sr, translatedAddress);
 		return translatedAddress;
-
-	u32 sr = PowerPC::ppcState.sr[EA_SR(address)];
+	}
 
 	u32 offset = EA_Offset(address);        // 12 bit
 	u32 page_index = EA_PageIndex(address); // 16 bit
@@ -1086,6 +1152,7 @@ static __forceinline u32 TranslatePageAddress(const u32 address, const XCheckTLB
 				if (res != TLB_UPDATE_C)
 					UpdateTLBEntry(flag, PTE2, address);
 
+				UpdateTranslationCache(flag, address, sr, PTE2.RPN << 12);
 				return (PTE2.RPN << 12) | offset;
 			}
 		}
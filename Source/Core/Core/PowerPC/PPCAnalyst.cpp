@@ -3,13 +3,18 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <map>
+#include <mutex>
 #include <queue>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
+#include "Common/ThreadPool.h"
 #include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -33,6 +38,8 @@ namespace PPCAnalyst
 static const int CODEBUFFER_SIZE = 32000;
 // 0 does not perform block merging
 static const u32 FUNCTION_FOLLOWING_THRESHOLD = 16;
+// Maximum distance of a forward branch followed with OPTION_BRANCH_FOLLOW.
+static const u32 BRANCH_FOLLOWING_DISTANCE = 0x400;
 
 CodeBuffer::CodeBuffer(int size)
 {
@@ -271,7 +278,14 @@ static bool CanSwapAdjacentOps(const CodeOp &a, const CodeOp &b)
 // called by another function. Therefore, let's scan the
 // entire space for bl operations and find what functions
 // get called.
-static void FindFunctionsFromBranches(u32 startAddr, u32 endAddr, SymbolDB *func_db)
+// Reads of main RAM through segment 8 with data translation on never reach the page table code,
+// so they touch no MMU state and can be done from several threads at once.
+static bool IsDirectRAMAddress(u32 address)
+{
+	return UReg_MSR(MSR).DR && (address >> 28) == 0x8 && (address & 0x0FFFFFFF) < Memory::REALRAM_SIZE;
+}
+
+static void FindBranchTargets(u32 startAddr, u32 endAddr, std::vector<u32>* targets)
 {
 	for (u32 addr = startAddr; addr < endAddr; addr += 4)
 	{
@@ -288,10 +302,7 @@ static void FindFunctionsFromBranches(u32 startAddr, u32 endAddr, SymbolDB *func
 					u32 target = SignExt26(instr.LI << 2);
 					if (!instr.AA)
 						target += addr;
-					if (PowerPC::HostIsRAMAddress(target))
-					{
-						func_db->AddFunction(target);
-					}
+					targets->push_back(target);
 				}
 			}
 			break;
@@ -302,6 +313,71 @@ static void FindFunctionsFromBranches(u32 startAddr, u32 endAddr, SymbolDB *func
 	}
 }
 
+static void FindFunctionsFromBranches(u32 startAddr, u32 endAddr, PPCSymbolDB *func_db)
+{
+	if (startAddr >= endAddr)
+		return;
+
+	std::vector<u32> targets;
+	const bool parallel = IsDirectRAMAddress(startAddr) && IsDirectRAMAddress(endAddr - 4);
+	if (parallel)
+	{
+		// Blocks finish in any order, keep their targets by start so they are added to the
+		// database in the same order as a serial scan would
+		std::mutex blocks_lock;
+		std::map<int, std::vector<u32>> blocks;
+		Common::AsyncWorker::ExecuteParallel([&](int lower, int upper) {
+			std::vector<u32> block_targets;
+			FindBranchTargets(startAddr + lower * 4, startAddr + upper * 4, &block_targets);
+			std::lock_guard<std::mutex> lk(blocks_lock);
+			blocks[lower] = std::move(block_targets);
+		}, 0, (endAddr - startAddr + 3) / 4, 0x4000);
+		for (const auto& block : blocks)
+			targets.insert(targets.end(), block.second.begin(), block.second.end());
+	}
+	else
+	{
+		FindBranchTargets(startAddr, endAddr, &targets);
+	}
+
+	// Most of the time goes into walking and hashing every candidate, which only reads memory,
+	// so the candidates in plain RAM are analyzed up front on the pool
+	std::vector<u32> candidates;
+	if (parallel)
+	{
+		for (u32 target : targets)
+		{
+			if (IsDirectRAMAddress(target))
+				candidates.push_back(target);
+		}
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+	std::vector<Symbol> analyzed(candidates.size());
+	std::vector<u8> analyzed_ok(candidates.size());
+	Common::AsyncWorker::ExecuteParallel([&](int lower, int upper) {
+		for (int i = lower; i < upper; i++)
+			analyzed_ok[i] = AnalyzeFunction(candidates[i], analyzed[i]);
+	}, 0, (int)candidates.size(), 64);
+
+	for (u32 target : targets)
+	{
+		if (!PowerPC::HostIsRAMAddress(target))
+			continue;
+		auto candidate = std::lower_bound(candidates.begin(), candidates.end(), target);
+		if (candidate != candidates.end() && *candidate == target)
+		{
+			size_t index = candidate - candidates.begin();
+			if (analyzed_ok[index])
+				func_db->AddAnalyzedFunction(target, analyzed[index]);
+		}
+		else
+		{
+			func_db->AddFunction(target);
+		}
+	}
+}
+
 static void FindFunctionsAfterBLR(PPCSymbolDB *func_db)
 {
 	std::vector<u32> funcAddrs;
@@ -622,6 +698,49 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInf
 	}
 }
 
+// Detects loops that spin until an interrupt, another thread or the hardware changes memory:
+//   * The block ends in a conditional branch back to its start that doesn't use CTR, and
+//     contains no other branches.
+//   * It only consists of integer instructions and loads, so it changes no memory and no
+//     hardware state. MMIO reads either return register state or values derived from the
+//     timing of events, so they can only change when CoreTiming advances.
+//   * Every register it reads is either not written in the loop or written before being read,
+//     so each iteration computes the same values as long as memory doesn't change.
+// Such a loop can skip ahead to the next scheduled event.
+bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock *block, CodeOp *code, u32 instructions) const
+{
+	const CodeOp& branch = code[instructions - 1];
+	if (branch.inst.OPCD != 16 || branch.inst.LK || !(branch.inst.BO & BO_DONT_DECREMENT_FLAG))
+		return false;
+	u32 destination = branch.inst.AA ? SignExt16(branch.inst.BD << 2) : branch.address + SignExt16(branch.inst.BD << 2);
+	if (destination != block->m_address)
+		return false;
+
+	BitSet32 write_disallowed_regs;
+	BitSet32 written_regs;
+	for (u32 i = 0; i < instructions - 1; i++)
+	{
+		const GekkoOPInfo* opinfo = code[i].opinfo;
+		if (opinfo->type != OPTYPE_INTEGER && opinfo->type != OPTYPE_LOAD)
+			return false;
+		if (opinfo->flags & (FL_EVIL | FL_READ_CA | FL_ENDBLOCK))
+			return false;
+
+		for (int reg : code[i].regsIn)
+		{
+			if (!written_regs[reg])
+				write_disallowed_regs[reg] = true;
+		}
+		for (int reg : code[i].regsOut)
+		{
+			if (write_disallowed_regs[reg])
+				return false;
+			written_regs[reg] = true;
+		}
+	}
+	return true;
+}
+
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32 blockSize)
 {
 	// Clear block stats
@@ -687,6 +806,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 		SetInstructionStats(block, &code[i], opinfo, i);
 
 		bool follow = false;
+		bool follow_branch = false;
 		u32 destination = 0;
 
 		bool conditional_continue = false;
@@ -738,6 +858,20 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 				follow = false;
 		}
 
+		if (HasOption(OPTION_BRANCH_FOLLOW) && inst.OPCD == 18 && !inst.LK && blockSize > 1 &&
+			numFollows < FUNCTION_FOLLOWING_THRESHOLD)
+		{
+			// b without link: the skipped instructions only have to be covered by the block range.
+			// Stay within the page when not translating through a BAT, see the page boundary hack above.
+			u32 target = inst.AA ? SignExt26(inst.LI << 2) : address + SignExt26(inst.LI << 2);
+			if (target > address && target - address <= BRANCH_FOLLOWING_DISTANCE &&
+				(result.from_bat || (target & ~0xfff) == (address & ~0xfff)))
+			{
+				follow_branch = true;
+				destination = target;
+			}
+		}
+
 		if (HasOption(OPTION_CONDITIONAL_CONTINUE))
 		{
 			if (inst.OPCD == 16 &&
@@ -767,7 +901,12 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 			}
 		}
 
-		if (!follow)
+		if (follow_branch)
+		{
+			numFollows++;
+			address = destination;
+		}
+		else if (!follow)
 		{
 			address += 4;
 			if (!conditional_continue && opinfo->flags & FL_ENDBLOCK) //right now we stop early
@@ -800,6 +939,10 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 		// We couldn't find an exit
 		block->m_broken = true;
 	}
+	else if (num_inst > 1 && IsBusyWaitLoop(block, code, num_inst))
+	{
+		code[num_inst - 1].branchIsIdleLoop = true;
+	}
 
 	// Scan for flag dependencies; assume the next block (or any branch that can leave the block)
 	// wants flags, to be safe.
@@ -42,6 +42,7 @@ struct CodeOp //16B
 	bool outputFPRF;
 	bool outputCA;
 	bool canEndBlock;
+	bool branchIsIdleLoop;  // backward branch of a side-effect free polling loop, see IsBusyWaitLoop
 	bool skip;  // followed BL-s for example
 	// which registers are still needed after this instruction in this block
 	BitSet32 fprInUse;
@@ -180,6 +181,7 @@ private:
 	void ReorderInstructionsCore(u32 instructions, CodeOp* code, bool reverse, ReorderType type);
 	void ReorderInstructions(u32 instructions, CodeOp *code);
 	void SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInfo *opinfo, u32 index);
+	bool IsBusyWaitLoop(CodeBlock *block, CodeOp *code, u32 instructions) const;
 
 	// Options
 	u32 m_options;
@@ -221,6 +223,11 @@ public:
 
 		// Reorder cror instructions next to their associated fcmp.
 		OPTION_CROR_MERGE = (1 << 6),
+
+		// Continue the block at the destination of short unconditional forward branches.
+		// The block then spans the skipped instructions as well, see JitBlock::followsBranches.
+		// Requires the JIT to handle bx in the middle of a block.
+		OPTION_BRANCH_FOLLOW = (1 << 7),
 	};
 
 
@@ -230,6 +237,8 @@ public:
 	void SetOption(AnalystOption option) { m_options |= option; }
 	void ClearOption(AnalystOption option) { m_options &= ~(option); }
 	bool HasOption(AnalystOption option) const { return !!(m_options & option); }
+	u32 GetOptions() const { return m_options; }
+	void SetOptions(u32 options) { m_options = options; }
 
 	u32 Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32 blockSize);
 };
@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 
 #include "Common/CommonFuncs.h"
@@ -75,12 +76,8 @@ void InstructionCache::Init()
 	Reset();
 }
 
-void InstructionCache::Invalidate(u32 addr)
+void InstructionCache::InvalidateSet(u32 set)
 {
-	if (!HID0.ICE)
-		return;
-	// invalidates the whole set
-	u32 set = (addr >> 5) & 0x7f;
 	for (int i = 0; i < 8; i++)
 		if (valid[set] & (1 << i))
 		{
@@ -92,9 +89,30 @@ void InstructionCache::Invalidate(u32 addr)
 				lookup_table[((tags[set][i] << 7) | set) & 0xfffff] = 0xff;
 		}
 	valid[set] = 0;
+}
+
+void InstructionCache::Invalidate(u32 addr)
+{
+	if (!HID0.ICE)
+		return;
+	// invalidates the whole set
+	InvalidateSet((addr >> 5) & 0x7f);
 	JitInterface::InvalidateICache(addr & ~0x1f, 32, false);
 }
 
+void InstructionCache::InvalidateRange(u32 addr, u32 length)
+{
+	if (!HID0.ICE || length == 0)
+		return;
+	u32 start = addr & ~0x1f;
+	u32 end = (addr + length + 0x1f) & ~0x1f;
+	// Past 4 KiB every set has been touched once
+	u32 num_sets = std::min((end - start) >> 5, ICACHE_SETS);
+	for (u32 i = 0; i < num_sets; i++)
+		InvalidateSet(((start >> 5) + i) & 0x7f);
+	JitInterface::InvalidateICache(start, end - start, false);
+}
+
 u32 InstructionCache::ReadInstruction(u32 addr)
 {
 	if (!HID0.ICE) // instruction cache is disabled
@@ -34,8 +34,13 @@ struct InstructionCache
 	InstructionCache();
 	u32 ReadInstruction(u32 addr);
 	void Invalidate(u32 addr);
+	// Invalidates every block in [addr, addr + length) with a single JIT invalidation
+	void InvalidateRange(u32 addr, u32 length);
 	void Init();
 	void Reset();
+
+private:
+	void InvalidateSet(u32 set);
 };
 
 }
@@ -48,13 +48,25 @@ Symbol *PPCSymbolDB::AddFunction(u32 startAddr)
 		if (targetEnd == 0)
 			return nullptr;  //found a dud :(
 		//LOG(OSHLE, "Symbol found at %08x", startAddr);
-		functions[startAddr] = tempFunc;
-		tempFunc.type = Symbol::SYMBOL_FUNCTION;
-		checksumToFunction[tempFunc.hash] = &(functions[startAddr]);
-		return &functions[startAddr];
+		return AddAnalyzedFunction(startAddr, tempFunc);
 	}
 }
 
+// Same as AddFunction, for a function PPCAnalyst::AnalyzeFunction already succeeded on
+Symbol *PPCSymbolDB::AddAnalyzedFunction(u32 startAddr, const Symbol& func)
+{
+	if (startAddr < 0x80000010)
+		return nullptr;
+	XFuncMap::iterator iter = functions.find(startAddr);
+	if (iter != functions.end())
+		return nullptr;
+
+	Symbol& added = functions[startAddr];
+	added = func;
+	checksumToFunction[added.hash] = &added;
+	return &added;
+}
+
 void PPCSymbolDB::AddKnownSymbol(u32 startAddr, u32 size, const std::string& name, int type)
 {
 	XFuncMap::iterator iter = functions.find(startAddr);
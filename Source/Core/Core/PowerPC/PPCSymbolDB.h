@@ -26,6 +26,7 @@ public:
 	~PPCSymbolDB();
 
 	Symbol *AddFunction(u32 startAddr) override;
+	Symbol *AddAnalyzedFunction(u32 startAddr, const Symbol& func);
 	void AddKnownSymbol(u32 startAddr, u32 size, const std::string& name, int type = Symbol::SYMBOL_FUNCTION);
 
 	Symbol *GetSymbolFromAddr(u32 addr) override;
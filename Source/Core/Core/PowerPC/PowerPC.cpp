@@ -18,6 +18,7 @@
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/PPCTables.h"
+#include "Core/PowerPC/Profiler.h"
 #include "Core/PowerPC/Interpreter/Interpreter.h"
 
 
@@ -65,6 +66,8 @@ void DoState(PointerWrap &p)
 	// *((u64 *)&TL) = SystemTimers::GetFakeTimeBase(); //works since we are little endian and TL comes first :)
 
 	p.DoPOD(ppcState);
+	if (p.GetMode() == PointerWrap::MODE_READ)
+		ClearTranslationCache();
 
 	// SystemTimers::DecrementerSet();
 	// SystemTimers::TimeBaseSet();
@@ -133,6 +136,7 @@ void Init(int cpu_core)
 			}
 		}
 	}
+	ClearTranslationCache();
 
 	ResetRegisters();
 	PPCTables::InitTables(cpu_core);
@@ -167,6 +171,7 @@ void Init(int cpu_core)
 	}
 
 	ppcState.iCache.Init();
+	Profiler::Init();
 
 	if (SConfig::GetInstance().bEnableDebugging)
 		breakpoints.ClearAllTemporary();
@@ -174,6 +179,7 @@ void Init(int cpu_core)
 
 void Shutdown()
 {
+	Profiler::Shutdown();
 	InjectExternalCPUCore(nullptr);
 	JitInterface::Shutdown();
 	s_interpreter->Shutdown();
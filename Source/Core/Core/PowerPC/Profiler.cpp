@@ -2,15 +2,132 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/SystemTimers.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/Profiler.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
 
 namespace Profiler
 {
 
 bool g_ProfileBlocks;
 
+// Sampling profiler state.
+static CoreTiming::EventType* s_et_sample;
+static bool s_sampling = false;
+static s64 s_sample_period;
+static std::unordered_map<u32, u64> s_samples;
+static u64 s_total_samples;
+static std::chrono::steady_clock::time_point s_start_time;
+
+static void SampleCallback(u64 userdata, s64 cycles_late)
+{
+	if (!s_sampling)
+		return;
+
+	// Events run between blocks, where the JIT keeps PC exact.
+	s_samples[PowerPC::ppcState.pc]++;
+	s_total_samples++;
+	CoreTiming::ScheduleEvent(s_sample_period - cycles_late, s_et_sample);
+}
+
+void Init()
+{
+	// Always registered, so save states stay compatible regardless of the setting.
+	s_et_sample = CoreTiming::RegisterEvent("ProfilerSample", SampleCallback);
+
+	s_samples.clear();
+	s_total_samples = 0;
+	s_sampling = SConfig::GetInstance().bJITSampleProfiler;
+	if (!s_sampling)
+		return;
+
+	s_sample_period = SystemTimers::GetTicksPerSecond() / SAMPLES_PER_SECOND;
+	s_start_time = std::chrono::steady_clock::now();
+	CoreTiming::ScheduleEvent(s_sample_period, s_et_sample);
+}
+
+void Shutdown()
+{
+	if (s_sampling && s_total_samples)
+	{
+		std::string filename = File::GetUserPath(D_DUMP_IDX) + "Profiler/" +
+			SConfig::GetInstance().GetGameID() + ".txt";
+		File::CreateFullPath(filename);
+		WriteSampleReport(filename);
+	}
+	s_sampling = false;
+	s_samples.clear();
+	s_total_samples = 0;
+}
+
+void WriteSampleReport(const std::string& filename)
+{
+	File::IOFile f(filename, "w");
+	if (!f)
+	{
+		ERROR_LOG(POWERPC, "Failed to open %s", filename.c_str());
+		return;
+	}
+
+	double host_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_start_time).count();
+	JitBaseBlockCache* block_cache = jit ? jit->GetBlockCache() : nullptr;
+
+	std::vector<std::pair<u32, u64>> blocks(s_samples.begin(), s_samples.end());
+	std::sort(blocks.begin(), blocks.end(), [](const std::pair<u32, u64>& a, const std::pair<u32, u64>& b) {
+		return a.second > b.second;
+	});
+
+	// Samples are taken at a fixed rate of emulated cycles, so the share of samples is the share
+	// of guest time. Host time is apportioned by the same share.
+	std::map<std::string, u64> functions;
+	fprintf(f.GetHandle(), "# %" PRIu64 " samples over %.0f ms\n", s_total_samples, host_ms);
+	fprintf(f.GetHandle(), "origAddr\tblkName\tsamples\tpercent\thostTime(ms)\trunCount\tblkCodeSize\n");
+	for (const auto& block : blocks)
+	{
+		std::string name = g_symbolDB.GetDescription(block.first);
+		double share = (double)block.second / (double)s_total_samples;
+		int run_count = 0;
+		u32 code_size = 0;
+		int block_num = block_cache ? block_cache->GetBlockNumberFromStartAddress(block.first) : -1;
+		if (block_num >= 0)
+		{
+			run_count = block_cache->GetBlock(block_num)->runCount;
+			code_size = block_cache->GetBlock(block_num)->codeSize;
+		}
+		fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\t%.2f\t%.2f\t%i\t%u\n",
+			block.first, name.c_str(), block.second, 100.0 * share, share * host_ms, run_count, code_size);
+		functions[name] += block.second;
+	}
+
+	std::vector<std::pair<std::string, u64>> sorted_functions(functions.begin(), functions.end());
+	std::sort(sorted_functions.begin(), sorted_functions.end(),
+		[](const std::pair<std::string, u64>& a, const std::pair<std::string, u64>& b) {
+		return a.second > b.second;
+	});
+	fprintf(f.GetHandle(), "\nfunction\tsamples\tpercent\thostTime(ms)\n");
+	for (const auto& function : sorted_functions)
+	{
+		double share = (double)function.second / (double)s_total_samples;
+		fprintf(f.GetHandle(), "%s\t%" PRIu64 "\t%.2f\t%.2f\n", function.first.c_str(), function.second,
+			100.0 * share, share * host_ms);
+	}
+}
+
 void WriteProfileResults(const std::string& filename)
 {
 	JitInterface::WriteProfileResults(filename);
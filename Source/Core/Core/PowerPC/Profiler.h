@@ -71,4 +71,13 @@ namespace Profiler
 extern bool g_ProfileBlocks;
 
 void WriteProfileResults(const std::string& filename);
+
+// Sampling profiler, enabled with SConfig::bJITSampleProfiler. Unlike g_ProfileBlocks it does
+// not instrument the generated code: the guest PC is sampled from a CoreTiming event, and the
+// report (Dump/Profiler/<game id>.txt) is written on shutdown.
+const int SAMPLES_PER_SECOND = 1000;
+
+void Init();
+void Shutdown();
+void WriteSampleReport(const std::string& filename);
 }
@@ -2,8 +2,13 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
 #include <lzo/lzo1x.h>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -18,6 +23,7 @@
 #include "Common/ScopeGuard.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Common/Timer.h"
 
 #include "Core/ConfigManager.h"
@@ -25,6 +31,7 @@
 #include "Core/CoreTiming.h"
 #include "Core/GeckoCode.h"
 #include "Core/HW/HW.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/Wiimote.h"
 #include "Core/Host.h"
 #include "Core/Movie.h"
@@ -48,12 +55,8 @@ static const u32 IN_LEN = 128 * 1024u;
 
 static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
 
-static unsigned char __LZO_MMODEL out[OUT_LEN];
-
-#define HEAP_ALLOC(var, size)                                                                      \
-  lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
-
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+// Chunks are compressed independently, this many at a time across the thread pool
+static const size_t COMPRESS_BATCH_CHUNKS = 64;
 
 static std::string g_last_filename;
 
@@ -62,6 +65,8 @@ static CallbackFunc g_onAfterLoadCb = nullptr;
 // Temporary undo state buffer
 static std::vector<u8> g_undo_load_buffer;
 static std::vector<u8> g_current_buffer;
+// g_current_buffer still holds the last state saved into it
+static bool g_current_buffer_valid = false;
 static int g_loadDepth = 0;
 
 static std::mutex g_cs_undo_load_buffer;
@@ -70,8 +75,32 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 
 static std::thread g_save_thread;
 
+// Rewind history. Every few frames the whole state is serialized into RAM. One
+// capture in REWIND_KEYFRAME_INTERVAL is kept as-is, the others only store the
+// pages that differ from that keyframe (mostly a handful of RAM pages and GPU
+// state), so any entry is rebuilt from a keyframe plus a single delta. Diffing
+// runs on the thread pool; the CPU is only paused for the serialization.
+static const size_t REWIND_PAGE_SIZE = 4096;
+static const u32 REWIND_KEYFRAME_INTERVAL = 8;
+
+struct RewindEntry
+{
+	std::shared_ptr<const std::vector<u8>> keyframe;
+	// (u32 page index, page contents) pairs, empty for the keyframe itself
+	std::vector<u8> delta;
+	size_t cost;
+};
+
+static std::mutex g_cs_rewind;
+static std::deque<RewindEntry> g_rewind_entries;
+static size_t g_rewind_bytes = 0;
+static u32 g_rewind_since_keyframe = 0;
+static std::atomic<bool> g_rewind_encoding{ false };
+static std::atomic<bool> g_rewind_capture_queued{ false };
+static u32 g_rewind_frames = 0;
+
 // Don't forget to increase this after doing changes on the savestate system
-static const u32 STATE_VERSION = 68;  // Last changed in PR 4638
+static const u32 STATE_VERSION = 69;  // Last changed when the PE/CP interrupt mailboxes were added
 
 																			// Maps savestate versions to Dolphin versions.
 																			// Versions after 42 don't need to be added to this list,
@@ -200,13 +229,37 @@ void LoadFromBuffer(std::vector<u8>& buffer)
 	Core::PauseAndLock(false, wasUnpaused);
 }
 
-void SaveToBuffer(std::vector<u8>& buffer)
+// Savestates rarely change size from one save to the next, so the last size is tried first and the
+// measuring pass only runs when the state no longer fits.
+static size_t s_last_state_size = 0;
+
+// Serializes the whole state into buffer, resizing it to fit. With incremental set, and a buffer
+// that still has the layout of the last save, Memory only copies the RAM written since then.
+static bool WriteStateToBuffer(std::vector<u8>& buffer, bool incremental)
 {
-	bool wasUnpaused = Core::PauseAndLock(true);
+	if (s_last_state_size != 0)
+	{
+		const bool use_incremental = incremental && buffer.size() == s_last_state_size;
+		buffer.resize(s_last_state_size);
+		u8* ptr = &buffer[0];
+		PointerWrap p(&ptr, PointerWrap::MODE_WRITE);
+		p.SetWriteLimit(ptr + buffer.size());
+		Memory::SetIncrementalSave(use_incremental);
+		DoState(p);
+		Memory::SetIncrementalSave(false);
+
+		const size_t written = ptr - &buffer[0];
+		// An incremental save is only valid if nothing before RAM moved
+		if (p.GetMode() == PointerWrap::MODE_WRITE && (written == s_last_state_size || !use_incremental))
+		{
+			buffer.resize(written);
+			s_last_state_size = written;
+			return true;
+		}
+	}
 
 	u8* ptr = nullptr;
 	PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-
 	DoState(p);
 	const size_t buffer_size = reinterpret_cast<size_t>(ptr);
 	buffer.resize(buffer_size);
@@ -214,6 +267,17 @@ void SaveToBuffer(std::vector<u8>& buffer)
 	ptr = &buffer[0];
 	p.SetMode(PointerWrap::MODE_WRITE);
 	DoState(p);
+	if (p.GetMode() != PointerWrap::MODE_WRITE)
+		return false;
+	s_last_state_size = buffer_size;
+	return true;
+}
+
+void SaveToBuffer(std::vector<u8>& buffer)
+{
+	bool wasUnpaused = Core::PauseAndLock(true);
+
+	WriteStateToBuffer(buffer, false);
 
 	Core::PauseAndLock(false, wasUnpaused);
 }
@@ -344,33 +408,44 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
 
 	if (header.size != 0)  // non-zero header size means the state is compressed
 	{
-		lzo_uint i = 0;
-		while (true)
+		// Every chunk is IN_LEN bytes except the last one, which may be empty.
+		const size_t num_chunks = buffer_size / IN_LEN + 1;
+		std::vector<std::vector<u8>> outputs(std::min(num_chunks, COMPRESS_BATCH_CHUNKS),
+			std::vector<u8>(OUT_LEN));
+		std::vector<lzo_uint> out_lens(outputs.size());
+		std::atomic<bool> failed{ false };
+
+		for (size_t first = 0; first < num_chunks; first += outputs.size())
 		{
-			lzo_uint32 cur_len = 0;
-			lzo_uint out_len = 0;
-
-			if ((i + IN_LEN) >= buffer_size)
+			const size_t count = std::min(outputs.size(), num_chunks - first);
+			Common::AsyncWorker::ExecuteParallel(
+				[&](int lower, int upper) {
+					std::vector<lzo_align_t> work_mem(
+						(LZO1X_1_MEM_COMPRESS + sizeof(lzo_align_t) - 1) / sizeof(lzo_align_t));
+					for (int j = lower; j < upper; j++)
+					{
+						const size_t offset = (first + j) * IN_LEN;
+						const lzo_uint cur_len = (lzo_uint)std::min<size_t>(IN_LEN, buffer_size - offset);
+						if (lzo1x_1_compress(buffer_data + offset, cur_len, outputs[j].data(), &out_lens[j],
+							work_mem.data()) != LZO_E_OK)
+						{
+							failed = true;
+						}
+					}
+				},
+				0, static_cast<int>(count), 1);
+
+			// Written in order, so the file is the same as from a serial compressor
+			for (size_t j = 0; j < count; j++)
 			{
-				cur_len = (lzo_uint32)(buffer_size - i);
+				const lzo_uint32 out_len = (lzo_uint32)out_lens[j];
+				f.WriteArray(&out_len, 1);
+				f.WriteBytes(outputs[j].data(), out_len);
 			}
-			else
-			{
-				cur_len = IN_LEN;
-			}
-
-			if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-				PanicAlertT("Internal LZO Error - compression failed");
-
-			// The size of the data to write is 'out_len'
-			f.WriteArray((lzo_uint32*)&out_len, 1);
-			f.WriteBytes(out, out_len);
-
-			if (cur_len != IN_LEN)
-				break;
-
-			i += cur_len;
 		}
+
+		if (failed)
+			PanicAlertT("Internal LZO Error - compression failed");
 	}
 	else  // uncompressed
 	{
@@ -386,22 +461,16 @@ void SaveAs(const std::string& filename, bool wait)
 	// Pause the core while we save the state
 	bool wasUnpaused = Core::PauseAndLock(true);
 
-	// Measure the size of the buffer.
-	u8* ptr = nullptr;
-	PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-	DoState(p);
-	const size_t buffer_size = reinterpret_cast<size_t>(ptr);
-
-	// Then actually do the write.
+	bool saved;
 	{
 		std::lock_guard<std::mutex> lk(g_cs_current_buffer);
-		g_current_buffer.resize(buffer_size);
-		ptr = &g_current_buffer[0];
-		p.SetMode(PointerWrap::MODE_WRITE);
-		DoState(p);
+		// Saving over the previous state only has to copy the memory written since then
+		saved = WriteStateToBuffer(g_current_buffer,
+			SConfig::GetInstance().bIncrementalSavestates && g_current_buffer_valid);
+		g_current_buffer_valid = saved;
 	}
 
-	if (p.GetMode() == PointerWrap::MODE_WRITE)
+	if (saved)
 	{
 		Core::DisplayMessage("Saving State...", 1000);
 
@@ -482,27 +551,61 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
 
 		buffer.resize(header.size);
 
-		lzo_uint i = 0;
-		while (true)
+		const size_t data_size = (size_t)(f.GetSize() - sizeof(StateHeader));
+		std::vector<u8> compressed(data_size);
+		if (data_size != 0 && !f.ReadBytes(compressed.data(), data_size))
 		{
-			lzo_uint32 cur_len = 0;  // number of bytes to read
-			lzo_uint new_len = 0;    // number of bytes to write
+			Core::DisplayMessage("Could not read state", 2000);
+			return;
+		}
 
-			if (!f.ReadArray(&cur_len, 1))
+		// Every chunk but the last one decompresses to IN_LEN bytes, so the place of each chunk in
+		// the buffer is known up front and they can all be decompressed in parallel.
+		std::vector<std::pair<size_t, lzo_uint32>> chunks;
+		size_t pos = 0;
+		while (data_size - pos >= sizeof(lzo_uint32))
+		{
+			lzo_uint32 cur_len;  // number of bytes to read
+			memcpy(&cur_len, &compressed[pos], sizeof(cur_len));
+			pos += sizeof(cur_len);
+			if (cur_len > data_size - pos)
 				break;
+			chunks.emplace_back(pos, cur_len);
+			pos += cur_len;
+		}
 
-			f.ReadBytes(out, cur_len);
-			const int res = lzo1x_decompress(out, cur_len, &buffer[i], &new_len, nullptr);
-			if (res != LZO_E_OK)
-			{
-				// This doesn't seem to happen anymore.
-				PanicAlertT("Internal LZO Error - decompression failed (%d) (%li, %li) \n"
-					"Try loading the state again",
-					res, i, new_len);
-				return;
-			}
-
-			i += new_len;
+		std::mutex error_lock;
+		int error = LZO_E_OK;
+		size_t error_offset = 0;
+		lzo_uint error_len = 0;
+		Common::AsyncWorker::ExecuteParallel(
+			[&](int lower, int upper) {
+				for (int j = lower; j < upper; j++)
+				{
+					const size_t offset = static_cast<size_t>(j) * IN_LEN;
+					lzo_uint new_len = offset < header.size ? header.size - offset : 0;
+					int res = lzo1x_decompress_safe(&compressed[chunks[j].first], chunks[j].second,
+						buffer.data() + std::min<size_t>(offset, header.size), &new_len, nullptr);
+					if (res == LZO_E_OK && j + 1 < static_cast<int>(chunks.size()) && new_len != IN_LEN)
+						res = LZO_E_INPUT_NOT_CONSUMED;
+					if (res != LZO_E_OK)
+					{
+						std::lock_guard<std::mutex> lk(error_lock);
+						error = res;
+						error_offset = offset;
+						error_len = new_len;
+					}
+				}
+			},
+			0, static_cast<int>(chunks.size()), 1);
+
+		if (error != LZO_E_OK)
+		{
+			// This doesn't seem to happen anymore.
+			PanicAlertT("Internal LZO Error - decompression failed (%d) (%li, %li) \n"
+				"Try loading the state again",
+				error, (long)error_offset, (long)error_len);
+			return;
 		}
 	}
 	else  // uncompressed
@@ -644,12 +747,15 @@ void Shutdown()
 	{
 		std::lock_guard<std::mutex> lk(g_cs_current_buffer);
 		std::vector<u8>().swap(g_current_buffer);
+		g_current_buffer_valid = false;
 	}
 
 	{
 		std::lock_guard<std::mutex> lk(g_cs_undo_load_buffer);
 		std::vector<u8>().swap(g_undo_load_buffer);
 	}
+
+	ClearRewind();
 }
 
 static std::string MakeStateFilename(int number)
@@ -740,4 +846,147 @@ void UndoSaveState()
 	LoadAs(File::GetUserPath(D_STATESAVES_IDX) + "lastState.sav");
 }
 
+static std::vector<u8> EncodeRewindDelta(const std::vector<u8>& keyframe,
+	const std::vector<u8>& state)
+{
+	std::vector<u8> delta;
+	for (size_t offset = 0; offset < state.size(); offset += REWIND_PAGE_SIZE)
+	{
+		const size_t length = std::min(REWIND_PAGE_SIZE, state.size() - offset);
+		if (std::memcmp(&keyframe[offset], &state[offset], length) == 0)
+			continue;
+
+		const u32 page = static_cast<u32>(offset / REWIND_PAGE_SIZE);
+		const size_t pos = delta.size();
+		delta.resize(pos + sizeof(page) + length);
+		std::memcpy(&delta[pos], &page, sizeof(page));
+		std::memcpy(&delta[pos + sizeof(page)], &state[offset], length);
+	}
+	return delta;
+}
+
+static void DecodeRewindEntry(const RewindEntry& entry, std::vector<u8>& state)
+{
+	state = *entry.keyframe;
+	size_t pos = 0;
+	while (pos < entry.delta.size())
+	{
+		u32 page;
+		std::memcpy(&page, &entry.delta[pos], sizeof(page));
+		pos += sizeof(page);
+
+		const size_t offset = page * REWIND_PAGE_SIZE;
+		const size_t length = std::min(REWIND_PAGE_SIZE, state.size() - offset);
+		std::memcpy(&state[offset], &entry.delta[pos], length);
+		pos += length;
+	}
+}
+
+static void StoreRewindState(std::vector<u8>& state)
+{
+	std::shared_ptr<const std::vector<u8>> keyframe;
+	{
+		std::lock_guard<std::mutex> lk(g_cs_rewind);
+		if (!g_rewind_entries.empty() && g_rewind_since_keyframe < REWIND_KEYFRAME_INTERVAL)
+			keyframe = g_rewind_entries.back().keyframe;
+	}
+
+	RewindEntry entry;
+	if (keyframe && keyframe->size() == state.size())
+	{
+		entry.keyframe = std::move(keyframe);
+		entry.delta = EncodeRewindDelta(*entry.keyframe, state);
+		entry.cost = entry.delta.size();
+	}
+	else
+	{
+		entry.cost = state.size();
+		entry.keyframe = std::make_shared<const std::vector<u8>>(std::move(state));
+	}
+
+	const size_t budget = static_cast<size_t>(std::max(SConfig::GetInstance().iRewindMemory, 1)) << 20;
+
+	std::lock_guard<std::mutex> lk(g_cs_rewind);
+	g_rewind_since_keyframe = entry.delta.empty() ? 1 : g_rewind_since_keyframe + 1;
+	g_rewind_bytes += entry.cost;
+	g_rewind_entries.push_back(std::move(entry));
+	// A dropped keyframe stays alive until its last delta is dropped too, so the
+	// budget can be exceeded by at most one keyframe.
+	while (g_rewind_bytes > budget && g_rewind_entries.size() > 1)
+	{
+		g_rewind_bytes -= g_rewind_entries.front().cost;
+		g_rewind_entries.pop_front();
+	}
+}
+
+static void CaptureRewindState()
+{
+	g_rewind_capture_queued = false;
+
+	// Only one capture is diffed at a time, if the pool is behind this one is skipped
+	if (!Core::IsRunningAndStarted() || NetPlay::IsNetPlayRunning() || g_rewind_encoding)
+		return;
+
+	auto state = std::make_shared<std::vector<u8>>();
+	SaveToBuffer(*state);
+	if (state->empty())
+		return;
+
+	g_rewind_encoding = true;
+	Common::AsyncWorker::ExecuteAsync([state] {
+		StoreRewindState(*state);
+		g_rewind_encoding = false;
+	});
+}
+
+void RewindFrameUpdate()
+{
+	const SConfig& config = SConfig::GetInstance();
+	if (!config.bRewind)
+		return;
+
+	if (++g_rewind_frames < static_cast<u32>(std::max(config.iRewindInterval, 1)))
+		return;
+	g_rewind_frames = 0;
+
+	// Serializing needs the CPU paused, which can't be done from the video thread
+	if (!g_rewind_capture_queued.exchange(true))
+		Core::QueueHostJob(CaptureRewindState);
+}
+
+void Rewind()
+{
+	while (g_rewind_encoding)
+		Common::YieldCPU();
+
+	std::vector<u8> state;
+	{
+		std::lock_guard<std::mutex> lk(g_cs_rewind);
+		if (g_rewind_entries.empty())
+		{
+			Core::DisplayMessage("Nothing to rewind", 2000);
+			return;
+		}
+
+		DecodeRewindEntry(g_rewind_entries.back(), state);
+		g_rewind_bytes -= g_rewind_entries.back().cost;
+		g_rewind_entries.pop_back();
+		if (g_rewind_entries.empty())
+			g_rewind_since_keyframe = 0;
+	}
+
+	LoadFromBuffer(state);
+}
+
+void ClearRewind()
+{
+	while (g_rewind_encoding)
+		Common::YieldCPU();
+
+	std::lock_guard<std::mutex> lk(g_cs_rewind);
+	std::deque<RewindEntry>().swap(g_rewind_entries);
+	g_rewind_bytes = 0;
+	g_rewind_since_keyframe = 0;
+}
+
 }  // namespace State
@@ -57,6 +57,13 @@ void SaveFirstSaved();
 void UndoSaveState();
 void UndoLoadState();
 
+// In-memory history for rewinding, captured every SConfig::iRewindInterval
+// frames while SConfig::bRewind is set. Rewind loads the newest capture and
+// drops it, so calling it again steps further back.
+void RewindFrameUpdate();
+void Rewind();
+void ClearRewind();
+
 // wait until previously scheduled savestate event (if any) is done
 void Flush();
 
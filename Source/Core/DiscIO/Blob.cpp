@@ -12,6 +12,7 @@
 #include "Common/CDUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/ThreadPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/CISOBlob.h"
@@ -25,6 +26,8 @@ namespace DiscIO
 {
 void SectorReader::SetSectorSize(int blocksize)
 {
+  StopReadAhead();
+  m_free_buffers.clear();
   m_block_size = std::max(blocksize, 0);
   for (auto& cache_entry : m_cache)
   {
@@ -74,17 +77,27 @@ SectorReader::Cache* SectorReader::GetEmptyCacheLine()
 
 const SectorReader::Cache* SectorReader::GetCacheLine(u64 block_num)
 {
+  // We only read aligned chunks, this avoids duplicate overlapping entries.
+  u64 chunk_idx = block_num / m_chunk_blocks;
+  if (m_read_ahead_enabled && chunk_idx != m_last_chunk)
+  {
+    if (chunk_idx == m_last_chunk + 1)
+      ScheduleReadAhead(chunk_idx);
+    m_last_chunk = chunk_idx;
+  }
+
   if (auto entry = FindCacheLine(block_num))
     return entry;
 
   // Cache miss. Fault in the missing entry.
   Cache* cache = GetEmptyCacheLine();
-  // We only read aligned chunks, this avoids duplicate overlapping entries.
-  u64 chunk_idx = block_num / m_chunk_blocks;
-  u32 blocks_read = ReadChunk(cache->data.data(), chunk_idx);
-  if (!blocks_read)
-    return nullptr;
-  cache->Fill(chunk_idx * m_chunk_blocks, blocks_read);
+  if (!TakeReadAhead(chunk_idx, cache))
+  {
+    u32 blocks_read = ReadChunk(cache->data.data(), chunk_idx);
+    if (!blocks_read)
+      return nullptr;
+    cache->Fill(chunk_idx * m_chunk_blocks, blocks_read);
+  }
 
   // Secondary check for out-of-bounds read.
   // If we got less than m_chunk_blocks, we may still have missed.
@@ -123,6 +136,111 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
   return true;
 }
 
+void SectorReader::EnableReadAhead()
+{
+  m_read_ahead_enabled = true;
+}
+
+void SectorReader::StopReadAhead()
+{
+  for (auto& chunk : m_read_ahead)
+  {
+    int expected = ReadAheadChunk::QUEUED;
+    if (chunk->state.compare_exchange_strong(expected, ReadAheadChunk::CANCELLED))
+      continue;
+
+    size_t count = 0;
+    while (chunk->state.load() == ReadAheadChunk::RUNNING)
+      Common::cYield(count++);
+  }
+  m_read_ahead.clear();
+  m_last_chunk = UINT64_MAX;
+}
+
+bool SectorReader::IsCached(u64 chunk_idx) const
+{
+  const u64 block_num = chunk_idx * m_chunk_blocks;
+  return std::any_of(m_cache.begin(), m_cache.end(),
+                     [&](const Cache& entry) { return entry.Contains(block_num); });
+}
+
+void SectorReader::ScheduleReadAhead(u64 chunk_idx)
+{
+  const u64 chunk_bytes = static_cast<u64>(m_chunk_blocks) * m_block_size;
+  const u64 depth = std::max<u64>(READ_AHEAD_BYTES / std::max<u64>(chunk_bytes, 1), 1);
+
+  // Forget chunks outside the new window, the pool still owns the running ones
+  m_read_ahead.erase(
+      std::remove_if(m_read_ahead.begin(), m_read_ahead.end(),
+                     [&](const std::shared_ptr<ReadAheadChunk>& chunk) {
+                       if (chunk->chunk_idx > chunk_idx && chunk->chunk_idx <= chunk_idx + depth)
+                         return false;
+                       int expected = ReadAheadChunk::QUEUED;
+                       chunk->state.compare_exchange_strong(expected, ReadAheadChunk::CANCELLED);
+                       return chunk->state.load() != ReadAheadChunk::RUNNING;
+                     }),
+      m_read_ahead.end());
+  const u64 end_block = (GetDataSize() + m_block_size - 1) / m_block_size;
+  const u64 end_chunk = (end_block + m_chunk_blocks - 1) / m_chunk_blocks;
+  for (u64 next = chunk_idx + 1; next <= chunk_idx + depth && next < end_chunk; ++next)
+  {
+    if (IsCached(next) ||
+        std::any_of(m_read_ahead.begin(), m_read_ahead.end(),
+                    [&](const std::shared_ptr<ReadAheadChunk>& chunk) { return chunk->chunk_idx == next; }))
+    {
+      continue;
+    }
+
+    auto chunk = std::make_shared<ReadAheadChunk>();
+    chunk->chunk_idx = next;
+    if (!m_free_buffers.empty())
+    {
+      chunk->data = std::move(m_free_buffers.back());
+      m_free_buffers.pop_back();
+    }
+    chunk->data.resize(chunk_bytes);
+    m_read_ahead.push_back(chunk);
+
+    // Cancelled chunks never touch the reader, it may be gone by then
+    Common::AsyncWorker::ExecuteAsync([this, chunk] {
+      int expected = ReadAheadChunk::QUEUED;
+      if (!chunk->state.compare_exchange_strong(expected, ReadAheadChunk::RUNNING))
+        return;
+      chunk->num_blocks = ReadChunk(chunk->data.data(), chunk->chunk_idx);
+      chunk->state.store(ReadAheadChunk::DONE);
+    });
+  }
+}
+
+bool SectorReader::TakeReadAhead(u64 chunk_idx, Cache* cache)
+{
+  auto itr = std::find_if(
+      m_read_ahead.begin(), m_read_ahead.end(),
+      [&](const std::shared_ptr<ReadAheadChunk>& chunk) { return chunk->chunk_idx == chunk_idx; });
+  if (itr == m_read_ahead.end())
+    return false;
+
+  std::shared_ptr<ReadAheadChunk> chunk = *itr;
+  m_read_ahead.erase(itr);
+
+  // Still queued, reading it here beats waiting behind other pool work
+  int expected = ReadAheadChunk::QUEUED;
+  if (chunk->state.compare_exchange_strong(expected, ReadAheadChunk::CANCELLED))
+    return false;
+
+  size_t count = 0;
+  while (chunk->state.load() == ReadAheadChunk::RUNNING)
+    Common::cYield(count++);
+  if (!chunk->num_blocks)
+    return false;
+
+  std::swap(cache->data, chunk->data);
+  if (m_free_buffers.size() < FREE_BUFFERS)
+    m_free_buffers.push_back(std::move(chunk->data));
+  cache->Fill(chunk_idx * m_chunk_blocks, chunk->num_blocks);
+  return true;
+}
+
 // Crap default implementation if not overridden.
 bool SectorReader::ReadMultipleAlignedBlocks(u64 block_num, u64 cnt_blocks, u8* out_ptr)
 {
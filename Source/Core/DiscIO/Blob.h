@@ -15,8 +15,10 @@
 // automatically do the right thing.
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 
@@ -76,6 +78,14 @@ protected:
   // overridden in derived classes where possible.
   virtual bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr);
 
+  // Once reads turn sequential, the chunks after the one being read are
+  // decoded on the thread pool ahead of time. When enabled, GetBlock and
+  // ReadMultipleAlignedBlocks may be called from several threads at once, and
+  // the derived class must call StopReadAhead in its destructor.
+  void EnableReadAhead();
+  // Waits for or cancels all outstanding read-ahead work.
+  void StopReadAhead();
+
 private:
   struct Cache
   {
@@ -130,10 +140,42 @@ private:
   // evenly divisible into chunks). Returns zero if it fails.
   u32 ReadChunk(u8* buffer, u64 chunk_num);
 
+  // A chunk read on the thread pool. The reader cancels queued chunks it
+  // needs right away and reads them itself instead of waiting on the pool.
+  struct ReadAheadChunk
+  {
+    enum State
+    {
+      QUEUED,
+      RUNNING,
+      DONE,
+      CANCELLED,
+    };
+
+    std::vector<u8> data;
+    u64 chunk_idx = 0;
+    u32 num_blocks = 0;
+    std::atomic<int> state{QUEUED};
+  };
+
+  // Queues the chunks following chunk_idx that are neither cached nor queued.
+  void ScheduleReadAhead(u64 chunk_idx);
+  // Moves a read-ahead chunk into the cache line, false if it isn't available.
+  bool TakeReadAhead(u64 chunk_idx, Cache* cache);
+  bool IsCached(u64 chunk_idx) const;
+
   static constexpr int CACHE_LINES = 32;
+  // How much is read ahead of a sequential reader
+  static constexpr u32 READ_AHEAD_BYTES = 1024 * 1024;
+  static constexpr size_t FREE_BUFFERS = 8;
   u32 m_block_size = 0;    // Bytes in a sector/block
   u32 m_chunk_blocks = 1;  // Number of sectors/blocks in a chunk
   std::array<Cache, CACHE_LINES> m_cache;
+
+  bool m_read_ahead_enabled = false;
+  u64 m_last_chunk = UINT64_MAX;
+  std::vector<std::shared_ptr<ReadAheadChunk>> m_read_ahead;
+  std::vector<std::vector<u8>> m_free_buffers;
 };
 
 class CBlobBigEndianReader
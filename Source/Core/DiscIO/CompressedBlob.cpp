@@ -8,9 +8,11 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -22,6 +24,7 @@
 #include "Common/Hash.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/ThreadPool.h"
 #include "Common/StringUtil.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/CompressedBlob.h"
@@ -31,6 +34,54 @@ namespace DiscIO
 {
 bool IsGCZBlob(File::IOFile& file);
 
+// Blocks handed to the thread pool at once when converting images.
+static constexpr u32 CONVERT_BATCH_BLOCKS = 256;
+
+namespace
+{
+// A batch of blocks that is processed on the thread pool while the caller
+// reads the next batch or writes the previous one.
+class PipelineJob
+{
+public:
+  ~PipelineJob() { Wait(); }
+  void Start(std::function<void()> work)
+  {
+    m_done.store(false);
+    Common::AsyncWorker::ExecuteAsync([this, work] {
+      work();
+      m_done.store(true);
+    });
+  }
+  void Wait() const
+  {
+    size_t count = 0;
+    while (!m_done.load())
+      Common::cYield(count++);
+  }
+
+private:
+  std::atomic<bool> m_done{true};
+};
+
+struct ConvertBatch
+{
+  std::vector<u8> in_buf;
+  std::vector<u8> out_buf;
+  std::vector<int> comp_sizes;
+  u32 first = 0;
+  u32 count = 0;
+};
+}  // namespace
+
+struct CompressedBlobReader::BlockDecoder
+{
+  explicit BlockDecoder(u32 buffer_size) : buffer(buffer_size) { inflateInit(&stream); }
+  ~BlockDecoder() { inflateEnd(&stream); }
+  z_stream stream = {};
+  std::vector<u8> buffer;
+};
+
 CompressedBlobReader::CompressedBlobReader(File::IOFile file, const std::string& filename)
     : m_file(std::move(file)), m_file_name(filename)
 {
@@ -50,11 +101,9 @@ CompressedBlobReader::CompressedBlobReader(File::IOFile file, const std::string&
                   (sizeof(u64)) * m_header.num_blocks     // skip block pointers
                   + (sizeof(u32)) * m_header.num_blocks;  // skip hashes
 
-  // A compressed block is never ever longer than a decompressed block, so just header.block_size
-  // should be fine.
-  // I still add some safety margin.
-  const u32 zlib_buffer_size = m_header.block_size + 64;
-  m_zlib_buffer.resize(zlib_buffer_size);
+  // FMV and audio streams read through whole files, and every block costs a
+  // seek, a hash and an inflate. Images on slow storage stutter without this.
+  EnableReadAhead();
 }
 
 std::unique_ptr<CompressedBlobReader> CompressedBlobReader::Create(File::IOFile file,
@@ -69,6 +118,31 @@ std::unique_ptr<CompressedBlobReader> CompressedBlobReader::Create(File::IOFile
 
 CompressedBlobReader::~CompressedBlobReader()
 {
+  StopReadAhead();
+}
+
+std::unique_ptr<CompressedBlobReader::BlockDecoder> CompressedBlobReader::AcquireDecoder()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_decoders_lock);
+    if (!m_decoders.empty())
+    {
+      std::unique_ptr<BlockDecoder> decoder = std::move(m_decoders.back());
+      m_decoders.pop_back();
+      return decoder;
+    }
+  }
+
+  // A compressed block is never ever longer than a decompressed block, so just header.block_size
+  // should be fine.
+  // I still add some safety margin.
+  return std::make_unique<BlockDecoder>(m_header.block_size + 64);
+}
+
+void CompressedBlobReader::ReleaseDecoder(std::unique_ptr<BlockDecoder> decoder)
+{
+  std::lock_guard<std::mutex> lk(m_decoders_lock);
+  m_decoders.push_back(std::move(decoder));
 }
 
 // IMPORTANT: Calling this function invalidates all earlier pointers gotten from this function.
@@ -98,33 +172,48 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
     offset &= ~(1ULL << 63);
   }
 
+  std::unique_ptr<BlockDecoder> decoder = AcquireDecoder();
+  std::vector<u8>& zlib_buffer = decoder->buffer;
+  if (comp_block_size > zlib_buffer.size())
+  {
+    PanicAlert("We have a problem");
+    ReleaseDecoder(std::move(decoder));
+    return false;
+  }
+
   // clear unused part of zlib buffer. maybe this can be deleted when it works fully.
-  memset(&m_zlib_buffer[comp_block_size], 0, m_zlib_buffer.size() - comp_block_size);
+  memset(&zlib_buffer[comp_block_size], 0, zlib_buffer.size() - comp_block_size);
 
-  m_file.Seek(offset, SEEK_SET);
-  if (!m_file.ReadBytes(m_zlib_buffer.data(), comp_block_size))
   {
-    PanicAlertT("The disc image \"%s\" is truncated, some of the data is missing.",
-                m_file_name.c_str());
-    m_file.Clear();
-    return false;
+    std::lock_guard<std::mutex> lk(m_file_lock);
+    m_file.Seek(offset, SEEK_SET);
+    if (!m_file.ReadBytes(zlib_buffer.data(), comp_block_size))
+    {
+      m_file.Clear();
+      PanicAlertT("The disc image \"%s\" is truncated, some of the data is missing.",
+                  m_file_name.c_str());
+      ReleaseDecoder(std::move(decoder));
+      return false;
+    }
   }
 
   // First, check hash.
-  u32 block_hash = HashAdler32(m_zlib_buffer.data(), comp_block_size);
+  u32 block_hash = HashAdler32(zlib_buffer.data(), comp_block_size);
   if (block_hash != m_hashes[block_num])
     PanicAlertT("The disc image \"%s\" is corrupt.\n"
                 "Hash of block %" PRIu64 " is %08x instead of %08x.",
                 m_file_name.c_str(), block_num, block_hash, m_hashes[block_num]);
 
+  bool success = true;
   if (uncompressed)
   {
-    std::copy(m_zlib_buffer.begin(), m_zlib_buffer.begin() + comp_block_size, out_ptr);
+    std::copy(zlib_buffer.begin(), zlib_buffer.begin() + comp_block_size, out_ptr);
   }
   else
   {
-    z_stream z = {};
-    z.next_in = m_zlib_buffer.data();
+    z_stream& z = decoder->stream;
+    inflateReset(&z);
+    z.next_in = zlib_buffer.data();
     z.avail_in = comp_block_size;
     if (z.avail_in > m_header.block_size)
     {
@@ -132,7 +221,6 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
     }
     z.next_out = out_ptr;
     z.avail_out = m_header.block_size;
-    inflateInit(&z);
     int status = inflate(&z, Z_FULL_FLUSH);
     u32 uncomp_size = m_header.block_size - z.avail_out;
     if (status != Z_STREAM_END)
@@ -141,14 +229,14 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
       // to be sure, don't use compressed isos :P
       PanicAlert("Failure reading block %" PRIu64 " - out of data and not at end.", block_num);
     }
-    inflateEnd(&z);
     if (uncomp_size != m_header.block_size)
     {
       PanicAlert("Wrong block size");
-      return false;
+      success = false;
     }
   }
-  return true;
+  ReleaseDecoder(std::move(decoder));
+  return success;
 }
 
 bool CompressFileToBlob(const std::string& infile_path, const std::string& outfile_path,
@@ -192,10 +280,6 @@ bool CompressFileToBlob(const std::string& infile_path, const std::string& outfi
     scrubbing = true;
   }
 
-  z_stream z = {};
-  if (deflateInit(&z, 9) != Z_OK)
-    return false;
-
   callback(GetStringT("Files opened, ready to compress."), 0, arg);
 
   CompressedBlobHeader header;
@@ -207,10 +291,19 @@ bool CompressFileToBlob(const std::string& infile_path, const std::string& outfi
   // round upwards!
   header.num_blocks = (u32)((header.data_size + (block_size - 1)) / block_size);
 
+  // A three stage pipeline: this thread reads a batch and hands it to the
+  // thread pool for deflating, then writes the previous batch in order while
+  // the workers are busy. The output is identical to a serial run.
+  const u32 batch_blocks = std::min<u32>(CONVERT_BATCH_BLOCKS, std::max<u32>(header.num_blocks, 1));
   std::vector<u64> offsets(header.num_blocks);
   std::vector<u32> hashes(header.num_blocks);
-  std::vector<u8> out_buf(block_size);
-  std::vector<u8> in_buf(block_size);
+  ConvertBatch batches[2];
+  for (ConvertBatch& batch : batches)
+  {
+    batch.in_buf.resize(static_cast<size_t>(batch_blocks) * block_size);
+    batch.out_buf.resize(static_cast<size_t>(batch_blocks) * block_size);
+    batch.comp_sizes.resize(batch_blocks);
+  }
 
   // seek past the header (we will write it at the end)
   outfile.Seek(sizeof(CompressedBlobHeader), SEEK_CUR);
@@ -223,85 +316,166 @@ bool CompressFileToBlob(const std::string& infile_path, const std::string& outfi
   int num_stored = 0;
   int progress_monitor = std::max<int>(1, header.num_blocks / 1000);
   bool success = true;
+  std::atomic<bool> deflate_failed(false);
 
-  for (u32 i = 0; i < header.num_blocks; i++)
+  // Scrubbed clusters and disc padding are all zeros, and a zero block always
+  // deflates to the same bytes. It is compressed once here and copied after.
+  const std::vector<u8> zero_block(block_size);
+  std::vector<u8> zero_block_data(block_size);
+  int zero_block_size = -1;
   {
-    if (i % progress_monitor == 0)
-    {
-      const u64 inpos = infile.Tell();
-      int ratio = 0;
-      if (inpos != 0)
-        ratio = (int)(100 * position / inpos);
-
-      std::string temp =
-          StringFromFormat(GetStringT("%i of %i blocks. Compression ratio %i%%").c_str(), i,
-                           header.num_blocks, ratio);
-      bool was_cancelled = !callback(temp, (float)i / (float)header.num_blocks, arg);
-      if (was_cancelled)
-      {
-        success = false;
-        break;
-      }
-    }
-
-    offsets[i] = position;
-
-    size_t read_bytes;
-    if (scrubbing)
-      read_bytes = disc_scrubber.GetNextBlock(infile, in_buf.data());
-    else
-      infile.ReadArray(in_buf.data(), header.block_size, &read_bytes);
-    if (read_bytes < header.block_size)
-      std::fill(in_buf.begin() + read_bytes, in_buf.begin() + header.block_size, 0);
-
-    int retval = deflateReset(&z);
-    z.next_in = in_buf.data();
+    z_stream z = {};
+    if (deflateInit(&z, 9) != Z_OK)
+      return false;
+    z.next_in = const_cast<u8*>(zero_block.data());
     z.avail_in = header.block_size;
-    z.next_out = out_buf.data();
+    z.next_out = zero_block_data.data();
     z.avail_out = block_size;
+    if (deflate(&z, Z_FINISH) == Z_STREAM_END && z.avail_out >= 10)
+      zero_block_size = block_size - z.avail_out;
+    deflateEnd(&z);
+  }
 
-    if (retval != Z_OK)
+  auto deflate_batch = [&](ConvertBatch& batch) {
+    Common::AsyncWorker::ExecuteParallel(
+        [&](int lower, int upper) {
+          z_stream z = {};
+          if (deflateInit(&z, 9) != Z_OK)
+          {
+            deflate_failed.store(true);
+            return;
+          }
+          for (int j = lower; j < upper; j++)
+          {
+            const u8* in_block = &batch.in_buf[static_cast<size_t>(j) * block_size];
+            if (std::memcmp(in_block, zero_block.data(), block_size) == 0)
+            {
+              if (zero_block_size >= 0)
+              {
+                std::copy_n(zero_block_data.begin(), zero_block_size,
+                            &batch.out_buf[static_cast<size_t>(j) * block_size]);
+              }
+              batch.comp_sizes[j] = zero_block_size;
+              continue;
+            }
+
+            if (deflateReset(&z) != Z_OK)
+            {
+              deflate_failed.store(true);
+              break;
+            }
+            z.next_in = &batch.in_buf[static_cast<size_t>(j) * block_size];
+            z.avail_in = header.block_size;
+            z.next_out = &batch.out_buf[static_cast<size_t>(j) * block_size];
+            z.avail_out = block_size;
+
+            int status = deflate(&z, Z_FINISH);
+            // A negative size stores the block as-is
+            if ((status != Z_STREAM_END) || (z.avail_out < 10))
+              batch.comp_sizes[j] = -1;
+            else
+              batch.comp_sizes[j] = block_size - z.avail_out;
+          }
+          deflateEnd(&z);
+        },
+        0, batch.count, 4);
+  };
+
+  auto write_batch = [&](const ConvertBatch& batch) {
+    if (deflate_failed.load())
     {
       ERROR_LOG(DISCIO, "Deflate failed");
-      success = false;
-      break;
+      return false;
     }
 
-    int status = deflate(&z, Z_FINISH);
-    int comp_size = block_size - z.avail_out;
-
-    u8* write_buf;
-    int write_size;
-    if ((status != Z_STREAM_END) || (z.avail_out < 10))
-    {
-      // PanicAlert("%i %i Store %i", i*block_size, position, comp_size);
-      // let's store uncompressed
-      write_buf = in_buf.data();
-      offsets[i] |= 0x8000000000000000ULL;
-      write_size = block_size;
-      num_stored++;
-    }
-    else
+    for (u32 j = 0; j < batch.count; j++)
     {
-      // let's store compressed
-      // PanicAlert("Comp %i to %i", block_size, comp_size);
-      write_buf = out_buf.data();
-      write_size = comp_size;
-      num_compressed++;
+      const u32 i = batch.first + j;
+      if (i % progress_monitor == 0)
+      {
+        const u64 inpos = static_cast<u64>(i) * block_size;
+        int ratio = 0;
+        if (inpos != 0)
+          ratio = (int)(100 * position / inpos);
+
+        std::string temp =
+            StringFromFormat(GetStringT("%i of %i blocks. Compression ratio %i%%").c_str(), i,
+                             header.num_blocks, ratio);
+        bool was_cancelled = !callback(temp, (float)i / (float)header.num_blocks, arg);
+        if (was_cancelled)
+          return false;
+      }
+
+      offsets[i] = position;
+
+      const u8* write_buf;
+      int write_size;
+      if (batch.comp_sizes[j] < 0)
+      {
+        // let's store uncompressed
+        write_buf = &batch.in_buf[static_cast<size_t>(j) * block_size];
+        offsets[i] |= 0x8000000000000000ULL;
+        write_size = block_size;
+        num_stored++;
+      }
+      else
+      {
+        // let's store compressed
+        write_buf = &batch.out_buf[static_cast<size_t>(j) * block_size];
+        write_size = batch.comp_sizes[j];
+        num_compressed++;
+      }
+
+      if (!outfile.WriteBytes(write_buf, write_size))
+      {
+        PanicAlertT("Failed to write the output file \"%s\".\n"
+                    "Check that you have enough space available on the target drive.",
+                    outfile_path.c_str());
+        return false;
+      }
+
+      position += write_size;
+
+      hashes[i] = HashAdler32(write_buf, write_size);
     }
+    return true;
+  };
 
-    if (!outfile.WriteBytes(write_buf, write_size))
+  {
+    PipelineJob jobs[2];
+    int current = 0;
+    bool pending = false;
+    for (u32 first = 0; success && first < header.num_blocks; first += batch_blocks)
     {
-      PanicAlertT("Failed to write the output file \"%s\".\n"
-                  "Check that you have enough space available on the target drive.",
-                  outfile_path.c_str());
-      success = false;
-      break;
-    }
+      ConvertBatch& batch = batches[current];
+      batch.first = first;
+      batch.count = std::min(batch_blocks, header.num_blocks - first);
+      for (u32 j = 0; j < batch.count; j++)
+      {
+        u8* block = &batch.in_buf[static_cast<size_t>(j) * block_size];
+        size_t read_bytes;
+        if (scrubbing)
+          read_bytes = disc_scrubber.GetNextBlock(infile, block);
+        else
+          infile.ReadArray(block, header.block_size, &read_bytes);
+        if (read_bytes < header.block_size)
+          std::fill(block + read_bytes, block + header.block_size, 0);
+      }
+      jobs[current].Start([&deflate_batch, &batch] { deflate_batch(batch); });
 
-    position += write_size;
+      current ^= 1;
+      if (pending)
+      {
+        jobs[current].Wait();
+        success = write_batch(batches[current]);
+      }
+      pending = true;
+    }
 
-    hashes[i] = HashAdler32(write_buf, write_size);
+    current ^= 1;
+    jobs[current].Wait();
+    if (success && pending)
+      success = write_batch(batches[current]);
   }
 
   header.compressed_data_size = position;
@@ -321,9 +495,6 @@ bool CompressFileToBlob(const std::string& infile_path, const std::string& outfi
     outfile.WriteArray(hashes.data(), header.num_blocks);
   }
 
-  // Cleanup
-  deflateEnd(&z);
-
   if (success)
   {
     callback(GetStringT("Done compressing disc image."), 1.0f, arg);
@@ -362,36 +533,67 @@ bool DecompressBlobToFile(const std::string& infile_path, const std::string& out
     return false;
   }
 
+  // Blocks are inflated on the thread pool while the previous batch is written.
   const CompressedBlobHeader& header = reader->GetHeader();
-  static const size_t BUFFER_BLOCKS = 32;
-  size_t buffer_size = header.block_size * BUFFER_BLOCKS;
-  size_t last_buffer_size = header.block_size * (header.num_blocks % BUFFER_BLOCKS);
-  std::vector<u8> buffer(buffer_size);
-  u32 num_buffers = (header.num_blocks + BUFFER_BLOCKS - 1) / BUFFER_BLOCKS;
-  int progress_monitor = std::max<int>(1, num_buffers / 100);
+  const u32 block_size = header.block_size;
+  const u32 batch_blocks = std::min<u32>(CONVERT_BATCH_BLOCKS, std::max<u32>(header.num_blocks, 1));
+  ConvertBatch batches[2];
+  for (ConvertBatch& batch : batches)
+    batch.out_buf.resize(static_cast<size_t>(batch_blocks) * block_size);
+  std::atomic<bool> inflate_failed(false);
   bool success = true;
 
-  for (u64 i = 0; i < num_buffers; i++)
-  {
-    if (i % progress_monitor == 0)
-    {
-      bool was_cancelled = !callback(GetStringT("Unpacking"), (float)i / (float)num_buffers, arg);
-      if (was_cancelled)
-      {
-        success = false;
-        break;
-      }
-    }
-    const size_t sz = i == num_buffers - 1 ? last_buffer_size : buffer_size;
-    reader->Read(i * buffer_size, sz, buffer.data());
-    if (!outfile.WriteBytes(buffer.data(), sz))
+  auto inflate_batch = [&](ConvertBatch& batch) {
+    Common::AsyncWorker::ExecuteParallel(
+        [&](int lower, int upper) {
+          for (int j = lower; j < upper; j++)
+          {
+            if (!reader->GetBlock(batch.first + j, &batch.out_buf[static_cast<size_t>(j) * block_size]))
+              inflate_failed.store(true);
+          }
+        },
+        0, batch.count, 4);
+  };
+
+  auto write_batch = [&](const ConvertBatch& batch) {
+    if (inflate_failed.load())
+      return false;
+    if (!callback(GetStringT("Unpacking"), (float)batch.first / (float)header.num_blocks, arg))
+      return false;
+    if (!outfile.WriteBytes(batch.out_buf.data(), static_cast<size_t>(batch.count) * block_size))
     {
       PanicAlertT("Failed to write the output file \"%s\".\n"
                   "Check that you have enough space available on the target drive.",
                   outfile_path.c_str());
-      success = false;
-      break;
+      return false;
     }
+    return true;
+  };
+
+  {
+    PipelineJob jobs[2];
+    int current = 0;
+    bool pending = false;
+    for (u32 first = 0; success && first < header.num_blocks; first += batch_blocks)
+    {
+      ConvertBatch& batch = batches[current];
+      batch.first = first;
+      batch.count = std::min(batch_blocks, header.num_blocks - first);
+      jobs[current].Start([&inflate_batch, &batch] { inflate_batch(batch); });
+
+      current ^= 1;
+      if (pending)
+      {
+        jobs[current].Wait();
+        success = write_batch(batches[current]);
+      }
+      pending = true;
+    }
+
+    current ^= 1;
+    jobs[current].Wait();
+    if (success && pending)
+      success = write_batch(batches[current]);
   }
 
   if (!success)
@@ -405,7 +607,7 @@ bool DecompressBlobToFile(const std::string& infile_path, const std::string& out
     outfile.Resize(header.data_size);
   }
 
-  return true;
+  return success;
 }
 
 bool IsGCZBlob(File::IOFile& file)
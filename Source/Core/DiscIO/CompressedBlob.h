@@ -14,6 +14,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -55,16 +56,25 @@ public:
   bool GetBlock(u64 block_num, u8* out_ptr) override;
 
 private:
+  // A zlib stream and its input buffer, kept around between blocks. Blocks
+  // are read ahead on several threads, so there is one per concurrent read.
+  struct BlockDecoder;
+
   CompressedBlobReader(File::IOFile file, const std::string& filename);
 
+  std::unique_ptr<BlockDecoder> AcquireDecoder();
+  void ReleaseDecoder(std::unique_ptr<BlockDecoder> decoder);
+
   CompressedBlobHeader m_header;
   std::vector<u64> m_block_pointers;
   std::vector<u32> m_hashes;
   int m_data_offset;
+  std::mutex m_file_lock;
   File::IOFile m_file;
   u64 m_file_size;
-  std::vector<u8> m_zlib_buffer;
   std::string m_file_name;
+  std::mutex m_decoders_lock;
+  std::vector<std::unique_ptr<BlockDecoder>> m_decoders;
 };
 
 }  // namespace
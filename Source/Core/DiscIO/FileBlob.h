@@ -18,6 +18,7 @@ class PlainFileReader : public IBlobReader
 {
 public:
   static std::unique_ptr<PlainFileReader> Create(File::IOFile file);
+  ~PlainFileReader();
 
   BlobType GetBlobType() const override { return BlobType::PLAIN; }
   u64 GetDataSize() const override { return m_size; }
@@ -27,8 +28,20 @@ public:
 private:
   PlainFileReader(File::IOFile file);
 
+  // Maps the whole image read-only, so reads are copies from the page cache
+  // instead of a seek and an fread each. Falls back to the file on failure.
+  void MapFile();
+  void UnmapFile();
+  void PrefetchAfter(u64 offset);
+
   File::IOFile m_file;
   s64 m_size;
+  const u8* m_view = nullptr;
+#ifdef _WIN32
+  void* m_mapping = nullptr;
+#endif
+  u64 m_next_offset = 0;
+  u64 m_prefetched_end = 0;
 };
 
 }  // namespace
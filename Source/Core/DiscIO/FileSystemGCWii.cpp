@@ -5,7 +5,6 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstddef>
-#include <cstring>
 #include <string>
 #include <vector>
 
@@ -20,6 +19,18 @@
 
 namespace DiscIO
 {
+// Paths are only case insensitive for ASCII, like strcasecmp in the C locale
+static std::string LowerCasePath(const std::string& path)
+{
+	std::string lower(path);
+	for (char& c : lower)
+	{
+		if (c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+	}
+	return lower;
+}
+
 CFileSystemGCWii::CFileSystemGCWii(const IVolume* _rVolume)
 	: IFileSystem(_rVolume), m_Initialized(false), m_Valid(false), m_Wii(false)
 {
@@ -49,15 +60,21 @@ std::string CFileSystemGCWii::GetFileName(u64 _Address)
 	if (!m_Initialized)
 		InitFileSystem();
 
-	for (auto& fileInfo : m_FileInfoVector)
+	auto it = std::upper_bound(m_file_extents.begin(), m_file_extents.end(), _Address,
+		[](u64 address, const FileExtent& extent) { return address < extent.offset; });
+
+	// Files can overlap, the first one in the FST wins
+	size_t found = m_FileInfoVector.size();
+	while (it != m_file_extents.begin())
 	{
-		if ((fileInfo.m_Offset <= _Address) && ((fileInfo.m_Offset + fileInfo.m_FileSize) > _Address))
-		{
-			return fileInfo.m_FullPath;
-		}
+		--it;
+		if (it->max_end <= _Address)
+			break;
+		if (it->end > _Address)
+			found = std::min(found, it->index);
 	}
 
-	return "";
+	return found < m_FileInfoVector.size() ? m_FileInfoVector[found].m_FullPath : "";
 }
 
 u64 CFileSystemGCWii::ReadFile(const std::string& _rFullPath, u8* _pBuffer, u64 _MaxBufferSize,
@@ -239,13 +256,8 @@ const SFileInfo* CFileSystemGCWii::FindFileInfo(const std::string& _rFullPath)
 	if (!m_Initialized)
 		InitFileSystem();
 
-	for (auto& fileInfo : m_FileInfoVector)
-	{
-		if (!strcasecmp(fileInfo.m_FullPath.c_str(), _rFullPath.c_str()))
-			return &fileInfo;
-	}
-
-	return nullptr;
+	auto it = m_path_index.find(LowerCasePath(_rFullPath));
+	return it != m_path_index.end() ? &m_FileInfoVector[it->second] : nullptr;
 }
 
 bool CFileSystemGCWii::DetectFileSystem()
@@ -318,6 +330,32 @@ void CFileSystemGCWii::InitFileSystem()
 	}
 
 	BuildFilenames(1, m_FileInfoVector.size(), "", NameTableOffset);
+	BuildIndices();
+}
+
+void CFileSystemGCWii::BuildIndices()
+{
+	m_path_index.reserve(m_FileInfoVector.size());
+	m_file_extents.reserve(m_FileInfoVector.size());
+	for (size_t i = 0; i < m_FileInfoVector.size(); i++)
+	{
+		const SFileInfo& file_info = m_FileInfoVector[i];
+		m_path_index.emplace(LowerCasePath(file_info.m_FullPath), i);
+
+		// The offset and size of a directory are indices into the FST
+		if (!file_info.IsDirectory() && file_info.m_FileSize)
+			m_file_extents.push_back({file_info.m_Offset, file_info.m_Offset + file_info.m_FileSize, 0, i});
+	}
+
+	std::sort(m_file_extents.begin(), m_file_extents.end(), [](const FileExtent& a, const FileExtent& b) {
+		return a.offset < b.offset || (a.offset == b.offset && a.index < b.index);
+	});
+	u64 max_end = 0;
+	for (FileExtent& extent : m_file_extents)
+	{
+		max_end = std::max(max_end, extent.end);
+		extent.max_end = max_end;
+	}
 }
 
 size_t CFileSystemGCWii::BuildFilenames(const size_t _FirstIndex, const size_t _LastIndex,
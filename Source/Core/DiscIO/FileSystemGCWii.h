@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -39,10 +40,25 @@ private:
 	bool m_Wii;
 	std::vector<SFileInfo> m_FileInfoVector;
 
+	// Built once by InitFileSystem, the lookups are done for every logged disc read
+	struct FileExtent
+	{
+		u64 offset;
+		u64 end;
+		// Largest end of this and all previous extents, bounds the search for overlapping files
+		u64 max_end;
+		size_t index;
+	};
+	// Lower case full path to the index of its first entry
+	std::unordered_map<std::string, size_t> m_path_index;
+	// Files sorted by offset
+	std::vector<FileExtent> m_file_extents;
+
 	std::string GetStringFromOffset(u64 _Offset) const;
 	const SFileInfo* FindFileInfo(const std::string& _rFullPath);
 	bool DetectFileSystem();
 	void InitFileSystem();
+	void BuildIndices();
 	size_t BuildFilenames(const size_t _FirstIndex, const size_t _LastIndex,
 		const std::string& _szDirectory, u64 _NameTableOffset);
 	u32 GetOffsetShift() const;
@@ -29,6 +29,21 @@
 
 namespace DiscIO
 {
+// mbedtls uses AES-NI for this when the CPU has it
+static void AESDecode(const u8* key, u8* iv, const u8* src, u32 size, u8* dst)
+{
+	mbedtls_aes_context aes_ctx;
+	mbedtls_aes_setkey_dec(&aes_ctx, key, 128);
+	mbedtls_aes_crypt_cbc(&aes_ctx, MBEDTLS_AES_DECRYPT, size, iv, src, dst);
+}
+
+static std::vector<u8> AESDecode(const u8* key, u8* iv, const u8* src, u32 size)
+{
+	std::vector<u8> buffer(size);
+	AESDecode(key, iv, src, size, buffer.data());
+	return buffer;
+}
+
 CNANDContentData::~CNANDContentData() = default;
 
 CSharedContent::CSharedContent()
@@ -156,6 +171,54 @@ bool CNANDContentDataBuffer::GetRange(u32 start, u32 size, u8* buffer)
 	return true;
 }
 
+CNANDContentDataWAD::CNANDContentDataWAD(std::shared_ptr<const std::vector<u8>> data_app, u32 offset,
+	u32 size, const std::array<u8, 16>& key,
+	const std::array<u8, 16>& iv)
+	: m_data_app(std::move(data_app)), m_offset(offset), m_size(size), m_key(key), m_iv(iv)
+{
+}
+
+std::vector<u8> CNANDContentDataWAD::Get()
+{
+	std::call_once(m_decrypt_flag, [this] {
+		if (!IsInBounds())
+		{
+			ERROR_LOG(DISCIO, "WAD content at %08x is outside of the data", m_offset);
+			return;
+		}
+		std::array<u8, 16> iv = m_iv;
+		m_decrypted = AESDecode(m_key.data(), iv.data(), m_data_app->data() + m_offset, m_size);
+		m_is_decrypted.store(true, std::memory_order_release);
+	});
+	return m_decrypted;
+}
+
+bool CNANDContentDataWAD::GetRange(u32 start, u32 size, u8* buffer)
+{
+	if (static_cast<u64>(start) + size > m_size || !IsInBounds())
+		return false;
+
+	if (m_is_decrypted.load(std::memory_order_acquire))
+	{
+		std::copy(&m_decrypted[start], &m_decrypted[start + size], buffer);
+		return true;
+	}
+
+	// In CBC mode every block only depends on the previous encrypted block
+	const u32 first_block = start / 16;
+	const u32 end_block = (start + size + 15) / 16;
+	const u8* src = m_data_app->data() + m_offset;
+	std::array<u8, 16> iv = m_iv;
+	if (first_block)
+		std::copy(src + (first_block - 1) * 16, src + first_block * 16, iv.begin());
+
+	std::vector<u8> decrypted((end_block - first_block) * 16);
+	AESDecode(m_key.data(), iv.data(), src + first_block * 16, static_cast<u32>(decrypted.size()),
+		decrypted.data());
+	std::copy_n(&decrypted[start - first_block * 16], size, buffer);
+	return true;
+}
+
 CNANDContentLoader::CNANDContentLoader(const std::string& content_name)
 	: m_Valid(false), m_IsWAD(false), m_TitleID(-1), m_IosVersion(0x09), m_BootIndex(-1)
 {
@@ -186,7 +249,7 @@ bool CNANDContentLoader::Initialize(const std::string& name)
 	m_Path = name;
 
 	WiiWAD wad(name);
-	std::vector<u8> data_app;
+	std::shared_ptr<const std::vector<u8>> data_app;
 	std::vector<u8> tmd;
 	std::vector<u8> decrypted_title_key;
 
@@ -196,7 +259,7 @@ bool CNANDContentLoader::Initialize(const std::string& name)
 		m_Ticket = wad.GetTicket();
 		decrypted_title_key = GetKeyFromTicket(m_Ticket);
 		tmd = wad.GetTMD();
-		data_app = wad.GetDataApp();
+		data_app = std::make_shared<const std::vector<u8>>(wad.GetDataApp());
 	}
 	else
 	{
@@ -237,10 +300,13 @@ bool CNANDContentLoader::Initialize(const std::string& name)
 
 void CNANDContentLoader::InitializeContentEntries(const std::vector<u8>& tmd,
 	const std::vector<u8>& decrypted_title_key,
-	const std::vector<u8>& data_app)
+	const std::shared_ptr<const std::vector<u8>>& data_app)
 {
 	m_Content.resize(m_NumEntries);
 
+	std::array<u8, 16> key{};
+	if (m_IsWAD)
+		std::copy_n(decrypted_title_key.begin(), key.size(), key.begin());
 	std::array<u8, 16> iv;
 	u32 data_app_offset = 0;
 
@@ -269,8 +335,8 @@ void CNANDContentLoader::InitializeContentEntries(const std::vector<u8>& tmd,
 			iv.fill(0);
 			std::copy(&tmd[entry_offset + 0x01E8], &tmd[entry_offset + 0x01E8 + 2], iv.begin());
 
-			content.m_Data = std::make_unique<CNANDContentDataBuffer>(AESDecode(
-				decrypted_title_key.data(), iv.data(), &data_app[data_app_offset], rounded_size));
+			content.m_Data =
+				std::make_unique<CNANDContentDataWAD>(data_app, data_app_offset, rounded_size, key, iv);
 
 			data_app_offset += rounded_size;
 			continue;
@@ -290,17 +356,6 @@ void CNANDContentLoader::InitializeContentEntries(const std::vector<u8>& tmd,
 	}
 }
 
-std::vector<u8> CNANDContentLoader::AESDecode(const u8* key, u8* iv, const u8* src, u32 size)
-{
-	mbedtls_aes_context aes_ctx;
-	std::vector<u8> buffer(size);
-
-	mbedtls_aes_setkey_dec(&aes_ctx, key, 128);
-	mbedtls_aes_crypt_cbc(&aes_ctx, MBEDTLS_AES_DECRYPT, size, iv, src, buffer.data());
-
-	return buffer;
-}
-
 std::vector<u8> CNANDContentLoader::GetKeyFromTicket(const std::vector<u8>& ticket)
 {
 	const u8 common_key[16] = { 0xeb, 0xe4, 0x2a, 0x22, 0x5e, 0x85, 0x93, 0xe4,
@@ -325,13 +380,22 @@ CNANDContentManager::~CNANDContentManager()
 
 const CNANDContentLoader& CNANDContentManager::GetNANDLoader(const std::string& content_path)
 {
+	// Title directories are identified by their TMD
+	const std::string file_path =
+		!content_path.empty() && content_path.back() == '/' ? content_path + "title.tmd" : content_path;
+	const u64 modification_time = File::GetModificationTime(file_path);
+
 	auto it = m_map.find(content_path);
 	if (it != m_map.end())
-		return *it->second;
-	return *m_map
-		.emplace_hint(it, std::make_pair(content_path,
-			std::make_unique<CNANDContentLoader>(content_path)))
-		->second;
+	{
+		if (it->second.modification_time == modification_time)
+			return *it->second.loader;
+		m_stale_loaders.push_back(std::move(it->second.loader));
+		it->second = {std::make_unique<CNANDContentLoader>(content_path), modification_time};
+		return *it->second.loader;
+	}
+	CachedLoader cached{std::make_unique<CNANDContentLoader>(content_path), modification_time};
+	return *m_map.emplace_hint(it, content_path, std::move(cached))->second.loader;
 }
 
 const CNANDContentLoader& CNANDContentManager::GetNANDLoader(u64 title_id,
@@ -353,6 +417,7 @@ bool CNANDContentManager::RemoveTitle(u64 title_id, Common::FromWhichRoot from)
 void CNANDContentManager::ClearCache()
 {
 	m_map.clear();
+	m_stale_loaders.clear();
 }
 
 void CNANDContentLoader::RemoveTitle() const
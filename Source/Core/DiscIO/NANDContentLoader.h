@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -61,6 +64,30 @@ public:
 private:
 	const std::vector<u8> m_buffer;
 };
+// A content of a WAD, decrypted on first access. Ranges are decrypted on their own until the
+// whole content is needed, the data of all contents is shared.
+class CNANDContentDataWAD final : public CNANDContentData
+{
+public:
+	CNANDContentDataWAD(std::shared_ptr<const std::vector<u8>> data_app, u32 offset, u32 size,
+		const std::array<u8, 16>& key, const std::array<u8, 16>& iv);
+
+	std::vector<u8> Get() override;
+	bool GetRange(u32 start, u32 size, u8* buffer) override;
+
+private:
+	bool IsInBounds() const { return m_offset + static_cast<u64>(m_size) <= m_data_app->size(); }
+
+	const std::shared_ptr<const std::vector<u8>> m_data_app;
+	const u32 m_offset;
+	const u32 m_size;
+	const std::array<u8, 16> m_key;
+	const std::array<u8, 16> m_iv;
+
+	std::once_flag m_decrypt_flag;
+	std::atomic<bool> m_is_decrypted{false};
+	std::vector<u8> m_decrypted;
+};
 
 struct SNANDContent
 {
@@ -108,9 +135,8 @@ private:
 	bool Initialize(const std::string& name);
 	void InitializeContentEntries(const std::vector<u8>& tmd,
 		const std::vector<u8>& decrypted_title_key,
-		const std::vector<u8>& data_app);
+		const std::shared_ptr<const std::vector<u8>>& data_app);
 
-	static std::vector<u8> AESDecode(const u8* key, u8* iv, const u8* src, u32 size);
 	static std::vector<u8> GetKeyFromTicket(const std::vector<u8>& ticket);
 
 	bool m_Valid;
@@ -130,6 +156,8 @@ private:
 };
 
 // we open the NAND Content files too often... let's cache them
+// Loaders are reloaded when the modification time of their TMD or WAD changed. The replaced ones
+// are kept until ClearCache, ES may still point into their contents.
 class CNANDContentManager
 {
 public:
@@ -152,7 +180,13 @@ private:
 	CNANDContentManager(CNANDContentManager const&) = delete;
 	void operator=(CNANDContentManager const&) = delete;
 
-	std::unordered_map<std::string, std::unique_ptr<CNANDContentLoader>> m_map;
+	struct CachedLoader
+	{
+		std::unique_ptr<CNANDContentLoader> loader;
+		u64 modification_time;
+	};
+	std::unordered_map<std::string, CachedLoader> m_map;
+	std::vector<std::unique_ptr<CNANDContentLoader>> m_stale_loaders;
 };
 
 class CSharedContent
@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <map>
@@ -30,7 +31,7 @@ namespace DiscIO
 CVolumeWiiCrypted::CVolumeWiiCrypted(std::unique_ptr<IBlobReader> reader, u64 _VolumeOffset,
 	const unsigned char* _pVolumeKey)
 	: m_pReader(std::move(reader)), m_AES_ctx(std::make_unique<mbedtls_aes_context>()),
-	m_VolumeOffset(_VolumeOffset), m_dataOffset(0x20000), m_LastDecryptedBlockOffset(-1)
+	m_VolumeOffset(_VolumeOffset), m_dataOffset(0x20000), m_cache(s_cache_blocks)
 {
 	mbedtls_aes_setkey_dec(m_AES_ctx.get(), _pVolumeKey, 128);
 }
@@ -38,7 +39,7 @@ CVolumeWiiCrypted::CVolumeWiiCrypted(std::unique_ptr<IBlobReader> reader, u64 _V
 bool CVolumeWiiCrypted::ChangePartition(u64 offset)
 {
 	m_VolumeOffset = offset;
-	m_LastDecryptedBlockOffset = -1;
+	ClearCache();
 
 	u8 volume_key[16];
 	DiscIO::VolumeKeyForPartition(*m_pReader, offset, volume_key);
@@ -50,6 +51,64 @@ CVolumeWiiCrypted::~CVolumeWiiCrypted()
 {
 }
 
+void CVolumeWiiCrypted::ClearCache()
+{
+	for (DecryptedBlock& entry : m_cache)
+		entry.block = UINT64_MAX;
+}
+
+const u8* CVolumeWiiCrypted::GetDecryptedBlock(u64 block, u64 last_block) const
+{
+	for (DecryptedBlock& entry : m_cache)
+	{
+		if (entry.block == block)
+		{
+			entry.last_used = ++m_cache_tick;
+			return entry.data;
+		}
+	}
+
+	// Read this block and the following ones of the request that aren't cached
+	u64 count = 1;
+	while (count < s_max_read_blocks && block + count <= last_block &&
+		std::none_of(m_cache.begin(), m_cache.end(),
+			[&](const DecryptedBlock& entry) { return entry.block == block + count; }))
+	{
+		count++;
+	}
+
+	m_read_buffer.resize(static_cast<size_t>(count) * s_block_total_size);
+	if (!m_pReader->Read(m_VolumeOffset + m_dataOffset + block * s_block_total_size,
+		count * s_block_total_size, m_read_buffer.data()))
+		return nullptr;
+
+	const u8* result = nullptr;
+	for (u64 i = 0; i < count; i++)
+	{
+		DecryptedBlock& entry = *std::min_element(m_cache.begin(), m_cache.end(),
+			[](const DecryptedBlock& a, const DecryptedBlock& b) { return a.last_used < b.last_used; });
+		u8* raw = &m_read_buffer[static_cast<size_t>(i) * s_block_total_size];
+
+		// Decrypt the block's data.
+		// 0x3D0 - 0x3DF in the raw block will be overwritten,
+		// but that won't affect anything, because we won't
+		// use the content of the raw block anymore after this
+		mbedtls_aes_crypt_cbc(m_AES_ctx.get(), MBEDTLS_AES_DECRYPT, s_block_data_size, &raw[0x3D0],
+			&raw[s_block_header_size], entry.data);
+		entry.block = block + i;
+		entry.last_used = ++m_cache_tick;
+		if (i == 0)
+			result = entry.data;
+
+		// The only thing we currently use from the 0x000 - 0x3FF part
+		// of the block is the IV (at 0x3D0), but it also contains SHA-1
+		// hashes that IOS uses to check that discs aren't tampered with.
+		// http://wiibrew.org/wiki/Wii_Disc#Encrypted
+	}
+
+	return result;
+}
+
 bool CVolumeWiiCrypted::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, bool decrypt) const
 {
 	if (m_pReader == nullptr)
@@ -60,39 +119,21 @@ bool CVolumeWiiCrypted::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, bool de
 
 	FileMon::FindFilename(_ReadOffset);
 
-	std::vector<u8> read_buffer(s_block_total_size);
+	const u64 last_block = _Length ? (_ReadOffset + _Length - 1) / s_block_data_size : 0;
 	while (_Length > 0)
 	{
 		// Calculate block offset
 		u64 Block = _ReadOffset / s_block_data_size;
 		u64 Offset = _ReadOffset % s_block_data_size;
 
-		if (m_LastDecryptedBlockOffset != Block)
-		{
-			// Read the current block
-			if (!m_pReader->Read(m_VolumeOffset + m_dataOffset + Block * s_block_total_size,
-				s_block_total_size, read_buffer.data()))
-				return false;
-
-			// Decrypt the block's data.
-			// 0x3D0 - 0x3DF in m_pBuffer will be overwritten,
-			// but that won't affect anything, because we won't
-			// use the content of m_pBuffer anymore after this
-			mbedtls_aes_crypt_cbc(m_AES_ctx.get(), MBEDTLS_AES_DECRYPT, s_block_data_size,
-				&read_buffer[0x3D0], &read_buffer[s_block_header_size],
-				m_LastDecryptedBlock);
-			m_LastDecryptedBlockOffset = Block;
-
-			// The only thing we currently use from the 0x000 - 0x3FF part
-			// of the block is the IV (at 0x3D0), but it also contains SHA-1
-			// hashes that IOS uses to check that discs aren't tampered with.
-			// http://wiibrew.org/wiki/Wii_Disc#Encrypted
-		}
+		const u8* decrypted = GetDecryptedBlock(Block, last_block);
+		if (!decrypted)
+			return false;
 
 		// Copy the decrypted data
 		u64 MaxSizeToCopy = s_block_data_size - Offset;
 		u64 CopySize = (_Length > MaxSizeToCopy) ? MaxSizeToCopy : _Length;
-		memcpy(_pBuffer, &m_LastDecryptedBlock[Offset], (size_t)CopySize);
+		memcpy(_pBuffer, &decrypted[Offset], (size_t)CopySize);
 
 		// Update offsets
 		_Length -= CopySize;
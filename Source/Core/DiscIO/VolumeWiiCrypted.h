@@ -56,14 +56,31 @@ private:
 	static const unsigned int s_block_data_size = 0x7C00;
 	static const unsigned int s_block_total_size = s_block_header_size + s_block_data_size;
 
+	// Decrypted blocks are kept in a small LRU cache (2 MiB), so games that
+	// keep reading the same data don't pay for AES every time. Misses read
+	// up to s_max_read_blocks consecutive blocks with a single blob read.
+	static const size_t s_cache_blocks = 64;
+	static const size_t s_max_read_blocks = 16;
+
+	struct DecryptedBlock
+	{
+		u64 block = UINT64_MAX;
+		u64 last_used = 0;
+		u8 data[s_block_data_size];
+	};
+
+	const u8* GetDecryptedBlock(u64 block, u64 last_block) const;
+	void ClearCache();
+
 	std::unique_ptr<IBlobReader> m_pReader;
 	std::unique_ptr<mbedtls_aes_context> m_AES_ctx;
 
 	u64 m_VolumeOffset;
 	u64 m_dataOffset;
 
-	mutable u64 m_LastDecryptedBlockOffset;
-	mutable unsigned char m_LastDecryptedBlock[s_block_data_size];
+	mutable std::vector<DecryptedBlock> m_cache;
+	mutable std::vector<u8> m_read_buffer;
+	mutable u64 m_cache_tick = 0;
 };
 
 }  // namespace
@@ -49,11 +49,20 @@ void AudioConfigPane::InitializeGUI()
 	m_audio_latency_label = new wxStaticText(this, wxID_ANY, _("Latency:"));
 
 	m_time_stretching_checkbox = new wxCheckBox(this, wxID_ANY, _("Time Stretching"));
+	m_stretch_latency_spinctrl =
+		new wxSpinCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 5, 300);
+	m_stretch_latency_label = new wxStaticText(this, wxID_ANY, _("Stretch Latency:"));
 	m_RS_Hack_checkbox = new wxCheckBox(this, wxID_ANY, _("Rogue Squadron 2/3 Hack"));
 	m_audio_backend_choice->SetToolTip(
 		_("Changing this will have no effect while the emulator is running."));
 	m_audio_latency_spinctrl->SetToolTip(_("Sets the latency (in ms). Higher values may reduce audio "
-		"crackling. Certain backends only."));
+		"crackling. Certain backends only.\n\nThe latency actually measured is shown with the "
+		"statistics overlay. For the lowest latency, use WASAPI exclusive mode on Windows."));
+	m_time_stretching_checkbox->SetToolTip(
+		_("Stretches the audio to the emulation speed instead of changing its pitch. Keeps sound "
+			"smooth when the emulation speed fluctuates."));
+	m_stretch_latency_spinctrl->SetToolTip(_("Sets the amount of stretched audio buffered (in ms). "
+		"It is raised temporarily when the audio runs dry."));
 	m_dpl2_decoder_checkbox->SetToolTip(
 		_("Enables Dolby Pro Logic II emulation using 5.1 surround. Certain backends only."));
 
@@ -65,6 +74,12 @@ void AudioConfigPane::InitializeGUI()
 	dsp_engine_sizer->AddSpacer(space5);
 	dsp_engine_sizer->AddStretchSpacer();
 	dsp_engine_sizer->Add(m_time_stretching_checkbox, 0, wxLEFT | wxRIGHT, space5);
+	dsp_engine_sizer->AddSpacer(space5);
+	wxBoxSizer* const stretch_latency_sizer = new wxBoxSizer(wxHORIZONTAL);
+	stretch_latency_sizer->Add(m_stretch_latency_label, 0, wxALIGN_CENTER_VERTICAL);
+	stretch_latency_sizer->AddSpacer(space5);
+	stretch_latency_sizer->Add(m_stretch_latency_spinctrl, 0, wxALIGN_CENTER_VERTICAL);
+	dsp_engine_sizer->Add(stretch_latency_sizer, 0, wxLEFT | wxRIGHT, space5);
 	dsp_engine_sizer->AddStretchSpacer();
 	dsp_engine_sizer->AddSpacer(space5);
 	dsp_engine_sizer->Add(m_RS_Hack_checkbox, 0, wxLEFT | wxRIGHT, space5);
@@ -129,6 +144,9 @@ void AudioConfigPane::LoadGUIValues()
 	m_audio_latency_spinctrl->SetValue(startup_params.iLatency);
 
 	m_time_stretching_checkbox->SetValue(startup_params.bTimeStretching);
+	m_stretch_latency_spinctrl->SetValue(startup_params.iTimeStretchLatency);
+	m_stretch_latency_spinctrl->Enable(startup_params.bTimeStretching);
+	m_stretch_latency_label->Enable(startup_params.bTimeStretching);
 	m_RS_Hack_checkbox->SetValue(startup_params.bRSHACK);
 }
 
@@ -162,6 +180,7 @@ void AudioConfigPane::BindEvents()
 	m_audio_latency_spinctrl->Bind(wxEVT_SPINCTRL, &AudioConfigPane::OnLatencySpinCtrlChanged, this);
 	m_audio_latency_spinctrl->Bind(wxEVT_UPDATE_UI, &WxEventUtils::OnEnableIfCoreNotRunning);
 	m_time_stretching_checkbox->Bind(wxEVT_CHECKBOX, &AudioConfigPane::OnTimeStretchingCheckBoxChanged, this);
+	m_stretch_latency_spinctrl->Bind(wxEVT_SPINCTRL, &AudioConfigPane::OnStretchLatencySpinCtrlChanged, this);
 	m_RS_Hack_checkbox->Bind(wxEVT_CHECKBOX, &AudioConfigPane::OnRS_Hack_checkboxChanged, this);
 }
 
@@ -180,6 +199,13 @@ void AudioConfigPane::OnDPL2DecoderCheckBoxChanged(wxCommandEvent&)
 void AudioConfigPane::OnTimeStretchingCheckBoxChanged(wxCommandEvent&)
 {
 	SConfig::GetInstance().bTimeStretching = m_time_stretching_checkbox->IsChecked();
+	m_stretch_latency_spinctrl->Enable(m_time_stretching_checkbox->IsChecked());
+	m_stretch_latency_label->Enable(m_time_stretching_checkbox->IsChecked());
+}
+
+void AudioConfigPane::OnStretchLatencySpinCtrlChanged(wxCommandEvent&)
+{
+	SConfig::GetInstance().iTimeStretchLatency = m_stretch_latency_spinctrl->GetValue();
 }
 
 void AudioConfigPane::OnRS_Hack_checkboxChanged(wxCommandEvent&)
@@ -34,6 +34,7 @@ private:
 	void OnAudioBackendChanged(wxCommandEvent&);
 	void OnLatencySpinCtrlChanged(wxCommandEvent&);
 	void OnTimeStretchingCheckBoxChanged(wxCommandEvent&);
+	void OnStretchLatencySpinCtrlChanged(wxCommandEvent&);
 	void OnRS_Hack_checkboxChanged(wxCommandEvent&);
 
 	wxArrayString m_dsp_engine_strings;
@@ -46,6 +47,8 @@ private:
 	wxChoice* m_audio_backend_choice;
 	wxSpinCtrl* m_audio_latency_spinctrl;
 	wxCheckBox* m_time_stretching_checkbox;
+	wxSpinCtrl* m_stretch_latency_spinctrl;
+	wxStaticText* m_stretch_latency_label;
 	wxCheckBox* m_RS_Hack_checkbox;
 	wxStaticText* m_audio_latency_label;
 };
@@ -64,6 +64,7 @@ void GeneralConfigPane::InitializeGUI()
 #endif
 	m_throttler_choice =
 		new wxChoice(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, m_throttler_array_string);
+	m_frame_pacing_checkbox = new wxCheckBox(this, wxID_ANY, _("Low Latency Frame Pacing"));
 	m_cpu_engine_radiobox =
 		new wxRadioBox(this, wxID_ANY, _("CPU Emulator Engine"), wxDefaultPosition, wxDefaultSize,
 			m_cpu_engine_array_string, 0, wxRA_SPECIFY_ROWS);
@@ -86,6 +87,10 @@ void GeneralConfigPane::InitializeGUI()
 	m_throttler_choice->SetToolTip(_("Limits the emulation speed to the specified percentage.\nNote "
 		"that raising or lowering the emulation speed will also raise "
 		"or lower the audio pitch to prevent audio from stuttering."));
+	m_frame_pacing_checkbox->SetToolTip(
+		_("Emulates each frame in one go, just before it is due, instead of spreading it over the "
+			"whole frame. Controller input is then read closer to the moment the frame is shown.\n"
+			"Needs a CPU that is comfortably faster than full speed for the game."));
 
 	const int space5 = FromDIP(5);
 
@@ -105,6 +110,8 @@ void GeneralConfigPane::InitializeGUI()
 	basic_settings_sizer->Add(m_cheats_checkbox, 0, wxLEFT | wxRIGHT, space5);
 	basic_settings_sizer->AddSpacer(space5);
 	basic_settings_sizer->Add(throttler_sizer);
+	basic_settings_sizer->Add(m_frame_pacing_checkbox, 0, wxLEFT | wxRIGHT, space5);
+	basic_settings_sizer->AddSpacer(space5);
 
 	wxStaticBoxSizer* const analytics_sizer =
 		new wxStaticBoxSizer(wxVERTICAL, this, _("Usage Statistics Reporting Settings"));
@@ -145,6 +152,7 @@ void GeneralConfigPane::LoadGUIValues()
 	u32 selection = std::lround(startup_params.m_EmulationSpeed * 10.0f);
 	if (selection < m_throttler_array_string.size())
 		m_throttler_choice->SetSelection(selection);
+	m_frame_pacing_checkbox->SetValue(startup_params.bLowLatencyFramePacing);
 
 	for (size_t i = 0; i < m_cpu_cores.size(); ++i)
 	{
@@ -170,6 +178,8 @@ void GeneralConfigPane::BindEvents()
 	m_analytics_new_id->Bind(wxEVT_BUTTON, &GeneralConfigPane::OnAnalyticsNewIdButtonClick, this);
 
 	m_throttler_choice->Bind(wxEVT_CHOICE, &GeneralConfigPane::OnThrottlerChoiceChanged, this);
+	m_frame_pacing_checkbox->Bind(wxEVT_CHECKBOX, &GeneralConfigPane::OnFramePacingCheckBoxChanged,
+		this);
 
 	m_cpu_engine_radiobox->Bind(wxEVT_RADIOBOX, &GeneralConfigPane::OnCPUEngineRadioBoxChanged, this);
 	m_cpu_engine_radiobox->Bind(wxEVT_UPDATE_UI, &WxEventUtils::OnEnableIfCoreNotRunning);
@@ -199,6 +209,11 @@ void GeneralConfigPane::OnThrottlerChoiceChanged(wxCommandEvent& event)
 		SConfig::GetInstance().m_EmulationSpeed = m_throttler_choice->GetSelection() * 0.1f;
 }
 
+void GeneralConfigPane::OnFramePacingCheckBoxChanged(wxCommandEvent& event)
+{
+	SConfig::GetInstance().bLowLatencyFramePacing = m_frame_pacing_checkbox->IsChecked();
+}
+
 void GeneralConfigPane::OnCPUEngineRadioBoxChanged(wxCommandEvent& event)
 {
 	SConfig::GetInstance().iCPUCore = m_cpu_cores.at(event.GetSelection()).CPUid;
@@ -33,6 +33,7 @@ private:
 	void OnCheatCheckBoxChanged(wxCommandEvent&);
 	void OnForceNTSCJCheckBoxChanged(wxCommandEvent&);
 	void OnThrottlerChoiceChanged(wxCommandEvent&);
+	void OnFramePacingCheckBoxChanged(wxCommandEvent&);
 	void OnCPUEngineRadioBoxChanged(wxCommandEvent&);
 	void OnAnalyticsCheckBoxChanged(wxCommandEvent&);
 	void OnAnalyticsNewIdButtonClick(wxCommandEvent&);
@@ -48,6 +49,7 @@ private:
 	wxButton* m_analytics_new_id;
 
 	wxChoice* m_throttler_choice;
+	wxCheckBox* m_frame_pacing_checkbox;
 
 	wxRadioBox* m_cpu_engine_radiobox;
 };
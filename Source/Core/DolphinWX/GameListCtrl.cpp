@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cmath>
 #include <cstddef>
@@ -44,6 +45,8 @@
 #include "Common/MathUtil.h"
 #include "Common/StringUtil.h"
 #include "Common/SysConf.h"
+#include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Core/Boot/Boot.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -590,25 +593,60 @@ void CGameListCtrl::ScanForISOs()
 
 	if (rFilenames.size() > 0)
 	{
+		GameListCache cache;
+		cache.Load();
+
 		wxProgressDialog dialog(
 			_("Scanning for ISOs"), _("Scanning..."), (int)rFilenames.size() - 1, this,
 			wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME | wxPD_ESTIMATED_TIME |
 			wxPD_REMAINING_TIME | wxPD_SMOOTH  // - makes updates as small as possible (down to 1px)
 		);
 
-		for (u32 i = 0; i < rFilenames.size(); i++)
+		// Images are opened on the thread pool, mostly to hide the I/O latency of
+		// network shares. Each worker pulls the next file, so one slow image does
+		// not hold up the others. This thread keeps the dialog responsive.
+		std::vector<std::unique_ptr<GameListItem>> iso_files(rFilenames.size());
+		std::atomic<int> next_file(0);
+		std::atomic<int> files_done(0);
+		std::atomic<int> last_done(0);
+		std::atomic<bool> cancelled(false);
+		std::atomic<bool> finished(false);
+		const int file_count = (int)rFilenames.size();
+		Common::AsyncWorker::ExecuteAsync([&] {
+			Common::AsyncWorker::ExecuteParallel(
+				[&](int, int) {
+					int i;
+					while (!cancelled.load() && (i = next_file.fetch_add(1)) < file_count)
+					{
+						iso_files[i] = std::make_unique<GameListItem>(rFilenames[i], custom_title_map,
+							&cache);
+						last_done.store(i);
+						files_done.fetch_add(1);
+					}
+				},
+				0, file_count, 1);
+			finished.store(true);
+		});
+
+		while (!finished.load())
 		{
 			std::string FileName;
-			SplitPath(rFilenames[i], nullptr, &FileName, nullptr);
+			SplitPath(rFilenames[last_done.load()], nullptr, &FileName, nullptr);
 
-			// Update with the progress (i) and the message
-			dialog.Update(i, wxString::Format(_("Scanning %s"), StrToWxStr(FileName)));
+			// Update with the progress and the most recently scanned file
+			dialog.Update(std::min(files_done.load(), file_count - 1),
+				wxString::Format(_("Scanning %s"), StrToWxStr(FileName)));
 			if (dialog.WasCancelled())
-				break;
+				cancelled.store(true);
+			Common::SleepCurrentThread(10);
+		}
 
-			auto iso_file = std::make_unique<GameListItem>(rFilenames[i], custom_title_map);
+		if (!cancelled.load())
+			cache.Save();
 
-			if (iso_file->IsValid())
+		for (auto& iso_file : iso_files)
+		{
+			if (iso_file && iso_file->IsValid())
 			{
 				bool list = true;
 
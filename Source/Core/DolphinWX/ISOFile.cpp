@@ -37,6 +37,7 @@
 #include "DolphinWX/WxUtils.h"
 
 static const u32 CACHE_REVISION = 0x127;  // Last changed in PR 3309
+static const char GAME_LIST_CACHE_NAME[] = "gamelist.cache";
 
 static std::string GetLanguageString(DiscIO::Language language,
 	std::map<DiscIO::Language, std::string> strings)
@@ -62,10 +63,10 @@ static std::string GetLanguageString(DiscIO::Language language,
 }
 
 GameListItem::GameListItem(const std::string& _rFileName,
-	const std::unordered_map<std::string, std::string>& custom_titles)
+	const std::unordered_map<std::string, std::string>& custom_titles, GameListCache* cache)
 	: m_FileName(_rFileName), m_title_id(0), m_emu_state(0), m_FileSize(0),
 	m_Country(DiscIO::Country::COUNTRY_UNKNOWN), m_Revision(0), m_Valid(false), m_ImageWidth(0),
-	m_ImageHeight(0), m_disc_number(0), m_has_custom_name(false)
+	m_ImageHeight(0), m_disc_number(0), m_has_custom_name(false), m_cache(cache)
 {
 	if (LoadFromCache())
 	{
@@ -192,17 +193,155 @@ void GameListItem::ReloadINI()
 	}
 }
 
-bool GameListItem::LoadFromCache()
+void GameListCache::Load()
 {
-	return CChunkFileReader::Load<GameListItem>(CreateCacheFilename(), CACHE_REVISION, *this);
+	std::lock_guard<std::mutex> lk(m_lock);
+	m_entries.clear();
+	m_dirty = false;
+	CChunkFileReader::Load<GameListCache>(File::GetUserPath(D_CACHE_IDX) + GAME_LIST_CACHE_NAME,
+		CACHE_REVISION, *this);
 }
 
-void GameListItem::SaveToCache()
+void GameListCache::Save()
 {
+	std::lock_guard<std::mutex> lk(m_lock);
+
+	// Forget images that were not seen by this scan
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (it->second.used)
+		{
+			++it;
+		}
+		else
+		{
+			it = m_entries.erase(it);
+			m_dirty = true;
+		}
+	}
+
+	if (!m_dirty)
+		return;
+
 	if (!File::IsDirectory(File::GetUserPath(D_CACHE_IDX)))
 		File::CreateDir(File::GetUserPath(D_CACHE_IDX));
 
-	CChunkFileReader::Save<GameListItem>(CreateCacheFilename(), CACHE_REVISION, *this);
+	CChunkFileReader::Save<GameListCache>(File::GetUserPath(D_CACHE_IDX) + GAME_LIST_CACHE_NAME,
+		CACHE_REVISION, *this);
+	m_dirty = false;
+}
+
+bool GameListCache::Find(const std::string& path, u64 size, s64 mtime, std::vector<u8>* state)
+{
+	std::lock_guard<std::mutex> lk(m_lock);
+	auto it = m_entries.find(path);
+	if (it == m_entries.end() || it->second.size != size || it->second.mtime != mtime)
+		return false;
+
+	it->second.used = true;
+	*state = it->second.state;
+	return true;
+}
+
+void GameListCache::Store(const std::string& path, u64 size, s64 mtime, std::vector<u8> state)
+{
+	std::lock_guard<std::mutex> lk(m_lock);
+	Entry& entry = m_entries[path];
+	entry.size = size;
+	entry.mtime = mtime;
+	entry.state = std::move(state);
+	entry.used = true;
+	m_dirty = true;
+}
+
+// Called with m_lock held by Load and Save
+void GameListCache::DoState(PointerWrap& p)
+{
+	u32 count = (u32)m_entries.size();
+	p.Do(count);
+
+	if (p.GetMode() == PointerWrap::MODE_READ)
+	{
+		for (; count != 0; --count)
+		{
+			std::string path;
+			Entry entry;
+			p.Do(path);
+			p.Do(entry.size);
+			p.Do(entry.mtime);
+			p.Do(entry.state);
+			m_entries.emplace(std::move(path), std::move(entry));
+		}
+	}
+	else
+	{
+		for (auto& elem : m_entries)
+		{
+			std::string path = elem.first;
+			p.Do(path);
+			p.Do(elem.second.size);
+			p.Do(elem.second.mtime);
+			p.Do(elem.second.state);
+		}
+	}
+}
+
+bool GameListItem::GetCacheKey(u64* size, s64* mtime) const
+{
+	std::string name;
+	SplitPath(m_FileName, nullptr, &name, nullptr);
+	if (name.empty())
+		return false;  // Disc Drive
+
+	*size = File::GetSize(m_FileName);
+	*mtime = static_cast<s64>(wxFileModificationTime(StrToWxStr(m_FileName)));
+	return true;
+}
+
+bool GameListItem::LoadFromCache()
+{
+	if (!m_cache)
+		return CChunkFileReader::Load<GameListItem>(CreateCacheFilename(), CACHE_REVISION, *this);
+
+	u64 size;
+	s64 mtime;
+	std::vector<u8> state;
+	if (!GetCacheKey(&size, &mtime) || !m_cache->Find(m_FileName, size, mtime, &state) ||
+		state.empty())
+	{
+		return false;
+	}
+
+	u8* ptr = state.data();
+	PointerWrap p(&ptr, PointerWrap::MODE_READ);
+	DoState(p);
+	return true;
+}
+
+void GameListItem::SaveToCache()
+{
+	if (!m_cache)
+	{
+		if (!File::IsDirectory(File::GetUserPath(D_CACHE_IDX)))
+			File::CreateDir(File::GetUserPath(D_CACHE_IDX));
+
+		CChunkFileReader::Save<GameListItem>(CreateCacheFilename(), CACHE_REVISION, *this);
+		return;
+	}
+
+	u64 size;
+	s64 mtime;
+	if (!GetCacheKey(&size, &mtime))
+		return;
+
+	u8* ptr = nullptr;
+	PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+	DoState(p);
+	std::vector<u8> state(reinterpret_cast<size_t>(ptr));
+	ptr = state.data();
+	p.SetMode(PointerWrap::MODE_WRITE);
+	DoState(p);
+	m_cache->Store(m_FileName, size, mtime, std::move(state));
 }
 
 void GameListItem::DoState(PointerWrap& p)
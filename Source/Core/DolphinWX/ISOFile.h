@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -26,11 +28,40 @@ enum class Platform;
 
 class PointerWrap;
 
+// Cached state of every game list item in a single file, keyed by path, size
+// and modification time. A rescan only has to stat unchanged images instead
+// of opening them or a cache file for each one. Lookups are thread-safe.
+class GameListCache
+{
+public:
+	void Load();
+	void Save();
+
+	bool Find(const std::string& path, u64 size, s64 mtime, std::vector<u8>* state);
+	void Store(const std::string& path, u64 size, s64 mtime, std::vector<u8> state);
+
+	void DoState(PointerWrap& p);
+
+private:
+	struct Entry
+	{
+		u64 size = 0;
+		s64 mtime = 0;
+		std::vector<u8> state;
+		bool used = false;
+	};
+
+	std::mutex m_lock;
+	std::map<std::string, Entry> m_entries;
+	bool m_dirty = false;
+};
+
 class GameListItem
 {
 public:
 	GameListItem(const std::string& _rFileName,
-		const std::unordered_map<std::string, std::string>& custom_titles);
+		const std::unordered_map<std::string, std::string>& custom_titles,
+		GameListCache* cache = nullptr);
 	~GameListItem();
 
 	// Reload settings after INI changes
@@ -99,6 +130,9 @@ private:
 	std::string m_custom_name;             // Custom title from INI or titles.txt
 	bool m_has_custom_name;
 
+	GameListCache* m_cache;
+
+	bool GetCacheKey(u64* size, s64* mtime) const;
 	bool LoadFromCache();
 	void SaveToCache();
 
@@ -2,35 +2,53 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <getopt.h>
+#include <memory>
 #include <signal.h>
 #include <string>
 #include <thread>
 #include <unistd.h>
+#include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
+#include "Common/FileUtil.h"
 #include "Common/Flag.h"
+#include "Common/IniFile.h"
 #include "Common/Logging/LogManager.h"
 #include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
 
 #include "Core/Analytics.h"
 #include "Core/BootManager.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/HW/Wiimote.h"
 #include "Core/Host.h"
 #include "Core/IPC_HLE/WII_IPC_HLE.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device_stm.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device_usb_bt_emu.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_WiiMote.h"
+#include "Core/Movie.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
 #include "Core/State.h"
 
+#include "DiscIO/Volume.h"
+#include "DiscIO/VolumeCreator.h"
+
 #include "UICommon/UICommon.h"
 
+#include "VideoCommon/BenchmarkLog.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/VideoBackendBase.h"
 
@@ -373,20 +391,429 @@ static Platform* GetPlatform()
 	return nullptr;
 }
 
+// Replays every FIFO log the given number of times without frame limiting or VSync, one run
+// per log, and writes the frames of all runs to output.
+static int RunBenchmark(const std::vector<std::string>& files, u32 loops, const std::string& output)
+{
+	if (!BenchmarkLog::Open(output))
+	{
+		fprintf(stderr, "Could not open %s\n", output.c_str());
+		return 1;
+	}
+
+	Core::SetIsThrottlerTempDisabled(true);
+	FifoPlayer::GetInstance().SetLoopCount(loops);
+
+	int result = 0;
+	for (const std::string& file : files)
+	{
+		std::string name, extension;
+		SplitPath(file, nullptr, &name, &extension);
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		if (extension != ".dff")
+		{
+			fprintf(stderr, "%s is not a FIFO log\n", file.c_str());
+			result = 1;
+			continue;
+		}
+
+		BenchmarkLog::BeginRun(name);
+		s_running.Set();
+		if (!BootManager::BootCore(file))
+		{
+			fprintf(stderr, "Could not boot %s\n", file.c_str());
+			BenchmarkLog::EndRun();
+			result = 1;
+			continue;
+		}
+
+		while (!Core::IsRunning() && s_running.IsSet())
+		{
+			Core::HostDispatchJobs();
+			updateMainFrameEvent.Wait();
+		}
+
+		if (s_running.IsSet())
+			platform->MainLoop();
+		Core::Stop();
+		while (Core::GetState() != Core::CORE_UNINITIALIZED)
+		{
+			Core::HostDispatchJobs();
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		const BenchmarkLog::RunSummary summary = BenchmarkLog::EndRun();
+		const double average_ms = summary.frames ? summary.total_ms / summary.frames : 0.0;
+		printf("%s: %u frames, %.2f ms average, %.2f ms max, %.1f FPS, %llu draw calls, %llu shader "
+			"compiles\n",
+			summary.name.c_str(), summary.frames, average_ms, summary.max_frame_ms,
+			average_ms > 0.0 ? 1000.0 / average_ms : 0.0,
+			static_cast<unsigned long long>(summary.draw_calls),
+			static_cast<unsigned long long>(summary.shader_compiles));
+
+		// Stopped before all loops were played, e.g. by a signal
+		if (FifoPlayer::GetInstance().GetLoopsPlayed() < loops)
+		{
+			result = 1;
+			break;
+		}
+	}
+
+	FifoPlayer::GetInstance().SetLoopCount(0);
+	Core::SetIsThrottlerTempDisabled(false);
+	BenchmarkLog::Close();
+	return result;
+}
+
+static bool ParseCPUCore(const std::string& name, int* core)
+{
+	static const std::pair<const char*, int> cores[] = {
+		{ "interpreter", PowerPC::CORE_INTERPRETER },
+		{ "cachedinterpreter", PowerPC::CORE_CACHEDINTERPRETER },
+		{ "jit64", PowerPC::CORE_JIT64 },
+		{ "jitil", PowerPC::CORE_JITIL64 },
+	};
+	for (const auto& entry : cores)
+	{
+		if (name == entry.first)
+		{
+			*core = entry.second;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Replays a DTM as fast as the CPU emulation allows and reports where the time went. Meant to be
+// used with the Null video backend so that only the CPU side is measured.
+static int RunMovieBenchmark(const std::string& game, const std::string& movie, int cpu_core)
+{
+	SConfig& config = SConfig::GetInstance();
+	const int saved_cpu_core = config.iCPUCore;
+	const bool saved_pause_movie = config.m_PauseMovie;
+	// Keeps the CPU halted when the movie ends so that the counters stop with it
+	config.m_PauseMovie = true;
+	if (cpu_core >= 0)
+		config.iCPUCore = cpu_core;
+
+	Core::SetIsThrottlerTempDisabled(true);
+	CoreTiming::SetEventProfiling(true);
+
+	int result = 0;
+	Movie::SetReadOnly(true);
+	if (!Movie::PlayInput(movie))
+	{
+		fprintf(stderr, "Could not play %s\n", movie.c_str());
+		result = 1;
+	}
+	else
+	{
+		// The core saved in the movie wins over the config otherwise
+		if (cpu_core >= 0)
+			Movie::SetCPUMode(cpu_core);
+
+		s_running.Set();
+		if (!BootManager::BootCore(game))
+		{
+			fprintf(stderr, "Could not boot %s\n", game.c_str());
+			Movie::EndPlayInput(false);
+			result = 1;
+		}
+	}
+
+	if (!result)
+	{
+		while (!Core::IsRunning() && s_running.IsSet())
+		{
+			Core::HostDispatchJobs();
+			updateMainFrameEvent.Wait();
+		}
+
+		const u64 start_us = Common::Timer::GetTimeUs();
+		while (s_running.IsSet() && Movie::IsPlayingInput())
+		{
+			if (s_shutdown_requested.TestAndClear())
+			{
+				result = 1;
+				break;
+			}
+			Core::HostDispatchJobs();
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		const double seconds = (Common::Timer::GetTimeUs() - start_us) / 1000000.0;
+		if (!s_running.IsSet())
+			result = 1;
+
+		// Read before stopping, the events are unregistered on shutdown
+		const u64 frames = Movie::GetCurrentFrame();
+		u64 jit_blocks = 0, jit_time_us = 0;
+		JitInterface::GetCompileStats(&jit_blocks, &jit_time_us);
+		const std::vector<CoreTiming::EventProfile> events = CoreTiming::GetEventProfile();
+
+		Core::Stop();
+		while (Core::GetState() != Core::CORE_UNINITIALIZED)
+		{
+			Core::HostDispatchJobs();
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		const double total_us = seconds * 1000000.0;
+		printf("%s: %llu VIs in %.2f s, %.1f VI/s\n", movie.c_str(), static_cast<unsigned long long>(frames),
+			seconds, seconds > 0.0 ? frames / seconds : 0.0);
+		printf("  JIT: %llu blocks compiled in %.1f ms (%.1f%%)\n", static_cast<unsigned long long>(jit_blocks),
+			jit_time_us / 1000.0, total_us > 0.0 ? 100.0 * jit_time_us / total_us : 0.0);
+
+		u64 event_time_us = 0;
+		for (const CoreTiming::EventProfile& event : events)
+			event_time_us += event.time_us;
+		printf("  Events: %.1f ms (%.1f%%)\n", event_time_us / 1000.0,
+			total_us > 0.0 ? 100.0 * event_time_us / total_us : 0.0);
+		for (size_t i = 0; i < events.size() && i < 10; i++)
+		{
+			printf("    %-24s %10llu calls %10.1f ms %8llu cycles late%s\n", events[i].name.c_str(),
+				static_cast<unsigned long long>(events[i].count), events[i].time_us / 1000.0,
+				static_cast<unsigned long long>(events[i].count ? events[i].late_cycles / events[i].count : 0),
+				events[i].high_frequency ? " (high frequency)" : "");
+		}
+	}
+
+	CoreTiming::SetEventProfiling(false);
+	Core::SetIsThrottlerTempDisabled(false);
+	config.iCPUCore = saved_cpu_core;
+	config.m_PauseMovie = saved_pause_movie;
+	return result;
+}
+
+// A setting the auto tuner may change in the game INI, with the values it tries.
+struct TuneSetting
+{
+	const char* section;
+	const char* key;
+	std::vector<std::string> values;
+};
+
+// A value has to be this much faster than the best one so far to be picked, runs vary a bit.
+static constexpr double TUNE_MIN_GAIN = 0.02;
+
+// Plays the movie once with the chosen values written over base_ini at ini_path. Returns the
+// average wall time per VI in ms, or a negative value if the run didn't finish.
+static double TimeTuneProfile(const std::string& game, const std::string& movie,
+	const std::string& ini_path, const IniFile& base_ini,
+	const std::vector<TuneSetting>& settings, const std::vector<std::string>& profile)
+{
+	IniFile ini = base_ini;
+	int cpu_core = -1;
+	for (size_t i = 0; i < settings.size(); i++)
+	{
+		if (profile[i].empty())
+			continue;
+		// The movie overrides the core from the INI
+		if (!strcmp(settings[i].key, "CPUCore"))
+			cpu_core = std::stoi(profile[i]);
+		else
+			ini.GetOrCreateSection(settings[i].section)->Set(settings[i].key, profile[i]);
+	}
+	if (!ini.Save(ini_path))
+		return -1.0;
+
+	Movie::SetReadOnly(true);
+	if (!Movie::PlayInput(movie))
+		return -1.0;
+	if (cpu_core >= 0)
+		Movie::SetCPUMode(cpu_core);
+
+	s_running.Set();
+	if (!BootManager::BootCore(game))
+	{
+		Movie::EndPlayInput(false);
+		return -1.0;
+	}
+	while (!Core::IsRunning() && s_running.IsSet())
+	{
+		Core::HostDispatchJobs();
+		updateMainFrameEvent.Wait();
+	}
+
+	const u64 start_us = Common::Timer::GetTimeUs();
+	while (s_running.IsSet() && Movie::IsPlayingInput() && !s_shutdown_requested.IsSet())
+	{
+		Core::HostDispatchJobs();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	const double elapsed_ms = (Common::Timer::GetTimeUs() - start_us) / 1000.0;
+	const bool finished = s_running.IsSet() && !Movie::IsPlayingInput();
+	const u64 frames = Movie::GetCurrentFrame();
+
+	Core::Stop();
+	while (Core::GetState() != Core::CORE_UNINITIALIZED)
+	{
+		Core::HostDispatchJobs();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return finished && frames ? elapsed_ms / frames : -1.0;
+}
+
+// Replays the DTM with one setting changed at a time and keeps each value that is clearly faster,
+// then writes the resulting profile to the user's game INI. Settings listed in Locked of the
+// [AutoTune] section of the game INI are left alone, e.g. because the game needs them for
+// accuracy. Dual core, DSP HLE and the EFB copy settings are saved in the DTM and have to match
+// it, so they are not tuned.
+static int RunAutoTune(const std::string& game, const std::string& movie)
+{
+	std::unique_ptr<DiscIO::IVolume> volume = DiscIO::CreateVolumeFromFilename(game);
+	if (!volume)
+	{
+		fprintf(stderr, "Could not open %s\n", game.c_str());
+		return 1;
+	}
+	const std::string game_id = volume->GetGameID();
+	const u16 revision = volume->GetRevision();
+	volume.reset();
+
+	const std::vector<TuneSetting> settings = {
+		{ "Core", "CPUCore", { std::to_string(PowerPC::CORE_JIT64), std::to_string(PowerPC::CORE_JITIL64) } },
+		{ "Video", "FullAsyncShaderCompilation", { "False", "True" } },
+		{ "Video_Settings", "BackendMultithreading", { "False", "True" } },
+		{ "Video_Hacks", "EFBFastAccess", { "False", "True" } },
+	};
+
+	std::vector<std::string> locked;
+	std::string locked_list;
+	SConfig::LoadGameIni(game_id, revision).GetOrCreateSection("AutoTune")->Get("Locked", &locked_list);
+	SplitString(locked_list, ',', locked);
+	for (std::string& key : locked)
+		key = StripSpaces(key);
+
+	// The runs write their profile to the user's INI, which is written back if tuning fails.
+	const std::string ini_path = File::GetUserPath(D_GAMESETTINGS_IDX) + game_id + ".ini";
+	const std::string backup_path = ini_path + ".autotune";
+	const bool ini_existed = File::Exists(ini_path);
+	if (ini_existed && !File::Copy(ini_path, backup_path))
+	{
+		fprintf(stderr, "Could not back up %s\n", ini_path.c_str());
+		return 1;
+	}
+	IniFile base_ini;
+	base_ini.Load(ini_path);
+
+	SConfig& config = SConfig::GetInstance();
+	const bool saved_pause_movie = config.m_PauseMovie;
+	config.m_PauseMovie = true;
+	Core::SetIsThrottlerTempDisabled(true);
+
+	std::vector<std::string> profile(settings.size());
+	double best_ms = TimeTuneProfile(game, movie, ini_path, base_ini, settings, profile);
+	if (best_ms >= 0.0)
+		printf("%s: %.2f ms per VI with the current settings\n", game_id.c_str(), best_ms);
+
+	for (size_t i = 0; i < settings.size() && best_ms >= 0.0; i++)
+	{
+		if (std::find(locked.begin(), locked.end(), settings[i].key) != locked.end())
+		{
+			printf("  %s: locked by the game INI\n", settings[i].key);
+			continue;
+		}
+
+		std::string best_value;
+		for (const std::string& value : settings[i].values)
+		{
+			std::vector<std::string> candidate = profile;
+			candidate[i] = value;
+			const double ms = TimeTuneProfile(game, movie, ini_path, base_ini, settings, candidate);
+			if (s_shutdown_requested.IsSet())
+			{
+				best_ms = -1.0;
+				break;
+			}
+			if (ms < 0.0)
+			{
+				printf("  %s = %s: did not finish\n", settings[i].key, value.c_str());
+				continue;
+			}
+			printf("  %s = %s: %.2f ms per VI\n", settings[i].key, value.c_str(), ms);
+			if (ms < best_ms * (1.0 - TUNE_MIN_GAIN))
+			{
+				best_ms = ms;
+				best_value = value;
+			}
+		}
+		if (!best_value.empty())
+			profile[i] = best_value;
+	}
+
+	Core::SetIsThrottlerTempDisabled(false);
+	config.m_PauseMovie = saved_pause_movie;
+
+	if (best_ms < 0.0)
+	{
+		fprintf(stderr, "Tuning failed, %s was not changed\n", ini_path.c_str());
+		if (ini_existed)
+			File::Rename(backup_path, ini_path);
+		else
+			File::Delete(ini_path);
+		return 1;
+	}
+
+	// Unlike during the runs the core is read from the INI when playing normally
+	for (size_t i = 0; i < settings.size(); i++)
+	{
+		if (!profile[i].empty())
+			base_ini.GetOrCreateSection(settings[i].section)->Set(settings[i].key, profile[i]);
+	}
+	base_ini.Save(ini_path);
+	if (ini_existed)
+		File::Delete(backup_path);
+	printf("Wrote the profile to %s, %.2f ms per VI\n", ini_path.c_str(), best_ms);
+	return 0;
+}
+
 int main(int argc, char* argv[])
 {
 	int ch, help = 0;
+	u32 benchmark_loops = 0;
+	std::string video_backend;
+	std::string benchmark_output;
+	std::string movie;
+	std::string tune_movie;
+	int cpu_core = -1;
 	struct option longopts[] = { { "exec", no_argument, nullptr, 'e' },
+	{ "benchmark", required_argument, nullptr, 'b' },
+	{ "video_backend", required_argument, nullptr, 'V' },
+	{ "output", required_argument, nullptr, 'o' },
+	{ "movie", required_argument, nullptr, 'm' },
+	{ "cpu_core", required_argument, nullptr, 'C' },
+	{ "tune", required_argument, nullptr, 't' },
 	{ "help", no_argument, nullptr, 'h' },
 	{ "version", no_argument, nullptr, 'v' },
 	{ nullptr, 0, nullptr, 0 } };
 
-	while ((ch = getopt_long(argc, argv, "eh?v", longopts, 0)) != -1)
+	while ((ch = getopt_long(argc, argv, "eb:V:o:m:C:t:h?v", longopts, 0)) != -1)
 	{
 		switch (ch)
 		{
 		case 'e':
 			break;
+		case 'b':
+			benchmark_loops = static_cast<u32>(strtoul(optarg, nullptr, 10));
+			if (!benchmark_loops)
+				help = 1;
+			break;
+		case 'V':
+			video_backend = optarg;
+			break;
+		case 'o':
+			benchmark_output = optarg;
+			break;
+		case 'm':
+			movie = optarg;
+			break;
+		case 'C':
+			if (!ParseCPUCore(optarg, &cpu_core))
+				help = 1;
+			break;
+		case 't':
+			tune_movie = optarg;
+			break;
 		case 'h':
 		case '?':
 			help = 1;
@@ -402,9 +829,21 @@ int main(int argc, char* argv[])
 		fprintf(stderr, "%s\n\n", scm_rev_str.c_str());
 		fprintf(stderr, "A multi-platform GameCube/Wii emulator\n\n");
 		fprintf(stderr, "Usage: %s [-e <file>] [-h] [-v]\n", argv[0]);
-		fprintf(stderr, "  -e, --exec     Load the specified file\n");
-		fprintf(stderr, "  -h, --help     Show this help message\n");
-		fprintf(stderr, "  -v, --version  Print version and exit\n");
+		fprintf(stderr, "       %s -b <loops> [-V <backend>] [-o <csv>] <fifo log>...\n", argv[0]);
+		fprintf(stderr, "       %s -m <dtm> [-C <core>] [-V <backend>] <game>\n", argv[0]);
+		fprintf(stderr, "       %s -t <dtm> [-V <backend>] <game>\n", argv[0]);
+		fprintf(stderr, "  -e, --exec           Load the specified file\n");
+		fprintf(stderr, "  -b, --benchmark      Replay the FIFO logs <loops> times each, unthrottled\n");
+		fprintf(stderr, "  -V, --video_backend  Video backend to benchmark\n");
+		fprintf(stderr, "  -o, --output         Benchmark CSV, defaults to Logs/benchmark.csv\n");
+		fprintf(stderr, "  -m, --movie          Replay the DTM unthrottled and report CPU time,\n");
+		fprintf(stderr, "                       uses the Null video backend unless -V is given\n");
+		fprintf(stderr, "  -C, --cpu_core       CPU core for -m: interpreter, cachedinterpreter, jit64\n");
+		fprintf(stderr, "                       or jitil\n");
+		fprintf(stderr, "  -t, --tune           Replay the DTM with different settings and write the\n");
+		fprintf(stderr, "                       fastest to the user's game INI\n");
+		fprintf(stderr, "  -h, --help           Show this help message\n");
+		fprintf(stderr, "  -v, --version        Print version and exit\n");
 		return 1;
 	}
 
@@ -431,6 +870,58 @@ int main(int argc, char* argv[])
 
 	DolphinAnalytics::Instance()->ReportDolphinStart("nogui");
 
+	if (benchmark_loops)
+	{
+		// Not saved, the backend is only changed for the benchmark
+		const std::string saved_video_backend = SConfig::GetInstance().m_strVideoBackend;
+		if (!video_backend.empty())
+			SConfig::GetInstance().m_strVideoBackend = video_backend;
+		if (benchmark_output.empty())
+			benchmark_output = File::GetUserPath(D_LOGS_IDX) + "benchmark.csv";
+
+		const int result = RunBenchmark(std::vector<std::string>(argv + optind, argv + argc),
+			benchmark_loops, benchmark_output);
+		SConfig::GetInstance().m_strVideoBackend = saved_video_backend;
+
+		Core::Shutdown();
+		platform->Shutdown();
+		UICommon::Shutdown();
+		delete platform;
+		return result;
+	}
+
+	if (!tune_movie.empty())
+	{
+		// Not saved, the backend is only changed for tuning
+		const std::string saved_video_backend = SConfig::GetInstance().m_strVideoBackend;
+		if (!video_backend.empty())
+			SConfig::GetInstance().m_strVideoBackend = video_backend;
+
+		const int result = RunAutoTune(argv[optind], tune_movie);
+		SConfig::GetInstance().m_strVideoBackend = saved_video_backend;
+
+		Core::Shutdown();
+		platform->Shutdown();
+		UICommon::Shutdown();
+		delete platform;
+		return result;
+	}
+
+	if (!movie.empty())
+	{
+		const std::string saved_video_backend = SConfig::GetInstance().m_strVideoBackend;
+		SConfig::GetInstance().m_strVideoBackend = video_backend.empty() ? "Null" : video_backend;
+
+		const int result = RunMovieBenchmark(argv[optind], movie, cpu_core);
+		SConfig::GetInstance().m_strVideoBackend = saved_video_backend;
+
+		Core::Shutdown();
+		platform->Shutdown();
+		UICommon::Shutdown();
+		delete platform;
+		return result;
+	}
+
 	if (!BootManager::BootCore(argv[optind]))
 	{
 		fprintf(stderr, "Could not boot %s\n", argv[optind]);
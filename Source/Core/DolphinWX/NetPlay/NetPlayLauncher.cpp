@@ -34,6 +34,7 @@ bool NetPlayLauncher::Host(const NetPlayHostConfig& config)
 	}
 
 	netplay_server->ChangeGame(config.game_name);
+	netplay_server->SetSpectatorDelay(config.spectator_delay);
 
 #ifdef USE_UPNP
 	if (config.forward_port)
@@ -141,6 +142,7 @@ void NetPlayLaunchConfig::SetDialogInfo(const IniFile::Section& section, wxWindo
 void NetPlayHostConfig::FromIniConfig(IniFile::Section& netplay_section)
 {
 	netplay_section.Get("Nickname", &player_name, "Player");
+	netplay_section.Get("SpectatorDelay", &spectator_delay, 0);
 	std::string traversal_choice_setting;
 	netplay_section.Get("TraversalChoice", &traversal_choice_setting, "direct");
 	use_traversal = traversal_choice_setting == "traversal";
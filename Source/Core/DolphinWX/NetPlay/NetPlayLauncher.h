@@ -40,6 +40,7 @@ public:
 
 	std::string game_name;
 	u16 listen_port = 0;
+	u32 spectator_delay = 0;
 #ifdef USE_UPNP
 	bool forward_port;
 #endif
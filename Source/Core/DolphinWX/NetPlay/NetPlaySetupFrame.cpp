@@ -335,6 +335,7 @@ void NetPlaySetupFrame::DoHost()
 	host_config.game_name = WxStrToStr(m_game_lbox->GetStringSelection());
 	host_config.use_traversal = m_direct_traversal->GetCurrentSelection() == TRAVERSAL_CHOICE;
 	host_config.player_name = WxStrToStr(m_nickname_text->GetValue());
+	netplay_section.Get("SpectatorDelay", &host_config.spectator_delay, 0);
 	host_config.game_list_ctrl = m_game_list;
 	host_config.SetDialogInfo(netplay_section, m_parent);
 #ifdef USE_UPNP
@@ -134,8 +134,11 @@ static wxString efb_fast_access_desc = _("Use a fast efb caching method to speed
 static wxString efb_emulate_format_changes_desc = _("Ignore any changes to the EFB format.\nImproves performance in many games without any negative effect. Causes graphical defects in a small number of other games though.\n\nIf unsure, leave this checked.");
 static wxString viewport_correction_desc = _("Some games uses viewport values that are not compatible with D3D backends, to solve issues on those games check this.\n\nIf unsure, leave this unchecked.");
 static wxString skip_efb_copy_to_ram_desc = _("Stores EFB Copies exclusively on the GPU, bypassing system memory. Causes graphical defects in a small number of games.\n\nEnabled = EFB Copies to Texture\nDisabled = EFB Copies to RAM (and Texture)\n\nIf unsure, leave this checked.");
+static wxString dynamic_resolution_desc = _("Lowers the internal resolution step by step when the GPU can't render frames in time, and raises it again when there is headroom. The selected internal resolution is the highest one used. Only has an effect with OpenGL and Vulkan, and not with the Auto resolutions.\n\nIf unsure, leave this unchecked.");
+static wxString defer_efb_copies_desc = _("Waits with writing EFB Copies to RAM until the emulated game or the texture cache needs them, instead of stalling the GPU on every copy. Only has an effect with EFB Copies to RAM on OpenGL and Vulkan.\n\nIf unsure, leave this unchecked.");
 static wxString stc_desc = _("The safer you adjust this, the less likely the emulator will be missing any texture updates from RAM.\n\nIf unsure, use the rightmost value.");
 static wxString bbox_desc = _("Selects wish implementation is used to emulate Bounding Box. By Default GPU will be used if supported.");
+static wxString bbox_async_desc = _("With GPU Bounding Box, returns the result of the previous frame to the game instead of waiting for the GPU on every read. Faster, but some games may show a frame of lag in effects that depend on it.\n\nIf unsure, leave this unchecked.");
 static wxString wireframe_desc = _("Render the scene as a wireframe.\n\nIf unsure, leave this unchecked.");
 static wxString disable_fog_desc = _("Makes distant objects more visible by removing fog, thus increasing the overall detail.\nDisabling fog will break some games which rely on proper fog emulation.\n\nIf unsure, leave this unchecked.");
 static wxString true_color_desc = _("Forces the game to render the RGB color channels in 24-bit, thereby increasing "
@@ -154,6 +157,9 @@ wxTRANSLATE("Log the render time of every frame to User/Logs/render_time.txt. Us
 	"unsure, leave this unchecked.");
 static wxString show_stats_desc =
 wxTRANSLATE("Show various rendering statistics.\n\nIf unsure, leave this unchecked.");
+static wxString show_pass_times_desc =
+wxTRANSLATE("Show how much CPU and GPU time vertex loading, drawing, shader compilation, "
+	"EFB copies, post-processing and presenting take per frame.\n\nIf unsure, leave this unchecked.");
 static wxString show_netplay_messages_desc =
 wxTRANSLATE("When playing on NetPlay, show chat messages, buffer changes and "
 	"desync alerts.\n\nIf unsure, leave this unchecked.");
@@ -168,7 +174,7 @@ static wxString fullAsyncShaderCompilation_desc = _("Make shader compilation pro
 static wxString compute_texture_decoding_desc = _("Decode Textures using compute shaders. Can Increase Performance in some scenarios.");
 static wxString Compute_texture_encoding_desc = _("Encode Textures using compute shaders. Can Increase Performance in some scenarios.");
 static wxString waitforshadercompilation_desc = _("Wait for shader compilation in the cpu to avoid fifo problems. This option prevents loops in F-Zero, Metroid Prime fifo resets and others.");
-static wxString predictiveFifo_desc = _("Generate a secondary fifo to predict resource usage and improve loading time.");
+static wxString predictiveFifo_desc = _("Scans the GPU FIFO ahead of the emulated GPU and compiles the shaders of upcoming draws early.\nOnly works in dual core mode.\n\nIf unsure, leave this unchecked.");
 static wxString load_hires_textures_desc = _("Load custom textures from User/Load/Textures/<game_id>/\n\nIf unsure, leave this unchecked.");
 static wxString load_hires_material_maps_desc = _("Load custom material maps from User/Load/Textures/<game_id>/\nUsed to Enable Advanced lighting, Requires Pixel Lighting and Hires Textures Enabled\nIf unsure, leave this unchecked.");
 static wxString cache_hires_textures_desc = _("Cache custom textures to system RAM on startup.\nThis can require exponentially more RAM but fixes possible stuttering.\n\nIf unsure, leave this unchecked.");
@@ -475,6 +481,7 @@ VideoConfigDiag::VideoConfigDiag(wxWindow* parent, const std::string &title)
 
 		// Scaled copy, PL, Bilinear filter, 3D Vision
 		szr_enh->Add(CreateCheckBox(page_enh, _("Scaled EFB Copy"), (scaled_efb_copy_desc), vconfig.bCopyEFBScaled));
+		szr_enh->Add(CreateCheckBox(page_enh, _("Dynamic Resolution"), (dynamic_resolution_desc), vconfig.bDynamicResolution));
 		if (vconfig.backend_info.bSupportsScaling)
 		{
 			szr_enh->Add(CreateCheckBox(page_enh, _("Use Scaling Filter"), (Use_Scaling_filter_desc), vconfig.bUseScalingFilter));
@@ -820,6 +827,7 @@ VideoConfigDiag::VideoConfigDiag(wxWindow* parent, const std::string &title)
 		szr_efb->Add(Fast_efb_cache, 0, wxBOTTOM | wxLEFT, 5);
 		szr_efb->Add(emulate_efb_format_changes, 0, wxBOTTOM | wxLEFT, 5);
 		szr_efb->Add(CreateCheckBox(page_hacks, _("Store EFB copies to Texture Only"), (skip_efb_copy_to_ram_desc), vconfig.bSkipEFBCopyToRam), 0, wxBOTTOM | wxLEFT, 5);
+		szr_efb->Add(CreateCheckBox(page_hacks, _("Defer EFB Copies to RAM"), (defer_efb_copies_desc), vconfig.bDeferEFBCopies), 0, wxBOTTOM | wxLEFT, 5);
 		szr_hacks->Add(szr_efb, 0, wxEXPAND | wxALL, 5);
 
 		// Texture cache
@@ -876,6 +884,8 @@ VideoConfigDiag::VideoConfigDiag(wxWindow* parent, const std::string &title)
 			group_bbox->AddStretchSpacer(0);
 			group_bbox->Add(bbox_slider, 3, wxRIGHT, 0);
 			group_bbox->Add(text_bboxmode = new wxStaticText(page_hacks, wxID_ANY, _("GPU")), 1, wxRIGHT | wxTOP | wxBOTTOM, 5);
+			if (vconfig.backend_info.bSupportsBBox)
+				group_bbox->Add(CreateCheckBox(page_hacks, _("Async Readback"), (bbox_async_desc), vconfig.bBBoxAsyncReadback), 0, wxALL, 5);
 			szr_hacks->Add(group_bbox, 0, wxEXPAND | wxALL, 5);
 			bbox_slider->SetValue(vconfig.iBBoxMode);
 			text_bboxmode->SetLabel((s_bbox_mode_text[vconfig.iBBoxMode]));
@@ -891,7 +901,7 @@ VideoConfigDiag::VideoConfigDiag(wxWindow* parent, const std::string &title)
 					vconfig.bVertexRounding);
 			szr_other->Add(vertex_rounding_checkbox);
 			szr_other->Add(Forced_LogicOp = CreateCheckBox(page_hacks, _("Force Logic Blending"), (forcedLogivOp_desc), vconfig.bForceLogicOpBlend));
-			//szr_other->Add(Predictive_FIFO = CreateCheckBox(page_hacks, _("Predictive FIFO"), (predictiveFifo_desc), vconfig.bPredictiveFifo));
+			szr_other->Add(Predictive_FIFO = CreateCheckBox(page_hacks, _("Predictive FIFO"), (predictiveFifo_desc), vconfig.bPredictiveFifo));
 			//szr_other->Add(Wait_For_Shaders = CreateCheckBox(page_hacks, _("Wait for Shader Compilation"), (waitforshadercompilation_desc), vconfig.bWaitForShaderCompilation));
 			szr_other->Add(Async_Shader_compilation = CreateCheckBox(page_hacks, _("Full Async Shader Compilation"), (fullAsyncShaderCompilation_desc), vconfig.bFullAsyncShaderCompilation));
 			szr_other->Add(GPU_Texture_decoding = CreateCheckBox(page_hacks, _("GPU Texture Decoding"), (compute_texture_decoding_desc), vconfig.bEnableGPUTextureDecoding));
@@ -919,6 +929,7 @@ VideoConfigDiag::VideoConfigDiag(wxWindow* parent, const std::string &title)
 
 			szr_debug->Add(CreateCheckBox(page_advanced, _("Enable Wireframe"), (wireframe_desc), vconfig.bWireFrame));
 			szr_debug->Add(CreateCheckBox(page_advanced, _("Show Statistics"), (show_stats_desc), vconfig.bOverlayStats));
+			szr_debug->Add(CreateCheckBox(page_advanced, _("Show Pass Times"), (show_pass_times_desc), vconfig.bOverlayPassTimes));
 			szr_debug->Add(CreateCheckBox(page_advanced, _("Texture Format Overlay"), (texfmt_desc), vconfig.bTexFmtOverlayEnable));
 			if (vconfig.backend_info.bSupportsValidationLayer)
 			{
@@ -214,6 +214,8 @@ public:
 	virtual ControlState GetValue() { return 0; }
 	virtual void SetValue(ControlState state) {}
 	virtual int CountNumControls() { return 0; }
+	// Appends the postfix form of the node, returns false if it has none
+	virtual bool Compile(std::vector<Expression::Instruction>& program) { return false; }
 	virtual operator std::string() { return ""; }
 };
 
@@ -226,6 +228,11 @@ public:
 	ControlState GetValue() override { return 0.0; }
 	void SetValue(ControlState value) override {}
 	int CountNumControls() override { return 0; }
+	bool Compile(std::vector<Expression::Instruction>& program) override
+	{
+		program.push_back({ Expression::Instruction::PUSH_ZERO, nullptr });
+		return true;
+	}
 	operator std::string() override { return "`" + name + "`"; }
 };
 
@@ -244,6 +251,14 @@ public:
 	ControlState GetValue() override { return control->ToInput()->GetGatedState(); }
 	void SetValue(ControlState value) override { control->ToOutput()->SetGatedState(value); }
 	int CountNumControls() override { return 1; }
+	bool Compile(std::vector<Expression::Instruction>& program) override
+	{
+		Device::Input* input = control->ToInput();
+		if (!input)
+			return false;
+		program.push_back({ Expression::Instruction::PUSH_INPUT, input });
+		return true;
+	}
 	operator std::string() override { return "`" + (std::string)qualifier + "`"; }
 private:
 	std::shared_ptr<Device> m_device;
@@ -293,6 +308,25 @@ public:
 	}
 
 	int CountNumControls() override { return lhs->CountNumControls() + rhs->CountNumControls(); }
+	bool Compile(std::vector<Expression::Instruction>& program) override
+	{
+		if (!lhs->Compile(program) || !rhs->Compile(program))
+			return false;
+		switch (op)
+		{
+		case TOK_AND:
+			program.push_back({ Expression::Instruction::AND, nullptr });
+			return true;
+		case TOK_OR:
+			program.push_back({ Expression::Instruction::OR, nullptr });
+			return true;
+		case TOK_ADD:
+			program.push_back({ Expression::Instruction::ADD, nullptr });
+			return true;
+		default:
+			return false;
+		}
+	}
 	operator std::string() override
 	{
 		return OpName(op) + "(" + (std::string)(*lhs) + ", " + (std::string)(*rhs) + ")";
@@ -334,6 +368,13 @@ public:
 	}
 
 	int CountNumControls() override { return inner->CountNumControls(); }
+	bool Compile(std::vector<Expression::Instruction>& program) override
+	{
+		if (op != TOK_NOT || !inner->Compile(program))
+			return false;
+		program.push_back({ Expression::Instruction::NOT, nullptr });
+		return true;
+	}
 	operator std::string() override { return OpName(op) + "(" + (std::string)(*inner) + ")"; }
 };
 
@@ -499,7 +540,39 @@ private:
 
 ControlState Expression::GetValue()
 {
-	return node->GetValue();
+	if (program.empty())
+		return node->GetValue();
+
+	ControlState stack[MAX_STACK_DEPTH];
+	ControlState* top = stack;
+	for (const Instruction& instruction : program)
+	{
+		switch (instruction.type)
+		{
+		case Instruction::PUSH_INPUT:
+			*top++ = instruction.input->GetGatedState();
+			break;
+		case Instruction::PUSH_ZERO:
+			*top++ = 0.0;
+			break;
+		case Instruction::AND:
+			--top;
+			top[-1] = std::min(top[-1], top[0]);
+			break;
+		case Instruction::OR:
+			--top;
+			top[-1] = std::max(top[-1], top[0]);
+			break;
+		case Instruction::ADD:
+			--top;
+			top[-1] = std::min(top[-1] + top[0], 1.0);
+			break;
+		case Instruction::NOT:
+			top[-1] = 1.0 - top[-1];
+			break;
+		}
+	}
+	return stack[0];
 }
 
 void Expression::SetValue(ControlState value)
@@ -511,6 +584,25 @@ Expression::Expression(ExpressionNode* node_)
 {
 	node = node_;
 	num_controls = node->CountNumControls();
+
+	// Input updates evaluate every mapped control each poll, so flatten the tree once here
+	int depth = 0, max_depth = 0;
+	if (node->Compile(program))
+	{
+		for (const Instruction& instruction : program)
+		{
+			if (instruction.type == Instruction::PUSH_INPUT || instruction.type == Instruction::PUSH_ZERO)
+				max_depth = std::max(max_depth, ++depth);
+			else if (instruction.type != Instruction::NOT)
+				--depth;
+		}
+	}
+	else
+	{
+		program.clear();
+	}
+	if (max_depth > MAX_STACK_DEPTH)
+		program.clear();
 }
 
 Expression::~Expression()
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "InputCommon/ControllerInterface/Device.h"
 
 namespace ciface
@@ -50,6 +51,25 @@ class ExpressionNode;
 class Expression
 {
 public:
+	// One step of the postfix form of an input expression
+	struct Instruction
+	{
+		enum Type
+		{
+			PUSH_INPUT,
+			PUSH_ZERO,
+			AND,
+			OR,
+			ADD,
+			NOT,
+		} type;
+		Core::Device::Input* input;
+	};
+	enum
+	{
+		MAX_STACK_DEPTH = 16
+	};
+
 	Expression() : node(nullptr) {}
 	Expression(ExpressionNode* node);
 	~Expression();
@@ -57,6 +77,9 @@ public:
 	void SetValue(ControlState state);
 	int num_controls;
 	ExpressionNode* node;
+	// Flattened node, which GetValue runs instead of walking the tree. Empty when the expression
+	// doesn't read inputs only or needs a deeper stack.
+	std::vector<Instruction> program;
 };
 
 enum ExpressionParseStatus
@@ -2,11 +2,15 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <fcntl.h>
 #include <libudev.h>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <poll.h>
 #include <unistd.h>
+#include <vector>
 
 #include <sys/eventfd.h>
 
@@ -27,6 +31,14 @@ static std::thread s_hotplug_thread;
 static Common::Flag s_hotplug_thread_running;
 static int s_wakeup_eventfd;
 
+// The input thread waits for events on all devices and flags the ones that have some, so
+// UpdateInput on the CPU thread only reads from devices that actually changed.
+static std::thread s_input_thread;
+static Common::Flag s_input_thread_running;
+static int s_input_wakeup_eventfd;
+static std::mutex s_input_devices_mutex;
+static std::vector<evdevDevice*> s_input_devices;
+
 // There is no easy way to get the device name from only a dev node
 // during a device removed event, since libevdev can't work on removed devices;
 // sysfs is not stable, so this is probably the easiest way to get a name for a node.
@@ -114,6 +126,78 @@ static void HotplugThreadFunc()
 	NOTICE_LOG(SERIALINTERFACE, "evdev hotplug thread stopped");
 }
 
+static void WakeInputThread()
+{
+	uint64_t value = 1;
+	if (write(s_input_wakeup_eventfd, &value, sizeof(uint64_t)) < 0)
+	{
+	}
+}
+
+static void InputThreadFunc()
+{
+	Common::SetCurrentThreadName("evdev Input Thread");
+
+	std::vector<pollfd> fds;
+	std::vector<evdevDevice*> devices;
+	while (s_input_thread_running.IsSet())
+	{
+		// Devices with unread events are left out until UpdateInput has drained them, it wakes
+		// the thread up afterwards.
+		fds.assign(1, { s_input_wakeup_eventfd, POLLIN, 0 });
+		devices.assign(1, nullptr);
+		{
+			std::lock_guard<std::mutex> lk(s_input_devices_mutex);
+			for (evdevDevice* device : s_input_devices)
+			{
+				if (device->HasPendingEvents())
+					continue;
+				fds.push_back({ device->GetFD(), POLLIN, 0 });
+				devices.push_back(device);
+			}
+		}
+
+		if (poll(fds.data(), fds.size(), -1) < 1)
+			continue;
+
+		if (fds[0].revents & POLLIN)
+		{
+			uint64_t value;
+			if (read(s_input_wakeup_eventfd, &value, sizeof(uint64_t)) < 0)
+			{
+			}
+		}
+
+		std::lock_guard<std::mutex> lk(s_input_devices_mutex);
+		for (size_t i = 1; i < fds.size(); ++i)
+		{
+			// The device may have been removed while polling
+			if (fds[i].revents &&
+				std::find(s_input_devices.begin(), s_input_devices.end(), devices[i]) != s_input_devices.end())
+				devices[i]->SetPendingEvents();
+		}
+	}
+}
+
+static void StartInputThread()
+{
+	if (!s_input_thread_running.TestAndSet())
+		return;
+
+	s_input_wakeup_eventfd = eventfd(0, 0);
+	_assert_msg_(PAD, s_input_wakeup_eventfd != -1, "Couldn't create eventfd.");
+	s_input_thread = std::thread(InputThreadFunc);
+}
+
+static void StopInputThread()
+{
+	if (!s_input_thread_running.TestAndClear())
+		return;
+	WakeInputThread();
+	s_input_thread.join();
+	close(s_input_wakeup_eventfd);
+}
+
 static void StartHotplugThread()
 {
 	// Mark the thread as running.
@@ -143,6 +227,7 @@ static void StopHotplugThread()
 void Init()
 {
 	s_devnode_name_map.clear();
+	StartInputThread();
 	StartHotplugThread();
 }
 
@@ -193,6 +278,7 @@ void PopulateDevices()
 void Shutdown()
 {
 	StopHotplugThread();
+	StopInputThread();
 }
 
 evdevDevice::evdevDevice(const std::string& devnode) : m_devfile(devnode)
@@ -243,10 +329,24 @@ evdevDevice::evdevDevice(const std::string& devnode) : m_devfile(devnode)
 
 	m_initialized = true;
 	m_interesting = num_axis >= 2 || num_buttons >= 8;
+
+	if (s_input_thread_running.IsSet())
+	{
+		std::lock_guard<std::mutex> lk(s_input_devices_mutex);
+		s_input_devices.push_back(this);
+		m_registered = true;
+	}
+	if (m_registered)
+		WakeInputThread();
 }
 
 evdevDevice::~evdevDevice()
 {
+	if (m_registered)
+	{
+		std::lock_guard<std::mutex> lk(s_input_devices_mutex);
+		s_input_devices.erase(std::find(s_input_devices.begin(), s_input_devices.end(), this));
+	}
 	if (m_initialized)
 	{
 		libevdev_free(m_dev);
@@ -256,6 +356,10 @@ evdevDevice::~evdevDevice()
 
 void evdevDevice::UpdateInput()
 {
+	// Without the input thread every poll has to try a read
+	if (m_registered && !m_events_pending.exchange(false))
+		return;
+
 	// Run through all evdev events
 	// libevdev will keep track of the actual controller state internally which can be queried
 	// later with libevdev_fetch_event_value()
@@ -268,6 +372,9 @@ void evdevDevice::UpdateInput()
 		else
 			rc = libevdev_next_event(m_dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
 	} while (rc >= 0);
+
+	if (m_registered)
+		WakeInputThread();
 }
 
 bool evdevDevice::IsValid() const
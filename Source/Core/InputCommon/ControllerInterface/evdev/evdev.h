@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <libevdev/libevdev.h>
 #include <string>
 #include <vector>
@@ -74,6 +75,11 @@ public:
   std::string GetName() const override { return m_name; }
   std::string GetSource() const override { return "evdev"; }
   bool IsInteresting() const { return m_initialized && m_interesting; }
+
+  int GetFD() const { return m_fd; }
+  bool HasPendingEvents() const { return m_events_pending.load(); }
+  void SetPendingEvents() { m_events_pending.store(true); }
+
 private:
   const std::string m_devfile;
   int m_fd;
@@ -81,6 +87,9 @@ private:
   std::string m_name;
   bool m_initialized;
   bool m_interesting;
+  // Set by the input thread when the device has events to read
+  std::atomic<bool> m_events_pending{ true };
+  bool m_registered = false;
 };
 }
 }
@@ -81,8 +81,9 @@ static void Read()
 	int payload_size = 0;
 	while (s_adapter_thread_running.IsSet())
 	{
-		adapter_error = libusb_interrupt_transfer(s_handle, s_endpoint_in, s_controller_payload_swap,
-			sizeof(s_controller_payload_swap), &payload_size, 16) != LIBUSB_SUCCESS && SConfig::GetInstance().bAdapterWarning;
+		int result = libusb_interrupt_transfer(s_handle, s_endpoint_in, s_controller_payload_swap,
+			sizeof(s_controller_payload_swap), &payload_size, 16);
+		adapter_error = result != LIBUSB_SUCCESS && SConfig::GetInstance().bAdapterWarning;
 
 		{
 			std::lock_guard<std::mutex> lk(s_mutex);
@@ -90,7 +91,10 @@ static void Read()
 			s_controller_payload_size.store(payload_size);
 		}
 
-		Common::YieldCPU();
+		// Resubmit right away after a report, so the transfer is already pending when the adapter
+		// sends the next one. Only failures, which can return immediately, give up the time slice.
+		if (result != LIBUSB_SUCCESS)
+			Common::YieldCPU();
 	}
 }
 
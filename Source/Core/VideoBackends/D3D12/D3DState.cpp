@@ -8,6 +8,7 @@
 #include "Common/LinearDiskCache.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/ThreadPool.h"
 #include "Common/Logging/Log.h"
 
 #include "Core/ConfigManager.h"
@@ -439,6 +440,28 @@ HRESULT StateCache::GetPipelineStateObjectFromCache(const SmallPsoDesc& pso_desc
 
 	if (it == m_small_pso_map.end())
 	{
+		auto pending_it = m_pending_psos.find(pso_desc);
+		if (pending_it != m_pending_psos.end())
+		{
+			if (!pending_it->second->done.load() && g_ActiveConfig.bFullAsyncShaderCompilation)
+			{
+				*pso = nullptr;
+				return S_FALSE;
+			}
+			size_t count = 0;
+			while (!pending_it->second->done.load())
+				Common::cYield(count++);
+			HRESULT hr = pending_it->second->hr;
+			*pso = FinishPendingPso(pso_desc, *pending_it->second);
+			m_pending_psos.erase(pending_it);
+			if (FAILED(hr))
+			{
+				CheckHR(hr);
+				return hr;
+			}
+			return S_OK;
+		}
+
 		// Not found, create new PSO.
 
 		// RootSignature, SampleMask, NumRenderTargets, RTVFormats, DSVFormat
@@ -458,6 +481,39 @@ HRESULT StateCache::GetPipelineStateObjectFromCache(const SmallPsoDesc& pso_desc
 		m_current_pso_desc.InputLayout = pso_desc.input_Layout->GetActiveInputLayout();
 		m_current_pso_desc.SampleDesc.Count = pso_desc.sample_count;
 
+		// This contains all of the information needed to reconstruct a PSO at startup.
+		SmallPsoDiskDesc disk_desc = {};
+		disk_desc.blend_state_hex = pso_desc.blend_state.hex;
+		disk_desc.depth_stencil_state_hex = pso_desc.depth_stencil_state.packed;
+		disk_desc.rasterizer_state_hex = pso_desc.rasterizer_state.hex;
+		disk_desc.gs_uid = *gs_uid;
+		disk_desc.ps_uid = *ps_uid;
+		disk_desc.vs_uid = *vs_uid;
+		disk_desc.hds_uid = *hds_uid;
+		disk_desc.vertex_declaration = pso_desc.input_Layout->GetVertexDeclaration();
+		disk_desc.topology = topology;
+		disk_desc.sample_desc.Count = g_ActiveConfig.iMultisamples;
+
+		if (g_ActiveConfig.bFullAsyncShaderCompilation)
+		{
+			// The device is free threaded, the shader bytecode and input layouts referenced
+			// by the desc live as long as the cache itself.
+			std::shared_ptr<PendingPso> pending = std::make_shared<PendingPso>();
+			pending->desc = m_current_pso_desc;
+			pending->disk_desc = disk_desc;
+			pending->hr = E_PENDING;
+			pending->done = false;
+			m_pending_psos[pso_desc] = pending;
+			Common::AsyncWorker::ExecuteAsync([pending]()
+			{
+				pending->hr = D3D::device->CreateGraphicsPipelineState(&pending->desc,
+					IID_PPV_ARGS(pending->pso.ReleaseAndGetAddressOf()));
+				pending->done.store(true);
+			});
+			*pso = nullptr;
+			return S_FALSE;
+		}
+
 		ComPtr<ID3D12PipelineState> new_pso;
 		HRESULT hr = D3D::device->CreateGraphicsPipelineState(&m_current_pso_desc, IID_PPV_ARGS(new_pso.ReleaseAndGetAddressOf()));
 
@@ -470,28 +526,7 @@ HRESULT StateCache::GetPipelineStateObjectFromCache(const SmallPsoDesc& pso_desc
 		m_small_pso_map[pso_desc] = new_pso;
 		*pso = new_pso.Get();
 
-		if (m_enable_disk_cache)
-		{
-			// This contains all of the information needed to reconstruct a PSO at startup.
-			SmallPsoDiskDesc disk_desc = {};
-			disk_desc.blend_state_hex = pso_desc.blend_state.hex;
-			disk_desc.depth_stencil_state_hex = pso_desc.depth_stencil_state.packed;
-			disk_desc.rasterizer_state_hex = pso_desc.rasterizer_state.hex;
-			disk_desc.gs_uid = *gs_uid;
-			disk_desc.ps_uid = *ps_uid;
-			disk_desc.vs_uid = *vs_uid;
-			disk_desc.hds_uid = *hds_uid;
-			disk_desc.vertex_declaration = pso_desc.input_Layout->GetVertexDeclaration();
-			disk_desc.topology = topology;
-			disk_desc.sample_desc.Count = g_ActiveConfig.iMultisamples;
-			// This shouldn't fail.. but if it does, don't cache to disk.
-			ComPtr<ID3DBlob> psoBlob;
-			hr = new_pso->GetCachedBlob(psoBlob.ReleaseAndGetAddressOf());
-			if (SUCCEEDED(hr))
-			{
-				s_pso_disk_cache.Append(disk_desc, reinterpret_cast<const u8*>(psoBlob->GetBufferPointer()), static_cast<u32>(psoBlob->GetBufferSize()));
-			}
-		}
+		AppendToDiskCache(disk_desc, new_pso.Get());
 	}
 	else
 	{
@@ -501,8 +536,43 @@ HRESULT StateCache::GetPipelineStateObjectFromCache(const SmallPsoDesc& pso_desc
 	return S_OK;
 }
 
+ID3D12PipelineState* StateCache::FinishPendingPso(const SmallPsoDesc& pso_desc, PendingPso& pending)
+{
+	if (FAILED(pending.hr))
+		return nullptr;
+
+	m_small_pso_map[pso_desc] = pending.pso;
+	// The disk cache is not thread safe, so it is only written from here.
+	AppendToDiskCache(pending.disk_desc, pending.pso.Get());
+	return pending.pso.Get();
+}
+
+void StateCache::AppendToDiskCache(const SmallPsoDiskDesc& disk_desc, ID3D12PipelineState* pso)
+{
+	if (!m_enable_disk_cache)
+		return;
+
+	// This shouldn't fail.. but if it does, don't cache to disk.
+	ComPtr<ID3DBlob> psoBlob;
+	HRESULT hr = pso->GetCachedBlob(psoBlob.ReleaseAndGetAddressOf());
+	if (SUCCEEDED(hr))
+	{
+		s_pso_disk_cache.Append(disk_desc, reinterpret_cast<const u8*>(psoBlob->GetBufferPointer()), static_cast<u32>(psoBlob->GetBufferSize()));
+	}
+}
+
 void StateCache::Clear()
 {
+	// Finished PSOs still go to the disk cache
+	for (auto& it : m_pending_psos)
+	{
+		size_t count = 0;
+		while (!it.second->done.load())
+			Common::cYield(count++);
+		FinishPendingPso(it.first, *it.second);
+	}
+	m_pending_psos.clear();
+
 	m_pso_map.clear();
 	m_small_pso_map.clear();
 
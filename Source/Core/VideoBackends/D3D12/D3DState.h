@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <stack>
 #include <unordered_map>
 
@@ -106,6 +108,8 @@ public:
 	static D3D12_DEPTH_STENCIL_DESC GetDesc(DepthState state);
 
 	HRESULT GetPipelineStateObjectFromCache(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& pso_desc, ID3D12PipelineState** pso);
+	// With full async shader compilation new PSOs are created on the thread pool,
+	// S_FALSE and a null pso are returned until they are ready.
 	HRESULT GetPipelineStateObjectFromCache(const SmallPsoDesc& pso_desc, ID3D12PipelineState** pso, D3D12_PRIMITIVE_TOPOLOGY_TYPE topology, const GeometryShaderUid* gs_uid, const PixelShaderUid* ps_uid, const VertexShaderUid* vs_uid, const TessellationShaderUid* hds_uid);
 
 	StateCache();
@@ -214,6 +218,19 @@ private:
 	};
 
 	std::unordered_map<SmallPsoDesc, ComPtr<ID3D12PipelineState>, hash_small_pso_desc, equality_small_pipeline_state_desc> m_small_pso_map;
+
+	struct PendingPso
+	{
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC desc;
+		SmallPsoDiskDesc disk_desc;
+		ComPtr<ID3D12PipelineState> pso;
+		HRESULT hr;
+		std::atomic<bool> done;
+	};
+	std::unordered_map<SmallPsoDesc, std::shared_ptr<PendingPso>, hash_small_pso_desc, equality_small_pipeline_state_desc> m_pending_psos;
+	ID3D12PipelineState* FinishPendingPso(const SmallPsoDesc& pso_desc, PendingPso& pending);
+	void AppendToDiskCache(const SmallPsoDiskDesc& disk_desc, ID3D12PipelineState* pso);
+
 	bool m_enable_disk_cache = true;
 };
 
@@ -4,11 +4,15 @@
 
 #include <algorithm>
 
+#include "Common/Timer.h"
+
 #include "VideoBackends/D3D12/D3DBase.h"
 #include "VideoBackends/D3D12/D3DCommandListManager.h"
 #include "VideoBackends/D3D12/D3DStreamBuffer.h"
 #include "VideoBackends/D3D12/D3DUtil.h"
 
+#include "VideoCommon/Statistics.h"
+
 namespace DX12
 {
 
@@ -196,7 +200,11 @@ bool D3DStreamBuffer::AttemptBufferResizeOrElseStall(size_t allocation_size, boo
 	// This is guaranteed to succeed, since we've already CHECK'd that the allocation_size <= max_buffer_size, and flushing now and waiting will
 	// free all space in buffer.
 
+	u64 start = Common::Timer::GetTimeUs();
 	D3D::command_list_mgr->ExecuteQueuedWork(true);
+	INCSTAT(stats.thisFrame.numStreamBufferStalls);
+	ADDSTAT(stats.thisFrame.streamBufferStallMicroseconds,
+		static_cast<int>(Common::Timer::GetTimeUs() - start));
 
 	m_buffer_offset = allocation_size;
 	m_buffer_current_allocation_offset = 0;
@@ -289,7 +297,14 @@ bool D3DStreamBuffer::AttemptToFindExistingFenceToStallOn(size_t allocation_size
 	// If so, wait on it.
 	if (fence_value_required > 0)
 	{
-		D3D::command_list_mgr->WaitOnCPUForFence(m_buffer_tracking_fence, fence_value_required);
+		if (m_buffer_tracking_fence->GetCompletedValue() < fence_value_required)
+		{
+			u64 start = Common::Timer::GetTimeUs();
+			D3D::command_list_mgr->WaitOnCPUForFence(m_buffer_tracking_fence, fence_value_required);
+			INCSTAT(stats.thisFrame.numStreamBufferStalls);
+			ADDSTAT(stats.thisFrame.streamBufferStallMicroseconds,
+				static_cast<int>(Common::Timer::GetTimeUs() - start));
+		}
 		return true;
 	}
 
@@ -155,6 +155,11 @@ void PerfQuery::FlushResults()
 		FlushOne();
 }
 
+void PerfQuery::PollResults()
+{
+	WeakFlush();
+}
+
 void PerfQuery::WeakFlush()
 {
 	UINT64 completed_fence = m_tracking_fence->GetCompletedValue();
@@ -25,6 +25,7 @@ public:
 	void ResetQuery() override;
 	u32 GetQueryResult(PerfQueryType type) override;
 	void FlushResults() override;
+	void PollResults() override;
 	bool IsFlushed() const override;
 
 private:
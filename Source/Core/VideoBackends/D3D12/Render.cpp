@@ -38,6 +38,7 @@
 #include "VideoCommon/AVIDump.h"
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
@@ -831,6 +832,7 @@ void Renderer::DrawEFB(const TargetRectangle& t_rc, const EFBRectangle& source_r
 			blit_depth_tex = FramebufferManager::GetResolvedEFBDepthTexture();
 
 		uintptr_t new_blit_tex;
+		FrameProfiler::ScopedPass post_processing_pass(FrameProfiler::PASS_POST_PROCESSING);
 		m_post_processor->PostProcess(&scaled_source_rc, &tex_size, &new_blit_tex,
 			src_rect, src_size, reinterpret_cast<uintptr_t>(tex),
 			src_rect, src_size, reinterpret_cast<uintptr_t>(blit_depth_tex));
@@ -1052,6 +1054,7 @@ void Renderer::ApplyState(bool use_dst_alpha)
 		}
 
 		ID3D12PipelineState* pso = nullptr;
+		m_pipeline_ready = false;
 		CheckHR(
 			gx_state_cache.GetPipelineStateObjectFromCache(
 				pso_desc,
@@ -1064,9 +1067,14 @@ void Renderer::ApplyState(bool use_dst_alpha)
 			)
 		);
 
-		D3D::current_command_list->SetPipelineState(pso);
+		// Still being created on the thread pool, stay dirty so the next draw asks again
+		if (pso)
+		{
+			D3D::current_command_list->SetPipelineState(pso);
 
-		D3D::command_list_mgr->SetCommandListDirtyState(COMMAND_LIST_STATE_PSO, false);
+			D3D::command_list_mgr->SetCommandListDirtyState(COMMAND_LIST_STATE_PSO, false);
+			m_pipeline_ready = true;
+		}
 	}
 	FramebufferManager::InvalidateEFBCache();
 	FramebufferManager::GetEFBDepthTexture()->TransitionToResourceState(D3D::current_command_list, D3D12_RESOURCE_STATE_DEPTH_WRITE);
@@ -1325,6 +1333,7 @@ void Renderer::BBoxWrite(int index, u16 value)
 void Renderer::BlitScreen(TargetRectangle dst_rect, TargetRectangle src_rect, TargetSize src_size, D3DTexture2D* src_texture, D3DTexture2D* depth_texture,
 	const TargetSize& dst_size, D3DTexture2D* dst_texture, float Gamma)
 {
+	FrameProfiler::ScopedPass post_processing_pass(FrameProfiler::PASS_POST_PROCESSING);
 	if (g_ActiveConfig.iStereoMode == STEREO_SBS || g_ActiveConfig.iStereoMode == STEREO_TAB)
 	{
 		TargetRectangle left_rc, right_rc;
@@ -1478,7 +1487,6 @@ void  Renderer::DumpFrame(const EFBRectangle& source_rc, u32 xfb_addr,
 	AVIDump::Frame state = AVIDump::FetchState(ticks);
 	DumpFrameData(reinterpret_cast<const u8*>(screenshot_texture_map), box_width, box_height,
 		dst_location.PlacedFootprint.Footprint.RowPitch, state);
-	FinishFrameData();
 
 	D3D12_RANGE write_range = {};
 	m_frame_dump_buffer->Unmap(0, &write_range);
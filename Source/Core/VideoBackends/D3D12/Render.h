@@ -33,6 +33,8 @@ public:
 	// TODO: Fix confusing names (see ResetAPIState and RestoreAPIState)
 	void ApplyState(bool use_dst_alpha) override;
 	void RestoreState() override;
+	// False when the last ApplyState had no PSO to bind, the draw has to be skipped.
+	bool IsPipelineReady() const { return m_pipeline_ready; }
 
 	void ApplyCullDisable();
 	void RestoreCull();
@@ -98,6 +100,7 @@ private:
 	bool m_target_dirty = true;
 	bool m_previous_use_dst_alpha = false;
 	D3DVertexFormat* m_previous_vertex_format = nullptr;
+	bool m_pipeline_ready = true;
 };
 
 }
@@ -132,7 +132,7 @@ bool TextureCache::TCacheEntry::Save(const std::string& filename, unsigned int l
 	}
 	else
 	{
-		saved = TextureToPng(
+		saved = TextureToPngAsync(
 			static_cast<u8*>(readback_texture_map),
 			dst_location.PlacedFootprint.Footprint.RowPitch,
 			filename,
@@ -142,6 +142,8 @@ void VertexManager::Draw(u32 stride)
 	if (PerfQueryBase::ShouldEmulate())
 		static_cast<PerfQuery*>(g_perf_query.get())->EndQuery();
 	INCSTAT(stats.thisFrame.numDrawCalls);
+	if (d3d_primitive_topology == D3D_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST)
+		ADDSTAT(stats.thisFrame.numTessellatedPatches, indices / 3);
 }
 
 void VertexManager::PrepareShaders(PrimitiveType primitive, u32 components, const XFMemory &xfr, const BPMemory &bpm, bool ongputhread)
@@ -163,6 +165,8 @@ void VertexManager::vFlush(bool use_dst_alpha)
 	PrepareDrawBuffers(stride);
 
 	g_renderer->ApplyState(use_dst_alpha);
+	if (!static_cast<Renderer*>(g_renderer.get())->IsPipelineReady())
+		return;
 
 	Draw(stride);
 
@@ -245,31 +245,50 @@ void StateManager::Apply()
 			m_current.inputLayout = m_pending.inputLayout;
 		}
 	}
+	// Slots that were changed and changed back before the draw are dropped, the rest goes
+	// to the runtime as contiguous ranges instead of one call per slot.
+	const bool bind_domain_resources = g_ActiveConfig.backend_info.bSupportsTessellation;
 	u64 dirty_elements = m_dirtyFlags & DirtyFlag_Textures;
-	if (dirty_elements)
+	while (dirty_elements)
 	{
-		while (dirty_elements)
+		unsigned long index;
+		_BitScanForward64(&index, dirty_elements);
+		dirty_elements &= ~(1ull << index);
+		if (m_current.textures[index] == m_pending.textures[index])
+			continue;
+		u32 count = 1;
+		while ((dirty_elements & (1ull << (index + count))) &&
+			m_current.textures[index + count] != m_pending.textures[index + count])
 		{
-			unsigned long index;
-			_BitScanForward64(&index, dirty_elements);
-			D3D::context->PSSetShaderResources(index, 1, &m_pending.textures[index]);
-			D3D::context->DSSetShaderResources(index, 1, &m_pending.textures[index]);
-			m_current.textures[index] = m_pending.textures[index];
-			dirty_elements &= ~(1ull << index);
+			dirty_elements &= ~(1ull << (index + count));
+			count++;
 		}
+		D3D::context->PSSetShaderResources(index, count, &m_pending.textures[index]);
+		if (bind_domain_resources)
+			D3D::context->DSSetShaderResources(index, count, &m_pending.textures[index]);
+		for (u32 i = index; i < index + count; i++)
+			m_current.textures[i] = m_pending.textures[i];
 	}
 	dirty_elements = (m_dirtyFlags & DirtyFlag_Samplers) >> 16;
-	if (dirty_elements)
+	while (dirty_elements)
 	{
-		while (dirty_elements)
+		unsigned long index;
+		_BitScanForward64(&index, dirty_elements);
+		dirty_elements &= ~(1ull << index);
+		if (m_current.samplers[index] == m_pending.samplers[index])
+			continue;
+		u32 count = 1;
+		while ((dirty_elements & (1ull << (index + count))) &&
+			m_current.samplers[index + count] != m_pending.samplers[index + count])
 		{
-			unsigned long index;
-			_BitScanForward64(&index, dirty_elements);
-			D3D::context->PSSetSamplers(index, 1, &m_pending.samplers[index]);
-			D3D::context->DSSetSamplers(index, 1, &m_pending.samplers[index]);
-			m_current.samplers[index] = m_pending.samplers[index];
-			dirty_elements &= ~(1 << index);
+			dirty_elements &= ~(1ull << (index + count));
+			count++;
 		}
+		D3D::context->PSSetSamplers(index, count, &m_pending.samplers[index]);
+		if (bind_domain_resources)
+			D3D::context->DSSetSamplers(index, count, &m_pending.samplers[index]);
+		for (u32 i = index; i < index + count; i++)
+			m_current.samplers[i] = m_pending.samplers[i];
 	}
 
 	if (m_dirtyFlags & DirtyFlag_Shaders)
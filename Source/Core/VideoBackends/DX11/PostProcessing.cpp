@@ -244,6 +244,10 @@ void D3DPostProcessingShader::Draw(PostProcessor* p,
 		{
 			output_rect = PostProcessor::ScaleTargetRectangle(API_D3D11, src_rect, pass.output_scale);
 			output_size = pass.output_size;
+			// Pass outputs are shared, an earlier pass may still have this one bound as an input.
+			for (u32 i = 0; i < POST_PROCESSING_MAX_TEXTURE_INPUTS; i++)
+				D3D::stateman->SetTexture(FIRST_INPUT_BINDING_SLOT + i, nullptr);
+			D3D::stateman->Apply();
 			D3D::context->OMSetRenderTargets(1, &reinterpret_cast<D3DTexture2D*>(pass.output_texture->GetInternalObject())->GetRTV(), nullptr);
 		}
 
@@ -38,6 +38,7 @@
 #include "VideoCommon/AVIDump.h"
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
@@ -1133,6 +1134,7 @@ void Renderer::DrawEFB(const TargetRectangle& t_rc, const EFBRectangle& source_r
 			blit_depth_tex = FramebufferManager::GetResolvedEFBDepthTexture();
 
 		uintptr_t new_blit_tex;
+		FrameProfiler::ScopedPass post_processing_pass(FrameProfiler::PASS_POST_PROCESSING);
 		m_post_processor->PostProcess(&scaled_source_rc, &tex_size, &new_blit_tex,
 			src_rect, src_size, reinterpret_cast<uintptr_t>(tex),
 			src_rect, src_size, reinterpret_cast<uintptr_t>(blit_depth_tex));
@@ -1210,6 +1212,7 @@ void Renderer::DrawRealXFB(const TargetRectangle& target_rc, u32 xfb_addr, D3DTe
 void Renderer::BlitScreen(TargetRectangle dst_rect, TargetRectangle src_rect, TargetSize src_size, D3DTexture2D* src_texture, D3DTexture2D* depth_texture,
 	const TargetSize& dst_size, D3DTexture2D* dst_texture, float Gamma)
 {
+	FrameProfiler::ScopedPass post_processing_pass(FrameProfiler::PASS_POST_PROCESSING);
 	if (g_ActiveConfig.iStereoMode == STEREO_SBS || g_ActiveConfig.iStereoMode == STEREO_TAB)
 	{
 		TargetRectangle leftRc, rightRc;
@@ -1296,7 +1299,6 @@ void  Renderer::DumpFrame(const EFBRectangle& source_rc, u32 xfb_addr,
 	AVIDump::Frame state = AVIDump::FetchState(ticks);
 	DumpFrameData(reinterpret_cast<const u8*>(map.pData), box_width, box_height,
 		map.RowPitch, state);
-	FinishFrameData();
 	D3D::context->Unmap(m_frame_dump_staging_texture.get(), 0);
 }
 
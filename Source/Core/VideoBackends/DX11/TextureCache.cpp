@@ -87,7 +87,7 @@ bool TextureCache::TCacheEntry::Save(const std::string& filename, u32 level)
 	}
 	else
 	{
-		encode_result = TextureToPng(reinterpret_cast<u8*>(map.pData), map.RowPitch, filename, mip_width, mip_height);
+		encode_result = TextureToPngAsync(reinterpret_cast<u8*>(map.pData), map.RowPitch, filename, mip_width, mip_height);
 	}
 	D3D::context->Unmap(staging_texture, 0);
 	staging_texture->Release();
@@ -124,6 +124,8 @@ void VertexManager::Draw(UINT stride)
 		auto pt = HullDomainShaderCache::GetActiveHullShader() != nullptr ?
 			D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST :
 			D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		if (pt == D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST)
+			ADDSTAT(stats.thisFrame.numTessellatedPatches, indices / 3);
 
 		D3D::stateman->SetPrimitiveTopology(pt);
 	}
@@ -643,7 +643,6 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, co
 			AVIDump::Frame state = AVIDump::FetchState(ticks);
 			DumpFrameData(reinterpret_cast<const u8*>(rect.pBits), source_width, source_height,
 				rect.Pitch, state, false, true);
-			FinishFrameData();
 
 			m_screen_shoot_mem_surface->UnlockRect();
 		}
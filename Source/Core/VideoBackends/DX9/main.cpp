@@ -88,6 +88,7 @@ void VideoBackend::InitBackendInfo()
 	g_Config.backend_info.bSupportsOversizedViewports = false;
 	g_Config.backend_info.bSupportsBBox = false;
 	g_Config.backend_info.bSupportsGeometryShaders = false;
+	g_Config.backend_info.bSupportsVSLayerOutput = false;
 	g_Config.backend_info.bSupports3DVision = false;
 	g_Config.backend_info.bSupportsPostProcessing = false;
 	g_Config.backend_info.bSupportsClipControl = true;
@@ -0,0 +1,44 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoBackends/Null/Render.h"
+
+#include "VideoCommon/FramebufferManagerBase.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace Null
+{
+Renderer::Renderer()
+{
+	g_Config.bRunning = true;
+	UpdateActiveConfig();
+
+	m_backbuffer_width = MAX_XFB_WIDTH;
+	m_backbuffer_height = MAX_XFB_HEIGHT;
+	FramebufferManagerBase::SetLastXfbWidth(MAX_XFB_WIDTH);
+	FramebufferManagerBase::SetLastXfbHeight(MAX_XFB_HEIGHT);
+}
+
+Renderer::~Renderer()
+{
+	g_Config.bRunning = false;
+	UpdateActiveConfig();
+}
+
+TargetRectangle Renderer::ConvertEFBRectangle(const EFBRectangle& rc)
+{
+	TargetRectangle result;
+	result.left = rc.left;
+	result.top = rc.top;
+	result.right = rc.right;
+	result.bottom = rc.bottom;
+	return result;
+}
+
+void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
+	const EFBRectangle& rc, u64 ticks, float Gamma)
+{
+	UpdateActiveConfig();
+}
+}
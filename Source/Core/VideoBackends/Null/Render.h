@@ -0,0 +1,38 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+
+#include "VideoCommon/RenderBase.h"
+
+namespace Null
+{
+class Renderer : public ::Renderer
+{
+public:
+	Renderer();
+	~Renderer() override;
+
+	void RenderText(const std::string& str, int left, int top, u32 color) override {}
+	u32 AccessEFB(EFBAccessType type, u32 x, u32 y, u32 poke_data) override { return 0; }
+	void PokeEFB(EFBAccessType type, const EfbPokeData* points, size_t num_points) override {}
+	u16 BBoxRead(int index) override { return m_bbox[index]; }
+	void BBoxWrite(int index, u16 value) override { m_bbox[index] = value; }
+	TargetRectangle ConvertEFBRectangle(const EFBRectangle& rc) override;
+
+	void SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc,
+		u64 ticks, float Gamma) override;
+
+	void ClearScreen(const EFBRectangle& rc, bool colorEnable, bool alphaEnable, bool zEnable,
+		u32 color, u32 z) override
+	{
+	}
+	void ReinterpretPixelData(unsigned int convtype) override {}
+
+private:
+	std::array<u16, 4> m_bbox{};
+};
+}
@@ -0,0 +1,29 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "VideoCommon/VideoBackendBase.h"
+
+// Decodes the command stream like every other backend but draws nothing, for benchmarks and
+// tests that only care about the CPU side of emulation.
+namespace Null
+{
+class VideoBackend : public VideoBackendBase
+{
+	bool Initialize(void* window_handle) override;
+	void Shutdown() override;
+
+	std::string GetName() const override { return "Null"; }
+	std::string GetDisplayName() const override { return "Null"; }
+	void Video_Prepare() override;
+	void Video_Cleanup() override;
+
+	void InitBackendInfo() override;
+
+	unsigned int PeekMessages() override { return 0; }
+};
+}
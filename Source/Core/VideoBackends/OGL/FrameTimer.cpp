@@ -0,0 +1,101 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/GL/GLInterfaceBase.h"
+
+#include "VideoBackends/OGL/FrameTimer.h"
+
+namespace OGL
+{
+std::unique_ptr<FrameTimer> FrameTimer::Create()
+{
+	if (GLInterface->GetMode() != GLInterfaceMode::MODE_OPENGL || !GLExtensions::Supports("GL_ARB_timer_query"))
+		return nullptr;
+	return std::make_unique<FrameTimer>();
+}
+
+FrameTimer::~FrameTimer()
+{
+	for (const Frame& frame : m_pending_frames)
+	{
+		for (const Interval& interval : frame)
+		{
+			m_free_queries.push_back(interval.begin_query);
+			m_free_queries.push_back(interval.end_query);
+		}
+	}
+	for (const Interval& interval : m_current_frame)
+	{
+		m_free_queries.push_back(interval.begin_query);
+		m_free_queries.push_back(interval.end_query);
+	}
+	if (!m_free_queries.empty())
+		glDeleteQueries(static_cast<GLsizei>(m_free_queries.size()), m_free_queries.data());
+}
+
+GLuint FrameTimer::AllocateQuery()
+{
+	if (m_free_queries.empty())
+	{
+		GLuint query;
+		glGenQueries(1, &query);
+		return query;
+	}
+	GLuint query = m_free_queries.back();
+	m_free_queries.pop_back();
+	return query;
+}
+
+void FrameTimer::Begin(FrameProfiler::Pass pass)
+{
+	m_open_queries[pass] = AllocateQuery();
+	glQueryCounter(m_open_queries[pass], GL_TIMESTAMP);
+}
+
+void FrameTimer::End(FrameProfiler::Pass pass)
+{
+	Interval interval = {pass, m_open_queries[pass], AllocateQuery()};
+	glQueryCounter(interval.end_query, GL_TIMESTAMP);
+	m_current_frame.push_back(interval);
+}
+
+void FrameTimer::ResolveOldestFrame(FrameProfiler::PassTimes* times)
+{
+	times->fill(0.0);
+	for (const Interval& interval : m_pending_frames.front())
+	{
+		GLuint64 begin_ns = 0, end_ns = 0;
+		glGetQueryObjectui64v(interval.begin_query, GL_QUERY_RESULT, &begin_ns);
+		glGetQueryObjectui64v(interval.end_query, GL_QUERY_RESULT, &end_ns);
+		if (end_ns > begin_ns)
+			(*times)[interval.pass] += (end_ns - begin_ns) / 1000000.0;
+		m_free_queries.push_back(interval.begin_query);
+		m_free_queries.push_back(interval.end_query);
+	}
+	m_pending_frames.pop_front();
+}
+
+bool FrameTimer::ResolveFrame(FrameProfiler::PassTimes* times)
+{
+	m_pending_frames.push_back(std::move(m_current_frame));
+	m_current_frame.clear();
+
+	bool resolved = false;
+	while (!m_pending_frames.empty())
+	{
+		const Frame& oldest = m_pending_frames.front();
+		// The end queries complete in order, the frame is done once its last one is
+		if (!oldest.empty() && m_pending_frames.size() <= MAX_PENDING_FRAMES)
+		{
+			GLuint available = GL_FALSE;
+			glGetQueryObjectuiv(oldest.back().end_query, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+				break;
+		}
+		ResolveOldestFrame(times);
+		resolved = true;
+	}
+	return resolved;
+}
+}
@@ -0,0 +1,52 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "Common/GL/GLUtil.h"
+
+#include "VideoCommon/FrameProfiler.h"
+
+namespace OGL
+{
+// Times the FrameProfiler passes with GL_TIMESTAMP queries. Unlike GPUTimer it can nest and
+// never waits for results, they are read back once a later frame finds them available.
+class FrameTimer final : public FrameProfiler::GPUTimer
+{
+public:
+	~FrameTimer();
+
+	// nullptr when the driver has no timer queries
+	static std::unique_ptr<FrameTimer> Create();
+
+	void Begin(FrameProfiler::Pass pass) override;
+	void End(FrameProfiler::Pass pass) override;
+	bool ResolveFrame(FrameProfiler::PassTimes* times) override;
+
+private:
+	struct Interval
+	{
+		FrameProfiler::Pass pass;
+		GLuint begin_query;
+		GLuint end_query;
+	};
+	typedef std::vector<Interval> Frame;
+
+	// Frames older than this are resolved even if that has to wait for the GPU
+	static constexpr size_t MAX_PENDING_FRAMES = 8;
+
+	GLuint AllocateQuery();
+	void ResolveOldestFrame(FrameProfiler::PassTimes* times);
+
+	std::vector<GLuint> m_free_queries;
+	std::array<GLuint, FrameProfiler::PASS_COUNT> m_open_queries{};
+	Frame m_current_frame;
+	std::deque<Frame> m_pending_frames;
+};
+}
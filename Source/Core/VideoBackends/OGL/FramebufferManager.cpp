@@ -36,6 +36,10 @@ GLuint FramebufferManager::m_efbColorSwap; // for hot swap when reinterpreting E
 std::vector<GLuint> FramebufferManager::m_resolvedFramebuffer;
 GLuint FramebufferManager::m_resolvedColorTexture;
 GLuint FramebufferManager::m_resolvedDepthTexture;
+TargetRectangle FramebufferManager::m_resolvedColorRect;
+TargetRectangle FramebufferManager::m_resolvedDepthRect;
+bool FramebufferManager::m_resolvedColorValid;
+bool FramebufferManager::m_resolvedDepthValid;
 
 // reinterpret pixel format
 SHADER FramebufferManager::m_pixel_format_shaders[2];
@@ -53,6 +57,7 @@ FramebufferManager::FramebufferManager(int targetWidth, int targetHeight, int ms
 	m_efbColorSwap = 0;
 	m_resolvedColorTexture = 0;
 	m_resolvedDepthTexture = 0;
+	InvalidateResolvedEFB();
 
 	m_targetWidth = targetWidth;
 	m_targetHeight = targetHeight;
@@ -448,6 +453,12 @@ FramebufferManager::~FramebufferManager()
 	m_EfbPokes.Destroy();
 }
 
+static bool ContainsRect(const TargetRectangle& outer, const TargetRectangle& inner)
+{
+	return inner.left >= outer.left && inner.right <= outer.right &&
+		inner.top >= outer.top && inner.bottom <= outer.bottom;
+}
+
 GLuint FramebufferManager::GetEFBColorTexture(const EFBRectangle& sourceRc)
 {
 	if (m_msaaSamples <= 1)
@@ -462,6 +473,13 @@ GLuint FramebufferManager::GetEFBColorTexture(const EFBRectangle& sourceRc)
 		TargetRectangle targetRc = g_renderer->ConvertEFBRectangle(sourceRc);
 		targetRc.ClampUL(0, 0, m_targetWidth, m_targetHeight);
 
+		// Nothing was drawn since this area was last resolved.
+		if (m_resolvedColorValid && ContainsRect(m_resolvedColorRect, targetRc))
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, m_efbFramebuffer[0]);
+			return m_resolvedColorTexture;
+		}
+
 		// Resolve.
 		for (unsigned int i = 0; i < m_EFBLayers; i++)
 		{
@@ -473,6 +491,8 @@ GLuint FramebufferManager::GetEFBColorTexture(const EFBRectangle& sourceRc)
 				GL_COLOR_BUFFER_BIT, GL_NEAREST
 			);
 		}
+		m_resolvedColorRect = targetRc;
+		m_resolvedColorValid = true;
 
 		// Return to EFB.
 		glBindFramebuffer(GL_FRAMEBUFFER, m_efbFramebuffer[0]);
@@ -494,6 +514,12 @@ GLuint FramebufferManager::GetEFBDepthTexture(const EFBRectangle& sourceRc)
 		TargetRectangle targetRc = g_renderer->ConvertEFBRectangle(sourceRc);
 		targetRc.ClampUL(0, 0, m_targetWidth, m_targetHeight);
 
+		if (m_resolvedDepthValid && ContainsRect(m_resolvedDepthRect, targetRc))
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, m_efbFramebuffer[0]);
+			return m_resolvedDepthTexture;
+		}
+
 		// Resolve.
 		for (unsigned int i = 0; i < m_EFBLayers; i++)
 		{
@@ -505,6 +531,8 @@ GLuint FramebufferManager::GetEFBDepthTexture(const EFBRectangle& sourceRc)
 				GL_DEPTH_BUFFER_BIT, GL_NEAREST
 			);
 		}
+		m_resolvedDepthRect = targetRc;
+		m_resolvedDepthValid = true;
 
 		// Return to EFB.
 		glBindFramebuffer(GL_FRAMEBUFFER, m_efbFramebuffer[0]);
@@ -559,6 +587,7 @@ GLuint FramebufferManager::ResolveAndGetDepthTarget(const EFBRectangle &source_r
 
 void FramebufferManager::ReinterpretPixelData(unsigned int convtype)
 {
+	InvalidateResolvedEFB();
 	g_renderer->ResetAPIState();
 
 	OpenGL_BindAttributelessVAO();
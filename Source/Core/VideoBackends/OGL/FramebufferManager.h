@@ -105,6 +105,14 @@ public:
 	// After calling this, before you render anything else, you MUST bind the framebuffer you want to draw to.
 	static GLuint ResolveAndGetDepthTarget(const EFBRectangle &rect);
 
+	// Resolved rectangles are kept until the EFB is written again, this must be called whenever
+	// that happens.
+	static void InvalidateResolvedEFB()
+	{
+		m_resolvedColorValid = false;
+		m_resolvedDepthValid = false;
+	}
+
 	// Convert EFB content on pixel format change.
 	// convtype=0 -> rgb8->rgba6, convtype=2 -> rgba6->rgb8
 	static void ReinterpretPixelData(unsigned int convtype);
@@ -132,6 +140,10 @@ private:
 	static std::vector<GLuint> m_resolvedFramebuffer;
 	static GLuint m_resolvedColorTexture;
 	static GLuint m_resolvedDepthTexture;
+	static TargetRectangle m_resolvedColorRect;
+	static TargetRectangle m_resolvedDepthRect;
+	static bool m_resolvedColorValid;
+	static bool m_resolvedDepthValid;
 
 	// For pixel format draw
 	static SHADER m_pixel_format_shaders[2];
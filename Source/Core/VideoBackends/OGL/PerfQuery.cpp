@@ -54,6 +54,11 @@ void PerfQuery::FlushResults()
 	m_query->FlushResults();
 }
 
+void PerfQuery::PollResults()
+{
+	m_query->PollResults();
+}
+
 void PerfQuery::ResetQuery()
 {
 	m_query_count = 0;
@@ -130,6 +135,11 @@ void PerfQueryGL::DisableQuery(PerfQueryGroup type)
 	}
 }
 
+void PerfQueryGL::PollResults()
+{
+	WeakFlush();
+}
+
 void PerfQueryGL::WeakFlush()
 {
 	while (!IsFlushed())
@@ -223,6 +233,11 @@ void PerfQueryGLESNV::DisableQuery(PerfQueryGroup type)
 	}
 }
 
+void PerfQueryGLESNV::PollResults()
+{
+	WeakFlush();
+}
+
 void PerfQueryGLESNV::WeakFlush()
 {
 	while (!IsFlushed())
@@ -27,6 +27,7 @@ public:
 	void ResetQuery() override;
 	u32 GetQueryResult(PerfQueryType type) override;
 	void FlushResults() override;
+	void PollResults() override;
 	bool IsFlushed() const override;
 
 protected:
@@ -58,6 +59,7 @@ public:
 	void EnableQuery(PerfQueryGroup type) override;
 	void DisableQuery(PerfQueryGroup type) override;
 	void FlushResults() override;
+	void PollResults() override;
 
 private:
 
@@ -77,6 +79,7 @@ public:
 	void EnableQuery(PerfQueryGroup type) override;
 	void DisableQuery(PerfQueryGroup type) override;
 	void FlushResults() override;
+	void PollResults() override;
 
 private:
 
@@ -2,12 +2,16 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "Common/Align.h"
 #include "Common/Common.h"
+#include "Common/IndexedDiskCache.h"
 #include "Common/MathUtil.h"
 #include "Common/StringUtil.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/Host.h"
 #include "Core/ConfigManager.h"
@@ -18,9 +22,11 @@
 
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/DriverDetails.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/ShaderCacheBundle.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexShaderManager.h"
 
@@ -35,11 +41,16 @@ s32 ProgramShaderCache::s_ubo_align;
 static std::unique_ptr<StreamBuffer> s_buffer;
 static int num_failures = 0;
 
-static LinearDiskCache<SHADERUID, u8> g_program_disk_cache;
+// Binaries are only read when a program is first needed, not when the game starts.
+static IndexedDiskCache<SHADERUID, u8, SHADERUID::ShaderUidHasher, std::equal_to<SHADERUID>> g_program_disk_cache;
+// Programs of all games, per-game lookups fall back to it
+static IndexedDiskCache<SHADERUID, u8, SHADERUID::ShaderUidHasher, std::equal_to<SHADERUID>> g_shared_program_disk_cache;
+static bool s_shared_cache_open = false;
 static GLuint CurrentProgram = 0;
 ProgramShaderCache::PCache* ProgramShaderCache::pshaders;
 std::array<ProgramShaderCache::PCacheEntry*, PIXEL_SHADER_RENDER_MODE::PSRM_DEPTH_ONLY + 1> ProgramShaderCache::last_entry;
 std::array<SHADERUID, PIXEL_SHADER_RENDER_MODE::PSRM_DEPTH_ONLY + 1> ProgramShaderCache::last_uid;
+std::array<ShaderUIDStateTag, PIXEL_SHADER_RENDER_MODE::PSRM_DEPTH_ONLY + 1> ProgramShaderCache::last_uid_state;
 
 static char s_glsl_header[2048] = "";
 
@@ -223,12 +234,21 @@ SHADER* ProgramShaderCache::CompileShader(const SHADERUID& uid)
 	{
 		last_entry[render_mode] = &newentry;
 		GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
-		return &last_entry[render_mode]->shader;
+		return GetReadyShader(&newentry);
 	}
 	// Make an entry in the table
 	last_entry[render_mode] = &newentry;
 	newentry.in_cache = 0;
 
+	FrameProfiler::ScopedPass shader_compilation_pass(FrameProfiler::PASS_SHADER_COMPILATION);
+	TRACE_SCOPE("OGL::CompileShader");
+
+	if (g_ogl_config.bSupportsGLSLCache && LoadFromDiskCache(uid, newentry))
+	{
+		GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
+		return &newentry.shader;
+	}
+
 	ShaderCode vcode;
 	ShaderCode pcode;
 	ShaderCode gcode;
@@ -255,7 +275,10 @@ SHADER* ProgramShaderCache::CompileShader(const SHADERUID& uid)
 	}
 #endif
 
-	if (!CompileShader(newentry.shader, vcode.GetBuffer(), pcode.GetBuffer(), gcode.GetBuffer()))
+	const bool compiled = UseAsyncCompilation() ?
+		CompileShaderAsync(newentry.shader, vcode.GetBuffer(), pcode.GetBuffer(), gcode.GetBuffer()) :
+		CompileShader(newentry.shader, vcode.GetBuffer(), pcode.GetBuffer(), gcode.GetBuffer());
+	if (!compiled)
 	{
 		GFX_DEBUGGER_PAUSE_AT(NEXT_ERROR, true);
 		return nullptr;
@@ -265,11 +288,32 @@ SHADER* ProgramShaderCache::CompileShader(const SHADERUID& uid)
 	SETSTAT(stats.numPixelShadersAlive, static_cast<int>(pshaders->size()));
 	GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
 
-	return &last_entry[render_mode]->shader;
+	return GetReadyShader(&newentry);
+}
+
+bool ProgramShaderCache::UseAsyncCompilation()
+{
+	return g_ogl_config.bSupportsParallelShaderCompile && g_ActiveConfig.bFullAsyncShaderCompilation;
+}
+
+SHADER* ProgramShaderCache::GetReadyShader(PCacheEntry* entry)
+{
+	// Draws are skipped while the program is still being built, like the D3D backends do
+	if (!PollShader(entry->shader, !g_ActiveConfig.bFullAsyncShaderCompilation))
+		return nullptr;
+	return &entry->shader;
 }
 
 SHADER* ProgramShaderCache::SetShader(PIXEL_SHADER_RENDER_MODE render_mode, u32 components, u32 primitive_type)
 {
+	// Nothing that goes into the uid was written since the last draw in this mode
+	if (last_entry[render_mode] && last_uid_state[render_mode].Matches(components, primitive_type))
+	{
+		GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
+		return GetReadyShader(last_entry[render_mode]);
+	}
+	last_uid_state[render_mode].Set(components, primitive_type);
+
 	SHADERUID uid;
 	GetShaderId(&uid, render_mode, components, primitive_type);
 	uid.CalculateHash();
@@ -279,7 +323,7 @@ SHADER* ProgramShaderCache::SetShader(PIXEL_SHADER_RENDER_MODE render_mode, u32
 		if (uid == last_uid[render_mode])
 		{
 			GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
-			return &last_entry[render_mode]->shader;
+			return GetReadyShader(last_entry[render_mode]);
 		}
 	}
 
@@ -287,6 +331,19 @@ SHADER* ProgramShaderCache::SetShader(PIXEL_SHADER_RENDER_MODE render_mode, u32
 	return CompileShader(uid);
 }
 
+void ProgramShaderCache::PrepareShader(PIXEL_SHADER_RENDER_MODE render_mode, u32 components, u32 primitive_type, const XFMemory &xfr, const BPMemory &bpm)
+{
+	SHADERUID uid;
+	GetPixelShaderUID(uid.puid, render_mode, components, xfr, bpm);
+	GetVertexShaderUID(uid.vuid, components, xfr, bpm);
+	GetGeometryShaderUid(uid.guid, primitive_type, xfr, components);
+	uid.CalculateHash();
+
+	PCacheEntry* current_entry = last_entry[render_mode];
+	CompileShader(uid);
+	last_entry[render_mode] = current_entry;
+}
+
 bool ProgramShaderCache::CompileShader(SHADER& shader, const char* vcode, const char* pcode, const char* gcode, const char **macros, const u32 macro_count)
 {
 	GLuint vsid = CompileSingleShader(GL_VERTEX_SHADER, vcode, macros, macro_count);
@@ -324,6 +381,104 @@ bool ProgramShaderCache::CompileShader(SHADER& shader, const char* vcode, const
 	glDeleteShader(psid);
 	glDeleteShader(gsid);
 
+	if (!CheckProgramLinkResult(pid, vcode, pcode, gcode))
+	{
+		shader.glprogid = 0;
+		return false;
+	}
+
+	shader.SetProgramVariables();
+
+	return true;
+}
+
+bool ProgramShaderCache::CompileShaderAsync(SHADER& shader, const char* vcode, const char* pcode, const char* gcode)
+{
+	// Nothing is queried here, any status query would wait for the compiler threads.
+	GLuint vsid = IssueSingleShader(GL_VERTEX_SHADER, vcode);
+	GLuint psid = IssueSingleShader(GL_FRAGMENT_SHADER, pcode);
+	GLuint gsid = gcode ? IssueSingleShader(GL_GEOMETRY_SHADER, gcode) : 0;
+
+	GLuint pid = shader.glprogid = glCreateProgram();
+
+	glAttachShader(pid, vsid);
+	glAttachShader(pid, psid);
+	if (gsid)
+		glAttachShader(pid, gsid);
+
+	if (g_ogl_config.bSupportsGLSLCache)
+		glProgramParameteri(pid, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	shader.SetProgramBindings(false);
+
+	glLinkProgram(pid);
+
+	shader.stage_ids = {{vsid, psid, gsid}};
+	shader.pending = true;
+	return true;
+}
+
+bool ProgramShaderCache::PollShader(SHADER& shader, bool wait)
+{
+	if (!shader.pending)
+		return shader.glprogid != 0;
+
+	if (!wait)
+	{
+		GLint completed = GL_FALSE;
+		glGetProgramiv(shader.glprogid, GL_COMPLETION_STATUS_KHR, &completed);
+		if (completed != GL_TRUE)
+			return false;
+	}
+	shader.pending = false;
+
+	static const GLenum stage_types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER };
+	std::array<std::string, 3> sources;
+	bool compiled = true;
+	for (size_t i = 0; i < shader.stage_ids.size(); i++)
+	{
+		GLuint id = shader.stage_ids[i];
+		if (!id)
+			continue;
+		// The header is part of the source given to the driver, the reports add it back.
+		GLint length = 0;
+		glGetShaderiv(id, GL_SHADER_SOURCE_LENGTH, &length);
+		std::string source(std::max(length, 1), '\0');
+		glGetShaderSource(id, length, nullptr, &source[0]);
+		source.resize(std::strlen(source.c_str()));
+		sources[i] = source.substr(std::min(source.size(), std::strlen(s_glsl_header)));
+		if (!CheckShaderCompileResult(id, stage_types[i], sources[i].c_str()))
+		{
+			// Already deleted by the check
+			shader.stage_ids[i] = 0;
+			compiled = false;
+		}
+	}
+
+	bool linked = compiled && CheckProgramLinkResult(shader.glprogid, sources[0].c_str(),
+		sources[1].c_str(), shader.stage_ids[2] ? sources[2].c_str() : nullptr);
+
+	for (GLuint& id : shader.stage_ids)
+	{
+		if (id)
+			glDeleteShader(id);
+		id = 0;
+	}
+
+	if (!linked)
+	{
+		if (!compiled)
+			glDeleteProgram(shader.glprogid);
+		shader.glprogid = 0;
+		return false;
+	}
+
+	shader.SetProgramVariables();
+	return true;
+}
+
+bool ProgramShaderCache::CheckProgramLinkResult(GLuint pid, const char* vcode, const char* pcode, const char* gcode)
+{
 	GLint linkStatus;
 	glGetProgramiv(pid, GL_LINK_STATUS, &linkStatus);
 	GLsizei length = 0;
@@ -362,8 +517,6 @@ bool ProgramShaderCache::CompileShader(SHADER& shader, const char* vcode, const
 		return false;
 	}
 
-	shader.SetProgramVariables();
-
 	return true;
 }
 
@@ -436,6 +589,16 @@ bool ProgramShaderCache::CompileComputeShader(SHADER& shader, const std::string&
 
 GLuint ProgramShaderCache::CompileSingleShader(GLuint type, const char* code, const char **macros,
 	const u32 count)
+{
+	GLuint result = IssueSingleShader(type, code, macros, count);
+	if (!CheckShaderCompileResult(result, type, code))
+		return 0;
+
+	return result;
+}
+
+GLuint ProgramShaderCache::IssueSingleShader(GLuint type, const char* code, const char **macros,
+	const u32 count)
 {
 	GLuint result = glCreateShader(type);
 	std::vector<const char*> src(count + 2);
@@ -447,6 +610,11 @@ GLuint ProgramShaderCache::CompileSingleShader(GLuint type, const char* code, co
 	src[count + 2 - 1] = code;
 	glShaderSource(result, count + 2, src.data(), nullptr);
 	glCompileShader(result);
+	return result;
+}
+
+bool ProgramShaderCache::CheckShaderCompileResult(GLuint result, GLuint type, const char* code)
+{
 	GLint compileStatus;
 	glGetShaderiv(result, GL_COMPILE_STATUS, &compileStatus);
 	GLsizei length = 0;
@@ -501,10 +669,10 @@ GLuint ProgramShaderCache::CompileSingleShader(GLuint type, const char* code, co
 
 		// Don't try to use this shader
 		glDeleteShader(result);
-		return 0;
+		return false;
 	}
 
-	return result;
+	return true;
 }
 
 void ProgramShaderCache::GetShaderId(SHADERUID* uid, PIXEL_SHADER_RENDER_MODE render_mode, u32 components, u32 primitive_type)
@@ -534,6 +702,15 @@ void ProgramShaderCache::Init()
 
 	s_buffer = StreamBuffer::Create(GL_UNIFORM_BUFFER, s_ubo_buffer_size * 2048);
 
+	// Let the driver pick as many compiler threads as it likes
+	if (g_ogl_config.bSupportsParallelShaderCompile)
+		glMaxShaderCompilerThreads(0xFFFFFFFF);
+
+	// A bundle from an identical machine only fills in files this one doesn't have yet
+	const std::string& game_id = SConfig::GetInstance().GetGameID();
+	if (g_ogl_config.bSupportsGLSLCache)
+		ShaderCacheBundle::Import(ShaderCacheBundle::GetBundlePath(game_id, "OGL"), game_id, GetDriverFingerprint());
+
 	pKey_t gameid = (pKey_t)GetMurmurHash3(reinterpret_cast<const u8*>(SConfig::GetInstance().GetGameID().data()), (u32)SConfig::GetInstance().GetGameID().size(), 0);
 	pshaders = PCache::Create(
 		gameid,
@@ -560,16 +737,23 @@ void ProgramShaderCache::Init()
 			std::string cache_filename = StringFromFormat("%sIOGL-%s-shaders.cache", File::GetUserPath(D_SHADERCACHE_IDX).c_str(),
 				SConfig::GetInstance().GetGameID().c_str());
 
-			ProgramShaderCacheInserter inserter;
-			g_program_disk_cache.OpenAndRead(cache_filename, inserter);
+			g_program_disk_cache.Open(cache_filename);
+
+			s_shared_cache_open = g_ActiveConfig.bSharedShaderCache;
+			if (s_shared_cache_open)
+			{
+				g_shared_program_disk_cache.SetSizeLimit(u64(std::max(g_ActiveConfig.iSharedShaderCacheSizeMB, 1)) << 20);
+				g_shared_program_disk_cache.Open(StringFromFormat("%sIOGL-shared-shaders.cache", File::GetUserPath(D_SHADERCACHE_IDX).c_str()));
+			}
 		}
-		SETSTAT(stats.numPixelShadersAlive, pshaders->size());
 	}
 
 	CreateHeader();
 
 	CurrentProgram = 0;
 	last_entry.fill(nullptr);
+	for (ShaderUIDStateTag& tag : last_uid_state)
+		tag.Invalidate();
 	if (g_ActiveConfig.bCompileShaderOnStartup)
 	{
 		size_t shader_count = 0;
@@ -608,7 +792,12 @@ void ProgramShaderCache::Shutdown()
 			// Clear any prior error code
 			glGetError();
 
-			if (entry.in_cache)
+			const bool in_shared_cache = s_shared_cache_open && g_shared_program_disk_cache.Contains(uid);
+			if (in_shared_cache)
+			{
+				g_shared_program_disk_cache.MarkUsed(uid);
+			}
+			if (entry.in_cache && (in_shared_cache || !s_shared_cache_open))
 			{
 				return;
 			}
@@ -631,12 +820,32 @@ void ProgramShaderCache::Shutdown()
 				return;
 			}
 
-			g_program_disk_cache.Append(uid, &data[0], binary_size + sizeof(GLenum));
+			if (!entry.in_cache)
+			{
+				g_program_disk_cache.Append(uid, &data[0], binary_size + sizeof(GLenum));
+			}
+			if (s_shared_cache_open && !in_shared_cache)
+			{
+				g_shared_program_disk_cache.Append(uid, &data[0], binary_size + sizeof(GLenum));
+			}
 		});
 		delete pshaders;
 		pshaders = nullptr;
 		g_program_disk_cache.Sync();
 		g_program_disk_cache.Close();
+		if (s_shared_cache_open)
+		{
+			g_shared_program_disk_cache.Sync();
+			g_shared_program_disk_cache.Close();
+			s_shared_cache_open = false;
+		}
+		if (g_ActiveConfig.bExportShaderCacheBundle)
+		{
+			const std::string& game_id = SConfig::GetInstance().GetGameID();
+			ShaderCacheBundle::Export(ShaderCacheBundle::GetBundlePath(game_id, "OGL"), game_id, GetDriverFingerprint(), {
+				{D_SHADERCACHE_IDX, StringFromFormat("IOGL-%s-shaders.cache", game_id.c_str())},
+				{D_SHADERUIDCACHE_IDX, StringFromFormat("%s.ps.OGL.usage", game_id.c_str())}});
+		}
 	}
 	s_buffer.reset();
 }
@@ -647,6 +856,7 @@ void ProgramShaderCache::CreateHeader()
 	bool is_glsles = v >= GLSLES_300;
 	std::string SupportedESPointSize;
 	std::string SupportedESTextureBuffer;
+	std::string SupportedVSLayerOutput;
 	switch (g_ogl_config.SupportedESPointSize)
 	{
 	case 1: SupportedESPointSize = "#extension GL_OES_geometry_point_size : enable"; break;
@@ -654,6 +864,13 @@ void ProgramShaderCache::CreateHeader()
 	default: SupportedESPointSize = ""; break;
 	}
 
+	switch (g_ogl_config.SupportedVSLayerOutput)
+	{
+	case 1: SupportedVSLayerOutput = "#extension GL_ARB_shader_viewport_layer_array : enable"; break;
+	case 2: SupportedVSLayerOutput = "#extension GL_AMD_vertex_shader_layer : enable"; break;
+	default: SupportedVSLayerOutput = ""; break;
+	}
+
 	switch (g_ogl_config.SupportedESTextureBuffer)
 	{
 	case ES_TEXBUF_TYPE::TEXBUF_EXT:
@@ -697,6 +914,7 @@ void ProgramShaderCache::CreateHeader()
 		"%s\n" // shader5
 		"%s\n" // SSAA
 		"%s\n" // Geometry point size
+		"%s\n" // Vertex shader layer output
 		"%s\n" // AEP
 		"%s\n" // texture buffer
 		"%s\n" // ES texture buffer
@@ -766,6 +984,7 @@ void ProgramShaderCache::CreateHeader()
 		, !is_glsles && g_ActiveConfig.backend_info.bSupportsBBox ? "#extension GL_ARB_shader_storage_buffer_object : enable" : ""
 		, !is_glsles && g_ActiveConfig.backend_info.bSupportsGSInstancing ? "#extension GL_ARB_gpu_shader5 : enable" : ""
 		, SupportedESPointSize.c_str()
+		, SupportedVSLayerOutput.c_str()
 		, g_ogl_config.bSupportsAEP ? "#extension GL_ANDROID_extension_pack_es31a : enable" : ""
 		, v < GLSL_140 && g_ActiveConfig.backend_info.bSupportsPaletteConversion ? "#extension GL_ARB_texture_buffer_object : enable" : ""
 		, v < GLSL_400 && g_ActiveConfig.backend_info.bSupportsSSAA ? "#extension GL_ARB_sample_shading : enable" : ""
@@ -784,34 +1003,53 @@ void ProgramShaderCache::CreateHeader()
 		);
 }
 
+std::string ProgramShaderCache::GetDriverFingerprint()
+{
+	return StringFromFormat("%s|%s|%s", g_ogl_config.gl_vendor, g_ogl_config.gl_renderer, g_ogl_config.gl_version);
+}
+
 u32 ProgramShaderCache::GetUniformBufferAlignment()
 {
 	return s_ubo_align;
 }
 
-void ProgramShaderCache::ProgramShaderCacheInserter::Read(const SHADERUID& key, const u8* value, u32 value_size)
+bool ProgramShaderCache::LoadFromDiskCache(const SHADERUID& uid, PCacheEntry& entry)
 {
-	const u8 *binary = value + sizeof(GLenum);
-	GLenum *prog_format = (GLenum*)value;
-	GLint binary_size = value_size - sizeof(GLenum);
+	std::vector<u8> data;
+	bool from_shared_cache = false;
+	if (!g_program_disk_cache.Lookup(uid, &data))
+	{
+		// Another game built it, copied to this game's cache on shutdown
+		if (!s_shared_cache_open || !g_shared_program_disk_cache.Lookup(uid, &data))
+			return false;
+		from_shared_cache = true;
+	}
+	if (data.size() < sizeof(GLenum))
+		return false;
+
+	const u8 *binary = data.data() + sizeof(GLenum);
+	GLenum prog_format;
+	std::memcpy(&prog_format, data.data(), sizeof(GLenum));
+	GLint binary_size = static_cast<GLint>(data.size() - sizeof(GLenum));
 
-	PCacheEntry& entry = pshaders->GetOrAdd(key);
-	entry.in_cache = 1;
 	entry.shader.glprogid = glCreateProgram();
-	glProgramBinary(entry.shader.glprogid, *prog_format, binary, binary_size);
+	glProgramBinary(entry.shader.glprogid, prog_format, binary, binary_size);
 
 	GLint success;
 	glGetProgramiv(entry.shader.glprogid, GL_LINK_STATUS, &success);
 
-	if (success)
-	{
-		entry.shader.SetProgramVariables();
-	}
-	else
+	if (!success)
 	{
+		// Stale binary, e.g. after a driver update, the program is compiled again
 		glDeleteProgram(entry.shader.glprogid);
 		entry.shader.glprogid = 0;
+		return false;
 	}
+
+	entry.in_cache = from_shared_cache ? 0 : 1;
+	entry.shader.SetProgramVariables();
+	SETSTAT(stats.numPixelShadersAlive, static_cast<int>(pshaders->size()));
+	return true;
 }
 
 
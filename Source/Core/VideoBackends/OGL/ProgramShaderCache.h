@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <array>
+#include <string>
+
 #include "Common/GL/GLUtil.h"
-#include "Common/LinearDiskCache.h"
 
 #include "VideoCommon/GeometryShaderGen.h"
 #include "VideoCommon/ObjectUsageProfiler.h"
@@ -66,19 +68,32 @@ public:
 
 struct SHADER
 {
-	SHADER() : glprogid(0), initialized(false)
-	{}
+	SHADER() : glprogid(0), initialized(false), pending(false)
+	{
+		stage_ids.fill(0);
+	}
 	void Destroy()
 	{
+		for (GLuint& id : stage_ids)
+		{
+			if (id != 0)
+				glDeleteShader(id);
+			id = 0;
+		}
 		if (glprogid != 0)
 		{
 			glDeleteProgram(glprogid);
 		}
 		glprogid = 0;
 		initialized = false;
+		pending = false;
 	}
 	GLuint glprogid; // OpenGL program id
 	bool initialized;
+	// Compile and link were issued to the driver's compiler threads but not checked yet,
+	// the stage objects are kept around for the error report.
+	bool pending;
+	std::array<GLuint, 3> stage_ids;
 	void SetProgramVariables();
 	void SetProgramBindings(bool is_compute);
 	void Bind();
@@ -104,11 +119,20 @@ public:
 	static GLuint GetCurrentProgram();
 	static SHADER* SetShader(PIXEL_SHADER_RENDER_MODE render_mode, u32 components, u32 primitive_type);
 	static SHADER* CompileShader(const SHADERUID& uid);
+	// Compiles the program for the given state without making it the current one.
+	static void PrepareShader(PIXEL_SHADER_RENDER_MODE render_mode, u32 components, u32 primitive_type, const XFMemory &xfr, const BPMemory &bpm);
 	static void GetShaderId(SHADERUID *uid, PIXEL_SHADER_RENDER_MODE render_mode, u32 components, u32 primitive_type);
 
 	static bool CompileShader(SHADER &shader, const char* vcode, const char* pcode, const char* gcode = nullptr, const char **macros = nullptr, const u32 macro_count = 0);
+	// Issues the compile and link without waiting, PollShader finishes it once the driver is done.
+	static bool CompileShaderAsync(SHADER& shader, const char* vcode, const char* pcode, const char* gcode = nullptr);
+	// Returns true once the program can be used, blocks on pending programs when wait is set.
+	static bool PollShader(SHADER& shader, bool wait);
 	static bool CompileComputeShader(SHADER& shader, const std::string& code);
 	static GLuint CompileSingleShader(GLuint type, const char *code, const char **macros = nullptr, const u32 count = 0);
+	static GLuint IssueSingleShader(GLuint type, const char *code, const char **macros = nullptr, const u32 count = 0);
+	static bool CheckShaderCompileResult(GLuint id, GLuint type, const char* code);
+	static bool CheckProgramLinkResult(GLuint pid, const char* vcode, const char* pcode, const char* gcode);
 	static void UploadConstants();
 
 	static void Init();
@@ -118,15 +142,17 @@ public:
 	static u32 GetUniformBufferAlignment();
 
 private:
-	class ProgramShaderCacheInserter : public LinearDiskCacheReader<SHADERUID, u8>
-	{
-	public:
-		void Read(const SHADERUID &key, const u8 *value, u32 value_size) override;
-	};
+	// Creates the program from the binary in the disk cache, if there is one.
+	static bool LoadFromDiskCache(const SHADERUID& uid, PCacheEntry& entry);
+	// Program binaries from a bundle are only usable on the same GPU and driver version.
+	static std::string GetDriverFingerprint();
 
 	static PCache* pshaders;
 	static std::array<PCacheEntry*, PIXEL_SHADER_RENDER_MODE::PSRM_DEPTH_ONLY + 1> last_entry;
 	static std::array<SHADERUID, PIXEL_SHADER_RENDER_MODE::PSRM_DEPTH_ONLY + 1>  last_uid;
+	static std::array<ShaderUIDStateTag, PIXEL_SHADER_RENDER_MODE::PSRM_DEPTH_ONLY + 1> last_uid_state;
+	static SHADER* GetReadyShader(PCacheEntry* entry);
+	static bool UseAsyncCompilation();
 
 	static u32 s_ubo_buffer_size;
 	static u32 s_p_ubo_buffer_size;
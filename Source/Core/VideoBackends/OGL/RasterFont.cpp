@@ -117,21 +117,23 @@ static const u8 rasters[CHARACTER_COUNT][CHARACTER_HEIGHT] = {
 	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x8f, 0xf1, 0x60, 0x00, 0x00, 0x00 } };
 
 static const char* s_vertexShaderSrc = "uniform vec2 charSize;\n"
-"uniform vec2 offset;"
 "in vec2 rawpos;\n"
 "in vec2 tex0;\n"
+"in vec4 color0;\n"
 "out vec2 uv0;\n"
+"out vec4 col0;\n"
 "void main(void) {\n"
-"	gl_Position = vec4(rawpos + offset,0,1);\n"
+"	gl_Position = vec4(rawpos,0,1);\n"
 "	uv0 = tex0 * charSize;\n"
+"	col0 = color0;\n"
 "}\n";
 
 static const char* s_fragmentShaderSrc = "SAMPLER_BINDING(8) uniform sampler2D samp8;\n"
-"uniform vec4 color;\n"
 "in vec2 uv0;\n"
+"in vec4 col0;\n"
 "out vec4 ocol0;\n"
 "void main(void) {\n"
-"	ocol0 = texture(samp8,uv0) * color;\n"
+"	ocol0 = texture(samp8,uv0) * col0;\n"
 "}\n";
 
 static SHADER s_shader;
@@ -166,10 +168,6 @@ RasterFont::RasterFont()
 	// bound uniforms
 	glUniform2f(glGetUniformLocation(s_shader.glprogid, "charSize"), 1.0f / GLfloat(CHARACTER_COUNT),
 		1.0f);
-	uniform_color_id = glGetUniformLocation(s_shader.glprogid, "color");
-	glUniform4f(uniform_color_id, 1.0f, 1.0f, 1.0f, 1.0f);
-	uniform_offset_id = glGetUniformLocation(s_shader.glprogid, "offset");
-	glUniform2f(uniform_offset_id, 0.0f, 0.0f);
 
 	// generate VBO & VAO
 	glGenBuffers(1, &VBO);
@@ -177,10 +175,13 @@ RasterFont::RasterFont()
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBindVertexArray(VAO);
 	glEnableVertexAttribArray(SHADER_POSITION_ATTRIB);
-	glVertexAttribPointer(SHADER_POSITION_ATTRIB, 2, GL_FLOAT, 0, sizeof(GLfloat) * 4, nullptr);
+	glVertexAttribPointer(SHADER_POSITION_ATTRIB, 2, GL_FLOAT, 0, sizeof(Vertex), nullptr);
 	glEnableVertexAttribArray(SHADER_TEXTURE0_ATTRIB);
-	glVertexAttribPointer(SHADER_TEXTURE0_ATTRIB, 2, GL_FLOAT, 0, sizeof(GLfloat) * 4,
+	glVertexAttribPointer(SHADER_TEXTURE0_ATTRIB, 2, GL_FLOAT, 0, sizeof(Vertex),
 		(GLfloat*)nullptr + 2);
+	glEnableVertexAttribArray(SHADER_COLOR0_ATTRIB);
+	glVertexAttribPointer(SHADER_COLOR0_ATTRIB, 4, GL_UNSIGNED_BYTE, 1, sizeof(Vertex),
+		(GLfloat*)nullptr + 4);
 }
 
 RasterFont::~RasterFont()
@@ -191,95 +192,109 @@ RasterFont::~RasterFont()
 	s_shader.Destroy();
 }
 
+// OSD colors are 0xAARRGGBB, the vertex attribute reads the bytes as RGBA
+static u32 ToVertexColor(u32 color)
+{
+	return ((color >> 16) & 0xff) | (color & 0xff00) | ((color & 0xff) << 16) | (color & 0xff000000);
+}
+
 void RasterFont::printMultilineText(const std::string& text, double start_x, double start_y,
 	double z, int bbWidth, int bbHeight, u32 color)
 {
-	std::vector<GLfloat> vertices(text.length() * 6 * 4);
-
-	int usage = 0;
-	GLfloat delta_x = GLfloat(2 * CHARACTER_WIDTH) / GLfloat(bbWidth);
-	GLfloat delta_y = GLfloat(2 * CHARACTER_HEIGHT) / GLfloat(bbHeight);
-	GLfloat border_x = 2.0f / GLfloat(bbWidth);
-	GLfloat border_y = 4.0f / GLfloat(bbHeight);
+	if (m_cached_index == m_cached_texts.size())
+		m_cached_texts.emplace_back();
+	CachedText& cached = m_cached_texts[m_cached_index++];
 
-	GLfloat x = GLfloat(start_x);
-	GLfloat y = GLfloat(start_y);
-
-	for (const char& c : text)
+	if (text != cached.text || start_x != cached.x || start_y != cached.y ||
+		bbWidth != cached.width || bbHeight != cached.height)
 	{
-		if (c == '\n')
-		{
-			x = GLfloat(start_x);
-			y -= delta_y + border_y;
-			continue;
-		}
-
-		// do not print spaces, they can be skipped easily
-		if (c == ' ')
+		cached.text = text;
+		cached.x = start_x;
+		cached.y = start_y;
+		cached.width = bbWidth;
+		cached.height = bbHeight;
+		cached.quads.clear();
+
+		GLfloat delta_x = GLfloat(2 * CHARACTER_WIDTH) / GLfloat(bbWidth);
+		GLfloat delta_y = GLfloat(2 * CHARACTER_HEIGHT) / GLfloat(bbHeight);
+		GLfloat border_x = 2.0f / GLfloat(bbWidth);
+		GLfloat border_y = 4.0f / GLfloat(bbHeight);
+
+		GLfloat x = GLfloat(start_x);
+		GLfloat y = GLfloat(start_y);
+
+		for (const char& c : text)
 		{
-			x += delta_x + border_x;
-			continue;
-		}
+			if (c == '\n')
+			{
+				x = GLfloat(start_x);
+				y -= delta_y + border_y;
+				continue;
+			}
 
-		if (c < CHARACTER_OFFSET || c >= CHARACTER_COUNT + CHARACTER_OFFSET)
-			continue;
+			// do not print spaces, they can be skipped easily
+			if (c == ' ')
+			{
+				x += delta_x + border_x;
+				continue;
+			}
 
-		vertices[usage++] = x;
-		vertices[usage++] = y;
-		vertices[usage++] = GLfloat(c - CHARACTER_OFFSET);
-		vertices[usage++] = 0.0f;
+			if (c < CHARACTER_OFFSET || c >= CHARACTER_COUNT + CHARACTER_OFFSET)
+				continue;
 
-		vertices[usage++] = x + delta_x;
-		vertices[usage++] = y;
-		vertices[usage++] = GLfloat(c - CHARACTER_OFFSET + 1);
-		vertices[usage++] = 0.0f;
+			GLfloat u0 = GLfloat(c - CHARACTER_OFFSET);
+			GLfloat u1 = GLfloat(c - CHARACTER_OFFSET + 1);
+			cached.quads.push_back({ x, y, u0, 0.0f, 0 });
+			cached.quads.push_back({ x + delta_x, y, u1, 0.0f, 0 });
+			cached.quads.push_back({ x + delta_x, y + delta_y, u1, 1.0f, 0 });
+			cached.quads.push_back({ x, y, u0, 0.0f, 0 });
+			cached.quads.push_back({ x + delta_x, y + delta_y, u1, 1.0f, 0 });
+			cached.quads.push_back({ x, y + delta_y, u0, 1.0f, 0 });
 
-		vertices[usage++] = x + delta_x;
-		vertices[usage++] = y + delta_y;
-		vertices[usage++] = GLfloat(c - CHARACTER_OFFSET + 1);
-		vertices[usage++] = 1.0f;
+			x += delta_x + border_x;
+		}
+	}
 
-		vertices[usage++] = x;
-		vertices[usage++] = y;
-		vertices[usage++] = GLfloat(c - CHARACTER_OFFSET);
-		vertices[usage++] = 0.0f;
+	if (cached.quads.empty())
+		return;
 
-		vertices[usage++] = x + delta_x;
-		vertices[usage++] = y + delta_y;
-		vertices[usage++] = GLfloat(c - CHARACTER_OFFSET + 1);
-		vertices[usage++] = 1.0f;
+	AppendQuads(m_shadow_vertices, cached.quads, 2.0f / GLfloat(bbWidth), -2.0f / GLfloat(bbHeight),
+		color & 0xff000000);
+	AppendQuads(m_text_vertices, cached.quads, 0.0f, 0.0f, ToVertexColor(color));
+}
 
-		vertices[usage++] = x;
-		vertices[usage++] = y + delta_y;
-		vertices[usage++] = GLfloat(c - CHARACTER_OFFSET);
-		vertices[usage++] = 1.0f;
+void RasterFont::AppendQuads(std::vector<Vertex>& out, const std::vector<Vertex>& quads,
+	float offset_x, float offset_y, u32 color)
+{
+	out.reserve(out.size() + quads.size());
+	for (const Vertex& vertex : quads)
+		out.push_back({ vertex.x + offset_x, vertex.y + offset_y, vertex.u, vertex.v, color });
+}
 
-		x += delta_x + border_x;
-	}
+void RasterFont::Flush()
+{
+	// Texts that weren't printed this frame are dropped from the cache
+	m_cached_texts.resize(m_cached_index);
+	m_cached_index = 0;
 
-	if (!usage)
-	{
+	if (m_text_vertices.empty())
 		return;
-	}
+
+	m_shadow_vertices.insert(m_shadow_vertices.end(), m_text_vertices.begin(),
+		m_text_vertices.end());
 
 	glActiveTexture(g_ActiveConfig.backend_info.bSupportsBindingLayout ? GL_TEXTURE8 : GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, texture);
 
 	glBindVertexArray(VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, usage * sizeof(GLfloat), vertices.data(), GL_STREAM_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, m_shadow_vertices.size() * sizeof(Vertex),
+		m_shadow_vertices.data(), GL_STREAM_DRAW);
 
 	s_shader.Bind();
+	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_shadow_vertices.size()));
 
-	// shadows
-	glUniform2f(uniform_offset_id, 2.0f / GLfloat(bbWidth), -2.0f / GLfloat(bbHeight));
-	glUniform4f(uniform_color_id, 0.0f, 0.0f, 0.0f, GLfloat((color >> 24) & 0xff) / 255.f);
-	glDrawArrays(GL_TRIANGLES, 0, usage / 4);
-
-	glUniform2f(uniform_offset_id, 0.0f, 0.0f);
-	glUniform4f(uniform_color_id, GLfloat((color >> 16) & 0xff) / 255.f,
-		GLfloat((color >> 8) & 0xff) / 255.f, GLfloat((color >> 0) & 0xff) / 255.f,
-		GLfloat((color >> 24) & 0xff) / 255.f);
-	glDrawArrays(GL_TRIANGLES, 0, usage / 4);
+	m_shadow_vertices.clear();
+	m_text_vertices.clear();
 }
 }
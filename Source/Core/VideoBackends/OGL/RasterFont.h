@@ -5,6 +5,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
@@ -20,11 +21,40 @@ public:
 	void printMultilineText(const std::string& text, double x, double y, double z, int bbWidth,
 		int bbHeight, u32 color);
 
+	// Draws all text queued since the last flush with a single upload and draw call
+	void Flush();
+
 private:
+	struct Vertex
+	{
+		float x, y, u, v;
+		u32 color;
+	};
+
+	static void AppendQuads(std::vector<Vertex>& out, const std::vector<Vertex>& quads,
+		float offset_x, float offset_y, u32 color);
+
 	u32 VBO;
 	u32 VAO;
 	u32 texture;
-	u32 uniform_color_id;
-	u32 uniform_offset_id;
+
+	// Glyph quads of each text printed last frame, in call order. The overlay prints the same
+	// texts in the same order every frame, so they are only rebuilt when the text or its
+	// placement changes.
+	struct CachedText
+	{
+		std::string text;
+		double x = 0.0;
+		double y = 0.0;
+		int width = 0;
+		int height = 0;
+		std::vector<Vertex> quads;
+	};
+	std::vector<CachedText> m_cached_texts;
+	size_t m_cached_index = 0;
+
+	// Shadows are queued separately so they end up underneath all of the text
+	std::vector<Vertex> m_shadow_vertices;
+	std::vector<Vertex> m_text_vertices;
 };
 }
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cmath>
 #include <cstdio>
@@ -24,6 +25,7 @@
 
 #include "VideoBackends/OGL/BoundingBox.h"
 #include "VideoBackends/OGL/FramebufferManager.h"
+#include "VideoBackends/OGL/GPUTimer.h"
 #include "VideoBackends/OGL/PostProcessing.h"
 #include "VideoBackends/OGL/ProgramShaderCache.h"
 #include "VideoBackends/OGL/RasterFont.h"
@@ -36,10 +38,12 @@
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/DriverDetails.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -64,6 +68,31 @@ static bool s_last_xfb_mode = false;
 
 static u32 s_blendMode;
 
+// Shadow copy of the fixed function state set for game draws, so that BP and XF writes which
+// end up with the same GL state don't reach the driver. Bits in s_draw_state_valid mark
+// the entries that match the context.
+static u32 s_draw_state_valid;
+static u32 s_cull_state;
+static u32 s_depth_state;
+static u32 s_color_mask_state;
+static u32 s_logic_op_state;
+static std::array<GLint, 4> s_scissor_state;
+static std::array<float, 6> s_viewport_state;
+
+// Returns true if the state is set already, otherwise records the new value.
+template <typename T>
+static bool IsDrawStateCurrent(u32 flag, T* cached, const T& value)
+{
+	if ((s_draw_state_valid & flag) && *cached == value)
+	{
+		INCSTAT(stats.thisFrame.numSkippedStateChanges);
+		return true;
+	}
+	s_draw_state_valid |= flag;
+	*cached = value;
+	return false;
+}
+
 static bool s_vsync;
 
 // EFB cache related
@@ -490,6 +519,12 @@ Renderer::Renderer()
 	g_ogl_config.bSupportsDebug =
 		GLExtensions::Supports("GL_KHR_debug") || GLExtensions::Supports("GL_ARB_debug_output");
 	g_ogl_config.bSupportsTextureStorage = GLExtensions::Supports("GL_ARB_texture_storage");
+	g_ogl_config.bSupportsTimerQuery = GLExtensions::Supports("GL_ARB_timer_query");
+	g_ogl_config.bSupportsParallelShaderCompile =
+		GLExtensions::Supports("GL_KHR_parallel_shader_compile") ||
+		GLExtensions::Supports("GL_ARB_parallel_shader_compile");
+	// Programs are only built in the background with the driver's compiler threads
+	g_Config.backend_info.bSupportsAsyncShaderCompilation = g_ogl_config.bSupportsParallelShaderCompile;
 	g_ogl_config.bSupports3DTextureStorageMultisample =
 		GLExtensions::Supports("GL_ARB_texture_storage_multisample") ||
 		GLExtensions::Supports("GL_OES_texture_storage_multisample_2d_array");
@@ -499,6 +534,11 @@ Renderer::Renderer()
 	g_ogl_config.bSupportsConservativeDepth = GLExtensions::Supports("GL_ARB_conservative_depth");
 	g_ogl_config.bSupportsAniso = GLExtensions::Supports("GL_EXT_texture_filter_anisotropic");
 	g_Config.backend_info.bSupportsComputeShaders = GLExtensions::Supports("GL_ARB_compute_shader");
+	g_ogl_config.SupportedVSLayerOutput =
+		GLExtensions::Supports("GL_ARB_shader_viewport_layer_array") ?
+		1 :
+		GLExtensions::Supports("GL_AMD_vertex_shader_layer") ? 2 : 0;
+	g_Config.backend_info.bSupportsVSLayerOutput = g_ogl_config.SupportedVSLayerOutput > 0;
 
 	if (GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGLES3)
 	{
@@ -653,6 +693,12 @@ Renderer::Renderer()
 		g_Config.backend_info.bSupportsPaletteConversion &&
 		g_Config.backend_info.bSupportsComputeShaders && g_ogl_config.bSupportsImageLoadStore;
 
+	// EFB copies can be encoded by a compute shader writing to a storage buffer, which needs the
+	// buffer binding to be set in the shader.
+	g_Config.backend_info.bSupportsComputeTextureEncoding =
+		g_Config.backend_info.bSupportsComputeShaders && g_Config.backend_info.bSupportsBBox &&
+		g_Config.backend_info.bSupportsBindingLayout;
+
 	if (g_ogl_config.bSupportsDebug)
 	{
 		if (GLExtensions::Supports("GL_KHR_debug"))
@@ -744,6 +790,13 @@ Renderer::~Renderer()
 	FlushFrameDump();
 	FinishFrameData();
 	DestroyFrameDumpResources();
+
+	if (m_frame_time_queries[0] != 0)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		glDeleteQueries(static_cast<GLsizei>(m_frame_time_queries.size()),
+			m_frame_time_queries.data());
+	}
 }
 
 void Renderer::Shutdown()
@@ -802,6 +855,13 @@ void Renderer::Init()
 		glEnable(GL_DEPTH_CLAMP);
 	}
 
+	// Frame timing only feeds dynamic resolution, the first query covers the first frame.
+	if (g_ogl_config.bSupportsTimerQuery)
+	{
+		glGenQueries(static_cast<GLsizei>(m_frame_time_queries.size()), m_frame_time_queries.data());
+		glBeginQuery(GL_TIME_ELAPSED, m_frame_time_queries[0]);
+	}
+
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);  // 4-byte pixel alignment
 
 	glDisable(GL_STENCIL_TEST);
@@ -847,7 +907,10 @@ void Renderer::_SetScissorRect()
 {
 	m_bScissorRectChanged = false;
 	TargetRectangle targetrc = ConvertEFBRectangle(m_ScissorRect);
-	glScissor(targetrc.left, targetrc.bottom, targetrc.GetWidth(), targetrc.GetHeight());
+	const std::array<GLint, 4> scissor = { { targetrc.left, targetrc.bottom, targetrc.GetWidth(), targetrc.GetHeight() } };
+	if (IsDrawStateCurrent(DRAW_STATE_SCISSOR, &s_scissor_state, scissor))
+		return;
+	glScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
 }
 
 void Renderer::SetScissorRect(const EFBRectangle& trc)
@@ -868,6 +931,8 @@ void Renderer::_SetColorMask()
 		if (bpmem.blendmode.alphaupdate && (bpmem.zcontrol.pixel_format == PEControl::RGBA6_Z24))
 			AlphaMask = GL_TRUE;
 	}
+	if (IsDrawStateCurrent(DRAW_STATE_COLOR_MASK, &s_color_mask_state, u32(ColorMask | (AlphaMask << 1))))
+		return;
 	glColorMask(ColorMask, ColorMask, ColorMask, AlphaMask);
 }
 
@@ -878,6 +943,8 @@ void Renderer::SetColorMask()
 
 void ClearEFBCache()
 {
+	// Every EFB write invalidates the peek cache, so the resolved copy goes with it
+	FramebufferManager::InvalidateResolvedEFB();
 	if (!s_efbCacheIsCleared)
 	{
 		s_efbCacheIsCleared = true;
@@ -1175,6 +1242,12 @@ void Renderer::_SetViewport()
 	}
 	if (m_bViewPortChanged)
 	{
+		m_bViewPortChanged = false;
+		const std::array<float, 6> viewport = { { m_viewport.X, m_viewport.Y, m_viewport.Width,
+			m_viewport.Height, m_viewport.NearZ, m_viewport.FarZ } };
+		if (IsDrawStateCurrent(DRAW_STATE_VIEWPORT, &s_viewport_state, viewport))
+			return;
+
 		// Update the view port
 		if (g_ogl_config.bSupportViewportFloat)
 		{
@@ -1191,7 +1264,6 @@ void Renderer::_SetViewport()
 		// value supported by the console GPU. If not, we simply clamp the near/far values
 		// themselves to the maximum value as done above.
 		glDepthRangef(m_viewport.FarZ, m_viewport.NearZ);
-		m_bViewPortChanged = false;
 	}
 }
 
@@ -1235,6 +1307,7 @@ void Renderer::ClearScreen(const EFBRectangle& rc, bool colorEnable, bool alphaE
 
 void Renderer::BlitScreen(const TargetRectangle& dst_rect, const TargetRectangle& src_rect, const TargetSize& src_size, GLuint src_texture, GLuint src_depth_texture, const TargetSize& dst_size, GLuint dst_texture, float gamma)
 {
+	FrameProfiler::ScopedPass post_processing_pass(FrameProfiler::PASS_POST_PROCESSING);
 	if (g_ActiveConfig.iStereoMode == STEREO_SBS || g_ActiveConfig.iStereoMode == STEREO_TAB)
 	{
 		TargetRectangle leftRc, rightRc;
@@ -1538,6 +1611,7 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
 	// Do our OSD callbacks
 	OSD::DoCallbacks(OSD::CallbackType::OnFrame);
 	OSD::DrawMessages();
+	s_raster_font->Flush();
 
 #ifdef ANDROID
 	if (s_surface_needs_change.IsSet())
@@ -1574,6 +1648,7 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
 
 	g_Config.iSaveTargetId = 0;
 
+	UpdateFrameTimeQueries();
 	UpdateActiveConfig();
 	g_texture_cache->OnConfigChanged(g_ActiveConfig);
 
@@ -1590,6 +1665,34 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
 		m_post_processor->ReloadShaders();
 }
 
+void Renderer::UpdateFrameTimeQueries()
+{
+	if (m_frame_time_queries[0] == 0)
+		return;
+
+	// This spans the GPU timeline between two swaps, so it includes the time the GPU sat idle
+	// waiting for us. That only makes it overestimate the load when we are CPU bound.
+	glEndQuery(GL_TIME_ELAPSED);
+	m_frame_time_query_pending[m_frame_time_query_index] = true;
+	m_frame_time_query_index = (m_frame_time_query_index + 1) % m_frame_time_queries.size();
+
+	// Reuse the oldest query, its frame has usually completed by now. Never stall for it.
+	const GLuint query = m_frame_time_queries[m_frame_time_query_index];
+	if (m_frame_time_query_pending[m_frame_time_query_index])
+	{
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available)
+		{
+			GLuint elapsed_ns = 0;
+			glGetQueryObjectuiv(query, GL_QUERY_RESULT, &elapsed_ns);
+			OnGPUFrameTime(elapsed_ns / 1000000.0);
+		}
+		m_frame_time_query_pending[m_frame_time_query_index] = false;
+	}
+	glBeginQuery(GL_TIME_ELAPSED, query);
+}
+
 void Renderer::DrawFrame(const TargetRectangle& target_rc, const EFBRectangle& source_rc, u32 xfb_addr,
 	const XFBSourceBase* const* xfb_sources, u32 xfb_count, GLuint dst_texture, const TargetSize& dst_size, u32 fb_width,
 	u32 fb_stride, u32 fb_height, float Gamma)
@@ -1627,6 +1730,7 @@ void Renderer::DrawEFB(const TargetRectangle& t_rc, const EFBRectangle& source_r
 			depth_tex = FramebufferManager::ResolveAndGetDepthTarget(source_rc);
 
 		uintptr_t new_blit_tex;
+		FrameProfiler::ScopedPass post_processing_pass(FrameProfiler::PASS_POST_PROCESSING);
 		m_post_processor->PostProcess(&scaled_source_rc, &tex_size, &new_blit_tex, src_rect, src_size, tex, src_rect, src_size, depth_tex);
 		tex = static_cast<GLuint>(new_blit_tex);
 	}
@@ -1715,7 +1819,6 @@ void Renderer::FlushFrameDump()
 	if (!m_last_frame_exported)
 		return;
 
-	FinishFrameData();
 	glBindBuffer(GL_PIXEL_PACK_BUFFER, m_frame_dumping_pbo[0]);
 	m_frame_pbo_is_mapped[0] = true;
 	void* data = glMapBufferRange(
@@ -1918,6 +2021,7 @@ void Renderer::RestoreAPIState()
 	m_bViewPortChanged = true;
 	m_bBlendModeForce = true;
 	m_bBlendModeChanged = true;
+	s_draw_state_valid = 0;
 	const VertexManager* const vm = static_cast<VertexManager*>(g_vertex_manager.get());
 	glBindBuffer(GL_ARRAY_BUFFER, vm->m_vertex_buffers);
 	if (vm->m_last_vao)
@@ -1926,9 +2030,16 @@ void Renderer::RestoreAPIState()
 	TextureCache::SetStage();
 }
 
+void Renderer::InvalidateDrawState(u32 flags)
+{
+	s_draw_state_valid &= ~flags;
+}
+
 void Renderer::_SetGenerationMode()
 {
 	m_bGenerationModeChanged = false;
+	if (IsDrawStateCurrent(DRAW_STATE_CULL, &s_cull_state, u32(bpmem.genMode.cullmode)))
+		return;
 	// none, ccw, cw, ccw
 	if (bpmem.genMode.cullmode > 0)
 	{
@@ -1962,6 +2073,11 @@ void Renderer::_SetDepthMode()
 		GL_ALWAYS
 	};
 
+	const u32 depth_state = bpmem.zmode.testenable ?
+		(1 | (bpmem.zmode.updateenable << 1) | (bpmem.zmode.func << 2)) : 0;
+	if (IsDrawStateCurrent(DRAW_STATE_DEPTH, &s_depth_state, depth_state))
+		return;
+
 	if (bpmem.zmode.testenable)
 	{
 		glEnable(GL_DEPTH_TEST);
@@ -1985,6 +2101,15 @@ void Renderer::SetDepthMode()
 
 void Renderer::_SetLogicOpMode()
 {
+	if (GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGL)
+	{
+		// The GLES emulation below goes through the blend state, only glLogicOp is shadowed.
+		const bool enable = bpmem.blendmode.logicopenable && !bpmem.blendmode.blendenable &&
+			bpmem.blendmode.logicmode != BlendMode::LogicOp::COPY;
+		const u32 logic_op_state = enable ? (1 | (bpmem.blendmode.logicmode << 1)) : 0;
+		if (IsDrawStateCurrent(DRAW_STATE_LOGIC_OP, &s_logic_op_state, logic_op_state))
+			return;
+	}
 	if (bpmem.blendmode.logicopenable && !bpmem.blendmode.blendenable)
 	{
 		if (GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGL)
@@ -49,6 +49,7 @@ struct VideoConfig
 	bool bSupportsDebug;
 	bool bSupportsCopySubImage;
 	u8 SupportedESPointSize;
+	u8 SupportedVSLayerOutput;
 	ES_TEXBUF_TYPE SupportedESTextureBuffer;
 	bool bSupportsTextureStorage;
 	bool bSupports2DTextureStorageMultisample;
@@ -56,6 +57,8 @@ struct VideoConfig
 	bool bSupportsConservativeDepth;
 	bool bSupportsImageLoadStore;
 	bool bSupportsAniso;
+	bool bSupportsTimerQuery;
+	bool bSupportsParallelShaderCompile;
 
 	const char* gl_vendor;
 	const char* gl_renderer;
@@ -99,6 +102,20 @@ public:
 	void ResetAPIState() override;
 	void RestoreAPIState() override;
 
+	enum DrawStateFlags : u32
+	{
+		DRAW_STATE_CULL = 1 << 0,
+		DRAW_STATE_DEPTH = 1 << 1,
+		DRAW_STATE_COLOR_MASK = 1 << 2,
+		DRAW_STATE_LOGIC_OP = 1 << 3,
+		DRAW_STATE_SCISSOR = 1 << 4,
+		DRAW_STATE_VIEWPORT = 1 << 5,
+		DRAW_STATE_ALL = (1 << 6) - 1
+	};
+	// Code changing these GL states directly in between game draws has to drop them from the
+	// shadow copy, everything between ResetAPIState and RestoreAPIState is covered already.
+	void InvalidateDrawState(u32 flags);
+
 	TargetRectangle ConvertEFBRectangle(const EFBRectangle& rc) override;
 
 	void SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc, u64 ticks,
@@ -112,6 +129,8 @@ public:
 	void ChangeSurface(void* new_surface_handle) override;
 
 private:
+	void UpdateFrameTimeQueries();
+
 	struct ViewPort {
 		float       X;
 		float       Y;
@@ -168,6 +187,12 @@ private:
 	u32 m_frame_dump_render_texture_height = 0;
 
 	// avi dumping state to delay one frame
+	// GL_TIME_ELAPSED queries spanning one swap to the next, read back a few frames later.
+	static const size_t NUM_FRAME_TIME_QUERIES = 4;
+	std::array<GLuint, NUM_FRAME_TIME_QUERIES> m_frame_time_queries = {};
+	std::array<bool, NUM_FRAME_TIME_QUERIES> m_frame_time_query_pending = {};
+	size_t m_frame_time_query_index = 0;
+
 	std::array<u32, 2> m_frame_dumping_pbo = {};
 	std::array<bool, 2> m_frame_pbo_is_mapped = {};
 	std::array<int, 2> m_last_frame_width = {};
@@ -4,6 +4,7 @@
 
 #include "Common/Align.h"
 #include "Common/MemoryUtil.h"
+#include "Common/Timer.h"
 #include "Common/GL/GLUtil.h"
 
 #include "VideoBackends/OGL/Render.h"
@@ -11,6 +12,7 @@
 
 #include "VideoCommon/DriverDetails.h"
 #include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/Statistics.h"
 
 namespace OGL
 {
@@ -103,7 +105,7 @@ void StreamBuffer::AllocMemory(u32 size)
 		// insert waiting slots in unused space at the end of the buffer
 		for (int i = Slot(m_used_iterator); i < SYNC_POINTS; i++)
 		{
-			if (!m_fences[i])
+			if (m_fences[i])
 			{
 				glDeleteSync(m_fences[i]);
 			}
@@ -121,7 +123,15 @@ void StreamBuffer::AllocMemory(u32 size)
 	{
 		if (m_fences[i])
 		{
-			glClientWaitSync(m_fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			// Only a fence the GPU hasn't passed yet is a stall worth reporting
+			if (glClientWaitSync(m_fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+			{
+				u64 start = Common::Timer::GetTimeUs();
+				glClientWaitSync(m_fences[i], 0, GL_TIMEOUT_IGNORED);
+				INCSTAT(stats.thisFrame.numStreamBufferStalls);
+				ADDSTAT(stats.thisFrame.streamBufferStallMicroseconds,
+					static_cast<int>(Common::Timer::GetTimeUs() - start));
+			}
 			glDeleteSync(m_fences[i]);
 			m_fences[i] = 0;
 		}
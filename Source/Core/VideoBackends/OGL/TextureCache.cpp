@@ -37,6 +37,7 @@
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/TextureScalerCommon.h"
+#include "VideoCommon/TextureScalerShader.h"
 #include "VideoCommon/VideoConfig.h"
 
 #define 	GL_COMPRESSED_RGB_S3TC_DXT1_EXT   0x83F0
@@ -86,6 +87,21 @@ struct TextureDecodingProgramInfo
 static std::map<std::pair<u32, u32>, TextureDecodingProgramInfo> s_texture_decoding_program_info;
 static std::array<GLuint, TextureConversionShader::BUFFER_FORMAT_COUNT>
 s_texture_decoding_buffer_views;
+
+struct TextureScalingProgramInfo
+{
+	SHADER program;
+	GLint uniform_src_size = -1;
+	bool valid = false;
+};
+
+// Keyed by scaling type and factor.
+static std::map<std::pair<int, int>, TextureScalingProgramInfo> s_texture_scaling_program_info;
+// The decoded texture is uploaded here to be read by the scaling shaders. Larger textures fall
+// back to the CPU scaler.
+static const u32 TEXTURE_SCALING_SOURCE_SIZE = 512;
+static GLuint s_texture_scaling_source = 0;
+
 static void CreateTextureDecodingResources();
 static void DestroyTextureDecodingResources();
 
@@ -108,7 +124,7 @@ bool SaveTexture(const std::string& filename, u32 textarget, u32 tex, int virtua
 	else
 	{
 		glGetTexImage(textarget, level, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
-		saved = TextureToPng(data.data(), width * 4, filename, width, height);
+		saved = TextureToPngAsync(data.data(), width * 4, filename, width, height);
 	}
 	TextureCache::SetStage();
 	return saved;
@@ -550,6 +566,14 @@ void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_widt
 		memory_stride, is_depth_copy, src_rect, scale_by_half);
 }
 
+std::unique_ptr<EFBCopyReadback> TextureCache::QueueEFBCopy(const EFBCopyFormat& format,
+	u32 native_width, u32 bytes_per_row, u32 num_blocks_y, bool is_depth_copy,
+	const EFBRectangle& src_rect, bool scale_by_half)
+{
+	return TextureConverter::QueueEncodeToRamFromTexture(format, native_width, bytes_per_row,
+		num_blocks_y, is_depth_copy, src_rect, scale_by_half);
+}
+
 bool TextureCache::Palettize(TCacheEntryBase* src_entry, const TCacheEntryBase* base_entry)
 {
 	TextureCache::TCacheEntry* entry = (TextureCache::TCacheEntry*)src_entry;
@@ -831,6 +855,7 @@ void TextureCache::DeleteShaders()
 
 TextureCache::~TextureCache()
 {
+	FlushEFBCopies();
 	DeleteShaders();
 	DestroyTextureDecodingResources();
 	if (g_ActiveConfig.backend_info.bSupportsPaletteConversion)
@@ -906,6 +931,15 @@ void DestroyTextureDecodingResources()
 		s_texture_decoding_buffer_views.data());
 	s_texture_decoding_buffer_views.fill(0);
 	s_texture_decoding_program_info.clear();
+
+	for (auto& it : s_texture_scaling_program_info)
+		it.second.program.Destroy();
+	s_texture_scaling_program_info.clear();
+	if (s_texture_scaling_source)
+	{
+		glDeleteTextures(1, &s_texture_scaling_source);
+		s_texture_scaling_source = 0;
+	}
 }
 
 bool TextureCache::SupportsGPUTextureDecode(TextureFormat format, TlutFormat palette_format)
@@ -952,6 +986,11 @@ bool TextureCache::TCacheEntry::DecodeTextureOnGPU(u32 dst_level, const u8* data
 	u32 aligned_width, u32 aligned_height, u32 row_stride,
 	const u8* palette, TlutFormat palette_format)
 {
+	// The decoder writes straight into the entry, scaled textures are decoded on the CPU and
+	// handed to ScaleTextureOnGPU instead.
+	if (is_scaled)
+		return false;
+
 	auto key = std::make_pair(static_cast<u32>(format), static_cast<u32>(palette_format));
 	auto iter = s_texture_decoding_program_info.find(key);
 	if (iter == s_texture_decoding_program_info.end())
@@ -1029,4 +1068,74 @@ bool TextureCache::TCacheEntry::DecodeTextureOnGPU(u32 dst_level, const u8* data
 	return true;
 }
 
+bool TextureCache::SupportsGPUTextureScaling(int scaling_type, int factor)
+{
+	if (!g_ActiveConfig.backend_info.bSupportsGPUTextureDecoding ||
+		!g_ogl_config.bSupportsTextureStorage)
+	{
+		return false;
+	}
+
+	auto key = std::make_pair(scaling_type, factor);
+	auto iter = s_texture_scaling_program_info.find(key);
+	if (iter != s_texture_scaling_program_info.end())
+		return iter->second.valid;
+
+	TextureScalingProgramInfo info;
+	std::string shader_source =
+		TextureScalerShader::GenerateScalingShader(scaling_type, factor, API_OPENGL);
+	if (shader_source.empty() || !ProgramShaderCache::CompileComputeShader(info.program, shader_source))
+	{
+		s_texture_scaling_program_info.emplace(key, info);
+		return false;
+	}
+
+	info.uniform_src_size = glGetUniformLocation(info.program.glprogid, "u_src_size");
+	info.valid = true;
+	s_texture_scaling_program_info.emplace(key, info);
+	return true;
+}
+
+bool TextureCache::TCacheEntry::ScaleTextureOnGPU(u32 dst_level, const u8* data, u32 width,
+	u32 height, u32 expanded_width)
+{
+	auto iter = s_texture_scaling_program_info.find(
+		std::make_pair(g_ActiveConfig.iTexScalingType, g_ActiveConfig.iTexScalingFactor));
+	if (iter == s_texture_scaling_program_info.end() || !iter->second.valid ||
+		expanded_width > TEXTURE_SCALING_SOURCE_SIZE || height > TEXTURE_SCALING_SOURCE_SIZE)
+	{
+		return false;
+	}
+
+	glActiveTexture(GL_TEXTURE9);
+	if (!s_texture_scaling_source)
+	{
+		glGenTextures(1, &s_texture_scaling_source);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, s_texture_scaling_source);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, TEXTURE_SCALING_SOURCE_SIZE,
+			TEXTURE_SCALING_SOURCE_SIZE, 1);
+	}
+	else
+	{
+		glBindTexture(GL_TEXTURE_2D_ARRAY, s_texture_scaling_source);
+	}
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, expanded_width, height, 1, GL_RGBA,
+		GL_UNSIGNED_BYTE, data);
+
+	// The scaler sees the whole expanded width like the CPU one, the texels past the entry's
+	// width are dropped by the image store.
+	iter->second.program.Bind();
+	if (iter->second.uniform_src_size >= 0)
+		glUniform2ui(iter->second.uniform_src_size, expanded_width, height);
+
+	auto dispatch_groups = TextureScalerShader::GetDispatchCount(expanded_width, height);
+	glBindImageTexture(0, texture, dst_level, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA8);
+	glDispatchCompute(dispatch_groups.first, dispatch_groups.second, 1);
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+	TextureCache::SetStage();
+	return true;
+}
+
 }
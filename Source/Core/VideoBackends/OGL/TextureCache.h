@@ -57,6 +57,8 @@ private:
 			u32 data_size, TextureFormat format, u32 width, u32 height,
 			u32 aligned_width, u32 aligned_height, u32 row_stride,
 			const u8* palette, TlutFormat palette_format) override;
+		bool ScaleTextureOnGPU(u32 dst_level, const u8* data, u32 width, u32 height,
+			u32 expanded_width) override;
 		bool SupportsMaterialMap() const override
 		{
 			return nrm_texture != 0;
@@ -76,11 +78,15 @@ private:
 	void CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
 		u32 num_blocks_y, u32 memory_stride, bool is_depth_copy,
 		const EFBRectangle& src_rect, bool scale_by_half) override;
+	std::unique_ptr<EFBCopyReadback> QueueEFBCopy(const EFBCopyFormat& format, u32 native_width,
+		u32 bytes_per_row, u32 num_blocks_y, bool is_depth_copy, const EFBRectangle& src_rect,
+		bool scale_by_half) override;
 	bool Palettize(TCacheEntryBase* entry, const TCacheEntryBase* base_entry) override;
 	void LoadLut(u32 lutFmt, void* addr, u32 size) override;
 	bool CompileShaders() override;
 	void DeleteShaders() override;
 	bool SupportsGPUTextureDecode(TextureFormat format, TlutFormat palette_format) override;
+	bool SupportsGPUTextureScaling(int scaling_type, int factor) override;
 	void* m_last_addr = {};
 	u32 m_last_size = {};
 	u64 m_last_hash = {};
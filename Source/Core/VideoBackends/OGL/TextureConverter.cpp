@@ -4,6 +4,7 @@
 
 // Fast image conversion using OpenGL shaders.
 
+#include <memory>
 #include <string>
 
 #include "Common/Common.h"
@@ -49,8 +50,10 @@ struct EncodingProgram
 {
 	SHADER program;
 	GLint copy_position_uniform;
+	GLint encoded_size_uniform;
 };
 static std::map<EFBCopyFormat, EncodingProgram> s_encoding_programs;
+static std::map<EFBCopyFormat, EncodingProgram> s_encoding_compute_programs;
 
 static GLuint s_PBO = 0; // for readback with different strides
 
@@ -166,9 +169,33 @@ static EncodingProgram& GetOrCreateEncodingShader(const EFBCopyFormat& format)
 		PanicAlert("Failed to compile texture encoding shader.");
 
 	program.copy_position_uniform = glGetUniformLocation(program.program.glprogid, "position");
+	program.encoded_size_uniform = -1;
 	return s_encoding_programs.emplace(format, program).first->second;
 }
 
+static bool UseComputeEncoding()
+{
+	return g_ActiveConfig.backend_info.bSupportsComputeTextureEncoding &&
+		g_ActiveConfig.bEnableComputeTextureEncoding;
+}
+
+static EncodingProgram& GetOrCreateEncodingComputeShader(const EFBCopyFormat& format)
+{
+	auto iter = s_encoding_compute_programs.find(format);
+	if (iter != s_encoding_compute_programs.end())
+		return iter->second;
+
+	const char* shader = TextureConversionShader::GenerateEncodingComputeShader(format);
+
+	EncodingProgram program;
+	if (!ProgramShaderCache::CompileComputeShader(program.program, shader))
+		PanicAlert("Failed to compile texture encoding compute shader.");
+
+	program.copy_position_uniform = glGetUniformLocation(program.program.glprogid, "position");
+	program.encoded_size_uniform = glGetUniformLocation(program.program.glprogid, "encoded_size");
+	return s_encoding_compute_programs.emplace(format, program).first->second;
+}
+
 void Init()
 {
 	glGenFramebuffers(2, s_texConvFrameBuffer);
@@ -208,6 +235,9 @@ void Shutdown()
 	for (auto& program : s_encoding_programs)
 		program.second.program.Destroy();
 	s_encoding_programs.clear();
+	for (auto& program : s_encoding_compute_programs)
+		program.second.program.Destroy();
+	s_encoding_compute_programs.clear();
 
 	s_srcTexture = 0;
 	s_dstTexture = 0;
@@ -216,10 +246,56 @@ void Shutdown()
 	s_texConvFrameBuffer[1] = 0;
 }
 
-// dst_line_size, writeStride in bytes
-static void EncodeToRamUsingShader(GLuint srcTexture,
-	u8* destAddr, u32 dst_line_size, u32 dstHeight,
-	u32 writeStride, bool linearFilter)
+// Keeps the encoded copy in its own buffer until the texture cache asks for it.
+class PBOReadback final : public EFBCopyReadback
+{
+public:
+	PBOReadback(GLuint pbo, u32 line_size, u32 height)
+		: m_pbo(pbo), m_line_size(line_size), m_height(height)
+	{
+	}
+	~PBOReadback()
+	{
+		glDeleteBuffers(1, &m_pbo);
+	}
+	void ReadToRAM(u8* dst, u32 memory_stride) override;
+
+private:
+	GLuint m_pbo;
+	u32 m_line_size;
+	u32 m_height;
+};
+
+static void CopyFromPBO(u8* destAddr, u32 dst_line_size, u32 dstHeight, u32 writeStride)
+{
+	u32 dstSize = dst_line_size * dstHeight;
+	u8* pbo = (u8*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, dstSize, GL_MAP_READ_BIT);
+	if (dst_line_size == writeStride)
+	{
+		memcpy(destAddr, pbo, dstSize);
+	}
+	else
+	{
+		for (u32 i = 0; i < dstHeight; i++)
+		{
+			memcpy(destAddr, pbo, dst_line_size);
+			pbo += dst_line_size;
+			destAddr += writeStride;
+		}
+	}
+	glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+}
+
+void PBOReadback::ReadToRAM(u8* dst, u32 memory_stride)
+{
+	// Mapping waits for the readback to finish
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo);
+	CopyFromPBO(dst, m_line_size, m_height, memory_stride);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// dst_line_size in bytes
+static void DrawEncoding(GLuint srcTexture, u32 dst_line_size, u32 dstHeight, bool linearFilter)
 {
 	u32 dstWidth = (dst_line_size / 4);
 	// switch to texture converter frame buffer
@@ -240,55 +316,123 @@ static void EncodeToRamUsingShader(GLuint srcTexture,
 	glViewport(0, 0, (GLsizei)dstWidth, (GLsizei)dstHeight);
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
 
-	// .. and then read back the results.
-	int dstSize = dst_line_size * dstHeight;
+// dst_line_size, writeStride in bytes
+static void EncodeToRamUsingShader(GLuint srcTexture,
+	u8* destAddr, u32 dst_line_size, u32 dstHeight,
+	u32 writeStride, bool linearFilter)
+{
+	u32 dstWidth = (dst_line_size / 4);
+	DrawEncoding(srcTexture, dst_line_size, dstHeight, linearFilter);
 
+	// .. and then read back the results.
 	// When the dst_line_size and writeStride are the same, we could use glReadPixels directly to RAM.
 	// But instead we always copy the data via a PBO, because macOS inexplicably prefers this for some
 	// reason.
 	glBindBuffer(GL_PIXEL_PACK_BUFFER, s_PBO);
 	glReadPixels(0, 0, (GLsizei)dstWidth, (GLsizei)dstHeight, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
-	u8* pbo = (u8*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, dstSize, GL_MAP_READ_BIT);
-	if (dst_line_size == writeStride)
-	{
-		memcpy(destAddr, pbo, dstSize);
-	}
-	else
-	{
-		for (u32 i = 0; i < dstHeight; i++)
-		{
-			memcpy(destAddr, pbo, dst_line_size);
-			pbo += dst_line_size;
-			destAddr += writeStride;
-		}
-	}
-	glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	CopyFromPBO(destAddr, dst_line_size, dstHeight, writeStride);
 	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
-void EncodeToRamFromTexture(u8* dest_ptr, const EFBCopyFormat& format, u32 native_width,
-	u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
-	bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+// Runs the compute encoder, which writes the copy in its final memory layout straight into
+// buffer, so there is no render target to read back. buffer must hold dst_line_size * dstHeight.
+static void DispatchEncoding(GLuint srcTexture, const EncodingProgram& program, GLuint buffer,
+	u32 dst_line_size, u32 dstHeight, bool linearFilter)
 {
-	g_renderer->ResetAPIState();
+	u32 dstWidth = (dst_line_size / 4);
+
+	glActiveTexture(GL_TEXTURE9);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, srcTexture);
+	if (linearFilter || g_ActiveConfig.iEFBScale != SCALE_1X)
+		g_sampler_cache->BindLinearSampler(9);
+	else
+		g_sampler_cache->BindNearestSampler(9);
 
-	EncodingProgram& texconv_shader = GetOrCreateEncodingShader(format);
+	glUniform2i(program.encoded_size_uniform, dstWidth, dstHeight);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffer);
+	glDispatchCompute((dstWidth + 7) / 8, (dstHeight + 7) / 8, 1);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+
+	// Make the writes visible to the mapping of the buffer
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+static GLuint BindEncodingSource(const EFBCopyFormat& format, u32 native_width,
+	bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+{
+	EncodingProgram& texconv_shader = UseComputeEncoding() ?
+		GetOrCreateEncodingComputeShader(format) :
+		GetOrCreateEncodingShader(format);
 
 	texconv_shader.program.Bind();
 	glUniform4i(texconv_shader.copy_position_uniform, src_rect.left, src_rect.top, native_width,
 		scale_by_half ? 2 : 1);
 
-	const GLuint read_texture = is_depth_copy ?
+	return is_depth_copy ?
 		FramebufferManager::ResolveAndGetDepthTarget(src_rect) :
 		FramebufferManager::ResolveAndGetRenderTarget(src_rect);
+}
+
+void EncodeToRamFromTexture(u8* dest_ptr, const EFBCopyFormat& format, u32 native_width,
+	u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
+	bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+{
+	g_renderer->ResetAPIState();
+
+	const GLuint read_texture = BindEncodingSource(format, native_width, is_depth_copy, src_rect,
+		scale_by_half);
+	if (UseComputeEncoding())
+	{
+		DispatchEncoding(read_texture, GetOrCreateEncodingComputeShader(format), s_PBO,
+			bytes_per_row, num_blocks_y, scale_by_half && !is_depth_copy);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, s_PBO);
+		CopyFromPBO(dest_ptr, bytes_per_row, num_blocks_y, memory_stride);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+	else
+	{
+		EncodeToRamUsingShader(read_texture,
+			dest_ptr, bytes_per_row, num_blocks_y,
+			memory_stride, scale_by_half && !is_depth_copy);
+	}
 
-	EncodeToRamUsingShader(read_texture,
-		dest_ptr, bytes_per_row, num_blocks_y,
-		memory_stride, scale_by_half && !is_depth_copy);
+	FramebufferManager::SetFramebuffer(0);
+	g_renderer->RestoreAPIState();
+}
+
+std::unique_ptr<EFBCopyReadback> QueueEncodeToRamFromTexture(const EFBCopyFormat& format,
+	u32 native_width, u32 bytes_per_row, u32 num_blocks_y,
+	bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+{
+	g_renderer->ResetAPIState();
+
+	const GLuint read_texture = BindEncodingSource(format, native_width, is_depth_copy, src_rect,
+		scale_by_half);
+
+	// The read into the buffer runs asynchronously, only mapping it waits.
+	GLuint pbo;
+	glGenBuffers(1, &pbo);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+	glBufferData(GL_PIXEL_PACK_BUFFER, bytes_per_row * num_blocks_y, nullptr, GL_STREAM_READ);
+	if (UseComputeEncoding())
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		DispatchEncoding(read_texture, GetOrCreateEncodingComputeShader(format), pbo,
+			bytes_per_row, num_blocks_y, scale_by_half && !is_depth_copy);
+	}
+	else
+	{
+		DrawEncoding(read_texture, bytes_per_row, num_blocks_y, scale_by_half && !is_depth_copy);
+		glReadPixels(0, 0, (GLsizei)(bytes_per_row / 4), (GLsizei)num_blocks_y, GL_BGRA,
+			GL_UNSIGNED_BYTE, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
 
 	FramebufferManager::SetFramebuffer(0);
 	g_renderer->RestoreAPIState();
+	return std::make_unique<PBOReadback>(pbo, bytes_per_row, num_blocks_y);
 }
 
 void EncodeToRamYUYV(GLuint srcTexture, const TargetRectangle& sourceRc, u8* destAddr, u32 dstWidth, u32 dstStride, u32 dstHeight)
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "Common/GL/GLUtil.h"
 
 #include "VideoCommon/TextureCacheBase.h"
@@ -30,6 +32,11 @@ void EncodeToRamFromTexture(u8* dest_ptr, const EFBCopyFormat& format, u32 nativ
 	u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
 	bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half);
 
+// Encodes like EncodeToRamFromTexture, the returned readback writes the result to RAM.
+std::unique_ptr<EFBCopyReadback> QueueEncodeToRamFromTexture(const EFBCopyFormat& format,
+	u32 native_width, u32 bytes_per_row, u32 num_blocks_y,
+	bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half);
+
 }
 
 }  // namespace OGL
@@ -91,9 +91,18 @@ void VertexManager::Draw(u32 stride)
 	if (cull_changed)
 	{
 		glDisable(GL_CULL_FACE);
+		static_cast<Renderer*>(g_renderer.get())->InvalidateDrawState(Renderer::DRAW_STATE_CULL);
 	}
 
-	if (g_ogl_config.bSupportsGLBaseVertex)
+	if (g_ActiveConfig.VertexShaderStereoEnabled())
+	{
+		// One instance per eye, the vertex shader picks the layer
+		if (g_ogl_config.bSupportsGLBaseVertex)
+			glDrawElementsInstancedBaseVertex(primitive_mode, index_size, GL_UNSIGNED_SHORT, (u8*)nullptr + m_index_offset, 2, (GLint)m_baseVertex);
+		else
+			glDrawElementsInstanced(primitive_mode, index_size, GL_UNSIGNED_SHORT, (u8*)nullptr + m_index_offset, 2);
+	}
+	else if (g_ogl_config.bSupportsGLBaseVertex)
 	{
 		glDrawRangeElementsBaseVertex(primitive_mode, 0, max_index, index_size, GL_UNSIGNED_SHORT, (u8*)nullptr + m_index_offset, (GLint)m_baseVertex);
 	}
@@ -114,19 +123,28 @@ void VertexManager::PrepareShaders(PrimitiveType primitive, u32 components, cons
 		bpm.zcontrol.pixel_format == PEControl::RGBA6_Z24;
 	// Makes sure we can actually do Dual source blending
 	bool dualSourcePossible = g_ActiveConfig.backend_info.bSupportsDualSourceBlend;
+	// Requests from the predictive fifo only compile the program for the given
+	// state, the current one is still picked by the draw itself.
+	auto set_shader = [&](PIXEL_SHADER_RENDER_MODE render_mode)
+	{
+		if (ongputhread)
+			ProgramShaderCache::SetShader(render_mode, VertexLoaderManager::g_current_components, m_current_primitive_type);
+		else
+			ProgramShaderCache::PrepareShader(render_mode, components, primitive, xfr, bpm);
+	};
 	// If host supports GL_ARB_blend_func_extended, we can do dst alpha in
 	// the same pass as regular rendering.
 	if (useDstAlpha && dualSourcePossible)
 	{
-		ProgramShaderCache::SetShader(PSRM_DUAL_SOURCE_BLEND, VertexLoaderManager::g_current_components, m_current_primitive_type);
+		set_shader(PSRM_DUAL_SOURCE_BLEND);
 	}
 	else
 	{
 		if (useDstAlpha)
 		{
-			ProgramShaderCache::SetShader(PSRM_ALPHA_PASS, VertexLoaderManager::g_current_components, m_current_primitive_type);
+			set_shader(PSRM_ALPHA_PASS);
 		}
-		ProgramShaderCache::SetShader(PSRM_DEFAULT, VertexLoaderManager::g_current_components, m_current_primitive_type);
+		set_shader(PSRM_DEFAULT);
 	}
 }
 
@@ -136,11 +154,26 @@ u16* VertexManager::GetIndexBuffer()
 }
 void VertexManager::vFlush(bool useDstAlpha)
 {
+	// Makes sure we can actually do Dual source blending
+	bool dualSourcePossible = g_ActiveConfig.backend_info.bSupportsDualSourceBlend;
+	// If host supports GL_ARB_blend_func_extended, we can do dst alpha in
+	// the same pass as regular rendering.
+	OGL::SHADER* active_shader = nullptr;
+	if (useDstAlpha && dualSourcePossible)
+	{
+		active_shader = ProgramShaderCache::SetShader(PSRM_DUAL_SOURCE_BLEND, VertexLoaderManager::g_current_components, m_current_primitive_type);
+	}
+	else
+	{
+		active_shader = ProgramShaderCache::SetShader(PSRM_DEFAULT, VertexLoaderManager::g_current_components, m_current_primitive_type);
+	}
+	// Failed or still compiling in the background
+	if (!active_shader)
+		return;
+
 	GLVertexFormat* nativeVertexFmt = (GLVertexFormat*)VertexLoaderManager::GetCurrentVertexFormat();
 	u32 stride = nativeVertexFmt->GetVertexStride();
 	BBox::Update();
-	// Makes sure we can actually do Dual source blending
-	bool dualSourcePossible = g_ActiveConfig.backend_info.bSupportsDualSourceBlend;
 
 	// upload global constants
 	ProgramShaderCache::UploadConstants();
@@ -153,17 +186,6 @@ void VertexManager::vFlush(bool useDstAlpha)
 		m_last_vao = nativeVertexFmt->VAO;
 	}
 	PrepareDrawBuffers(stride);
-	// If host supports GL_ARB_blend_func_extended, we can do dst alpha in
-	// the same pass as regular rendering.
-	OGL::SHADER* active_shader = nullptr;
-	if (useDstAlpha && dualSourcePossible)
-	{
-		active_shader = ProgramShaderCache::SetShader(PSRM_DUAL_SOURCE_BLEND, VertexLoaderManager::g_current_components, m_current_primitive_type);
-	}
-	else
-	{
-		active_shader = ProgramShaderCache::SetShader(PSRM_DEFAULT, VertexLoaderManager::g_current_components, m_current_primitive_type);
-	}
 	active_shader->Bind();
 	g_renderer->ApplyState(false);
 	Draw(stride);
@@ -176,11 +198,16 @@ void VertexManager::vFlush(bool useDstAlpha)
 	const bool logic_op_enabled = bpmem.blendmode.logicopenable && bpmem.blendmode.logicmode != BlendMode::LogicOp::COPY && !bpmem.blendmode.blendenable;
 	// run through vertex groups again to set alpha
 	if (useDstAlpha && (!dualSourcePossible || logic_op_enabled))
-	{
 		active_shader = ProgramShaderCache::SetShader(PSRM_ALPHA_PASS, VertexLoaderManager::g_current_components, m_current_primitive_type);
+	else
+		active_shader = nullptr;
+	if (active_shader)
+	{
 
 		// only update alpha
 		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
+		static_cast<Renderer*>(g_renderer.get())->InvalidateDrawState(
+			Renderer::DRAW_STATE_COLOR_MASK | Renderer::DRAW_STATE_LOGIC_OP);
 
 		glDisable(GL_BLEND);
 		if (logic_op_enabled)
@@ -47,6 +47,7 @@ Make AA apply instantly during gameplay if possible
 #include "Core/Host.h"
 
 #include "VideoBackends/OGL/BoundingBox.h"
+#include "VideoBackends/OGL/FrameTimer.h"
 #include "VideoBackends/OGL/PerfQuery.h"
 #include "VideoBackends/OGL/ProgramShaderCache.h"
 #include "VideoBackends/OGL/Render.h"
@@ -59,6 +60,7 @@ Make AA apply instantly during gameplay if possible
 #include "VideoCommon/BPStructs.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OnScreenDisplay.h"
@@ -110,6 +112,7 @@ void VideoBackend::InitBackendInfo()
 	g_Config.backend_info.bSupportsExclusiveFullscreen = false;
 	g_Config.backend_info.bSupportsOversizedViewports = true;
 	g_Config.backend_info.bSupportsGeometryShaders = true;
+	g_Config.backend_info.bSupportsVSLayerOutput = false;
 	g_Config.backend_info.bSupports3DVision = false;
 	g_Config.backend_info.bSupportsPostProcessing = true;
 	g_Config.backend_info.bSupportsSSAA = true;
@@ -157,6 +160,7 @@ void VideoBackend::Video_Prepare()
 
 	g_vertex_manager = std::make_unique<VertexManager>();
 	g_perf_query = GetPerfQuery();
+	FrameProfiler::SetGPUTimer(FrameTimer::Create());
 	ProgramShaderCache::Init();
 	g_texture_cache = std::make_unique<TextureCache>();
 	g_sampler_cache = std::make_unique<SamplerCache>();
@@ -183,6 +187,7 @@ void VideoBackend::Video_Cleanup()
 	g_sampler_cache.reset();
 	g_texture_cache.reset();
 	ProgramShaderCache::Shutdown();
+	FrameProfiler::Shutdown();
 	g_perf_query.reset();
 	g_vertex_manager.reset();
 	g_renderer.reset();
@@ -36,6 +36,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "Common/ChunkFile.h"
+#include "Common/Intrinsics.h"
 #include "VideoBackends/Software/Clipper.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
 #include "VideoBackends/Software/Rasterizer.h"
@@ -107,6 +108,38 @@ static inline int CalcClipMask(OutputVertexData *v)
 	return cmask;
 }
 
+// The combined clip mask of a triangle, all three vertices are tested together
+static inline int CalcTriangleClipMask(OutputVertexData* const* v)
+{
+#ifdef _M_X86
+	const Vec4& p0 = v[0]->projectedPosition;
+	const Vec4& p1 = v[1]->projectedPosition;
+	const Vec4& p2 = v[2]->projectedPosition;
+	const __m128 x = _mm_setr_ps(p0.x, p1.x, p2.x, p0.x);
+	const __m128 y = _mm_setr_ps(p0.y, p1.y, p2.y, p0.y);
+	const __m128 z = _mm_setr_ps(p0.z, p1.z, p2.z, p0.z);
+	const __m128 w = _mm_setr_ps(p0.w, p1.w, p2.w, p0.w);
+	const __m128 zero = _mm_setzero_ps();
+
+	int cmask = 0;
+	if (_mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(w, x), zero)))
+		cmask |= CLIP_POS_X_BIT;
+	if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(x, w), zero)))
+		cmask |= CLIP_NEG_X_BIT;
+	if (_mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(w, y), zero)))
+		cmask |= CLIP_POS_Y_BIT;
+	if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(y, w), zero)))
+		cmask |= CLIP_NEG_Y_BIT;
+	if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_mul_ps(w, z), zero)))
+		cmask |= CLIP_POS_Z_BIT;
+	if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(z, w), zero)))
+		cmask |= CLIP_NEG_Z_BIT;
+	return cmask;
+#else
+	return CalcClipMask(v[0]) | CalcClipMask(v[1]) | CalcClipMask(v[2]);
+#endif
+}
+
 static inline void AddInterpolatedVertex(float t, int out, int in, int* numVertices)
 {
 	Vertices[(*numVertices)++]->Lerp(t, Vertices[out], Vertices[in]);
@@ -182,11 +215,7 @@ static inline void AddInterpolatedVertex(float t, int out, int in, int* numVerti
 
 static void ClipTriangle(int *indices, int* numIndices)
 {
-	int mask = 0;
-
-	mask |= CalcClipMask(Vertices[0]);
-	mask |= CalcClipMask(Vertices[1]);
-	mask |= CalcClipMask(Vertices[2]);
+	int mask = CalcTriangleClipMask(Vertices);
 
 	if (mask != 0)
 	{
@@ -18,6 +18,7 @@ static u8 efb[EFB_WIDTH*EFB_HEIGHT * 6];
 namespace EfbInterface
 {
 u32 perf_values[PQ_NUM_MEMBERS];
+u32 perf_quad_pixels[PQ_NUM_MEMBERS];
 
 static inline u32 GetColorOffset(u16 x, u16 y)
 {
@@ -61,16 +61,24 @@ void CopyToXFB(yuv422_packed* xfb_in_ram, u32 fbWidth, u32 fbHeight, const EFBRe
 void BypassXFB(u8* texture, u32 fbWidth, u32 fbHeight, const EFBRectangle& sourceRc, float Gamma);
 
 extern u32 perf_values[PQ_NUM_MEMBERS];
+extern u32 perf_quad_pixels[PQ_NUM_MEMBERS];
 inline void IncPerfCounterQuadCount(PerfQueryType type)
 {
 	// NOTE: hardware doesn't process individual pixels but quads instead.
 	// Current software renderer architecture works on pixels though, so
 	// we have this "quad" hack here to only increment the registers on
 	// every fourth rendered pixel
-	static u32 quad[PQ_NUM_MEMBERS];
-	if (++quad[type] != 3)
+	if (++perf_quad_pixels[type] != 3)
 		return;
-	quad[type] = 0;
+	perf_quad_pixels[type] = 0;
 	++perf_values[type];
 }
+
+// Same as calling IncPerfCounterQuadCount count times, used for pixels counted on other threads.
+inline void AddPerfCounterPixels(PerfQueryType type, u32 count)
+{
+	u32 pixels = perf_quad_pixels[type] + count;
+	perf_values[type] += pixels / 3;
+	perf_quad_pixels[type] = pixels % 3;
+}
 }
@@ -4,8 +4,11 @@
 
 #include <algorithm>
 #include <cstring>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "Common/ThreadPool.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
 #include "VideoBackends/Software/Rasterizer.h"
@@ -20,27 +23,69 @@ namespace Rasterizer
 {
 static constexpr int BLOCK_SIZE = 2;
 
-static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
+// Triangles of a draw are binned into tiles of the EFB first, the tiles are then shaded in
+// parallel, each one only touching its own pixels in the order the triangles came in.
+static constexpr int TILE_SIZE = 64;
+static constexpr int TILES_X = (EFB_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr int TILES_Y = (EFB_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+static_assert(TILE_SIZE % BLOCK_SIZE == 0, "blocks must not straddle tiles");
 
-static s32 vertex0X;
-static s32 vertex0Y;
-static float vertexOffsetX;
-static float vertexOffsetY;
+struct SetupTriangle
+{
+	Slope ZSlope;
+	Slope WSlope;
+	Slope ColorSlopes[2][4];
+	Slope TexSlopes[8][3];
+
+	s32 vertex0X;
+	s32 vertex0Y;
+	float vertexOffsetX;
+	float vertexOffsetY;
+
+	// scissored bounding rectangle
+	s32 minx;
+	s32 maxx;
+	s32 miny;
+	s32 maxy;
+
+	// half-edge constants and deltas in 28.4
+	s32 C1, C2, C3;
+	s32 DX12, DX23, DX31;
+	s32 DY12, DY23, DY31;
+};
+
+struct RasterContext
+{
+	Tev tev;
+	RasterBlock rasterBlock;
+	int rasterizedPixels;
+	// indices into binnedTriangles, tiles only
+	std::vector<u32> triangles;
+};
+
+// Kept across triangles for zfreeze
+static Slope ZSlope;
 
 static s32 scissorLeft = 0;
 static s32 scissorTop = 0;
 static s32 scissorRight = 0;
 static s32 scissorBottom = 0;
 
-static Tev tev;
-static RasterBlock rasterBlock;
+static RasterContext context;
+static RasterContext tiles[TILES_X * TILES_Y];
+static std::vector<SetupTriangle> binnedTriangles;
+static std::vector<int> activeTiles;
 
 void Init()
 {
-	tev.Init();
+	context.tev.Init();
+	context.rasterizedPixels = 0;
+	for (RasterContext& tile : tiles)
+	{
+		tile.tev.Init();
+		tile.tev.LocalCounters = true;
+		tile.rasterizedPixels = 0;
+	}
 
 	// Set initial z reference plane in the unlikely case that zfreeze is enabled when drawing the first primitive.
 	// TODO: This is just a guess!
@@ -94,32 +139,37 @@ void SetScissor()
 
 void SetTevReg(int reg, int comp, bool konst, s16 color)
 {
-	tev.SetRegColor(reg, comp, konst, color);
+	context.tev.SetRegColor(reg, comp, konst, color);
+	for (RasterContext& tile : tiles)
+		tile.tev.SetRegColor(reg, comp, konst, color);
 }
 
-static void Draw(s32 x, s32 y, s32 xi, s32 yi)
+static void Draw(const SetupTriangle& tri, RasterContext& ctx, s32 x, s32 y, s32 xi, s32 yi)
 {
-	INCSTAT(stats.thisFrame.rasterizedPixels);
+	ctx.rasterizedPixels++;
+
+	float dx = tri.vertexOffsetX + (float)(x - tri.vertex0X);
+	float dy = tri.vertexOffsetY + (float)(y - tri.vertex0Y);
 
-	float dx = vertexOffsetX + (float)(x - vertex0X);
-	float dy = vertexOffsetY + (float)(y - vertex0Y);
+	s32 z = (s32)MathUtil::Clamp<float>(tri.ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
 
-	s32 z = (s32)MathUtil::Clamp<float>(ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
+	Tev& tev = ctx.tev;
+	const RasterBlock& rasterBlock = ctx.rasterBlock;
 
 	if (!BoundingBox::active && bpmem.UseEarlyDepthTest() && g_ActiveConfig.bZComploc)
 	{
 		// TODO: Test if perf regs are incremented even if test is disabled
-		EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
+		tev.IncPerfCounter(PQ_ZCOMP_INPUT_ZCOMPLOC);
 		if (bpmem.zmode.testenable)
 		{
 			// early z
 			if (!EfbInterface::ZCompare(x, y, z))
 				return;
 		}
-		EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
+		tev.IncPerfCounter(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
 	}
 
-	RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
+	const RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
 	tev.Position[0] = x;
 	tev.Position[1] = y;
@@ -130,7 +180,7 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
 	{
 		for (int comp = 0; comp < 4; comp++)
 		{
-			u16 color = (u16)ColorSlopes[i][comp].GetValue(dx, dy);
+			u16 color = (u16)tri.ColorSlopes[i][comp].GetValue(dx, dy);
 
 			// clamp color value to 0
 			u16 mask = ~(color >> 8);
@@ -162,16 +212,16 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
 	tev.Draw();
 }
 
-static void InitTriangle(float X1, float Y1, s32 xi, s32 yi)
+static void InitTriangle(SetupTriangle* tri, float X1, float Y1, s32 xi, s32 yi)
 {
-	vertex0X = xi;
-	vertex0Y = yi;
+	tri->vertex0X = xi;
+	tri->vertex0Y = yi;
 
 	// adjust a little less than 0.5
 	const float adjust = 0.495f;
 
-	vertexOffsetX = ((float)xi - X1) + adjust;
-	vertexOffsetY = ((float)yi - Y1) + adjust;
+	tri->vertexOffsetX = ((float)xi - X1) + adjust;
+	tri->vertexOffsetY = ((float)yi - Y1) + adjust;
 }
 
 static void InitSlope(Slope *slope, float f1, float f2, float f3, float DX31, float DX12, float DY12, float DY31)
@@ -186,7 +236,7 @@ static void InitSlope(Slope *slope, float f1, float f2, float f3, float DX31, fl
 	slope->f0 = f1;
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear, u32 texmap, u32 texcoord)
 {
 	const FourTexUnits& texUnit = bpmem.tex[(texmap >> 2) & 1];
 	const u8 subTexmap = texmap & 3;
@@ -199,17 +249,17 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
 	float sDelta, tDelta;
 	if (tm0.diag_lod)
 	{
-		float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-		float *uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
+		const float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+		const float *uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
 
 		sDelta = fabsf(uv0[0] - uv1[0]);
 		tDelta = fabsf(uv0[1] - uv1[1]);
 	}
 	else
 	{
-		float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-		float *uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
-		float *uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
+		const float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+		const float *uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
+		const float *uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
 		sDelta = std::max(fabsf(uv0[0] - uv1[0]), fabsf(uv0[0] - uv2[0]));
 		tDelta = std::max(fabsf(uv0[1] - uv1[1]), fabsf(uv0[1] - uv2[1]));
@@ -234,7 +284,7 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
 	*lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(const SetupTriangle& tri, RasterBlock& rasterBlock, s32 blockX, s32 blockY)
 {
 	for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
 	{
@@ -242,10 +292,10 @@ static void BuildBlock(s32 blockX, s32 blockY)
 		{
 			RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
-			float dx = vertexOffsetX + (float)(xi + blockX - vertex0X);
-			float dy = vertexOffsetY + (float)(yi + blockY - vertex0Y);
+			float dx = tri.vertexOffsetX + (float)(xi + blockX - tri.vertex0X);
+			float dy = tri.vertexOffsetY + (float)(yi + blockY - tri.vertex0Y);
 
-			float invW = 1.0f / WSlope.GetValue(dx, dy);
+			float invW = 1.0f / tri.WSlope.GetValue(dx, dy);
 			pixel.InvW = invW;
 
 			// tex coords
@@ -254,13 +304,13 @@ static void BuildBlock(s32 blockX, s32 blockY)
 				float projection = invW;
 				if (xfmem.texMtxInfo[i].projection)
 				{
-					float q = TexSlopes[i][2].GetValue(dx, dy) * invW;
+					float q = tri.TexSlopes[i][2].GetValue(dx, dy) * invW;
 					if (q != 0.0f)
 						projection = invW / q;
 				}
 
-				pixel.Uv[i][0] = TexSlopes[i][0].GetValue(dx, dy) * projection;
-				pixel.Uv[i][1] = TexSlopes[i][1].GetValue(dx, dy) * projection;
+				pixel.Uv[i][0] = tri.TexSlopes[i][0].GetValue(dx, dy) * projection;
+				pixel.Uv[i][1] = tri.TexSlopes[i][1].GetValue(dx, dy) * projection;
 			}
 		}
 	}
@@ -273,7 +323,7 @@ static void BuildBlock(s32 blockX, s32 blockY)
 		u32 texcoord = indref & 3;
 		indref >>= 3;
 
-		CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+		CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
 	}
 
 	for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -285,12 +335,12 @@ static void BuildBlock(s32 blockX, s32 blockY)
 			u32 texmap = order.getTexMap(stageOdd);
 			u32 texcoord = order.getTexCoord(stageOdd);
 
-			CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+			CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
 		}
 	}
 }
 
-static inline void PrepareBlock(s32 blockX, s32 blockY)
+static inline void PrepareBlock(const SetupTriangle& tri, s32 blockX, s32 blockY)
 {
 	static s32 x = -1;
 	static s32 y = -1;
@@ -302,14 +352,12 @@ static inline void PrepareBlock(s32 blockX, s32 blockY)
 	{
 		x = blockX;
 		y = blockY;
-		BuildBlock(x, y);
+		BuildBlock(tri, context.rasterBlock, x, y);
 	}
 }
 
-void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVertexData *v2)
+static bool SetupTriangleData(SetupTriangle* tri, OutputVertexData *v0, OutputVertexData *v1, OutputVertexData *v2)
 {
-	INCSTAT(stats.thisFrame.numTrianglesDrawn);
-
 	// adapted from http://devmaster.net/posts/6145/advanced-rasterization
 
 	// 28.4 fixed-pou32 coordinates. rounded to nearest and adjusted to match hardware output
@@ -331,15 +379,6 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 	const s32 DY23 = Y2 - Y3;
 	const s32 DY31 = Y3 - Y1;
 
-	// Fixed-pos32 deltas
-	const s32 FDX12 = DX12 * 16;
-	const s32 FDX23 = DX23 * 16;
-	const s32 FDX31 = DX31 * 16;
-
-	const s32 FDY12 = DY12 * 16;
-	const s32 FDY23 = DY23 * 16;
-	const s32 FDY31 = DY31 * 16;
-
 	// Bounding rectangle
 	s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
 	s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
@@ -353,7 +392,12 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 	maxy = std::min(maxy, scissorBottom);
 
 	if (minx >= maxx || miny >= maxy)
-		return;
+		return false;
+
+	tri->minx = minx;
+	tri->maxx = maxx;
+	tri->miny = miny;
+	tri->maxy = maxy;
 
 	// Setup slopes
 	float fltx1 = v0->screenPosition.x;
@@ -363,10 +407,10 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 	float fltdy12 = flty1 - v1->screenPosition.y;
 	float fltdy31 = v2->screenPosition.y - flty1;
 
-	InitTriangle(fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
+	InitTriangle(tri, fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
 
 	float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w, 1.0f / v2->projectedPosition.w};
-	InitSlope(&WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+	InitSlope(&tri->WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 
 	// TODO: The zfreeze emulation is not quite correct, yet!
 	// Many things might prevent us from reaching this line (culling, clipping, scissoring).
@@ -374,17 +418,18 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 	// We're currently sloppy at this since we abort early if any of the culling/clipping/scissoring tests fail.
 	if (!bpmem.genMode.zfreeze || !g_ActiveConfig.bZFreeze)
 		InitSlope(&ZSlope, v0->screenPosition[2], v1->screenPosition[2], v2->screenPosition[2], fltdx31, fltdx12, fltdy12, fltdy31);
+	tri->ZSlope = ZSlope;
 
 	for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
 	{
 		for (int comp = 0; comp < 4; comp++)
-			InitSlope(&ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
+			InitSlope(&tri->ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
 	}
 
 	for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
 	{
 		for (int comp = 0; comp < 3; comp++)
-			InitSlope(&TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+			InitSlope(&tri->TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 	}
 
 	// Half-edge constants
@@ -397,151 +442,244 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 	if (DY23 < 0 || (DY23 == 0 && DX23 > 0)) C2++;
 	if (DY31 < 0 || (DY31 == 0 && DX31 > 0)) C3++;
 
-	if (!BoundingBox::active)
+	tri->C1 = C1;
+	tri->C2 = C2;
+	tri->C3 = C3;
+	tri->DX12 = DX12;
+	tri->DX23 = DX23;
+	tri->DX31 = DX31;
+	tri->DY12 = DY12;
+	tri->DY23 = DY23;
+	tri->DY31 = DY31;
+	return true;
+}
+
+// Draws the blocks of the triangle inside [minx, maxx) x [miny, maxy), minx and miny are block aligned
+static void RasterizeBlocks(const SetupTriangle& tri, RasterContext& ctx, s32 minx, s32 maxx, s32 miny, s32 maxy)
+{
+	const s32 C1 = tri.C1;
+	const s32 C2 = tri.C2;
+	const s32 C3 = tri.C3;
+
+	const s32 DX12 = tri.DX12;
+	const s32 DX23 = tri.DX23;
+	const s32 DX31 = tri.DX31;
+
+	const s32 DY12 = tri.DY12;
+	const s32 DY23 = tri.DY23;
+	const s32 DY31 = tri.DY31;
+
+	// Fixed-pos32 deltas
+	const s32 FDX12 = DX12 * 16;
+	const s32 FDX23 = DX23 * 16;
+	const s32 FDX31 = DX31 * 16;
+
+	const s32 FDY12 = DY12 * 16;
+	const s32 FDY23 = DY23 * 16;
+	const s32 FDY31 = DY31 * 16;
+
+	// Loop through blocks
+	for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
 	{
-		// Start in corner of 8x8 block
-		minx &= ~(BLOCK_SIZE - 1);
-		miny &= ~(BLOCK_SIZE - 1);
-		// Loop through blocks
-		for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
+		for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
 		{
-			for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
+			// Corners of block
+			s32 x0 = x << 4;
+			s32 x1 = (x + BLOCK_SIZE - 1) << 4;
+			s32 y0 = y << 4;
+			s32 y1 = (y + BLOCK_SIZE - 1) << 4;
+
+			// Evaluate half-space functions
+			bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
+			bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
+			bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
+			bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
+			int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
+
+			bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
+			bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
+			bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
+			bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
+			int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
+
+			bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
+			bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
+			bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
+			bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
+			int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
+
+			// Skip block when outside an edge
+			if (a == 0x0 || b == 0x0 || c == 0x0)
+				continue;
+
+			BuildBlock(tri, ctx.rasterBlock, x, y);
+
+			// Accept whole block when totally covered
+			if (a == 0xF && b == 0xF && c == 0xF)
 			{
-				// Corners of block
-				s32 x0 = x << 4;
-				s32 x1 = (x + BLOCK_SIZE - 1) << 4;
-				s32 y0 = y << 4;
-				s32 y1 = (y + BLOCK_SIZE - 1) << 4;
-
-				// Evaluate half-space functions
-				bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
-				bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
-				bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
-				bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
-				int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
-
-				bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
-				bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
-				bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
-				bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
-				int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
-
-				bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
-				bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
-				bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
-				bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
-				int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
-
-				// Skip block when outside an edge
-				if (a == 0x0 || b == 0x0 || c == 0x0)
-					continue;
-
-				BuildBlock(x, y);
-
-				// Accept whole block when totally covered
-				if (a == 0xF && b == 0xF && c == 0xF)
+				for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
 				{
-					for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+					for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
 					{
-						for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-						{
-							Draw(x + ix, y + iy, ix, iy);
-						}
+						Draw(tri, ctx, x + ix, y + iy, ix, iy);
 					}
 				}
-				else // Partially covered block
+			}
+			else // Partially covered block
+			{
+				s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
+				s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
+				s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
+
+				for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
 				{
-					s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
-					s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
-					s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
+					s32 CX1 = CY1;
+					s32 CX2 = CY2;
+					s32 CX3 = CY3;
 
-					for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+					for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
 					{
-						s32 CX1 = CY1;
-						s32 CX2 = CY2;
-						s32 CX3 = CY3;
-
-						for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+						if (CX1 > 0 && CX2 > 0 && CX3 > 0)
 						{
-							if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-							{
-								Draw(x + ix, y + iy, ix, iy);
-							}
-
-							CX1 -= FDY12;
-							CX2 -= FDY23;
-							CX3 -= FDY31;
+							Draw(tri, ctx, x + ix, y + iy, ix, iy);
 						}
 
-						CY1 += FDX12;
-						CY2 += FDX23;
-						CY3 += FDX31;
+						CX1 -= FDY12;
+						CX2 -= FDY23;
+						CX3 -= FDY31;
 					}
+
+					CY1 += FDX12;
+					CY2 += FDX23;
+					CY3 += FDX31;
 				}
 			}
 		}
 	}
-	else
+}
+
+static void RasterizeBoundingBox(const SetupTriangle& tri)
+{
+	const s32 C1 = tri.C1;
+	const s32 C2 = tri.C2;
+	const s32 C3 = tri.C3;
+
+	const s32 DX12 = tri.DX12;
+	const s32 DX23 = tri.DX23;
+	const s32 DX31 = tri.DX31;
+
+	const s32 DY12 = tri.DY12;
+	const s32 DY23 = tri.DY23;
+	const s32 DY31 = tri.DY31;
+
+	// Fixed-pos32 deltas
+	const s32 FDX12 = DX12 * 16;
+	const s32 FDX23 = DX23 * 16;
+	const s32 FDX31 = DX31 * 16;
+
+	const s32 FDY12 = DY12 * 16;
+	const s32 FDY23 = DY23 * 16;
+	const s32 FDY31 = DY31 * 16;
+
+	s32 minx = tri.minx;
+	s32 maxx = tri.maxx;
+	s32 miny = tri.miny;
+	s32 maxy = tri.maxy;
+
+	// Calculating bbox
+	// First check for alpha channel - don't do anything it if always fails,
+	// Change bbox to primitive size if it always passes
+	AlphaTest::TEST_RESULT alphaRes = bpmem.alpha_test.TestResult();
+
+	if (alphaRes != AlphaTest::UNDETERMINED)
+	{
+		if (alphaRes == AlphaTest::PASS)
+		{
+			BoundingBox::coords[BoundingBox::TOP] = std::min(BoundingBox::coords[BoundingBox::TOP], (u16)miny);
+			BoundingBox::coords[BoundingBox::LEFT] = std::min(BoundingBox::coords[BoundingBox::LEFT], (u16)minx);
+			BoundingBox::coords[BoundingBox::BOTTOM] = std::max(BoundingBox::coords[BoundingBox::BOTTOM], (u16)maxy);
+			BoundingBox::coords[BoundingBox::RIGHT] = std::max(BoundingBox::coords[BoundingBox::RIGHT], (u16)maxx);
+		}
+		return;
+	}
+
+	// If we are calculating bbox with alpha, we only need to find the
+	// topmost, leftmost, bottom most and rightmost pixels to be drawn.
+	// So instead of drawing every single one of the triangle's pixels,
+	// four loops are run: one for the top pixel, one for the left, one for
+	// the bottom and one for the right. As soon as a pixel that is to be
+	// drawn is found, the loop breaks. This enables a ~150% speedbost in
+	// bbox calculation, albeit at the cost of some ugly repetitive code.
+	const s32 FLEFT = minx << 4;
+	const s32 FRIGHT = maxx << 4;
+	s32 FTOP = miny << 4;
+	s32 FBOTTOM = maxy << 4;
+
+	// Start checking for bbox top
+	s32 CY1 = C1 + DX12 * FTOP - DY12 * FLEFT;
+	s32 CY2 = C2 + DX23 * FTOP - DY23 * FLEFT;
+	s32 CY3 = C3 + DX31 * FTOP - DY31 * FLEFT;
+
+	// Loop
+	for (s32 y = miny; y <= maxy; ++y)
 	{
-		// Calculating bbox
-		// First check for alpha channel - don't do anything it if always fails,
-		// Change bbox to primitive size if it always passes
-		AlphaTest::TEST_RESULT alphaRes = bpmem.alpha_test.TestResult();
+		if (y >= BoundingBox::coords[BoundingBox::TOP])
+			break;
+
+		s32 CX1 = CY1;
+		s32 CX2 = CY2;
+		s32 CX3 = CY3;
 
-		if (alphaRes != AlphaTest::UNDETERMINED)
+		for (s32 x = minx; x <= maxx; ++x)
 		{
-			if (alphaRes == AlphaTest::PASS)
+			if (CX1 > 0 && CX2 > 0 && CX3 > 0)
 			{
-				BoundingBox::coords[BoundingBox::TOP] = std::min(BoundingBox::coords[BoundingBox::TOP], (u16)miny);
-				BoundingBox::coords[BoundingBox::LEFT] = std::min(BoundingBox::coords[BoundingBox::LEFT], (u16)minx);
-				BoundingBox::coords[BoundingBox::BOTTOM] = std::max(BoundingBox::coords[BoundingBox::BOTTOM], (u16)maxy);
-				BoundingBox::coords[BoundingBox::RIGHT] = std::max(BoundingBox::coords[BoundingBox::RIGHT], (u16)maxx);
+				// Build the new raster block every other pixel
+				PrepareBlock(tri, x, y);
+				Draw(tri, context, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+
+				if (y >= BoundingBox::coords[BoundingBox::TOP])
+					break;
 			}
-			return;
+
+			CX1 -= FDY12;
+			CX2 -= FDY23;
+			CX3 -= FDY31;
 		}
 
-		// If we are calculating bbox with alpha, we only need to find the
-		// topmost, leftmost, bottom most and rightmost pixels to be drawn.
-		// So instead of drawing every single one of the triangle's pixels,
-		// four loops are run: one for the top pixel, one for the left, one for
-		// the bottom and one for the right. As soon as a pixel that is to be
-		// drawn is found, the loop breaks. This enables a ~150% speedbost in
-		// bbox calculation, albeit at the cost of some ugly repetitive code.
-		const s32 FLEFT = minx << 4;
-		const s32 FRIGHT = maxx << 4;
-		s32 FTOP = miny << 4;
-		s32 FBOTTOM = maxy << 4;
-
-		// Start checking for bbox top
-		s32 CY1 = C1 + DX12 * FTOP - DY12 * FLEFT;
-		s32 CY2 = C2 + DX23 * FTOP - DY23 * FLEFT;
-		s32 CY3 = C3 + DX31 * FTOP - DY31 * FLEFT;
-
-		// Loop
-		for (s32 y = miny; y <= maxy; ++y)
-		{
-			if (y >= BoundingBox::coords[BoundingBox::TOP])
-				break;
+		CY1 += FDX12;
+		CY2 += FDX23;
+		CY3 += FDX31;
+	}
 
-			s32 CX1 = CY1;
-			s32 CX2 = CY2;
-			s32 CX3 = CY3;
+	// Update top limit
+	miny = std::max((s32)BoundingBox::coords[BoundingBox::TOP], miny);
+	FTOP = miny << 4;
 
-			for (s32 x = minx; x <= maxx; ++x)
-			{
-				if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-				{
-					// Build the new raster block every other pixel
-					PrepareBlock(x, y);
-					Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+	// Checking for bbox left
+	s32 CX1 = C1 + DX12 * FTOP - DY12 * FLEFT;
+	s32 CX2 = C2 + DX23 * FTOP - DY23 * FLEFT;
+	s32 CX3 = C3 + DX31 * FTOP - DY31 * FLEFT;
 
-					if (y >= BoundingBox::coords[BoundingBox::TOP])
-						break;
-				}
+	// Loop
+	for (s32 x = minx; x <= maxx; ++x)
+	{
+		if (x >= BoundingBox::coords[BoundingBox::LEFT])
+			break;
+
+		CY1 = CX1;
+		CY2 = CX2;
+		CY3 = CX3;
 
-				CX1 -= FDY12;
-				CX2 -= FDY23;
-				CX3 -= FDY31;
+		for (s32 y = miny; y <= maxy; ++y)
+		{
+			if (CY1 > 0 && CY2 > 0 && CY3 > 0)
+			{
+				PrepareBlock(tri, x, y);
+				Draw(tri, context, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+
+				if (x >= BoundingBox::coords[BoundingBox::LEFT])
+					break;
 			}
 
 			CY1 += FDX12;
@@ -549,79 +687,80 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 			CY3 += FDX31;
 		}
 
-		// Update top limit
-		miny = std::max((s32)BoundingBox::coords[BoundingBox::TOP], miny);
-		FTOP = miny << 4;
+		CX1 -= FDY12;
+		CX2 -= FDY23;
+		CX3 -= FDY31;
+	}
+
+	// Update left limit
+	minx = std::max((s32)BoundingBox::coords[BoundingBox::LEFT], minx);
 
-		// Checking for bbox left
-		s32 CX1 = C1 + DX12 * FTOP - DY12 * FLEFT;
-		s32 CX2 = C2 + DX23 * FTOP - DY23 * FLEFT;
-		s32 CX3 = C3 + DX31 * FTOP - DY31 * FLEFT;
+	// Checking for bbox bottom
+	CY1 = C1 + DX12 * FBOTTOM - DY12 * FRIGHT;
+	CY2 = C2 + DX23 * FBOTTOM - DY23 * FRIGHT;
+	CY3 = C3 + DX31 * FBOTTOM - DY31 * FRIGHT;
 
-		// Loop
-		for (s32 x = minx; x <= maxx; ++x)
-		{
-			if (x >= BoundingBox::coords[BoundingBox::LEFT])
-				break;
+	// Loop
+	for (s32 y = maxy; y >= miny; --y)
+	{
+		CX1 = CY1;
+		CX2 = CY2;
+		CX3 = CY3;
 
-			CY1 = CX1;
-			CY2 = CX2;
-			CY3 = CX3;
+		if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
+			break;
 
-			for (s32 y = miny; y <= maxy; ++y)
+		for (s32 x = maxx; x >= minx; --x)
+		{
+			if (CX1 > 0 && CX2 > 0 && CX3 > 0)
 			{
-				if (CY1 > 0 && CY2 > 0 && CY3 > 0)
-				{
-					PrepareBlock(x, y);
-					Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+				// Build the new raster block every other pixel
+				PrepareBlock(tri, x, y);
+				Draw(tri, context, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
 
-					if (x >= BoundingBox::coords[BoundingBox::LEFT])
-						break;
-				}
-
-				CY1 += FDX12;
-				CY2 += FDX23;
-				CY3 += FDX31;
+				if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
+					break;
 			}
 
-			CX1 -= FDY12;
-			CX2 -= FDY23;
-			CX3 -= FDY31;
+			CX1 += FDY12;
+			CX2 += FDY23;
+			CX3 += FDY31;
 		}
 
-		// Update left limit
-		minx = std::max((s32)BoundingBox::coords[BoundingBox::LEFT], minx);
+		CY1 -= FDX12;
+		CY2 -= FDX23;
+		CY3 -= FDX31;
+	}
 
-		// Checking for bbox bottom
-		CY1 = C1 + DX12 * FBOTTOM - DY12 * FRIGHT;
-		CY2 = C2 + DX23 * FBOTTOM - DY23 * FRIGHT;
-		CY3 = C3 + DX31 * FBOTTOM - DY31 * FRIGHT;
+	// Update bottom limit
+	maxy = std::min((s32)BoundingBox::coords[BoundingBox::BOTTOM], maxy);
+	FBOTTOM = maxy << 4;
 
-		// Loop
-		for (s32 y = maxy; y >= miny; --y)
-		{
-			CX1 = CY1;
-			CX2 = CY2;
-			CX3 = CY3;
+	// Checking for bbox right
+	CX1 = C1 + DX12 * FBOTTOM - DY12 * FRIGHT;
+	CX2 = C2 + DX23 * FBOTTOM - DY23 * FRIGHT;
+	CX3 = C3 + DX31 * FBOTTOM - DY31 * FRIGHT;
 
-			if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
-				break;
+	// Loop
+	for (s32 x = maxx; x >= minx; --x)
+	{
+		if (x <= BoundingBox::coords[BoundingBox::RIGHT])
+			break;
 
-			for (s32 x = maxx; x >= minx; --x)
-			{
-				if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-				{
-					// Build the new raster block every other pixel
-					PrepareBlock(x, y);
-					Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+		CY1 = CX1;
+		CY2 = CX2;
+		CY3 = CX3;
 
-					if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
-						break;
-				}
+		for (s32 y = maxy; y >= miny; --y)
+		{
+			if (CY1 > 0 && CY2 > 0 && CY3 > 0)
+			{
+				// Build the new raster block every other pixel
+				PrepareBlock(tri, x, y);
+				Draw(tri, context, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
 
-				CX1 += FDY12;
-				CX2 += FDY23;
-				CX3 += FDY31;
+				if (x <= BoundingBox::coords[BoundingBox::RIGHT])
+					break;
 			}
 
 			CY1 -= FDX12;
@@ -629,47 +768,104 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 			CY3 -= FDX31;
 		}
 
-		// Update bottom limit
-		maxy = std::min((s32)BoundingBox::coords[BoundingBox::BOTTOM], maxy);
-		FBOTTOM = maxy << 4;
+		CX1 += FDY12;
+		CX2 += FDY23;
+		CX3 += FDY31;
+	}
+}
+
+static void ShadeTile(int index)
+{
+	RasterContext& tile = tiles[index];
+	const s32 left = (index % TILES_X) * TILE_SIZE;
+	const s32 top = (index / TILES_X) * TILE_SIZE;
+	for (u32 i : tile.triangles)
+	{
+		const SetupTriangle& tri = binnedTriangles[i];
+		RasterizeBlocks(tri, tile,
+			std::max(tri.minx & ~(BLOCK_SIZE - 1), left), std::min(tri.maxx, left + TILE_SIZE),
+			std::max(tri.miny & ~(BLOCK_SIZE - 1), top), std::min(tri.maxy, top + TILE_SIZE));
+	}
+	tile.triangles.clear();
+}
 
-		// Checking for bbox right
-		CX1 = C1 + DX12 * FBOTTOM - DY12 * FRIGHT;
-		CX2 = C2 + DX23 * FBOTTOM - DY23 * FRIGHT;
-		CX3 = C3 + DX31 * FBOTTOM - DY31 * FRIGHT;
+static bool CanShadeInParallel()
+{
+	// Bounding box emulation reads back the coordinates while rasterizing, tev dumps share buffers
+	return cpu_info.logical_cpu_count > 1 && !BoundingBox::active &&
+		!g_ActiveConfig.bDumpTevStages && !g_ActiveConfig.bDumpTevTextureFetches;
+}
 
-		// Loop
-		for (s32 x = maxx; x >= minx; --x)
+static void BinTriangle(const SetupTriangle& tri)
+{
+	const u32 index = static_cast<u32>(binnedTriangles.size());
+	binnedTriangles.push_back(tri);
+
+	const int tile_left = (tri.minx & ~(BLOCK_SIZE - 1)) / TILE_SIZE;
+	const int tile_right = (tri.maxx - 1) / TILE_SIZE;
+	const int tile_top = (tri.miny & ~(BLOCK_SIZE - 1)) / TILE_SIZE;
+	const int tile_bottom = (tri.maxy - 1) / TILE_SIZE;
+	for (int ty = tile_top; ty <= tile_bottom; ty++)
+	{
+		for (int tx = tile_left; tx <= tile_right; tx++)
 		{
-			if (x <= BoundingBox::coords[BoundingBox::RIGHT])
-				break;
+			RasterContext& tile = tiles[ty * TILES_X + tx];
+			if (tile.triangles.empty())
+				activeTiles.push_back(ty * TILES_X + tx);
+			tile.triangles.push_back(index);
+		}
+	}
+}
 
-			CY1 = CX1;
-			CY2 = CX2;
-			CY3 = CX3;
+void Flush()
+{
+	if (activeTiles.empty())
+	{
+		binnedTriangles.clear();
+		return;
+	}
 
-			for (s32 y = maxy; y >= miny; --y)
-			{
-				if (CY1 > 0 && CY2 > 0 && CY3 > 0)
-				{
-					// Build the new raster block every other pixel
-					PrepareBlock(x, y);
-					Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+	Common::AsyncWorker::ExecuteParallel([](int lower, int upper)
+	{
+		for (int i = lower; i < upper; i++)
+			ShadeTile(activeTiles[i]);
+	}, 0, static_cast<int>(activeTiles.size()), 1);
 
-					if (x <= BoundingBox::coords[BoundingBox::RIGHT])
-						break;
-				}
+	for (int index : activeTiles)
+	{
+		RasterContext& tile = tiles[index];
+		tile.tev.MergeLocalCounters();
+		ADDSTAT(stats.thisFrame.rasterizedPixels, tile.rasterizedPixels);
+		tile.rasterizedPixels = 0;
+	}
+	activeTiles.clear();
+	binnedTriangles.clear();
+}
 
-				CY1 -= FDX12;
-				CY2 -= FDX23;
-				CY3 -= FDX31;
-			}
+void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVertexData *v2)
+{
+	INCSTAT(stats.thisFrame.numTrianglesDrawn);
 
-			CX1 += FDY12;
-			CX2 += FDY23;
-			CX3 += FDY31;
-		}
+	SetupTriangle tri;
+	if (!SetupTriangleData(&tri, v0, v1, v2))
+		return;
+
+	if (CanShadeInParallel())
+	{
+		BinTriangle(tri);
+		return;
 	}
+
+	// Keep the order with anything binned earlier in the draw
+	Flush();
+
+	if (!BoundingBox::active)
+		RasterizeBlocks(tri, context, tri.minx & ~(BLOCK_SIZE - 1), tri.maxx, tri.miny & ~(BLOCK_SIZE - 1), tri.maxy);
+	else
+		RasterizeBoundingBox(tri);
+
+	ADDSTAT(stats.thisFrame.rasterizedPixels, context.rasterizedPixels);
+	context.rasterizedPixels = 0;
 }
 
 }
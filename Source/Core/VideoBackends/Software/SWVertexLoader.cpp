@@ -98,6 +98,42 @@ void SWVertexLoader::vFlush(bool useDstAlpha)
 		Rasterizer::SetTevReg(i, Tev::ALP_C, true, kcolors[i * 4 + 3]);
 	}
 
+	// Only the matrix indices and the tex gen special case come from here, they are the same for every vertex
+	memset(&m_Vertex, 0, sizeof(m_Vertex));
+	SetFormat(g_main_cp_state.last_id, primitiveType);
+
+	// Most vertices are referenced by several indices, so every vertex is transformed once per
+	// draw up front, positions in batches.
+	const u32 numVertices = IndexGenerator::GetNumVerts();
+	const PortableVertexDeclaration& vdec = VertexLoaderManager::GetCurrentVertexFormat()->GetVertexDeclaration();
+	m_InputVertices.resize(numVertices);
+	m_TransformedVertices.resize(numVertices);
+	for (u32 i = 0; i < numVertices; i++)
+	{
+		// Super Mario Sunshine requires the colors to be zero for those debug boxes.
+		m_InputVertices[i] = m_Vertex;
+
+		// parse the videocommon format to our own struct format
+		ParseVertex(vdec, i, &m_InputVertices[i]);
+	}
+
+	// transform the vertices so that they can be used for rasterization
+	TransformUnit::TransformPositions(m_InputVertices.data(), m_TransformedVertices.data(), static_cast<int>(numVertices));
+	for (u32 i = 0; i < numVertices; i++)
+	{
+		const InputVertexData* inVertex = &m_InputVertices[i];
+		OutputVertexData* outVertex = &m_TransformedVertices[i];
+		memset(&outVertex->normal, 0, sizeof(outVertex->normal));
+		if (VertexLoaderManager::g_current_components & VB_HAS_NRM0)
+		{
+			TransformUnit::TransformNormal(inVertex, (VertexLoaderManager::g_current_components & VB_HAS_NRM2) != 0, outVertex);
+		}
+		TransformUnit::TransformColor(inVertex, outVertex);
+		TransformUnit::TransformTexCoord(inVertex, outVertex, m_TexGenSpecialCase);
+
+		INCSTAT(stats.thisFrame.numVerticesLoaded)
+	}
+
 	for (u32 i = 0; i < IndexGenerator::GetIndexLen(); i++)
 	{
 		u16 index = LocalIBuffer[i];
@@ -108,32 +144,14 @@ void SWVertexLoader::vFlush(bool useDstAlpha)
 			m_SetupUnit->Init(primitiveType);
 			continue;
 		}
-		memset(&m_Vertex, 0, sizeof(m_Vertex));
-
-		// Super Mario Sunshine requires those to be zero for those debug boxes.
-		memset(&m_Vertex.color, 0, sizeof(m_Vertex.color));
-
-		// parse the videocommon format to our own struct format (m_Vertex)
-		SetFormat(g_main_cp_state.last_id, primitiveType);
-		ParseVertex(VertexLoaderManager::GetCurrentVertexFormat()->GetVertexDeclaration(), index);
-
-		// transform this vertex so that it can be used for rasterization (outVertex)
-		OutputVertexData* outVertex = m_SetupUnit->GetVertex();
-		TransformUnit::TransformPosition(&m_Vertex, outVertex);
-		memset(&outVertex->normal, 0, sizeof(outVertex->normal));
-		if (VertexLoaderManager::g_current_components & VB_HAS_NRM0)
-		{
-			TransformUnit::TransformNormal(&m_Vertex, (VertexLoaderManager::g_current_components & VB_HAS_NRM2) != 0, outVertex);
-		}
-		TransformUnit::TransformColor(&m_Vertex, outVertex);
-		TransformUnit::TransformTexCoord(&m_Vertex, outVertex, m_TexGenSpecialCase);
 
 		// assemble and rasterize the primitive
+		*m_SetupUnit->GetVertex() = m_TransformedVertices[index];
 		m_SetupUnit->SetupVertex();
-
-		INCSTAT(stats.thisFrame.numVerticesLoaded)
 	}
 
+	Rasterizer::Flush();
+
 	DebugUtil::OnObjectEnd();
 }
 
@@ -224,33 +242,33 @@ static void ReadVertexAttribute(T* dst, DataReader src, const AttributeFormat& f
 	}
 }
 
-void SWVertexLoader::ParseVertex(const PortableVertexDeclaration& vdec, int index)
+void SWVertexLoader::ParseVertex(const PortableVertexDeclaration& vdec, int index, InputVertexData* vertex)
 {
 	DataReader src(LocalVBuffer.data(), LocalVBuffer.data() + LocalVBuffer.size());
 	src.ReadSkip(index * vdec.stride);
 
-	ReadVertexAttribute<float>(&m_Vertex.position[0], src, vdec.position, 0, 3, false);
+	ReadVertexAttribute<float>(&vertex->position[0], src, vdec.position, 0, 3, false);
 
 	for (int i = 0; i < 3; i++)
 	{
-		ReadVertexAttribute<float>(&m_Vertex.normal[i][0], src, vdec.normals[i], 0, 3, false);
+		ReadVertexAttribute<float>(&vertex->normal[i][0], src, vdec.normals[i], 0, 3, false);
 	}
 
 	for (int i = 0; i < 2; i++)
 	{
-		ReadVertexAttribute<u8>(m_Vertex.color[i], src, vdec.colors[i], 0, 4, true);
+		ReadVertexAttribute<u8>(vertex->color[i], src, vdec.colors[i], 0, 4, true);
 	}
 
 	for (int i = 0; i < 8; i++)
 	{
-		ReadVertexAttribute<float>(m_Vertex.texCoords[i], src, vdec.texcoords[i], 0, 2, false);
+		ReadVertexAttribute<float>(vertex->texCoords[i], src, vdec.texcoords[i], 0, 2, false);
 
 		// the texmtr is stored as third component of the texCoord
 		if (vdec.texcoords[i].components >= 3)
 		{
-			ReadVertexAttribute<u8>(&m_Vertex.texMtx[i], src, vdec.texcoords[i], 2, 1, false);
+			ReadVertexAttribute<u8>(&vertex->texMtx[i], src, vdec.texcoords[i], 2, 1, false);
 		}
 	}
 
-	ReadVertexAttribute<u8>(&m_Vertex.posMtx, src, vdec.posmtx, 0, 1, false);
+	ReadVertexAttribute<u8>(&vertex->posMtx, src, vdec.posmtx, 0, 1, false);
 }
@@ -37,9 +37,12 @@ private:
 	std::vector<u8> LocalVBuffer;
 	std::vector<u16> LocalIBuffer;
 
+	// Holds the per draw defaults every parsed vertex starts from
 	InputVertexData m_Vertex;
+	std::vector<InputVertexData> m_InputVertices;
+	std::vector<OutputVertexData> m_TransformedVertices;
 
-	void ParseVertex(const PortableVertexDeclaration& vdec, int index);
+	void ParseVertex(const PortableVertexDeclaration& vdec, int index, InputVertexData* vertex);
 
 	SetupUnit *m_SetupUnit;
 
@@ -6,6 +6,7 @@
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "VideoBackends/Software/DebugUtil.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/Tev.h"
@@ -124,6 +125,14 @@ void Tev::Init()
 	m_ScaleRShiftLUT[1] = 0;
 	m_ScaleRShiftLUT[2] = 0;
 	m_ScaleRShiftLUT[3] = 1;
+
+#ifdef _M_X86
+	for (RegularCombinerLanes& lanes : m_RegularLanes)
+		lanes.Valid = false;
+#endif
+
+	LocalCounters = false;
+	ResetLocalCounters();
 }
 
 static inline s16 Clamp255(s16 in)
@@ -209,6 +218,86 @@ void Tev::DrawColorRegular(TevStageCombiner::ColorCombiner &cc, const InputRegTy
 	}
 }
 
+#ifdef _M_X86
+void Tev::UpdateRegularLanes(RegularCombinerLanes& lanes, const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		const bool alpha = i == ALP_C;
+		const u32 shift = alpha ? ac.shift : cc.shift;
+		const u32 op = alpha ? ac.op : cc.op;
+		const u32 clamp = alpha ? ac.clamp : cc.clamp;
+
+		lanes.DoubleOnce[i] = m_ScaleLShiftLUT[shift] >= 1 ? -1 : 0;
+		lanes.DoubleTwice[i] = m_ScaleLShiftLUT[shift] >= 2 ? -1 : 0;
+		// Same rounding as DrawColorRegular and DrawAlphaRegular, which don't agree on it
+		if (alpha)
+			lanes.Round[i] = (shift != 3) ? 0 : (op == 1) ? 127 : 128;
+		else
+			lanes.Round[i] = (shift == 3) ? 0 : (op == 1) ? 127 : 128;
+		lanes.NegateBefore[i] = (alpha && op) ? -1 : 0;
+		lanes.NegateAfter[i] = (!alpha && op) ? -1 : 0;
+		lanes.Bias[i] = m_BiasLUT[alpha ? ac.bias : cc.bias];
+		lanes.Halve[i] = m_ScaleRShiftLUT[shift] ? -1 : 0;
+		lanes.ClampMin[i] = clamp ? 0 : -1024;
+		lanes.ClampMax[i] = clamp ? 255 : 1023;
+	}
+	lanes.ColorHex = cc.hex;
+	lanes.AlphaHex = ac.hex;
+	lanes.Valid = true;
+}
+
+void Tev::DrawRegularCombiners(unsigned int stageNum, const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
+{
+	RegularCombinerLanes& lanes = m_RegularLanes[stageNum];
+	if (!lanes.Valid || lanes.ColorHex != cc.hex || lanes.AlphaHex != ac.hex)
+		UpdateRegularLanes(lanes, cc, ac);
+
+	s16 c[4];
+	for (int i = 0; i < 4; i++)
+		c[i] = inputs[i].c + (inputs[i].c >> 7);
+
+	// a * (256 - c) + b * c of all four lanes in one multiply-add
+	__m128i temp = _mm_madd_epi16(
+		_mm_setr_epi16(inputs[0].a, inputs[0].b, inputs[1].a, inputs[1].b, inputs[2].a, inputs[2].b, inputs[3].a, inputs[3].b),
+		_mm_setr_epi16(256 - c[0], c[0], 256 - c[1], c[1], 256 - c[2], c[2], 256 - c[3], c[3]));
+
+	// Left shifts by 0-2 bits per lane without variable shifts
+	const __m128i double_once = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.DoubleOnce));
+	const __m128i double_twice = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.DoubleTwice));
+	temp = _mm_add_epi32(temp, _mm_and_si128(temp, double_once));
+	temp = _mm_add_epi32(temp, _mm_and_si128(temp, double_twice));
+
+	temp = _mm_add_epi32(temp, _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.Round)));
+	const __m128i negate_before = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.NegateBefore));
+	temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_before), negate_before);
+	temp = _mm_srai_epi32(temp, 8);
+	const __m128i negate_after = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.NegateAfter));
+	temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_after), negate_after);
+
+	__m128i result = _mm_add_epi32(_mm_setr_epi32(inputs[0].d, inputs[1].d, inputs[2].d, inputs[3].d),
+		_mm_load_si128(reinterpret_cast<const __m128i*>(lanes.Bias)));
+	result = _mm_add_epi32(result, _mm_and_si128(result, double_once));
+	result = _mm_add_epi32(result, _mm_and_si128(result, double_twice));
+	result = _mm_add_epi32(result, temp);
+
+	const __m128i halve = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.Halve));
+	result = _mm_or_si128(_mm_andnot_si128(halve, result), _mm_and_si128(halve, _mm_srai_epi32(result, 1)));
+
+	// Results stay well inside 16 bits, so saturating matches the scalar truncation
+	__m128i packed = _mm_packs_epi32(result, result);
+	packed = _mm_max_epi16(packed, _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.ClampMin)));
+	packed = _mm_min_epi16(packed, _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.ClampMax)));
+
+	alignas(16) s16 output[8];
+	_mm_store_si128(reinterpret_cast<__m128i*>(output), packed);
+	Reg[cc.dest][BLU_C] = output[BLU_C];
+	Reg[cc.dest][GRN_C] = output[GRN_C];
+	Reg[cc.dest][RED_C] = output[RED_C];
+	Reg[ac.dest][ALP_C] = output[ALP_C];
+}
+#endif
+
 void Tev::DrawColorCompare(TevStageCombiner::ColorCombiner &cc, const InputRegType inputs[4])
 {
 	for (int i = BLU_C; i <= RED_C; i++)
@@ -511,7 +600,10 @@ void Tev::Draw()
 	_assert_(Position[0] >= 0 && Position[0] < EFB_WIDTH);
 	_assert_(Position[1] >= 0 && Position[1] < EFB_HEIGHT);
 
-	INCSTAT(stats.thisFrame.tevPixelsIn);
+	if (LocalCounters)
+		m_LocalPixelsIn++;
+	else
+		INCSTAT(stats.thisFrame.tevPixelsIn);
 
 	for (unsigned int stageNum = 0; stageNum < bpmem.genMode.numindstages.Value(); stageNum++)
 	{
@@ -605,33 +697,42 @@ void Tev::Draw()
 		inputs[ALP_C].c = *m_AlphaInputLUT[ac.c];
 		inputs[ALP_C].d = *m_AlphaInputLUT[ac.d];
 
-		if (cc.bias != 3)
-			DrawColorRegular(cc, inputs);
-		else
-			DrawColorCompare(cc, inputs);
-
-		if (cc.clamp)
+#ifdef _M_X86
+		if (cc.bias != 3 && ac.bias != 3)
 		{
-			Reg[cc.dest][RED_C] = Clamp255(Reg[cc.dest][RED_C]);
-			Reg[cc.dest][GRN_C] = Clamp255(Reg[cc.dest][GRN_C]);
-			Reg[cc.dest][BLU_C] = Clamp255(Reg[cc.dest][BLU_C]);
+			DrawRegularCombiners(stageNum, cc, ac, inputs);
 		}
 		else
+#endif
 		{
-			Reg[cc.dest][RED_C] = Clamp1024(Reg[cc.dest][RED_C]);
-			Reg[cc.dest][GRN_C] = Clamp1024(Reg[cc.dest][GRN_C]);
-			Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
-		}
+			if (cc.bias != 3)
+				DrawColorRegular(cc, inputs);
+			else
+				DrawColorCompare(cc, inputs);
 
-		if (ac.bias != 3)
-			DrawAlphaRegular(ac, inputs);
-		else
-			DrawAlphaCompare(ac, inputs);
+			if (cc.clamp)
+			{
+				Reg[cc.dest][RED_C] = Clamp255(Reg[cc.dest][RED_C]);
+				Reg[cc.dest][GRN_C] = Clamp255(Reg[cc.dest][GRN_C]);
+				Reg[cc.dest][BLU_C] = Clamp255(Reg[cc.dest][BLU_C]);
+			}
+			else
+			{
+				Reg[cc.dest][RED_C] = Clamp1024(Reg[cc.dest][RED_C]);
+				Reg[cc.dest][GRN_C] = Clamp1024(Reg[cc.dest][GRN_C]);
+				Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
+			}
 
-		if (ac.clamp)
-			Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
-		else
-			Reg[ac.dest][ALP_C] = Clamp1024(Reg[ac.dest][ALP_C]);
+			if (ac.bias != 3)
+				DrawAlphaRegular(ac, inputs);
+			else
+				DrawAlphaCompare(ac, inputs);
+
+			if (ac.clamp)
+				Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
+			else
+				Reg[ac.dest][ALP_C] = Clamp1024(Reg[ac.dest][ALP_C]);
+		}
 
 #if ALLOW_TEV_DUMPS
 		if (g_ActiveConfig.bDumpTevStages)
@@ -763,19 +864,20 @@ void Tev::Draw()
 		if (late_ztest && bpmem.zmode.testenable)
 		{
 			// TODO: Check against hw if these values get incremented even if depth testing is disabled
-			EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
+			IncPerfCounter(PQ_ZCOMP_INPUT);
 
 			if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
 				return;
 
-			EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
+			IncPerfCounter(PQ_ZCOMP_OUTPUT);
 		}
 	}
 	// branchless bounding box update
-	BoundingBox::coords[BoundingBox::LEFT] = std::min((u16)Position[0], BoundingBox::coords[BoundingBox::LEFT]);
-	BoundingBox::coords[BoundingBox::RIGHT] = std::max((u16)Position[0], BoundingBox::coords[BoundingBox::RIGHT]);
-	BoundingBox::coords[BoundingBox::TOP] = std::min((u16)Position[1], BoundingBox::coords[BoundingBox::TOP]);
-	BoundingBox::coords[BoundingBox::BOTTOM] = std::max((u16)Position[1], BoundingBox::coords[BoundingBox::BOTTOM]);
+	u16* bbox = LocalCounters ? m_LocalBBox : BoundingBox::coords;
+	bbox[BoundingBox::LEFT] = std::min((u16)Position[0], bbox[BoundingBox::LEFT]);
+	bbox[BoundingBox::RIGHT] = std::max((u16)Position[0], bbox[BoundingBox::RIGHT]);
+	bbox[BoundingBox::TOP] = std::min((u16)Position[1], bbox[BoundingBox::TOP]);
+	bbox[BoundingBox::BOTTOM] = std::max((u16)Position[1], bbox[BoundingBox::BOTTOM]);
 
 	// if we are only calculating the bounding box,
 	// there's no need to actually draw anything
@@ -802,8 +904,11 @@ void Tev::Draw()
 	}
 #endif
 
-	INCSTAT(stats.thisFrame.tevPixelsOut);
-	EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
+	if (LocalCounters)
+		m_LocalPixelsOut++;
+	else
+		INCSTAT(stats.thisFrame.tevPixelsOut);
+	IncPerfCounter(PQ_BLEND_INPUT);
 
 	EfbInterface::BlendTev(Position[0], Position[1], output);
 }
@@ -820,3 +925,39 @@ void Tev::SetRegColor(int reg, int comp, bool konst, s16 color)
 	}
 }
 
+void Tev::ResetLocalCounters()
+{
+	m_LocalBBox[BoundingBox::LEFT] = 0xFFFF;
+	m_LocalBBox[BoundingBox::RIGHT] = 0;
+	m_LocalBBox[BoundingBox::TOP] = 0xFFFF;
+	m_LocalBBox[BoundingBox::BOTTOM] = 0;
+	for (u32& pixels : m_LocalPerfPixels)
+		pixels = 0;
+	m_LocalPixelsIn = 0;
+	m_LocalPixelsOut = 0;
+}
+
+void Tev::IncPerfCounter(PerfQueryType type)
+{
+	if (LocalCounters)
+		m_LocalPerfPixels[type]++;
+	else
+		EfbInterface::IncPerfCounterQuadCount(type);
+}
+
+void Tev::MergeLocalCounters()
+{
+	for (int i = 0; i < PQ_NUM_MEMBERS; i++)
+		EfbInterface::AddPerfCounterPixels(static_cast<PerfQueryType>(i), m_LocalPerfPixels[i]);
+
+	BoundingBox::coords[BoundingBox::LEFT] = std::min(m_LocalBBox[BoundingBox::LEFT], BoundingBox::coords[BoundingBox::LEFT]);
+	BoundingBox::coords[BoundingBox::RIGHT] = std::max(m_LocalBBox[BoundingBox::RIGHT], BoundingBox::coords[BoundingBox::RIGHT]);
+	BoundingBox::coords[BoundingBox::TOP] = std::min(m_LocalBBox[BoundingBox::TOP], BoundingBox::coords[BoundingBox::TOP]);
+	BoundingBox::coords[BoundingBox::BOTTOM] = std::max(m_LocalBBox[BoundingBox::BOTTOM], BoundingBox::coords[BoundingBox::BOTTOM]);
+
+	ADDSTAT(stats.thisFrame.tevPixelsIn, m_LocalPixelsIn);
+	ADDSTAT(stats.thisFrame.tevPixelsOut, m_LocalPixelsOut);
+
+	ResetLocalCounters();
+}
+
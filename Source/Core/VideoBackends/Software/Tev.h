@@ -5,6 +5,7 @@
 #pragma once
 
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PerfQueryBase.h"
 
 class Tev
 {
@@ -66,6 +67,37 @@ class Tev
 
 	void Indirect(unsigned int stageNum, s32 s, s32 t);
 
+#ifdef _M_X86
+	// Per lane (ABGR) constants to run a stage's regular color and alpha combiners as one
+	// SSE2 operation, rebuilt whenever the stage's combiners change.
+	struct RegularCombinerLanes
+	{
+		alignas(16) s32 DoubleOnce[4];
+		alignas(16) s32 DoubleTwice[4];
+		alignas(16) s32 Round[4];
+		alignas(16) s32 NegateBefore[4];
+		alignas(16) s32 NegateAfter[4];
+		alignas(16) s32 Bias[4];
+		alignas(16) s32 Halve[4];
+		alignas(16) s16 ClampMin[8];
+		alignas(16) s16 ClampMax[8];
+		u32 ColorHex;
+		u32 AlphaHex;
+		bool Valid;
+	};
+	RegularCombinerLanes m_RegularLanes[16];
+
+	void UpdateRegularLanes(RegularCombinerLanes& lanes, const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac);
+	void DrawRegularCombiners(unsigned int stageNum, const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
+#endif
+
+	u16 m_LocalBBox[4];
+	u32 m_LocalPerfPixels[PQ_NUM_MEMBERS];
+	int m_LocalPixelsIn;
+	int m_LocalPixelsOut;
+
+	void ResetLocalCounters();
+
 public:
 	s32 Position[3];
 	u8 Color[2][4]; // must be RGBA for correct swap table ordering
@@ -88,4 +120,10 @@ public:
 	void Draw();
 
 	void SetRegColor(int reg, int comp, bool konst, s16 color);
+
+	// Tevs shading EFB tiles on worker threads keep the bounding box, perf and stat counts to
+	// themselves until MergeLocalCounters, none of them depend on the order pixels come in.
+	bool LocalCounters;
+	void IncPerfCounter(PerfQueryType type);
+	void MergeLocalCounters();
 };
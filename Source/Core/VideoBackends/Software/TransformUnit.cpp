@@ -6,6 +6,7 @@
 #include <cmath>
 
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/MathUtil.h"
 
 #include "VideoBackends/Software/NativeVertexFormat.h"
@@ -85,6 +86,79 @@ void TransformPosition(const InputVertexData *src, OutputVertexData *dst)
 	}
 }
 
+#ifdef _M_X86
+// One row of four position matrices times four positions, lane k holds vertex k. The products
+// are summed in the same order as MultiplyVec3Mat34 so the results match it bit for bit.
+static inline __m128 MultiplyRow4(const float* const mat[4], int row, __m128 x, __m128 y, __m128 z)
+{
+	const int i = row * 4;
+	__m128 result = _mm_mul_ps(_mm_setr_ps(mat[0][i], mat[1][i], mat[2][i], mat[3][i]), x);
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_setr_ps(mat[0][i + 1], mat[1][i + 1], mat[2][i + 1], mat[3][i + 1]), y));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_setr_ps(mat[0][i + 2], mat[1][i + 2], mat[2][i + 2], mat[3][i + 2]), z));
+	return _mm_add_ps(result, _mm_setr_ps(mat[0][i + 3], mat[1][i + 3], mat[2][i + 3], mat[3][i + 3]));
+}
+#endif
+
+void TransformPositions(const InputVertexData *src, OutputVertexData *dst, int count)
+{
+	int i = 0;
+#ifdef _M_X86
+	const float* proj = xfmem.projection.rawProjection;
+	const bool perspective = xfmem.projection.type == GX_PERSPECTIVE;
+	for (; i + 4 <= count; i += 4)
+	{
+		const InputVertexData* in = &src[i];
+		const float* mat[4] = {
+			&xfmem.posMatrices[in[0].posMtx * 4], &xfmem.posMatrices[in[1].posMtx * 4],
+			&xfmem.posMatrices[in[2].posMtx * 4], &xfmem.posMatrices[in[3].posMtx * 4]
+		};
+		const __m128 x = _mm_setr_ps(in[0].position.x, in[1].position.x, in[2].position.x, in[3].position.x);
+		const __m128 y = _mm_setr_ps(in[0].position.y, in[1].position.y, in[2].position.y, in[3].position.y);
+		const __m128 z = _mm_setr_ps(in[0].position.z, in[1].position.z, in[2].position.z, in[3].position.z);
+
+		const __m128 mvx = MultiplyRow4(mat, 0, x, y, z);
+		const __m128 mvy = MultiplyRow4(mat, 1, x, y, z);
+		const __m128 mvz = MultiplyRow4(mat, 2, x, y, z);
+
+		__m128 px, py, pz, pw;
+		if (perspective)
+		{
+			px = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[0]), mvx), _mm_mul_ps(_mm_set1_ps(proj[1]), mvz));
+			py = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[2]), mvy), _mm_mul_ps(_mm_set1_ps(proj[3]), mvz));
+			pz = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[4]), mvz), _mm_set1_ps(proj[5])), _mm_set1_ps(1.0f - (float)1e-7));
+			pw = _mm_xor_ps(mvz, _mm_set1_ps(-0.0f));
+		}
+		else
+		{
+			px = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[0]), mvx), _mm_set1_ps(proj[1]));
+			py = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[2]), mvy), _mm_set1_ps(proj[3]));
+			pz = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[4]), mvz), _mm_set1_ps(proj[5]));
+			pw = _mm_set1_ps(1.0f);
+		}
+
+		alignas(16) float out[7][4];
+		_mm_store_ps(out[0], mvx);
+		_mm_store_ps(out[1], mvy);
+		_mm_store_ps(out[2], mvz);
+		_mm_store_ps(out[3], px);
+		_mm_store_ps(out[4], py);
+		_mm_store_ps(out[5], pz);
+		_mm_store_ps(out[6], pw);
+		for (int k = 0; k < 4; k++)
+		{
+			OutputVertexData& vertex = dst[i + k];
+			vertex.mvPosition.set(out[0][k], out[1][k], out[2][k]);
+			vertex.projectedPosition.x = out[3][k];
+			vertex.projectedPosition.y = out[4][k];
+			vertex.projectedPosition.z = out[5][k];
+			vertex.projectedPosition.w = out[6][k];
+		}
+	}
+#endif
+	for (; i < count; i++)
+		TransformPosition(&src[i], &dst[i]);
+}
+
 void TransformNormal(const InputVertexData *src, bool nbt, OutputVertexData *dst)
 {
 	const float* mat = &xfmem.normalMatrices[(src->posMtx & 31) * 3];
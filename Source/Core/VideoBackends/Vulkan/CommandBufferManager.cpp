@@ -15,7 +15,8 @@
 namespace Vulkan
 {
 CommandBufferManager::CommandBufferManager(bool use_threaded_submission)
-	: m_submit_semaphore(1, 1), m_use_threaded_submission(use_threaded_submission)
+	: m_submit_semaphore(MAX_PENDING_SUBMITS, MAX_PENDING_SUBMITS),
+	m_use_threaded_submission(use_threaded_submission)
 {
 }
 
@@ -25,7 +26,7 @@ CommandBufferManager::~CommandBufferManager()
 	if (m_use_threaded_submission)
 	{
 		// Wait for all command buffers to be consumed by the worker thread.
-		m_submit_semaphore.Wait();
+		WaitForWorkerThreadIdle();
 		m_submit_loop->Stop();
 		m_submit_thread.join();
 	}
@@ -40,6 +41,9 @@ bool CommandBufferManager::Initialize()
 	if (!CreateCommandBuffers())
 		return false;
 
+	// Timing is optional, it only feeds dynamic resolution.
+	CreateTimestampQueries();
+
 	if (m_use_threaded_submission && !CreateSubmitThread())
 		return false;
 
@@ -115,10 +119,54 @@ bool CommandBufferManager::CreateCommandBuffers()
 	return true;
 }
 
+bool CommandBufferManager::CreateTimestampQueries()
+{
+	if (g_vulkan_context->GetGraphicsQueueProperties().timestampValidBits == 0 ||
+		g_vulkan_context->GetDeviceLimits().timestampPeriod <= 0.0f)
+	{
+		return false;
+	}
+
+	VkQueryPoolCreateInfo info = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0,
+		VK_QUERY_TYPE_TIMESTAMP, static_cast<uint32_t>(NUM_COMMAND_BUFFERS * 2), 0 };
+	VkResult res =
+		vkCreateQueryPool(g_vulkan_context->GetDevice(), &info, nullptr, &m_timestamp_query_pool);
+	if (res != VK_SUCCESS)
+	{
+		LOG_VULKAN_ERROR(res, "vkCreateQueryPool failed: ");
+		m_timestamp_query_pool = VK_NULL_HANDLE;
+		return false;
+	}
+
+	// The command buffer activated during creation has no timestamps written yet.
+	VkCommandBuffer command_buffer = GetCurrentCommandBuffer();
+	vkCmdResetQueryPool(command_buffer, m_timestamp_query_pool,
+		static_cast<uint32_t>(m_current_frame * 2), 2);
+	vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestamp_query_pool,
+		static_cast<uint32_t>(m_current_frame * 2));
+	return true;
+}
+
+double CommandBufferManager::TakeGPUTime()
+{
+	if (m_timestamp_query_pool == VK_NULL_HANDLE)
+		return -1.0;
+
+	double time = m_gpu_time_ms;
+	m_gpu_time_ms = 0.0;
+	return time;
+}
+
 void CommandBufferManager::DestroyCommandBuffers()
 {
 	VkDevice device = g_vulkan_context->GetDevice();
 
+	if (m_timestamp_query_pool != VK_NULL_HANDLE)
+	{
+		vkDestroyQueryPool(device, m_timestamp_query_pool, nullptr);
+		m_timestamp_query_pool = VK_NULL_HANDLE;
+	}
+
 	for (FrameResources& resources : m_frame_resources)
 	{
 		for (auto& it : resources.cleanup_resources)
@@ -199,16 +247,18 @@ bool CommandBufferManager::CreateSubmitThread()
 void CommandBufferManager::PrepareToSubmitCommandBuffer()
 {
 	// Grab the semaphore before submitting command buffer either on-thread or off-thread.
-	// This prevents a race from occurring where a second command buffer is executed
-	// before the worker thread has woken and executed the first one yet.
+	// This keeps the worker thread at most MAX_PENDING_SUBMITS buffers behind, so the buffer
+	// we activate next has always been submitted before we wait on its fence.
 	m_submit_semaphore.Wait();
 }
 
 void CommandBufferManager::WaitForWorkerThreadIdle()
 {
-	// Drain the semaphore, then allow another request in the future.
-	m_submit_semaphore.Wait();
-	m_submit_semaphore.Post();
+	// Drain the semaphore, then allow further requests in the future.
+	for (size_t i = 0; i < MAX_PENDING_SUBMITS; i++)
+		m_submit_semaphore.Wait();
+	for (size_t i = 0; i < MAX_PENDING_SUBMITS; i++)
+		m_submit_semaphore.Post();
 }
 
 void CommandBufferManager::WaitForGPUIdle()
@@ -257,6 +307,12 @@ void CommandBufferManager::SubmitCommandBuffer(bool submit_on_worker_thread,
 	for (const auto& iter : m_fence_point_callbacks)
 		iter.second.first(resources.command_buffers[1], resources.fence);
 
+	if (m_timestamp_query_pool != VK_NULL_HANDLE)
+	{
+		vkCmdWriteTimestamp(resources.command_buffers[1], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+			m_timestamp_query_pool, static_cast<uint32_t>(m_current_frame * 2 + 1));
+	}
+
 	// End the current command buffer.
 	for (VkCommandBuffer command_buffer : resources.command_buffers)
 	{
@@ -369,6 +425,20 @@ void CommandBufferManager::OnCommandBufferExecuted(size_t index)
 	for (const auto& iter : m_fence_point_callbacks)
 		iter.second.second(resources.fence);
 
+	// The fence has signaled so the results are there, no need to wait on them.
+	if (m_timestamp_query_pool != VK_NULL_HANDLE)
+	{
+		std::array<u64, 2> timestamps;
+		VkResult res = vkGetQueryPoolResults(g_vulkan_context->GetDevice(), m_timestamp_query_pool,
+			static_cast<uint32_t>(index * 2), 2, sizeof(timestamps), timestamps.data(), sizeof(u64),
+			VK_QUERY_RESULT_64_BIT);
+		if (res == VK_SUCCESS && timestamps[1] > timestamps[0])
+		{
+			m_gpu_time_ms += (timestamps[1] - timestamps[0]) *
+				g_vulkan_context->GetDeviceLimits().timestampPeriod / 1000000.0;
+		}
+	}
+
 	// Clean up all objects pending destruction on this command buffer
 	for (auto& it : resources.cleanup_resources)
 		it();
@@ -412,6 +482,14 @@ void CommandBufferManager::ActivateCommandBuffer()
 			LOG_VULKAN_ERROR(res, "vkBeginCommandBuffer failed: ");
 	}
 
+	if (m_timestamp_query_pool != VK_NULL_HANDLE)
+	{
+		vkCmdResetQueryPool(resources.command_buffers[1], m_timestamp_query_pool,
+			static_cast<uint32_t>(m_current_frame * 2), 2);
+		vkCmdWriteTimestamp(resources.command_buffers[1], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			m_timestamp_query_pool, static_cast<uint32_t>(m_current_frame * 2));
+	}
+
 	// Also can do the same for the descriptor pools
 	res = vkResetDescriptorPool(g_vulkan_context->GetDevice(), resources.descriptor_pool, 0);
 	if (res != VK_SUCCESS)
@@ -427,7 +505,7 @@ void CommandBufferManager::ExecuteCommandBuffer(bool submit_off_thread, bool wai
 
 	// If we're waiting for completion, don't bother waking the worker thread.
 	PrepareToSubmitCommandBuffer();
-	SubmitCommandBuffer((submit_off_thread && wait_for_completion));
+	SubmitCommandBuffer(submit_off_thread && !wait_for_completion);
 	ActivateCommandBuffer();
 
 	if (wait_for_completion)
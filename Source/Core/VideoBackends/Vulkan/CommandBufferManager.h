@@ -98,9 +98,14 @@ public:
 
 	void RemoveFencePointCallback(const void* key);
 
+	// Returns the GPU time spent executing draw command buffers that completed since the last
+	// call, in milliseconds. Negative when the device can't provide timestamps.
+	double TakeGPUTime();
+
 private:
 	bool CreateCommandBuffers();
 	void DestroyCommandBuffers();
+	bool CreateTimestampQueries();
 
 	bool CreateSubmitThread();
 
@@ -125,6 +130,10 @@ private:
 	std::array<FrameResources, NUM_COMMAND_BUFFERS> m_frame_resources = {};
 	size_t m_current_frame;
 
+	// Two timestamps per command buffer, written at the start and the end of the draw buffer.
+	VkQueryPool m_timestamp_query_pool = VK_NULL_HANDLE;
+	double m_gpu_time_ms = 0.0;
+
 	// callbacks when a fence point is set
 	std::map<const void*, std::pair<CommandBufferQueuedCallback, CommandBufferExecutedCallback>>
 		m_fence_point_callbacks;
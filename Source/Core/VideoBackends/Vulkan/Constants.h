@@ -12,9 +12,13 @@
 
 namespace Vulkan
 {
-// Number of command buffers. Having two allows one buffer to be
-// executed whilst another is being built.
-constexpr size_t NUM_COMMAND_BUFFERS = 2;
+// Number of command buffers. Having three allows one buffer to be executed whilst another
+// is waiting on the submit thread and a third one is being built.
+constexpr size_t NUM_COMMAND_BUFFERS = 3;
+
+// Command buffers that can be queued for the submit thread at once. The buffer after them
+// in the ring must have been submitted, as it is the next one we wait on and reset.
+constexpr size_t MAX_PENDING_SUBMITS = NUM_COMMAND_BUFFERS - 1;
 
 // Staging buffer usage - optimize for uploads or readbacks
 enum STAGING_BUFFER_TYPE
@@ -79,6 +83,7 @@ enum UNIFORM_BUFFER_DESCRIPTOR_SET_BINDING
 	UBO_DESCRIPTOR_SET_BINDING_PS,
 	UBO_DESCRIPTOR_SET_BINDING_VS,
 	UBO_DESCRIPTOR_SET_BINDING_GS,
+	UBO_DESCRIPTOR_SET_BINDING_UBER,
 	NUM_UBO_DESCRIPTOR_SET_BINDINGS
 };
 
@@ -257,6 +257,7 @@ bool FramebufferManager::CreateEFBFramebuffer()
 		return false;
 
 	// Create resolved textures if MSAA is on
+	InvalidateResolvedEFB();
 	if (m_efb_samples != VK_SAMPLE_COUNT_1_BIT)
 	{
 		m_efb_resolve_color_texture = Texture2D::Create(
@@ -409,6 +410,7 @@ void FramebufferManager::RecompileShaders()
 
 void FramebufferManager::ReinterpretPixelData(int convtype)
 {
+	InvalidateResolvedEFB();
 	VkShaderModule pixel_shader = VK_NULL_HANDLE;
 	if (convtype == 0)
 	{
@@ -452,6 +454,19 @@ void FramebufferManager::ReinterpretPixelData(int convtype)
 	std::swap(m_efb_framebuffer, m_efb_convert_framebuffer);
 }
 
+static bool ContainsRegion(const VkRect2D& outer, const VkRect2D& inner)
+{
+	return inner.offset.x >= outer.offset.x && inner.offset.y >= outer.offset.y &&
+		inner.offset.x + inner.extent.width <= outer.offset.x + outer.extent.width &&
+		inner.offset.y + inner.extent.height <= outer.offset.y + outer.extent.height;
+}
+
+void FramebufferManager::InvalidateResolvedEFB()
+{
+	m_efb_resolved_color_valid = false;
+	m_efb_resolved_depth_valid = false;
+}
+
 Texture2D* FramebufferManager::ResolveEFBColorTexture(const VkRect2D& region)
 {
 	// Return the normal EFB texture if multisampling is off.
@@ -461,6 +476,10 @@ Texture2D* FramebufferManager::ResolveEFBColorTexture(const VkRect2D& region)
 	// Can't resolve within a render pass.
 	StateTracker::GetInstance()->EndRenderPass();
 
+	// Nothing was drawn since this region was last resolved.
+	if (m_efb_resolved_color_valid && ContainsRegion(m_efb_resolved_color_region, region))
+		return m_efb_resolve_color_texture.get();
+
 	// It's not valid to resolve out-of-bounds coordinates.
 	// Ensuring the region is within the image is the caller's responsibility.
 	_assert_(region.offset.x >= 0 && region.offset.y >= 0 &&
@@ -489,6 +508,8 @@ Texture2D* FramebufferManager::ResolveEFBColorTexture(const VkRect2D& region)
 	// Restore MSAA texture ready for rendering again
 	m_efb_color_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
 		VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	m_efb_resolved_color_region = region;
+	m_efb_resolved_color_valid = true;
 	return m_efb_resolve_color_texture.get();
 }
 
@@ -501,6 +522,9 @@ Texture2D* FramebufferManager::ResolveEFBDepthTexture(const VkRect2D& region)
 	// Can't resolve within a render pass.
 	StateTracker::GetInstance()->EndRenderPass();
 
+	if (m_efb_resolved_depth_valid && ContainsRegion(m_efb_resolved_depth_region, region))
+		return m_efb_resolve_depth_texture.get();
+
 	m_efb_depth_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
 		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
@@ -522,6 +546,8 @@ Texture2D* FramebufferManager::ResolveEFBDepthTexture(const VkRect2D& region)
 
 	// Render pass transitions to shader resource.
 	m_efb_resolve_depth_texture->OverrideImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	m_efb_resolved_depth_region = region;
+	m_efb_resolved_depth_valid = true;
 	return m_efb_resolve_depth_texture.get();
 }
 
@@ -1150,6 +1176,7 @@ void FramebufferManager::DrawPokeVertices(const EFBPokeVertex* vertices, size_t
 {
 	// Relatively simple since we don't have any bindings.
 	VkCommandBuffer command_buffer = g_command_buffer_mgr->GetCurrentCommandBuffer();
+	InvalidateResolvedEFB();
 
 	// We don't use the utility shader in order to keep the vertices compact.
 	PipelineInfo pipeline_info = {};
@@ -65,6 +65,9 @@ public:
 	// Resolve color/depth textures to a non-msaa texture, and return it.
 	Texture2D* ResolveEFBColorTexture(const VkRect2D& region);
 	Texture2D* ResolveEFBDepthTexture(const VkRect2D& region);
+	// Resolved regions are reused until the EFB is written again, this must be called whenever
+	// that happens.
+	void InvalidateResolvedEFB();
 
 	// Returns the texture that the EFB color texture is resolved to when multisampling is enabled.
 	// Ensure ResolveEFBColorTexture is called before this method.
@@ -132,6 +135,10 @@ private:
 	std::unique_ptr<Texture2D> m_efb_depth_texture;
 	std::unique_ptr<Texture2D> m_efb_resolve_color_texture;
 	std::unique_ptr<Texture2D> m_efb_resolve_depth_texture;
+	VkRect2D m_efb_resolved_color_region = {};
+	VkRect2D m_efb_resolved_depth_region = {};
+	bool m_efb_resolved_color_valid = false;
+	bool m_efb_resolved_depth_valid = false;
 	VkFramebuffer m_efb_framebuffer = VK_NULL_HANDLE;
 	VkFramebuffer m_efb_convert_framebuffer = VK_NULL_HANDLE;
 	VkFramebuffer m_depth_resolve_framebuffer = VK_NULL_HANDLE;
@@ -9,8 +9,11 @@
 #include <type_traits>
 #include <xxhash.h>
 
+#include "Common/CPUDetect.h"
 #include "Common/CommonFuncs.h"
 #include "Common/LinearDiskCache.h"
+#include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Core/ConfigManager.h"
 #include "Core/Host.h"
 
@@ -20,6 +23,7 @@
 #include "VideoBackends/Vulkan/VertexFormat.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/UberShaderCommon.h"
 
 namespace Vulkan
 {
@@ -35,6 +39,10 @@ static_assert(std::is_trivially_copyable<PipelineInfo>::value,
 
 std::unique_ptr<ObjectCache> g_object_cache;
 
+// Number of the most used shaders from the usage profile that have to be compiled
+// before the game starts. The rest is compiled on the thread pool in the background.
+static constexpr size_t STARTUP_BLOCKING_SHADER_COUNT = 256;
+
 ObjectCache::ObjectCache()
 {
 }
@@ -170,7 +178,7 @@ GetVulkanColorBlendState(const BlendState& state,
 	return vk_state;
 }
 
-VkPipeline ObjectCache::CreatePipeline(const PipelineInfo& info)
+VkPipeline ObjectCache::CreatePipeline(const PipelineInfo& info, VkPipeline base_pipeline)
 {
 	// Declare descriptors for empty vertex buffers/attributes
 	static const VkPipelineVertexInputStateCreateInfo empty_vertex_input_state = {
@@ -262,11 +270,17 @@ VkPipeline ObjectCache::CreatePipeline(const PipelineInfo& info)
 		dynamic_states  // const VkDynamicState*                pDynamicStates
 	};
 
+	// Every pipeline can serve as the base for the other pipelines using the same shaders, which
+	// only differ in fixed function state.
+	VkPipelineCreateFlags flags = VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+	if (base_pipeline != VK_NULL_HANDLE)
+		flags |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+
 	// Combine to full pipeline info structure.
 	VkGraphicsPipelineCreateInfo pipeline_info = {
 		VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
 		nullptr,                // VkStructureType sType
-		0,                      // VkPipelineCreateFlags                            flags
+		flags,                  // VkPipelineCreateFlags                            flags
 		num_shader_stages,      // uint32_t                                         stageCount
 		shader_stages,          // const VkPipelineShaderStageCreateInfo*           pStages
 		&vertex_input_state,    // const VkPipelineVertexInputStateCreateInfo*      pVertexInputState
@@ -281,7 +295,7 @@ VkPipeline ObjectCache::CreatePipeline(const PipelineInfo& info)
 		info.pipeline_layout,  // VkPipelineLayout                                 layout
 		info.render_pass,      // VkRenderPass                                     renderPass
 		0,                     // uint32_t                                         subpass
-		VK_NULL_HANDLE,        // VkPipeline                                       basePipelineHandle
+		base_pipeline,         // VkPipeline                                       basePipelineHandle
 		-1                     // int32_t                                          basePipelineIndex
 	};
 
@@ -303,15 +317,100 @@ VkPipeline ObjectCache::GetPipeline(const PipelineInfo& info)
 
 std::pair<VkPipeline, bool> ObjectCache::GetPipelineWithCacheResult(const PipelineInfo& info)
 {
-	auto iter = m_pipeline_objects.find(info);
-	if (iter != m_pipeline_objects.end())
-		return{ iter->second, true };
+	auto shaders = std::make_tuple(info.vs, info.gs, info.ps);
+	VkPipeline base_pipeline = VK_NULL_HANDLE;
+	{
+		std::lock_guard<std::mutex> lock(m_pipeline_lock);
+		auto iter = m_pipeline_objects.find(info);
+		if (iter != m_pipeline_objects.end())
+			return{ iter->second, true };
+
+		auto base_iter = m_base_pipelines.find(shaders);
+		if (base_iter != m_base_pipelines.end())
+			base_pipeline = base_iter->second;
+	}
+
+	// Created outside of the lock, the workers precaching pipelines use this too.
+	VkPipeline pipeline = CreatePipeline(info, base_pipeline);
 
-	VkPipeline pipeline = CreatePipeline(info);
-	m_pipeline_objects.emplace(info, pipeline);
+	std::lock_guard<std::mutex> lock(m_pipeline_lock);
+	auto result = m_pipeline_objects.emplace(info, pipeline);
+	if (!result.second)
+	{
+		// Another thread was faster.
+		if (pipeline != VK_NULL_HANDLE)
+			vkDestroyPipeline(g_vulkan_context->GetDevice(), pipeline, nullptr);
+		return{ result.first->second, true };
+	}
+	if (pipeline != VK_NULL_HANDLE && base_pipeline == VK_NULL_HANDLE)
+		m_base_pipelines.emplace(shaders, pipeline);
 	return{ pipeline, false };
 }
 
+void ObjectCache::PrecachePipelineAsync(const PipelineInfo& info, const VertexShaderUid& vs_uid,
+	const GeometryShaderUid* gs_uid, const PixelShaderUid& ps_uid)
+{
+	// The shader maps are only accessed from the GPU thread, so look up the items here
+	// and leave compiling the shaders to the worker.
+	PrecachedPipeline pipeline = { info, vs_uid, gs_uid ? *gs_uid : GeometryShaderUid(), ps_uid,
+		&m_vs_cache.shader_map->GetOrAdd(vs_uid),
+		gs_uid ? &m_gs_cache.shader_map->GetOrAdd(*gs_uid) : nullptr,
+		&m_ps_cache.shader_map->GetOrAdd(ps_uid) };
+
+	m_pending_pipelines++;
+	QueueAsyncShader([this, pipeline]() { CreatePrecachedPipeline(pipeline); });
+}
+
+void ObjectCache::CreatePrecachedPipeline(const PrecachedPipeline& pipeline)
+{
+	bool ready = true;
+	if (!pipeline.vs_item->initialized.test_and_set())
+		CompileVertexShaderForUid(pipeline.vs_uid, *pipeline.vs_item);
+	else
+		ready &= pipeline.vs_item->compiled.load();
+	if (pipeline.gs_item)
+	{
+		if (!pipeline.gs_item->initialized.test_and_set())
+			CompileGeometryShaderForUid(pipeline.gs_uid, *pipeline.gs_item);
+		else
+			ready &= pipeline.gs_item->compiled.load();
+	}
+	if (!pipeline.ps_item->initialized.test_and_set())
+		CompilePixelShaderForUid(pipeline.ps_uid, *pipeline.ps_item);
+	else
+		ready &= pipeline.ps_item->compiled.load();
+
+	// A shader claimed elsewhere may still be waiting in the queue behind us, so go to the
+	// back of the queue instead of blocking the worker on it.
+	if (!ready)
+	{
+		Common::YieldCPU();
+		QueueAsyncShader([this, pipeline]() { CreatePrecachedPipeline(pipeline); });
+		return;
+	}
+
+	PipelineInfo info = pipeline.info;
+	info.vs = pipeline.vs_item->module;
+	info.gs = pipeline.gs_item ? pipeline.gs_item->module : VK_NULL_HANDLE;
+	info.ps = pipeline.ps_item->module;
+	if (info.vs == VK_NULL_HANDLE || info.ps == VK_NULL_HANDLE ||
+		(pipeline.gs_item && info.gs == VK_NULL_HANDLE))
+	{
+		WARN_LOG(VIDEO, "Failed to get shaders from cached pipeline UID.");
+	}
+	else if (GetPipeline(info) == VK_NULL_HANDLE)
+	{
+		WARN_LOG(VIDEO, "Failed to get pipeline from cached UID.");
+	}
+	m_pending_pipelines--;
+}
+
+void ObjectCache::WaitForPrecachedPipelines()
+{
+	while (m_pending_pipelines.load() > 0)
+		Common::YieldCPU();
+}
+
 VkPipeline ObjectCache::CreateComputePipeline(const ComputePipelineInfo& info)
 {
 	VkComputePipelineCreateInfo pipeline_info = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
@@ -349,12 +448,15 @@ VkPipeline ObjectCache::GetComputePipeline(const ComputePipelineInfo& info)
 
 void ObjectCache::ClearPipelineCache()
 {
+	WaitForPrecachedPipelines();
+	std::lock_guard<std::mutex> lock(m_pipeline_lock);
 	for (const auto& it : m_pipeline_objects)
 	{
 		if (it.second != VK_NULL_HANDLE)
 			vkDestroyPipeline(g_vulkan_context->GetDevice(), it.second, nullptr);
 	}
 	m_pipeline_objects.clear();
+	m_base_pipelines.clear();
 
 	for (const auto& it : m_compute_pipeline_objects)
 	{
@@ -613,66 +715,84 @@ void ObjectCache::LoadShaderCaches()
 
 	if (g_ActiveConfig.bCompileShaderOnStartup)
 	{
-		int shader_count = 0;
+		std::vector<StartupShader> vs_shaders, ps_shaders, gs_shaders;
+		auto not_compiled = [](vkShaderItem& entry)
+		{
+			return !entry.compiled;
+		};
 		m_vs_cache.shader_map->ForEachMostUsedByCategory(gameid,
 			[&](const VertexShaderUid& uid, size_t total)
 		{
 			VertexShaderUid item = uid;
 			item.ClearHASH();
 			item.CalculateUIDHash();
-			vkShaderItem& it = m_vs_cache.shader_map->GetOrAdd(item);
-			if (!it.initialized.test_and_set())
-			{
-				Host_UpdateTitle(StringFromFormat("Compiling Vertex Shaders %i %% (%i/%i)", (shader_count * 100) / total, shader_count, total));
-				CompileVertexShaderForUid(item, it);
-			}
-		},
-			[](vkShaderItem& entry)
-		{
-			return !entry.compiled;
-		}
-		, true);
-		shader_count = 0;
+			vkShaderItem* it = &m_vs_cache.shader_map->GetOrAdd(item);
+			vs_shaders.push_back({ it, [this, item, it]() { CompileVertexShaderForUid(item, *it); } });
+		}, not_compiled, true);
 		m_ps_cache.shader_map->ForEachMostUsedByCategory(gameid,
 			[&](const PixelShaderUid& uid, size_t total)
 		{
 			PixelShaderUid item = uid;
 			item.ClearHASH();
 			item.CalculateUIDHash();
-			vkShaderItem& it = m_ps_cache.shader_map->GetOrAdd(item);
-			if (!it.initialized.test_and_set())
-			{
-				Host_UpdateTitle(StringFromFormat("Compiling Pixel Shaders %i %% (%i/%i)", (shader_count * 100) / total, shader_count, total));
-				CompilePixelShaderForUid(item, it);
-			}
-		},
-			[](vkShaderItem& entry)
-		{
-			return !entry.compiled;
-		}
-		, true);
-
+			vkShaderItem* it = &m_ps_cache.shader_map->GetOrAdd(item);
+			ps_shaders.push_back({ it, [this, item, it]() { CompilePixelShaderForUid(item, *it); } });
+		}, not_compiled, true);
 		if (g_vulkan_context->SupportsGeometryShaders())
 		{
-			shader_count = 0;
 			m_gs_cache.shader_map->ForEachMostUsedByCategory(gameid,
 				[&](const GeometryShaderUid& uid, size_t total)
 			{
 				GeometryShaderUid item = uid;
 				item.ClearHASH();
 				item.CalculateUIDHash();
-				vkShaderItem& it = m_gs_cache.shader_map->GetOrAdd(item);
-				if (!it.initialized.test_and_set())
+				vkShaderItem* it = &m_gs_cache.shader_map->GetOrAdd(item);
+				gs_shaders.push_back({ it, [this, item, it]() { CompileGeometryShaderForUid(item, *it); } });
+			}, not_compiled, true);
+		}
+
+		// Interleave the stages so the most used shaders of every stage come first.
+		size_t stage_max = std::max(vs_shaders.size(), std::max(ps_shaders.size(), gs_shaders.size()));
+		m_startup_shaders.reserve(vs_shaders.size() + ps_shaders.size() + gs_shaders.size());
+		for (size_t i = 0; i < stage_max; i++)
+		{
+			if (i < vs_shaders.size())
+				m_startup_shaders.push_back(std::move(vs_shaders[i]));
+			if (i < ps_shaders.size())
+				m_startup_shaders.push_back(std::move(ps_shaders[i]));
+			if (i < gs_shaders.size())
+				m_startup_shaders.push_back(std::move(gs_shaders[i]));
+		}
+		m_startup_next = 0;
+
+		if (!m_startup_shaders.empty())
+		{
+			// The pool threads keep going through the list while the game runs, shaders
+			// they have not reached yet are compiled on demand as before.
+			int workers = std::max(cpu_info.logical_cpu_count - 1, 1);
+			for (int i = 0; i < workers; i++)
+			{
+				m_startup_workers++;
+				Common::AsyncWorker::ExecuteAsync([this]()
 				{
-					Host_UpdateTitle(StringFromFormat("Compiling Geometry Shaders %i %% (%i/%i)", (shader_count * 100) / total, shader_count, total));
-					CompileGeometryShaderForUid(item, it);
-				}
-			},
-				[](vkShaderItem& entry)
+					while (CompileNextStartupShader()) {}
+					m_startup_workers--;
+				});
+			}
+
+			// Only the most used shaders have to be ready before the game starts.
+			size_t blocking = std::min(m_startup_shaders.size(), STARTUP_BLOCKING_SHADER_COUNT);
+			while (m_startup_next.load() < blocking && CompileNextStartupShader())
+			{
+				size_t count = std::min(m_startup_next.load(), blocking);
+				Host_UpdateTitle(StringFromFormat("Compiling Shaders %i %% (%i/%i)",
+					static_cast<int>((count * 100) / blocking), static_cast<int>(count), static_cast<int>(blocking)));
+			}
+			for (size_t i = 0; i < blocking; i++)
 			{
-				return !entry.compiled;
+				while (!m_startup_shaders[i].item->compiled.load())
+					Common::YieldCPU();
 			}
-			, true);
 		}
 	}
 
@@ -694,13 +814,87 @@ static void DestroyShaderCache(T& cache)
 	cache.shader_map.reset();
 }
 
+bool ObjectCache::CompileNextStartupShader()
+{
+	size_t index = m_startup_next.fetch_add(1);
+	if (index >= m_startup_shaders.size())
+		return false;
+
+	// The game may have asked for the shader already.
+	StartupShader& shader = m_startup_shaders[index];
+	if (!shader.item->initialized.test_and_set())
+		shader.compile();
+	return true;
+}
+
+void ObjectCache::CancelStartupShaders()
+{
+	m_startup_next = m_startup_shaders.size();
+	while (m_startup_workers.load() > 0)
+		Common::YieldCPU();
+	m_startup_shaders.clear();
+}
+
+void ObjectCache::QueueAsyncShader(std::function<void()>&& compile)
+{
+	std::lock_guard<std::mutex> lock(m_async_shaders_lock);
+	m_async_shaders.push_back(std::move(compile));
+
+	// The workers keep draining the queue until it is empty, so only start
+	// new ones while we are below one per spare core.
+	if (m_async_workers.load() >= std::max(cpu_info.logical_cpu_count - 1, 1))
+		return;
+
+	m_async_workers++;
+	Common::AsyncWorker::ExecuteAsync([this]()
+	{
+		std::unique_lock<std::mutex> worker_lock(m_async_shaders_lock);
+		while (!m_async_shaders.empty())
+		{
+			std::function<void()> next = std::move(m_async_shaders.front());
+			m_async_shaders.pop_front();
+			worker_lock.unlock();
+			next();
+			worker_lock.lock();
+		}
+		m_async_workers--;
+	});
+}
+
+void ObjectCache::CancelAsyncShaders()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_async_shaders_lock);
+		m_async_shaders.clear();
+	}
+	while (m_async_workers.load() > 0)
+		Common::YieldCPU();
+	m_pending_pipelines = 0;
+}
+
+template <typename T>
+static void DestroyUberShaderCache(T& cache)
+{
+	for (const auto& it : cache)
+	{
+		if (it.second != VK_NULL_HANDLE)
+			vkDestroyShaderModule(g_vulkan_context->GetDevice(), it.second, nullptr);
+	}
+	cache.clear();
+}
+
 void ObjectCache::DestroyShaderCaches()
 {
+	CancelStartupShaders();
+	CancelAsyncShaders();
 	DestroyShaderCache(m_vs_cache);
 	DestroyShaderCache(m_ps_cache);
 
 	if (g_vulkan_context->SupportsGeometryShaders())
 		DestroyShaderCache(m_gs_cache);
+
+	DestroyUberShaderCache(m_uber_vs_cache);
+	DestroyUberShaderCache(m_uber_ps_cache);
 }
 
 void ObjectCache::CompileVertexShaderForUid(const VertexShaderUid& uid, ObjectCache::vkShaderItem& it)
@@ -709,6 +903,8 @@ void ObjectCache::CompileVertexShaderForUid(const VertexShaderUid& uid, ObjectCa
 	ShaderCompiler::SPIRVCodeVector spv;
 	VkShaderModule module = VK_NULL_HANDLE;
 	ShaderCode source_code;
+	// The generators only fall back to their static buffer when none is set.
+	source_code.SetBuffer(GetShaderCodeBuffer(ShaderCodeBuffer::Vertex, VERTEXSHADERGEN_BUFFERSIZE));
 	GenerateVertexShaderCodeVulkan(source_code, uid.GetUidData());
 	if (ShaderCompiler::CompileVertexShader(&spv, source_code.GetBuffer(),
 		source_code.BufferSize()))
@@ -718,14 +914,15 @@ void ObjectCache::CompileVertexShaderForUid(const VertexShaderUid& uid, ObjectCa
 		// Append to shader cache if it created successfully.
 		if (module != VK_NULL_HANDLE)
 		{
+			std::lock_guard<std::mutex> lock(m_vs_cache.disk_cache_lock);
 			m_vs_cache.disk_cache.Append(uid, spv.data(), static_cast<u32>(spv.size()));
 			INCSTAT(stats.numVertexShadersCreated);
 			INCSTAT(stats.numVertexShadersAlive);
 		}
 	}
-	it.compiled = true;
 	// We still insert null entries to prevent further compilation attempts.
 	it.module = module;
+	it.compiled = true;
 }
 void ObjectCache::CompileGeometryShaderForUid(const GeometryShaderUid& uid, ObjectCache::vkShaderItem& it)
 {
@@ -733,6 +930,8 @@ void ObjectCache::CompileGeometryShaderForUid(const GeometryShaderUid& uid, Obje
 	ShaderCompiler::SPIRVCodeVector spv;
 	VkShaderModule module = VK_NULL_HANDLE;
 	ShaderCode source_code;
+	// The generators only fall back to their static buffer when none is set.
+	source_code.SetBuffer(GetShaderCodeBuffer(ShaderCodeBuffer::Geometry, GEOMETRYSHADERGEN_BUFFERSIZE));
 	GenerateGeometryShaderCode(source_code, uid.GetUidData(), API_VULKAN);
 	if (ShaderCompiler::CompileGeometryShader(&spv, source_code.GetBuffer(),
 		source_code.BufferSize()))
@@ -741,11 +940,14 @@ void ObjectCache::CompileGeometryShaderForUid(const GeometryShaderUid& uid, Obje
 
 		// Append to shader cache if it created successfully.
 		if (module != VK_NULL_HANDLE)
+		{
+			std::lock_guard<std::mutex> lock(m_gs_cache.disk_cache_lock);
 			m_gs_cache.disk_cache.Append(uid, spv.data(), static_cast<u32>(spv.size()));
+		}
 	}
-	it.compiled = true;
 	// We still insert null entries to prevent further compilation attempts.
 	it.module = module;
+	it.compiled = true;
 }
 
 void ObjectCache::CompilePixelShaderForUid(const PixelShaderUid& uid, ObjectCache::vkShaderItem& it)
@@ -754,6 +956,8 @@ void ObjectCache::CompilePixelShaderForUid(const PixelShaderUid& uid, ObjectCach
 	ShaderCompiler::SPIRVCodeVector spv;
 	VkShaderModule module = VK_NULL_HANDLE;
 	ShaderCode source_code;
+	// The generators only fall back to their static buffer when none is set.
+	source_code.SetBuffer(GetShaderCodeBuffer(ShaderCodeBuffer::Pixel, PIXELSHADERGEN_BUFFERSIZE));
 	GeneratePixelShaderCodeVulkan(source_code, uid.GetUidData());
 	if (ShaderCompiler::CompileFragmentShader(&spv, source_code.GetBuffer(),
 		source_code.BufferSize()))
@@ -763,21 +967,27 @@ void ObjectCache::CompilePixelShaderForUid(const PixelShaderUid& uid, ObjectCach
 		// Append to shader cache if it created successfully.
 		if (module != VK_NULL_HANDLE)
 		{
+			std::lock_guard<std::mutex> lock(m_ps_cache.disk_cache_lock);
 			m_ps_cache.disk_cache.Append(uid, spv.data(), static_cast<u32>(spv.size()));
 			INCSTAT(stats.numPixelShadersCreated);
 			INCSTAT(stats.numPixelShadersAlive);
 		}
 	}
-	it.compiled = true;
 	// We still insert null entries to prevent further compilation attempts.
 	it.module = module;
+	it.compiled = true;
 }
 
 VkShaderModule ObjectCache::GetVertexShaderForUid(const VertexShaderUid& uid)
 {
 	vkShaderItem& it = m_vs_cache.shader_map->GetOrAdd(uid);
 	if (it.initialized.test_and_set())
+	{
+		// Might still be compiling on one of the startup workers.
+		while (!it.compiled.load())
+			Common::YieldCPU();
 		return it.module;
+	}
 
 	CompileVertexShaderForUid(uid, it);
 	return it.module;
@@ -788,7 +998,12 @@ VkShaderModule ObjectCache::GetGeometryShaderForUid(const GeometryShaderUid& uid
 	_assert_(g_vulkan_context->SupportsGeometryShaders());
 	vkShaderItem& it = m_gs_cache.shader_map->GetOrAdd(uid);
 	if (it.initialized.test_and_set())
+	{
+		// Might still be compiling on one of the startup workers.
+		while (!it.compiled.load())
+			Common::YieldCPU();
 		return it.module;
+	}
 
 	CompileGeometryShaderForUid(uid, it);
 	return it.module;
@@ -798,12 +1013,95 @@ VkShaderModule ObjectCache::GetPixelShaderForUid(const PixelShaderUid& uid)
 {
 	vkShaderItem& it = m_ps_cache.shader_map->GetOrAdd(uid);
 	if (it.initialized.test_and_set())
+	{
+		// Might still be compiling on one of the startup workers.
+		while (!it.compiled.load())
+			Common::YieldCPU();
 		return it.module;
+	}
 
 	CompilePixelShaderForUid(uid, it);
 	return it.module;
 }
 
+bool ObjectCache::GetVertexShaderForUidAsync(const VertexShaderUid& uid, VkShaderModule* module)
+{
+	vkShaderItem& it = m_vs_cache.shader_map->GetOrAdd(uid);
+	if (!it.initialized.test_and_set())
+	{
+		vkShaderItem* item = &it;
+		QueueAsyncShader([this, uid, item]() { CompileVertexShaderForUid(uid, *item); });
+		return false;
+	}
+
+	if (!it.compiled.load())
+		return false;
+
+	*module = it.module;
+	return true;
+}
+
+bool ObjectCache::GetPixelShaderForUidAsync(const PixelShaderUid& uid, VkShaderModule* module)
+{
+	vkShaderItem& it = m_ps_cache.shader_map->GetOrAdd(uid);
+	if (!it.initialized.test_and_set())
+	{
+		vkShaderItem* item = &it;
+		QueueAsyncShader([this, uid, item]() { CompilePixelShaderForUid(uid, *item); });
+		return false;
+	}
+
+	if (!it.compiled.load())
+		return false;
+
+	*module = it.module;
+	return true;
+}
+
+VkShaderModule ObjectCache::GetUberVertexShader(const UberShader::VertexShaderUid& uid)
+{
+	auto iter = m_uber_vs_cache.find(uid);
+	if (iter != m_uber_vs_cache.end())
+		return iter->second;
+
+	ShaderCompiler::SPIRVCodeVector spv;
+	VkShaderModule module = VK_NULL_HANDLE;
+	ShaderCode source_code;
+	source_code.SetBuffer(GetShaderCodeBuffer(ShaderCodeBuffer::Vertex, UBERSHADERGEN_BUFFERSIZE));
+	UberShader::GenerateVertexShaderCode(source_code, uid.GetUidData(), API_VULKAN);
+	if (ShaderCompiler::CompileVertexShader(&spv, source_code.GetBuffer(),
+		source_code.BufferSize()))
+	{
+		module = Util::CreateShaderModule(spv.data(), spv.size());
+	}
+
+	// We still insert null entries to prevent further compilation attempts.
+	m_uber_vs_cache.emplace(uid, module);
+	return module;
+}
+
+VkShaderModule ObjectCache::GetUberPixelShader(const UberShader::PixelShaderUid& uid)
+{
+	auto iter = m_uber_ps_cache.find(uid);
+	if (iter != m_uber_ps_cache.end())
+		return iter->second;
+
+	ShaderCompiler::SPIRVCodeVector spv;
+	VkShaderModule module = VK_NULL_HANDLE;
+	ShaderCode source_code;
+	source_code.SetBuffer(GetShaderCodeBuffer(ShaderCodeBuffer::Pixel, UBERSHADERGEN_BUFFERSIZE));
+	UberShader::GeneratePixelShaderCode(source_code, uid.GetUidData(), API_VULKAN);
+	if (ShaderCompiler::CompileFragmentShader(&spv, source_code.GetBuffer(),
+		source_code.BufferSize()))
+	{
+		module = Util::CreateShaderModule(spv.data(), spv.size());
+	}
+
+	// We still insert null entries to prevent further compilation attempts.
+	m_uber_ps_cache.emplace(uid, module);
+	return module;
+}
+
 void ObjectCache::ClearSamplerCache()
 {
 	for (const auto& it : m_sampler_cache)
@@ -846,7 +1144,9 @@ bool ObjectCache::CreateDescriptorSetLayouts()
 		{ UBO_DESCRIPTOR_SET_BINDING_VS, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1,
 		VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT },
 		{ UBO_DESCRIPTOR_SET_BINDING_GS, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1,
-		VK_SHADER_STAGE_GEOMETRY_BIT } };
+		VK_SHADER_STAGE_GEOMETRY_BIT },
+		{ UBO_DESCRIPTOR_SET_BINDING_UBER, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1,
+		VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT } };
 
 	// Annoying these have to be split, apparently we can't partially update an array without the
 	// validation layers throwing a warning.
@@ -5,11 +5,17 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/LinearDiskCache.h"
@@ -18,6 +24,8 @@
 #include "VideoCommon/ObjectUsageProfiler.h"
 #include "VideoCommon/GeometryShaderGen.h"
 #include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/UberShaderPixel.h"
+#include "VideoCommon/UberShaderVertex.h"
 #include "VideoCommon/VertexShaderGen.h"
 
 namespace Vulkan
@@ -153,6 +161,15 @@ public:
 	VkShaderModule GetGeometryShaderForUid(const GeometryShaderUid& uid);
 	VkShaderModule GetPixelShaderForUid(const PixelShaderUid& uid);
 
+	// Same as above, but the shader is compiled on the thread pool. Returns false and leaves
+	// module untouched until the compile has finished.
+	bool GetVertexShaderForUidAsync(const VertexShaderUid& uid, VkShaderModule* module);
+	bool GetPixelShaderForUidAsync(const PixelShaderUid& uid, VkShaderModule* module);
+
+	// Ubershaders, drawn with while the specialized shaders are compiling.
+	VkShaderModule GetUberVertexShader(const UberShader::VertexShaderUid& uid);
+	VkShaderModule GetUberPixelShader(const UberShader::PixelShaderUid& uid);
+
 	// Static samplers
 	VkSampler GetPointSampler() const { return m_point_sampler; }
 	VkSampler GetLinearSampler() const { return m_linear_sampler; }
@@ -163,7 +180,8 @@ public:
 
 	// Creates a pipeline for the specified description. The resulting pipeline, if successful
 	// is not stored anywhere, this is left up to the caller.
-	VkPipeline CreatePipeline(const PipelineInfo& info);
+	// If base_pipeline is set, the pipeline is created as a derivative of it.
+	VkPipeline CreatePipeline(const PipelineInfo& info, VkPipeline base_pipeline = VK_NULL_HANDLE);
 
 	// Find a pipeline by the specified description, if not found, attempts to create it.
 	VkPipeline GetPipeline(const PipelineInfo& info);
@@ -173,6 +191,15 @@ public:
 	// otherwise for a cache hit it will be true.
 	std::pair<VkPipeline, bool> GetPipelineWithCacheResult(const PipelineInfo& info);
 
+	// Creates the pipeline on the thread pool, compiling any shaders that are not ready yet first.
+	// The shader modules in info are ignored. Used to recreate the pipelines from the UID cache
+	// without stalling the GPU thread.
+	void PrecachePipelineAsync(const PipelineInfo& info, const VertexShaderUid& vs_uid,
+		const GeometryShaderUid* gs_uid, const PixelShaderUid& ps_uid);
+
+	// Blocks until all pipelines queued with PrecachePipelineAsync have been created.
+	void WaitForPrecachedPipelines();
+
 	// Creates a compute pipeline, and does not track the handle.
 	VkPipeline CreateComputePipeline(const ComputePipelineInfo& info);
 
@@ -207,8 +234,8 @@ public:
 	class vkShaderItem
 	{
 	public:
-		bool compiled{};
-		std::atomic_flag initialized{};
+		std::atomic<bool> compiled{};
+		std::atomic_flag initialized = ATOMIC_FLAG_INIT;
 		VkShaderModule module = VK_NULL_HANDLE;
 		vkShaderItem() {}
 	};
@@ -246,6 +273,8 @@ private:
 		typedef ObjectUsageProfiler<Uid, pKey_t, vkShaderItem, UidHasher> cache_type;
 		std::unique_ptr<cache_type> shader_map{};
 		LinearDiskCache<Uid, u32> disk_cache{};
+		// Startup shaders are compiled on the thread pool, appends have to be serialized.
+		std::mutex disk_cache_lock;
 		ShaderCache(){}
 	};
 	typedef ShaderCache<VertexShaderUid, VertexShaderUid::ShaderUidHasher> VShaderCache;
@@ -256,7 +285,47 @@ private:
 	GShaderCache m_gs_cache;
 	PShaderCache m_ps_cache;
 
+	// Shaders from the usage profile compiled at startup, most used first.
+	struct StartupShader
+	{
+		vkShaderItem* item;
+		std::function<void()> compile;
+	};
+	bool CompileNextStartupShader();
+	void CancelStartupShaders();
+	std::vector<StartupShader> m_startup_shaders;
+	std::atomic<size_t> m_startup_next{};
+	std::atomic<int> m_startup_workers{};
+
+	// Shaders requested by the game that are compiled in the background.
+	void QueueAsyncShader(std::function<void()>&& compile);
+	void CancelAsyncShaders();
+	std::deque<std::function<void()>> m_async_shaders;
+	std::mutex m_async_shaders_lock;
+	std::atomic<int> m_async_workers{};
+
+	// Pipelines from the UID cache, created by the async shader workers.
+	struct PrecachedPipeline
+	{
+		PipelineInfo info;
+		VertexShaderUid vs_uid;
+		GeometryShaderUid gs_uid;
+		PixelShaderUid ps_uid;
+		vkShaderItem* vs_item;
+		vkShaderItem* gs_item;
+		vkShaderItem* ps_item;
+	};
+	void CreatePrecachedPipeline(const PrecachedPipeline& pipeline);
+	std::atomic<int> m_pending_pipelines{};
+
+	std::map<UberShader::VertexShaderUid, VkShaderModule> m_uber_vs_cache;
+	std::map<UberShader::PixelShaderUid, VkShaderModule> m_uber_ps_cache;
+
 	std::unordered_map<PipelineInfo, VkPipeline, PipelineInfoHash> m_pipeline_objects;
+	// First pipeline created for each vs/gs/ps combination, the others derive from it.
+	std::map<std::tuple<VkShaderModule, VkShaderModule, VkShaderModule>, VkPipeline>
+		m_base_pipelines;
+	std::mutex m_pipeline_lock;
 	std::unordered_map<ComputePipelineInfo, VkPipeline, ComputePipelineInfoHash>
 		m_compute_pipeline_objects;
 	VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
@@ -167,6 +167,12 @@ void PerfQuery::FlushResults()
 		BlockingPartialFlush();
 }
 
+void PerfQuery::PollResults()
+{
+	// Results come in through OnCommandBufferExecuted, just make sure they get submitted.
+	NonBlockingPartialFlush();
+}
+
 bool PerfQuery::IsFlushed() const
 {
 	return m_query_count == 0;
@@ -123,8 +123,6 @@ static const char VERTEX_SHADER_SOURCE[] = R"(
 
 layout(std140, push_constant) uniform PCBlock {
 vec2 char_size;
-vec2 offset;
-vec4 color;
 } PC;
 
 layout(location = 0) in vec4 ipos;
@@ -132,33 +130,30 @@ layout(location = 5) in vec4 icol0;
 layout(location = 8) in vec3 itex0;
 
 layout(location = 0) out vec2 uv0;
+layout(location = 1) out vec4 col0;
 
 void main()
 {
-gl_Position = vec4(ipos.xy + PC.offset, 0.0f, 1.0f);
+gl_Position = vec4(ipos.xy, 0.0f, 1.0f);
 gl_Position.y = -gl_Position.y;
 uv0 = itex0.xy * PC.char_size;
+col0 = icol0;
 }
 
 )";
 
 static const char FRAGMENT_SHADER_SOURCE[] = R"(
 
-layout(std140, push_constant) uniform PCBlock {
-vec2 char_size;
-vec2 offset;
-vec4 color;
-} PC;
-
 layout(set = 1, binding = 0) uniform sampler2D samp0;
 
 layout(location = 0) in vec2 uv0;
+layout(location = 1) in vec4 col0;
 
 layout(location = 0) out vec4 ocol0;
 
 void main()
 {
-ocol0 = texture(samp0, uv0) * PC.color;
+ocol0 = texture(samp0, uv0) * col0;
 }
 
 )";
@@ -308,20 +303,29 @@ void RasterFont::PrintMultiLineText(VkRenderPass render_pass, const std::string&
 	if (text.empty())
 		return;
 
-	UtilityShaderDraw draw(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-		g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_PUSH_CONSTANT),
-		render_pass, m_vertex_shader, VK_NULL_HANDLE, m_fragment_shader);
-
-	UtilityShaderVertex* vertices =
-		draw.ReserveVertices(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, text.length() * 6);
-	size_t num_vertices = 0;
-	if (!vertices)
-		return;
-
 	float delta_x = float(2 * CHARACTER_WIDTH) / float(bbWidth);
 	float delta_y = float(2 * CHARACTER_HEIGHT) / float(bbHeight);
 	float border_x = 2.0f / float(bbWidth);
 	float border_y = 4.0f / float(bbHeight);
+	float shadow_x = 2.0f / float(bbWidth);
+	float shadow_y = -2.0f / float(bbHeight);
+
+	// OSD colors are 0xAARRGGBB, the vertex color is RGBA8
+	u32 text_color = ((color >> 16) & 0xFF) | (color & 0xFF00) | ((color & 0xFF) << 16) |
+		(color & 0xFF000000);
+	u32 shadow_color = color & 0xFF000000;
+
+	auto add_vertex = [&](float x, float y, float u, float v) {
+		UtilityShaderVertex vertex;
+		vertex.SetPosition(x, y);
+		vertex.SetTextureCoordinates(u, v);
+		vertex.SetColor(text_color);
+		m_text_vertices.push_back(vertex);
+
+		vertex.SetPosition(x + shadow_x, y + shadow_y);
+		vertex.SetColor(shadow_color);
+		m_shadow_vertices.push_back(vertex);
+	};
 
 	float x = float(start_x);
 	float y = float(start_y);
@@ -345,57 +349,43 @@ void RasterFont::PrintMultiLineText(VkRenderPass render_pass, const std::string&
 		if (c < CHARACTER_OFFSET || c >= CHARACTER_COUNT + CHARACTER_OFFSET)
 			continue;
 
-		vertices[num_vertices].SetPosition(x, y);
-		vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET), 0.0f);
-		num_vertices++;
-
-		vertices[num_vertices].SetPosition(x + delta_x, y);
-		vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET + 1),
-			0.0f);
-		num_vertices++;
-
-		vertices[num_vertices].SetPosition(x + delta_x, y + delta_y);
-		vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET + 1),
-			1.0f);
-		num_vertices++;
-
-		vertices[num_vertices].SetPosition(x, y);
-		vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET), 0.0f);
-		num_vertices++;
-
-		vertices[num_vertices].SetPosition(x + delta_x, y + delta_y);
-		vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET + 1),
-			1.0f);
-		num_vertices++;
-
-		vertices[num_vertices].SetPosition(x, y + delta_y);
-		vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET), 1.0f);
-		num_vertices++;
+		float u0 = static_cast<float>(c - CHARACTER_OFFSET);
+		float u1 = static_cast<float>(c - CHARACTER_OFFSET + 1);
+		add_vertex(x, y, u0, 0.0f);
+		add_vertex(x + delta_x, y, u1, 0.0f);
+		add_vertex(x + delta_x, y + delta_y, u1, 1.0f);
+		add_vertex(x, y, u0, 0.0f);
+		add_vertex(x + delta_x, y + delta_y, u1, 1.0f);
+		add_vertex(x, y + delta_y, u0, 1.0f);
 
 		x += delta_x + border_x;
 	}
+}
 
-	// skip all whitespace strings
-	if (num_vertices == 0)
+void RasterFont::Flush(VkRenderPass render_pass)
+{
+	// skip frames without text
+	if (m_text_vertices.empty())
 		return;
 
-	draw.CommitVertices(num_vertices);
+	m_shadow_vertices.insert(m_shadow_vertices.end(), m_text_vertices.begin(),
+		m_text_vertices.end());
+
+	UtilityShaderDraw draw(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+		g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_PUSH_CONSTANT),
+		render_pass, m_vertex_shader, VK_NULL_HANDLE, m_fragment_shader);
+
+	draw.UploadVertices(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, m_shadow_vertices.data(),
+		m_shadow_vertices.size());
 
 	struct PCBlock
 	{
 		float char_size[2];
-		float offset[2];
-		float color[4];
 	} pc_block = {};
 
 	pc_block.char_size[0] = 1.0f / static_cast<float>(CHARACTER_COUNT);
 	pc_block.char_size[1] = 1.0f;
 
-	// shadows
-	pc_block.offset[0] = 2.0f / bbWidth;
-	pc_block.offset[1] = -2.0f / bbHeight;
-	pc_block.color[3] = (color >> 24) / 255.0f;
-
 	draw.SetPushConstants(&pc_block, sizeof(pc_block));
 	draw.SetPSSampler(0, m_texture->GetView(), g_object_cache->GetLinearSampler());
 
@@ -409,14 +399,8 @@ void RasterFont::PrintMultiLineText(VkRenderPass render_pass, const std::string&
 
 	draw.Draw();
 
-	// non-shadowed part
-	pc_block.offset[0] = 0.0f;
-	pc_block.offset[1] = 0.0f;
-	pc_block.color[0] = ((color >> 16) & 0xFF) / 255.0f;
-	pc_block.color[1] = ((color >> 8) & 0xFF) / 255.0f;
-	pc_block.color[2] = (color & 0xFF) / 255.0f;
-	draw.SetPushConstants(&pc_block, sizeof(pc_block));
-	draw.Draw();
+	m_shadow_vertices.clear();
+	m_text_vertices.clear();
 }
 
 }  // namespace Vulkan
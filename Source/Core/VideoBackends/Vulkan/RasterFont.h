@@ -6,10 +6,12 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
 #include "VideoBackends/Vulkan/Constants.h"
+#include "VideoBackends/Vulkan/Util.h"
 
 namespace Vulkan
 {
@@ -28,10 +30,17 @@ public:
 	void PrintMultiLineText(VkRenderPass render_pass, const std::string& text, float start_x,
 		float start_y, u32 bbWidth, u32 bbHeight, u32 color);
 
+	// Draws all text queued since the last flush with a single draw call
+	void Flush(VkRenderPass render_pass);
+
 private:
 	bool CreateTexture();
 	bool CreateShaders();
 
+	// Shadows are queued separately so they end up underneath all of the text
+	std::vector<UtilityShaderVertex> m_shadow_vertices;
+	std::vector<UtilityShaderVertex> m_text_vertices;
+
 	std::unique_ptr<Texture2D> m_texture;
 
 	VkShaderModule m_vertex_shader = VK_NULL_HANDLE;
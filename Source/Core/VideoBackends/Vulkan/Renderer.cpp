@@ -348,6 +348,7 @@ void Renderer::ClearScreen(const EFBRectangle& rc, bool color_enable, bool alpha
 	// Size we pass this size to vkBeginRenderPass, it has to be clamped to the framebuffer
 	// dimensions. The other backends just silently ignore this case.
 	target_rc.ClampUL(0, 0, m_target_width, m_target_height);
+	FramebufferManager::GetInstance()->InvalidateResolvedEFB();
 
 	VkRect2D target_vk_rc = {
 		{ target_rc.left, target_rc.top },
@@ -543,9 +544,11 @@ void Renderer::SwapImpl(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height
 			EndFrameDumping();
 	}
 
-	// Ensure the worker thread is not still submitting a previous command buffer.
+	// Ensure the worker thread is not still submitting any previous command buffer.
 	// In other words, the last frame has been submitted (otherwise the next call would
-	// be a race, as the image may not have been consumed yet).
+	// be a race, as the image may not have been consumed yet). Command buffers executed
+	// mid-frame can stay queued until here, so they don't block vertex processing.
+	g_command_buffer_mgr->WaitForWorkerThreadIdle();
 	g_command_buffer_mgr->PrepareToSubmitCommandBuffer();
 
 	// Draw to the screen if we have a swap chain.
@@ -575,6 +578,11 @@ void Renderer::SwapImpl(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height
 	// Prep for the next frame (get command buffer ready) before doing anything else.
 	BeginFrame();
 
+	// Activating the next command buffer retires the oldest one, which completes its timing.
+	double gpu_time = g_command_buffer_mgr->TakeGPUTime();
+	if (gpu_time >= 0.0)
+		OnGPUFrameTime(gpu_time);
+
 	// Determine what (if anything) has changed in the config.
 	CheckForConfigChanges();
 
@@ -748,6 +756,7 @@ void Renderer::DrawScreen(const TargetRectangle& scaled_efb_rect, u32 xfb_addr,
 	DrawDebugText();
 	OSD::DoCallbacks(OSD::CallbackType::OnFrame);
 	OSD::DrawMessages();
+	m_raster_font->Flush(m_swap_chain->GetRenderPass());
 
 	// End drawing to backbuffer
 	vkCmdEndRenderPass(g_command_buffer_mgr->GetCurrentCommandBuffer());
@@ -867,13 +876,8 @@ void Renderer::WriteFrameDumpImage(size_t index)
 
 StagingTexture2D* Renderer::PrepareFrameDumpImage(u32 width, u32 height, u64 ticks)
 {
-	// Ensure the last frame that was sent to the frame dump has completed encoding before we send
-	// the next image to it.
-	FinishFrameData();
-
 	// If the last image hasn't been written to the frame dump yet, write it now.
-	// This is necessary so that the worker thread is no more than one frame behind, and the pointer
-	// (which is actually the buffer) is safe for us to re-use next time.
+	// This is necessary so that the readback texture is safe for us to re-use next time.
 	if (m_frame_dump_images[m_current_frame_dump_image].pending)
 		WriteFrameDumpImage(m_current_frame_dump_image);
 
@@ -1172,6 +1176,8 @@ void Renderer::CheckForConfigChanges()
 	if (msaa_changed || stereo_changed)
 	{
 		g_command_buffer_mgr->WaitForGPUIdle();
+		// Pipelines still being precached may reference the old render pass.
+		g_object_cache->WaitForPrecachedPipelines();
 		FramebufferManager::GetInstance()->RecreateRenderPass();
 		FramebufferManager::GetInstance()->ResizeEFBTextures();
 		BindEFBToStateTracker();
@@ -1652,6 +1658,7 @@ void Renderer::ResetSamplerStates()
 
 	// Invalidate all sampler objects (some will be unused now).
 	g_object_cache->ClearSamplerCache();
+	StateTracker::GetInstance()->InvalidateDescriptorSets();
 }
 
 void Renderer::SetInterlacingMode()
@@ -244,20 +244,20 @@ bool CompileShaderToSPV(SPIRVCodeVector* out_code, EShLanguage stage, const char
 
 bool InitializeGlslang()
 {
-	static bool glslang_initialized = false;
-	if (glslang_initialized)
-		return true;
-
-	if (!glslang::InitializeProcess())
-	{
-		PanicAlert("Failed to initialize glslang shader compiler");
-		return false;
-	}
+	// Shaders are compiled from several threads at startup, the static initializer
+	// makes sure only one of them sets up glslang.
+	static const bool glslang_initialized = []() {
+		if (!glslang::InitializeProcess())
+		{
+			PanicAlert("Failed to initialize glslang shader compiler");
+			return false;
+		}
 
-	std::atexit([]() { glslang::FinalizeProcess(); });
+		std::atexit([]() { glslang::FinalizeProcess(); });
+		return true;
+	}();
 
-	glslang_initialized = true;
-	return true;
+	return glslang_initialized;
 }
 
 const TBuiltInResource* GetCompilerResourceLimits()
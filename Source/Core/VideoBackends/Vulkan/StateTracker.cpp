@@ -5,6 +5,7 @@
 #include "VideoBackends/Vulkan/StateTracker.h"
 
 #include <cstring>
+#include <functional>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
@@ -21,6 +22,7 @@
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/UberShaderManager.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -108,6 +110,9 @@ bool StateTracker::Initialize()
 	m_uniform_buffer_reserve_size = Common::AlignUp(m_uniform_buffer_reserve_size,
 		g_vulkan_context->GetUniformBufferAlignment()) +
 		sizeof(GeometryShaderConstants);
+	m_uniform_buffer_reserve_size = Common::AlignUp(m_uniform_buffer_reserve_size,
+		g_vulkan_context->GetUniformBufferAlignment()) +
+		sizeof(UberShaderConstants);
 
 	// Default dirty flags include all descriptors
 	InvalidateDescriptorSets();
@@ -167,41 +172,18 @@ bool StateTracker::PrecachePipelineUID(const SerializedPipelineUID& uid)
 	pinfo.pipeline_layout = uid.ps_uid.GetUidData().bounding_box ?
 		g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_BBOX) :
 		g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_STANDARD);
-	pinfo.vs = g_object_cache->GetVertexShaderForUid(uid.vs_uid);
-	if (pinfo.vs == VK_NULL_HANDLE)
-	{
-		WARN_LOG(VIDEO, "Failed to get vertex shader from cached UID.");
-		return false;
-	}
-	if (g_vulkan_context->SupportsGeometryShaders() && !uid.gs_uid.GetUidData().IsPassthrough())
-	{
-		pinfo.gs = g_object_cache->GetGeometryShaderForUid(uid.gs_uid);
-		if (pinfo.gs == VK_NULL_HANDLE)
-		{
-			WARN_LOG(VIDEO, "Failed to get geometry shader from cached UID.");
-			return false;
-		}
-	}
-	pinfo.ps = g_object_cache->GetPixelShaderForUid(uid.ps_uid);
-	if (pinfo.ps == VK_NULL_HANDLE)
-	{
-		WARN_LOG(VIDEO, "Failed to get pixel shader from cached UID.");
-		return false;
-	}
 	pinfo.render_pass = m_load_render_pass;
 	pinfo.blend_state.bits = uid.blend_state_bits;
 	pinfo.rasterization_state.bits = uid.rasterizer_state_bits;
 	pinfo.depth_stencil_state.bits = uid.depth_stencil_state_bits;
 	pinfo.primitive_topology = uid.primitive_topology;
 
-	VkPipeline pipeline = g_object_cache->GetPipeline(pinfo);
-	if (pipeline == VK_NULL_HANDLE)
-	{
-		WARN_LOG(VIDEO, "Failed to get pipeline from cached UID.");
-		return false;
-	}
-
-	// We don't need to do anything with this pipeline, just make sure it exists.
+	// The shaders and the pipeline are created on the thread pool, so the game can start while
+	// the pipelines it used before are still being built.
+	bool use_gs = g_vulkan_context->SupportsGeometryShaders() &&
+		!uid.gs_uid.GetUidData().IsPassthrough();
+	g_object_cache->PrecachePipelineAsync(pinfo, uid.vs_uid, use_gs ? &uid.gs_uid : nullptr,
+		uid.ps_uid);
 	return true;
 }
 
@@ -306,19 +288,19 @@ void StateTracker::SetBlendState(const BlendState& state)
 
 bool StateTracker::CheckForShaderChanges(u32 gx_primitive_type, u32 components, PIXEL_SHADER_RENDER_MODE dstalpha_mode)
 {
+	// The uids can't have changed, ubershaders still have to poll for the specialized shaders
+	if (!m_using_ubershaders && m_shader_uid_state.Matches(components, gx_primitive_type, dstalpha_mode))
+		return false;
+	m_shader_uid_state.Set(components, gx_primitive_type, dstalpha_mode);
+
 	VertexShaderUid vs_uid;
 	GetVertexShaderUID(vs_uid, components, xfmem, bpmem);
 	PixelShaderUid ps_uid;
 	GetPixelShaderUID(ps_uid, dstalpha_mode, components, xfmem, bpmem);
 
 	bool changed = false;
-
-	if (vs_uid != m_vs_uid)
-	{
-		m_pipeline_state.vs = g_object_cache->GetVertexShaderForUid(vs_uid);
-		m_vs_uid = vs_uid;
-		changed = true;
-	}
+	bool use_ubershaders = g_ActiveConfig.bFullAsyncShaderCompilation &&
+		!g_ActiveConfig.bWaitForShaderCompilation && !m_bbox_enabled;
 
 	if (g_vulkan_context->SupportsGeometryShaders())
 	{
@@ -334,13 +316,58 @@ bool StateTracker::CheckForShaderChanges(u32 gx_primitive_type, u32 components,
 			m_gs_uid = gs_uid;
 			changed = true;
 		}
+
+		// The ubershaders only cover the vertex and pixel stages.
+		use_ubershaders &= gs_uid.GetUidData().IsPassthrough();
 	}
 
-	if (ps_uid != m_ps_uid)
+	if (use_ubershaders)
+	{
+		if (vs_uid != m_vs_uid || ps_uid != m_ps_uid || m_using_ubershaders)
+		{
+			// Both stages have to come from the same generator, the interfaces don't match.
+			VkShaderModule vs = VK_NULL_HANDLE;
+			VkShaderModule ps = VK_NULL_HANDLE;
+			bool vs_ready = g_object_cache->GetVertexShaderForUidAsync(vs_uid, &vs);
+			bool ps_ready = g_object_cache->GetPixelShaderForUidAsync(ps_uid, &ps);
+			m_using_ubershaders = !vs_ready || !ps_ready;
+			if (m_using_ubershaders)
+			{
+				UberShader::VertexShaderUid uber_vs_uid;
+				UberShader::GetVertexShaderUid(uber_vs_uid, vs_uid.GetUidData());
+				vs = g_object_cache->GetUberVertexShader(uber_vs_uid);
+				UberShader::PixelShaderUid uber_ps_uid;
+				UberShader::GetPixelShaderUid(uber_ps_uid, ps_uid.GetUidData());
+				ps = g_object_cache->GetUberPixelShader(uber_ps_uid);
+			}
+
+			if (vs != m_pipeline_state.vs || ps != m_pipeline_state.ps)
+			{
+				m_pipeline_state.vs = vs;
+				m_pipeline_state.ps = ps;
+				changed = true;
+			}
+			m_vs_uid = vs_uid;
+			m_ps_uid = ps_uid;
+		}
+	}
+	else
 	{
-		m_pipeline_state.ps = g_object_cache->GetPixelShaderForUid(ps_uid);
-		m_ps_uid = ps_uid;
-		changed = true;
+		if (vs_uid != m_vs_uid || m_using_ubershaders)
+		{
+			m_pipeline_state.vs = g_object_cache->GetVertexShaderForUid(vs_uid);
+			m_vs_uid = vs_uid;
+			changed = true;
+		}
+
+		if (ps_uid != m_ps_uid || m_using_ubershaders)
+		{
+			m_pipeline_state.ps = g_object_cache->GetPixelShaderForUid(ps_uid);
+			m_ps_uid = ps_uid;
+			changed = true;
+		}
+
+		m_using_ubershaders = false;
 	}
 
 	if (m_dstalpha_mode != dstalpha_mode)
@@ -448,6 +475,46 @@ void StateTracker::UpdatePixelShaderConstants()
 	PixelShaderManager::Clear();
 }
 
+void StateTracker::UpdateUberShaderConstants(u32 components)
+{
+	// The constants are only read by the ubershaders, skip them for specialized draws.
+	if (!m_using_ubershaders)
+	{
+		// However, if the buffer has changed, we can't skip the update, because then we'll
+		// try to include the now non-existant buffer in the descriptor set.
+		if (m_uniform_stream_buffer->GetBuffer() ==
+			m_bindings.uniform_buffer_bindings[UBO_DESCRIPTOR_SET_BINDING_UBER].buffer)
+		{
+			return;
+		}
+
+		UberShaderManager::Dirty();
+	}
+
+	UberShaderManager::SetConstants(components);
+	if (!UberShaderManager::IsDirty() || !ReserveConstantStorage())
+		return;
+
+	// Buffer allocation changed?
+	if (m_uniform_stream_buffer->GetBuffer() !=
+		m_bindings.uniform_buffer_bindings[UBO_DESCRIPTOR_SET_BINDING_UBER].buffer)
+	{
+		m_bindings.uniform_buffer_bindings[UBO_DESCRIPTOR_SET_BINDING_UBER].buffer =
+			m_uniform_stream_buffer->GetBuffer();
+		m_dirty_flags |= DIRTY_FLAG_UBER_UBO;
+	}
+
+	m_bindings.uniform_buffer_offsets[UBO_DESCRIPTOR_SET_BINDING_UBER] =
+		static_cast<uint32_t>(m_uniform_stream_buffer->GetCurrentOffset());
+	m_dirty_flags |= DIRTY_FLAG_DYNAMIC_OFFSETS;
+
+	memcpy(m_uniform_stream_buffer->GetCurrentHostPointer(), &UberShaderManager::constants,
+		sizeof(UberShaderConstants));
+	ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(UberShaderConstants));
+	m_uniform_stream_buffer->CommitMemory(sizeof(UberShaderConstants));
+	UberShaderManager::Clear();
+}
+
 bool StateTracker::ReserveConstantStorage()
 {
 	// Since we invalidate all constants on command buffer execution, it doesn't matter if this
@@ -480,7 +547,9 @@ void StateTracker::UploadAllConstants()
 	size_t geometry_constants_offset =
 		Common::AlignUp(vertex_constants_offset + VertexShaderManager::ConstantBufferSize * sizeof(float),
 			ub_alignment);
-	size_t allocation_size = geometry_constants_offset + sizeof(GeometryShaderConstants);
+	size_t uber_constants_offset =
+		Common::AlignUp(geometry_constants_offset + sizeof(GeometryShaderConstants), ub_alignment);
+	size_t allocation_size = uber_constants_offset + sizeof(UberShaderConstants);
 
 	// Allocate everything at once.
 	// We should only be here if the buffer was full and a command buffer was submitted anyway.
@@ -502,6 +571,8 @@ void StateTracker::UploadAllConstants()
 		VertexShaderManager::ConstantBufferSize * sizeof(float);
 	m_bindings.uniform_buffer_bindings[UBO_DESCRIPTOR_SET_BINDING_GS].range =
 		sizeof(GeometryShaderConstants);
+	m_bindings.uniform_buffer_bindings[UBO_DESCRIPTOR_SET_BINDING_UBER].range =
+		sizeof(UberShaderConstants);
 
 	// Update dynamic offsets
 	m_bindings.uniform_buffer_offsets[UBO_DESCRIPTOR_SET_BINDING_PS] =
@@ -513,8 +584,11 @@ void StateTracker::UploadAllConstants()
 	m_bindings.uniform_buffer_offsets[UBO_DESCRIPTOR_SET_BINDING_GS] = static_cast<uint32_t>(
 		m_uniform_stream_buffer->GetCurrentOffset() + geometry_constants_offset);
 
+	m_bindings.uniform_buffer_offsets[UBO_DESCRIPTOR_SET_BINDING_UBER] = static_cast<uint32_t>(
+		m_uniform_stream_buffer->GetCurrentOffset() + uber_constants_offset);
+
 	m_dirty_flags |= DIRTY_FLAG_ALL_DESCRIPTOR_SETS | DIRTY_FLAG_DYNAMIC_OFFSETS | DIRTY_FLAG_VS_UBO |
-		DIRTY_FLAG_GS_UBO | DIRTY_FLAG_PS_UBO;
+		DIRTY_FLAG_GS_UBO | DIRTY_FLAG_PS_UBO | DIRTY_FLAG_UBER_UBO;
 
 	// Copy the actual data in
 	memcpy(m_uniform_stream_buffer->GetCurrentHostPointer() + pixel_constants_offset,
@@ -523,6 +597,8 @@ void StateTracker::UploadAllConstants()
 		VertexShaderManager::GetBuffer(), VertexShaderManager::ConstantBufferSize * sizeof(float));
 	memcpy(m_uniform_stream_buffer->GetCurrentHostPointer() + geometry_constants_offset,
 		&GeometryShaderManager::constants, sizeof(GeometryShaderConstants));
+	memcpy(m_uniform_stream_buffer->GetCurrentHostPointer() + uber_constants_offset,
+		&UberShaderManager::constants, sizeof(UberShaderConstants));
 
 	// Finally, flush buffer memory after copying
 	m_uniform_stream_buffer->CommitMemory(allocation_size);
@@ -531,6 +607,7 @@ void StateTracker::UploadAllConstants()
 	VertexShaderManager::Clear();
 	GeometryShaderManager::Clear();
 	PixelShaderManager::Clear();
+	UberShaderManager::Clear();
 }
 
 void StateTracker::SetTexture(size_t index, VkImageView view)
@@ -606,6 +683,7 @@ void StateTracker::UnbindTexture(VkImageView view)
 void StateTracker::InvalidateDescriptorSets()
 {
 	m_descriptor_sets.fill(VK_NULL_HANDLE);
+	m_sampler_set_cache.clear();
 	m_dirty_flags |= DIRTY_FLAG_ALL_DESCRIPTOR_SETS;
 
 	// Defer SSBO descriptor update until bbox is actually enabled.
@@ -618,6 +696,7 @@ void StateTracker::InvalidateConstants()
 	VertexShaderManager::Dirty();
 	GeometryShaderManager::Dirty();
 	PixelShaderManager::Dirty();
+	UberShaderManager::Dirty();
 }
 
 void StateTracker::SetPendingRebind()
@@ -913,8 +992,9 @@ VkPipeline StateTracker::GetPipelineAndCacheUID(const PipelineInfo& info)
 {
 	auto result = g_object_cache->GetPipelineWithCacheResult(info);
 
-	// Add to the UID cache if it is a new pipeline.
-	if (!result.second)
+	// Add to the UID cache if it is a new pipeline. Ubershader pipelines are never precached,
+	// the specialized shaders are compiled from the same uids.
+	if (!result.second && !m_using_ubershaders)
 		AppendToPipelineUIDCache(info);
 
 	return result.first;
@@ -943,6 +1023,31 @@ bool StateTracker::UpdatePipeline()
 	return m_pipeline_object != VK_NULL_HANDLE;
 }
 
+size_t StateTracker::SamplerBindingsHash::operator()(const SamplerBindings& bindings) const
+{
+	size_t hash = 0;
+	for (const VkDescriptorImageInfo& info : bindings)
+	{
+		hash = hash * 31 + std::hash<VkImageView>()(info.imageView);
+		hash = hash * 31 + std::hash<VkSampler>()(info.sampler);
+	}
+	return hash;
+}
+
+bool StateTracker::SamplerBindingsEqual::operator()(const SamplerBindings& lhs,
+	const SamplerBindings& rhs) const
+{
+	for (size_t i = 0; i < lhs.size(); i++)
+	{
+		if (lhs[i].imageView != rhs[i].imageView || lhs[i].sampler != rhs[i].sampler ||
+			lhs[i].imageLayout != rhs[i].imageLayout)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 bool StateTracker::UpdateDescriptorSet()
 {
 	const size_t MAX_DESCRIPTOR_WRITES =
@@ -952,7 +1057,7 @@ bool StateTracker::UpdateDescriptorSet()
 	std::array<VkWriteDescriptorSet, MAX_DESCRIPTOR_WRITES> writes;
 	u32 num_writes = 0;
 
-	if (m_dirty_flags & (DIRTY_FLAG_VS_UBO | DIRTY_FLAG_GS_UBO | DIRTY_FLAG_PS_UBO) ||
+	if (m_dirty_flags & (DIRTY_FLAG_VS_UBO | DIRTY_FLAG_GS_UBO | DIRTY_FLAG_PS_UBO | DIRTY_FLAG_UBER_UBO) ||
 		m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_UNIFORM_BUFFERS] == VK_NULL_HANDLE)
 	{
 		VkDescriptorSetLayout layout =
@@ -982,35 +1087,56 @@ bool StateTracker::UpdateDescriptorSet()
 	if (m_dirty_flags & DIRTY_FLAG_PS_SAMPLERS ||
 		m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] == VK_NULL_HANDLE)
 	{
-		VkDescriptorSetLayout layout =
-			g_object_cache->GetDescriptorSetLayout(DESCRIPTOR_SET_LAYOUT_PIXEL_SHADER_SAMPLERS);
-		VkDescriptorSet set = g_command_buffer_mgr->AllocateDescriptorSet(layout);
-		if (set == VK_NULL_HANDLE)
-			return false;
+		// Cached sets die with the pool they were allocated from.
+		VkDescriptorPool pool = g_command_buffer_mgr->GetCurrentDescriptorPool();
+		if (m_sampler_set_cache_pool != pool)
+		{
+			m_sampler_set_cache.clear();
+			m_sampler_set_cache_pool = pool;
+		}
 
-		for (size_t i = 0; i < NUM_PIXEL_SHADER_SAMPLERS; i++)
+		auto iter = m_sampler_set_cache.find(m_bindings.ps_samplers);
+		if (iter != m_sampler_set_cache.end())
 		{
-			const VkDescriptorImageInfo& info = m_bindings.ps_samplers[i];
-			if (info.imageView != VK_NULL_HANDLE && info.sampler != VK_NULL_HANDLE)
+			if (m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] != iter->second)
 			{
-				writes[num_writes++] =
-				{
-					VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-					nullptr,
-					set,
-					static_cast<uint32_t>(i),
-					0,
-					1,
-					VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-					&info,
-					nullptr,
-					nullptr
-				};
+				m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] = iter->second;
+				m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
 			}
 		}
+		else
+		{
+			VkDescriptorSetLayout layout =
+				g_object_cache->GetDescriptorSetLayout(DESCRIPTOR_SET_LAYOUT_PIXEL_SHADER_SAMPLERS);
+			VkDescriptorSet set = g_command_buffer_mgr->AllocateDescriptorSet(layout);
+			if (set == VK_NULL_HANDLE)
+				return false;
 
-		m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] = set;
-		m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
+			for (size_t i = 0; i < NUM_PIXEL_SHADER_SAMPLERS; i++)
+			{
+				const VkDescriptorImageInfo& info = m_bindings.ps_samplers[i];
+				if (info.imageView != VK_NULL_HANDLE && info.sampler != VK_NULL_HANDLE)
+				{
+					writes[num_writes++] =
+					{
+						VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+						nullptr,
+						set,
+						static_cast<uint32_t>(i),
+						0,
+						1,
+						VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+						&info,
+						nullptr,
+						nullptr
+					};
+				}
+			}
+
+			m_sampler_set_cache.emplace(m_bindings.ps_samplers, set);
+			m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] = set;
+			m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
+		}
 	}
 
 	if (m_bbox_enabled &&
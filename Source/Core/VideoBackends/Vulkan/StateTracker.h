@@ -7,6 +7,7 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <unordered_map>
 
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Vulkan/Constants.h"
@@ -62,6 +63,7 @@ public:
 	void UpdateVertexShaderConstants();
 	void UpdateGeometryShaderConstants();
 	void UpdatePixelShaderConstants();
+	void UpdateUberShaderConstants(u32 components);
 
 	void SetTexture(size_t index, VkImageView view);
 	void SetSampler(size_t index, VkSampler sampler);
@@ -73,6 +75,7 @@ public:
 
 	// When executing a command buffer, we want to recreate the descriptor set, as it will
 	// now be in a different pool for the new command buffer.
+	// Also needed when samplers are destroyed, as cached sampler sets may reference them.
 	void InvalidateDescriptorSets();
 
 	// Same with the uniforms, as the current storage will belong to the previous command buffer.
@@ -153,9 +156,11 @@ private:
 		DIRTY_FLAG_PIPELINE = (1 << 10),
 		DIRTY_FLAG_DESCRIPTOR_SET_BINDING = (1 << 11),
 		DIRTY_FLAG_PIPELINE_BINDING = (1 << 12),
+		DIRTY_FLAG_UBER_UBO = (1 << 13),
 
 		DIRTY_FLAG_ALL_DESCRIPTOR_SETS =
-		DIRTY_FLAG_VS_UBO | DIRTY_FLAG_GS_UBO | DIRTY_FLAG_PS_SAMPLERS | DIRTY_FLAG_PS_SSBO
+		DIRTY_FLAG_VS_UBO | DIRTY_FLAG_GS_UBO | DIRTY_FLAG_PS_SAMPLERS | DIRTY_FLAG_PS_SSBO |
+		DIRTY_FLAG_UBER_UBO
 	};
 
 	bool Initialize();
@@ -164,7 +169,7 @@ private:
 	// The info is here so that we can store variations of a UID, e.g. blend state.
 	void AppendToPipelineUIDCache(const PipelineInfo& info);
 
-	// Precaches a pipeline based on the UID information.
+	// Precaches a pipeline based on the UID information, in the background.
 	bool PrecachePipelineUID(const SerializedPipelineUID& uid);
 
 	// Check that the specified viewport is within the render area.
@@ -201,6 +206,9 @@ private:
 	VertexShaderUid m_vs_uid = {};
 	GeometryShaderUid m_gs_uid = {};
 	PixelShaderUid m_ps_uid = {};
+	// Set while the specialized shaders for the current uids are compiling in the background.
+	bool m_using_ubershaders = false;
+	ShaderUIDStateTag m_shader_uid_state;
 
 	// pipeline state
 	PipelineInfo m_pipeline_state = {};
@@ -220,6 +228,21 @@ private:
 		VkDescriptorBufferInfo ps_ssbo = {};
 	} m_bindings;
 	u32 m_num_active_descriptor_sets = 0;
+
+	// Sampler descriptor sets already written in the current descriptor pool, by their bindings.
+	// Draws tend to alternate between a few texture sets, so most changes only need a rebind.
+	using SamplerBindings = std::array<VkDescriptorImageInfo, NUM_PIXEL_SHADER_SAMPLERS>;
+	struct SamplerBindingsHash
+	{
+		size_t operator()(const SamplerBindings& bindings) const;
+	};
+	struct SamplerBindingsEqual
+	{
+		bool operator()(const SamplerBindings& lhs, const SamplerBindings& rhs) const;
+	};
+	std::unordered_map<SamplerBindings, VkDescriptorSet, SamplerBindingsHash, SamplerBindingsEqual>
+		m_sampler_set_cache;
+	VkDescriptorPool m_sampler_set_cache_pool = VK_NULL_HANDLE;
 	size_t m_uniform_buffer_reserve_size = 0;
 
 	// rasterization
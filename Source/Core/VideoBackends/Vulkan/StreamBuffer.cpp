@@ -10,11 +10,14 @@
 
 #include "Common/Assert.h"
 #include "Common/MsgHandler.h"
+#include "Common/Timer.h"
 
 #include "VideoBackends/Vulkan/CommandBufferManager.h"
 #include "VideoBackends/Vulkan/Util.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
 
+#include "VideoCommon/Statistics.h"
+
 namespace Vulkan
 {
 StreamBuffer::StreamBuffer(VkBufferUsageFlags usage, size_t max_size)
@@ -331,11 +334,18 @@ bool StreamBuffer::WaitForClearSpace(size_t num_bytes)
 	if (iter == m_tracked_fences.end())
 		return false;
 
-	// Wait until this fence is signaled.
-	VkResult res =
-		vkWaitForFences(g_vulkan_context->GetDevice(), 1, &iter->first, VK_TRUE, UINT64_MAX);
-	if (res != VK_SUCCESS)
-		LOG_VULKAN_ERROR(res, "vkWaitForFences failed: ");
+	// Wait until this fence is signaled, the GPU may well be past it already.
+	if (vkGetFenceStatus(g_vulkan_context->GetDevice(), iter->first) != VK_SUCCESS)
+	{
+		u64 start = Common::Timer::GetTimeUs();
+		VkResult res =
+			vkWaitForFences(g_vulkan_context->GetDevice(), 1, &iter->first, VK_TRUE, UINT64_MAX);
+		if (res != VK_SUCCESS)
+			LOG_VULKAN_ERROR(res, "vkWaitForFences failed: ");
+		INCSTAT(stats.thisFrame.numStreamBufferStalls);
+		ADDSTAT(stats.thisFrame.streamBufferStallMicroseconds,
+			static_cast<int>(Common::Timer::GetTimeUs() - start));
+	}
 
 	// Update GPU position, and remove all fences up to (and including) this fence.
 	m_current_offset = new_offset;
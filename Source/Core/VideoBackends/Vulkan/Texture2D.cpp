@@ -410,6 +410,25 @@ void Texture2D::TransitionToLayout(VkCommandBuffer command_buffer, ComputeImageL
 		break;
 	}
 
+	// Going from one compute layout to another, e.g. reading what a previous dispatch wrote.
+	switch (m_compute_layout)
+	{
+	case ComputeImageLayout::Undefined:
+		break;
+	case ComputeImageLayout::ReadOnly:
+		barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		break;
+	case ComputeImageLayout::WriteOnly:
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		break;
+	case ComputeImageLayout::ReadWrite:
+		barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		break;
+	}
+
 	switch (new_layout)
 	{
 	case ComputeImageLayout::ReadOnly:
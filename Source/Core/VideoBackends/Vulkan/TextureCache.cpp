@@ -37,6 +37,7 @@ TextureCache::TextureCache()
 
 TextureCache::~TextureCache()
 {
+	FlushEFBCopies();
 	if (m_render_pass != VK_NULL_HANDLE)
 		vkDestroyRenderPass(g_vulkan_context->GetDevice(), m_render_pass, nullptr);
 	TextureCache::DeleteShaders();
@@ -98,9 +99,7 @@ void TextureCache::LoadLut(u32 lutFmt, void* addr, u32 size)
 	m_pallette_size = size;
 }
 
-void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
-	u32 num_blocks_y, u32 memory_stride,
-	bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+Texture2D* TextureCache::PrepareEFBCopySource(bool is_depth_copy, const EFBRectangle& src_rect)
 {
 	// Flush EFB pokes first, as they're expected to be included.
 	FramebufferManager::GetInstance()->FlushEFBPokes();
@@ -125,6 +124,14 @@ void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_widt
 	// The barrier has to happen after the render pass, not inside it, as we are going to be
 	// reading from the texture immediately afterwards.
 	StateTracker::GetInstance()->EndRenderPass();
+	return src_texture;
+}
+
+void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
+	u32 num_blocks_y, u32 memory_stride,
+	bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+{
+	Texture2D* src_texture = PrepareEFBCopySource(is_depth_copy, src_rect);
 	StateTracker::GetInstance()->OnReadback();
 
 	// Transition to shader resource before reading.
@@ -140,6 +147,25 @@ void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_widt
 	src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(), original_layout);
 }
 
+std::unique_ptr<EFBCopyReadback> TextureCache::QueueEFBCopy(const EFBCopyFormat& format,
+	u32 native_width, u32 bytes_per_row, u32 num_blocks_y, bool is_depth_copy,
+	const EFBRectangle& src_rect, bool scale_by_half)
+{
+	// The readback is only counted once it has to wait, see EncodingReadback.
+	Texture2D* src_texture = PrepareEFBCopySource(is_depth_copy, src_rect);
+
+	VkImageLayout original_layout = src_texture->GetLayout();
+	src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	std::unique_ptr<EFBCopyReadback> readback = m_texture_converter->QueueEncodeTextureToMemory(
+		src_texture->GetView(), format, native_width, bytes_per_row, num_blocks_y, is_depth_copy,
+		src_rect, scale_by_half);
+
+	src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(), original_layout);
+	return readback;
+}
+
 PC_TexFormat TextureCache::GetNativeTextureFormat(const s32 texformat, const TlutFormat tlutfmt, u32 width, u32 height)
 {
 	const bool compressed_supported = ((width & 3) == 0) && ((height & 3) == 0);
@@ -165,6 +191,11 @@ bool TextureCache::SupportsGPUTextureDecode(TextureFormat format, TlutFormat pal
 	return m_texture_converter->SupportsTextureDecoding(format, palette_format);
 }
 
+bool TextureCache::SupportsGPUTextureScaling(int scaling_type, int factor)
+{
+	return m_texture_converter->SupportsTextureScaling(scaling_type, factor);
+}
+
 void TextureCache::CopyTextureRectangle(TCacheEntry* dst_texture,
 	const MathUtil::Rectangle<int>& dst_rect,
 	Texture2D* src_texture,
@@ -525,6 +556,13 @@ bool TextureCache::TCacheEntry::DecodeTextureOnGPU(u32 dst_level, const u8* data
 		row_stride, palette, palette_format);
 }
 
+bool TextureCache::TCacheEntry::ScaleTextureOnGPU(u32 dst_level, const u8* data, u32 width,
+	u32 height, u32 expanded_width)
+{
+	return static_cast<TextureCache*>(g_texture_cache.get())->GetTextureConverter()->ScaleTexture(
+		this, dst_level, data, width, height, expanded_width);
+}
+
 void TextureCache::TCacheEntry::Load(const u8* src, u32 width, u32 height,
 	u32 expanded_width, u32 level)
 {
@@ -674,7 +712,7 @@ bool TextureCache::TCacheEntry::Save(const std::string& filename, u32 level)
 	// Write texture out to file.
 	// It's okay to throw this texture away immediately, since we're done with it, and
 	// we blocked until the copy completed on the GPU anyway.
-	bool result = TextureToPng(reinterpret_cast<u8*>(staging_texture->GetMapPointer()),
+	bool result = TextureToPngAsync(reinterpret_cast<u8*>(staging_texture->GetMapPointer()),
 		staging_texture->GetRowStride(), filename, level_width, level_height);
 
 	staging_texture->Unmap();
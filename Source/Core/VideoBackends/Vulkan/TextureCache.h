@@ -41,6 +41,8 @@ public:
 			u32 data_size, TextureFormat format, u32 width, u32 height,
 			u32 aligned_width, u32 aligned_height, u32 row_stride,
 			const u8* palette, TlutFormat palette_format) override;
+		bool ScaleTextureOnGPU(u32 dst_level, const u8* data, u32 width, u32 height,
+			u32 expanded_width) override;
 		void Bind(u32 stage) override;
 		bool Save(const std::string& filename, unsigned int level) override;
 		bool SupportsMaterialMap() const override
@@ -75,10 +77,14 @@ public:
 	void CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
 		u32 num_blocks_y, u32 memory_stride,
 		bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half) override;
+	std::unique_ptr<EFBCopyReadback> QueueEFBCopy(const EFBCopyFormat& format, u32 native_width,
+		u32 bytes_per_row, u32 num_blocks_y, bool is_depth_copy, const EFBRectangle& src_rect,
+		bool scale_by_half) override;
 
 	void CopyRectangleFromTexture(TCacheEntry* dst_texture, const MathUtil::Rectangle<int>& dst_rect,
 		Texture2D* src_texture, const MathUtil::Rectangle<int>& src_rect);
 	bool SupportsGPUTextureDecode(TextureFormat format, TlutFormat palette_format) override;
+	bool SupportsGPUTextureScaling(int scaling_type, int factor) override;
 	TextureConverter* GetTextureConverter()
 	{
 		return m_texture_converter.get();
@@ -94,6 +100,9 @@ public:
 private:
 	bool CreateRenderPasses();
 
+	// Resolves the EFB for a copy and ends the render pass, so the texture can be transitioned.
+	Texture2D* PrepareEFBCopySource(bool is_depth_copy, const EFBRectangle& src_rect);
+
 	// Copies the contents of a texture using vkCmdCopyImage
 	void CopyTextureRectangle(TCacheEntry* dst_texture, const MathUtil::Rectangle<int>& dst_rect,
 		Texture2D* src_texture, const MathUtil::Rectangle<int>& src_rect);
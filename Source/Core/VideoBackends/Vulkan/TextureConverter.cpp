@@ -28,6 +28,7 @@
 
 #include "VideoCommon/TextureConversionShader.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/TextureScalerShader.h"
 #include "VideoCommon/VideoConfig.h"
 
 namespace Vulkan
@@ -65,6 +66,12 @@ TextureConverter::~TextureConverter()
 			vkDestroyShaderModule(g_vulkan_context->GetDevice(), it.second.compute_shader, nullptr);
 	}
 
+	for (const auto& it : m_scaling_shaders)
+	{
+		if (it.second != VK_NULL_HANDLE)
+			vkDestroyShaderModule(g_vulkan_context->GetDevice(), it.second, nullptr);
+	}
+
 	if (m_rgb_to_yuyv_shader != VK_NULL_HANDLE)
 		vkDestroyShaderModule(g_vulkan_context->GetDevice(), m_rgb_to_yuyv_shader, nullptr);
 	if (m_yuyv_to_rgb_shader != VK_NULL_HANDLE)
@@ -208,18 +215,56 @@ void TextureConverter::ConvertTexture(TextureCache::TCacheEntry* dst_entry, cons
 	draw.EndRenderPass();
 }
 
-void TextureConverter::EncodeTextureToMemory(VkImageView src_texture, u8* dest_ptr,
-	const EFBCopyFormat& format, u32 native_width,
-	u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
-	bool is_depth_copy, const EFBRectangle& src_rect,
-	bool scale_by_half)
+// Owns the staging texture of a deferred copy until it is read back.
+class TextureConverter::EncodingReadback final : public EFBCopyReadback
+{
+public:
+	EncodingReadback(TextureConverter* converter, std::unique_ptr<StagingTexture2D> texture,
+		u32 width, u32 height, VkFence fence)
+		: m_converter(converter), m_texture(std::move(texture)), m_width(width), m_height(height),
+		m_fence(fence)
+	{
+	}
+	~EncodingReadback()
+	{
+		m_converter->ReturnReadbackTexture(std::move(m_texture));
+	}
+
+	void ReadToRAM(u8* dst, u32 memory_stride) override
+	{
+		// The copy may still be in the command buffer that is being recorded.
+		if (m_fence == g_command_buffer_mgr->GetCurrentCommandBufferFence())
+		{
+			StateTracker::GetInstance()->OnReadback();
+			Util::ExecuteCurrentCommandsAndRestoreState(false, true);
+		}
+		else
+		{
+			g_command_buffer_mgr->WaitForFence(m_fence);
+		}
+
+		m_texture->InvalidateCPUCache();
+		m_texture->ReadTexels(0, 0, m_width, m_height, dst, memory_stride);
+	}
+
+private:
+	TextureConverter* m_converter;
+	std::unique_ptr<StagingTexture2D> m_texture;
+	u32 m_width;
+	u32 m_height;
+	VkFence m_fence;
+};
+
+bool TextureConverter::DrawEncoding(VkImageView src_texture, const EFBCopyFormat& format,
+	u32 native_width, u32 bytes_per_row, u32 num_blocks_y, bool is_depth_copy,
+	const EFBRectangle& src_rect, bool scale_by_half)
 {
 	VkShaderModule shader = GetEncodingShader(format);
 	if (shader == VK_NULL_HANDLE)
 	{
 		ERROR_LOG(VIDEO, "Missing encoding fragment shader for format %u->%u", format.efb_format,
 			static_cast<u32>(format.copy_format));
-		return;
+		return false;
 	}
 
 	// Can't do our own draw within a render pass.
@@ -258,6 +303,23 @@ void TextureConverter::EncodeTextureToMemory(VkImageView src_texture, u8* dest_p
 	// Transition the image before copying
 	m_encoding_render_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
 		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+	return true;
+}
+
+void TextureConverter::EncodeTextureToMemory(VkImageView src_texture, u8* dest_ptr,
+	const EFBCopyFormat& format, u32 native_width,
+	u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
+	bool is_depth_copy, const EFBRectangle& src_rect,
+	bool scale_by_half)
+{
+	if (!DrawEncoding(src_texture, format, native_width, bytes_per_row, num_blocks_y, is_depth_copy,
+		src_rect, scale_by_half))
+	{
+		return;
+	}
+
+	u32 render_width = bytes_per_row / sizeof(u32);
+	u32 render_height = num_blocks_y;
 	m_encoding_download_texture->CopyFromImage(
 		g_command_buffer_mgr->GetCurrentCommandBuffer(), m_encoding_render_texture->GetImage(),
 		VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, render_width, render_height, 0, 0);
@@ -270,6 +332,56 @@ void TextureConverter::EncodeTextureToMemory(VkImageView src_texture, u8* dest_p
 		memory_stride);
 }
 
+std::unique_ptr<EFBCopyReadback> TextureConverter::QueueEncodeTextureToMemory(
+	VkImageView src_texture, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
+	u32 num_blocks_y, bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+{
+	u32 render_width = bytes_per_row / sizeof(u32);
+	u32 render_height = num_blocks_y;
+	std::unique_ptr<StagingTexture2D> texture = GetReadbackTexture(render_width, render_height);
+	if (!texture)
+		return nullptr;
+
+	if (!DrawEncoding(src_texture, format, native_width, bytes_per_row, num_blocks_y, is_depth_copy,
+		src_rect, scale_by_half))
+	{
+		ReturnReadbackTexture(std::move(texture));
+		return nullptr;
+	}
+
+	texture->CopyFromImage(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+		m_encoding_render_texture->GetImage(), VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, render_width,
+		render_height, 0, 0);
+	return std::make_unique<EncodingReadback>(this, std::move(texture), render_width,
+		render_height, g_command_buffer_mgr->GetCurrentCommandBufferFence());
+}
+
+std::unique_ptr<StagingTexture2D> TextureConverter::GetReadbackTexture(u32 width, u32 height)
+{
+	auto iter = std::find_if(m_readback_texture_pool.begin(), m_readback_texture_pool.end(),
+		[width, height](const std::unique_ptr<StagingTexture2D>& texture) {
+		return texture->GetWidth() >= width && texture->GetHeight() >= height;
+	});
+	if (iter != m_readback_texture_pool.end())
+	{
+		std::unique_ptr<StagingTexture2D> texture = std::move(*iter);
+		m_readback_texture_pool.erase(iter);
+		return texture;
+	}
+
+	std::unique_ptr<StagingTexture2D> texture = StagingTexture2D::Create(
+		STAGING_BUFFER_TYPE_READBACK, width, height, ENCODING_TEXTURE_FORMAT);
+	if (!texture || !texture->Map())
+		return nullptr;
+	return texture;
+}
+
+void TextureConverter::ReturnReadbackTexture(std::unique_ptr<StagingTexture2D> texture)
+{
+	if (texture && m_readback_texture_pool.size() < MAX_POOLED_READBACK_TEXTURES)
+		m_readback_texture_pool.push_back(std::move(texture));
+}
+
 void TextureConverter::EncodeTextureToMemoryYUYV(void* dst_ptr, u32 dst_width, u32 dst_stride,
 	u32 dst_height, Texture2D* src_texture,
 	const MathUtil::Rectangle<int>& src_rect)
@@ -421,6 +533,15 @@ bool TextureConverter::DecodeTexture(TextureCache::TCacheEntry* entry, u32 dst_l
 	if (iter == m_decoding_pipelines.end())
 		return false;
 
+	// Scaled entries take the decoded texture through the scaler instead of copying it.
+	VkShaderModule scaling_shader = VK_NULL_HANDLE;
+	if (entry->is_scaled)
+	{
+		scaling_shader = GetScalingShader(aligned_width, height);
+		if (scaling_shader == VK_NULL_HANDLE)
+			return false;
+	}
+
 	struct PushConstants
 	{
 		u32 dst_size[2];
@@ -511,6 +632,14 @@ bool TextureConverter::DecodeTexture(TextureCache::TCacheEntry* entry, u32 dst_l
 	auto groups = TextureConversionShader::GetDispatchCount(iter->second.base_info, aligned_width, aligned_height);
 	dispatcher.Dispatch(groups.first, groups.second, 1);
 
+	// The CPU scaler works on the expanded width too, so do the same to get the same edges.
+	if (scaling_shader != VK_NULL_HANDLE)
+	{
+		ScaleDecodingTexture(command_buffer, scaling_shader, entry, dst_level, width, height,
+			aligned_width);
+		return true;
+	}
+
 	// Copy from temporary texture to final destination.
 	m_decoding_texture->TransitionToLayout(command_buffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 	entry->GetTexture()->TransitionToLayout(command_buffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
@@ -525,6 +654,100 @@ bool TextureConverter::DecodeTexture(TextureCache::TCacheEntry* entry, u32 dst_l
 	return true;
 }
 
+bool TextureConverter::SupportsTextureScaling(int scaling_type, int factor)
+{
+	auto key = std::make_pair(scaling_type, factor);
+	auto iter = m_scaling_shaders.find(key);
+	if (iter != m_scaling_shaders.end())
+		return iter->second != VK_NULL_HANDLE;
+
+	std::string shader_source =
+		TextureScalerShader::GenerateScalingShader(scaling_type, factor, API_TYPE::API_VULKAN);
+	VkShaderModule shader = VK_NULL_HANDLE;
+	if (!shader_source.empty())
+		shader = Util::CompileAndCreateComputeShader(shader_source, true);
+
+	// The destination is only needed once a scaler is used.
+	if (shader != VK_NULL_HANDLE && !m_scaling_texture)
+	{
+		m_scaling_texture = Texture2D::Create(
+			SCALING_TEXTURE_WIDTH, SCALING_TEXTURE_HEIGHT, 1, 1, VK_FORMAT_R8G8B8A8_UNORM,
+			VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D_ARRAY, VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+		if (!m_scaling_texture)
+		{
+			vkDestroyShaderModule(g_vulkan_context->GetDevice(), shader, nullptr);
+			shader = VK_NULL_HANDLE;
+		}
+	}
+
+	m_scaling_shaders.emplace(key, shader);
+	return shader != VK_NULL_HANDLE;
+}
+
+bool TextureConverter::ScaleTexture(TextureCache::TCacheEntry* entry, u32 dst_level,
+	const u8* data, u32 width, u32 height, u32 expanded_width)
+{
+	VkShaderModule shader = GetScalingShader(expanded_width, height);
+	if (shader == VK_NULL_HANDLE)
+		return false;
+
+	// This may execute the current command buffer, so get the command buffer afterwards.
+	TextureCache::GetInstance()->LoadData(m_decoding_texture.get(), data, expanded_width, height,
+		expanded_width, 0);
+	ScaleDecodingTexture(g_command_buffer_mgr->GetCurrentInitCommandBuffer(), shader, entry,
+		dst_level, width, height, expanded_width);
+	return true;
+}
+
+VkShaderModule TextureConverter::GetScalingShader(u32 src_width, u32 src_height) const
+{
+	const int factor = g_ActiveConfig.iTexScalingFactor;
+	auto iter = m_scaling_shaders.find(std::make_pair(g_ActiveConfig.iTexScalingType, factor));
+	if (iter == m_scaling_shaders.end() || src_width > DECODING_TEXTURE_WIDTH ||
+		src_height > DECODING_TEXTURE_HEIGHT || src_width * factor > SCALING_TEXTURE_WIDTH ||
+		src_height * factor > SCALING_TEXTURE_HEIGHT)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	return iter->second;
+}
+
+void TextureConverter::ScaleDecodingTexture(VkCommandBuffer command_buffer,
+	VkShaderModule shader, TextureCache::TCacheEntry* entry,
+	u32 dst_level, u32 width, u32 height, u32 src_width)
+{
+	struct PushConstants
+	{
+		u32 src_size[2];
+	};
+	PushConstants constants = { { src_width, height } };
+
+	ComputeShaderDispatcher dispatcher(command_buffer,
+		g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_COMPUTE), shader);
+	m_decoding_texture->TransitionToLayout(command_buffer, Texture2D::ComputeImageLayout::ReadOnly);
+	m_scaling_texture->TransitionToLayout(command_buffer, Texture2D::ComputeImageLayout::WriteOnly);
+	dispatcher.SetPushConstants(&constants, sizeof(constants));
+	dispatcher.SetSampler(0, m_decoding_texture->GetView(), g_object_cache->GetPointSampler());
+	dispatcher.SetStorageImage(m_scaling_texture->GetView(), m_scaling_texture->GetLayout());
+	auto groups = TextureScalerShader::GetDispatchCount(src_width, height);
+	dispatcher.Dispatch(groups.first, groups.second, 1);
+
+	// Copy the part covered by the entry to the final destination.
+	const u32 factor = static_cast<u32>(g_ActiveConfig.iTexScalingFactor);
+	m_scaling_texture->TransitionToLayout(command_buffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+	entry->GetTexture()->TransitionToLayout(command_buffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	VkImageCopy image_copy = { { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+	{ 0, 0, 0 },
+	{ VK_IMAGE_ASPECT_COLOR_BIT, dst_level, 0, 1 },
+	{ 0, 0, 0 },
+	{ width * factor, height * factor, 1 } };
+	vkCmdCopyImage(command_buffer, m_scaling_texture->GetImage(),
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, entry->GetTexture()->GetImage(),
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &image_copy);
+}
+
 bool TextureConverter::CreateTexelBuffer()
 {
 	// Prefer an 8MB buffer if possible, but use less if the device doesn't support this.
@@ -756,7 +979,8 @@ bool TextureConverter::CreateDecodingTexture()
 	m_decoding_texture = Texture2D::Create(
 		DECODING_TEXTURE_WIDTH, DECODING_TEXTURE_HEIGHT, 1, 1, VK_FORMAT_R8G8B8A8_UNORM,
 		VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D_ARRAY, VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+		VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+		VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 	return static_cast<bool>(m_decoding_texture);
 }
 
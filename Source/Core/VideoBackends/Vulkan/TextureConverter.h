@@ -8,6 +8,7 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Vulkan/StreamBuffer.h"
@@ -41,6 +42,12 @@ public:
 		u32 memory_stride, bool is_depth_copy, const EFBRectangle& src_rect,
 		bool scale_by_half);
 
+	// Same as above, but only records the copy to a staging texture. The returned readback waits
+	// for the command buffer when the data is needed, and has to be destroyed before this class.
+	std::unique_ptr<EFBCopyReadback> QueueEncodeTextureToMemory(VkImageView src_texture,
+		const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row, u32 num_blocks_y,
+		bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half);
+
 	// Encodes texture to guest memory in XFB (YUYV) format.
 	void EncodeTextureToMemoryYUYV(void* dst_ptr, u32 dst_width, u32 dst_stride, u32 dst_height,
 		Texture2D* src_texture, const MathUtil::Rectangle<int>& src_rect);
@@ -55,16 +62,30 @@ public:
 		u32 aligned_width, u32 aligned_height, u32 row_stride, const u8* palette,
 		TlutFormat palette_format);
 
+	// Compiles the compute shader of the texture scaler type and factor if it is supported.
+	bool SupportsTextureScaling(int scaling_type, int factor);
+	// Scales the RGBA8 texels in data, expanded_width x height, with the active texture scaler and
+	// copies the scaled width x height part to dst_level of entry.
+	bool ScaleTexture(TextureCache::TCacheEntry* entry, u32 dst_level, const u8* data, u32 width,
+		u32 height, u32 expanded_width);
+
 private:
 	static const u32 ENCODING_TEXTURE_WIDTH = EFB_WIDTH * 4;
 	static const u32 ENCODING_TEXTURE_HEIGHT = 1024;
 	static const VkFormat ENCODING_TEXTURE_FORMAT = VK_FORMAT_B8G8R8A8_UNORM;
 	static const size_t NUM_PALETTE_CONVERSION_SHADERS = 3;
 
+	// Staging textures of finished deferred copies kept for reuse.
+	static const size_t MAX_POOLED_READBACK_TEXTURES = 16;
+
 	// Maximum size of a texture based on BP registers.
 	static const u32 DECODING_TEXTURE_WIDTH = 1024;
 	static const u32 DECODING_TEXTURE_HEIGHT = 1024;
 
+	// Largest scaled texture, scaling is only done for textures smaller than 384x384.
+	static const u32 SCALING_TEXTURE_WIDTH = 2048;
+	static const u32 SCALING_TEXTURE_HEIGHT = 2048;
+
 	bool CreateTexelBuffer();
 	VkBufferView CreateTexelBufferView(VkFormat format) const;
 
@@ -76,8 +97,25 @@ private:
 	bool CreateEncodingTexture();
 	bool CreateEncodingDownloadTexture();
 
+	// Renders the encoded copy to m_encoding_render_texture and leaves it in TRANSFER_SRC layout.
+	bool DrawEncoding(VkImageView src_texture, const EFBCopyFormat& format, u32 native_width,
+		u32 bytes_per_row, u32 num_blocks_y, bool is_depth_copy, const EFBRectangle& src_rect,
+		bool scale_by_half);
+
+	class EncodingReadback;
+	std::unique_ptr<StagingTexture2D> GetReadbackTexture(u32 width, u32 height);
+	void ReturnReadbackTexture(std::unique_ptr<StagingTexture2D> texture);
+
 	bool CreateDecodingTexture();
 
+	// Returns the shader of the active texture scaler if a src_width x src_height texture in the
+	// decoding texture can be scaled, otherwise VK_NULL_HANDLE.
+	VkShaderModule GetScalingShader(u32 src_width, u32 src_height) const;
+	// Scales the src_width x height texels in the decoding texture and copies the scaled
+	// width x height part of the result to the entry.
+	void ScaleDecodingTexture(VkCommandBuffer command_buffer, VkShaderModule shader,
+		TextureCache::TCacheEntry* entry, u32 dst_level, u32 width, u32 height, u32 src_width);
+
 	bool CompileYUYVConversionShaders();
 
 	// Allocates storage in the texel command buffer of the specified size.
@@ -107,6 +145,7 @@ private:
 	VkRenderPass m_encoding_render_pass = VK_NULL_HANDLE;
 	std::unique_ptr<Texture2D> m_encoding_render_texture;
 	std::unique_ptr<StagingTexture2D> m_encoding_download_texture;
+	std::vector<std::unique_ptr<StagingTexture2D>> m_readback_texture_pool;
 
 	// Texture decoding - GX format in memory->RGBA8
 	struct TextureDecodingPipeline
@@ -118,6 +157,10 @@ private:
 	std::map<std::pair<TextureFormat, TlutFormat>, TextureDecodingPipeline> m_decoding_pipelines;
 	std::unique_ptr<Texture2D> m_decoding_texture;
 
+	// Texture scaling - decoded RGBA8->upscaled RGBA8, keyed by scaling type and factor
+	std::map<std::pair<int, int>, VkShaderModule> m_scaling_shaders;
+	std::unique_ptr<Texture2D> m_scaling_texture;
+
 	// XFB encoding/decoding shaders
 	VkShaderModule m_rgb_to_yuyv_shader = VK_NULL_HANDLE;
 	VkShaderModule m_yuyv_to_rgb_shader = VK_NULL_HANDLE;
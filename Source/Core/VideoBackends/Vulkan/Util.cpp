@@ -587,6 +587,17 @@ void UtilityShaderDraw::BindDescriptors()
 			&dummy_uniform_buffer,
 			nullptr };
 
+		set_writes[num_set_writes++] = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			nullptr,
+			set,
+			UBO_DESCRIPTOR_SET_BINDING_UBER,
+			0,
+			1,
+			VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+			nullptr,
+			&dummy_uniform_buffer,
+			nullptr };
+
 		set_writes[num_set_writes++] = {
 			VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, set, UBO_DESCRIPTOR_SET_BINDING_PS, 0, 1,
 			VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, nullptr,
@@ -6,6 +6,7 @@
 #include "VideoBackends/Vulkan/BoundingBox.h"
 #include "VideoBackends/Vulkan/CommandBufferManager.h"
 #include "VideoBackends/Vulkan/FramebufferManager.h"
+#include "VideoBackends/Vulkan/ObjectCache.h"
 #include "VideoBackends/Vulkan/PerfQuery.h"
 #include "VideoBackends/Vulkan/Renderer.h"
 #include "VideoBackends/Vulkan/StateTracker.h"
@@ -121,6 +122,36 @@ u16* VertexManager::GetIndexBuffer()
 	return reinterpret_cast<u16*>(IndexGenerator::GetBasePointer());
 }
 
+void VertexManager::PrepareShaders(PrimitiveType primitive, u32 components, const XFMemory &xfr, const BPMemory &bpm, bool ongputhread)
+{
+	// Draws pick their shaders in StateTracker::CheckForShaderChanges(), this only
+	// fills the shader cache ahead of time for the predictive fifo.
+	if (ongputhread)
+		return;
+
+	bool use_dst_alpha = bpm.dstalpha.enable && bpm.blendmode.alphaupdate &&
+		bpm.zcontrol.pixel_format == PEControl::RGBA6_Z24;
+	PIXEL_SHADER_RENDER_MODE dstalpha_mode = PIXEL_SHADER_RENDER_MODE::PSRM_DEFAULT;
+	if (use_dst_alpha && g_vulkan_context->SupportsDualSourceBlend())
+		dstalpha_mode = PIXEL_SHADER_RENDER_MODE::PSRM_DUAL_SOURCE_BLEND;
+
+	VertexShaderUid vs_uid;
+	GetVertexShaderUID(vs_uid, components, xfr, bpm);
+	g_object_cache->GetVertexShaderForUid(vs_uid);
+
+	if (g_vulkan_context->SupportsGeometryShaders())
+	{
+		GeometryShaderUid gs_uid;
+		GetGeometryShaderUid(gs_uid, primitive, xfr, components);
+		if (!gs_uid.GetUidData().IsPassthrough())
+			g_object_cache->GetGeometryShaderForUid(gs_uid);
+	}
+
+	PixelShaderUid ps_uid;
+	GetPixelShaderUID(ps_uid, dstalpha_mode, components, xfr, bpm);
+	g_object_cache->GetPixelShaderForUid(ps_uid);
+}
+
 void VertexManager::vFlush(bool use_dst_alpha)
 {
 	const VertexFormat* vertex_format =
@@ -162,6 +193,7 @@ void VertexManager::vFlush(bool use_dst_alpha)
 	StateTracker::GetInstance()->UpdateVertexShaderConstants();
 	StateTracker::GetInstance()->UpdateGeometryShaderConstants();
 	StateTracker::GetInstance()->UpdatePixelShaderConstants();
+	StateTracker::GetInstance()->UpdateUberShaderConstants(VertexLoaderManager::g_current_components);
 	
 	// Commit memory to device.
 	// NOTE: This must be done after constant upload, as a constant buffer overrun can cause
@@ -171,6 +203,7 @@ void VertexManager::vFlush(bool use_dst_alpha)
 
 	// Flush all EFB pokes and invalidate the peek cache.
 	FramebufferManager::GetInstance()->InvalidatePeekCache();
+	FramebufferManager::GetInstance()->InvalidateResolvedEFB();
 	FramebufferManager::GetInstance()->FlushEFBPokes();
 
 	// If bounding box is enabled, we need to flush any changes first, then invalidate what we have.
@@ -240,6 +240,7 @@ void VulkanContext::PopulateBackendInfo(VideoConfig* config)
 	config->backend_info.bSupportsDualSourceBlend = false;      // Dependent on features.
 	config->backend_info.bSupportsGeometryShaders = false;      // Dependent on features.
 	config->backend_info.bSupportsGSInstancing = false;         // Dependent on features.
+	config->backend_info.bSupportsVSLayerOutput = false;        // No support yet.
 	config->backend_info.bSupportsBBox = false;                 // Dependent on features.
 	config->backend_info.bSupportsSSAA = false;                 // Dependent on features.
 	config->backend_info.bSupportsDepthClamp = false;           // Dependent on features.
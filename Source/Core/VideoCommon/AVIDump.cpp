@@ -13,6 +13,7 @@ extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/mathematics.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
@@ -121,6 +122,59 @@ static std::string GetDumpPath(const std::string& format)
 	return s_dump_path;
 }
 
+// Hardware encoders list their device surface formats next to the system memory ones they
+// upload themselves, only the latter can be fed from the frame dump readback.
+static AVPixelFormat ChooseEncoderPixelFormat(const AVCodec* codec, AVPixelFormat preferred)
+{
+	if (!codec->pix_fmts)
+		return preferred;
+
+	AVPixelFormat fallback = AV_PIX_FMT_NONE;
+	for (const AVPixelFormat* fmt = codec->pix_fmts; *fmt != AV_PIX_FMT_NONE; ++fmt)
+	{
+		if (*fmt == preferred)
+			return preferred;
+
+		const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(*fmt);
+		if (!desc || (desc->flags & AV_PIX_FMT_FLAG_HWACCEL))
+			continue;
+		if (*fmt == AV_PIX_FMT_NV12 || fallback == AV_PIX_FMT_NONE)
+			fallback = *fmt;
+	}
+	return fallback;
+}
+
+static bool OpenEncoder(const AVCodec* codec, const AVOutputFormat* output_format,
+	AVPixelFormat preferred_pix_fmt, int width, int height)
+{
+	AVPixelFormat pix_fmt = ChooseEncoderPixelFormat(codec, preferred_pix_fmt);
+	if (pix_fmt == AV_PIX_FMT_NONE || !(s_codec_context = avcodec_alloc_context3(codec)))
+		return false;
+
+	// Force XVID FourCC for better compatibility
+	if (codec->id == AV_CODEC_ID_MPEG4)
+		s_codec_context->codec_tag = MKTAG('X', 'V', 'I', 'D');
+
+	s_codec_context->codec_type = AVMEDIA_TYPE_VIDEO;
+	s_codec_context->bit_rate = g_Config.iBitrateKbps * 1000;
+	s_codec_context->width = width;
+	s_codec_context->height = height;
+	s_codec_context->time_base.num = 1;
+	s_codec_context->time_base.den = VideoInterface::GetTargetRefreshRate();
+	s_codec_context->gop_size = 12;
+	s_codec_context->pix_fmt = pix_fmt;
+
+	if (output_format->flags & AVFMT_GLOBALHEADER)
+		s_codec_context->flags |= CODEC_FLAG_GLOBAL_HEADER;
+
+	if (avcodec_open2(s_codec_context, codec, nullptr) < 0)
+	{
+		avcodec_free_context(&s_codec_context);
+		return false;
+	}
+	return true;
+}
+
 bool AVIDump::CreateVideoFile()
 {
 	const std::string& s_format = g_Config.sDumpFormat;
@@ -157,35 +211,39 @@ bool AVIDump::CreateVideoFile()
 			WARN_LOG(VIDEO, "Invalid codec %s", codec_name.c_str());
 	}
 
+	const AVPixelFormat pix_fmt = g_Config.bUseFFV1 ? AV_PIX_FMT_BGRA : AV_PIX_FMT_YUV420P;
 	const AVCodec* codec = nullptr;
 
-	if (!(codec = avcodec_find_encoder(codec_id)) ||
-		!(s_codec_context = avcodec_alloc_context3(codec)))
+	// A named encoder (h264_nvenc, hevc_qsv, h264_amf...) is tried first, the software encoder
+	// for the codec is used when the device or driver isn't there.
+	const std::string& encoder_name = g_Config.sDumpEncoder;
+	if (!g_Config.bUseFFV1 && !encoder_name.empty())
 	{
-		ERROR_LOG(VIDEO, "Could not find encoder or allocate codec context");
-		return false;
+		codec = avcodec_find_encoder_by_name(encoder_name.c_str());
+		if (!codec)
+		{
+			WARN_LOG(VIDEO, "Invalid encoder %s", encoder_name.c_str());
+		}
+		else if (!OpenEncoder(codec, output_format, pix_fmt, s_width, s_height))
+		{
+			WARN_LOG(VIDEO, "Could not open encoder %s, falling back to software encoding",
+				encoder_name.c_str());
+			codec = nullptr;
+		}
 	}
 
-	// Force XVID FourCC for better compatibility
-	if (codec->id == AV_CODEC_ID_MPEG4)
-		s_codec_context->codec_tag = MKTAG('X', 'V', 'I', 'D');
-
-	s_codec_context->codec_type = AVMEDIA_TYPE_VIDEO;
-	s_codec_context->bit_rate = g_Config.iBitrateKbps * 1000;
-	s_codec_context->width = s_width;
-	s_codec_context->height = s_height;
-	s_codec_context->time_base.num = 1;
-	s_codec_context->time_base.den = VideoInterface::GetTargetRefreshRate();
-	s_codec_context->gop_size = 12;
-	s_codec_context->pix_fmt = g_Config.bUseFFV1 ? AV_PIX_FMT_BGRA : AV_PIX_FMT_YUV420P;
-
-	if (output_format->flags & AVFMT_GLOBALHEADER)
-		s_codec_context->flags |= CODEC_FLAG_GLOBAL_HEADER;
-
-	if (avcodec_open2(s_codec_context, codec, nullptr) < 0)
+	if (!codec)
 	{
-		ERROR_LOG(VIDEO, "Could not open codec");
-		return false;
+		if (!(codec = avcodec_find_encoder(codec_id)))
+		{
+			ERROR_LOG(VIDEO, "Could not find encoder");
+			return false;
+		}
+		if (!OpenEncoder(codec, output_format, pix_fmt, s_width, s_height))
+		{
+			ERROR_LOG(VIDEO, "Could not open codec");
+			return false;
+		}
 	}
 
 	s_src_frame = av_frame_alloc();
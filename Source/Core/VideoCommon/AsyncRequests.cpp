@@ -8,6 +8,7 @@
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
@@ -131,13 +132,30 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
 	break;
 
 	case Event::EFB_PEEK_COLOR:
+		g_renderer->OnEFBRead();
 		*e.efb_peek.data = g_renderer->AccessEFB(EFBAccessType::PeekColor, e.efb_peek.x, e.efb_peek.y, 0);
 		break;
 
 	case Event::EFB_PEEK_Z:
+		g_renderer->OnEFBRead();
 		*e.efb_peek.data = g_renderer->AccessEFB(EFBAccessType::PeekZ, e.efb_peek.x, e.efb_peek.y, 0);
 		break;
 
+	case Event::EFB_PEEK_COLOR_TILE:
+	case Event::EFB_PEEK_Z_TILE:
+	{
+		// The backends keep a readback copy of the EFB, so only the first peek waits for the GPU.
+		g_renderer->OnEFBRead();
+		EFBAccessType type = e.type == Event::EFB_PEEK_COLOR_TILE ? EFBAccessType::PeekColor : EFBAccessType::PeekZ;
+		u32* data = e.efb_peek.data;
+		for (u32 y = 0; y < EFB_PEEK_TILE_SIZE; y++)
+		{
+			for (u32 x = 0; x < EFB_PEEK_TILE_SIZE; x++)
+				*data++ = g_renderer->AccessEFB(type, e.efb_peek.x + x, e.efb_peek.y + y, 0);
+		}
+	}
+	break;
+
 	case Event::SWAP_EVENT:
 		g_renderer->Swap(e.swap_event.xfbAddr, e.swap_event.fbWidth, e.swap_event.fbStride, e.swap_event.fbHeight, rc, e.time);
 		break;
@@ -155,6 +173,13 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
 	case Event::PERF_QUERY:
 		g_perf_query->FlushResults();
 		break;
+	case Event::PERF_QUERY_POLL:
+		g_perf_query->PollResults();
+		break;
+	case Event::FLUSH_EFB_COPIES:
+		if (g_texture_cache)
+			g_texture_cache->FlushEFBCopies();
+		break;
 
 	}
 }
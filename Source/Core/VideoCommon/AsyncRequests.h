@@ -25,9 +25,13 @@ public:
 			EFB_POKE_Z,
 			EFB_PEEK_COLOR,
 			EFB_PEEK_Z,
+			EFB_PEEK_COLOR_TILE,
+			EFB_PEEK_Z_TILE,
 			SWAP_EVENT,
 			BBOX_READ,
 			PERF_QUERY,
+			PERF_QUERY_POLL,
+			FLUSH_EFB_COPIES,
 		} type;
 		u64 time;
 
@@ -40,6 +44,8 @@ public:
 				u32 data;
 			} efb_poke;
 
+			// For the tile peeks, x/y is the top left of the tile and data receives
+			// EFB_PEEK_TILE_SIZE rows of EFB_PEEK_TILE_SIZE values.
 			struct
 			{
 				u16 x;
@@ -74,6 +80,7 @@ public:
 			PullEventsInternal();
 	}
 	void PushEvent(const Event& event, bool blocking = false);
+	bool HasPendingEvents() const { return !m_empty.IsSet(); }
 	void SetEnable(bool enable);
 	void SetPassthrough(bool enable);
 
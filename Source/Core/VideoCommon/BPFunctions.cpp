@@ -12,6 +12,7 @@
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -139,6 +140,7 @@ void ClearScreen(const EFBRectangle &rc)
 			z = Z24ToZ16ToZ24(z);
 		}
 		g_renderer->ClearScreen(rc, colorEnable, alphaEnable, zEnable, color, z);
+		VideoBackendBase::InvalidateEFBPeekTiles();
 	}
 }
 
@@ -209,6 +211,8 @@ void OnPixelFormatChange()
 	g_renderer->ReinterpretPixelData(convtype);
 
 skip:
+	// Peeks convert the values for the current format.
+	VideoBackendBase::InvalidateEFBPeekTiles();
 	DEBUG_LOG(VIDEO, "pixelfmt: pixel=%d, zc=%d", static_cast<int>(new_format), static_cast<int>(bpmem.zcontrol.zformat));
 
 	g_renderer->StorePixelFormat(new_format);
@@ -19,11 +19,13 @@
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/BPStructs.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/ShaderGenCommon.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
@@ -38,8 +40,6 @@ static u32 mapTexAddress;
 static bool mapTexFound;
 static int numWrites;
 
-extern bool g_bSkipCurrentFrame;
-
 static const float s_gammaLUT[] =
 {
 	1.0f,
@@ -120,6 +120,7 @@ void BPWritten(const BPCmd& bp)
 	FlushPipeline();
 
 	((u32*)&bpmem)[bp.address] = bp.newvalue;
+	InvalidateShaderUIDs();
 
 	switch (bp.address)
 	{
@@ -211,6 +212,9 @@ void BPWritten(const BPCmd& bp)
 		switch (bp.newvalue & 0xFF)
 		{
 		case 0x02:
+			// The game may read the results of its EFB copies once it sees this
+			if (g_texture_cache)
+				g_texture_cache->FlushEFBCopies();
 			if (!Fifo::UseDeterministicGPUThread())
 				PixelEngine::SetFinish(); // may generate interrupt
 			DEBUG_LOG(VIDEO, "GXSetDrawDone SetPEFinish (value: 0x%02X)", (bp.newvalue & 0xFFFF));
@@ -222,11 +226,15 @@ void BPWritten(const BPCmd& bp)
 		}
 		return;
 	case BPMEM_PE_TOKEN_ID: // Pixel Engine Token ID
+		if (g_texture_cache)
+			g_texture_cache->FlushEFBCopies();
 		if (!Fifo::UseDeterministicGPUThread())
 			PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), false);
 		DEBUG_LOG(VIDEO, "SetPEToken 0x%04x", (bp.newvalue & 0xFFFF));
 		return;
 	case BPMEM_PE_TOKEN_INT_ID: // Pixel Engine Interrupt Token ID
+		if (g_texture_cache)
+			g_texture_cache->FlushEFBCopies();
 		if (!Fifo::UseDeterministicGPUThread())
 			PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), true);
 		DEBUG_LOG(VIDEO, "SetPEToken + INT 0x%04x", (bp.newvalue & 0xFFFF));
@@ -237,6 +245,7 @@ void BPWritten(const BPCmd& bp)
 		// It can also optionally clear the EFB while copying from it. To emulate this, we of course copy first and clear afterwards.
 	case BPMEM_TRIGGER_EFB_COPY: // Copy EFB Region or Render to the XFB or Clear the screen.
 	{
+		FrameProfiler::ScopedPass efb_copy_pass(FrameProfiler::PASS_EFB_COPY);
 		// The bottom right is within the rectangle
 		// The values in bpmem.copyTexSrcXY and bpmem.copyTexSrcWH are updated in case 0x49 and 0x4a in this function
 
@@ -256,6 +265,7 @@ void BPWritten(const BPCmd& bp)
 		// Check if we are to copy from the EFB or draw to the XFB
 		if (PE_copy.copy_to_xfb == 0)
 		{
+			g_renderer->OnEFBRead();
 			// bpmem.zcontrol.pixel_format to PEControl::Z24 is when the game wants to copy from ZBuffer (Zbuffer uses 24-bit Format)
 			bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
 			g_texture_cache->CopyRenderTargetToTexture(destAddr, PE_copy.tp_realFormat(), destStride,
@@ -0,0 +1,121 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+
+#include "VideoCommon/BenchmarkLog.h"
+#include "VideoCommon/FrameProfiler.h"
+#include "VideoCommon/Statistics.h"
+
+namespace BenchmarkLog
+{
+static std::mutex s_mutex;
+static std::ofstream s_file;
+static bool s_in_run = false;
+static RunSummary s_summary;
+static u64 s_last_frame_us = 0;
+static s64 s_last_shader_count = 0;
+
+static s64 GetShaderCount()
+{
+	return static_cast<s64>(stats.numVertexShadersCreated) + stats.numPixelShadersCreated +
+		stats.numGeometryShadersCreated + stats.numHullShadersCreated + stats.numDomainShadersCreated;
+}
+
+bool Open(const std::string& path)
+{
+	std::lock_guard<std::mutex> lk(s_mutex);
+	OpenFStream(s_file, path, std::ios_base::out | std::ios_base::trunc);
+	if (!s_file.is_open())
+		return false;
+
+	s_file << "run,frame,frame_ms";
+	for (int i = 0; i < FrameProfiler::PASS_COUNT; i++)
+		s_file << ",cpu_" << FrameProfiler::GetPassCSVName(static_cast<FrameProfiler::Pass>(i)) << "_ms";
+	for (int i = 0; i < FrameProfiler::PASS_COUNT; i++)
+		s_file << ",gpu_" << FrameProfiler::GetPassCSVName(static_cast<FrameProfiler::Pass>(i)) << "_ms";
+	s_file << ",draw_calls,shader_compiles" << std::endl;
+
+	FrameProfiler::SetForced(true);
+	return true;
+}
+
+void Close()
+{
+	std::lock_guard<std::mutex> lk(s_mutex);
+	FrameProfiler::SetForced(false);
+	if (s_file.is_open())
+		s_file.close();
+	s_in_run = false;
+}
+
+bool IsOpen()
+{
+	std::lock_guard<std::mutex> lk(s_mutex);
+	return s_file.is_open();
+}
+
+void BeginRun(const std::string& name)
+{
+	std::lock_guard<std::mutex> lk(s_mutex);
+	s_summary = RunSummary();
+	s_summary.name = name;
+	s_last_frame_us = 0;
+	s_last_shader_count = GetShaderCount();
+	s_in_run = true;
+}
+
+RunSummary EndRun()
+{
+	std::lock_guard<std::mutex> lk(s_mutex);
+	s_in_run = false;
+	s_file.flush();
+	return s_summary;
+}
+
+void EndFrame()
+{
+	std::lock_guard<std::mutex> lk(s_mutex);
+	if (!s_in_run || !s_file.is_open())
+		return;
+
+	// Backends reset the counters when they start, anything below the last count is new
+	const s64 shader_count = GetShaderCount();
+	if (shader_count < s_last_shader_count)
+		s_last_shader_count = 0;
+	const s64 shader_compiles = shader_count - s_last_shader_count;
+	s_last_shader_count = shader_count;
+
+	// The first swap of a run only starts the clock
+	const u64 now = Common::Timer::GetTimeUs();
+	const u64 last_frame_us = s_last_frame_us;
+	s_last_frame_us = now;
+	if (!last_frame_us)
+		return;
+
+	const double frame_ms = (now - last_frame_us) / 1000.0;
+	FrameProfiler::PassTimes cpu_times;
+	FrameProfiler::PassTimes gpu_times;
+	const bool has_gpu_times = FrameProfiler::GetLastFrame(&cpu_times, &gpu_times);
+
+	s_file << s_summary.name << ',' << s_summary.frames << StringFromFormat(",%.3f", frame_ms);
+	for (double time : cpu_times)
+		s_file << StringFromFormat(",%.3f", time);
+	for (double time : gpu_times)
+		s_file << (has_gpu_times ? StringFromFormat(",%.3f", time) : std::string(","));
+	s_file << ',' << stats.thisFrame.numDrawCalls << ',' << shader_compiles << '\n';
+
+	s_summary.frames++;
+	s_summary.total_ms += frame_ms;
+	s_summary.max_frame_ms = std::max(s_summary.max_frame_ms, frame_ms);
+	s_summary.draw_calls += stats.thisFrame.numDrawCalls;
+	s_summary.shader_compiles += shader_compiles;
+}
+}
@@ -0,0 +1,35 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Per frame times, draw calls and shader compiles of benchmark runs, written as CSV.
+// A run is usually one FIFO log replayed by the nogui benchmark mode. Runs are started and
+// finished while emulation is stopped, frames are added by the GPU thread.
+namespace BenchmarkLog
+{
+struct RunSummary
+{
+	std::string name;
+	u32 frames = 0;
+	double total_ms = 0.0;
+	double max_frame_ms = 0.0;
+	u64 draw_calls = 0;
+	u64 shader_compiles = 0;
+};
+
+bool Open(const std::string& path);
+void Close();
+bool IsOpen();
+
+void BeginRun(const std::string& name);
+RunSummary EndRun();
+
+// Called once per swap.
+void EndFrame();
+}
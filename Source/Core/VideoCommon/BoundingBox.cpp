@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 
+#include <atomic>
 
 #include "VideoBackends/Software/Clipper.h"
 #include "VideoBackends/Software/Rasterizer.h"
@@ -29,6 +30,11 @@ static VAT myVat;
 static TVtxDesc vertexDesc;
 static PortableVertexDeclaration vertexDecl;
 
+// Written by the GPU thread, read by the CPU thread
+static std::atomic<u16> s_stable_coords[4];
+static std::atomic<bool> s_stable_valid{ false };
+static std::atomic<bool> s_readback_requested{ false };
+
 // Gets the pointer to the current buffer position
 
 
@@ -147,6 +153,34 @@ void DoState(PointerWrap& p)
 {
 	p.Do(active);
 	p.Do(coords);
+	if (p.GetMode() == PointerWrap::MODE_READ)
+		InvalidateStableCoords();
+}
+
+bool GetStableCoord(int index, u16* value)
+{
+	s_readback_requested.store(true, std::memory_order_relaxed);
+	if (!s_stable_valid.load(std::memory_order_acquire))
+		return false;
+	*value = s_stable_coords[index].load(std::memory_order_relaxed);
+	return true;
+}
+
+bool TakeReadbackRequest()
+{
+	return s_readback_requested.exchange(false, std::memory_order_relaxed);
+}
+
+void SetStableCoords(const u16* values)
+{
+	for (int i = 0; i < 4; i++)
+		s_stable_coords[i].store(values[i], std::memory_order_relaxed);
+	s_stable_valid.store(true, std::memory_order_release);
+}
+
+void InvalidateStableCoords()
+{
+	s_stable_valid.store(false, std::memory_order_release);
 }
 
 } // namespace BoundingBox
@@ -41,4 +41,13 @@ void Prepare(const VAT& vat, int primitive, const TVtxDesc& vtxDesc, const Porta
 // Save state
 void DoState(PointerWrap& p);
 
+// Asynchronous GPU readback, the emulated CPU gets the last result the GPU thread copied
+// at swap time instead of waiting for the GPU on every register read.
+// Returns false when nothing was read back yet, the caller has to sync then.
+bool GetStableCoord(int index, u16* value);
+// GPU thread, true if the emulated CPU read the bounding box since the last call.
+bool TakeReadbackRequest();
+void SetStableCoords(const u16* values);
+void InvalidateStableCoords();
+
 }; // end of namespace BoundingBox
@@ -21,8 +21,6 @@
 
 namespace CommandProcessor
 {
-static CoreTiming::EventType* et_UpdateInterrupts;
-
 // TODO(ector): Warn on bbox read/write
 
 // STATE_TO_SAVE
@@ -42,16 +40,15 @@ static Common::Flag s_interrupt_waiting;
 static Common::Flag s_interrupt_token_waiting;
 static Common::Flag s_interrupt_finish_waiting;
 
+// Interrupt change posted by the GPU thread in dual core: 0 is none, otherwise the UpdateInterrupts
+// argument plus one. Only one can be in flight, s_interrupt_waiting stays set until it is delivered.
+static std::atomic<u32> s_pending_interrupt;
+
 static bool IsOnThread()
 {
 	return SConfig::GetInstance().bCPUThread;
 }
 
-static void UpdateInterrupts_Wrapper(u64 userdata, s64 cyclesLate)
-{
-	UpdateInterrupts(userdata);
-}
-
 void DoState(PointerWrap& p)
 {
 	p.DoPOD(m_CPStatusReg);
@@ -68,6 +65,10 @@ void DoState(PointerWrap& p)
 	p.Do(s_interrupt_waiting);
 	p.Do(s_interrupt_token_waiting);
 	p.Do(s_interrupt_finish_waiting);
+
+	u32 pending_interrupt = s_pending_interrupt.load();
+	p.Do(pending_interrupt);
+	s_pending_interrupt.store(pending_interrupt);
 }
 
 static inline void WriteLow(volatile u32& _reg, u16 lowbits)
@@ -115,8 +116,7 @@ void Init()
 	s_interrupt_waiting.Clear();
 	s_interrupt_finish_waiting.Clear();
 	s_interrupt_token_waiting.Clear();
-
-	et_UpdateInterrupts = CoreTiming::RegisterEvent("CPInterrupt", UpdateInterrupts_Wrapper);
+	s_pending_interrupt.store(0);
 }
 
 void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
@@ -349,7 +349,17 @@ void UpdateInterrupts(u64 userdata)
 void UpdateInterruptsFromVideoBackend(u64 userdata)
 {
 	if (!Fifo::UseDeterministicGPUThread())
-		CoreTiming::ScheduleEvent(0, et_UpdateInterrupts, userdata, CoreTiming::FromThread::NON_CPU);
+		s_pending_interrupt.store(static_cast<u32>(userdata) + 1, std::memory_order_release);
+}
+
+void DeliverPendingInterrupts()
+{
+	if (!s_pending_interrupt.load(std::memory_order_relaxed))
+		return;
+
+	const u32 pending_interrupt = s_pending_interrupt.exchange(0, std::memory_order_acquire);
+	if (pending_interrupt)
+		UpdateInterrupts(pending_interrupt - 1);
 }
 
 bool IsInterruptWaiting()
@@ -149,6 +149,8 @@ void SetCPStatusFromCPU();
 void GatherPipeBursted();
 void UpdateInterrupts(u64 userdata);
 void UpdateInterruptsFromVideoBackend(u64 userdata);
+// Delivers the interrupt change posted by UpdateInterruptsFromVideoBackend, called by the CPU thread
+void DeliverPendingInterrupts();
 
 bool IsInterruptWaiting();
 void SetInterruptTokenWaiting(bool waiting);
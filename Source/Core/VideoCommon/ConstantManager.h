@@ -59,3 +59,25 @@ struct TessellationShaderConstants
 	float4 tessparams;
 	int4 cullparams;
 };
+
+// Raw TEV/XF state read by the ubershaders, see UberShaderCommon.cpp for the layout in the shaders.
+struct UberShaderConstants
+{
+	u32 genmode;
+	u32 alphatest;
+	u32 fogparam3;
+	u32 fogrange;
+	u32 ztex2;
+	u32 tevindref;
+	u32 flags;
+	u32 pad0;
+	u32 components;
+	u32 numcolorchans;
+	u32 numtexgens;
+	u32 dualtextrans;
+	u32 tevorder[8];
+	u32 tevksel[8];
+	uint4 combiners[16]; // color, alpha, tevind, unused
+	u32 chancontrol[4];  // color0, color1, alpha0, alpha1
+	uint4 texgen[8];     // texMtxInfo, postMtxInfo, unused, unused
+};
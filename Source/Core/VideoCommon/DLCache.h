@@ -0,0 +1,35 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+// Display list cache.
+// Display lists that are called repeatedly with the same contents are recorded in
+// a compact program: runs of state commands (BP/CP/XF loads) are replayed through the
+// opcode decoder, while draws reuse the already converted vertex loader output, so
+// neither the vertex loader nor the draw parsing runs again for them. Draws with indexed
+// attributes are only reused while the vertex arrays they read stay unchanged.
+namespace DLCache
+{
+
+void Init();
+void Shutdown();
+void Clear();
+
+// Removes entries that have not been used for a while. Called once per frame.
+void ProgressiveCleanup();
+
+// Host memory held by the recorded display lists
+size_t GetMemoryUsage();
+
+}  // namespace DLCache
+
+// NOTE - outside the namespace on purpose.
+// Returns true if the display list was executed from the cache, in which case
+// cycles holds the cycle count of the list.
+bool HandleDisplayList(u32 address, u32 size, u32* cycles);
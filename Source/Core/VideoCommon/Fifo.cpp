@@ -13,6 +13,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -26,6 +27,7 @@
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/OpcodeDecodingSC.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoConfig.h"
@@ -70,6 +72,16 @@ static u8* s_video_buffer_pp_read_ptr;
 // polls, it's just atomic.
 // - The pp_read_ptr is the CPU preprocessing version of the read_ptr.
 
+// Predictive FIFO state, only touched by the GPU thread.
+// s_predict_ahead bytes starting at s_predict_cp_read_ptr have been pushed to the
+// look-ahead decoder, the next chunk to push is at s_predict_read_ptr.
+static bool s_predict_synced;
+static u32 s_predict_cp_read_ptr;
+static u32 s_predict_read_ptr;
+static u32 s_predict_ahead;
+// Bound on how far the scan may run ahead, so a huge backlog doesn't delay the real decoder.
+static constexpr u32 PREDICT_MAX_AHEAD = 256 * 1024;
+
 static std::atomic<int> s_sync_ticks;
 static bool s_syncing_suspended;
 static Common::Event s_sync_wakeup_event;
@@ -89,6 +101,7 @@ void DoState(PointerWrap& p)
 
 	p.Do(s_sync_ticks);
 	p.Do(s_syncing_suspended);
+	s_predict_synced = false;
 }
 
 void PauseAndLock(bool doLock, bool unpauseOnUnlock)
@@ -96,6 +109,17 @@ void PauseAndLock(bool doLock, bool unpauseOnUnlock)
 	if (doLock)
 	{
 		SyncGPU(SyncGPUReason::Other);
+
+		// Savestates are taken while paused, deferred EFB copies have to be in RAM by then. The GPU
+		// thread doesn't handle requests once it is paused.
+		if (g_ActiveConfig.bDeferEFBCopies)
+		{
+			AsyncRequests::Event e;
+			e.type = AsyncRequests::Event::FLUSH_EFB_COPIES;
+			e.time = 0;
+			AsyncRequests::GetInstance()->PushEvent(e, true);
+		}
+
 		EmulatorState(false);
 		const SConfig& param = SConfig::GetInstance();
 
@@ -116,6 +140,7 @@ void Init()
 	// Padded so that SIMD overreads in the vertex loader are safe
 	s_video_buffer = static_cast<u8*>(Common::AllocateMemoryPages(FIFO_SIZE + 4));
 	ResetVideoBuffer();
+	OpcodeDecoderSC_Init();
 	if (SConfig::GetInstance().bCPUThread)
 		s_gpu_mainloop.Prepare();
 	s_sync_ticks.store(0);
@@ -126,6 +151,7 @@ void Shutdown()
 	if (s_gpu_mainloop.IsRunning())
 		PanicAlert("Fifo shutting down while active");
 
+	OpcodeDecoderSC_Shutdown();
 	Common::FreeMemoryPages(s_video_buffer, FIFO_SIZE + 4);
 	s_video_buffer = nullptr;
 	s_video_buffer_write_ptr = nullptr;
@@ -287,6 +313,55 @@ void ResetVideoBuffer()
 	s_video_buffer_pp_read_ptr = s_video_buffer;
 	s_fifo_aux_write_ptr = s_fifo_aux_data;
 	s_fifo_aux_read_ptr = s_fifo_aux_data;
+	s_predict_synced = false;
+}
+
+// Scans the part of the FIFO the CPU has already written but the GPU hasn't read yet,
+// so that the shaders for upcoming draws get queued for compilation.
+static void RunPredictiveFifo(const SCPFifoStruct& fifo)
+{
+	u32 distance = fifo.CPReadWriteDistance;
+	if (!s_predict_synced || fifo.CPReadPointer != s_predict_cp_read_ptr || s_predict_ahead > distance)
+	{
+		OpcodeDecoderSC_Reset(s_video_buffer_read_ptr, s_video_buffer_write_ptr);
+		s_predict_cp_read_ptr = s_predict_read_ptr = fifo.CPReadPointer;
+		s_predict_ahead = 0;
+		s_predict_synced = true;
+	}
+
+	if (s_predict_ahead >= distance)
+		return;
+
+	while (s_predict_ahead < distance && s_predict_ahead < PREDICT_MAX_AHEAD)
+	{
+		const u8* data = Memory::GetPointer(s_predict_read_ptr);
+		if (!data)
+		{
+			s_predict_synced = false;
+			return;
+		}
+		OpcodeDecoderSC_Push(data, 32);
+		if (s_predict_read_ptr == fifo.CPEnd)
+			s_predict_read_ptr = fifo.CPBase;
+		else
+			s_predict_read_ptr += 32;
+		s_predict_ahead += 32;
+	}
+	OpcodeDecoderSC_Run();
+}
+
+// Called after the real decoder consumed the 32 bytes before read_ptr.
+static void ConsumePredictiveFifo(u32 read_ptr)
+{
+	if (s_predict_ahead >= 32)
+	{
+		s_predict_ahead -= 32;
+		s_predict_cp_read_ptr = read_ptr;
+	}
+	else
+	{
+		s_predict_synced = false;
+	}
 }
 
 // Description: Main FIFO update loop
@@ -308,8 +383,6 @@ void RunGpuLoop()
 
 		if (s_use_deterministic_gpu_thread)
 		{
-			AsyncRequests::GetInstance()->PullEvents();
-
 			// All the fifo/CP stuff is on the CPU.  We just need to run the opcode decoder.
 			u8* seen_ptr = s_video_buffer_seen_ptr;
 			u8* write_ptr = s_video_buffer_write_ptr;
@@ -317,9 +390,14 @@ void RunGpuLoop()
 			if (write_ptr > seen_ptr)
 			{
 				g_VideoData.SetReadPosition(s_video_buffer_read_ptr, write_ptr);
+				TRACE_SCOPE("Fifo::RunGpuLoop");
 				s_video_buffer_read_ptr = OpcodeDecoder::Run<false>(g_VideoData, nullptr);
 				s_video_buffer_seen_ptr = write_ptr;
 			}
+
+			// Events are handled after the commands that were pushed before them, so swaps and EFB
+			// pokes don't need the CPU to wait for the GPU thread to catch up.
+			AsyncRequests::GetInstance()->PullEvents();
 		}
 		else
 		{
@@ -329,6 +407,8 @@ void RunGpuLoop()
 
 			CommandProcessor::SetCPStatusFromGPU();
 
+			const bool predictive_fifo = g_ActiveConfig.bPredictiveFifo;
+
 			// check if we are able to run this buffer
 			while (!CommandProcessor::IsInterruptWaiting() && fifo.bFF_GPReadEnable &&
 				fifo.CPReadWriteDistance && !AtBreakpoint())
@@ -336,6 +416,9 @@ void RunGpuLoop()
 				if (param.bSyncGPU && s_sync_ticks.load() < param.iSyncGpuMinDistance)
 					break;
 
+				if (predictive_fifo)
+					RunPredictiveFifo(fifo);
+
 				u32 cyclesExecuted = 0;
 				u32 readPtr = fifo.CPReadPointer;
 				ReadDataFromFifo(readPtr);
@@ -352,13 +435,19 @@ void RunGpuLoop()
 
 				u8* write_ptr = s_video_buffer_write_ptr;
 				g_VideoData.SetReadPosition(s_video_buffer_read_ptr, write_ptr);
-				s_video_buffer_read_ptr = OpcodeDecoder::Run(g_VideoData, &cyclesExecuted);
+				{
+					TRACE_SCOPE("Fifo::RunGpuLoop");
+					s_video_buffer_read_ptr = OpcodeDecoder::Run(g_VideoData, &cyclesExecuted);
+				}
 
 				Common::AtomicStore(fifo.CPReadPointer, readPtr);
 				Common::AtomicAdd(fifo.CPReadWriteDistance, -32);
 				if ((write_ptr - s_video_buffer_read_ptr) == 0)
 					Common::AtomicStore(fifo.SafeCPReadPointer, fifo.CPReadPointer);
 
+				if (predictive_fifo)
+					ConsumePredictiveFifo(readPtr);
+
 				CommandProcessor::SetCPStatusFromGPU();
 
 				if (param.bSyncGPU)
@@ -421,8 +510,9 @@ void RunGpu()
 {
 	const SConfig& param = SConfig::GetInstance();
 
-	// wake up GPU thread
-	if (param.bCPUThread && !s_use_deterministic_gpu_thread)
+	// wake up GPU thread, the deterministic one only needs it for queued events
+	if (param.bCPUThread &&
+		(!s_use_deterministic_gpu_thread || AsyncRequests::GetInstance()->HasPendingEvents()))
 	{
 		s_gpu_mainloop.Wakeup();
 	}
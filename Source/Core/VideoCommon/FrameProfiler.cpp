@@ -0,0 +1,221 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <fstream>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+
+#include "VideoCommon/FrameProfiler.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace FrameProfiler
+{
+static constexpr u64 OVERLAY_REFRESH_INTERVAL_US = 1000000;
+
+static const char* const s_pass_names[PASS_COUNT] = {
+	"Vertex loading",
+	"Draw",
+	"Shader compilation",
+	"EFB copy",
+	"Post processing",
+	"Present",
+};
+
+static const char* const s_pass_csv_names[PASS_COUNT] = {
+	"vertex_loading",
+	"draw",
+	"shader_compilation",
+	"efb_copy",
+	"post_processing",
+	"present",
+};
+
+bool g_active = false;
+static bool s_forced = false;
+
+static std::unique_ptr<GPUTimer> s_gpu_timer;
+static std::array<u64, PASS_COUNT> s_begin_us;
+static std::array<int, PASS_COUNT> s_depth;
+static PassTimes s_cpu_frame;
+
+// Sums since the overlay was last refreshed, the overlay shows their averages
+static PassTimes s_cpu_sum;
+static PassTimes s_gpu_sum;
+static u32 s_cpu_frames = 0;
+static u32 s_gpu_frames = 0;
+static PassTimes s_cpu_average;
+static PassTimes s_gpu_average;
+static bool s_has_gpu_average = false;
+static u64 s_last_refresh_us = 0;
+
+static PassTimes s_last_cpu_frame;
+static PassTimes s_last_gpu_frame;
+static bool s_last_has_gpu_frame = false;
+
+static u64 s_frame_number = 0;
+static std::ofstream s_csv_file;
+
+static void ResetTimes()
+{
+	s_depth.fill(0);
+	s_cpu_frame.fill(0.0);
+	s_cpu_sum.fill(0.0);
+	s_gpu_sum.fill(0.0);
+	s_cpu_average.fill(0.0);
+	s_gpu_average.fill(0.0);
+	s_cpu_frames = 0;
+	s_gpu_frames = 0;
+	s_has_gpu_average = false;
+	s_last_refresh_us = Common::Timer::GetTimeUs();
+}
+
+void SetGPUTimer(std::unique_ptr<GPUTimer> timer)
+{
+	s_gpu_timer = std::move(timer);
+}
+
+void Shutdown()
+{
+	s_gpu_timer.reset();
+	if (s_csv_file.is_open())
+		s_csv_file.close();
+	g_active = false;
+}
+
+void SetForced(bool forced)
+{
+	s_forced = forced;
+}
+
+void BeginPass(Pass pass)
+{
+	if (s_depth[pass]++ > 0)
+		return;
+
+	s_begin_us[pass] = Common::Timer::GetTimeUs();
+	if (s_gpu_timer)
+		s_gpu_timer->Begin(pass);
+}
+
+void EndPass(Pass pass)
+{
+	if (--s_depth[pass] > 0)
+		return;
+
+	s_cpu_frame[pass] += (Common::Timer::GetTimeUs() - s_begin_us[pass]) / 1000.0;
+	if (s_gpu_timer)
+		s_gpu_timer->End(pass);
+}
+
+static void WriteCSVRow(bool has_gpu_times, const PassTimes& gpu_times)
+{
+	if (!s_csv_file.is_open())
+	{
+		OpenFStream(s_csv_file, File::GetUserPath(D_LOGS_IDX) + "pass_times.csv", std::ios_base::out | std::ios_base::trunc);
+		s_csv_file << "frame";
+		for (const char* name : s_pass_csv_names)
+			s_csv_file << ",cpu_" << name << "_ms";
+		for (const char* name : s_pass_csv_names)
+			s_csv_file << ",gpu_" << name << "_ms";
+		s_csv_file << std::endl;
+	}
+
+	// GPU times lag a few frames behind and are left empty when none completed
+	s_csv_file << s_frame_number;
+	for (double time : s_cpu_frame)
+		s_csv_file << StringFromFormat(",%.3f", time);
+	for (double time : gpu_times)
+		s_csv_file << (has_gpu_times ? StringFromFormat(",%.3f", time) : std::string(","));
+	s_csv_file << '\n';
+}
+
+void EndFrame()
+{
+	const bool active = g_ActiveConfig.bOverlayPassTimes || g_ActiveConfig.bLogPassTimesToFile || s_forced;
+	if (g_active)
+	{
+		PassTimes gpu_times;
+		gpu_times.fill(0.0);
+		const bool has_gpu_times = s_gpu_timer && s_gpu_timer->ResolveFrame(&gpu_times);
+
+		for (int i = 0; i < PASS_COUNT; i++)
+		{
+			s_cpu_sum[i] += s_cpu_frame[i];
+			if (has_gpu_times)
+				s_gpu_sum[i] += gpu_times[i];
+		}
+		s_cpu_frames++;
+		if (has_gpu_times)
+			s_gpu_frames++;
+
+		const u64 now = Common::Timer::GetTimeUs();
+		if (now - s_last_refresh_us >= OVERLAY_REFRESH_INTERVAL_US)
+		{
+			for (int i = 0; i < PASS_COUNT; i++)
+			{
+				s_cpu_average[i] = s_cpu_sum[i] / s_cpu_frames;
+				s_gpu_average[i] = s_gpu_frames ? s_gpu_sum[i] / s_gpu_frames : 0.0;
+			}
+			s_has_gpu_average = s_gpu_frames > 0;
+			s_cpu_sum.fill(0.0);
+			s_gpu_sum.fill(0.0);
+			s_cpu_frames = 0;
+			s_gpu_frames = 0;
+			s_last_refresh_us = now;
+		}
+
+		if (g_ActiveConfig.bLogPassTimesToFile)
+			WriteCSVRow(has_gpu_times, gpu_times);
+
+		s_last_cpu_frame = s_cpu_frame;
+		s_last_gpu_frame = gpu_times;
+		s_last_has_gpu_frame = has_gpu_times;
+	}
+	else if (active)
+	{
+		ResetTimes();
+		s_last_cpu_frame.fill(0.0);
+		s_last_gpu_frame.fill(0.0);
+		s_last_has_gpu_frame = false;
+	}
+
+	if (!g_ActiveConfig.bLogPassTimesToFile && s_csv_file.is_open())
+		s_csv_file.close();
+
+	s_cpu_frame.fill(0.0);
+	s_frame_number++;
+	g_active = active;
+}
+
+std::string ToString()
+{
+	if (!g_active || !g_ActiveConfig.bOverlayPassTimes)
+		return "";
+
+	std::string str = s_has_gpu_average ? "Pass times (ms)      CPU     GPU\n" : "Pass times (ms)      CPU\n";
+	for (int i = 0; i < PASS_COUNT; i++)
+	{
+		str += StringFromFormat("%-18s %7.2f", s_pass_names[i], s_cpu_average[i]);
+		if (s_has_gpu_average)
+			str += StringFromFormat(" %7.2f", s_gpu_average[i]);
+		str += '\n';
+	}
+	return str;
+}
+
+bool GetLastFrame(PassTimes* cpu_times, PassTimes* gpu_times)
+{
+	*cpu_times = s_last_cpu_frame;
+	*gpu_times = s_last_gpu_frame;
+	return s_last_has_gpu_frame;
+}
+
+const char* GetPassCSVName(Pass pass)
+{
+	return s_pass_csv_names[pass];
+}
+}
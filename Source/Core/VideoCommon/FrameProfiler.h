@@ -0,0 +1,86 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+
+// Per frame CPU and GPU time of the major passes of the GPU thread, shown with the Pass Times
+// overlay and written to Logs/pass_times.csv. Only measured while one of the two is enabled.
+// Times are inclusive, e.g. a shader compiled during a flush also counts towards the draw pass.
+namespace FrameProfiler
+{
+enum Pass
+{
+	PASS_VERTEX_LOADING,
+	PASS_DRAW,
+	PASS_SHADER_COMPILATION,
+	PASS_EFB_COPY,
+	PASS_POST_PROCESSING,
+	PASS_PRESENT,
+	PASS_COUNT
+};
+
+typedef std::array<double, PASS_COUNT> PassTimes;
+
+// Implemented by backends with timestamp queries, Begin and End are only called for the
+// outermost instance of a pass.
+class GPUTimer
+{
+public:
+	virtual ~GPUTimer() {}
+	virtual void Begin(Pass pass) = 0;
+	virtual void End(Pass pass) = 0;
+	// Called at the end of every frame, returns true and fills times in milliseconds when the
+	// queries of an earlier frame completed.
+	virtual bool ResolveFrame(PassTimes* times) = 0;
+};
+
+extern bool g_active;
+
+void SetGPUTimer(std::unique_ptr<GPUTimer> timer);
+void Shutdown();
+
+// Keeps measuring with the overlay and log disabled, used by the benchmark log.
+void SetForced(bool forced);
+
+inline bool IsActive()
+{
+	return g_active;
+}
+
+void BeginPass(Pass pass);
+void EndPass(Pass pass);
+
+// Called once per swap, picks up config changes.
+void EndFrame();
+
+std::string ToString();
+
+// Times of the frame finished by the last EndFrame. The GPU times belong to an earlier frame,
+// returns false when none completed.
+bool GetLastFrame(PassTimes* cpu_times, PassTimes* gpu_times);
+const char* GetPassCSVName(Pass pass);
+
+class ScopedPass
+{
+public:
+	ScopedPass(Pass pass) : m_pass(pass), m_active(IsActive())
+	{
+		if (m_active)
+			BeginPass(m_pass);
+	}
+	~ScopedPass()
+	{
+		if (m_active)
+			EndPass(m_pass);
+	}
+
+private:
+	Pass m_pass;
+	bool m_active;
+};
+}
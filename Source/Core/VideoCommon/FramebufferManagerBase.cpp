@@ -6,6 +6,9 @@
 #include <array>
 #include <memory>
 #include <utility>
+
+#include "Common/Hash.h"
+#include "Core/HW/Memmap.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/VideoConfig.h"
@@ -13,6 +16,7 @@
 std::unique_ptr<FramebufferManagerBase> g_framebuffer_manager;
 
 std::unique_ptr<XFBSourceBase> FramebufferManagerBase::m_realXFBSource; // Only used in Real XFB mode
+u64 FramebufferManagerBase::m_realXFBHash = 0;
 FramebufferManagerBase::VirtualXFBListType FramebufferManagerBase::m_virtualXFBList; // Only used in Virtual XFB mode
 std::array<const XFBSourceBase*, FramebufferManagerBase::MAX_VIRTUAL_XFB> FramebufferManagerBase::m_overlappingXFBArray;
 
@@ -54,12 +58,24 @@ const XFBSourceBase* const* FramebufferManagerBase::GetRealXFBSource(u32 xfbAddr
 	if (m_realXFBSource && (m_realXFBSource->texWidth != fbWidth || m_realXFBSource->texHeight != fbHeight))
 		m_realXFBSource.reset();
 
+	bool decode_needed = false;
 	if (!m_realXFBSource && g_framebuffer_manager)
+	{
 		m_realXFBSource = g_framebuffer_manager->CreateXFBSource(fbWidth, fbHeight, 1);
+		decode_needed = true;
+	}
 
 	if (!m_realXFBSource)
 		return nullptr;
 
+	// Games often scan out the same XFB for several fields, only decode and upload it again when
+	// it moved or its contents in RAM changed since the last time
+	const u8* src = Memory::GetPointer(xfbAddr);
+	const u64 hash = src ? GetHash64(src, 2 * fbWidth * fbHeight, 0) : 0;
+	if (!src || m_realXFBSource->srcAddr != xfbAddr || hash != m_realXFBHash)
+		decode_needed = true;
+	m_realXFBHash = hash;
+
 	m_realXFBSource->srcAddr = xfbAddr;
 
 	m_realXFBSource->srcWidth = MAX_XFB_WIDTH;
@@ -74,7 +90,8 @@ const XFBSourceBase* const* FramebufferManagerBase::GetRealXFBSource(u32 xfbAddr
 	m_realXFBSource->sourceRc.bottom = fbHeight;
 
 	// Decode YUYV data from GameCube RAM
-	m_realXFBSource->DecodeToTexture(xfbAddr, fbWidth, fbHeight);
+	if (decode_needed)
+		m_realXFBSource->DecodeToTexture(xfbAddr, fbWidth, fbHeight);
 
 	m_overlappingXFBArray[0] = m_realXFBSource.get();
 	return &m_overlappingXFBArray[0];
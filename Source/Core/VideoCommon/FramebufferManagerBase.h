@@ -111,6 +111,7 @@ private:
 	static const XFBSourceBase* const* GetVirtualXFBSource(u32 xfbAddr, u32 fbWidth, u32 fbHeight, u32* xfbCount);
 
 	static std::unique_ptr<XFBSourceBase> m_realXFBSource; // Only used in Real XFB mode
+	static u64 m_realXFBHash; // Hash of the RAM last decoded into m_realXFBSource
 	static VirtualXFBListType m_virtualXFBList; // Only used in Virtual XFB mode
 
 	static std::array<const XFBSourceBase*, MAX_VIRTUAL_XFB> m_overlappingXFBArray;
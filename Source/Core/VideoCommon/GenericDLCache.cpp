@@ -15,38 +15,797 @@
 // Official SVN repository and contact information can be found at
 // http://code.google.com/p/dolphin-emu/
 
-// TODO: Handle cache-is-full condition :p
+// A display list is only cached once it has been called twice with the same contents.
+// The second call records it: state commands are executed through the opcode decoder as
+// usual and remembered as byte ranges of the list, while the output of the vertex loader
+// for draws using only direct attributes is kept. Replaying the entry then runs the state
+// ranges and copies the converted vertices straight into the vertex buffer. Ranges made of
+// register loads only are also decoded once while recording, so replaying them calls the
+// register handlers in a straight loop instead of parsing the commands again.
+// Replay checks that every draw still selects the same vertex loader and matrix index;
+// if not, the rest of the list is decoded normally and the entry is recorded again.
+// Draws with indexed attributes are kept converted too: the vertex array ranges they read
+// are hashed and write tracked, and verified together with the list itself. Replay also
+// checks that the draw still uses the same array bases and strides. Lists whose arrays
+// keep changing, such as CPU skinned meshes, go back to decoding their indexed draws.
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
-#include "Common.h"
-#include "DLCache.h"
+#include "Common/CommonFuncs.h"
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+#include "Core/HW/Memmap.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/DLCache.h"
+#include "VideoCommon/Fifo.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VertexManagerBase.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/XFMemory.h"
 
 namespace DLCache
 {
+namespace
+{
+constexpr u32 MAX_UNUSED_FRAMES = 256;
+constexpr size_t MAX_CACHE_BYTES = 64 * 1024 * 1024;
+// Array changes after which indexed draws of a list are no longer kept converted
+constexpr u8 MAX_ARRAY_CHANGES = 2;
+
+enum class EntryState : u8
+{
+	Pending,
+	Recorded,
+	Uncacheable
+};
+
+struct Op
+{
+	// Commands: executed through the opcode decoder. Draw: replayed from vertex_data.
+	bool is_draw;
+	u8 cmd_byte;
+	u16 count;
+	u32 offset;
+	u32 size;
+	u32 finalcount;
+	u32 matrix_index_a;
+	u32 vertex_offset;
+	u32 cycles;
+	const VertexLoaderBase* loader;
+	// Vertex arrays read by an indexed draw, in CachedDisplayList::array_uses
+	u32 first_array_use;
+	u32 num_array_uses;
+	// Commands decoded at record time, in CachedDisplayList::commands. Ranges with display
+	// list calls or draws are not decoded and go through the opcode decoder again.
+	bool decoded;
+	u32 first_command;
+	u32 num_commands;
+};
+
+// A register load of a command range, replayed without parsing the list again
+struct StateCommand
+{
+	u8 cmd_byte;
+	u8 sub_cmd;
+	u16 transfer_size;
+	u32 value;        // CP value, BP command, XF address or indexed XF load
+	u32 data_offset;  // of the XF data in the list
+};
+
+struct ArrayUse
+{
+	u32 array;
+	u32 base;
+	u32 stride;
+};
+
+// Guest memory read through the vertex arrays, verified like the list contents
+struct ArrayRange
+{
+	u32 address;
+	u32 size;
+	u64 hash;
+	u64 write_seq;
+};
+
+struct CachedDisplayList
+{
+	u64 hash;
+	// Write tracking sequence of the list itself
+	u64 write_seq;
+	u32 last_frame;
+	EntryState state;
+	u8 array_changes;
+	std::vector<Op> ops;
+	std::vector<u8> vertex_data;
+	std::vector<ArrayUse> array_uses;
+	std::vector<ArrayRange> array_ranges;
+	std::vector<StateCommand> commands;
+
+	size_t GetMemoryUsage() const
+	{
+		return ops.capacity() * sizeof(Op) + vertex_data.capacity() +
+			array_uses.capacity() * sizeof(ArrayUse) + array_ranges.capacity() * sizeof(ArrayRange) +
+			commands.capacity() * sizeof(StateCommand);
+	}
+
+	void Reset(EntryState new_state)
+	{
+		state = new_state;
+		ops.clear();
+		ops.shrink_to_fit();
+		vertex_data.clear();
+		vertex_data.shrink_to_fit();
+		array_uses.clear();
+		array_uses.shrink_to_fit();
+		array_ranges.clear();
+		array_ranges.shrink_to_fit();
+		commands.clear();
+		commands.shrink_to_fit();
+	}
+};
+
+std::unordered_map<u64, CachedDisplayList> s_cache;
+size_t s_cache_bytes = 0;
+u32 s_frame = 0;
+
+// For recorded entries, which are counted in s_cache_bytes
+void ResetRecorded(CachedDisplayList& entry)
+{
+	s_cache_bytes -= std::min(s_cache_bytes, entry.GetMemoryUsage());
+	entry.Reset(EntryState::Pending);
+}
+
+u32 ExecuteCommands(u8* start, u8* end)
+{
+	u8* old_pVideoData = g_VideoData.GetReadPosition();
+	u8* old_pVideoDataEnd = g_VideoData.GetEnd();
+	g_VideoData.SetReadPosition(start, end);
+	u32 cycles = 0;
+	OpcodeDecoder::Run<false, false>(g_VideoData, &cycles);
+	g_VideoData.SetReadPosition(old_pVideoData, old_pVideoDataEnd);
+	return cycles;
+}
+
+bool UsesIndexedAttributes(const TVtxDesc& vtx_desc)
+{
+	// The high bit of every 2-bit attribute field means 8 or 16 bit index.
+	return ((vtx_desc.Hex >> 9) & 0xAAAAAA) != 0;
+}
+
+u32 GetComponentSize(u32 format)
+{
+	return format <= FORMAT_BYTE ? 1 : format <= FORMAT_SHORT ? 2 : 4;
+}
+
+u32 GetColorSize(u32 format)
+{
+	switch (format)
+	{
+	case FORMAT_16B_565:
+	case FORMAT_16B_4444:
+		return 2;
+	case FORMAT_24B_888:
+	case FORMAT_24B_6666:
+		return 3;
+	default:
+		return 4;
+	}
+}
+
+struct IndexedAttribute
+{
+	u32 array;
+	u32 offset;        // of the first index in the raw vertex
+	u32 num_indices;   // 3 for normal, binormal and tangent with separate indices
+	u32 element_size;  // bytes read from the array per index
+	bool index16;
+};
+
+// Lays out the raw vertex the way the vertex loader reads it and returns its indexed
+// attributes; their index fields give the array ranges a draw reads.
+std::vector<IndexedAttribute> GetIndexedAttributes(const TVtxDesc& desc, const VAT& vat)
+{
+	std::vector<IndexedAttribute> attributes;
+	u32 offset = 0;
+	auto add = [&](u32 type, u32 array, u32 direct_size, u32 element_size, u32 num_indices) {
+		if (type == DIRECT)
+		{
+			offset += direct_size;
+		}
+		else if (type != NOT_PRESENT)
+		{
+			attributes.push_back({ array, offset, num_indices, element_size, type == INDEX16 });
+			offset += num_indices * (type == INDEX16 ? 2 : 1);
+		}
+	};
+
+	// Matrix indices are always direct bytes.
+	offset += desc.PosMatIdx + desc.Tex0MatIdx + desc.Tex1MatIdx + desc.Tex2MatIdx + desc.Tex3MatIdx +
+		desc.Tex4MatIdx + desc.Tex5MatIdx + desc.Tex6MatIdx + desc.Tex7MatIdx;
+
+	u32 position_size = (vat.g0.PosElements ? 3 : 2) * GetComponentSize(vat.g0.PosFormat);
+	add(desc.Position, ARRAY_POSITION, position_size, position_size, 1);
+
+	u32 normal_size = (vat.g0.NormalElements ? 9 : 3) * GetComponentSize(vat.g0.NormalFormat);
+	add(desc.Normal, ARRAY_NORMAL, normal_size, normal_size,
+		vat.g0.NormalElements && vat.g0.NormalIndex3 ? 3 : 1);
+
+	u32 color0_size = GetColorSize(vat.g0.Color0Comp);
+	add(desc.Color0, ARRAY_COLOR, color0_size, color0_size, 1);
+	u32 color1_size = GetColorSize(vat.g0.Color1Comp);
+	add(desc.Color1, ARRAY_COLOR2, color1_size, color1_size, 1);
+
+	const u32 tex_elements[8] = { vat.g0.Tex0CoordElements, vat.g1.Tex1CoordElements,
+		vat.g1.Tex2CoordElements, vat.g1.Tex3CoordElements, vat.g1.Tex4CoordElements,
+		vat.g2.Tex5CoordElements, vat.g2.Tex6CoordElements, vat.g2.Tex7CoordElements };
+	const u32 tex_formats[8] = { vat.g0.Tex0CoordFormat, vat.g1.Tex1CoordFormat,
+		vat.g1.Tex2CoordFormat, vat.g1.Tex3CoordFormat, vat.g1.Tex4CoordFormat,
+		vat.g2.Tex5CoordFormat, vat.g2.Tex6CoordFormat, vat.g2.Tex7CoordFormat };
+	for (u32 i = 0; i < 8; i++)
+	{
+		u32 tex_size = (tex_elements[i] ? 2 : 1) * GetComponentSize(tex_formats[i]);
+		add(desc.GetVertexArrayStatus(ARRAY_TEXCOORD0 + i), ARRAY_TEXCOORD0 + i, tex_size, tex_size, 1);
+	}
+	return attributes;
+}
+
+// Adds the array ranges read by an indexed draw to the entry. Returns false if one of
+// them is outside of guest memory, in which case the draw is kept as raw command.
+bool AddArrayUses(CachedDisplayList& entry, Op& op, const u8* vertices, u32 count, u32 vertex_size)
+{
+	const CPState& state = g_main_cp_state;
+	std::vector<IndexedAttribute> attributes =
+		GetIndexedAttributes(state.vtx_desc, state.vtx_attr[op.cmd_byte & GX_VAT_MASK]);
+	op.first_array_use = u32(entry.array_uses.size());
+	op.num_array_uses = u32(attributes.size());
+	for (const IndexedAttribute& attribute : attributes)
+	{
+		u32 max_index = 0;
+		bool any_index = false;
+		for (u32 v = 0; v < count; v++)
+		{
+			const u8* field = vertices + v * vertex_size + attribute.offset;
+			for (u32 i = 0; i < attribute.num_indices; i++)
+			{
+				u32 index = attribute.index16 ? Common::swap16(field + i * 2) : field[i];
+				// The vertex loader skips vertices with an all ones position index.
+				if (attribute.array == ARRAY_POSITION && index == (attribute.index16 ? 0xFFFFu : 0xFFu))
+					continue;
+				max_index = std::max(max_index, index);
+				any_index = true;
+			}
+		}
+		u32 base = state.array_bases[attribute.array];
+		u32 stride = state.array_strides[attribute.array];
+		entry.array_uses.push_back({ attribute.array, base, stride });
+		if (!any_index)
+			continue;
+
+		u32 size = max_index * stride + std::max(stride, attribute.element_size);
+		if (Memory::GetPointer(base) == nullptr || Memory::GetPointer(base + size - 1) == nullptr)
+			return false;
+
+		auto range = std::find_if(entry.array_ranges.begin(), entry.array_ranges.end(),
+			[base](const ArrayRange& r) { return r.address == base; });
+		if (range == entry.array_ranges.end())
+			entry.array_ranges.push_back({ base, size, 0, 0 });
+		else
+			range->size = std::max(range->size, size);
+	}
+	return true;
+}
+
+// Starts tracking the array ranges of a recorded entry.
+void HashArrayRanges(CachedDisplayList& entry)
+{
+	for (ArrayRange& range : entry.array_ranges)
+	{
+		range.write_seq = Memory::TrackWrites(range.address, range.size);
+		range.hash = GetHash64(Memory::GetPointer(range.address), range.size, 0);
+	}
+}
+
+// Returns false if the guest changed a vertex array since the entry was recorded.
+bool ArrayRangesUnchanged(CachedDisplayList& entry)
+{
+	for (ArrayRange& range : entry.array_ranges)
+	{
+		if (!Memory::WasWrittenSince(range.address, range.size, range.write_seq))
+			continue;
+		// Tracked again before hashing, so a write racing the hash isn't missed
+		range.write_seq = Memory::TrackWrites(range.address, range.size);
+		u8* data = Memory::GetPointer(range.address);
+		if (data == nullptr || GetHash64(data, range.size, 0) != range.hash)
+			return false;
+	}
+	return true;
+}
+
+bool ArrayUsesMatch(const CachedDisplayList& entry, const Op& op)
+{
+	const CPState& state = g_main_cp_state;
+	for (u32 i = 0; i < op.num_array_uses; i++)
+	{
+		const ArrayUse& use = entry.array_uses[op.first_array_use + i];
+		if (state.array_bases[use.array] != use.base || state.array_strides[use.array] != use.stride)
+			return false;
+	}
+	return true;
+}
+
+void FillDrawParameters(VertexLoaderParameters& parameters, u8 cmd_byte, u16 count, u8* source, size_t buf_size)
+{
+	CPState& state = g_main_cp_state;
+	u32 vtx_attr_group = cmd_byte & GX_VAT_MASK;
+	parameters.count = count;
+	parameters.buf_size = buf_size;
+	parameters.primitive = (cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT;
+	parameters.vtx_attr_group = vtx_attr_group;
+	parameters.needloaderrefresh = (state.attr_dirty & (1u << vtx_attr_group)) != 0;
+	parameters.skip_draw = g_bSkipCurrentFrame
+		|| xfmem.viewport.wd == 0.0f
+		|| xfmem.viewport.ht == 0.0f
+		|| (bpmem.scissorBR.x + 1 - bpmem.scissorTL.x) == 0
+		|| (bpmem.scissorBR.y + 1 - bpmem.scissorTL.y) == 0;
+	parameters.VtxDesc = &state.vtx_desc;
+	parameters.VtxAttr = &state.vtx_attr[vtx_attr_group];
+	parameters.source = source;
+	state.attr_dirty &= ~(1 << vtx_attr_group);
+}
+
+// Returns the size of the non-draw command at the reader position, or 0 if it is unknown.
+u32 GetCommandSize(const DataReader& reader, u8 cmd_byte)
+{
+	switch (cmd_byte)
+	{
+	case GX_NOP:
+	case GX_UNKNOWN_RESET:
+	case GX_CMD_UNKNOWN_METRICS:
+	case GX_CMD_INVL_VC:
+		return 1;
+	case GX_LOAD_CP_REG:
+		return 1 + GX_LOAD_CP_REG_SIZE;
+	case GX_LOAD_XF_REG:
+		if (reader.size() < 1 + GX_LOAD_XF_REG_SIZE)
+			return 0;
+		return 1 + GX_LOAD_XF_REG_SIZE + (((reader.Peek<u32>(1) >> 16) & 15) + 1) * sizeof(u32);
+	case GX_LOAD_INDX_A:
+	case GX_LOAD_INDX_B:
+	case GX_LOAD_INDX_C:
+	case GX_LOAD_INDX_D:
+		return 1 + GX_LOAD_INDX_SIZE;
+	case GX_CMD_CALL_DL:
+		return 1 + GX_CMD_CALL_DL_SIZE;
+	case GX_LOAD_BP_REG:
+		return 1 + GX_LOAD_BP_REG_SIZE;
+	default:
+		return 0;
+	}
+}
+
+// Appends the register loads of a command range to the entry. Returns false if the range
+// holds anything else than register loads and no-ops.
+bool DecodeCommands(CachedDisplayList& entry, const u8* source, u32 offset, u32 size)
+{
+	DataReader reader(const_cast<u8*>(source + offset), const_cast<u8*>(source + offset + size));
+	while (reader.size())
+	{
+		u8 cmd_byte = reader.Peek<u8>();
+		// Unknown and truncated commands only show up at the end of abandoned recordings.
+		u32 command_size = GetCommandSize(reader, cmd_byte);
+		if (command_size > reader.size() ||
+			(command_size == 0 && (cmd_byte & GX_DRAW_PRIMITIVES) != 0x80))
+			return false;
+		StateCommand command = {};
+		command.cmd_byte = cmd_byte;
+		switch (cmd_byte)
+		{
+		case GX_NOP:
+		case GX_UNKNOWN_RESET:
+		case GX_CMD_UNKNOWN_METRICS:
+		case GX_CMD_INVL_VC:
+			reader.ReadSkip(1);
+			continue;
+		case GX_LOAD_CP_REG:
+			command.sub_cmd = reader.Peek<u8>(1);
+			command.value = reader.Peek<u32>(2);
+			reader.ReadSkip(1 + GX_LOAD_CP_REG_SIZE);
+			break;
+		case GX_LOAD_XF_REG:
+		{
+			u32 cmd2 = reader.Peek<u32>(1);
+			command.transfer_size = u16(((cmd2 >> 16) & 15) + 1);
+			command.value = cmd2 & 0xFFFF;
+			command.data_offset = u32(reader.GetReadPosition() - source) + 1 + GX_LOAD_XF_REG_SIZE;
+			reader.ReadSkip(1 + GX_LOAD_XF_REG_SIZE + command.transfer_size * sizeof(u32));
+			break;
+		}
+		case GX_LOAD_INDX_A:
+		case GX_LOAD_INDX_B:
+		case GX_LOAD_INDX_C:
+		case GX_LOAD_INDX_D:
+			command.value = reader.Peek<u32>(1);
+			reader.ReadSkip(1 + GX_LOAD_INDX_SIZE);
+			break;
+		case GX_LOAD_BP_REG:
+			command.value = reader.Peek<u32>(1);
+			reader.ReadSkip(1 + GX_LOAD_BP_REG_SIZE);
+			break;
+		default:
+			// Empty draws only cost cycles, draws kept as raw commands and calls need the decoder.
+			if ((cmd_byte & GX_DRAW_PRIMITIVES) == 0x80 && reader.size() >= 1 + GX_DRAW_PRIMITIVES_SIZE &&
+				reader.Peek<u16>(1) == 0)
+			{
+				reader.ReadSkip(1 + GX_DRAW_PRIMITIVES_SIZE);
+				continue;
+			}
+			return false;
+		}
+		entry.commands.push_back(command);
+	}
+	return true;
+}
+
+// Runs the decoded register loads of a command range.
+void RunCommands(const CachedDisplayList& entry, const Op& op, u8* source)
+{
+	for (u32 i = 0; i < op.num_commands; i++)
+	{
+		const StateCommand& command = entry.commands[op.first_command + i];
+		switch (command.cmd_byte)
+		{
+		case GX_LOAD_CP_REG:
+			LoadCPReg<false>(command.sub_cmd, command.value);
+			INCSTAT(stats.thisFrame.numCPLoads);
+			break;
+		case GX_LOAD_XF_REG:
+		{
+			// The XF data is read from the list through the video data reader.
+			u8* old_pVideoData = g_VideoData.GetReadPosition();
+			u8* old_pVideoDataEnd = g_VideoData.GetEnd();
+			u8* data = source + command.data_offset;
+			g_VideoData.SetReadPosition(data, data + command.transfer_size * sizeof(u32));
+			LoadXFReg(command.transfer_size, command.value);
+			g_VideoData.SetReadPosition(old_pVideoData, old_pVideoDataEnd);
+			INCSTAT(stats.thisFrame.numXFLoads);
+			break;
+		}
+		case GX_LOAD_BP_REG:
+			LoadBPReg(command.value);
+			INCSTAT(stats.thisFrame.numBPLoads);
+			break;
+		default:
+			LoadIndexedXF(command.value, (command.cmd_byte >> 3) + 8);
+			break;
+		}
+	}
+}
+
+void AddCommandsOp(CachedDisplayList& entry, const u8* source, u32 offset, u32 size, u32 cycles)
+{
+	if (!entry.ops.empty())
+	{
+		Op& last = entry.ops.back();
+		if (!last.is_draw && last.offset + last.size == offset)
+		{
+			// The commands of the last op are at the end of the entry.
+			u32 num_commands = u32(entry.commands.size());
+			last.decoded = last.decoded && DecodeCommands(entry, source, offset, size);
+			last.num_commands += u32(entry.commands.size()) - num_commands;
+			last.size += size;
+			last.cycles += cycles;
+			return;
+		}
+	}
+	Op op = {};
+	op.is_draw = false;
+	op.offset = offset;
+	op.size = size;
+	op.cycles = cycles;
+	op.first_command = u32(entry.commands.size());
+	op.decoded = DecodeCommands(entry, source, offset, size);
+	op.num_commands = u32(entry.commands.size()) - op.first_command;
+	entry.ops.push_back(op);
+}
+
+// Executes the display list while building the cache entry for it.
+u32 Record(CachedDisplayList& entry, u8* source, u32 size)
+{
+	entry.Reset(EntryState::Recorded);
+	DataReader reader(source, source + size);
+	u32 total_cycles = 0;
+	u8* segment_start = nullptr;
+	bool has_cached_draws = false;
+
+	auto flush_segment = [&](u8* segment_end) {
+		if (segment_start == nullptr)
+			return;
+		u32 cycles = ExecuteCommands(segment_start, segment_end);
+		AddCommandsOp(entry, source, u32(segment_start - source), u32(segment_end - segment_start),
+			cycles);
+		total_cycles += cycles;
+		segment_start = nullptr;
+	};
+
+	while (reader.size())
+	{
+		u8* opcode_start = reader.GetReadPosition();
+		u8 cmd_byte = reader.Peek<u8>();
+		if ((cmd_byte & GX_DRAW_PRIMITIVES) != 0x80)
+		{
+			u32 command_size = GetCommandSize(reader, cmd_byte);
+			if (command_size == 0 || command_size > reader.size())
+			{
+				// Unknown or truncated command, let the decoder deal with the rest.
+				if (segment_start == nullptr)
+					segment_start = opcode_start;
+				flush_segment(source + size);
+				entry.Reset(EntryState::Uncacheable);
+				return total_cycles;
+			}
+			if (segment_start == nullptr)
+				segment_start = opcode_start;
+			reader.ReadSkip(command_size);
+			continue;
+		}
+
+		if (reader.size() < 1 + GX_DRAW_PRIMITIVES_SIZE)
+		{
+			if (segment_start == nullptr)
+				segment_start = opcode_start;
+			flush_segment(source + size);
+			entry.Reset(EntryState::Uncacheable);
+			return total_cycles;
+		}
+		u16 count = reader.Peek<u16>(1);
+		if (count == 0)
+		{
+			if (segment_start == nullptr)
+				segment_start = opcode_start;
+			reader.ReadSkip(1 + GX_DRAW_PRIMITIVES_SIZE);
+			continue;
+		}
+
+		// The vertex size depends on the state set by the preceding commands.
+		flush_segment(opcode_start);
+		reader.ReadSkip(1 + GX_DRAW_PRIMITIVES_SIZE);
+		VertexLoaderParameters parameters;
+		FillDrawParameters(parameters, cmd_byte, count, reader.GetReadPosition(), reader.size());
+		VertexLoaderBase* loader = VertexLoaderManager::GetActiveLoader(parameters);
+		u32 readsize = count * loader->m_VertexSize;
+		if (readsize > reader.size())
+		{
+			segment_start = opcode_start;
+			flush_segment(source + size);
+			entry.Reset(EntryState::Uncacheable);
+			return total_cycles;
+		}
+		u32 draw_cycles = GX_NOP_CYCLES + GX_DRAW_PRIMITIVES_CYCLES * count;
+		const bool indexed = UsesIndexedAttributes(g_main_cp_state.vtx_desc);
+		Op op = {};
+		if (!parameters.skip_draw && indexed && entry.array_changes < MAX_ARRAY_CHANGES)
+		{
+			op.cmd_byte = cmd_byte;
+			if (!AddArrayUses(entry, op, reader.GetReadPosition(), count, loader->m_VertexSize))
+			{
+				entry.array_uses.resize(op.first_array_use);
+				op.num_array_uses = 0;
+			}
+		}
+		if (parameters.skip_draw || (indexed && op.num_array_uses == 0))
+		{
+			// Skipped draws and indexed draws whose vertex arrays can't be verified
+			// only keep the raw command.
+			segment_start = opcode_start;
+			reader.ReadSkip(readsize);
+			flush_segment(reader.GetReadPosition());
+			continue;
+		}
+
+		u32 writesize = 0;
+		VertexLoaderManager::ConvertVertices(parameters, readsize, writesize);
+		op.is_draw = true;
+		op.cmd_byte = cmd_byte;
+		op.count = count;
+		op.offset = u32(opcode_start - source);
+		op.size = 1 + GX_DRAW_PRIMITIVES_SIZE + readsize;
+		op.finalcount = writesize / loader->m_native_stride;
+		op.matrix_index_a = g_main_cp_state.matrix_index_a.Hex;
+		op.vertex_offset = u32(entry.vertex_data.size());
+		op.cycles = draw_cycles;
+		op.loader = loader;
+		entry.ops.push_back(op);
+		entry.vertex_data.insert(entry.vertex_data.end(), parameters.destination, parameters.destination + writesize);
+		g_vertex_manager->IncCurrentBufferPointer(writesize);
+		total_cycles += draw_cycles;
+		reader.ReadSkip(readsize);
+		has_cached_draws = true;
+	}
+	if (segment_start != nullptr)
+		flush_segment(source + size);
+	if (!has_cached_draws)
+	{
+		// Nothing to gain from replaying state only lists.
+		entry.Reset(EntryState::Uncacheable);
+	}
+	HashArrayRanges(entry);
+	return total_cycles;
+}
+
+// Returns false if the entry had to be abandoned halfway, in which case the rest of the
+// list has already been executed normally.
+bool Replay(CachedDisplayList& entry, u8* source, u32 size, u32* cycles)
+{
+	u32 total_cycles = 0;
+	for (const Op& op : entry.ops)
+	{
+		u8* op_start = source + op.offset;
+		if (!op.is_draw)
+		{
+			if (op.decoded)
+			{
+				RunCommands(entry, op, source);
+				total_cycles += op.cycles;
+			}
+			else
+			{
+				total_cycles += ExecuteCommands(op_start, op_start + op.size);
+			}
+			continue;
+		}
+		u32 writesize = 0;
+		bool valid = g_main_cp_state.matrix_index_a.Hex == op.matrix_index_a &&
+			ArrayUsesMatch(entry, op);
+		if (valid)
+		{
+			u32 header_end = op.offset + 1 + GX_DRAW_PRIMITIVES_SIZE;
+			VertexLoaderParameters parameters;
+			FillDrawParameters(parameters, op.cmd_byte, op.count, source + header_end, size - header_end);
+			valid = VertexLoaderManager::ConvertCachedVertices(parameters, op.loader, entry.vertex_data.data() + op.vertex_offset, op.finalcount, writesize);
+		}
+		if (!valid)
+		{
+			*cycles = total_cycles + ExecuteCommands(op_start, source + size);
+			return false;
+		}
+		g_vertex_manager->IncCurrentBufferPointer(writesize);
+		total_cycles += op.cycles;
+	}
+	*cycles = total_cycles;
+	return true;
+}
+
+}  // namespace
 
 void Init()
 {
+	Clear();
+	s_frame = 0;
 }
 
 void Shutdown()
 {
+	Clear();
 }
 
-void Clear() 
+void Clear()
 {
+	s_cache.clear();
+	s_cache_bytes = 0;
 }
 
 void ProgressiveCleanup()
 {
+	s_frame++;
+	if (!g_ActiveConfig.bDisplayListCache)
+	{
+		if (!s_cache.empty())
+			Clear();
+		return;
+	}
+	size_t cache_bytes = 0;
+	for (auto iter = s_cache.begin(); iter != s_cache.end();)
+	{
+		if (s_frame - iter->second.last_frame > MAX_UNUSED_FRAMES)
+		{
+			iter = s_cache.erase(iter);
+			continue;
+		}
+		cache_bytes += iter->second.GetMemoryUsage();
+		++iter;
+	}
+	s_cache_bytes = cache_bytes;
+	if (s_cache_bytes > MAX_CACHE_BYTES)
+	{
+		Clear();
+	}
 }
-}  // namespace
 
-// NOTE - outside the namespace on purpose.
-bool HandleDisplayList(u32 address, u32 size)
+size_t GetMemoryUsage()
 {
-	return false;
+	return s_cache_bytes;
 }
 
-void IncrementCheckContextId()
+}  // namespace DLCache
+
+// NOTE - outside the namespace on purpose.
+bool HandleDisplayList(u32 address, u32 size, u32* cycles)
 {
+	using namespace DLCache;
+	if (!g_ActiveConfig.bDisplayListCache
+		|| g_ActiveConfig.iBBoxMode == BBoxCPU
+		|| g_bRecordFifoData
+		|| Fifo::UseDeterministicGPUThread()
+		|| size == 0)
+	{
+		return false;
+	}
+	// The hash and Record read the whole list, so it has to end in RAM too
+	u8* source = Memory::GetPointer(address);
+	if (source == nullptr || Memory::GetPointer(address + size - 1) == nullptr)
+		return false;
+
+	u64 key = (u64(address) << 32) | size;
+	auto iter = s_cache.find(key);
+	if (iter == s_cache.end())
+	{
+		CachedDisplayList& entry = s_cache[key];
+		entry.write_seq = Memory::TrackWrites(address, size);
+		entry.hash = GetHash64(source, size, 0);
+		entry.last_frame = s_frame;
+		entry.state = EntryState::Pending;
+		return false;
+	}
+
+	CachedDisplayList& entry = iter->second;
+	entry.last_frame = s_frame;
+	// Games may rewrite a list in place at any time, so it is verified on every call. With write
+	// tracking only lists whose pages were written are hashed again.
+	if (Memory::WasWrittenSince(address, size, entry.write_seq))
+	{
+		entry.write_seq = Memory::TrackWrites(address, size);
+		u64 hash = GetHash64(source, size, 0);
+		if (hash != entry.hash)
+		{
+			entry.hash = hash;
+			ResetRecorded(entry);
+			return false;
+		}
+	}
+	if (!ArrayRangesUnchanged(entry))
+	{
+		if (entry.array_changes < MAX_ARRAY_CHANGES)
+			entry.array_changes++;
+		ResetRecorded(entry);
+		return false;
+	}
+
+	switch (entry.state)
+	{
+	case EntryState::Pending:
+		if (s_cache_bytes > MAX_CACHE_BYTES)
+			return false;
+	{
+		// Whatever the entry still holds was counted when it was recorded before
+		const size_t old_bytes = entry.GetMemoryUsage();
+		*cycles = Record(entry, source, size);
+		s_cache_bytes = s_cache_bytes - std::min(s_cache_bytes, old_bytes) + entry.GetMemoryUsage();
+		return true;
+	}
+	case EntryState::Recorded:
+		if (!Replay(entry, source, size, cycles))
+			ResetRecorded(entry);
+		return true;
+	default:
+		return false;
+	}
 }
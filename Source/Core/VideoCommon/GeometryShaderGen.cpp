@@ -36,7 +36,9 @@ void GetGeometryShaderUid(GeometryShaderUid& out, u32 primitive_type, const XFMe
 	uid_data.wireframe = g_ActiveConfig.bWireFrame;
 	uid_data.msaa = g_ActiveConfig.iMultisamples > 1;
 	uid_data.ssaa = g_ActiveConfig.iMultisamples > 1 && g_ActiveConfig.bSSAA;
-	uid_data.stereo = g_ActiveConfig.iStereoMode > 0;
+	// With vertex shader stereo both eyes are separate instances, the layer comes from the vertex
+	uid_data.vs_layer = g_ActiveConfig.VertexShaderStereoEnabled();
+	uid_data.stereo = g_ActiveConfig.iStereoMode > 0 && !uid_data.vs_layer;
 	uid_data.numTexGens = xfr.numTexGen.numTexGens;
 	uid_data.pixel_lighting = g_ActiveConfig.PixelLightingEnabled(xfr, components);
 	out.CalculateUIDHash();
@@ -144,12 +146,14 @@ inline void GenerateGeometryShader(ShaderCode& out, const geometry_shader_uid_da
 
 		out.Write("VARYING_LOCATION(0) in VertexData {\n");
 		GenerateVSOutputMembers<ApiType>(out, uid_data.pixel_lighting, uid_data.numTexGens, GetInterpolationQualifier(ApiType, uid_data.msaa, uid_data.ssaa, true, true));
+		if (uid_data.vs_layer)
+			out.Write("\tflat int layer;\n");
 		out.Write("} vs[%d];\n", vertex_in);
 
 		out.Write("VARYING_LOCATION(0) out VertexData {\n");
 		GenerateVSOutputMembers<ApiType>(out, uid_data.pixel_lighting, uid_data.numTexGens, GetInterpolationQualifier(ApiType, uid_data.msaa, uid_data.ssaa, false, true));
 
-		if (uid_data.stereo)
+		if (uid_data.stereo || uid_data.vs_layer)
 			out.Write("\tflat int layer;\n");
 
 		out.Write("} ps;\n");
@@ -279,6 +283,11 @@ inline void GenerateGeometryShader(ShaderCode& out, const geometry_shader_uid_da
 		out.Write("\tfloat hoffset = (eye == 0) ? " I_STEREOPARAMS ".x : " I_STEREOPARAMS ".y;\n");
 		out.Write("\tf.pos.x += hoffset * (f.pos.w - " I_STEREOPARAMS ".z);\n");
 	}
+	else if (uid_data.vs_layer)
+	{
+		out.Write("\tps.layer = vs[i].layer;\n");
+		out.Write("\tgl_Layer = vs[i].layer;\n");
+	}
 
 	if (uid_data.primitive_type == PRIMITIVE_LINES)
 	{
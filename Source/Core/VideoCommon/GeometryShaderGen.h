@@ -36,7 +36,8 @@ struct geometry_shader_uid_data
 	u32 wireframe : 1;
 	u32 msaa : 1;
 	u32 ssaa : 1;
-	u32 padding : 21;
+	u32 vs_layer : 1;
+	u32 padding : 20;
 };
 
 #pragma pack()
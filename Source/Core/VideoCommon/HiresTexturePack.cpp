@@ -0,0 +1,255 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <xxhash.h>
+
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+#include "VideoCommon/HiresTexturePack.h"
+#include "VideoCommon/TextureUtil.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(HiresTexturePack::Header) == 24, "pack header must not have padding");
+static_assert(sizeof(HiresTexturePack::Entry) == 56, "pack entry must not have padding");
+
+static u64 GetNameHash(const char* name, size_t size)
+{
+	return XXH64(name, size, 0);
+}
+
+HiresTexturePack::Writer::Writer(const std::string& path)
+	: m_path(path), m_temp_path(path + ".tmp"), m_file(m_temp_path, "wb")
+{
+	// The header is written again with the table offset once everything is in.
+	Header header = {};
+	m_file.WriteArray(&header, 1);
+}
+
+HiresTexturePack::Writer::~Writer()
+{
+	// Unfinished packs are never left behind
+	if (m_file.IsOpen())
+	{
+		m_file.Close();
+		File::Delete(m_temp_path);
+	}
+}
+
+bool HiresTexturePack::Writer::AddTexture(const std::string& name, PC_TexFormat format,
+	u32 width, u32 height, u32 levels, u32 nrm_levels, u32 flags, const u8* data)
+{
+	static const u8 padding[PAYLOAD_ALIGNMENT] = {};
+	u64 offset = m_file.Tell();
+	u64 aligned_offset = (offset + PAYLOAD_ALIGNMENT - 1) & ~u64(PAYLOAD_ALIGNMENT - 1);
+	if (!m_file.WriteBytes(padding, static_cast<size_t>(aligned_offset - offset)))
+		return false;
+
+	Entry entry = {};
+	entry.name_hash = GetNameHash(name.data(), name.size());
+	entry.data_offset = aligned_offset;
+	entry.data_size = GetPayloadSize(format, width, height, levels, nrm_levels);
+	entry.name_offset = static_cast<u32>(m_names.size());
+	entry.name_size = static_cast<u32>(name.size());
+	entry.format = format;
+	entry.width = width;
+	entry.height = height;
+	entry.levels = levels;
+	entry.nrm_levels = nrm_levels;
+	entry.flags = flags;
+	if (!m_file.WriteBytes(data, static_cast<size_t>(entry.data_size)))
+		return false;
+
+	m_entries.push_back(entry);
+	m_names += name;
+	return true;
+}
+
+bool HiresTexturePack::Writer::Finish()
+{
+	std::sort(m_entries.begin(), m_entries.end(),
+		[](const Entry& a, const Entry& b) { return a.name_hash < b.name_hash; });
+
+	Header header = {};
+	header.magic = PACK_MAGIC;
+	header.version = PACK_VERSION;
+	header.toc_offset = m_file.Tell();
+	header.entry_count = static_cast<u32>(m_entries.size());
+	header.names_size = static_cast<u32>(m_names.size());
+	m_file.WriteArray(m_entries.data(), m_entries.size());
+	m_file.WriteBytes(m_names.data(), m_names.size());
+	m_file.Seek(0, SEEK_SET);
+	m_file.WriteArray(&header, 1);
+	bool good = m_file.IsGood();
+	good = m_file.Close() && good;
+	if (!good)
+	{
+		File::Delete(m_temp_path);
+		return false;
+	}
+
+	if (File::Exists(m_path))
+		File::Delete(m_path);
+	return File::Rename(m_temp_path, m_path);
+}
+
+HiresTexturePack::~HiresTexturePack()
+{
+#ifdef _WIN32
+	if (m_base)
+		UnmapViewOfFile(m_base);
+	if (m_mapping_handle)
+		CloseHandle(m_mapping_handle);
+	if (m_file_handle)
+		CloseHandle(m_file_handle);
+#else
+	if (m_base)
+		munmap(m_base, m_size);
+#endif
+}
+
+std::unique_ptr<HiresTexturePack> HiresTexturePack::Open(const std::string& path)
+{
+	if (!File::Exists(path))
+		return nullptr;
+
+	std::unique_ptr<HiresTexturePack> pack(new HiresTexturePack());
+	if (!pack->Map(path))
+	{
+		ERROR_LOG(VIDEO, "Failed to map custom texture pack %s", path.c_str());
+		return nullptr;
+	}
+	if (!pack->Validate())
+	{
+		ERROR_LOG(VIDEO, "Custom texture pack %s is invalid", path.c_str());
+		return nullptr;
+	}
+	return pack;
+}
+
+bool HiresTexturePack::Map(const std::string& path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFile(UTF8ToTStr(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	m_file_handle = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		return false;
+	m_size = static_cast<size_t>(size.QuadPart);
+
+	m_mapping_handle = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_mapping_handle)
+		return false;
+
+	m_base = static_cast<u8*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+	return m_base != nullptr;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	m_size = static_cast<size_t>(st.st_size);
+
+	// The mapping stays valid after closing the descriptor
+	void* base = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return false;
+	m_base = static_cast<u8*>(base);
+	return true;
+#endif
+}
+
+bool HiresTexturePack::Validate()
+{
+	if (m_size < sizeof(Header))
+		return false;
+
+	std::memcpy(&m_header, m_base, sizeof(Header));
+	if (m_header.magic != PACK_MAGIC || m_header.version != PACK_VERSION)
+		return false;
+
+	const u64 toc_size = u64(m_header.entry_count) * sizeof(Entry) + m_header.names_size;
+	if (m_header.toc_offset % alignof(Entry) != 0 || m_header.toc_offset > m_size ||
+		toc_size > m_size - m_header.toc_offset)
+	{
+		return false;
+	}
+	m_entries = reinterpret_cast<const Entry*>(m_base + m_header.toc_offset);
+	m_names = reinterpret_cast<const char*>(m_entries + m_header.entry_count);
+
+	// Check everything once here so lookups can trust the table
+	for (const Entry& entry : *this)
+	{
+		if (entry.levels == 0 || entry.levels > 16 || entry.nrm_levels > 16)
+			return false;
+		const size_t expected_size = GetPayloadSize(static_cast<PC_TexFormat>(entry.format),
+			entry.width, entry.height, entry.levels, entry.nrm_levels);
+		if (entry.data_offset > m_header.toc_offset ||
+			entry.data_size > m_header.toc_offset - entry.data_offset ||
+			entry.data_size != expected_size || entry.name_offset > m_header.names_size ||
+			entry.name_size > m_header.names_size - entry.name_offset)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t HiresTexturePack::GetPayloadSize(PC_TexFormat format, u32 width, u32 height, u32 levels,
+	u32 nrm_levels)
+{
+	// Normal maps are only uploaded when they cover every color level
+	const size_t maps = nrm_levels != 0 && nrm_levels >= levels ? 2 : 1;
+	size_t size = 0;
+	for (u32 level = 0; level < levels; level++)
+	{
+		u32 mip_width = TextureUtil::CalculateLevelSize(width, level);
+		u32 mip_height = TextureUtil::CalculateLevelSize(height, level);
+		size += TextureUtil::GetTextureSizeInBytes(mip_width, mip_height, format);
+	}
+	return size * maps;
+}
+
+const HiresTexturePack::Entry* HiresTexturePack::Find(const std::string& name) const
+{
+	const u64 hash = GetNameHash(name.data(), name.size());
+	const Entry* iter = std::lower_bound(begin(), end(), hash,
+		[](const Entry& entry, u64 value) { return entry.name_hash < value; });
+	for (; iter != end() && iter->name_hash == hash; ++iter)
+	{
+		if (iter->name_size == name.size() &&
+			std::memcmp(m_names + iter->name_offset, name.data(), name.size()) == 0)
+		{
+			return iter;
+		}
+	}
+	return nullptr;
+}
+
+std::string HiresTexturePack::GetName(const Entry& entry) const
+{
+	return std::string(m_names + entry.name_offset, entry.name_size);
+}
@@ -0,0 +1,113 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/NonCopyable.h"
+#include "VideoCommon/TextureDecoder.h"
+
+// Single file container for custom textures, holding them already decoded in the layout the
+// texture cache uploads (all color levels followed by all normal map levels).
+// The file is memory mapped, so textures are read straight from the mapping instead of being
+// decoded or copied into the prefetch cache.
+//
+// Layout: Header, payloads aligned to PAYLOAD_ALIGNMENT, then the table of entries sorted by
+// name hash followed by the names they point to at Header::toc_offset.
+class HiresTexturePack : NonCopyable
+{
+public:
+	static const u32 PACK_MAGIC = 0x4b505449; // "ITPK"
+	static const u32 PACK_VERSION = 1;
+	static const u32 PAYLOAD_ALIGNMENT = 16;
+	static const u32 FLAG_EMISSIVE_IN_COLOR = 1;
+	// Set on every entry of a pack built with material map generation enabled, the generated maps
+	// are stored as the normal map levels.
+	static const u32 FLAG_BUILT_MATERIAL_MAPS = 2;
+
+	struct Header
+	{
+		u32 magic;
+		u32 version;
+		u64 toc_offset;
+		u32 entry_count;
+		u32 names_size;
+	};
+
+	struct Entry
+	{
+		u64 name_hash;
+		u64 data_offset;
+		u64 data_size;
+		u32 name_offset;
+		u32 name_size;
+		u32 format;
+		u32 width;
+		u32 height;
+		u32 levels;
+		u32 nrm_levels;
+		u32 flags;
+	};
+
+	// Writes a pack, entries are streamed to a temporary file which replaces path on Finish.
+	class Writer : NonCopyable
+	{
+	public:
+		explicit Writer(const std::string& path);
+		~Writer();
+
+		bool IsOpen() const { return m_file.IsOpen(); }
+		bool AddTexture(const std::string& name, PC_TexFormat format, u32 width, u32 height,
+			u32 levels, u32 nrm_levels, u32 flags, const u8* data);
+		bool Finish();
+		size_t GetEntryCount() const { return m_entries.size(); }
+
+	private:
+		std::string m_path;
+		std::string m_temp_path;
+		File::IOFile m_file;
+		std::vector<Entry> m_entries;
+		std::string m_names;
+	};
+
+	~HiresTexturePack();
+
+	// Returns nullptr if the file is missing or not a valid pack.
+	static std::unique_ptr<HiresTexturePack> Open(const std::string& path);
+
+	// Size of the payload of a texture with the layout described above.
+	static size_t GetPayloadSize(PC_TexFormat format, u32 width, u32 height, u32 levels,
+		u32 nrm_levels);
+
+	const Entry* Find(const std::string& name) const;
+	const u8* GetData(const Entry& entry) const { return m_base + entry.data_offset; }
+	std::string GetName(const Entry& entry) const;
+	const Entry* begin() const { return m_entries; }
+	const Entry* end() const { return m_entries + m_header.entry_count; }
+	size_t GetSize() const { return m_size; }
+	bool HasBuiltMaterialMaps() const
+	{
+		return m_header.entry_count > 0 && (m_entries[0].flags & FLAG_BUILT_MATERIAL_MAPS) != 0;
+	}
+
+private:
+	HiresTexturePack() = default;
+	bool Map(const std::string& path);
+	bool Validate();
+
+	u8* m_base = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	void* m_file_handle = nullptr;
+	void* m_mapping_handle = nullptr;
+#endif
+	Header m_header = {};
+	const Entry* m_entries = nullptr;
+	const char* m_names = nullptr;
+};
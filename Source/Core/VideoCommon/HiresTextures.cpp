@@ -4,11 +4,15 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <xxhash.h>
@@ -29,6 +33,7 @@
 #include "Core/ConfigManager.h"
 
 #include "VideoCommon/ImageLoader.h"
+#include "VideoCommon/HiresTexturePack.h"
 #include "VideoCommon/HiresTextures.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/TextureUtil.h"
@@ -78,46 +83,242 @@ struct HiresTextureCacheItem
 typedef std::unordered_map<std::string, HiresTextureCacheItem> HiresTextureCache;
 static HiresTextureCache s_textureMap;
 
-static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
+struct HiresTextureCacheEntry
+{
+	std::shared_ptr<HiresTexture> texture;
+	std::list<std::string>::iterator lru_iter;
+};
+
+static std::unordered_map<std::string, HiresTextureCacheEntry> s_textureCache;
+// Names of the cached textures, most recently used first
+static std::list<std::string> s_textureCacheLRU;
 static std::mutex s_textureCacheMutex;
 static Common::Flag s_textureCacheAbortLoading;
 
+// Textures for the prefetch workers. Misses during gameplay queue the textures that followed them
+// in earlier sessions in s_prefetch_urgent, which is served before the speculative queue.
+static std::deque<std::string> s_prefetch_urgent;
+static std::deque<std::string> s_prefetch_queue;
+static std::mutex s_prefetch_mutex;
+static std::condition_variable s_prefetch_cv;
+static size_t s_prefetch_busy = 0;
+static bool s_prefetch_done = false;
+static u32 s_prefetch_starttime = 0;
+
+// Textures of the game in the order they were first used, the current session goes first when
+// saving. Only touched from the video thread.
+static std::string s_usage_path;
+static std::vector<std::string> s_usage_history;
+static std::unordered_map<std::string, size_t> s_usage_history_index;
+static std::vector<std::string> s_session_usage;
+static std::unordered_set<std::string> s_session_used;
+static const size_t MAX_USAGE_HISTORY = 65536;
+static const size_t SCENE_PREFETCH_COUNT = 64;
+
 static bool s_check_native_format;
 static bool s_check_new_format;
 static std::atomic<size_t> size_sum;
+static std::atomic<size_t> size_peak;
 static size_t max_mem = 0;
-static std::thread s_prefetcher;
+static std::vector<std::thread> s_prefetchers;
+static std::shared_ptr<HiresTexturePack> s_texture_pack;
 
 static const std::string s_format_prefix = "tex1_";
+static const std::string s_pack_filename = "textures.ipk";
 HiresTexture::HiresTexture() :
 	m_format(PC_TEX_FMT_NONE),
 	m_height(0),
 	m_levels(0),
 	m_nrm_levels(0),
 	m_cached_data(nullptr),
-	m_cached_data_size(0)
+	m_cached_data_size(0),
+	m_pack_data(nullptr)
 {}
 
-void HiresTexture::Init()
+static void ClearTextureCache()
 {
+	s_textureCache.clear();
+	s_textureCacheLRU.clear();
 	size_sum.store(0);
+}
+
+// Caller holds s_textureCacheMutex. Drops the least recently used textures until the cache fits
+// in max_mem again.
+static void EvictCachedTextures()
+{
+	while (size_sum.load() > max_mem && s_textureCacheLRU.size() > 1)
+	{
+		auto victim = s_textureCache.find(s_textureCacheLRU.back());
+		size_sum.fetch_sub(victim->second.texture->m_cached_data_size);
+		s_textureCache.erase(victim);
+		s_textureCacheLRU.pop_back();
+	}
+}
+
+// Caller holds s_textureCacheMutex. Textures that were used go to the front of the LRU list and
+// push out the least recently used ones when over the budget. Speculative loads go to the back
+// and are rejected when they do not fit.
+static bool InsertCachedTexture(const std::string& name, const std::shared_ptr<HiresTexture>& texture, bool used)
+{
+	if (s_textureCache.find(name) != s_textureCache.end())
+	{
+		return true;
+	}
+	if (!used && size_sum.load() + texture->m_cached_data_size > max_mem)
+	{
+		return false;
+	}
+	auto lru_iter = s_textureCacheLRU.insert(used ? s_textureCacheLRU.begin() : s_textureCacheLRU.end(), name);
+	s_textureCache.emplace(name, HiresTextureCacheEntry{ texture, lru_iter });
+	size_t new_size = size_sum.fetch_add(texture->m_cached_data_size) + texture->m_cached_data_size;
+	if (new_size > size_peak.load())
+		size_peak.store(new_size);
+	EvictCachedTextures();
+	return true;
+}
+
+// Keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases.
+// The user's host memory budget, when set, caps this further; that is what keeps devices with
+// little RAM from running out of it with large texture packs.
+static size_t CalculateMemoryLimit()
+{
 	size_t sys_mem = Common::MemPhysical();
 	size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
-	// keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
-	max_mem = (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
-	Update();
+	size_t limit = (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+	if (g_ActiveConfig.iHostMemoryBudget > 0)
+		limit = std::min(limit, size_t(g_ActiveConfig.iHostMemoryBudget) * 1024 * 1024);
+	return limit;
 }
 
-void HiresTexture::Shutdown()
+static void StopPrefetch()
 {
-	if (s_prefetcher.joinable())
 	{
+		std::lock_guard<std::mutex> lk(s_prefetch_mutex);
 		s_textureCacheAbortLoading.Set();
-		s_prefetcher.join();
+		s_prefetch_urgent.clear();
+		s_prefetch_queue.clear();
+	}
+	s_prefetch_cv.notify_all();
+	for (std::thread& prefetcher : s_prefetchers)
+	{
+		prefetcher.join();
+	}
+	s_prefetchers.clear();
+}
+
+static void SaveUsageHistory()
+{
+	if (s_usage_path.empty() || s_session_usage.empty())
+	{
+		return;
+	}
+	std::string contents;
+	size_t count = 0;
+	for (const std::string& name : s_session_usage)
+	{
+		if (count++ == MAX_USAGE_HISTORY)
+			break;
+		contents += name + '\n';
+	}
+	for (const std::string& name : s_usage_history)
+	{
+		if (count == MAX_USAGE_HISTORY)
+			break;
+		if (s_session_used.find(name) == s_session_used.end())
+		{
+			contents += name + '\n';
+			count++;
+		}
 	}
+	File::CreateFullPath(s_usage_path);
+	if (!File::WriteStringToFile(contents, s_usage_path))
+	{
+		ERROR_LOG(VIDEO, "Failed to write custom texture usage history %s", s_usage_path.c_str());
+	}
+}
+
+static void LoadUsageHistory(const std::string& game_id)
+{
+	s_usage_path = File::GetUserPath(D_CACHE_IDX) + "HiresTextures" DIR_SEP + game_id + ".txt";
+	s_usage_history.clear();
+	s_usage_history_index.clear();
+	s_session_usage.clear();
+	s_session_used.clear();
+	std::string contents;
+	if (!File::ReadFileToString(s_usage_path, contents))
+	{
+		return;
+	}
+	std::vector<std::string> names;
+	SplitString(contents, '\n', names);
+	for (std::string& name : names)
+	{
+		if (!name.empty() && s_usage_history_index.emplace(name, s_usage_history.size()).second)
+		{
+			s_usage_history.push_back(std::move(name));
+		}
+	}
+}
+
+static void RecordUsage(const std::string& name)
+{
+	if (s_session_used.insert(name).second)
+	{
+		s_session_usage.push_back(name);
+	}
+}
+
+// A texture had to be loaded during gameplay, queue what was used after it last time.
+static void PrefetchScene(const std::string& name)
+{
+	auto iter = s_usage_history_index.find(name);
+	if (s_prefetchers.empty() || iter == s_usage_history_index.end())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lk(s_prefetch_mutex);
+		size_t end = std::min(iter->second + 1 + SCENE_PREFETCH_COUNT, s_usage_history.size());
+		for (size_t i = iter->second + 1; i < end; i++)
+		{
+			s_prefetch_urgent.push_back(s_usage_history[i]);
+		}
+	}
+	s_prefetch_cv.notify_all();
+}
+
+void HiresTexture::Init()
+{
+	size_sum.store(0);
+	size_peak.store(0);
+	max_mem = CalculateMemoryLimit();
+	Update();
+}
+
+size_t HiresTexture::GetCacheMemoryUsage()
+{
+	return size_sum.load();
+}
+
+size_t HiresTexture::GetCacheMemoryPeak()
+{
+	return size_peak.load();
+}
+
+size_t HiresTexture::GetCacheMemoryLimit()
+{
+	return max_mem;
+}
+
+void HiresTexture::Shutdown()
+{
+	StopPrefetch();
+	SaveUsageHistory();
+	s_usage_path.clear();
 
 	s_textureMap.clear();
-	s_textureCache.clear();
+	ClearTextureCache();
+	s_texture_pack.reset();
 }
 
 std::string HiresTexture::GetTextureDirectory(const std::string& game_id)
@@ -136,29 +337,55 @@ void HiresTexture::Update()
 	s_check_native_format = false;
 	s_check_new_format = false;
 	bool BuildMaterialMaps = g_ActiveConfig.bHiresMaterialMapsBuild;
-	if (s_prefetcher.joinable())
+	StopPrefetch();
+	SaveUsageHistory();
+	s_usage_path.clear();
+
 	{
-		s_textureCacheAbortLoading.Set();
-		s_prefetcher.join();
+		std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+		max_mem = CalculateMemoryLimit();
+		EvictCachedTextures();
 	}
 
+	s_texture_pack.reset();
 	if (!g_ActiveConfig.bHiresTextures)
 	{
 		s_textureMap.clear();
-		s_textureCache.clear();
-		size_sum.store(0);
+		ClearTextureCache();
 		return;
 	}
 
 	if (!g_ActiveConfig.bCacheHiresTextures)
 	{
-		s_textureCache.clear();
-		size_sum.store(0);
+		ClearTextureCache();
 	}
 
 	s_textureMap.clear();
 	const std::string& game_id = SConfig::GetInstance().m_strGameID;
+	LoadUsageHistory(game_id);
 	const std::string texture_directory = GetTextureDirectory(game_id);
+	const std::string pack_path = texture_directory + DIR_SEP + s_pack_filename;
+	s_texture_pack = HiresTexturePack::Open(pack_path);
+	if (s_texture_pack)
+	{
+		for (const HiresTexturePack::Entry& entry : *s_texture_pack)
+		{
+			std::string name = s_texture_pack->GetName(entry);
+			if (name.compare(0, s_format_prefix.length(), s_format_prefix) == 0)
+				s_check_new_format = true;
+			else
+				s_check_native_format = true;
+		}
+		INFO_LOG(VIDEO, "Custom texture pack %s mapped, %u textures", pack_path.c_str(),
+			static_cast<u32>(s_texture_pack->end() - s_texture_pack->begin()));
+	}
+	// A pack built without the generated material maps is replaced by one that has them.
+	if (s_texture_pack && BuildMaterialMaps && !s_texture_pack->HasBuiltMaterialMaps())
+	{
+		INFO_LOG(VIDEO, "Custom texture pack %s has no generated material maps, rebuilding it",
+			pack_path.c_str());
+		s_texture_pack.reset();
+	}
 
 	std::string ddscode(".dds");
 	std::string cddscode(".DDS");
@@ -255,7 +482,16 @@ void HiresTexture::Update()
 		}
 	}
 
-	if (g_ActiveConfig.bCacheHiresTextures && s_textureMap.size() > 0)
+	// The pack is only built when there is none, delete it to build it again. Generated material
+	// maps always go through the pack, so they are built once in the background instead of
+	// on every load.
+	if ((g_ActiveConfig.bBuildHiresTexturePack || BuildMaterialMaps) && !s_texture_pack &&
+		s_textureMap.size() > 0)
+	{
+		s_textureCacheAbortLoading.Clear();
+		s_prefetchers.emplace_back(BuildPack, pack_path);
+	}
+	else if (g_ActiveConfig.bCacheHiresTextures && s_textureMap.size() > 0)
 	{
 		// remove cached but deleted textures
 		auto iter = s_textureCache.begin();
@@ -263,7 +499,8 @@ void HiresTexture::Update()
 		{
 			if (s_textureMap.find(iter->first) == s_textureMap.end())
 			{
-				size_sum.fetch_sub(iter->second->m_cached_data_size);
+				size_sum.fetch_sub(iter->second.texture->m_cached_data_size);
+				s_textureCacheLRU.erase(iter->second.lru_iter);
 				iter = s_textureCache.erase(iter);
 			}
 			else
@@ -271,8 +508,31 @@ void HiresTexture::Update()
 				iter++;
 			}
 		}
+
+		// Textures used in earlier sessions first, in the order they were needed
+		for (const std::string& name : s_usage_history)
+		{
+			if (s_textureMap.find(name) != s_textureMap.end())
+			{
+				s_prefetch_queue.push_back(name);
+			}
+		}
+		for (const auto& entry : s_textureMap)
+		{
+			if (s_usage_history_index.find(entry.first) == s_usage_history_index.end())
+			{
+				s_prefetch_queue.push_back(entry.first);
+			}
+		}
+		s_prefetch_busy = 0;
+		s_prefetch_done = false;
+		s_prefetch_starttime = Common::Timer::GetTimeMs();
 		s_textureCacheAbortLoading.Clear();
-		s_prefetcher = std::thread(Prefetch);
+		const u32 thread_count = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2));
+		for (u32 i = 0; i < thread_count; i++)
+		{
+			s_prefetchers.emplace_back(Prefetch);
+		}
 	}
 }
 
@@ -280,44 +540,104 @@ void HiresTexture::Prefetch()
 {
 	Common::SetCurrentThreadName("Prefetcher");
 
-	u32 starttime = Common::Timer::GetTimeMs();
-	for (const auto& entry : s_textureMap)
+	std::unique_lock<std::mutex> queue_lk(s_prefetch_mutex);
+	while (!s_textureCacheAbortLoading.IsSet())
 	{
-		const std::string& base_filename = entry.first;
-
-		std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+		const bool urgent = !s_prefetch_urgent.empty();
+		if (!urgent && s_prefetch_queue.empty())
+		{
+			s_prefetch_cv.wait(queue_lk);
+			continue;
+		}
+		std::deque<std::string>& queue = urgent ? s_prefetch_urgent : s_prefetch_queue;
+		std::string base_filename = std::move(queue.front());
+		queue.pop_front();
+		s_prefetch_busy++;
+		queue_lk.unlock();
 
-		auto iter = s_textureCache.find(base_filename);
-		if (iter == s_textureCache.end())
+		bool loaded = true;
+		// Textures in the mapped pack need no caching
+		if (!s_texture_pack || !s_texture_pack->Find(base_filename))
 		{
-			lk.unlock();
-			HiresTexture* ptr = Load(base_filename, [](size_t requested_size)
-			{
-				return new u8[requested_size];
-			}, true);
-			lk.lock();
-			if (ptr != nullptr)
+			std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+			if (s_textureCache.find(base_filename) == s_textureCache.end())
 			{
-				size_sum.fetch_add(ptr->m_cached_data_size);
-				iter = s_textureCache.insert(iter, std::make_pair(base_filename, std::shared_ptr<HiresTexture>(ptr)));
+				lk.unlock();
+				std::shared_ptr<HiresTexture> ptr(Load(base_filename, [](size_t requested_size)
+				{
+					return new u8[requested_size];
+				}, true, g_ActiveConfig.bHiresMaterialMapsBuild));
+				lk.lock();
+				if (ptr)
+				{
+					loaded = InsertCachedTexture(base_filename, ptr, urgent);
+				}
 			}
 		}
 
-		if (s_textureCacheAbortLoading.IsSet())
+		queue_lk.lock();
+		s_prefetch_busy--;
+		if (s_prefetch_done)
 		{
-			return;
+			continue;
+		}
+		if (!loaded)
+		{
+			// Stop the speculative loads, textures used from now on replace the least recently used
+			s_prefetch_queue.clear();
+			s_prefetch_done = true;
+			OSD::AddMessage(StringFromFormat("Custom Textures prefetching stopped after %.1f MB, not enough RAM available", size_sum / (1024.0 * 1024.0)), 10000);
+		}
+		else if (s_prefetch_queue.empty() && s_prefetch_busy == 0)
+		{
+			s_prefetch_done = true;
+			u32 stoptime = Common::Timer::GetTimeMs();
+			OSD::AddMessage(StringFromFormat("Custom Textures loaded, %.1f MB in %.1f s", size_sum / (1024.0 * 1024.0), (stoptime - s_prefetch_starttime) / 1000.0), 10000);
 		}
+	}
+}
 
-		if (size_sum.load() > max_mem)
+void HiresTexture::BuildPack(const std::string& path)
+{
+	Common::SetCurrentThreadName("Texture Pack Builder");
+	const bool build_material_maps = g_ActiveConfig.bHiresMaterialMapsBuild;
+
+	u32 starttime = Common::Timer::GetTimeMs();
+	HiresTexturePack::Writer writer(path);
+	if (!writer.IsOpen())
+	{
+		ERROR_LOG(VIDEO, "Failed to create custom texture pack %s", path.c_str());
+		return;
+	}
+	for (const auto& entry : s_textureMap)
+	{
+		std::unique_ptr<HiresTexture> texture(Load(entry.first, [](size_t requested_size)
 		{
-			g_Config.bCacheHiresTextures = false;
+			return new u8[requested_size];
+		}, true, build_material_maps));
+		u32 flags = texture && texture->emissive_in_color ? HiresTexturePack::FLAG_EMISSIVE_IN_COLOR : 0;
+		if (build_material_maps)
+			flags |= HiresTexturePack::FLAG_BUILT_MATERIAL_MAPS;
+		if (texture && !writer.AddTexture(entry.first, texture->m_format, texture->m_width,
+			texture->m_height, texture->m_levels, texture->m_nrm_levels, flags,
+			texture->m_cached_data.get()))
+		{
+			ERROR_LOG(VIDEO, "Failed to write custom texture pack %s", path.c_str());
+			return;
+		}
 
-			OSD::AddMessage(StringFromFormat("Custom Textures prefetching after %.1f MB aborted, not enough RAM available", size_sum / (1024.0 * 1024.0)), 10000);
+		if (s_textureCacheAbortLoading.IsSet())
+		{
 			return;
 		}
 	}
+	if (!writer.Finish())
+	{
+		ERROR_LOG(VIDEO, "Failed to write custom texture pack %s", path.c_str());
+		return;
+	}
 	u32 stoptime = Common::Timer::GetTimeMs();
-	OSD::AddMessage(StringFromFormat("Custom Textures loaded, %.1f MB in %.1f s", size_sum / (1024.0 * 1024.0), (stoptime - starttime) / 1000.0), 10000);
+	OSD::AddMessage(StringFromFormat("Custom Texture pack with %zu textures built in %.1f s, it is used from the next start", writer.GetEntryCount(), (stoptime - starttime) / 1000.0), 10000);
 }
 
 std::string HiresTexture::GenBaseName(
@@ -619,6 +939,23 @@ std::shared_ptr<HiresTexture> HiresTexture::Search(
 	const std::string& basename,
 	std::function<u8*(size_t)> request_buffer_delegate)
 {
+	if (s_texture_pack)
+	{
+		const HiresTexturePack::Entry* entry = s_texture_pack->Find(basename);
+		if (entry)
+		{
+			std::shared_ptr<HiresTexture> ptr(new HiresTexture());
+			ptr->m_format = static_cast<PC_TexFormat>(entry->format);
+			ptr->m_width = entry->width;
+			ptr->m_height = entry->height;
+			ptr->m_levels = entry->levels;
+			ptr->m_nrm_levels = entry->nrm_levels >= entry->levels ? entry->nrm_levels : 0;
+			ptr->emissive_in_color = (entry->flags & HiresTexturePack::FLAG_EMISSIVE_IN_COLOR) != 0;
+			ptr->m_pack_data = s_texture_pack->GetData(*entry);
+			ptr->m_pack = s_texture_pack;
+			return ptr;
+		}
+	}
 	if (g_ActiveConfig.bCacheHiresTextures)
 	{
 		std::unique_lock<std::mutex> lk(s_textureCacheMutex);
@@ -626,35 +963,40 @@ std::shared_ptr<HiresTexture> HiresTexture::Search(
 		auto iter = s_textureCache.find(basename);
 		if (iter != s_textureCache.end())
 		{
-			HiresTexture* current = iter->second.get();
-			u8* dst = request_buffer_delegate(current->m_cached_data_size);
-			memcpy(dst, current->m_cached_data.get(), current->m_cached_data_size);
-			return iter->second;
+			s_textureCacheLRU.splice(s_textureCacheLRU.begin(), s_textureCacheLRU, iter->second.lru_iter);
+			std::shared_ptr<HiresTexture> ptr = iter->second.texture;
+			u8* dst = request_buffer_delegate(ptr->m_cached_data_size);
+			memcpy(dst, ptr->m_cached_data.get(), ptr->m_cached_data_size);
+			lk.unlock();
+			RecordUsage(basename);
+			return ptr;
 		}
 		lk.unlock();
-		if (size_sum.load() < max_mem)
+		std::shared_ptr<HiresTexture> ptr(Load(basename, [](size_t requested_size)
 		{
-			std::shared_ptr<HiresTexture> ptr(Load(basename, [](size_t requested_size)
-			{
-				return new u8[requested_size];
-			}, true));
+			return new u8[requested_size];
+		}, true, false));
+		if (ptr)
+		{
+			RecordUsage(basename);
+			PrefetchScene(basename);
 			lk.lock();
-			if (ptr)
-			{
-				s_textureCache[basename] = ptr;
-				HiresTexture* current = ptr.get();
-				size_sum.fetch_add(current->m_cached_data_size);
-				u8* dst = request_buffer_delegate(current->m_cached_data_size);
-				memcpy(dst, current->m_cached_data.get(), current->m_cached_data_size);
-			}
-			return ptr;
+			InsertCachedTexture(basename, ptr, true);
+			u8* dst = request_buffer_delegate(ptr->m_cached_data_size);
+			memcpy(dst, ptr->m_cached_data.get(), ptr->m_cached_data_size);
 		}
+		return ptr;
+	}
+	std::shared_ptr<HiresTexture> ptr(Load(basename, request_buffer_delegate, false, false));
+	if (ptr)
+	{
+		RecordUsage(basename);
 	}
-	return std::shared_ptr<HiresTexture>(Load(basename, request_buffer_delegate, false));
+	return ptr;
 }
 
 HiresTexture* HiresTexture::Load(const std::string& basename,
-	std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult)
+	std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult, bool build_material_maps)
 {
 	if (s_textureMap.size() == 0)
 	{
@@ -682,7 +1024,7 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
 	bool last_level_is_dds = false;
 	bool allocated_data = false;
 	bool mipmapsize_included = false;
-	size_t material_mat_index = g_ActiveConfig.bHiresMaterialMapsBuild ? MapType::normal : MapType::material;
+	size_t material_mat_index = build_material_maps ? MapType::normal : MapType::material;
 	bool nrm_posible = current.maps[MapType::color].size() == current.maps[material_mat_index].size() && g_ActiveConfig.HiresMaterialMapsEnabled();
 	size_t remaining_buffer_size = 0;
 	size_t total_buffer_size = 0;
@@ -748,7 +1090,7 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
 				break;
 			}
 			last_level_is_dds = false;
-			if (g_ActiveConfig.bHiresMaterialMapsBuild)
+			if (build_material_maps)
 			{
 				emissive_present = BuildColor(current, imgInfo, level);
 			}
@@ -867,7 +1209,7 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
 					break;
 				}
 				last_level_is_dds = false;
-				if (g_ActiveConfig.bHiresMaterialMapsBuild)
+				if (build_material_maps)
 				{
 					BuildMaterial(current, imgInfo, level);
 				}
@@ -5,12 +5,15 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/VideoCommon.h"
 
+class HiresTexturePack;
+
 class HiresTexture
 {
 public:
@@ -18,6 +21,11 @@ public:
 	static void Update();
 	static void Shutdown();
 
+	// Bytes held by the custom texture cache now, the most it held this session and its limit
+	static size_t GetCacheMemoryUsage();
+	static size_t GetCacheMemoryPeak();
+	static size_t GetCacheMemoryLimit();
+
 	static std::shared_ptr<HiresTexture> Search(const std::string& basename,
 		std::function<u8*(size_t)> request_buffer_delegate
 	);
@@ -37,9 +45,17 @@ public:
 	bool emissive_in_color;
 	std::unique_ptr<u8> m_cached_data;
 	size_t m_cached_data_size;
+	// Set for textures from the texture pack, their texels are read from the mapped file directly
+	// and are not copied to the buffer requested in Search.
+	const u8* m_pack_data;
 private:
+	static void BuildPack(const std::string& path);
+	std::shared_ptr<HiresTexturePack> m_pack;
+	// Material maps are only generated from the bump and specular maps with build_material_maps,
+	// which is never set on the GPU thread.
 	static HiresTexture* Load(const std::string& base_filename,
-		std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult);
+		std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult,
+		bool build_material_maps);
 	static void Prefetch();
 	HiresTexture();
 	static std::string GetTextureDirectory(const std::string& game_id);
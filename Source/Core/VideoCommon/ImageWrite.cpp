@@ -2,15 +2,30 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <atomic>
+#include <cstring>
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "png.h"
+#include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/Intrinsics.h"
 #include "Common/MsgHandler.h"
+#include "Common/ThreadPool.h"
 #include "VideoCommon/ImageWrite.h"
 
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
+
+// Bounds the memory held by queued dumps when the encoders can't keep up.
+static const int MAX_PENDING_PNG_WRITES = 64;
+static std::atomic<int> s_pending_png_writes{ 0 };
+
 bool SaveData(const std::string& filename, const std::string& data)
 {
 	std::ofstream f;
@@ -21,6 +36,51 @@ bool SaveData(const std::string& filename, const std::string& data)
 }
 
 
+// Converts a row of BGRA or RGBA pixels to the RGBA that libpng wants, optionally forcing
+// alpha to opaque. Frame dumps go through this for every pixel of every frame.
+static void ConvertRowToRGBA(u8* dst, const u8* src, int width, bool frombgra, bool saveAlpha)
+{
+	int x = 0;
+#if _M_SSE >= 0x301
+	if (cpu_info.bSSSE3)
+	{
+		const __m128i mask = frombgra ?
+			_mm_set_epi8(15, 12, 13, 14, 11, 8, 9, 10, 7, 4, 5, 6, 3, 0, 1, 2) :
+			_mm_set_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+		const __m128i alpha = _mm_set1_epi32(saveAlpha ? 0 : static_cast<int>(0xff000000));
+		for (; x + 4 <= width; x += 4)
+		{
+			__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x));
+			pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, mask), alpha);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x), pixels);
+		}
+	}
+#elif defined(_M_ARM_64)
+	for (; x + 16 <= width; x += 16)
+	{
+		uint8x16x4_t pixels = vld4q_u8(src + 4 * x);
+		if (frombgra)
+		{
+			uint8x16_t b = pixels.val[0];
+			pixels.val[0] = pixels.val[2];
+			pixels.val[2] = b;
+		}
+		if (!saveAlpha)
+			pixels.val[3] = vdupq_n_u8(0xff);
+		vst4q_u8(dst + 4 * x, pixels);
+	}
+#endif
+	int src_r = frombgra ? 2 : 0;
+	int src_b = frombgra ? 0 : 2;
+	for (; x < width; x++)
+	{
+		dst[4 * x + 0] = src[4 * x + src_r];
+		dst[4 * x + 1] = src[4 * x + 1];
+		dst[4 * x + 2] = src[4 * x + src_b];
+		dst[4 * x + 3] = saveAlpha ? src[4 * x + 3] : 0xff;
+	}
+}
+
 /*
 TextureToPng
 
@@ -97,15 +157,7 @@ bool TextureToPng(const u8* data, int row_stride, const std::string& filename, i
 		const u8* row_ptr = data + y * row_stride;
 		if (!saveAlpha || frombgra)
 		{
-			int src_r = frombgra ? 2 : 0;
-			int src_b = frombgra ? 0 : 2;
-			for (int x = 0; x < width; x++)
-			{
-				buffer[4 * x + 0] = row_ptr[4 * x + src_r];
-				buffer[4 * x + 1] = row_ptr[4 * x + 1];
-				buffer[4 * x + 2] = row_ptr[4 * x + src_b];
-				buffer[4 * x + 3] = saveAlpha ? row_ptr[4 * x + 3] : 0xff;
-			}
+			ConvertRowToRGBA(buffer.data(), row_ptr, width, frombgra, saveAlpha);
 			row_ptr = buffer.data();
 		}
 		// The old API uses u8* instead of const u8*. It doesn't write
@@ -126,3 +178,26 @@ finalise:
 
 	return success;
 }
+
+bool TextureToPngAsync(const u8* data, int row_stride, const std::string& filename, int width,
+	int height, bool saveAlpha, bool frombgra)
+{
+	if (!data)
+		return false;
+
+	if (s_pending_png_writes.load() >= MAX_PENDING_PNG_WRITES)
+		return TextureToPng(data, row_stride, filename, width, height, saveAlpha, frombgra);
+
+	// The source is usually a mapped readback buffer, so keep only the visible rows
+	const int packed_stride = width * 4;
+	auto pixels = std::make_shared<std::vector<u8>>(static_cast<size_t>(packed_stride) * height);
+	for (int y = 0; y < height; y++)
+		memcpy(pixels->data() + static_cast<size_t>(y) * packed_stride, data + static_cast<size_t>(y) * row_stride, packed_stride);
+
+	s_pending_png_writes++;
+	Common::AsyncWorker::ExecuteAsync([pixels, packed_stride, filename, width, height, saveAlpha, frombgra]() {
+		TextureToPng(pixels->data(), packed_stride, filename, width, height, saveAlpha, frombgra);
+		s_pending_png_writes--;
+	});
+	return true;
+}
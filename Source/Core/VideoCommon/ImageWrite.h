@@ -11,4 +11,8 @@
 bool SaveData(const std::string& filename, const std::string& data);
 bool TextureToPng(const u8* data, int row_stride, const std::string& filename, int width,
 	int height, bool saveAlpha = false, bool frombgra = false);
+// Copies the image and compresses it on the async worker pool, for texture and EFB dumps. Writes
+// synchronously instead when too many encodes are already queued.
+bool TextureToPngAsync(const u8* data, int row_stride, const std::string& filename, int width,
+	int height, bool saveAlpha = false, bool frombgra = false);
 bool TextureToDDS(const u8* data, int row_stride, const std::string& filename, int width, int height, DDSCompression format = DDSCompression::DDSC_DXT3);
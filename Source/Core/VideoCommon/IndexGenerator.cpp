@@ -5,6 +5,7 @@
 #include <cstddef>
 
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OpcodeDecoding.h"
@@ -55,11 +56,72 @@ __forceinline u16* IndexGenerator::WriteTriangle(u16* ptr, u32 index1, u32 index
 	return ptr;
 }
 
+// Long primitives are expanded in blocks of 24 indices: the first block is first_index + offsets
+// and every following block adds steps to the previous one, 8 indices per vector.
+static const u32 BLOCK_INDICES = 24;
+
+// 8 triangles of a strip, odd ones winded
+alignas(16) static const u16 s_strip_offsets[BLOCK_INDICES] = {
+	0, 1, 2, 1, 3, 2, 2, 3, 4, 3, 5, 4, 4, 5, 6, 5, 7, 6, 6, 7, 8, 7, 9, 8 };
+alignas(16) static const u16 s_strip_steps[BLOCK_INDICES] = {
+	8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8 };
+
+// 8 triangles of a fan, the center vertex stays in place
+alignas(16) static const u16 s_fan_offsets[BLOCK_INDICES] = {
+	0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5, 0, 5, 6, 0, 6, 7, 0, 7, 8, 0, 8, 9 };
+alignas(16) static const u16 s_fan_steps[BLOCK_INDICES] = {
+	0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8 };
+
+// 8 triangles of a list
+alignas(16) static const u16 s_list_offsets[BLOCK_INDICES] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23 };
+alignas(16) static const u16 s_list_steps[BLOCK_INDICES] = {
+	24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24 };
+
+// 4 quads
+alignas(16) static const u16 s_quad_offsets[BLOCK_INDICES] = {
+	0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7, 8, 9, 10, 8, 10, 11, 12, 13, 14, 12, 14, 15 };
+alignas(16) static const u16 s_quad_steps[BLOCK_INDICES] = {
+	16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 };
+
+u16* IndexGenerator::WriteBlocks(u16* ptr, u32 first_index, u32 blocks, const u16* offsets,
+	const u16* steps)
+{
+#ifdef _M_X86
+	const __m128i first = _mm_set1_epi16(static_cast<s16>(first_index));
+	__m128i indices0 = _mm_add_epi16(first, _mm_load_si128(reinterpret_cast<const __m128i*>(offsets)));
+	__m128i indices1 = _mm_add_epi16(first, _mm_load_si128(reinterpret_cast<const __m128i*>(offsets + 8)));
+	__m128i indices2 = _mm_add_epi16(first, _mm_load_si128(reinterpret_cast<const __m128i*>(offsets + 16)));
+	const __m128i steps0 = _mm_load_si128(reinterpret_cast<const __m128i*>(steps));
+	const __m128i steps1 = _mm_load_si128(reinterpret_cast<const __m128i*>(steps + 8));
+	const __m128i steps2 = _mm_load_si128(reinterpret_cast<const __m128i*>(steps + 16));
+	for (u32 block = 0; block < blocks; ++block)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), indices0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(ptr + 8), indices1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(ptr + 16), indices2);
+		indices0 = _mm_add_epi16(indices0, steps0);
+		indices1 = _mm_add_epi16(indices1, steps1);
+		indices2 = _mm_add_epi16(indices2, steps2);
+		ptr += BLOCK_INDICES;
+	}
+#else
+	for (u32 block = 0; block < blocks; ++block)
+	{
+		for (u32 i = 0; i < BLOCK_INDICES; ++i)
+			ptr[i] = static_cast<u16>(first_index + offsets[i] + block * steps[i]);
+		ptr += BLOCK_INDICES;
+	}
+#endif
+	return ptr;
+}
+
 void IndexGenerator::AddList(u32 const numVerts)
 {
-	u32 i = base_index + 2;
+	const u32 blocks = numVerts / 24;
+	u16* ptr = WriteBlocks(index_buffer_current, base_index, blocks, s_list_offsets, s_list_steps);
+	u32 i = base_index + blocks * 24 + 2;
 	u32 top = (base_index + numVerts);
-	u16* ptr = index_buffer_current;
 	while (i < top)
 	{
 		ptr = WriteTriangle(ptr, i - 2, i - 1, i);
@@ -70,9 +132,11 @@ void IndexGenerator::AddList(u32 const numVerts)
 
 void IndexGenerator::AddStrip(u32 const numVerts)
 {
-	u16* ptr = index_buffer_current;
+	// Blocks hold an even number of triangles, so the winding of the rest starts over
+	const u32 blocks = numVerts > 2 ? (numVerts - 2) / 8 : 0;
+	u16* ptr = WriteBlocks(index_buffer_current, base_index, blocks, s_strip_offsets, s_strip_steps);
 	u32 top = (base_index + numVerts);
-	u32 a = base_index;
+	u32 a = base_index + blocks * 8;
 	u32 i = a + 2;
 	u32 wind = 1;
 	while (i < top)
@@ -112,9 +176,10 @@ void IndexGenerator::AddStrip(u32 const numVerts)
 
 void IndexGenerator::AddFan(u32 numVerts)
 {
-	u32 i = base_index + 2;
+	const u32 blocks = numVerts > 2 ? (numVerts - 2) / 8 : 0;
+	u16* ptr = WriteBlocks(index_buffer_current, base_index, blocks, s_fan_offsets, s_fan_steps);
+	u32 i = base_index + blocks * 8 + 2;
 	u32 top = (base_index + numVerts);
-	u16* ptr = index_buffer_current;
 
 	while (i < top)
 	{
@@ -143,9 +208,10 @@ void IndexGenerator::AddFan(u32 numVerts)
  */
 void IndexGenerator::AddQuads(u32 numVerts)
 {
-	u32 i = base_index + 3;
+	const u32 blocks = numVerts / 16;
+	u16* ptr = WriteBlocks(index_buffer_current, base_index, blocks, s_quad_offsets, s_quad_steps);
+	u32 i = base_index + blocks * 16 + 3;
 	u32 top = (base_index + numVerts);
-	u16* ptr = index_buffer_current;
 	while (i < top)
 	{
 		ptr = WriteTriangle(ptr, i - 3, i - 2, i - 1);
@@ -51,6 +51,8 @@ private:
 	static void AddPoints(u32 numVerts);
 
 	static u16* WriteTriangle(u16 *ptr, u32 index1, u32 index2, u32 index3);
+	static u16* WriteBlocks(u16* ptr, u32 first_index, u32 blocks, const u16* offsets,
+		const u16* steps);
 
 	static u16 *index_buffer_current;
 	static u16 *BASEIptr;
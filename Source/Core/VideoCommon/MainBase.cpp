@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 
 #include "Common/ChunkFile.h"
@@ -15,6 +17,7 @@
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/DLCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/TessellationShaderManager.h"
@@ -25,6 +28,7 @@
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/UberShaderManager.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -33,6 +37,8 @@
 
 static Common::Flag s_FifoShuttingDown;
 volatile u32 s_EFB_PCache_Frame;
+// Bumped by the GPU thread on every draw, clear or reinterpretation of the EFB.
+static std::atomic<u32> s_EFB_PeekTile_Generation{ 1 };
 
 static volatile struct
 {
@@ -62,8 +68,9 @@ void VideoBackendBase::Video_BeginField(u32 xfbAddr, u32 fbWidth, u32 fbStride,
 {
 	if (m_initialized && g_ActiveConfig.bUseXFB && g_renderer)
 	{
-		Fifo::SyncGPU(Fifo::SyncGPUReason::Swap);
-
+		// No SyncGPU here. The CPU can't observe a swap, and the deterministic GPU thread decodes
+		// everything pushed so far before it handles queued events, so the swap still comes after
+		// the draws of its field.
 		AsyncRequests::Event e;
 		e.time = ticks;
 		e.type = AsyncRequests::Event::SWAP_EVENT;
@@ -87,6 +94,11 @@ VideoBackendBase::VideoBackendBase()
 	m_EFB_PCache_Height = EFB_HEIGHT >> m_EFB_PCache_Divisor;
 	m_EFB_PCache_Size = m_EFB_PCache_Width * m_EFB_PCache_Height;
 	m_EFB_PCache = new EFBPeekCacheElement[m_EFB_PCache_Size];
+	for (int i = 0; i < 2; i++)
+	{
+		m_EFB_PeekTiles[i].resize(EFB_WIDTH * EFB_HEIGHT);
+		m_EFB_PeekTileGeneration[i].resize((EFB_WIDTH / EFB_PEEK_TILE_SIZE) * (EFB_HEIGHT / EFB_PEEK_TILE_SIZE));
+	}
 }
 
 VideoBackendBase::~VideoBackendBase()
@@ -114,6 +126,13 @@ u32 VideoBackendBase::Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32 Inpu
 		e.efb_poke.x = x;
 		e.efb_poke.y = y;
 		AsyncRequests::GetInstance()->PushEvent(e, false);
+
+		// The poke is still queued, the next peek has to go through the GPU thread after it.
+		if (x < EFB_WIDTH && y < EFB_HEIGHT)
+		{
+			u32 tile = (y / EFB_PEEK_TILE_SIZE) * (EFB_WIDTH / EFB_PEEK_TILE_SIZE) + x / EFB_PEEK_TILE_SIZE;
+			m_EFB_PeekTileGeneration[type == EFBAccessType::PokeColor ? 1 : 0][tile] = 0;
+		}
 	}
 	else
 	{
@@ -128,14 +147,21 @@ u32 VideoBackendBase::Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32 Inpu
 				return m_EFB_PCache[efb_p_cache_stride].DepthValue;
 			}
 		}
-		AsyncRequests::Event e;
-
-		e.type = type == EFBAccessType::PeekColor ? AsyncRequests::Event::EFB_PEEK_COLOR : AsyncRequests::Event::EFB_PEEK_Z;
-		e.time = 0;
-		e.efb_peek.x = x;
-		e.efb_peek.y = y;
-		e.efb_peek.data = &result;
-		AsyncRequests::GetInstance()->PushEvent(e, true);
+		if (x < EFB_WIDTH && y < EFB_HEIGHT)
+		{
+			result = PeekEFBTile(type, x, y);
+		}
+		else
+		{
+			AsyncRequests::Event e;
+
+			e.type = type == EFBAccessType::PeekColor ? AsyncRequests::Event::EFB_PEEK_COLOR : AsyncRequests::Event::EFB_PEEK_Z;
+			e.time = 0;
+			e.efb_peek.x = x;
+			e.efb_peek.y = y;
+			e.efb_peek.data = &result;
+			AsyncRequests::GetInstance()->PushEvent(e, true);
+		}
 	}
 	if (g_ActiveConfig.bEFBFastAccess)
 	{
@@ -153,6 +179,49 @@ u32 VideoBackendBase::Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32 Inpu
 	return result;
 }
 
+u32 VideoBackendBase::PeekEFBTile(EFBAccessType type, u32 x, u32 y)
+{
+	const int cache = type == EFBAccessType::PeekColor ? 1 : 0;
+	if (cache == 1)
+	{
+		// The alpha read mode is applied by the backends when peeking.
+		u32 alpha_read_mode = PixelEngine::GetAlphaReadMode().Hex;
+		if (alpha_read_mode != m_EFB_PeekTileAlphaReadMode)
+		{
+			m_EFB_PeekTileAlphaReadMode = alpha_read_mode;
+			std::fill(m_EFB_PeekTileGeneration[1].begin(), m_EFB_PeekTileGeneration[1].end(), 0);
+		}
+	}
+
+	u32 tile_x = x / EFB_PEEK_TILE_SIZE;
+	u32 tile_y = y / EFB_PEEK_TILE_SIZE;
+	u32 tile = tile_y * (EFB_WIDTH / EFB_PEEK_TILE_SIZE) + tile_x;
+	u32* tile_data = &m_EFB_PeekTiles[cache][tile * EFB_PEEK_TILE_SIZE * EFB_PEEK_TILE_SIZE];
+
+	// Read before the request, a draw coming in while the tile is read invalidates it again.
+	u32 generation = s_EFB_PeekTile_Generation.load();
+	if (m_EFB_PeekTileGeneration[cache][tile] != generation)
+	{
+		AsyncRequests::Event e;
+		e.type = cache == 1 ? AsyncRequests::Event::EFB_PEEK_COLOR_TILE : AsyncRequests::Event::EFB_PEEK_Z_TILE;
+		e.time = 0;
+		e.efb_peek.x = tile_x * EFB_PEEK_TILE_SIZE;
+		e.efb_peek.y = tile_y * EFB_PEEK_TILE_SIZE;
+		e.efb_peek.data = tile_data;
+		AsyncRequests::GetInstance()->PushEvent(e, true);
+		m_EFB_PeekTileGeneration[cache][tile] = generation;
+	}
+
+	return tile_data[(y % EFB_PEEK_TILE_SIZE) * EFB_PEEK_TILE_SIZE + x % EFB_PEEK_TILE_SIZE];
+}
+
+void VideoBackendBase::InvalidateEFBPeekTiles()
+{
+	// Skip 0, it marks tiles that were never read.
+	if (++s_EFB_PeekTile_Generation == 0)
+		++s_EFB_PeekTile_Generation;
+}
+
 u32 VideoBackendBase::Video_GetQueryResult(PerfQueryType type)
 {
 	if (!g_perf_query->ShouldEmulate())
@@ -162,6 +231,26 @@ u32 VideoBackendBase::Video_GetQueryResult(PerfQueryType type)
 
 	Fifo::SyncGPU(Fifo::SyncGPUReason::PerfQuery);
 
+	if (g_ActiveConfig.bPerfQueriesAsync)
+	{
+		// Only a fully resolved count is meaningful, while queries are in flight the game
+		// sees the last complete one and the GPU thread collects whatever finished meanwhile.
+		// The fifo sync above stays so that the queries of the draws so far are issued.
+		static u32 s_last_complete_results[PQ_NUM_MEMBERS];
+		if (g_perf_query->IsFlushed())
+		{
+			s_last_complete_results[type] = g_perf_query->GetQueryResult(type);
+		}
+		else
+		{
+			AsyncRequests::Event e;
+			e.time = 0;
+			e.type = AsyncRequests::Event::PERF_QUERY_POLL;
+			AsyncRequests::GetInstance()->PushEvent(e, false);
+		}
+		return s_last_complete_results[type];
+	}
+
 	AsyncRequests::Event e;
 	e.time = 0;
 	e.type = AsyncRequests::Event::PERF_QUERY;
@@ -176,6 +265,14 @@ u16 VideoBackendBase::Video_GetBoundingBox(int index)
 	if (g_ActiveConfig.iBBoxMode == BBoxNone)
 		return BoundingBox::coords[index];
 
+	// Previous frame's result, no CPU/GPU sync. The first read still syncs below.
+	u16 stable_value;
+	if (g_ActiveConfig.iBBoxMode == BBoxGPU && g_ActiveConfig.bBBoxAsyncReadback &&
+		g_ActiveConfig.backend_info.bSupportsBBox && BoundingBox::GetStableCoord(index, &stable_value))
+	{
+		return stable_value;
+	}
+
 	Fifo::SyncGPU(Fifo::SyncGPUReason::BBox);
 
 	AsyncRequests::Event e;
@@ -197,6 +294,8 @@ void VideoBackendBase::InitializeShared()
 	m_invalid = false;
 	memset(m_EFB_PCache, 0, m_EFB_PCache_Size * sizeof(EFBPeekCacheElement));
 	s_EFB_PCache_Frame = 1;
+	for (auto& generation : m_EFB_PeekTileGeneration)
+		std::fill(generation.begin(), generation.end(), 0);
 	frameCount = 0;
 	// Do our OSD callbacks
 	OSD::DoCallbacks(OSD::CallbackType::Initialization);
@@ -212,6 +311,7 @@ void VideoBackendBase::InitializeShared()
 	CommandProcessor::Init();
 	Fifo::Init();
 	OpcodeDecoder::Init();
+	DLCache::Init();
 	PixelEngine::Init();
 	BPInit();
 	VertexLoaderManager::Init();
@@ -225,6 +325,7 @@ void VideoBackendBase::InitializeShared()
 		VertexShaderManager::DisableDirtyRegions();
 	}
 	TessellationShaderManager::Init();
+	UberShaderManager::Init();
 
 	// Notify the core that the video backend is ready
 	Host_Message(WM_USER_CREATE);
@@ -240,10 +341,12 @@ void VideoBackendBase::ShutdownShared()
 	Fifo::Shutdown();
 	GeometryShaderManager::Shutdown();
 	TessellationShaderManager::Shutdown();
+	UberShaderManager::Shutdown();
 }
 
 void VideoBackendBase::CleanupShared()
 {
+	DLCache::Shutdown();
 	VertexLoaderManager::Shutdown();
 }
 
@@ -259,6 +362,7 @@ void VideoBackendBase::DoState(PointerWrap& p)
 		p.SetMode(PointerWrap::MODE_VERIFY);
 	}
 
+	// Deferred EFB copies were written to RAM by Fifo::PauseAndLock, before Memory saves it
 	VideoCommon_DoState(p);
 	p.DoMarker("VideoCommon");
 
@@ -269,6 +373,7 @@ void VideoBackendBase::DoState(PointerWrap& p)
 	if (p.GetMode() == PointerWrap::MODE_READ)
 	{
 		m_invalid = true;
+		InvalidateEFBPeekTiles();
 		// Clear all caches that touch RAM
 		// (? these don't appear to touch any emulation state that gets saved. moved to on load only.)
 		VertexLoaderManager::MarkAllDirty();
@@ -283,5 +388,6 @@ void VideoBackendBase::CheckInvalidState()
 
 		BPReload();
 		g_texture_cache->Invalidate();
+		DLCache::Clear();
 	}
 }
\ No newline at end of file
@@ -21,8 +21,10 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DLCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -44,14 +46,19 @@ __forceinline void ReadU32xn(u32 *bufx16)
 __forceinline u32 InterpretDisplayList(u32 address, u32 size)
 {
 	u8* startAddress;
+	u32 cycles = 0;
+
+	if (HandleDisplayList(address, size, &cycles))
+	{
+		INCSTAT(stats.thisFrame.numDListsCalled);
+		return cycles;
+	}
 
 	if (Fifo::UseDeterministicGPUThread())
 		startAddress = static_cast<u8*>(Fifo::PopFifoAuxBuffer(size));
 	else
 		startAddress = static_cast<u8*>(Memory::GetPointer(address));
 
-	u32 cycles = 0;
-
 	// Avoid the crash if Memory::GetPointer failed ..
 	if (startAddress != nullptr)
 	{
@@ -295,7 +302,8 @@ u8* Run(DataReader& reader, u32* cycles)
 					u32 vtx_attr_group = cmd_byte & GX_VAT_MASK;
 					parameters.vtx_attr_group = vtx_attr_group;
 					parameters.needloaderrefresh = (state.attr_dirty & (1u << vtx_attr_group)) != 0;
-					parameters.skip_draw = xfmem.viewport.wd == 0.0f
+					parameters.skip_draw = g_bSkipCurrentFrame
+						|| xfmem.viewport.wd == 0.0f
 						|| xfmem.viewport.ht == 0.0f
 						|| (bpmem.scissorBR.x + 1 - bpmem.scissorTL.x) == 0
 						|| (bpmem.scissorBR.y + 1 - bpmem.scissorTL.y) == 0;
@@ -2,29 +2,31 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+// Predictive FIFO: a look-ahead decoder that walks the pending GP FIFO ahead of the
+// real one. It only tracks the BP/CP/XF state in its own copy of the registers and
+// skips the vertex data, so whenever the state seen by a draw changes it can ask the
+// backend to prepare the shaders that draw is going to need.
+
+#include <cstring>
+#include <vector>
+
 #include "Common/Common.h"
-#include "Core/Core.h"
-#include "Core/Host.h"
 #include "Core/HW/Memmap.h"
 #include "VideoCommon/BPMemory.h"
-#include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
-#include "VideoCommon/Fifo.h"
-#include "Common/CPUDetect.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/OpcodeDecodingSC.h"
 #include "VideoCommon/VertexLoaderManager.h"
-#include "VideoCommon/VideoCommon.h"
-#include "VideoCommon/XFMemory.h"
-#include "VideoCommon/VertexLoader_Normal.h"
-#include "VideoCommon/VertexLoader_TextCoord.h"
-#include "VideoCommon/VertexLoader_Position.h"
 #include "VideoCommon/VertexManagerBase.h"
+#include "VideoCommon/XFMemory.h"
 
+static DataReader g_VideoDataSC;
+static bool shaderGenDirty = false;
 
-DataReader g_VideoDataSC;
-bool shaderGenDirty = false;
+// Pending FIFO data that has not been scanned yet.
+static std::vector<u8> s_buffer;
+static size_t s_buffer_read_pos;
 
 template <int count>
 void ReadU32xnSC(u32 *bufx16)
@@ -32,7 +34,7 @@ void ReadU32xnSC(u32 *bufx16)
 	g_VideoDataSC.ReadU32xN<count>(bufx16);
 }
 
-DataReadU32xNfunc DataReadU32xFuncsSC[16] = {
+static OpcodeDecoder::DataReadU32xNfunc DataReadU32xFuncsSC[16] = {
 	ReadU32xnSC<1>,
 	ReadU32xnSC<2>,
 	ReadU32xnSC<3>,
@@ -51,31 +53,25 @@ DataReadU32xNfunc DataReadU32xFuncsSC[16] = {
 	ReadU32xnSC<16>
 };
 
-
-extern u8* GetVideoBufferStartPtrSC();
-extern u8* GetVideoBufferEndPtrSC();
-
-static void DecodeSemiNopSC();
-
 // Bp Register
-BPMemory bpmemSC;
+static BPMemory bpmemSC;
 
 // XF Register
-XFMemory xfmemSC;
+static XFMemory xfmemSC;
 
 // CP Register
-TVtxDesc g_VtxDescSC;
-VAT g_VtxAttrSC[8];
-int s_vtxattr_dirty;
-u32 arraybasesSC[16];
-u32 arraystridesSC[16];
+static TVtxDesc g_VtxDescSC;
+static VAT g_VtxAttrSC[8];
+static int s_vtxattr_dirty;
+static u32 arraybasesSC[16];
+static u32 arraystridesSC[16];
 
-void LoadBPRegSC(u32 value0)
+static void LoadBPRegSC(u32 value0)
 {
 	//handle the mask register
 	int opcode = value0 >> 24;
 	int oldval = ((u32*)&bpmemSC)[opcode];
-	int newval = (oldval & ~bpmemSC.bpMask) | (value0 & bpmemSC.bpMask);	
+	int newval = (oldval & ~bpmemSC.bpMask) | (value0 & bpmemSC.bpMask);
 	//reset the mask register
 	if (opcode != 0xFE)
 		bpmemSC.bpMask = 0xFFFFFF;
@@ -83,15 +79,18 @@ void LoadBPRegSC(u32 value0)
 	((u32*)&bpmemSC)[opcode] = newval;
 }
 
-void LoadXFRegSC(u32 transferSize, u32 baseAddress)
+static void LoadXFRegSC(u32 transferSize, u32 baseAddress)
 {
 	// do not allow writes past registers
 	if (baseAddress + transferSize > 0x1058)
 	{
 		if (baseAddress >= 0x1058)
-			transferSize = 0;
-		else
-			transferSize = 0x1058 - baseAddress;
+		{
+			g_VideoDataSC.ReadSkip(transferSize * sizeof(u32));
+			return;
+		}
+		g_VideoDataSC.ReadSkip((baseAddress + transferSize - 0x1058) * sizeof(u32));
+		transferSize = 0x1058 - baseAddress;
 	}
 
 	// write to XF mem
@@ -124,7 +123,7 @@ void LoadXFRegSC(u32 transferSize, u32 baseAddress)
 	}
 }
 
-void LoadIndexedXFSC(u32 val, int refarray)
+static void LoadIndexedXFSC(u32 val, int refarray)
 {
 	int index = val >> 16;
 	int address = val & 0xFFF; // check mask
@@ -133,17 +132,16 @@ void LoadIndexedXFSC(u32 val, int refarray)
 
 	u32* currData = ((u32*)&xfmemSC) + address;
 	u32* newData = (u32*)Memory::GetPointer(arraybasesSC[refarray] + arraystridesSC[refarray] * index);
+	if (!newData)
+		return;
 	for (int i = 0; i < size; ++i)
 		currData[i] = Common::swap32(newData[i]);
 }
 
-void LoadCPRegSC(u32 sub_cmd, u32 value)
+static void LoadCPRegSC(u32 sub_cmd, u32 value)
 {
 	switch (sub_cmd & 0xF0)
 	{
-	case 0x30:
-	case 0x40:
-		break;
 	case 0x50:
 		g_VtxDescSC.Hex &= ~0x1FFFF;  // keep the Upper bits
 		g_VtxDescSC.Hex |= value;
@@ -157,19 +155,16 @@ void LoadCPRegSC(u32 sub_cmd, u32 value)
 		break;
 
 	case 0x70:
-		_assert_((sub_cmd & 0x0F) < 8);
 		g_VtxAttrSC[sub_cmd & 7].g0.Hex = value;
 		s_vtxattr_dirty |= 1 << (sub_cmd & 7);
 		break;
 
 	case 0x80:
-		_assert_((sub_cmd & 0x0F) < 8);
 		g_VtxAttrSC[sub_cmd & 7].g1.Hex = value;
 		s_vtxattr_dirty |= 1 << (sub_cmd & 7);
 		break;
 
 	case 0x90:
-		_assert_((sub_cmd & 0x0F) < 8);
 		g_VtxAttrSC[sub_cmd & 7].g2.Hex = value;
 		s_vtxattr_dirty |= 1 << (sub_cmd & 7);
 		break;
@@ -177,7 +172,6 @@ void LoadCPRegSC(u32 sub_cmd, u32 value)
 		// Pointers to vertex arrays in GC RAM
 	case 0xA0:
 		arraybasesSC[sub_cmd & 0xF] = value;
-		//cached_arraybasesSC[sub_cmd & 0xF] = Memory::GetPointer(value);
 		break;
 
 	case 0xB0:
@@ -188,7 +182,7 @@ void LoadCPRegSC(u32 sub_cmd, u32 value)
 
 static void InterpretDisplayList(u32 address, u32 size);
 
-template<bool sizeCheck>
+template<bool sizeCheck, bool in_display_list>
 inline bool DecodeSC(const u8* end)
 {
 	const u8 *opcodeStart = g_VideoDataSC.GetReadPosition();
@@ -202,7 +196,7 @@ inline bool DecodeSC(const u8* end)
 	{
 	case GX_NOP:
 	case GX_CMD_UNKNOWN_METRICS: // zelda 4 swords calls it and checks the metrics registers after that
-	case GX_CMD_INVL_VC: // Invalidate Vertex Cache	
+	case GX_CMD_INVL_VC: // Invalidate Vertex Cache
 		break;
 	case GX_LOAD_CP_REG: //0x08
 	{
@@ -210,7 +204,7 @@ inline bool DecodeSC(const u8* end)
 			return false;
 		u8 sub_cmd = g_VideoDataSC.Read<u8>();
 		u32 value = g_VideoDataSC.Read<u32>();
-		LoadCPRegSC(sub_cmd, value); 
+		LoadCPRegSC(sub_cmd, value);
 		shaderGenDirty = true;
 	}
 		break;
@@ -229,34 +223,14 @@ inline bool DecodeSC(const u8* end)
 	}
 		break;
 	case GX_LOAD_INDX_A: //used for position matrices
-	{	
-		if (sizeCheck && distance < GX_LOAD_INDX_A_SIZE)
-			return false;
-		LoadIndexedXFSC(g_VideoDataSC.Read<u32>(), 0xC);
-		shaderGenDirty = true;
-	}
-		break;
 	case GX_LOAD_INDX_B: //used for normal matrices
-	{
-		if (sizeCheck && distance < GX_LOAD_INDX_B_SIZE)
-			return false;
-		LoadIndexedXFSC(g_VideoDataSC.Read<u32>(), 0xD);
-		shaderGenDirty = true;
-	}
-		break;
 	case GX_LOAD_INDX_C: //used for postmatrices
-	{
-		if (sizeCheck && distance < GX_LOAD_INDX_C_SIZE)
-			return false;
-		LoadIndexedXFSC(g_VideoDataSC.Read<u32>(), 0xE);
-		shaderGenDirty = true;
-	}
-		break;
 	case GX_LOAD_INDX_D: //used for lights
 	{
-		if (sizeCheck && distance < GX_LOAD_INDX_D_SIZE)
+		if (sizeCheck && distance < GX_LOAD_INDX_SIZE)
 			return false;
-		LoadIndexedXFSC(g_VideoDataSC.Read<u32>(), 0xF);
+		// The array index is 0xC + (cmd_byte - GX_LOAD_INDX_A) / 8
+		LoadIndexedXFSC(g_VideoDataSC.Read<u32>(), 0xC + ((cmd_byte - GX_LOAD_INDX_A) >> 3));
 		shaderGenDirty = true;
 	}
 		break;
@@ -266,9 +240,11 @@ inline bool DecodeSC(const u8* end)
 			return false;
 		u32 address = g_VideoDataSC.Read<u32>();
 		u32 count = g_VideoDataSC.Read<u32>();
-		InterpretDisplayList(address, count);
+		// Display lists don't nest on real hardware either
+		if (!in_display_list)
+			InterpretDisplayList(address, count);
 	}
-		break;	
+		break;
 	case GX_LOAD_BP_REG: //0x61
 	{
 		if (sizeCheck && distance < GX_LOAD_BP_REG_SIZE)
@@ -278,7 +254,7 @@ inline bool DecodeSC(const u8* end)
 		shaderGenDirty = true;
 	}
 		break;
-		// draw primitives 
+		// draw primitives
 	default:
 		if ((cmd_byte & GX_DRAW_PRIMITIVES) == 0x80)
 		{
@@ -296,89 +272,107 @@ inline bool DecodeSC(const u8* end)
 			VertexLoaderManager::GetVertexSizeAndComponents(parameters, vertexSize, components);
 			s_vtxattr_dirty &= ~(1 << parameters.vtx_attr_group);
 			vertexSize *= numVertices;
+			if (sizeCheck && distance < vertexSize)
+				return false;
 			if (shaderGenDirty)
 			{
-				g_vertex_manager->PrepareShaders(VertexManagerBase::GetPrimitiveType((cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT),
-					components, 
-					xfmemSC, 
-					bpmemSC, 
+				g_vertex_manager->PrepareShaders(g_vertex_manager->GetPrimitiveType((cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT),
+					components,
+					xfmemSC,
+					bpmemSC,
 					false);
 				shaderGenDirty = false;
 			}
-			if (sizeCheck &&  distance < vertexSize)
-				return false;
 			g_VideoDataSC.ReadSkip(vertexSize);
 		}
 		else
 		{
-			g_VideoDataSC.SetReadPosition(end);
-			PanicAlert("Unknown Opcode on predictive fifo.");			
+			// Unknown opcode, the real decoder will report it. Everything after it
+			// is garbage as far as we are concerned.
+			g_VideoDataSC.SetReadPosition(const_cast<u8*>(end));
 		}
 		break;
 	}
 	return true;
 }
 
-
 static void InterpretDisplayList(u32 address, u32 size)
 {
-	const u8* old_pVideoData = g_VideoDataSC.GetReadPosition();
-	const u8* startAddress = Memory::GetPointer(address);
+	u8* old_pVideoData = g_VideoDataSC.GetReadPosition();
+	u8* old_end = g_VideoDataSC.GetEnd();
+	u8* startAddress = Memory::GetPointer(address);
 
 	// Avoid the crash if Memory::GetPointer failed ..
 	if (startAddress != nullptr)
 	{
-		g_VideoDataSC.SetReadPosition(startAddress);
 		const u8 *end = startAddress + size;
+		g_VideoDataSC.SetReadPosition(startAddress, const_cast<u8*>(end));
 		while (g_VideoDataSC.GetReadPosition() < end)
 		{
-			DecodeSC<false>(end);
+			DecodeSC<false, true>(end);
 		}
 	}
 	// reset to the old pointer
-	g_VideoDataSC.SetReadPosition(old_pVideoData);
+	g_VideoDataSC.SetReadPosition(old_pVideoData, old_end);
 }
 
 void OpcodeDecoderSC_Init()
 {
-	g_VideoDataSC.SetReadPosition(GetVideoBufferStartPtrSC());
-
-	//bpmem Init
-	memset(&bpmemSC, 0, sizeof(bpmemSC));
-	bpmemSC.bpMask = 0xFFFFFF;
-
-	memset(arraybasesSC, 0, sizeof(g_main_cp_state.array_bases));
-	memset(arraystridesSC, 0, sizeof(g_main_cp_state.array_strides));
-	//memset(&g_main_cp_state.matrix_index_a, 0, sizeof(g_main_cp_state.matrix_index_a));
-	//memset(&g_main_cp_state.matrix_index_b, 0, sizeof(g_main_cp_state.matrix_index_b));
-	memset(&g_VtxDescSC, 0, sizeof(g_VtxDescSC));
-	memset(g_VtxAttrSC, 0, sizeof(g_VtxAttrSC));
-	s_vtxattr_dirty = 0xFF;
-	shaderGenDirty = true;
-
-	VertexLoader_Normal::Init();
-	VertexLoader_Position::Init();
-	VertexLoader_TextCoord::Init();
+	s_buffer.clear();
+	s_buffer_read_pos = 0;
+	OpcodeDecoderSC_Reset(nullptr, nullptr);
 }
 
-
 void OpcodeDecoderSC_Shutdown()
 {
+	s_buffer.clear();
+	s_buffer.shrink_to_fit();
+	s_buffer_read_pos = 0;
+}
+
+void OpcodeDecoderSC_Reset(const u8* start, const u8* end)
+{
+	// Start over from the state the real decoder has reached.
+	// BitField deletes the copy assignment of BPMemory, so the raw registers are copied
+	memcpy(static_cast<void*>(&bpmemSC), &bpmem, sizeof(bpmemSC));
+	memcpy(&xfmemSC, &xfmem, sizeof(xfmemSC));
+	memcpy(arraybasesSC, g_main_cp_state.array_bases, sizeof(arraybasesSC));
+	memcpy(arraystridesSC, g_main_cp_state.array_strides, sizeof(arraystridesSC));
+	g_VtxDescSC = g_main_cp_state.vtx_desc;
+	memcpy(g_VtxAttrSC, g_main_cp_state.vtx_attr, sizeof(g_VtxAttrSC));
+	s_vtxattr_dirty = 0xFF;
+	shaderGenDirty = true;
 
+	s_buffer.clear();
+	s_buffer_read_pos = 0;
+	if (start != end)
+		s_buffer.insert(s_buffer.end(), start, end);
 }
 
+void OpcodeDecoderSC_Push(const u8* data, u32 size)
+{
+	// Drop what has been scanned already before the buffer grows
+	if (s_buffer_read_pos > 0 && s_buffer.size() + size > s_buffer.capacity())
+	{
+		s_buffer.erase(s_buffer.begin(), s_buffer.begin() + s_buffer_read_pos);
+		s_buffer_read_pos = 0;
+	}
+	s_buffer.insert(s_buffer.end(), data, data + size);
+}
 
-void OpcodeDecoderSC_Run(const u8* end)
+void OpcodeDecoderSC_Run()
 {
+	u8* start = s_buffer.data() + s_buffer_read_pos;
+	u8* end = s_buffer.data() + s_buffer.size();
+	g_VideoDataSC.SetReadPosition(start, end);
 	while (true)
 	{
-		const u8* old = g_VideoDataSC.GetReadPosition();
-		if (!DecodeSC<true>(end))
+		u8* old = g_VideoDataSC.GetReadPosition();
+		if (!DecodeSC<true, false>(end))
 		{
 			g_VideoDataSC.SetReadPosition(old);
 			break;
 		}
 	}
+	s_buffer_read_pos = g_VideoDataSC.GetReadPosition() - s_buffer.data();
 }
-
-
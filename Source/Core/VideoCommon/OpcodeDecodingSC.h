@@ -1,13 +1,15 @@
 // Copyright 2013 Dolphin Emulator Project
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
-#pragma once 
+#pragma once
 #include "Common/CommonTypes.h"
-#include "VideoCommon/DataReader.h"
 
 void OpcodeDecoderSC_Init();
 void OpcodeDecoderSC_Shutdown();
-void OpcodeDecoderSC_Run(const u8* end);
-void ExecuteDisplayListSC(u32 address, u32 size);
-
-extern DataReader g_VideoDataSC;
\ No newline at end of file
+// Copies the current BP/CP/XF state and starts scanning again at [start, end),
+// the data the real decoder has not consumed yet.
+void OpcodeDecoderSC_Reset(const u8* start, const u8* end);
+// Queues FIFO data that follows the previously pushed data.
+void OpcodeDecoderSC_Push(const u8* data, u32 size);
+// Scans all complete commands queued so far.
+void OpcodeDecoderSC_Run();
@@ -10,6 +10,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 
+#include <algorithm>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -60,9 +61,9 @@ sDecoderParameter g_DecodeParametersRGBA[] = {
 	/* GX_TF_RGB5A3 */ { "DecodeRGB5A3_RGBA", NULL,    2, 4, 4, 4, PC_TEX_FMT_RGBA32 },
 	/* GX_TF_RGBA8  */ { "DecodeRGBA8_RGBA",  NULL,    4, 4, 4, 4, PC_TEX_FMT_RGBA32 },
 	/* 7            */ { NULL,                NULL,    0, 0, 0, 0, PC_TEX_FMT_NONE },
-	/* GX_TF_C4     */ { NULL,                NULL,    0, 0, 0, 0, PC_TEX_FMT_NONE },
-	/* GX_TF_C8     */ { NULL,                NULL,    0, 0, 0, 0, PC_TEX_FMT_NONE },
-	/* GX_TF_C14X2  */ { NULL,                NULL,    0, 0, 0, 0, PC_TEX_FMT_NONE },
+	/* GX_TF_C4     */ { "DecodeC4_RGBA",     NULL, 0.5f, 4, 8, 8, PC_TEX_FMT_RGBA32 },
+	/* GX_TF_C8     */ { "DecodeC8_RGBA",     NULL,    1, 4, 8, 4, PC_TEX_FMT_RGBA32 },
+	/* GX_TF_C14X2  */ { "DecodeC14X2_RGBA",  NULL,    2, 4, 4, 4, PC_TEX_FMT_RGBA32 },
 	/* B            */ { NULL,                NULL,    0, 0, 0, 0, PC_TEX_FMT_NONE },
 	/* C            */ { NULL,                NULL,    0, 0, 0, 0, PC_TEX_FMT_NONE },
 	/* D            */ { NULL,                NULL,    0, 0, 0, 0, PC_TEX_FMT_NONE },
@@ -71,6 +72,7 @@ sDecoderParameter g_DecodeParametersRGBA[] = {
 
 bool g_Inited = false;
 cl_mem g_clsrc, g_cldst;                    // texture buffer memory objects
+cl_mem g_cltlut;                            // palette of the C4/C8/C14X2 formats
 
 #define HEADER_SIZE	32
 
@@ -237,6 +239,7 @@ void TexDecoder_OpenCL_Initialize()
 		g_clsrc = clCreateBuffer(OpenCL::GetContext(), CL_MEM_READ_ONLY, 1024 * 1024 * sizeof(u32), NULL, NULL);
 		g_cldst = clCreateBuffer(OpenCL::GetContext(), CL_MEM_WRITE_ONLY, 1024 * 1024 * sizeof(u32), NULL, NULL);
 #endif
+		g_cltlut = clCreateBuffer(OpenCL::GetContext(), CL_MEM_READ_ONLY, TexDecoder_GetPaletteSize(GX_TF_C14X2), NULL, NULL);
 
 		g_Inited = true;
 	}
@@ -247,13 +250,17 @@ void TexDecoder_OpenCL_Shutdown()
 	if (g_program)
 		clReleaseProgram(g_program);
 
-	for (int i = 0; i < GX_TF_CMPR; ++i)
+	g_program = NULL;
+
+	for (int i = 0; i <= GX_TF_CMPR; ++i)
 	{
 		if (g_DecodeParametersNative[i].kernel)
 			clReleaseKernel(g_DecodeParametersNative[i].kernel);
+		g_DecodeParametersNative[i].kernel = NULL;
 
 		if (g_DecodeParametersRGBA[i].kernel)
 			clReleaseKernel(g_DecodeParametersRGBA[i].kernel);
+		g_DecodeParametersRGBA[i].kernel = NULL;
 	}
 
 	if (g_clsrc)
@@ -262,6 +269,10 @@ void TexDecoder_OpenCL_Shutdown()
 	if (g_cldst)
 		clReleaseMemObject(g_cldst);
 
+	if (g_cltlut)
+		clReleaseMemObject(g_cltlut);
+	g_clsrc = g_cldst = g_cltlut = NULL;
+
 	g_Inited = false;
 }
 
@@ -277,12 +288,24 @@ PC_TexFormat TexDecoder_Decode_OpenCL(u8 *dst, const u8 *src, int width, int hei
 	g_cldst = clCreateBuffer(OpenCL::GetContext(), CL_MEM_WRITE_ONLY, 1024 * 1024 * sizeof(u32), NULL, NULL);
 #endif
 
-	clEnqueueWriteBuffer(OpenCL::GetCommandQueue(), g_clsrc, CL_TRUE, 0, (size_t)(width * height * decoder.sizeOfSrc), src, 0, NULL, NULL);
+	// The queue is in order and the blocking read at the end waits for everything, so the uploads
+	// don't need to block. src and the TMEM palette stay valid until then.
+	clEnqueueWriteBuffer(OpenCL::GetCommandQueue(), g_clsrc, CL_FALSE, 0, (size_t)(width * height * decoder.sizeOfSrc), src, 0, NULL, NULL);
 
 	clSetKernelArg(decoder.kernel, 0, sizeof(cl_mem), &g_cldst);
 	clSetKernelArg(decoder.kernel, 1, sizeof(cl_mem), &g_clsrc);
 	clSetKernelArg(decoder.kernel, 2, sizeof(cl_int), &width);
 
+	if (texformat == GX_TF_C4 || texformat == GX_TF_C8 || texformat == GX_TF_C14X2)
+	{
+		size_t palette_size = std::min<size_t>(TexDecoder_GetPaletteSize(texformat), TMEM_SIZE - tlutaddr);
+		clEnqueueWriteBuffer(OpenCL::GetCommandQueue(), g_cltlut, CL_FALSE, 0, palette_size, &texMem[tlutaddr], 0, NULL, NULL);
+
+		cl_int palette_format = tlutfmt;
+		clSetKernelArg(decoder.kernel, 3, sizeof(cl_mem), &g_cltlut);
+		clSetKernelArg(decoder.kernel, 4, sizeof(cl_int), &palette_format);
+	}
+
 	size_t global[] = { (size_t)(width / decoder.xSkip), (size_t)(height / decoder.ySkip) };
 
 	// No work-groups for now
@@ -297,8 +320,6 @@ PC_TexFormat TexDecoder_Decode_OpenCL(u8 *dst, const u8 *src, int width, int hei
 	if (err)
 		OpenCL::HandleCLError(err, "Failed to enqueue kernel");
 
-	clFinish(OpenCL::GetCommandQueue());
-
 	clEnqueueReadBuffer(OpenCL::GetCommandQueue(), g_cldst, CL_TRUE, 0, (size_t)(width * height * decoder.sizeOfDst), dst, 0, NULL, NULL);
 
 #ifdef DEBUG_OPENCL
@@ -64,6 +64,10 @@ public:
 	virtual void FlushResults()
 	{}
 
+	// Collect the results the GPU already finished, never waits
+	virtual void PollResults()
+	{}
+
 	// True if there are no further pending query results
 	// NOTE: Called from CPU thread
 	virtual bool IsFlushed() const
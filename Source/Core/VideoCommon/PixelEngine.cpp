@@ -5,7 +5,7 @@
 
 // http://www.nvidia.com/object/General_FAQ.html#t6 !!!!!
 
-#include <mutex>
+#include <atomic>
 
 #include "Common/Atomic.h"
 #include "Common/ChunkFile.h"
@@ -20,6 +20,7 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/PixelEngine.h"
+#include "VideoCommon/ShaderGenCommon.h"
 
 namespace PixelEngine
 {
@@ -104,12 +105,19 @@ static UPEAlphaModeConfReg m_AlphaModeConf;
 static UPEAlphaReadReg     m_AlphaRead;
 static UPECtrlReg          m_Control;
 
-static std::mutex s_token_finish_mutex;
 static u16 s_token;
-static u16 s_token_pending;
-static bool s_token_interrupt_pending;
-static bool s_finish_interrupt_pending;
-static bool s_event_raised;
+
+// Token and finish signals posted by the GPU and not yet seen by the CPU. The GPU thread only
+// sets bits without taking a lock, the CPU thread takes them all at once. In dual core it does
+// that at the start of every slice instead of getting a CoreTiming event per token.
+enum : u32
+{
+	MAILBOX_TOKEN_MASK = 0xFFFF,
+	MAILBOX_TOKEN = 0x10000,
+	MAILBOX_TOKEN_INTERRUPT = 0x20000,
+	MAILBOX_FINISH = 0x40000,
+};
+static std::atomic<u32> s_mailbox;
 
 static bool s_signal_token_interrupt;
 static bool s_signal_finish_interrupt;
@@ -132,10 +140,9 @@ void DoState(PointerWrap &p)
 	p.DoPOD(m_Control);
 
 	p.Do(s_token);
-	p.Do(s_token_pending);
-	p.Do(s_token_interrupt_pending);
-	p.Do(s_finish_interrupt_pending);
-	p.Do(s_event_raised);
+	u32 mailbox = s_mailbox.load();
+	p.Do(mailbox);
+	s_mailbox.store(mailbox);
 
 	p.Do(s_signal_token_interrupt);
 	p.Do(s_signal_finish_interrupt);
@@ -155,10 +162,7 @@ void Init()
 	m_AlphaRead.Hex = 0;
 
 	s_token = 0;
-	s_token_pending = 0;
-	s_token_interrupt_pending = false;
-	s_finish_interrupt_pending = false;
-	s_event_raised = false;
+	s_mailbox.store(0);
 
 	s_signal_token_interrupt = false;
 	s_signal_finish_interrupt = false;
@@ -253,6 +257,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 			MMIO::ComplexRead<u16>([i](u32)
 		{
 			BoundingBox::active = false;
+			InvalidateShaderUIDs();
 			return g_video_backend->Video_GetBoundingBox(i);
 		}),
 			MMIO::InvalidWrite<u16>()
@@ -274,44 +279,47 @@ static void UpdateInterrupts()
 // Called only if BPMEM_PE_TOKEN_INT_ID is ack by GP
 static void SetTokenFinish_OnMainThread(u64 userdata, s64 cyclesLate)
 {
-	std::unique_lock<std::mutex> lk(s_token_finish_mutex);
-	s_event_raised = false;
+	// The waiting flags are cleared before taking the mailbox, so a token posted in between
+	// leaves its flag set instead of being pending with the flag cleared.
+	u32 mailbox = s_mailbox.load(std::memory_order_relaxed);
+	if (mailbox & MAILBOX_TOKEN_INTERRUPT)
+		CommandProcessor::SetInterruptTokenWaiting(false);
+	if (mailbox & MAILBOX_FINISH)
+		CommandProcessor::SetInterruptFinishWaiting(false);
+	mailbox = s_mailbox.exchange(0, std::memory_order_acquire);
 
-	s_token = s_token_pending;
+	if (mailbox & MAILBOX_TOKEN)
+		s_token = mailbox & MAILBOX_TOKEN_MASK;
 
-	if (s_token_interrupt_pending)
+	if (mailbox & MAILBOX_TOKEN_INTERRUPT)
 	{
-		s_token_interrupt_pending = false;
 		s_signal_token_interrupt = true;
 		UpdateInterrupts();
-		CommandProcessor::SetInterruptTokenWaiting(false);
 	}
 
-	if (s_finish_interrupt_pending)
+	if (mailbox & MAILBOX_FINISH)
 	{
-		s_finish_interrupt_pending = false;
 		s_signal_finish_interrupt = true;
 		UpdateInterrupts();
-		CommandProcessor::SetInterruptFinishWaiting(false);
-		lk.unlock();
 		Core::FrameUpdateOnCPUThread();
 	}
 }
 
-// Raise the event handler above on the CPU thread.
-// s_token_finish_mutex must be locked.
+void DeliverPendingInterrupts()
+{
+	if (s_mailbox.load(std::memory_order_relaxed))
+		SetTokenFinish_OnMainThread(0, 0);
+}
+
+// Raise the event handler above on the CPU thread when the GPU runs on it as well.
+// In dual core the CPU thread picks the mailbox up by itself in DeliverPendingInterrupts.
 // THIS IS EXECUTED FROM VIDEO THREAD
 static inline void RaiseEvent()
 {
-  if (s_event_raised)
-    return;
+	if (SConfig::GetInstance().bCPUThread && !Fifo::UseDeterministicGPUThread())
+		return;
 
-  s_event_raised = true;
-
-  CoreTiming::FromThread from = CoreTiming::FromThread::NON_CPU;
-  if (!SConfig::GetInstance().bCPUThread || Fifo::UseDeterministicGPUThread())
-    from = CoreTiming::FromThread::CPU;
-  CoreTiming::ScheduleEvent(0, et_SetTokenFinishOnMainThread, 0, from);
+	CoreTiming::ScheduleEvent(0, et_SetTokenFinishOnMainThread, 0, CoreTiming::FromThread::CPU);
 }
 
 // SetToken
@@ -319,21 +327,27 @@ static inline void RaiseEvent()
 void SetToken(const u16 token, const bool interrupt)
 {
 	DEBUG_LOG(PIXELENGINE, "VIDEO Backend raises INT_CAUSE_PE_TOKEN (btw, token: %04x)", token);
-	std::lock_guard<std::mutex> lk(s_token_finish_mutex);
-	s_token_pending = token;
-	s_token_interrupt_pending |= interrupt;
 	CommandProcessor::SetInterruptTokenWaiting(true);
-	RaiseEvent();
+
+	const u32 flags = MAILBOX_TOKEN | (interrupt ? MAILBOX_TOKEN_INTERRUPT : 0) | token;
+	u32 mailbox = s_mailbox.load(std::memory_order_relaxed);
+	while (!s_mailbox.compare_exchange_weak(mailbox, (mailbox & ~MAILBOX_TOKEN_MASK) | flags,
+		std::memory_order_release, std::memory_order_relaxed))
+	{
+	}
+
+	// Only the first signal since the CPU emptied the mailbox needs to raise the event
+	if (!mailbox)
+		RaiseEvent();
 }
 
 // SetFinish
 // THIS IS EXECUTED FROM VIDEO THREAD (BPStructs.cpp) when a new frame has been drawn
 void SetFinish()
 {
-	std::lock_guard<std::mutex> lk(s_token_finish_mutex);
 	CommandProcessor::SetInterruptFinishWaiting(true);
-	s_finish_interrupt_pending |= true;
-	RaiseEvent();
+	if (!s_mailbox.fetch_or(MAILBOX_FINISH, std::memory_order_release))
+		RaiseEvent();
 }
 
 UPEAlphaReadReg GetAlphaReadMode()
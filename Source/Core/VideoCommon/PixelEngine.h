@@ -64,6 +64,8 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base);
 // gfx backend support
 void SetToken(const u16 token, const bool interrupt);
 void SetFinish(void);
+// Takes the token and finish signals posted by the GPU thread, called by the CPU thread
+void DeliverPendingInterrupts();
 UPEAlphaReadReg GetAlphaReadMode();
 
 } // end of namespace PixelEngine
\ No newline at end of file
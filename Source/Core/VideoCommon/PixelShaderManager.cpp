@@ -70,6 +70,7 @@ void PixelShaderManager::Dirty()
 	s_materials_changed = 15;
 	sbflagschanged = true;
 	s_EfbScaleChanged = true;
+	m_buffer.SetAllDirty();
 }
 
 const float* PixelShaderManager::GetBuffer()
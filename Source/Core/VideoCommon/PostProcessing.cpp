@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 
+#include <algorithm>
 #include <cmath>
 #include <string>
 
@@ -986,11 +987,9 @@ PostProcessingShader::~PostProcessingShader()
 				delete input.texture;
 			}
 		}
-		if (pass.output_texture)
-		{
-			delete pass.output_texture;
-		}
 	}
+	for (TextureCacheBase::TCacheEntryBase* texture : m_pass_textures)
+		delete texture;
 }
 
 TextureCacheBase::TCacheEntryBase* PostProcessingShader::GetLastPassOutputTexture() const
@@ -1107,6 +1106,7 @@ void PostProcessingShader::LinkPassOutputs()
 		for (size_t input_index = 0; input_index < pass_config.inputs.size(); input_index++)
 		{
 			InputBinding& input_binding = pass.inputs[input_index];
+			input_binding.prev_pass_index = -1;
 			switch (input_binding.type)
 			{
 			case POST_PROCESSING_INPUT_TYPE_PASS_FRAME_OUTPUT:
@@ -1128,12 +1128,11 @@ void PostProcessingShader::LinkPassOutputs()
 				}
 				if (pass_output_index < 0)
 				{
-					input_binding.prev_texture = nullptr;
 					m_last_pass_uses_color_buffer = true;
 				}
 				else
 				{
-					input_binding.prev_texture = m_passes[pass_output_index].output_texture;
+					input_binding.prev_pass_index = pass_output_index;
 					input_binding.size = m_passes[pass_output_index].output_size;
 				}
 			}
@@ -1147,6 +1146,85 @@ void PostProcessingShader::LinkPassOutputs()
 			}
 		}
 	}
+
+	AssignPassOutputTextures();
+	for (RenderPassData& pass : m_passes)
+	{
+		for (InputBinding& input_binding : pass.inputs)
+		{
+			input_binding.prev_texture = input_binding.prev_pass_index >= 0 ?
+				m_passes[input_binding.prev_pass_index].output_texture : nullptr;
+		}
+	}
+}
+
+void PostProcessingShader::AssignPassOutputTextures()
+{
+	// The last pass reading each output, the final output has to survive all passes.
+	std::vector<size_t> last_reader(m_passes.size(), 0);
+	for (size_t pass_index = 0; pass_index < m_passes.size(); pass_index++)
+	{
+		RenderPassData& pass = m_passes[pass_index];
+		pass.output_texture = nullptr;
+		if (!pass.enabled)
+			continue;
+		last_reader[pass_index] = pass_index;
+		for (const InputBinding& input_binding : pass.inputs)
+		{
+			if (input_binding.prev_pass_index >= 0)
+				last_reader[input_binding.prev_pass_index] = pass_index;
+		}
+	}
+	if (!m_passes.empty())
+		last_reader[m_last_pass_index] = m_passes.size();
+
+	std::vector<TextureCacheBase::TCacheEntryBase*> free_textures;
+	free_textures.swap(m_pass_textures);
+	std::vector<size_t> texture_owner;
+	TextureCacheBase::TCacheEntryConfig config;
+	config.rendertarget = true;
+	config.layers = m_internal_layers;
+	for (size_t pass_index = 0; pass_index < m_passes.size(); pass_index++)
+	{
+		RenderPassData& pass = m_passes[pass_index];
+		if (!pass.enabled)
+			continue;
+
+		// Outputs nothing reads from here on can be written again.
+		for (size_t i = 0; i < m_pass_textures.size(); i++)
+		{
+			if (last_reader[texture_owner[i]] < pass_index)
+			{
+				free_textures.push_back(m_pass_textures[i]);
+				m_pass_textures.erase(m_pass_textures.begin() + i);
+				texture_owner.erase(texture_owner.begin() + i);
+				i--;
+			}
+		}
+
+		config.width = pass.output_size.width;
+		config.height = pass.output_size.height;
+		// Last pass output is always RGBA32
+		config.pcformat = pass_index < m_passes.size() - 1 ? pass.output_format : PC_TexFormat::PC_TEX_FMT_RGBA32;
+		auto iter = std::find_if(free_textures.begin(), free_textures.end(),
+			[&config](const TextureCacheBase::TCacheEntryBase* texture) {
+			return texture->config == config;
+		});
+		if (iter != free_textures.end())
+		{
+			pass.output_texture = *iter;
+			free_textures.erase(iter);
+		}
+		else
+		{
+			pass.output_texture = g_texture_cache->AllocateTexture(config);
+		}
+		m_pass_textures.push_back(pass.output_texture);
+		texture_owner.push_back(pass_index);
+	}
+
+	for (TextureCacheBase::TCacheEntryBase* texture : free_textures)
+		g_texture_cache->DisposeTexture(texture);
 }
 
 bool PostProcessingShader::ResizeOutputTextures(const TargetSize& new_size)
@@ -1178,24 +1256,16 @@ bool PostProcessingShader::ResizeOutputTextures(const TargetSize& new_size)
 		if (i < static_cast<size_t>(frameoutput.depth_count))
 			m_prev_frame_texture[i].depth_frame = g_texture_cache->AllocateTexture(config);
 	}
-	config.pcformat = PC_TexFormat::PC_TEX_FMT_RGBA32;
+	// The pass outputs are allocated when the passes are linked
+	for (TextureCacheBase::TCacheEntryBase* texture : m_pass_textures)
+		g_texture_cache->DisposeTexture(texture);
+	m_pass_textures.clear();
 	for (size_t pass_index = 0; pass_index < m_passes.size(); pass_index++)
 	{
 		RenderPassData& pass = m_passes[pass_index];
 		const PostProcessingShaderConfiguration::RenderPass& pass_config = m_config->GetPass(pass_index);
 		pass.output_size = PostProcessor::ScaleTargetSize(new_size, pass_config.output_scale);
-
-		if (pass.output_texture != nullptr)
-		{
-			g_texture_cache->DisposeTexture(pass.output_texture);
-			pass.output_texture = nullptr;
-		}
-
-		config.width = pass.output_size.width;
-		config.height = pass.output_size.height;
-		// Last pass output is always RGBA32
-		config.pcformat = pass_index < m_passes.size() - 1 ? pass.output_format : PC_TexFormat::PC_TEX_FMT_RGBA32;
-		pass.output_texture = g_texture_cache->AllocateTexture(config);
+		pass.output_texture = nullptr;
 	}
 	m_internal_size = new_size;
 	return true;
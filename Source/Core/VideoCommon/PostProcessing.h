@@ -344,6 +344,7 @@ protected:
 		u32 frame_index{};
 		TextureCacheBase::TCacheEntryBase* texture{};	// only set for external images
 		TextureCacheBase::TCacheEntryBase* prev_texture{};
+		s32 prev_pass_index = -1;	// pass whose output is bound, -1 for the color buffer
 		uintptr_t texture_sampler{};
 	};
 
@@ -356,6 +357,7 @@ protected:
 
 		std::vector<InputBinding> inputs;
 
+		// Owned by m_pass_textures, passes that are never alive at the same time share one.
 		TextureCacheBase::TCacheEntryBase* output_texture{};
 		TargetSize output_size{};
 		float output_scale{};
@@ -371,6 +373,9 @@ protected:
 	virtual bool RecompileShaders() = 0;
 	bool ResizeOutputTextures(const TargetSize& new_size);
 	void LinkPassOutputs();
+	// Gives every enabled pass an output texture, reusing the ones of passes whose output isn't
+	// read anymore.
+	void AssignPassOutputTextures();
 
 	PostProcessingShaderConfiguration* m_config;
 	uintptr_t m_uniform_buffer;
@@ -379,6 +384,7 @@ protected:
 	int m_internal_layers = 0;
 
 	std::vector<RenderPassData> m_passes;
+	std::vector<TextureCacheBase::TCacheEntryBase*> m_pass_textures;
 	size_t m_last_pass_index = 0;
 	bool m_last_pass_uses_color_buffer = false;
 	bool m_ready = false;
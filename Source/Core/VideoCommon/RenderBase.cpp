@@ -12,12 +12,16 @@
 // Next frame, that one is scanned out and the other one gets the copy. = double buffering.
 // ---------------------------------------------------------------------------------------------
 
+#include <algorithm>
 #include <cinttypes>
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <string>
 
+#include "AudioCommon/AudioCommon.h"
+
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
@@ -36,16 +40,21 @@
 #include "Core/Host.h"
 #include "Core/Movie.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
+#include "Core/HW/SystemTimers.h"
 #include "Core/HW/VideoInterface.h"
 
 #include "InputCommon/GCAdapter.h"
 
 #include "VideoCommon/AVIDump.h"
+#include "VideoCommon/BoundingBox.h"
+#include "VideoCommon/BenchmarkLog.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/DLCache.h"
 #include "VideoCommon/FPSCounter.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/ImageWrite.h"
@@ -63,6 +72,7 @@
 // TODO: Move these out of here.
 int frameCount;
 int OSDChoice;
+bool g_bSkipCurrentFrame = false;
 static int OSDTime;
 
 std::unique_ptr<Renderer> g_renderer;
@@ -95,6 +105,8 @@ Renderer::~Renderer()
 	ShutdownFrameDumping();
 	if (m_frame_dump_thread.joinable())
 		m_frame_dump_thread.join();
+	if (m_event_profiling)
+		CoreTiming::SetEventProfiling(false);
 }
 
 void Renderer::RenderToXFB(u32 xfbAddr, const EFBRectangle& sourceRc, u32 fbStride, u32 fbHeight, float Gamma)
@@ -108,7 +120,9 @@ void Renderer::RenderToXFB(u32 xfbAddr, const EFBRectangle& sourceRc, u32 fbStri
 
 	if (g_ActiveConfig.bUseXFB)
 	{
-		FramebufferManagerBase::CopyToXFB(xfbAddr, fbStride, fbHeight, sourceRc, Gamma);
+		// A skipped frame leaves the last copied one in the virtual XFB
+		if (!m_skipping_frame)
+			FramebufferManagerBase::CopyToXFB(xfbAddr, fbStride, fbHeight, sourceRc, Gamma);
 	}
 	else
 	{
@@ -117,6 +131,67 @@ void Renderer::RenderToXFB(u32 xfbAddr, const EFBRectangle& sourceRc, u32 fbStri
 		// below div two to convert from bytes to pixels - it expects width, not stride
 		Swap(xfbAddr, fbStride / 2, fbStride / 2, fbHeight, sourceRc, ticks, Gamma);
 	}
+
+	UpdateFrameSkip();
+}
+
+void Renderer::OnEFBRead()
+{
+	m_efb_read_this_frame = true;
+	// What the game reads back has to be drawn, the rest of a skipped frame is drawn as usual
+	g_bSkipCurrentFrame = false;
+}
+
+// Frames are only skipped after a frame that read nothing back from the EFB, games rendering to
+// textures or peeking at the EFB need everything drawn
+void Renderer::UpdateFrameSkip()
+{
+	static const u32 MAX_CONSECUTIVE_SKIPPED_FRAMES = 3;
+
+	const u64 ticks = CoreTiming::GetTicks();
+	const u64 host_us = Common::Timer::GetTimeUs();
+	const bool efb_read = m_efb_read_this_frame;
+	if (m_skipping_frame)
+		stats.numFramesSkipped++;
+	m_efb_read_this_frame = false;
+	m_skipping_frame = false;
+	g_bSkipCurrentFrame = false;
+
+	const int max_lag_frames = g_ActiveConfig.iAdaptiveFrameSkip;
+	const u64 last_ticks = m_frame_skip_last_ticks;
+	const u64 last_host_us = m_frame_skip_last_host_us;
+	m_frame_skip_last_ticks = ticks;
+	m_frame_skip_last_host_us = host_us;
+	// Real XFB frames are scanned out from RAM, skipping their copy would show stale data
+	if (max_lag_frames <= 0 || (g_ActiveConfig.bUseXFB && g_ActiveConfig.bUseRealXFB) ||
+		last_ticks == 0 || ticks <= last_ticks)
+	{
+		m_frame_skip_lag_ms = 0.0;
+		m_consecutive_skipped_frames = 0;
+		return;
+	}
+
+	// Host time spent beyond the emulated length of each frame adds up, running faster pays it back
+	const double emulated_ms = (ticks - last_ticks) * 1000.0 / SystemTimers::GetTicksPerSecond();
+	const double host_ms = (host_us - last_host_us) / 1000.0;
+	const double max_lag_ms = max_lag_frames * emulated_ms;
+	// A pause or a loading hitch restarts the measurement instead of causing a burst of skips
+	if (host_ms - emulated_ms > 2.0 * max_lag_ms)
+		m_frame_skip_lag_ms = 0.0;
+	else
+		m_frame_skip_lag_ms = std::max(m_frame_skip_lag_ms + host_ms - emulated_ms, 0.0);
+
+	if (!efb_read && m_frame_skip_lag_ms > max_lag_ms &&
+		m_consecutive_skipped_frames < MAX_CONSECUTIVE_SKIPPED_FRAMES)
+	{
+		m_skipping_frame = true;
+		g_bSkipCurrentFrame = true;
+		m_consecutive_skipped_frames++;
+	}
+	else
+	{
+		m_consecutive_skipped_frames = 0;
+	}
 }
 
 int Renderer::EFBToScaledX(int x)
@@ -305,6 +380,10 @@ void Renderer::SaveScreenshot(const std::string& filename, bool wait_for_complet
 }
 
 
+// Refresh rate of the statistics part of the overlay, fast enough to follow the values while
+// keeping the string formatting out of most frames
+static const u32 OVERLAY_STATS_INTERVAL_MS = 250;
+
 // Create On-Screen-Messages
 void Renderer::DrawDebugText()
 {
@@ -438,13 +517,35 @@ void Renderer::DrawDebugText()
 		}
 	}
 
-	final_cyan += Common::Profiler::ToString();
+	const u32 now = Common::Timer::GetTimeMs();
+	if (now - m_overlay_stats_time >= OVERLAY_STATS_INTERVAL_MS)
+	{
+		m_overlay_stats_time = now;
+		m_overlay_stats_text = Common::Profiler::ToString();
+
+		if (g_ActiveConfig.bOverlayStats != m_event_profiling)
+		{
+			m_event_profiling = g_ActiveConfig.bOverlayStats;
+			CoreTiming::SetEventProfiling(m_event_profiling);
+		}
 
-	if (g_ActiveConfig.bOverlayStats)
-		final_cyan += Statistics::ToString();
+		if (g_ActiveConfig.bOverlayStats)
+		{
+			m_overlay_stats_text += Statistics::ToString();
+			float mixer_latency, output_latency;
+			if (AudioCommon::GetMeasuredLatency(&mixer_latency, &output_latency))
+				m_overlay_stats_text += StringFromFormat(
+					"Audio latency: %.1f ms (mixer %.1f, output %.1f)\n",
+					mixer_latency + output_latency, mixer_latency, output_latency);
+			m_overlay_stats_text += CoreTiming::GetEventProfileString();
+		}
 
-	if (g_ActiveConfig.bOverlayProjStats)
-		final_cyan += Statistics::ToStringProj();
+		m_overlay_stats_text += FrameProfiler::ToString();
+
+		if (g_ActiveConfig.bOverlayProjStats)
+			m_overlay_stats_text += Statistics::ToStringProj();
+	}
+	final_cyan += m_overlay_stats_text;
 
 	if(GCAdapter::AdapterError())
 		final_yellow += 
@@ -768,8 +869,32 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
 			m_aspect_wide = flush_count_anamorphic > 0.75 * flush_total;
 	}
 
+	if (m_last_swap_ticks != 0 && ticks > m_last_swap_ticks)
+	{
+		m_frame_budget_ms =
+			(ticks - m_last_swap_ticks) * 1000.0 / SystemTimers::GetTicksPerSecond();
+	}
+	m_last_swap_ticks = ticks;
+
+	// Refresh the values the CPU thread reads without syncing, only for games using the bbox.
+	if (g_ActiveConfig.iBBoxMode == BBoxGPU && g_ActiveConfig.bBBoxAsyncReadback &&
+		g_ActiveConfig.backend_info.bSupportsBBox && BoundingBox::TakeReadbackRequest())
+	{
+		u16 values[4];
+		for (int i = 0; i < 4; i++)
+			values[i] = BBoxRead(i);
+		BoundingBox::SetStableCoords(values);
+	}
+
 	// TODO: merge more generic parts into VideoCommon
-	SwapImpl(xfbAddr, fbWidth, fbStride, fbHeight, rc, ticks, Gamma);
+	// Skipped frames weren't drawn, without XFB emulation the last presented frame stays up
+	if (!m_skipping_frame || g_ActiveConfig.bUseXFB)
+	{
+		FrameProfiler::ScopedPass present_pass(FrameProfiler::PASS_PRESENT);
+		SwapImpl(xfbAddr, fbWidth, fbStride, fbHeight, rc, ticks, Gamma);
+	}
+	FrameProfiler::EndFrame();
+	BenchmarkLog::EndFrame();
 
 	if (m_xfb_written)
 		m_fps_counter.Update();
@@ -781,11 +906,84 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
 	// Set default viewport and scissor, for the clear to work correctly
 	// New frame
 	stats.ResetFrame();
+	DLCache::ProgressiveCleanup();
 
 	Core::Callback_VideoCopiedToXFB(m_xfb_written || (g_ActiveConfig.bUseXFB && g_ActiveConfig.bUseRealXFB));
 	m_xfb_written = false;
 }
 
+double Renderer::GetEFBScaleFactor(int scale)
+{
+	switch (scale)
+	{
+	case SCALE_1_5X:
+		return 1.5;
+	case SCALE_2X:
+		return 2.0;
+	case SCALE_2_5X:
+		return 2.5;
+	default:
+		return scale > SCALE_2_5X ? scale - 3 : 1.0;
+	}
+}
+
+void Renderer::OnGPUFrameTime(double milliseconds)
+{
+	// The configured scale is the upper bound, the auto modes follow the window instead.
+	const int max_scale = g_Config.iEFBScale;
+	if (!g_Config.bDynamicResolution || max_scale < SCALE_1X)
+	{
+		if (m_dynamic_efb_scale != SCALE_AUTO)
+		{
+			m_dynamic_efb_scale = SCALE_AUTO;
+			m_gpu_time_sum_ms = 0.0;
+			m_gpu_time_samples = 0;
+			SetDynamicEFBScale(SCALE_AUTO);
+		}
+		return;
+	}
+	const int min_scale = std::max(std::min(g_Config.iDynamicResolutionMinScale, max_scale),
+		static_cast<int>(SCALE_1X));
+	if (m_dynamic_efb_scale < min_scale || m_dynamic_efb_scale > max_scale)
+		m_dynamic_efb_scale = max_scale;
+
+	static const u32 SAMPLES_PER_DECISION = 30;
+	m_gpu_time_sum_ms += milliseconds;
+	if (++m_gpu_time_samples < SAMPLES_PER_DECISION)
+		return;
+	const double average_ms = m_gpu_time_sum_ms / m_gpu_time_samples;
+	m_gpu_time_sum_ms = 0.0;
+	m_gpu_time_samples = 0;
+
+	// The window right after a change includes recreating the targets, don't act on it.
+	if (m_skip_gpu_time_window || m_frame_budget_ms <= 0.0)
+	{
+		m_skip_gpu_time_window = false;
+		return;
+	}
+
+	int new_scale = m_dynamic_efb_scale;
+	if (average_ms > m_frame_budget_ms * 0.9 && new_scale > min_scale)
+	{
+		new_scale--;
+	}
+	else if (new_scale < max_scale)
+	{
+		// Cost grows with the pixel count, only go up when the next step still leaves headroom.
+		const double ratio = GetEFBScaleFactor(new_scale + 1) / GetEFBScaleFactor(new_scale);
+		if (average_ms * ratio * ratio < m_frame_budget_ms * 0.75)
+			new_scale++;
+	}
+	if (new_scale != m_dynamic_efb_scale)
+	{
+		INFO_LOG(VIDEO, "Dynamic resolution: GPU %.2fms of %.2fms, EFB scale %d -> %d", average_ms,
+			m_frame_budget_ms, m_dynamic_efb_scale, new_scale);
+		m_dynamic_efb_scale = new_scale;
+		m_skip_gpu_time_window = true;
+	}
+	SetDynamicEFBScale(m_dynamic_efb_scale);
+}
+
 bool Renderer::IsFrameDumping()
 {
 	if (m_screenshot_request.IsSet())
@@ -806,16 +1004,15 @@ void Renderer::ShutdownFrameDumping()
 		return;
 
 	FinishFrameData();
-	m_frame_dump_thread_running.Clear();
-	m_frame_dump_start.Set();
+	{
+		std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+		m_frame_dump_thread_running.Clear();
+	}
+	m_frame_dump_queued.notify_one();
 }
 
 void Renderer::DumpFrameData(const u8* data, int w, int h, int stride, const AVIDump::Frame& state, bool swap_upside_down, bool bgra)
 {
-	FinishFrameData();
-
-	m_frame_dump_config = FrameDumpConfig{ data, w, h, stride, swap_upside_down, bgra, state };
-
 	if (!m_frame_dump_thread_running.IsSet())
 	{
 		if (m_frame_dump_thread.joinable())
@@ -824,17 +1021,39 @@ void Renderer::DumpFrameData(const u8* data, int w, int h, int stride, const AVI
 		m_frame_dump_thread = std::thread(&Renderer::RunFrameDumps, this);
 	}
 
-	m_frame_dump_start.Set();
-	m_frame_dump_frame_running = true;
+	// Only wait when the encoder is a full queue behind, the copy below lets the backend reuse
+	// its readback memory right away.
+	std::vector<u8> buffer;
+	{
+		std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+		m_frame_dump_written.wait(lk, [this] { return m_frame_dump_queue.size() < MAX_QUEUED_FRAME_DUMPS; });
+		if (!m_frame_dump_free_buffers.empty())
+		{
+			buffer = std::move(m_frame_dump_free_buffers.back());
+			m_frame_dump_free_buffers.pop_back();
+		}
+	}
+
+	const size_t row_size = static_cast<size_t>(w) * 4;
+	buffer.resize(row_size * h);
+	for (int y = 0; y < h; y++)
+		memcpy(&buffer[y * row_size], data + static_cast<ptrdiff_t>(y) * stride, row_size);
+
+	{
+		std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+		FrameDumpConfig config{ nullptr, w, h, static_cast<int>(row_size), swap_upside_down, bgra, state };
+		m_frame_dump_queue.push_back({ std::move(buffer), config });
+	}
+	m_frame_dump_queued.notify_one();
 }
 
 void Renderer::FinishFrameData()
 {
-	if (!m_frame_dump_frame_running)
+	if (!m_frame_dump_thread_running.IsSet())
 		return;
 
-	m_frame_dump_done.Wait();
-	m_frame_dump_frame_running = false;
+	std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+	m_frame_dump_written.wait(lk, [this] { return m_frame_dump_queue.empty() && !m_frame_dump_writing; });
 }
 
 void Renderer::RunFrameDumps()
@@ -855,11 +1074,22 @@ void Renderer::RunFrameDumps()
 
 	while (true)
 	{
-		m_frame_dump_start.Wait();
-		if (!m_frame_dump_thread_running.IsSet())
-			break;
+		QueuedFrameDump frame;
+		{
+			std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+			m_frame_dump_queued.wait(lk, [this] {
+				return !m_frame_dump_queue.empty() || !m_frame_dump_thread_running.IsSet();
+			});
+			if (m_frame_dump_queue.empty())
+				break;
+
+			frame = std::move(m_frame_dump_queue.front());
+			m_frame_dump_queue.pop_front();
+			m_frame_dump_writing = true;
+		}
 
-		auto config = m_frame_dump_config;
+		auto config = frame.config;
+		config.data = frame.data.data();
 
 		if (config.upside_down)
 		{
@@ -905,7 +1135,13 @@ void Renderer::RunFrameDumps()
 			}
 		}
 
-		m_frame_dump_done.Set();
+		{
+			std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+			m_frame_dump_writing = false;
+			if (m_frame_dump_free_buffers.size() < MAX_QUEUED_FRAME_DUMPS)
+				m_frame_dump_free_buffers.push_back(std::move(frame.data));
+		}
+		m_frame_dump_written.notify_all();
 	}
 
 	if (frame_dump_started)
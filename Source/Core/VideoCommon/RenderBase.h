@@ -14,6 +14,7 @@
 
 #pragma once
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -42,6 +43,8 @@ struct EfbPokeData
 
 // TODO: Move these out of here.
 extern int frameCount;
+// Set by the renderer for frames the adaptive frame skip doesn't draw
+extern bool g_bSkipCurrentFrame;
 extern int OSDChoice;
 
 // Renderer really isn't a very good name for this class - it's more like "Misc".
@@ -132,6 +135,8 @@ public:
 	virtual void ClearScreen(const EFBRectangle& rc, bool colorEnable, bool alphaEnable, bool zEnable, u32 color, u32 z) = 0;
 	virtual void ReinterpretPixelData(unsigned int convtype) = 0;
 	void RenderToXFB(u32 xfbAddr, const EFBRectangle& sourceRc, u32 fbStride, u32 fbHeight, float Gamma = 1.0f);
+	// EFB copies to RAM and EFB peeks need the real EFB contents, so frames doing them are drawn
+	void OnEFBRead();
 
 	virtual u32 AccessEFB(EFBAccessType type, u32 x, u32 y, u32 poke_data) = 0;
 	virtual void PokeEFB(EFBAccessType type, const EfbPokeData* data, size_t num_points) = 0;
@@ -153,12 +158,17 @@ public:
 protected:
 	std::tuple<int, int> CalculateTargetScale(int x, int y) const;
 	bool CalculateTargetSize(int multiplier = 1);
+	// Backends report how long the GPU spent on the last frame they presented,
+	// which drives the dynamic resolution scale when it is enabled.
+	void OnGPUFrameTime(double milliseconds);
 
 	static void CheckFifoRecording();
 	static void RecordVideoMemory();
 
 	bool IsFrameDumping();
+	// Copies the frame and queues it for the frame dumping thread, data can be released on return.
 	void DumpFrameData(const u8* data, int w, int h, int stride, const AVIDump::Frame& state, bool swap_upside_down = false, bool bgra = false);
+	// Waits until every queued frame has been written out.
 	void FinishFrameData();
 
 	Common::Flag m_screenshot_request;
@@ -190,6 +200,7 @@ protected:
 	void* m_new_surface_handle = nullptr;
 private:
 	void RunFrameDumps();
+	static double GetEFBScaleFactor(int scale);
 	void ShutdownFrameDumping();
 	PEControl::PixelFormat m_prev_efb_format = PEControl::INVALID_FMT;
 	unsigned int m_efb_scale_numeratorX = 1;
@@ -198,17 +209,37 @@ private:
 	unsigned int m_efb_scale_denominatorY = 1;
 	unsigned int m_ssaa_multiplier = 1;
 
+	// Dynamic resolution state, the budget is the emulated time between two swaps.
+	u64 m_last_swap_ticks = 0;
+	double m_frame_budget_ms = 0.0;
+	double m_gpu_time_sum_ms = 0.0;
+	u32 m_gpu_time_samples = 0;
+	bool m_skip_gpu_time_window = false;
+	int m_dynamic_efb_scale = 0;  // SCALE_AUTO while inactive
+
+	// Adaptive frame skip state, updated at every copy to the XFB
+	void UpdateFrameSkip();
+	u64 m_frame_skip_last_ticks = 0;
+	u64 m_frame_skip_last_host_us = 0;
+	double m_frame_skip_lag_ms = 0.0;
+	u32 m_consecutive_skipped_frames = 0;
+	bool m_skipping_frame = false;
+	bool m_efb_read_this_frame = false;
+
+	// The statistics overlay is re-formatted a few times per second instead of every frame
+	std::string m_overlay_stats_text;
+	u32 m_overlay_stats_time = 0;
+	// CoreTiming event profiling is held while the statistics are shown
+	bool m_event_profiling = false;
+
 	// These will be set on the first call to SetWindowSize.
 	int m_last_window_request_width = 0;
 	int m_last_window_request_height = 0;
 
 	// frame dumping
 	std::thread m_frame_dump_thread;
-	Common::Event m_frame_dump_start;
-	Common::Event m_frame_dump_done;
 	Common::Flag m_frame_dump_thread_running;
 	u32 m_frame_dump_image_counter = 0;
-	bool m_frame_dump_frame_running = false;
 
 	struct FrameDumpConfig
 	{
@@ -219,7 +250,21 @@ private:
 		bool upside_down;
 		bool bgra;
 		AVIDump::Frame state;
-	} m_frame_dump_config;
+	};
+
+	// Encoding runs behind the GPU thread by up to this many frames before it has to wait.
+	static const size_t MAX_QUEUED_FRAME_DUMPS = 3;
+	struct QueuedFrameDump
+	{
+		std::vector<u8> data;
+		FrameDumpConfig config;
+	};
+	std::deque<QueuedFrameDump> m_frame_dump_queue;
+	std::vector<std::vector<u8>> m_frame_dump_free_buffers;
+	std::mutex m_frame_dump_lock;
+	std::condition_variable m_frame_dump_queued;
+	std::condition_variable m_frame_dump_written;
+	bool m_frame_dump_writing = false;
 
 	// NOTE: The methods below are called on the framedumping thread.
 	bool StartFrameDumpToAVI(const FrameDumpConfig& config);
@@ -0,0 +1,169 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Logging/Log.h"
+
+#include "VideoCommon/ShaderCacheBundle.h"
+
+// On disk format:
+//header{
+// u32 'ISCB';
+// u32 version;
+// string fingerprint; // u32 length + chars
+// string game_id;
+// u32 file_count;
+//}
+
+//file{
+// u32 path_index;
+// string name;
+// u64 size;
+// u8[size] data;
+//}
+
+namespace ShaderCacheBundle
+{
+static constexpr u32 BUNDLE_VERSION = 1;
+
+static bool WriteString(File::IOFile& file, const std::string& str)
+{
+	const u32 length = static_cast<u32>(str.size());
+	return file.WriteArray(&length, 1) && file.WriteBytes(str.data(), length);
+}
+
+static bool ReadString(File::IOFile& file, std::string* str)
+{
+	u32 length;
+	// Names and fingerprints are short, anything else is a corrupt bundle
+	if (!file.ReadArray(&length, 1) || length > 4096)
+		return false;
+	str->resize(length);
+	return length == 0 || file.ReadBytes(&(*str)[0], length);
+}
+
+static bool IsBundlePathIndex(u32 path_index)
+{
+	return path_index == D_SHADERCACHE_IDX || path_index == D_SHADERUIDCACHE_IDX;
+}
+
+std::string GetBundlePath(const std::string& game_id, const std::string& backend)
+{
+	return StringFromFormat("%sBundles" DIR_SEP "%s.%s.bundle", File::GetUserPath(D_SHADERCACHE_IDX).c_str(),
+		game_id.c_str(), backend.c_str());
+}
+
+bool Export(const std::string& path, const std::string& game_id, const std::string& fingerprint,
+	const std::vector<BundleFile>& files)
+{
+	std::vector<const BundleFile*> present;
+	for (const BundleFile& bundle_file : files)
+	{
+		if (IsBundlePathIndex(bundle_file.path_index) &&
+			File::Exists(File::GetUserPath(bundle_file.path_index) + bundle_file.name))
+			present.push_back(&bundle_file);
+	}
+	if (present.empty())
+		return false;
+
+	File::CreateFullPath(path);
+	const std::string temp_path = path + ".tmp";
+	File::IOFile out(temp_path, "wb");
+	const u32 file_count = static_cast<u32>(present.size());
+	bool good = out.WriteBytes("ISCB", sizeof(u32)) && out.WriteArray(&BUNDLE_VERSION, 1) &&
+		WriteString(out, fingerprint) && WriteString(out, game_id) && out.WriteArray(&file_count, 1);
+
+	std::string data;
+	for (size_t i = 0; good && i < present.size(); i++)
+	{
+		const BundleFile& bundle_file = *present[i];
+		if (!File::ReadFileToString(File::GetUserPath(bundle_file.path_index) + bundle_file.name, data))
+		{
+			good = false;
+			break;
+		}
+		const u32 path_index = bundle_file.path_index;
+		const u64 size = data.size();
+		good = out.WriteArray(&path_index, 1) && WriteString(out, bundle_file.name) &&
+			out.WriteArray(&size, 1) && out.WriteBytes(data.data(), data.size());
+	}
+	out.Close();
+
+	if (good && File::RenameSync(temp_path, path))
+	{
+		NOTICE_LOG(VIDEO, "Exported %u shader cache files for %s to %s", file_count, game_id.c_str(), path.c_str());
+		return true;
+	}
+	ERROR_LOG(VIDEO, "Failed to export shader cache bundle %s", path.c_str());
+	File::Delete(temp_path);
+	return false;
+}
+
+bool Import(const std::string& path, const std::string& game_id, const std::string& fingerprint)
+{
+	File::IOFile in(path, "rb");
+	if (!in.IsOpen())
+		return false;
+
+	char magic[sizeof(u32)];
+	u32 version;
+	std::string bundle_fingerprint;
+	std::string bundle_game_id;
+	u32 file_count;
+	if (!in.ReadBytes(magic, sizeof(magic)) || std::memcmp(magic, "ISCB", sizeof(magic)) != 0 ||
+		!in.ReadArray(&version, 1) || version != BUNDLE_VERSION ||
+		!ReadString(in, &bundle_fingerprint) || !ReadString(in, &bundle_game_id) ||
+		!in.ReadArray(&file_count, 1))
+	{
+		ERROR_LOG(VIDEO, "Invalid shader cache bundle %s", path.c_str());
+		return false;
+	}
+	if (bundle_game_id != game_id)
+		return false;
+	// Program binaries are only valid for the driver that built them
+	if (bundle_fingerprint != fingerprint)
+	{
+		WARN_LOG(VIDEO, "Shader cache bundle %s was made for \"%s\", not \"%s\"", path.c_str(),
+			bundle_fingerprint.c_str(), fingerprint.c_str());
+		return false;
+	}
+
+	const u64 bundle_size = in.GetSize();
+	u32 imported = 0;
+	std::string name;
+	std::string data;
+	for (u32 i = 0; i < file_count; i++)
+	{
+		u32 path_index;
+		u64 size;
+		if (!in.ReadArray(&path_index, 1) || !ReadString(in, &name) || !in.ReadArray(&size, 1) ||
+			size > bundle_size || !IsBundlePathIndex(path_index) ||
+			name.find_first_of("/\\") != std::string::npos || name.find("..") != std::string::npos)
+		{
+			ERROR_LOG(VIDEO, "Corrupt shader cache bundle %s", path.c_str());
+			return false;
+		}
+		data.resize(static_cast<size_t>(size));
+		if (size > 0 && !in.ReadBytes(&data[0], data.size()))
+			return false;
+
+		const std::string& directory = File::GetUserPath(path_index);
+		const std::string filename = directory + name;
+		if (File::Exists(filename))
+			continue;
+		if (!File::Exists(directory))
+			File::CreateDir(directory);
+		if (File::WriteStringToFile(data, filename))
+			imported++;
+	}
+
+	NOTICE_LOG(VIDEO, "Imported %u shader cache files for %s from %s", imported, game_id.c_str(), path.c_str());
+	return true;
+}
+}
@@ -0,0 +1,30 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// A game's shader usage profile and disk caches packed into one file, so machines with the same
+// GPU and driver can be handed a warm cache instead of compiling everything themselves.
+// Bundles live in the Bundles folder of the shader cache directory as <game id>.<backend>.bundle
+namespace ShaderCacheBundle
+{
+struct BundleFile
+{
+	unsigned int path_index; // D_SHADERCACHE_IDX or D_SHADERUIDCACHE_IDX
+	std::string name;
+};
+
+std::string GetBundlePath(const std::string& game_id, const std::string& backend);
+
+// Packs the files that exist into path, tagged with the driver fingerprint.
+bool Export(const std::string& path, const std::string& game_id, const std::string& fingerprint,
+	const std::vector<BundleFile>& files);
+
+// Unpacks a bundle made for game_id on a driver with the same fingerprint.
+// Files that already exist locally are kept.
+bool Import(const std::string& path, const std::string& game_id, const std::string& fingerprint);
+}
@@ -0,0 +1,20 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <vector>
+
+#include "VideoCommon/ShaderGenCommon.h"
+
+std::atomic<u64> g_shader_state_generation{1};
+
+char* GetShaderCodeBuffer(ShaderCodeBuffer stage, size_t size)
+{
+	static thread_local std::array<std::vector<char>, static_cast<size_t>(ShaderCodeBuffer::Count)> s_buffers;
+	std::vector<char>& buffer = s_buffers[static_cast<size_t>(stage)];
+	// Only ever grows, the generators' buffer sizes are fixed anyway
+	if (buffer.size() < size)
+		buffer.resize(size);
+	return buffer.data();
+}
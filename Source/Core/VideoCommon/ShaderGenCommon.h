@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdarg>
 #include <cstring>
 #include <fstream>
@@ -99,6 +100,59 @@ private:
 	std::size_t HASH;
 };
 
+// Bumped by every BP register, XF register and config change that can affect the shader UIDs,
+// UIDs built from the current state can be reused while it stays the same.
+extern std::atomic<u64> g_shader_state_generation;
+
+inline void InvalidateShaderUIDs()
+{
+	g_shader_state_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Remembers the state the current UIDs of a render mode were built from.
+struct ShaderUIDStateTag
+{
+	u64 generation = 0;
+	u32 components = 0;
+	u32 primitive_type = 0;
+	u32 render_mode = 0;
+
+	bool Matches(u32 new_components, u32 new_primitive_type, u32 new_render_mode = 0) const
+	{
+		return generation == g_shader_state_generation.load(std::memory_order_relaxed) &&
+			components == new_components && primitive_type == new_primitive_type &&
+			render_mode == new_render_mode;
+	}
+
+	void Set(u32 new_components, u32 new_primitive_type, u32 new_render_mode = 0)
+	{
+		generation = g_shader_state_generation.load(std::memory_order_relaxed);
+		components = new_components;
+		primitive_type = new_primitive_type;
+		render_mode = new_render_mode;
+	}
+
+	void Invalidate()
+	{
+		generation = 0;
+	}
+};
+
+enum class ShaderCodeBuffer
+{
+	Vertex,
+	Pixel,
+	Geometry,
+	Tessellation,
+	Count
+};
+
+// Scratch buffer of at least size bytes owned by the calling thread, so compile workers neither
+// share the generators' static buffers nor allocate one per shader. There is one per stage so the
+// sources of a whole program can be generated together. Valid until the next call for the same
+// stage on this thread.
+char* GetShaderCodeBuffer(ShaderCodeBuffer stage, size_t size);
+
 class ShaderCode
 {
 public:
@@ -7,6 +7,8 @@
 #include <utility>
 
 #include "Common/StringUtil.h"
+#include "VideoCommon/DLCache.h"
+#include "VideoCommon/HiresTextures.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoConfig.h"
@@ -44,6 +46,20 @@ std::string Statistics::ToString()
 	}
 	str += StringFromFormat("Textures created: %i\n", stats.numTexturesCreated);
 	str += StringFromFormat("Textures alive: %i\n", stats.numTexturesAlive);
+	str += StringFromFormat("Textures resident: %i kB\n", stats.textureResidentBytes / 1024);
+	str += StringFromFormat("Texture pool: %i kB\n", stats.texturePoolBytes / 1024);
+	str += StringFromFormat("Texture pool hits: %i\n", stats.thisFrame.numTexturePoolHits);
+	str += StringFromFormat("Texture pool misses: %i\n", stats.thisFrame.numTexturePoolMisses);
+	if (g_ActiveConfig.bHiresTextures)
+	{
+		str += StringFromFormat("Custom textures: %zu MB (peak %zu MB, limit %zu MB)\n",
+			HiresTexture::GetCacheMemoryUsage() >> 20, HiresTexture::GetCacheMemoryPeak() >> 20,
+			HiresTexture::GetCacheMemoryLimit() >> 20);
+	}
+	if (g_ActiveConfig.bDisplayListCache)
+		str += StringFromFormat("Display list cache: %zu kB\n", DLCache::GetMemoryUsage() >> 10);
+	if (g_ActiveConfig.iAdaptiveFrameSkip > 0)
+		str += StringFromFormat("Frames skipped: %i\n", stats.numFramesSkipped);
 	str += StringFromFormat("pshaders created: %i\n", stats.numPixelShadersCreated);
 	str += StringFromFormat("pshaders alive: %i\n", stats.numPixelShadersAlive);
 	str += StringFromFormat("vshaders created: %i\n", stats.numVertexShadersCreated);
@@ -58,8 +74,12 @@ std::string Statistics::ToString()
 	str += StringFromFormat("dlists called: %i\n", stats.thisFrame.numDListsCalled);
 	str += StringFromFormat("Primitive joins: %i\n", stats.thisFrame.numPrimitiveJoins);
 	str += StringFromFormat("Draw calls: %i\n", stats.thisFrame.numDrawCalls);
+	if (g_ActiveConfig.backend_info.APIType == API_OPENGL)
+		str += StringFromFormat("State changes skipped: %i\n", stats.thisFrame.numSkippedStateChanges);
 	str += StringFromFormat("Primitives: %i\n", stats.thisFrame.numPrims);
 	str += StringFromFormat("Primitives (DL): %i\n", stats.thisFrame.numDLPrims);
+	if (g_ActiveConfig.TessellationEnabled())
+		str += StringFromFormat("Tessellated patches: %i\n", stats.thisFrame.numTessellatedPatches);
 	str += StringFromFormat("XF loads: %i\n", stats.thisFrame.numXFLoads);
 	str += StringFromFormat("XF loads (DL): %i\n", stats.thisFrame.numXFLoadsInDL);
 	str += StringFromFormat("CP loads: %i\n", stats.thisFrame.numCPLoads);
@@ -69,6 +89,8 @@ std::string Statistics::ToString()
 	str += StringFromFormat("Vertex streamed: %i kB\n", stats.thisFrame.bytesVertexStreamed / 1024);
 	str += StringFromFormat("Index streamed: %i kB\n", stats.thisFrame.bytesIndexStreamed / 1024);
 	str += StringFromFormat("Uniform streamed: %i kB\n", stats.thisFrame.bytesUniformStreamed / 1024);
+	str += StringFromFormat("Stream buffer stalls: %i (%i us)\n", stats.thisFrame.numStreamBufferStalls,
+		stats.thisFrame.streamBufferStallMicroseconds);
 	str += StringFromFormat("Vertex Loaders: %i\n", stats.numVertexLoaders);
 
 	std::string vertex_list;
@@ -21,8 +21,11 @@ struct Statistics
 
 	int numTexturesCreated;
 	int numTexturesAlive;
+	int textureResidentBytes;
+	int texturePoolBytes;
 
 	int numVertexLoaders;
+	int numFramesSkipped;
 
 	float proj_0, proj_1, proj_2, proj_3, proj_4, proj_5;
 	float gproj_0, gproj_1, gproj_2, gproj_3, gproj_4, gproj_5;
@@ -47,13 +50,23 @@ struct Statistics
 
 		int numPrimitiveJoins;
 		int numDrawCalls;
+		int numTessellatedPatches;
+		// Redundant API state changes the backend dropped
+		int numSkippedStateChanges;
 
 		int numDListsCalled;
 
+		int numTexturePoolHits;
+		int numTexturePoolMisses;
+
 		int bytesVertexStreamed;
 		int bytesIndexStreamed;
 		int bytesUniformStreamed;
 
+		// Times the CPU had to wait on the GPU for stream buffer space
+		int numStreamBufferStalls;
+		int streamBufferStallMicroseconds;
+
 		int numTrianglesClipped;
 		int numTrianglesIn;
 		int numTrianglesRejected;
@@ -61,7 +61,7 @@ struct HSOutput
 };
 
 [domain("tri")]
-[partitioning("fractional_even")]
+[partitioning("fractional_odd")]
 [outputtopology("triangle_cw")]
 [outputcontrolpoints(3)]
 [patchconstantfunc("TConstFunc")]
@@ -77,11 +77,13 @@ float GetScreenSize(float3 Origin, float Diameter)
     return abs(Diameter * )hlsl" I_PROJECTION R"hlsl([1].y / w);
 }
 
+// Screen space error: an edge gets one segment per 1/tessmax of the screen height it covers,
+// so small or distant edges stay at 1 and are passed through without subdivision.
 float CalcTessFactor(float3 Origin, float Diameter)
 {
 	float distance = 1.0 - saturate(length(Origin) * )hlsl" I_TESSPARAMS R"hlsl(.x);
 	distance = distance * distance;
-	return round(max(4.0,)hlsl" I_TESSPARAMS R"hlsl(.y * GetScreenSize(Origin,Diameter) * distance));
+	return round(max(1.0,)hlsl" I_TESSPARAMS R"hlsl(.y * GetScreenSize(Origin,Diameter) * distance));
 }
 ConstantOutput TConstFunc(InputPatch<VS_OUTPUT, 3> patch)
 {
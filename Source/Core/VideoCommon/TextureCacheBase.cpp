@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <string>
@@ -11,6 +12,8 @@
 #include "Common/FileUtil.h"
 #include "Common/MemoryUtil.h"
 #include "Common/StringUtil.h"
+#include "Common/ThreadPool.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/FifoPlayer/FifoPlayer.h"
@@ -20,6 +23,9 @@
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/HiresTextures.h"
+#ifdef _WIN32
+#include "VideoCommon/OpenCL/OCLTextureDecoder.h"
+#endif
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/SamplerCommon.h"
@@ -33,6 +39,44 @@
 static const u64 MAX_TEXTURE_BINARY_SIZE = 1024 * 1024 * 4; // 1024 x 1024 texel times 8 nibbles per texel
 std::unique_ptr<TextureCacheBase> g_texture_cache;
 
+// Number of finished decodes whose buffers are kept for reuse.
+static const size_t ASYNC_DECODE_POOL_SIZE = 16;
+
+struct AsyncTextureDecode
+{
+	// Copy of the texture data, the game may overwrite it while the decode runs.
+	std::vector<u8> src;
+	// Decoded levels, back to back.
+	std::vector<u8> dst;
+	std::vector<size_t> level_offsets;
+	u32 width;
+	u32 height;
+	u32 expanded_width;
+	u32 expanded_height;
+	u32 texformat;
+	u32 levels;
+	bool rgba_only;
+	bool compressed_supported;
+	std::atomic<bool> done{};
+
+	void Decode()
+	{
+		const u32 bsw = TexDecoder_GetBlockWidthInTexels(texformat);
+		const u32 bsh = TexDecoder_GetBlockHeightInTexels(texformat);
+		const u8* src_data = src.data();
+		for (u32 level = 0; level < levels; level++)
+		{
+			const u32 mip_width = Common::AlignUpSizePow2(TextureUtil::CalculateLevelSize(width, level), bsw);
+			const u32 mip_height = Common::AlignUpSizePow2(TextureUtil::CalculateLevelSize(height, level), bsh);
+			// The palette is not used, only non paletted textures are decoded here.
+			TexDecoder_Decode(dst.data() + level_offsets[level], src_data, mip_width, mip_height,
+				texformat, 0, GX_TL_IA8, rgba_only, compressed_supported);
+			src_data += TexDecoder_GetTextureSizeInBytes(mip_width, mip_height, texformat);
+		}
+		done = true;
+	}
+};
+
 TextureCacheBase::TCacheEntryBase::~TCacheEntryBase()
 {	
 }
@@ -58,7 +102,12 @@ TextureCacheBase::TextureCacheBase()
 	HiresTexture::Init();
 
 	SetHash64Function();
+#ifdef _WIN32
+	if (g_ActiveConfig.bEnableOpenCL)
+		TexDecoder_OpenCL_Initialize();
+#endif
 	texture_pool_memory_usage = 0;
+	texture_pool_pooled_bytes = 0;
 	UnbindTextures();
 	m_scaler = std::make_unique<TextureScaler>();
 }
@@ -74,11 +123,18 @@ void TextureCacheBase::Invalidate()
 	}
 	textures_by_address.clear();
 	textures_by_hash.clear();
+	m_max_entry_size = 0;
 }
 
 TextureCacheBase::~TextureCacheBase()
 {
+	// The backends flush before releasing the objects the readbacks use, anything left over
+	// can't be read back anymore.
+	m_pending_efb_copies.clear();
 	HiresTexture::Shutdown();
+#ifdef _WIN32
+	TexDecoder_OpenCL_Shutdown();
+#endif
 	UnbindTextures();
 	Invalidate();
 	for (auto& rt : texture_pool)
@@ -87,6 +143,9 @@ TextureCacheBase::~TextureCacheBase()
 	}
 	texture_pool.clear();
 	texture_pool_memory_usage = 0;
+	texture_pool_pooled_bytes = 0;
+	delete m_decode_placeholder;
+	m_decode_placeholder = nullptr;
 	if (TextureCacheBase::temp)
 	{
 		Common::FreeAlignedMemory(TextureCacheBase::temp);
@@ -97,6 +156,8 @@ TextureCacheBase::~TextureCacheBase()
 
 void TextureCacheBase::OnConfigChanged(VideoConfig& config)
 {
+	FlushEFBCopies();
+
 	if (config.bHiresTextures != backup_config.hires_textures ||
 		config.bCacheHiresTextures != backup_config.cache_hires_textures)
 	{
@@ -147,6 +208,9 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
 
 void TextureCacheBase::Cleanup(s32 _frameCount)
 {
+	// Copies are read back at least once per frame, so the game never sees one older than that.
+	FlushEFBCopies();
+
 	s32 texture_kill_threshold = TEXTURE_KILL_THRESHOLD;
 	if (texture_pool_memory_usage < (TEXTURE_POOL_MEMORY_LIMIT / 2))
 	{
@@ -168,6 +232,8 @@ void TextureCacheBase::Cleanup(s32 _frameCount)
 				// Only remove EFB copies when they wouldn't be used anymore(changed hash), because EFB copies living on the
 				// host GPU are unrecoverable. Perform this check only every TEXTURE_KILL_THRESHOLD for performance reasons
 				if ((_frameCount - iter->second->frameCount) % TEXTURE_KILL_THRESHOLD == 1 &&
+					Memory::WasWrittenSince(iter->second->addr, iter->second->size_in_bytes,
+						iter->second->write_seq) &&
 					iter->second->hash != iter->second->CalculateHash())
 				{
 					iter = InvalidateTexture(iter);
@@ -187,6 +253,17 @@ void TextureCacheBase::Cleanup(s32 _frameCount)
 			++iter;
 		}
 	}
+
+	m_max_entry_size = 0;
+	for (const auto& entry : textures_by_address)
+		m_max_entry_size = std::max(m_max_entry_size, entry.second->size_in_bytes);
+	// Keep unused textures longer while the pool is small, EFB copies and textures that come back
+	// within a second are then reused instead of being created again
+	s32 texture_pool_kill_threshold = TEXTURE_POOL_KILL_THRESHOLD;
+	if (texture_pool_pooled_bytes < (TEXTURE_POOL_MEMORY_LIMIT / 2))
+	{
+		texture_pool_kill_threshold *= TEXTURE_POOL_KILL_MULTIPLIER;
+	}
 	TexPool::iterator iter2 = texture_pool.begin();
 	TexPool::iterator tcend2 = texture_pool.end();
 	while (iter2 != tcend2)
@@ -195,9 +272,10 @@ void TextureCacheBase::Cleanup(s32 _frameCount)
 		{
 			iter2->second->frameCount = _frameCount;
 		}
-		if (_frameCount > TEXTURE_POOL_KILL_THRESHOLD + iter2->second->frameCount)
+		if (_frameCount > texture_pool_kill_threshold + iter2->second->frameCount)
 		{
 			texture_pool_memory_usage -= iter2->second->native_size_in_bytes;
+			texture_pool_pooled_bytes -= iter2->second->native_size_in_bytes;
 			delete iter2->second;
 			iter2 = texture_pool.erase(iter2);
 		}
@@ -206,6 +284,8 @@ void TextureCacheBase::Cleanup(s32 _frameCount)
 			++iter2;
 		}
 	}
+	SETSTAT(stats.textureResidentBytes, texture_pool_memory_usage);
+	SETSTAT(stats.texturePoolBytes, texture_pool_pooled_bytes);
 }
 
 bool TextureCacheBase::TCacheEntryBase::OverlapsMemoryRange(u32 range_address, u32 range_size) const
@@ -237,7 +317,7 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::ApplyPaletteToEntry(TCacheE
 		decoded_entry->frameCount = FRAMECOUNT_INVALID;
 		decoded_entry->is_efb_copy = false;
 		g_texture_cache->LoadLut(tlutfmt, &texMem[tlutaddr], palette_size);
-		auto iter = textures_by_address.emplace(entry->addr, decoded_entry);
+		auto iter = InsertTexture(entry->addr, entry->size_in_bytes, decoded_entry);
 		if (g_texture_cache->Palettize(decoded_entry, entry))
 		{
 			return decoded_entry;
@@ -247,6 +327,47 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::ApplyPaletteToEntry(TCacheE
 	return nullptr;
 }
 
+TextureCacheBase::TCacheEntryBase* TextureCacheBase::GetPaletteIndices(u32 address, const u8* src_data,
+	u32 texture_size, u32 texformat, u64 tex_hash, u32 width, u32 height, u32 expanded_width,
+	u32 expanded_height, u32 native_width, u32 native_height, u64 write_seq)
+{
+	// The palette conversion shaders read the index from the red channel of an intensity texture
+	const u32 index_format = texformat == GX_TF_C4 ? GX_TF_I4 : GX_TF_I8;
+	const u32 entry_format = index_format | TEXFMT_PALETTE_INDICES;
+	auto iter_range = textures_by_address.equal_range(address);
+	for (auto iter = iter_range.first; iter != iter_range.second; ++iter)
+	{
+		TCacheEntryBase* entry = iter->second;
+		if (entry->format == entry_format && entry->base_hash == tex_hash &&
+			entry->native_width == native_width && entry->native_height == native_height)
+		{
+			entry->frameCount = FRAMECOUNT_INVALID;
+			return entry;
+		}
+	}
+
+	TCacheEntryConfig config;
+	config.width = width;
+	config.height = height;
+	config.pcformat = PC_TEX_FMT_RGBA32;
+	TCacheEntryBase* entry = AllocateTexture(config);
+	if (!entry)
+		return nullptr;
+
+	InsertTexture(address, texture_size, entry);
+	entry->SetGeneralParameters(address, texture_size, entry_format);
+	entry->SetDimensions(native_width, native_height, 1);
+	entry->SetHashes(tex_hash, tex_hash);
+	entry->write_seq = write_seq;
+	entry->frameCount = FRAMECOUNT_INVALID;
+	entry->is_efb_copy = false;
+
+	// C4/C8 and I4/I8 share the block layout, so decoding the indices as intensities keeps them intact
+	TexDecoder_Decode(temp, src_data, expanded_width, expanded_height, index_format, 0, GX_TL_IA8, true);
+	entry->Load(temp, width, height, expanded_width, 0);
+	return entry;
+}
+
 void TextureCacheBase::ScaleTextureCacheEntryTo(TextureCacheBase::TCacheEntryBase** entry, u32 new_width, u32 new_height)
 {
 	if ((*entry)->config.width == new_width && (*entry)->config.height == new_height)
@@ -295,7 +416,7 @@ void TextureCacheBase::ScaleTextureCacheEntryTo(TextureCacheBase::TCacheEntryBas
 		InvalidateTexture(GetTexCacheIter(*entry));
 
 		*entry = newentry;
-		textures_by_address.emplace((*entry)->addr, *entry);
+		InsertTexture((*entry)->addr, (*entry)->size_in_bytes, *entry);
 	}
 	else
 	{
@@ -440,6 +561,15 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::DoPartialTextureUpdates(TCa
 
 void TextureCacheBase::DumpTexture(TCacheEntryBase* entry, std::string basename, u32 level)
 {
+	if (level > 0)
+	{
+		basename += StringFromFormat("_mip%i", level);
+	}
+	// The name holds the texture hash, so a texture that was queued once is skipped without
+	// waiting for its file to show up.
+	if (!m_dumped_textures.insert(basename).second)
+		return;
+
 	std::string szDir = File::GetUserPath(D_DUMPTEXTURES_IDX) +
 		SConfig::GetInstance().GetGameID();
 
@@ -447,10 +577,6 @@ void TextureCacheBase::DumpTexture(TCacheEntryBase* entry, std::string basename,
 	if (!File::Exists(szDir) || !File::IsDirectory(szDir))
 		File::CreateDir(szDir);
 
-	if (level > 0)
-	{
-		basename += StringFromFormat("_mip%i", level);
-	}
 	std::string filename = szDir + "/" + basename + ((entry->config.pcformat >= PC_TEX_FMT_DXT1) ? ".dds" : ".png");
 
 	if (!File::Exists(filename))
@@ -461,7 +587,7 @@ void TextureCacheBase::DumpTexture(TCacheEntryBase* entry, std::string basename,
 TextureCacheBase::TCacheEntryBase* TextureCacheBase::ReturnEntry(u32 stage, TCacheEntryBase* entry)
 {
 	entry->frameCount = FRAMECOUNT_INVALID;
-	bound_textures[stage] = entry;
+	bound_textures[stage] = entry->pending_decode ? GetDecodePlaceholder() : entry;
 	s_last_texture = std::max(s_last_texture, stage);
 	GFX_DEBUGGER_PAUSE_AT(NEXT_TEXTURE_CHANGE, true);
 	return entry;
@@ -480,8 +606,89 @@ void TextureCacheBase::UnbindTextures()
 	bound_textures.fill(nullptr);
 }
 
+void TextureCacheBase::DecodeTextureAsync(TCacheEntryBase* entry, const u8* src_data, u32 src_size,
+	u32 expanded_width, u32 expanded_height, u32 texformat, u32 levels)
+{
+	std::shared_ptr<AsyncTextureDecode> decode;
+	auto pool_iter = std::find_if(m_async_decode_pool.begin(), m_async_decode_pool.end(),
+		[](const std::shared_ptr<AsyncTextureDecode>& d) { return d.use_count() == 1 && d->done.load(); });
+	if (pool_iter != m_async_decode_pool.end())
+	{
+		decode = *pool_iter;
+		decode->done = false;
+	}
+	else
+	{
+		decode = std::make_shared<AsyncTextureDecode>();
+		if (m_async_decode_pool.size() < ASYNC_DECODE_POOL_SIZE)
+			m_async_decode_pool.push_back(decode);
+	}
+
+	decode->src.assign(src_data, src_data + src_size);
+	decode->width = entry->native_width;
+	decode->height = entry->native_height;
+	decode->expanded_width = expanded_width;
+	decode->expanded_height = expanded_height;
+	decode->texformat = texformat;
+	decode->levels = levels;
+	decode->rgba_only = entry->config.pcformat == PC_TEX_FMT_RGBA32;
+	decode->compressed_supported = entry->config.pcformat >= PC_TEX_FMT_DXT1;
+
+	// The decoders write at most four bytes per texel of the block aligned size.
+	decode->level_offsets.resize(levels);
+	size_t dst_size = 0;
+	const u32 bsw = TexDecoder_GetBlockWidthInTexels(texformat);
+	const u32 bsh = TexDecoder_GetBlockHeightInTexels(texformat);
+	for (u32 level = 0; level < levels; level++)
+	{
+		decode->level_offsets[level] = dst_size;
+		dst_size += Common::AlignUpSizePow2(TextureUtil::CalculateLevelSize(decode->width, level), bsw) *
+			Common::AlignUpSizePow2(TextureUtil::CalculateLevelSize(decode->height, level), bsh) * 4;
+	}
+	decode->dst.resize(dst_size);
+
+	entry->pending_decode = decode;
+	Common::AsyncWorker::ExecuteAsync([decode]() { decode->Decode(); });
+}
+
+bool TextureCacheBase::FinishAsyncDecode(TCacheEntryBase* entry)
+{
+	if (!entry->pending_decode)
+		return true;
+
+	const AsyncTextureDecode& decode = *entry->pending_decode;
+	if (!decode.done.load())
+		return false;
+
+	for (u32 level = 0; level < decode.levels; level++)
+	{
+		const u32 mip_width = TextureUtil::CalculateLevelSize(decode.width, level);
+		const u32 mip_height = TextureUtil::CalculateLevelSize(decode.height, level);
+		entry->Load(decode.dst.data() + decode.level_offsets[level], mip_width, mip_height,
+			Common::AlignUpSizePow2(mip_width, TexDecoder_GetBlockWidthInTexels(decode.texformat)), level);
+	}
+	entry->pending_decode.reset();
+	return true;
+}
+
+TextureCacheBase::TCacheEntryBase* TextureCacheBase::GetDecodePlaceholder()
+{
+	if (!m_decode_placeholder)
+	{
+		TCacheEntryConfig config;
+		config.width = 1;
+		config.height = 1;
+		config.pcformat = PC_TEX_FMT_RGBA32;
+		m_decode_placeholder = CreateTexture(config);
+		const u32 black = 0;
+		m_decode_placeholder->Load(reinterpret_cast<const u8*>(&black), 1, 1, 1, 0);
+	}
+	return m_decode_placeholder;
+}
+
 TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 {
+	TRACE_SCOPE("TextureCache::Load");
 	const FourTexUnits &tex = bpmem.tex[stage >> 2];
 	const u32 id = stage & 3;
 	const u32 address = (tex.texImage3[id].image_base/* & 0x1FFFFF*/) << 5;
@@ -551,13 +758,45 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 		return nullptr;
 	}
 
+	if (!from_tmem)
+		FlushEFBCopies(address, texture_size + additional_mips_size);
+
 	// If we are recording a FifoLog, keep track of what memory we read.
 	// FifiRecorder does it's own memory modification tracking independant of the texture hashing below.
 	if (g_bRecordFifoData && !from_tmem)
 		FifoRecorder::GetInstance().UseMemory(address, texture_size + additional_mips_size, MemoryUpdate::TEXTURE_MAP);
 
+	// When guest memory writes are tracked, an entry at this address whose pages weren't written
+	// since it was hashed still has the right hash, so hashing can be skipped. This also holds for
+	// EFB copies, their pages are tracked from when the copy was written, so a game sampling its
+	// own copy gets the one on the GPU without the memory being hashed again.
+	u64 write_seq = 0;
+	bool hash_is_current = false;
+	if (!from_tmem && Memory::IsWriteTrackingEnabled())
+	{
+		auto tracked_range = textures_by_address.equal_range(address);
+		for (auto tracked_iter = tracked_range.first; tracked_iter != tracked_range.second; ++tracked_iter)
+		{
+			const TCacheEntryBase* entry = tracked_iter->second;
+			// Strided EFB copies are hashed per row, this hash can't be compared to other entries
+			if (entry->IsEfbCopy() && entry->memory_stride != entry->BytesPerRow())
+				continue;
+			if (entry->write_seq != 0 && entry->size_in_bytes == texture_size &&
+				!Memory::WasWrittenSince(address, texture_size, entry->write_seq))
+			{
+				tex_hash = entry->base_hash;
+				write_seq = entry->write_seq;
+				hash_is_current = true;
+				break;
+			}
+		}
+		if (!hash_is_current)
+			write_seq = Memory::TrackWrites(address, texture_size);
+	}
+
 	// TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data from the low tmem bank than it should)	
-	tex_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+	if (!hash_is_current)
+		tex_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
 	u32 palette_size = std::min(TexDecoder_GetPaletteSize(texformat), TMEM_SIZE - tlutaddr);
 	if (isPaletteTexture)
 	{
@@ -640,7 +879,10 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 			if (entry->hash == (full_hash) && entry->format == full_format && entry->native_levels >= tex_levels &&
 				entry->native_width == nativeW && entry->native_height == nativeH)
 			{
-				entry = DoPartialTextureUpdates(iter->second, tlutaddr, tlutfmt, palette_size);
+				entry->write_seq = write_seq;
+				// EFB copies are applied on top of the decoded data, so wait for it.
+				if (FinishAsyncDecode(entry))
+					entry = DoPartialTextureUpdates(iter->second, tlutaddr, tlutfmt, palette_size);
 				return ReturnEntry(stage, entry);
 			}
 		}
@@ -686,7 +928,8 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 			if (entry->format == full_format && entry->native_levels >= tex_levels &&
 				entry->native_width == nativeW && entry->native_height == nativeH)
 			{
-				entry = DoPartialTextureUpdates(hash_iter->second, tlutaddr, tlutfmt, palette_size);
+				if (FinishAsyncDecode(entry))
+					entry = DoPartialTextureUpdates(hash_iter->second, tlutaddr, tlutfmt, palette_size);
 				return ReturnEntry(stage, entry);
 			}
 			++hash_iter;
@@ -743,16 +986,49 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 	// how many levels the allocated texture shall have
 	const u32 texLevels = hires_tex ? hires_tex->m_levels : tex_levels;
 	const bool use_scaling = (g_ActiveConfig.iTexScalingType > 0) && !hires_tex && (width < 384) && (height < 384);
+	const bool scale_on_gpu = use_scaling && g_texture_cache->SupportsGPUTextureScaling(
+		g_ActiveConfig.iTexScalingType, g_ActiveConfig.iTexScalingFactor);
 	// We can decode on the GPU if it is a supported format and the flag is enabled.
 	// Currently we don't decode RGBA8 textures from Tmem, as that would require copying from both
 	// banks, and if we're doing an copy we may as well just do the whole thing on the CPU, since
 	// there's no conversion between formats. In the future this could be extended with a separate
 	// shader, however.
+	// Scaled textures can only stay on the GPU when there is no deposterize pass, which is CPU only.
 	bool decode_on_gpu =
-		!hires_tex && !use_scaling && g_ActiveConfig.UseGPUTextureDecoding() &&
+		!hires_tex && (!use_scaling || (scale_on_gpu && !g_ActiveConfig.bTexDeposterize)) &&
+		g_ActiveConfig.UseGPUTextureDecoding() &&
 		g_texture_cache->SupportsGPUTextureDecode(static_cast<TextureFormat>(texformat),
 			static_cast<TlutFormat>(tlutfmt)) && !(from_tmem && texformat == GX_TF_RGBA8);
 
+	// Paletted textures without mipmaps keep their indices on the GPU and get the palette applied
+	// by a conversion pass, so a palette animation doesn't decode the texture again for each frame.
+	// C14X2 is decoded on the CPU, as the conversion shaders only read 8 bits of index.
+	const bool palette_on_gpu = isPaletteTexture && texformat != GX_TF_C14X2 && !hires_tex &&
+		!use_scaling && tex_levels == 1 && !g_ActiveConfig.bDumpTextures &&
+		g_ActiveConfig.backend_info.bSupportsPaletteConversion;
+	if (palette_on_gpu)
+	{
+		TCacheEntryBase* indices = GetPaletteIndices(address, src_data, texture_size, texformat,
+			tex_hash, width, height, expandedWidth, expandedHeight, nativeW, nativeH, write_seq);
+		TCacheEntryBase* decoded_entry =
+			indices ? ApplyPaletteToEntry(indices, tlutaddr, tlutfmt, palette_size) : nullptr;
+		if (decoded_entry)
+		{
+			decoded_entry->SetGeneralParameters(address, texture_size, full_format);
+			decoded_entry->SetHashes(full_hash, tex_hash);
+			decoded_entry->write_seq = write_seq;
+			if (g_ActiveConfig.iSafeTextureCache_ColorSamples == 0 ||
+				std::max(texture_size, palette_size) <= (u32)g_ActiveConfig.iSafeTextureCache_ColorSamples * 8)
+			{
+				decoded_entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, decoded_entry);
+			}
+			INCSTAT(stats.numTexturesCreated);
+			SETSTAT(stats.numTexturesAlive, textures_by_address.size());
+			decoded_entry = DoPartialTextureUpdates(decoded_entry, tlutaddr, tlutfmt, palette_size);
+			return ReturnEntry(stage, decoded_entry);
+		}
+	}
+
 	// create the entry/texture
 	TCacheEntryConfig config;
 	config.width = width;
@@ -770,7 +1046,7 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 	TCacheEntryBase* entry = AllocateTexture(config);
 	GFX_DEBUGGER_PAUSE_AT(NEXT_NEW_TEXTURE, true);
 
-	iter = textures_by_address.emplace(address, entry);
+	iter = InsertTexture(address, texture_size, entry);
 	if (g_ActiveConfig.iSafeTextureCache_ColorSamples == 0 ||
 		std::max(texture_size, palette_size) <= (u32)g_ActiveConfig.iSafeTextureCache_ColorSamples * 8)
 	{
@@ -781,13 +1057,15 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 	entry->SetDimensions(nativeW, nativeH, tex_levels);
 	entry->SetHiresParams(!!hires_tex, basename, use_scaling, !!hires_tex && hires_tex->emissive_in_color);
 	entry->SetHashes(full_hash, tex_hash);
+	entry->write_seq = write_seq;
 	entry->is_efb_copy = false;
 
 	// load texture
 	if (hires_tex)
 	{
-		entry->Load(TextureCacheBase::temp, width, height, expandedWidth, 0);
-		u8 *Bufferptr = TextureCacheBase::temp;
+		// Packed textures are uploaded straight from the mapped file
+		const u8* Bufferptr = hires_tex->m_pack_data ? hires_tex->m_pack_data : TextureCacheBase::temp;
+		entry->Load(Bufferptr, width, height, expandedWidth, 0);
 		Bufferptr += TextureUtil::GetTextureSizeInBytes(width, height, pcfmt);
 		for (u32 level = 1; level != texLevels; ++level)
 		{
@@ -826,13 +1104,25 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 				0, src_data, texture_size, static_cast<TextureFormat>(texformat), width, height,
 				expandedWidth, expandedHeight, row_stride, &texMem[tlutaddr], static_cast<TlutFormat>(tlutfmt));
 		}
-		
+
+		// Decode on the thread pool and draw with a placeholder until it is done. Paletted and TMEM
+		// textures depend on TMEM contents at the time of the draw, so they are still decoded here.
+		// The OpenCL decoder and the scaler are not thread safe.
+		const bool decode_async = !decode_on_gpu && !g_ActiveConfig.bWaitForTextureDecoding &&
+			!isPaletteTexture && !from_tmem && !use_scaling && !g_ActiveConfig.bDumpTextures &&
+			!g_ActiveConfig.bEnableOpenCL;
+		if (decode_async)
+		{
+			DecodeTextureAsync(entry, src_data, texture_size + additional_mips_size,
+				expandedWidth, expandedHeight, texformat, texLevels);
+			INCSTAT(stats.numTexturesCreated);
+			SETSTAT(stats.numTexturesAlive, textures_by_address.size());
+			return ReturnEntry(stage, entry);
+		}
+
 		if (!decode_on_gpu)
 		{
 			u8* texturedata = TextureCacheBase::temp;
-			u32 twidth = width;
-			u32 theight = height;
-			u32 texpandedWidth = expandedWidth;
 			if (texformat == GX_TF_RGBA8 && from_tmem)
 			{
 				TexDecoder_DecodeRGBA8FromTmem(reinterpret_cast<u32*>(texturedata),
@@ -847,13 +1137,9 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 					config.pcformat >= PC_TEX_FMT_DXT1);
 			}
 			if (use_scaling)
-			{
-				texturedata = reinterpret_cast<u8*>(m_scaler->Scale((u32*)texturedata, expandedWidth, height));
-				twidth *= g_ActiveConfig.iTexScalingFactor;
-				theight *= g_ActiveConfig.iTexScalingFactor;
-				texpandedWidth *= g_ActiveConfig.iTexScalingFactor;
-			}
-			entry->Load(texturedata, twidth, theight, texpandedWidth, 0);
+				LoadScaledLevel(entry, texturedata, width, height, expandedWidth, 0, scale_on_gpu);
+			else
+				entry->Load(texturedata, width, height, expandedWidth, 0);
 		}
 		if (g_ActiveConfig.bDumpTextures)
 		{
@@ -883,9 +1169,6 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 			else
 			{
 				u8* texturedata = TextureCacheBase::temp;
-				u32 twidth = mip_width;
-				u32 theight = mip_height;
-				u32 texpandedWidth = expanded_mip_width;
 				TexDecoder_Decode(texturedata, mip_src_data, expanded_mip_width,
 					expanded_mip_height, texformat, tlutaddr,
 					static_cast<TlutFormat>(tlutfmt),
@@ -893,12 +1176,13 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 					config.pcformat >= PC_TEX_FMT_DXT1);
 				if (use_scaling)
 				{
-					texturedata = reinterpret_cast<u8*>(m_scaler->Scale((u32*)texturedata, expandedWidth, height));
-					twidth *= g_ActiveConfig.iTexScalingFactor;
-					theight *= g_ActiveConfig.iTexScalingFactor;
-					texpandedWidth *= g_ActiveConfig.iTexScalingFactor;
+					LoadScaledLevel(entry, texturedata, mip_width, mip_height, expanded_mip_width, level,
+						scale_on_gpu);
+				}
+				else
+				{
+					entry->Load(texturedata, mip_width, mip_height, expanded_mip_width, level);
 				}
-				entry->Load(texturedata, twidth, theight, texpandedWidth, level);
 			}
 			mip_src_data += TexDecoder_GetTextureSizeInBytes(expanded_mip_width, expanded_mip_height, texformat);
 
@@ -913,6 +1197,21 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::Load(const u32 stage)
 	return ReturnEntry(stage, entry);
 }
 
+void TextureCacheBase::LoadScaledLevel(TCacheEntryBase* entry, u8* data, u32 width, u32 height,
+	u32 expanded_width, u32 level, bool scale_on_gpu)
+{
+	if (scale_on_gpu)
+	{
+		const u32* source = m_scaler->ApplyDePosterize(reinterpret_cast<u32*>(data), expanded_width, height);
+		if (entry->ScaleTextureOnGPU(level, reinterpret_cast<const u8*>(source), width, height, expanded_width))
+			return;
+	}
+
+	const u32 factor = g_ActiveConfig.iTexScalingFactor;
+	u8* scaled = reinterpret_cast<u8*>(m_scaler->Scale(reinterpret_cast<u32*>(data), expanded_width, height));
+	entry->Load(scaled, width * factor, height * factor, expanded_width * factor, level);
+}
+
 void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32 dstStride, bool is_depth_copy,
 	const EFBRectangle& srcRect, bool isIntensity, bool scaleByHalf)
 {
@@ -1246,19 +1545,38 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
 		c_tex_h = g_renderer->EFBToScaledY(c_tex_h);
 	}
 
+	// Get the base (in memory) format of this efb copy.
+	u32 baseFormat = TexDecoder_GetEfbCopyBaseFormat(dstFormat);
+
+	TCacheEntryConfig config;
+	config.rendertarget = true;
+	config.pcformat = PC_TEX_FMT_RGBA32;
+	config.width = scaled_tex_w;
+	config.height = scaled_tex_h;
+	config.layers = FramebufferManagerBase::GetEFBLayers();
+
 	// remove all texture cache entries at dstAddr
+	// A copy with the same size and format is rendered to again in place, chains of copies to
+	// the same buffers (bloom, blur) don't go through the pool every time.
+	TCacheEntryBase* reused_entry = nullptr;
 	{
 		auto iter_range = textures_by_address.equal_range(dstAddr);
 		TexAddrCache::iterator iter = iter_range.first;
 		while (iter != iter_range.second)
 		{
+			TCacheEntryBase* entry = iter->second;
+			if (!reused_entry && entry->IsEfbCopy() && entry->config == config &&
+				entry->format == baseFormat && entry->native_width == tex_w &&
+				entry->native_height == tex_h && entry->memory_stride == dstStride)
+			{
+				reused_entry = entry;
+				++iter;
+				continue;
+			}
 			iter = InvalidateTexture(iter);
 		}
 	}
 
-	// Get the base (in memory) format of this efb copy.
-	u32 baseFormat = TexDecoder_GetEfbCopyBaseFormat(dstFormat);
-
 	u32 blockH = TexDecoder_GetBlockHeightInTexels(baseFormat);
 	const u32 blockW = TexDecoder_GetBlockWidthInTexels(baseFormat);
 
@@ -1294,14 +1612,32 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
 			g_renderer->GetPostProcessor()->OnEFBCopy(&targetSource);
 		}
 	}
+	bool copy_deferred = false;
 	if (copy_to_ram)
 	{
 		EFBCopyFormat format(srcFormat, static_cast<TextureFormat>(dstFormat));
-		CopyEFB(dst, format, tex_w, bytes_per_row, num_blocks_y, dstStride, is_depth_copy, srcRect,
-			scaleByHalf);
+		std::unique_ptr<EFBCopyReadback> readback;
+		if (g_ActiveConfig.bDeferEFBCopies)
+		{
+			readback = QueueEFBCopy(format, tex_w, bytes_per_row, num_blocks_y, is_depth_copy,
+				srcRect, scaleByHalf);
+		}
+		if (readback)
+		{
+			m_pending_efb_copies.push_back({ dst, dstAddr, covered_range, dstStride, std::move(readback) });
+			copy_deferred = true;
+		}
+		else
+		{
+			// An older deferred copy must not land on top of this one later
+			FlushEFBCopies(dstAddr, covered_range);
+			CopyEFB(dst, format, tex_w, bytes_per_row, num_blocks_y, dstStride, is_depth_copy, srcRect,
+				scaleByHalf);
+		}
 	}
 	else
 	{
+		FlushEFBCopies(dstAddr, covered_range);
 		// Hack: Most games don't actually need the correct texture data in RAM
 		//       and we can just keep a copy in VRAM. We zero the memory so we
 		//       can check it hasn't changed before using our copy in VRAM.
@@ -1344,11 +1680,13 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
 	// TODO: This also invalidates partial overlaps, which we currently don't have a better way
 	//       of dealing with.
 	bool invalidate_textures = dstStride == bytes_per_row || !copy_to_vram;
+	if (!copy_to_vram)
+		reused_entry = nullptr;
 	auto iter = FindOverlappingTextures(dstAddr, covered_range);
 	while (iter.first != iter.second)
 	{
 		TCacheEntryBase* entry = iter.first->second;
-		if (entry->OverlapsMemoryRange(dstAddr, covered_range))
+		if (entry != reused_entry && entry->OverlapsMemoryRange(dstAddr, covered_range))
 		{
 			if (invalidate_textures)
 			{
@@ -1363,14 +1701,16 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
 	if (copy_to_vram)
 	{
 		// create the texture
-		TCacheEntryConfig config;
-		config.rendertarget = true;
-		config.pcformat = PC_TEX_FMT_RGBA32;
-		config.width = scaled_tex_w;
-		config.height = scaled_tex_h;
-		config.layers = FramebufferManagerBase::GetEFBLayers();
-
-		TCacheEntryBase* entry = AllocateTexture(config);
+		TCacheEntryBase* entry = reused_entry;
+		if (entry)
+		{
+			ResetTexture(entry);
+			entry->may_have_overlapping_textures = true;
+		}
+		else
+		{
+			entry = AllocateTexture(config);
+		}
 
 		if (entry)
 		{
@@ -1383,7 +1723,10 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
 
 			entry->FromRenderTarget(is_depth_copy, clampedRect, scaleByHalf, cbufid, colmat, c_tex_w, c_tex_h);
 
-			u64 hash = entry->CalculateHash();
+			// The memory of deferred copies is only hashed and tracked once they are flushed
+			if (!copy_deferred)
+				entry->write_seq = Memory::TrackWrites(dstAddr, covered_range);
+			u64 hash = copy_deferred ? TEXHASH_INVALID : entry->CalculateHash();
 			entry->SetHashes(hash, hash);
 
 			if (g_ActiveConfig.bDumpEFBTarget)
@@ -1393,7 +1736,52 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
 					count++), 0);
 			}
 
-			textures_by_address.emplace(dstAddr, entry);
+			if (!reused_entry)
+				InsertTexture(dstAddr, entry->size_in_bytes, entry);
+		}
+	}
+}
+
+void TextureCacheBase::FlushEFBCopies()
+{
+	if (m_pending_efb_copies.empty())
+		return;
+
+	// Move the list out first, the hashing below must not flush again
+	std::vector<PendingEFBCopy> pending_copies;
+	pending_copies.swap(m_pending_efb_copies);
+	for (PendingEFBCopy& copy : pending_copies)
+		copy.readback->ReadToRAM(copy.dst, copy.memory_stride);
+
+	for (PendingEFBCopy& copy : pending_copies)
+	{
+		auto iter_range = textures_by_address.equal_range(copy.dst_addr);
+		for (auto iter = iter_range.first; iter != iter_range.second; ++iter)
+		{
+			TCacheEntryBase* entry = iter->second;
+			if (entry->IsEfbCopy() && entry->hash == TEXHASH_INVALID)
+			{
+				entry->write_seq = Memory::TrackWrites(copy.dst_addr, copy.covered_range);
+				u64 hash = entry->CalculateHash();
+				entry->SetHashes(hash, hash);
+			}
+		}
+	}
+
+	// Keep the vector's storage for the next frame
+	pending_copies.clear();
+	m_pending_efb_copies.swap(pending_copies);
+}
+
+void TextureCacheBase::FlushEFBCopies(u32 address, u32 size)
+{
+	// Copies depend on each other when they overlap, so all of them are written in order.
+	for (const PendingEFBCopy& copy : m_pending_efb_copies)
+	{
+		if (address < copy.dst_addr + copy.covered_range && copy.dst_addr < address + size)
+		{
+			FlushEFBCopies();
+			return;
 		}
 	}
 }
@@ -1406,20 +1794,28 @@ TextureCacheBase::TCacheEntryBase* TextureCacheBase::AllocateTexture(const TCach
 	{
 		entry = iter->second;
 		texture_pool.erase(iter);
+		texture_pool_pooled_bytes -= entry->native_size_in_bytes;
+		INCSTAT(stats.thisFrame.numTexturePoolHits);
 	}
 	else
 	{
 		texture_pool_memory_usage += config.GetSizeInBytes();
 		entry = CreateTexture(config);
 		INCSTAT(stats.numTexturesCreated);
+		INCSTAT(stats.thisFrame.numTexturePoolMisses);
 	}
+	SETSTAT(stats.textureResidentBytes, texture_pool_memory_usage);
+	SETSTAT(stats.texturePoolBytes, texture_pool_pooled_bytes);
 	entry->textures_by_hash_iter = textures_by_hash.end();
 	entry->may_have_overlapping_textures = true;
 	return entry;
 }
 
-void TextureCacheBase::DisposeTexture(TCacheEntryBase* entry)
+void TextureCacheBase::ResetTexture(TCacheEntryBase* entry)
 {
+	// A running decode only keeps its own buffers alive, its result is dropped.
+	entry->pending_decode.reset();
+
 	if (entry->textures_by_hash_iter != textures_by_hash.end())
 	{
 		textures_by_hash.erase(entry->textures_by_hash_iter);
@@ -1429,8 +1825,16 @@ void TextureCacheBase::DisposeTexture(TCacheEntryBase* entry)
 	entry->DestroyAllReferences();
 
 	entry->frameCount = FRAMECOUNT_INVALID;
+	entry->write_seq = 0;
+}
+
+void TextureCacheBase::DisposeTexture(TCacheEntryBase* entry)
+{
+	ResetTexture(entry);
 
 	texture_pool.emplace(entry->config, entry);
+	texture_pool_pooled_bytes += entry->native_size_in_bytes;
+	SETSTAT(stats.texturePoolBytes, texture_pool_pooled_bytes);
 }
 
 TextureCacheBase::TexPool::iterator
@@ -1474,17 +1878,22 @@ TextureCacheBase::TexAddrCache::iterator TextureCacheBase::InvalidateTexture(Tex
 	return textures_by_address.erase(iter);
 }
 
+TextureCacheBase::TexAddrCache::iterator TextureCacheBase::InsertTexture(u32 address, u32 size_in_bytes,
+	TCacheEntryBase* entry)
+{
+	m_max_entry_size = std::max(m_max_entry_size, size_in_bytes);
+	return textures_by_address.emplace(address, entry);
+}
+
 std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
 TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
 {
 	// We index by the starting address only, so there is no way to query all textures
-	// which end after the given addr. But the GC textures have a limited size, so we
-	// look for all textures which have a start address bigger than addr minus the maximal
-	// texture size. But this yields false-positives which must be checked later on.
-
-	// 1024 x 1024 texel times 8 nibbles per texel
-	constexpr u32 max_texture_size = 1024 * 1024 * 4;
-	u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
+	// which end after the given addr. But every entry is at most m_max_entry_size long, so we
+	// look for all textures which have a start address bigger than addr minus that size.
+	// This yields false-positives which must be checked later on. Usually the largest live
+	// entry is far smaller than the largest possible texture, which keeps the range short.
+	u32 lower_addr = addr > m_max_entry_size ? addr - m_max_entry_size : 0;
 	auto begin = textures_by_address.lower_bound(lower_addr);
 	auto end = textures_by_address.upper_bound(addr + size_in_bytes);
 
@@ -7,9 +7,11 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Thread.h"
@@ -20,6 +22,7 @@
 
 struct VideoConfig;
 class TextureScaler;
+struct AsyncTextureDecode;
 
 enum TextureCacheParams
 {
@@ -29,7 +32,20 @@ enum TextureCacheParams
 	TEXTURE_KILL_MULTIPLIER = 2,
 	TEXTURE_KILL_THRESHOLD = 120,
 	TEXTURE_POOL_KILL_THRESHOLD = 3,
-	TEXTURE_POOL_MEMORY_LIMIT = 64 * 1024 * 1024
+	TEXTURE_POOL_KILL_MULTIPLIER = 20,
+	TEXTURE_POOL_MEMORY_LIMIT = 64 * 1024 * 1024,
+	// Added to the format of entries holding the raw indices of a paletted texture
+	TEXFMT_PALETTE_INDICES = 0x01000000
+};
+
+// An EFB copy that was encoded on the GPU but not yet read back to guest memory.
+class EFBCopyReadback
+{
+public:
+	virtual ~EFBCopyReadback() {}
+	// Waits for the GPU to finish the encode and writes the copy to dst, one row of blocks
+	// every memory_stride bytes.
+	virtual void ReadToRAM(u8* dst, u32 memory_stride) = 0;
 };
 
 class TextureCacheBase
@@ -131,6 +147,8 @@ public:
 		s32 frameCount = {};
 		u64 hash = {};
 		u64 base_hash = {};
+		// Write sequence of guest memory when base_hash was taken, 0 if the memory isn't tracked.
+		u64 write_seq = {};
 
 		// Keep an iterator to the entry in textures_by_hash, so it does not need to be searched when removing the cache entry
 		std::multimap<u64, TCacheEntryBase*>::iterator textures_by_hash_iter;
@@ -142,6 +160,10 @@ public:
 
 		std::string basename;
 
+		// Set while the texture data is decoded on the thread pool, it is uploaded on the next use
+		// after the decode finished.
+		std::shared_ptr<AsyncTextureDecode> pending_decode;
+
 		void SetGeneralParameters(u32 _addr, u32 _size, u32 _format)
 		{
 			addr = _addr;
@@ -216,6 +238,8 @@ public:
 		// width, height are the size of the image in pixels.
 		// aligned_width, aligned_height are the size of the image in pixels, aligned to the block size.
 		// row_stride is the number of bytes for a row of blocks, not pixels.
+		// Scaled entries also have to be run through the texture scaler, return false if that is
+		// not possible.
 		virtual bool DecodeTextureOnGPU(u32 dst_level, const u8* data,
 			u32 data_size, TextureFormat format, u32 width, u32 height,
 			u32 aligned_width, u32 aligned_height, u32 row_stride,
@@ -223,6 +247,13 @@ public:
 		{
 			return false;
 		}
+		// Scales the decoded RGBA8 image in data, expanded_width x height texels, with the active
+		// texture scaler and stores the scaled width x height part of it in dst_level.
+		virtual bool ScaleTextureOnGPU(u32 dst_level, const u8* data, u32 width, u32 height,
+			u32 expanded_width)
+		{
+			return false;
+		}
 		
 
 		bool IsEfbCopy() const
@@ -254,6 +285,18 @@ public:
 	virtual void CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
 		u32 num_blocks_y, u32 memory_stride,
 		bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half) = 0;
+	// Encodes the copy like CopyEFB but leaves the result on the GPU, to be read back once the
+	// data is needed. Returns nullptr if the backend can only copy synchronously.
+	virtual std::unique_ptr<EFBCopyReadback> QueueEFBCopy(const EFBCopyFormat& format,
+		u32 native_width, u32 bytes_per_row, u32 num_blocks_y, bool is_depth_copy,
+		const EFBRectangle& src_rect, bool scale_by_half)
+	{
+		return nullptr;
+	}
+	// Writes all deferred EFB copies to guest memory.
+	void FlushEFBCopies();
+	// Same as above, if any deferred copy overlaps the range.
+	void FlushEFBCopies(u32 address, u32 size);
 
 	virtual bool CompileShaders() = 0; // currently only implemented by OGL
 	virtual void DeleteShaders() = 0; // currently only implemented by OGL
@@ -274,6 +317,11 @@ public:
 	{
 		return false;
 	}
+	// Returns true if the texture scaler type and factor can run on the GPU.
+	virtual bool SupportsGPUTextureScaling(int scaling_type, int factor)
+	{
+		return false;
+	}
 protected:
 	alignas(16) u8 *temp = {};
 	size_t temp_size = {};
@@ -291,22 +339,60 @@ private:
 	void CheckTempSize(size_t required_size);
 	TCacheEntryBase* DoPartialTextureUpdates(TCacheEntryBase* entry_to_update, u32 tlutaddr, u32 tlutfmt, u32 palette_size);
 	TextureCacheBase::TCacheEntryBase* ApplyPaletteToEntry(TCacheEntryBase* entry, u32 tlutaddr, u32 tlutfmt, u32 palette_size);
+	// Finds or uploads the indices of a C4/C8 texture as an I4/I8 texture, so a palette change
+	// only needs a palette conversion pass instead of a new decode.
+	TCacheEntryBase* GetPaletteIndices(u32 address, const u8* src_data, u32 texture_size, u32 texformat,
+		u64 tex_hash, u32 width, u32 height, u32 expanded_width, u32 expanded_height, u32 native_width,
+		u32 native_height, u64 write_seq);
 	void DumpTexture(TCacheEntryBase* entry, std::string basename, u32 level);
+	// Scales a decoded level and uploads it, with a compute shader if scale_on_gpu is set and the
+	// backend manages to, otherwise with the CPU scaler.
+	void LoadScaledLevel(TCacheEntryBase* entry, u8* data, u32 width, u32 height,
+		u32 expanded_width, u32 level, bool scale_on_gpu);
 
 	TexPool::iterator FindMatchingTextureFromPool(const TCacheEntryConfig& config);
 	TexAddrCache::iterator GetTexCacheIter(TCacheEntryBase* entry);
 	TexAddrCache::iterator InvalidateTexture(TexAddrCache::iterator t_iter);
+	// Adds entry to textures_by_address, size_in_bytes extends the range FindOverlappingTextures
+	// has to search if needed.
+	TexAddrCache::iterator InsertTexture(u32 address, u32 size_in_bytes, TCacheEntryBase* entry);
+	// Drops what ties entry to its current contents, before it's pooled or rendered to again.
+	void ResetTexture(TCacheEntryBase* entry);
 	TCacheEntryBase* ReturnEntry(u32 stage, TCacheEntryBase* entry);
 
+	// Queues the decode of a new texture on the thread pool.
+	void DecodeTextureAsync(TCacheEntryBase* entry, const u8* src_data, u32 src_size,
+		u32 expanded_width, u32 expanded_height, u32 texformat, u32 levels);
+	// Uploads the texture if its decode has finished. Returns false while it is still running.
+	bool FinishAsyncDecode(TCacheEntryBase* entry);
+	TCacheEntryBase* GetDecodePlaceholder();
+
 	// Return all possible overlapping textures. As addr+size of the textures is not
 	// indexed, this may return false positives.
 	std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
 		FindOverlappingTextures(u32 addr, u32 size_in_bytes);
 
 	TexAddrCache textures_by_address;
+	// No entry in textures_by_address spans more than this, recalculated by Cleanup
+	u32 m_max_entry_size = 0;
 	TexHashCache textures_by_hash;
 	TexPool texture_pool;
+	// Names of the textures already dumped or queued for dumping
+	std::unordered_set<std::string> m_dumped_textures;
+
+	struct PendingEFBCopy
+	{
+		u8* dst;
+		u32 dst_addr;
+		u32 covered_range;
+		u32 memory_stride;
+		std::unique_ptr<EFBCopyReadback> readback;
+	};
+	// In the order they were queued, so later copies to the same memory win.
+	std::vector<PendingEFBCopy> m_pending_efb_copies;
+	// Bytes of all textures, and of the ones in the pool waiting for reuse
 	size_t texture_pool_memory_usage = {};
+	size_t texture_pool_pooled_bytes = {};
 	
 	u32 s_last_texture = {};
 
@@ -327,6 +413,11 @@ private:
 	};
 	BackupConfig backup_config = {};
 	std::unique_ptr<TextureScaler> m_scaler;
+
+	// Finished decodes are kept to reuse their buffers.
+	std::vector<std::shared_ptr<AsyncTextureDecode>> m_async_decode_pool;
+	// Bound instead of textures that are still being decoded.
+	TCacheEntryBase* m_decode_placeholder = nullptr;
 };
 
 extern std::unique_ptr<TextureCacheBase> g_texture_cache;
\ No newline at end of file
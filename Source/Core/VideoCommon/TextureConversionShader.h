@@ -46,6 +46,9 @@ inline u16 GetEncodedSampleCount(u32 format)
 	}
 }
 const char *GenerateEncodingShader(const EFBCopyFormat& format, API_TYPE ApiType = API_OPENGL);
+// GLSL compute variant of the encoder, writing one packed BGRA word per output texel to the
+// storage buffer at binding 1. The dispatch size is given by the encoded_size uniform.
+const char *GenerateEncodingComputeShader(const EFBCopyFormat& format);
 
 // View format of the input data to the texture decoding shader.
 enum BufferFormat
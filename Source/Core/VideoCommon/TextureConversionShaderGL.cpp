@@ -21,6 +21,8 @@
 
 static char text[16384];
 static bool IntensityConstantAdded = false;
+// Set while generating the compute variant of an encoder
+static bool ComputeEncoder = false;
 
 namespace TextureConversionShader
 {
@@ -59,7 +61,25 @@ static void WriteSwizzler(char*& p, u32 format, API_TYPE ApiType)
 	int blkH = TexDecoder_GetBlockHeightInTexels(format);
 	int samples = GetEncodedSampleCount(format);
 
-	if (ApiType == API_OPENGL)
+	if (ApiType == API_OPENGL && ComputeEncoder)
+	{
+		// One invocation per output texel, stored as a packed word of the destination buffer so
+		// the whole copy can be read back without going through a render target.
+		WRITE(p, "layout(local_size_x = 8, local_size_y = 8) in;\n");
+		WRITE(p, "#define samp0 samp9\n");
+		WRITE(p, "SAMPLER_BINDING(9) uniform sampler2DArray samp0;\n");
+		WRITE(p, "uniform int2 encoded_size;\n");
+		WRITE(p, "layout(std430) SSBO_BINDING(1) writeonly buffer EncodedData { uint encoded[]; };\n");
+
+		WRITE(p, "void main()\n");
+		WRITE(p, "{\n"
+			"  int2 sampleUv;\n"
+			"  int2 uv1 = int2(gl_GlobalInvocationID.xy);\n"
+			"  if (uv1.x >= encoded_size.x || uv1.y >= encoded_size.y)\n"
+			"    return;\n"
+			"  float4 ocol0;\n");
+	}
+	else if (ApiType == API_OPENGL)
 	{
 		WRITE(p, "#define samp0 samp9\n");
 		WRITE(p, "SAMPLER_BINDING(9) uniform sampler2DArray samp0;\n");
@@ -187,6 +207,9 @@ static void WriteToBitDepth(char*& p, u8 depth, const char* src, const char* des
 
 static void WriteEncoderEnd(char*& p)
 {
+	// Same byte order as the BGRA readback of the render target
+	if (ComputeEncoder)
+		WRITE(p, "  encoded[uv1.y * encoded_size.x + uv1.x] = packUnorm4x8(ocol0.bgra);\n");
 	WRITE(p, "}\n");
 	IntensityConstantAdded = false;
 }
@@ -712,6 +735,14 @@ const char* GenerateEncodingShader(const EFBCopyFormat& format, API_TYPE ApiType
 	return text;
 }
 
+const char* GenerateEncodingComputeShader(const EFBCopyFormat& format)
+{
+	ComputeEncoder = true;
+	const char* shader = GenerateEncodingShader(format, API_OPENGL);
+	ComputeEncoder = false;
+	return shader;
+}
+
 // NOTE: In these uniforms, a row refers to a row of blocks, not texels.
 static const char decoding_shader_header[] = R"(
 #ifdef VULKAN
@@ -1081,6 +1112,64 @@ static const std::map<TextureFormat, DecodingShaderInfo> s_decoding_shader_info{
         vec4 norm_color = GetPaletteColorNormalized(index);
         imageStore(output_image, ivec3(ivec2(coords), 0), norm_color);
       }
+      )" } },
+	  { GX_TF_CMPR,
+	  { BUFFER_FORMAT_R32G32_UINT, 0, 8, 8, false,
+	R"(
+      layout(local_size_x = 8, local_size_y = 8) in;
+
+      void main()
+      {
+        uvec2 coords = gl_GlobalInvocationID.xy;
+
+        // Tiled in 8x8 blocks made of four 4x4 DXT1 blocks, each buffer element is one DXT block:
+        // two BE RGB565 colors in x, then one byte of 2-bit indices per row in y.
+        uvec2 block = coords / 8u;
+        uvec2 sub_block = (coords % 8u) / 4u;
+        uvec2 offset = coords % 4u;
+        uint buffer_pos = u_src_offset;
+        buffer_pos += block.y * u_src_row_stride;
+        buffer_pos += block.x * 4u;
+        buffer_pos += sub_block.y * 2u;
+        buffer_pos += sub_block.x;
+        uvec2 dxt = texelFetch(s_input_buffer, int(buffer_pos)).xy;
+
+        uint c1 = Swap16(dxt.x & 0xFFFFu);
+        uint c2 = Swap16(dxt.x >> 16);
+        ivec3 color1 = ivec3(int(Convert5To8(bitfieldExtract(c1, 11, 5))),
+                             int(Convert6To8(bitfieldExtract(c1, 5, 6))),
+                             int(Convert5To8(bitfieldExtract(c1, 0, 5))));
+        ivec3 color2 = ivec3(int(Convert5To8(bitfieldExtract(c2, 11, 5))),
+                             int(Convert6To8(bitfieldExtract(c2, 5, 6))),
+                             int(Convert5To8(bitfieldExtract(c2, 0, 5))));
+
+        uint line = bitfieldExtract(dxt.y, int(offset.y * 8u), 8);
+        uint index = bitfieldExtract(line, int(6u - offset.x * 2u), 2);
+
+        // Same blending as the CPU decoder, GameCube CMPR differs from PC DXT1 here.
+        ivec4 color;
+        if (index == 0u)
+        {
+          color = ivec4(color1, 255);
+        }
+        else if (index == 1u)
+        {
+          color = ivec4(color2, 255);
+        }
+        else if (c1 > c2)
+        {
+          ivec3 diff = color2 - color1;
+          ivec3 blend = (diff >> 1) - (diff >> 3);
+          color = (index == 2u) ? ivec4(color1 + blend, 255) : ivec4(color2 - blend, 255);
+        }
+        else
+        {
+          color = (index == 2u) ? ivec4((color1 + color2 + 1) / 2, 255) : ivec4(color2, 0);
+        }
+
+        vec4 norm_color = vec4(color) / 255.0;
+        imageStore(output_image, ivec3(ivec2(coords), 0), norm_color);
+      }
       )" } } };
 
 static const std::array<u32, BUFFER_FORMAT_COUNT> s_buffer_bytes_per_texel = { {
@@ -29,6 +29,9 @@ public:
 	~TextureScaler();
 
 	u32* Scale(u32* data, int width, int height);
+	// Returns the deposterized texture if that is enabled, data otherwise. Scale() does this itself,
+	// it is only needed when another scaler takes the result.
+	u32* ApplyDePosterize(u32* data, int width, int height);
 
 	enum
 	{
@@ -0,0 +1,828 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <sstream>
+
+#include "VideoCommon/TextureScalerCommon.h"
+#include "VideoCommon/TextureScalerShader.h"
+
+namespace TextureScalerShader
+{
+static const char scaling_shader_header[] = R"(
+#ifdef VULKAN
+
+layout(std140, push_constant) uniform PushConstants {
+  uvec2 src_size;
+} push_constants;
+#define u_src_size (push_constants.src_size)
+
+SAMPLER_BINDING(0) uniform sampler2DArray s_input_image;
+
+IMAGE_BINDING(rgba8, 0) uniform writeonly image2DArray output_image;
+
+#else
+
+uniform uvec2 u_src_size;
+
+SAMPLER_BINDING(9) uniform sampler2DArray s_input_image;
+
+layout(rgba8, binding = 0) uniform writeonly image2DArray output_image;
+
+#endif
+)";
+
+// Shared by all filters. Texels are kept packed with red in the low byte, exactly as the CPU
+// scaler sees them, so the integer math below can follow it operation for operation.
+static const char scaling_shader_common[] = R"(
+// Texels around the current one, clamped to the image.
+#define CACHE_SIZE (2 * CACHE_RADIUS + 1)
+uint s_texels[CACHE_SIZE * CACHE_SIZE];
+ivec2 s_coords;
+
+// Output texels of the current block, row major.
+uint s_block[SCALE * SCALE];
+
+uint T(int x, int y)
+{
+  return s_texels[(y + CACHE_RADIUS) * CACHE_SIZE + x + CACHE_RADIUS];
+}
+
+uint GetByte(uint v, int n)
+{
+  return (v >> (8 * n)) & 0xFFu;
+}
+
+ivec4 Unpack(uint v)
+{
+  return ivec4(int(GetByte(v, 0)), int(GetByte(v, 1)), int(GetByte(v, 2)), int(GetByte(v, 3)));
+}
+
+uint Pack(ivec4 c)
+{
+  return uint(c.r) | (uint(c.g) << 8) | (uint(c.b) << 16) | (uint(c.a) << 24);
+}
+
+ivec2 ClampToImage(ivec2 coords)
+{
+  return ivec2(clamp(coords.x, 0, int(u_src_size.x) - 1), clamp(coords.y, 0, int(u_src_size.y) - 1));
+}
+)";
+
+// xBRZ 1.4 with the default ScalerCfg, see Externals/xbrz.
+static const char xbrz_shader_body[] = R"(
+#define BLEND_NONE 0u
+#define BLEND_NORMAL 1u
+#define BLEND_DOMINANT 2u
+
+#define EQUAL_COLOR_TOLERANCE 30.0
+#define DOMINANT_DIRECTION_THRESHOLD 3.6
+#define STEEP_DIRECTION_THRESHOLD 2.2
+
+// The CPU version reads this from a lookup table indexed by the halved channel differences.
+// xBRZ names byte 2 red and byte 0 blue.
+float DistYCbCr(uint pix1, uint pix2)
+{
+  ivec3 d = ivec3(int(GetByte(pix1, 2)), int(GetByte(pix1, 1)), int(GetByte(pix1, 0))) -
+            ivec3(int(GetByte(pix2, 2)), int(GetByte(pix2, 1)), int(GetByte(pix2, 0)));
+  d = (d + 255) / 2 * 2 - 255;
+
+  const float k_b = 0.0593;
+  const float k_r = 0.2627;
+  const float scale_b = 0.5 / (1.0 - k_b);
+  const float scale_r = 0.5 / (1.0 - k_r);
+
+  // Same as k_r * r + k_g * g + k_b * b, but exact for grays so that the ties which decide the
+  // blend color in single precision still go the way of the double precision CPU version.
+  float y = float(d.y) + k_r * float(d.x - d.y) + k_b * float(d.z - d.y);
+  float c_b = scale_b * (float(d.z) - y);
+  float c_r = scale_r * (float(d.x) - y);
+  return sqrt(y * y + c_b * c_b + c_r * c_r);
+}
+
+float Dist(uint pix1, uint pix2)
+{
+  float a1 = float(GetByte(pix1, 3)) / 255.0;
+  float a2 = float(GetByte(pix2, 3)) / 255.0;
+  float d = DistYCbCr(pix1, pix2);
+  if (a1 < a2)
+    return a1 * d + 255.0 * (a2 - a1);
+  return a2 * d + 255.0 * (a1 - a2);
+}
+
+bool Eq(uint pix1, uint pix2)
+{
+  return Dist(pix1, pix2) < EQUAL_COLOR_TOLERANCE;
+}
+
+// Blend types of the corners of the square between the texels at offsets 0 and 1, packed as
+// top left, top right, bottom left and bottom right. ox and oy are the offset of its top left.
+uvec4 PreProcessCorners(int ox, int oy)
+{
+  uint b = T(ox, oy - 1);
+  uint c = T(ox + 1, oy - 1);
+  uint e = T(ox - 1, oy);
+  uint f = T(ox, oy);
+  uint g = T(ox + 1, oy);
+  uint h = T(ox + 2, oy);
+  uint i = T(ox - 1, oy + 1);
+  uint j = T(ox, oy + 1);
+  uint k = T(ox + 1, oy + 1);
+  uint l = T(ox + 2, oy + 1);
+  uint n = T(ox, oy + 2);
+  uint o = T(ox + 1, oy + 2);
+
+  uvec4 result = uvec4(BLEND_NONE, BLEND_NONE, BLEND_NONE, BLEND_NONE);
+  if ((f == g && j == k) || (f == j && g == k))
+    return result;
+
+  float jg = Dist(i, f) + Dist(f, c) + Dist(n, k) + Dist(k, h) + 4.0 * Dist(j, g);
+  float fk = Dist(e, j) + Dist(j, o) + Dist(b, g) + Dist(g, l) + 4.0 * Dist(f, k);
+
+  if (jg < fk)
+  {
+    bool dominant = DOMINANT_DIRECTION_THRESHOLD * jg < fk;
+    if (f != g && f != j)
+      result.x = dominant ? BLEND_DOMINANT : BLEND_NORMAL;
+    if (k != j && k != g)
+      result.w = dominant ? BLEND_DOMINANT : BLEND_NORMAL;
+  }
+  else if (fk < jg)
+  {
+    bool dominant = DOMINANT_DIRECTION_THRESHOLD * fk < jg;
+    if (j != f && j != k)
+      result.z = dominant ? BLEND_DOMINANT : BLEND_NORMAL;
+    if (g != f && g != k)
+      result.y = dominant ? BLEND_DOMINANT : BLEND_NORMAL;
+  }
+  return result;
+}
+
+// Index in s_block of row i, column j of the block rotated clockwise rot times.
+int BlockIndex(int rot, int i, int j)
+{
+  const int n = SCALE - 1;
+  if (rot == 1)
+    return (n - j) * SCALE + i;
+  if (rot == 2)
+    return (n - i) * SCALE + n - j;
+  if (rot == 3)
+    return j * SCALE + n - i;
+  return i * SCALE + j;
+}
+
+uint GradientARGB(uint m, uint n, uint front, uint back)
+{
+  uint weight_front = GetByte(front, 3) * m;
+  uint weight_back = GetByte(back, 3) * (n - m);
+  uint weight_sum = weight_front + weight_back;
+  if (weight_sum == 0u)
+    return 0u;
+
+  uint result = (weight_sum / n) << 24;
+  for (int c = 0; c < 3; c++)
+  {
+    uint value = (GetByte(front, c) * weight_front + GetByte(back, c) * weight_back) / weight_sum;
+    result |= value << (8 * c);
+  }
+  return result;
+}
+
+void AlphaGrad(int rot, int i, int j, uint m, uint n, uint col)
+{
+  int index = BlockIndex(rot, i, j);
+  s_block[index] = GradientARGB(m, n, col, s_block[index]);
+}
+
+void SetTexel(int rot, int i, int j, uint col)
+{
+  s_block[BlockIndex(rot, i, j)] = col;
+}
+
+#if SCALE == 2
+void BlendLineShallow(int rot, uint col)
+{
+  AlphaGrad(rot, 1, 0, 1u, 4u, col);
+  AlphaGrad(rot, 1, 1, 3u, 4u, col);
+}
+void BlendLineSteep(int rot, uint col)
+{
+  AlphaGrad(rot, 0, 1, 1u, 4u, col);
+  AlphaGrad(rot, 1, 1, 3u, 4u, col);
+}
+void BlendLineSteepAndShallow(int rot, uint col)
+{
+  AlphaGrad(rot, 1, 0, 1u, 4u, col);
+  AlphaGrad(rot, 0, 1, 1u, 4u, col);
+  AlphaGrad(rot, 1, 1, 5u, 6u, col);
+}
+void BlendLineDiagonal(int rot, uint col)
+{
+  AlphaGrad(rot, 1, 1, 1u, 2u, col);
+}
+void BlendCorner(int rot, uint col)
+{
+  AlphaGrad(rot, 1, 1, 21u, 100u, col);
+}
+#elif SCALE == 3
+void BlendLineShallow(int rot, uint col)
+{
+  AlphaGrad(rot, 2, 0, 1u, 4u, col);
+  AlphaGrad(rot, 1, 2, 1u, 4u, col);
+  AlphaGrad(rot, 2, 1, 3u, 4u, col);
+  SetTexel(rot, 2, 2, col);
+}
+void BlendLineSteep(int rot, uint col)
+{
+  AlphaGrad(rot, 0, 2, 1u, 4u, col);
+  AlphaGrad(rot, 2, 1, 1u, 4u, col);
+  AlphaGrad(rot, 1, 2, 3u, 4u, col);
+  SetTexel(rot, 2, 2, col);
+}
+void BlendLineSteepAndShallow(int rot, uint col)
+{
+  AlphaGrad(rot, 2, 0, 1u, 4u, col);
+  AlphaGrad(rot, 0, 2, 1u, 4u, col);
+  AlphaGrad(rot, 2, 1, 3u, 4u, col);
+  AlphaGrad(rot, 1, 2, 3u, 4u, col);
+  SetTexel(rot, 2, 2, col);
+}
+void BlendLineDiagonal(int rot, uint col)
+{
+  AlphaGrad(rot, 1, 2, 1u, 8u, col);
+  AlphaGrad(rot, 2, 1, 1u, 8u, col);
+  AlphaGrad(rot, 2, 2, 7u, 8u, col);
+}
+void BlendCorner(int rot, uint col)
+{
+  AlphaGrad(rot, 2, 2, 45u, 100u, col);
+}
+#elif SCALE == 4
+void BlendLineShallow(int rot, uint col)
+{
+  AlphaGrad(rot, 3, 0, 1u, 4u, col);
+  AlphaGrad(rot, 2, 2, 1u, 4u, col);
+  AlphaGrad(rot, 3, 1, 3u, 4u, col);
+  AlphaGrad(rot, 2, 3, 3u, 4u, col);
+  SetTexel(rot, 3, 2, col);
+  SetTexel(rot, 3, 3, col);
+}
+void BlendLineSteep(int rot, uint col)
+{
+  AlphaGrad(rot, 0, 3, 1u, 4u, col);
+  AlphaGrad(rot, 2, 2, 1u, 4u, col);
+  AlphaGrad(rot, 1, 3, 3u, 4u, col);
+  AlphaGrad(rot, 3, 2, 3u, 4u, col);
+  SetTexel(rot, 2, 3, col);
+  SetTexel(rot, 3, 3, col);
+}
+void BlendLineSteepAndShallow(int rot, uint col)
+{
+  AlphaGrad(rot, 3, 1, 3u, 4u, col);
+  AlphaGrad(rot, 1, 3, 3u, 4u, col);
+  AlphaGrad(rot, 3, 0, 1u, 4u, col);
+  AlphaGrad(rot, 0, 3, 1u, 4u, col);
+  AlphaGrad(rot, 2, 2, 1u, 3u, col);
+  SetTexel(rot, 3, 3, col);
+  SetTexel(rot, 3, 2, col);
+  SetTexel(rot, 2, 3, col);
+}
+void BlendLineDiagonal(int rot, uint col)
+{
+  AlphaGrad(rot, 3, 2, 1u, 2u, col);
+  AlphaGrad(rot, 2, 3, 1u, 2u, col);
+  SetTexel(rot, 3, 3, col);
+}
+void BlendCorner(int rot, uint col)
+{
+  AlphaGrad(rot, 3, 3, 68u, 100u, col);
+  AlphaGrad(rot, 3, 2, 9u, 100u, col);
+  AlphaGrad(rot, 2, 3, 9u, 100u, col);
+}
+#else
+void BlendLineShallow(int rot, uint col)
+{
+  AlphaGrad(rot, 4, 0, 1u, 4u, col);
+  AlphaGrad(rot, 3, 2, 1u, 4u, col);
+  AlphaGrad(rot, 2, 4, 1u, 4u, col);
+  AlphaGrad(rot, 4, 1, 3u, 4u, col);
+  AlphaGrad(rot, 3, 3, 3u, 4u, col);
+  SetTexel(rot, 4, 2, col);
+  SetTexel(rot, 4, 3, col);
+  SetTexel(rot, 4, 4, col);
+  SetTexel(rot, 3, 4, col);
+}
+void BlendLineSteep(int rot, uint col)
+{
+  AlphaGrad(rot, 0, 4, 1u, 4u, col);
+  AlphaGrad(rot, 2, 3, 1u, 4u, col);
+  AlphaGrad(rot, 4, 2, 1u, 4u, col);
+  AlphaGrad(rot, 1, 4, 3u, 4u, col);
+  AlphaGrad(rot, 3, 3, 3u, 4u, col);
+  SetTexel(rot, 2, 4, col);
+  SetTexel(rot, 3, 4, col);
+  SetTexel(rot, 4, 4, col);
+  SetTexel(rot, 4, 3, col);
+}
+void BlendLineSteepAndShallow(int rot, uint col)
+{
+  AlphaGrad(rot, 0, 4, 1u, 4u, col);
+  AlphaGrad(rot, 2, 3, 1u, 4u, col);
+  AlphaGrad(rot, 1, 4, 3u, 4u, col);
+  AlphaGrad(rot, 4, 0, 1u, 4u, col);
+  AlphaGrad(rot, 3, 2, 1u, 4u, col);
+  AlphaGrad(rot, 4, 1, 3u, 4u, col);
+  AlphaGrad(rot, 3, 3, 2u, 3u, col);
+  SetTexel(rot, 2, 4, col);
+  SetTexel(rot, 3, 4, col);
+  SetTexel(rot, 4, 4, col);
+  SetTexel(rot, 4, 2, col);
+  SetTexel(rot, 4, 3, col);
+}
+void BlendLineDiagonal(int rot, uint col)
+{
+  AlphaGrad(rot, 4, 2, 1u, 8u, col);
+  AlphaGrad(rot, 3, 3, 1u, 8u, col);
+  AlphaGrad(rot, 2, 4, 1u, 8u, col);
+  AlphaGrad(rot, 4, 3, 7u, 8u, col);
+  AlphaGrad(rot, 3, 4, 7u, 8u, col);
+  SetTexel(rot, 4, 4, col);
+}
+void BlendCorner(int rot, uint col)
+{
+  AlphaGrad(rot, 4, 4, 86u, 100u, col);
+  AlphaGrad(rot, 4, 3, 23u, 100u, col);
+  AlphaGrad(rot, 3, 4, 23u, 100u, col);
+}
+#endif
+
+// Blends the bottom right corner of the block, with the 3x3 input rotated like the block.
+void BlendPixel(int rot, uint blend_info, uint a, uint b, uint c, uint d, uint e, uint f, uint g,
+                uint h, uint i)
+{
+  uint top_r = (blend_info >> 2) & 3u;
+  uint bottom_r = (blend_info >> 4) & 3u;
+  uint bottom_l = (blend_info >> 6) & 3u;
+  if (bottom_r == BLEND_NONE)
+    return;
+
+  bool do_line_blend;
+  if (bottom_r >= BLEND_DOMINANT)
+    do_line_blend = true;
+  else if (top_r != BLEND_NONE && !Eq(e, g))
+    do_line_blend = false;
+  else if (bottom_l != BLEND_NONE && !Eq(e, c))
+    do_line_blend = false;
+  else if (!Eq(e, i) && Eq(g, h) && Eq(h, i) && Eq(i, f) && Eq(f, c))
+    do_line_blend = false;
+  else
+    do_line_blend = true;
+
+  uint px = Dist(e, f) <= Dist(e, h) ? f : h;
+  if (!do_line_blend)
+  {
+    BlendCorner(rot, px);
+    return;
+  }
+
+  float fg = Dist(f, g);
+  float hc = Dist(h, c);
+  bool shallow = STEEP_DIRECTION_THRESHOLD * fg <= hc && e != g && d != g;
+  bool steep = STEEP_DIRECTION_THRESHOLD * hc <= fg && e != c && b != c;
+  if (shallow && steep)
+    BlendLineSteepAndShallow(rot, px);
+  else if (shallow)
+    BlendLineShallow(rot, px);
+  else if (steep)
+    BlendLineSteep(rot, px);
+  else
+    BlendLineDiagonal(rot, px);
+}
+
+uint RotateBlendInfo(uint blend_info, int rot)
+{
+  return ((blend_info << (2 * rot)) | (blend_info >> (8 - 2 * rot))) & 0xFFu;
+}
+
+void ScaleXBRZ()
+{
+  // Corners outside of the image are never blended, like the first row and column on the CPU.
+  uint blend_info = PreProcessCorners(0, 0).x << 4;
+  if (s_coords.x > 0)
+    blend_info |= PreProcessCorners(-1, 0).y << 6;
+  if (s_coords.y > 0)
+  {
+    blend_info |= PreProcessCorners(0, -1).z << 2;
+    if (s_coords.x > 0)
+      blend_info |= PreProcessCorners(-1, -1).w;
+  }
+
+  uint a = T(-1, -1);
+  uint b = T(0, -1);
+  uint c = T(1, -1);
+  uint d = T(-1, 0);
+  uint e = T(0, 0);
+  uint f = T(1, 0);
+  uint g = T(-1, 1);
+  uint h = T(0, 1);
+  uint i = T(1, 1);
+
+  for (int n = 0; n < SCALE * SCALE; n++)
+    s_block[n] = e;
+
+  if (blend_info == 0u)
+    return;
+
+  BlendPixel(0, blend_info, a, b, c, d, e, f, g, h, i);
+  BlendPixel(1, RotateBlendInfo(blend_info, 1), g, d, a, h, e, b, i, f, c);
+  BlendPixel(2, RotateBlendInfo(blend_info, 2), i, h, g, f, e, d, c, b, a);
+  BlendPixel(3, RotateBlendInfo(blend_info, 3), c, f, i, b, e, h, a, d, g);
+}
+)";
+
+// TextureScaler::ScaleHybrid without the bicubic option: xBRZ mixed with the bilinear scaler,
+// using the upscaled distance mask to pick xBRZ on edges.
+static const char hybrid_shader_body[] = R"(
+#define MASK_MAX 8192u
+
+// TextureScaler::ScaleBilinear's factors, entry i is used for the sub-texels at distance i from
+// the edge of the block.
+ivec2 BilinearFactors(int i)
+{
+#if SCALE == 2
+  return ivec2(44, 211);
+#elif SCALE == 3
+  return i == 0 ? ivec2(64, 191) : ivec2(0, 255);
+#elif SCALE == 4
+  return i == 0 ? ivec2(77, 178) : ivec2(26, 229);
+#else
+  return i == 0 ? ivec2(102, 153) : (i == 1 ? ivec2(51, 204) : ivec2(0, 255));
+#endif
+}
+
+uint MixPixels(uint p0, uint p1, ivec2 factors)
+{
+  uint result = 0u;
+  for (int c = 0; c < 4; c++)
+  {
+    uint value = (GetByte(p0, c) * uint(factors.x) + GetByte(p1, c) * uint(factors.y)) / 255u;
+    result |= value << (8 * c);
+  }
+  return result;
+}
+
+// 3x3 native values around the current texel, the colors followed by the splatted masks.
+uint s_grid[18];
+
+uint BilinearRow(int grid, int row, int x)
+{
+  uint left = s_grid[grid * 9 + row * 3];
+  uint center = s_grid[grid * 9 + row * 3 + 1];
+  uint right = s_grid[grid * 9 + row * 3 + 2];
+  if (x < SCALE / 2 + SCALE % 2)
+    return MixPixels(left, center, BilinearFactors(x));
+  return MixPixels(right, center, BilinearFactors(SCALE - 1 - x));
+}
+
+uint Bilinear(int grid, int x, int y)
+{
+  uint upper = BilinearRow(grid, 0, x);
+  uint center = BilinearRow(grid, 1, x);
+  uint lower = BilinearRow(grid, 2, x);
+  if (y < SCALE / 2 + SCALE % 2)
+    return MixPixels(upper, center, BilinearFactors(y));
+  return MixPixels(lower, center, BilinearFactors(SCALE - 1 - y));
+}
+
+int Distance(uint pix1, uint pix2)
+{
+  int result = 0;
+  for (int c = 0; c < 4; c++)
+    result += abs(int(GetByte(pix1, c)) - int(GetByte(pix2, c)));
+  return result;
+}
+
+// generateDistanceMask for a texel in the image. Neighbours outside of it count as very distant.
+uint DistanceMask(ivec2 coords)
+{
+  uint center = T(coords.x - s_coords.x, coords.y - s_coords.y);
+  uint dist = 0u;
+  for (int yoff = -1; yoff <= 1; yoff++)
+  {
+    int y = coords.y + yoff;
+    if (y == -1 || y == int(u_src_size.y))
+    {
+      dist += 1200u;
+      continue;
+    }
+    for (int xoff = -1; xoff <= 1; xoff++)
+    {
+      if (yoff == 0 && xoff == 0)
+        continue;
+      int x = coords.x + xoff;
+      if (x == -1 || x == int(u_src_size.x))
+      {
+        dist += 400u;
+        continue;
+      }
+      dist += uint(Distance(center, T(x - s_coords.x, y - s_coords.y)));
+    }
+  }
+  return dist;
+}
+
+// Distance masks of the texels up to two away, indexed by offset, as the splat of a neighbour
+// sums the masks of its own neighbours.
+uint s_masks[25];
+
+uint SplatMask(ivec2 coords)
+{
+  uint result = 0u;
+  for (int yoff = -1; yoff <= 1; yoff++)
+  {
+    for (int xoff = -1; xoff <= 1; xoff++)
+    {
+      ivec2 offset = ClampToImage(coords + ivec2(xoff, yoff)) - s_coords;
+      result += s_masks[(offset.y + 2) * 5 + offset.x + 2];
+    }
+  }
+  return result;
+}
+
+void ScaleBlock()
+{
+  ScaleXBRZ();
+
+  for (int y = -2; y <= 2; y++)
+  {
+    for (int x = -2; x <= 2; x++)
+      s_masks[(y + 2) * 5 + x + 2] = DistanceMask(ClampToImage(s_coords + ivec2(x, y)));
+  }
+  for (int y = -1; y <= 1; y++)
+  {
+    for (int x = -1; x <= 1; x++)
+    {
+      s_grid[(y + 1) * 3 + x + 1] = T(x, y);
+      s_grid[9 + (y + 1) * 3 + x + 1] = SplatMask(ClampToImage(s_coords + ivec2(x, y)));
+    }
+  }
+
+  for (int y = 0; y < SCALE; y++)
+  {
+    for (int x = 0; x < SCALE; x++)
+    {
+      uint mask = Bilinear(1, x, y);
+      int factor = int((min(mask, MASK_MAX) * 255u) / MASK_MAX);
+      uint xbrz = s_block[y * SCALE + x];
+      uint result = MixPixels(Bilinear(0, x, y), xbrz, ivec2(255 - factor, factor));
+      if (GetByte(xbrz, 3) == 0u)
+        result &= 0x00FFFFFFu;
+      s_block[y * SCALE + x] = result;
+    }
+  }
+}
+)";
+
+// scaleDDT's edge directed interpolation. The CPU version writes cells of SCALE x SCALE
+// texels starting SCALE / 2 to the top left of each texel, and the cells past the right and
+// bottom edges are clamped onto the last column and row, so those keep the last texel of the cell.
+static const char ddt_shader_common[] = R"(
+int CellOf(int coord, int size)
+{
+  return coord == size * SCALE - 1 ? size : (coord + SCALE / 2) / SCALE;
+}
+
+int CellOffset(int coord, int size)
+{
+  return coord == size * SCALE - 1 ? SCALE - 1 : (coord + SCALE / 2) % SCALE;
+}
+
+ivec4 Linear3p(int p, int q, ivec4 a, ivec4 b, ivec4 c)
+{
+  p = (((p << 1) + 1) << 7) / SCALE;
+  q = (((q << 1) + 1) << 7) / SCALE;
+  return (a << 8) + p * (b - a) + q * (c - a);
+}
+
+// Rounded like the SSE4.1 version, the plain one drops the low bits of p * q first.
+ivec4 Linear4p(int p, int q, ivec4 a, ivec4 b, ivec4 c, ivec4 d)
+{
+  p = (((p << 1) + 1) << 7) / SCALE;
+  q = (((q << 1) + 1) << 7) / SCALE;
+  return (a << 8) + p * (b - a) + q * (c - a) + (((a - b - c + d) * p * q) >> 8);
+}
+
+uint InterpolateCell(int px, int py, int wd1, int wd2, ivec4 c00, ivec4 c10, ivec4 c01, ivec4 c11)
+{
+  ivec4 result;
+  if (wd1 < wd2)
+  {
+    if (px > py)
+      result = Linear3p(SCALE - px - 1, py, c10, c00, c11);
+    else
+      result = Linear3p(px, SCALE - py - 1, c01, c11, c00);
+  }
+  else if (wd1 > wd2)
+  {
+    if (px + py < SCALE)
+      result = Linear3p(px, py, c00, c10, c01);
+    else
+      result = Linear3p(SCALE - px - 1, SCALE - py - 1, c11, c01, c10);
+  }
+  else
+  {
+    result = Linear4p(px, py, c00, c10, c01, c11);
+  }
+  return Pack(clamp(result >> 8, 0, 255));
+}
+
+// Support texel [sx][sy] of the cell at (cx, cy), first is the top left one.
+uint CellTexel(int cx, int cy, int sx, int sy)
+{
+  return T(cx + sx - s_coords.x, cy + sy - s_coords.y);
+}
+
+int Green(uint v)
+{
+  return int(GetByte(v, 1));
+}
+)";
+
+static const char ddt_shader_body[] = R"(
+uint ScaleTexel(int x, int y)
+{
+  int ox = s_coords.x * SCALE + x;
+  int oy = s_coords.y * SCALE + y;
+  int cx = CellOf(ox, int(u_src_size.x)) - 1;
+  int cy = CellOf(oy, int(u_src_size.y)) - 1;
+  int px = CellOffset(ox, int(u_src_size.x));
+  int py = CellOffset(oy, int(u_src_size.y));
+
+  uint c00 = CellTexel(cx, cy, 0, 0);
+  uint c10 = CellTexel(cx, cy, 1, 0);
+  uint c01 = CellTexel(cx, cy, 0, 1);
+  uint c11 = CellTexel(cx, cy, 1, 1);
+
+  int wd1 = abs(Green(c00) - Green(c11));
+  int wd2 = abs(Green(c10) - Green(c01));
+  return InterpolateCell(px, py, wd1, wd2, Unpack(c00), Unpack(c10), Unpack(c01), Unpack(c11));
+}
+
+void ScaleBlock()
+{
+  for (int y = 0; y < SCALE; y++)
+  {
+    for (int x = 0; x < SCALE; x++)
+      s_block[y * SCALE + x] = ScaleTexel(x, y);
+  }
+}
+)";
+
+// scaleDDTSharp weighs the edge directions over a 4x4 support.
+static const char ddt_sharp_shader_body[] = R"(
+uint ScaleTexel(int x, int y)
+{
+  int ox = s_coords.x * SCALE + x;
+  int oy = s_coords.y * SCALE + y;
+  int cx = CellOf(ox, int(u_src_size.x)) - 2;
+  int cy = CellOf(oy, int(u_src_size.y)) - 2;
+  int px = CellOffset(ox, int(u_src_size.x));
+  int py = CellOffset(oy, int(u_src_size.y));
+
+  int g[16];
+  for (int sy = 0; sy < 4; sy++)
+  {
+    for (int sx = 0; sx < 4; sx++)
+      g[sx * 4 + sy] = Green(CellTexel(cx, cy, sx, sy));
+  }
+#define G(sx, sy) g[(sx) * 4 + (sy)]
+  int wd1 = abs(G(1, 1) - G(2, 2)) +
+            (abs(G(1, 0) - G(2, 1)) + abs(G(2, 1) - G(3, 2)) + abs(G(0, 1) - G(1, 2)) +
+             abs(G(1, 2) - G(2, 3))) -
+            (abs(G(1, 0) - G(3, 2)) + abs(G(0, 1) - G(2, 3)));
+  int wd2 = abs(G(2, 1) - G(1, 2)) +
+            (abs(G(2, 0) - G(1, 1)) + abs(G(1, 1) - G(0, 2)) + abs(G(1, 3) - G(2, 2)) +
+             abs(G(2, 2) - G(3, 1))) -
+            (abs(G(2, 0) - G(0, 2)) + abs(G(1, 3) - G(3, 1)));
+#undef G
+
+  return InterpolateCell(px, py, wd1, wd2, Unpack(CellTexel(cx, cy, 1, 1)),
+                         Unpack(CellTexel(cx, cy, 2, 1)), Unpack(CellTexel(cx, cy, 1, 2)),
+                         Unpack(CellTexel(cx, cy, 2, 2)));
+}
+
+void ScaleBlock()
+{
+  for (int y = 0; y < SCALE; y++)
+  {
+    for (int x = 0; x < SCALE; x++)
+      s_block[y * SCALE + x] = ScaleTexel(x, y);
+  }
+}
+)";
+
+static const char scaling_shader_main[] = R"(
+layout(local_size_x = GROUP_SIZE, local_size_y = GROUP_SIZE) in;
+
+void main()
+{
+  s_coords = ivec2(gl_GlobalInvocationID.xy);
+  if (s_coords.x >= int(u_src_size.x) || s_coords.y >= int(u_src_size.y))
+    return;
+
+  for (int y = -CACHE_RADIUS; y <= CACHE_RADIUS; y++)
+  {
+    for (int x = -CACHE_RADIUS; x <= CACHE_RADIUS; x++)
+    {
+      ivec2 coords = ClampToImage(s_coords + ivec2(x, y));
+      s_texels[(y + CACHE_RADIUS) * CACHE_SIZE + x + CACHE_RADIUS] =
+          packUnorm4x8(texelFetch(s_input_image, ivec3(coords, 0), 0));
+    }
+  }
+
+  ScaleBlock();
+
+  for (int y = 0; y < SCALE; y++)
+  {
+    for (int x = 0; x < SCALE; x++)
+    {
+      imageStore(output_image, ivec3(s_coords * SCALE + ivec2(x, y), 0),
+                 unpackUnorm4x8(s_block[y * SCALE + x]));
+    }
+  }
+}
+)";
+
+bool IsScalingSupported(int scaling_type, int factor)
+{
+	if (factor < 2 || factor > 5)
+		return false;
+
+	switch (scaling_type)
+	{
+	case TextureScaler::XBRZ:
+	case TextureScaler::HYBRID:
+	case TextureScaler::DDT:
+	case TextureScaler::DDT_SHARP:
+		return true;
+	default:
+		return false;
+	}
+}
+
+std::pair<u32, u32> GetDispatchCount(u32 width, u32 height)
+{
+	return { (width + (GROUP_SIZE - 1)) / GROUP_SIZE, (height + (GROUP_SIZE - 1)) / GROUP_SIZE };
+}
+
+std::string GenerateScalingShader(int scaling_type, int factor, API_TYPE ApiType)
+{
+	if (!IsScalingSupported(scaling_type, factor))
+		return "";
+
+	int cache_radius;
+	switch (scaling_type)
+	{
+	case TextureScaler::HYBRID:
+		// The splatted masks of the neighbours reach three texels away.
+		cache_radius = 3;
+		break;
+	case TextureScaler::DDT:
+		cache_radius = 1;
+		break;
+	default:
+		cache_radius = 2;
+		break;
+	}
+
+	std::stringstream ss;
+	ss << "#define SCALE " << factor << "\n";
+	ss << "#define CACHE_RADIUS " << cache_radius << "\n";
+	ss << "#define GROUP_SIZE " << GROUP_SIZE << "\n";
+	ss << scaling_shader_header;
+	ss << scaling_shader_common;
+	switch (scaling_type)
+	{
+	case TextureScaler::XBRZ:
+		ss << xbrz_shader_body;
+		ss << "void ScaleBlock()\n{\n  ScaleXBRZ();\n}\n";
+		break;
+	case TextureScaler::HYBRID:
+		ss << xbrz_shader_body;
+		ss << hybrid_shader_body;
+		break;
+	case TextureScaler::DDT:
+		ss << ddt_shader_common;
+		ss << ddt_shader_body;
+		break;
+	case TextureScaler::DDT_SHARP:
+		ss << ddt_shader_common;
+		ss << ddt_sharp_shader_body;
+		break;
+	}
+	ss << scaling_shader_main;
+
+	return ss.str();
+}
+
+}  // namespace
@@ -0,0 +1,32 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/VideoCommon.h"
+
+// Compute shader versions of the TextureScaler filters.
+// The shaders read the decoded RGBA8 texture at its native size from s_input_image and write the
+// upscaled texture to output_image. They follow the CPU scaler, with the DDT filters following
+// its SSE4.1 path, but the blending that runs in float here runs in double there, so texels can
+// differ slightly.
+namespace TextureScalerShader
+{
+// One invocation scales one source texel, this is the group size in each dimension.
+static const u32 GROUP_SIZE = 8;
+
+// Returns true if the scaling type (TextureScaler::XBRZ, ...) has a shader for the factor.
+bool IsScalingSupported(int scaling_type, int factor);
+
+// Determine how many thread groups should be dispatched for a source image of the specified size.
+// First is the number of X groups, second is the number of Y groups, Z is always one.
+std::pair<u32, u32> GetDispatchCount(u32 width, u32 height);
+
+// Returns the GLSL string containing the scaling shader, or an empty string if unsupported.
+std::string GenerateScalingShader(int scaling_type, int factor, API_TYPE ApiType = API_OPENGL);
+}
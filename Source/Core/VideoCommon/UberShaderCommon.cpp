@@ -0,0 +1,54 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/UberShaderCommon.h"
+
+namespace UberShader
+{
+static const char s_uber_constants[] = R"(
+UBO_BINDING(std140, 4) uniform UBERBlock {
+	uint bpmem_genmode;
+	uint bpmem_alphatest;
+	uint bpmem_fogparam3;
+	uint bpmem_fogrange;
+	uint bpmem_ztex2;
+	uint bpmem_tevindref;
+	uint uber_flags;
+	uint uber_pad0;
+	uint xfmem_components;
+	uint xfmem_numcolorchans;
+	uint xfmem_numtexgens;
+	uint xfmem_dualtextrans;
+	uint4 bpmem_tevorder[2];
+	uint4 bpmem_tevksel[2];
+	uint4 bpmem_combiners[16];
+	uint4 xfmem_chancontrol;
+	uint4 xfmem_texgen[8];
+};
+
+#define BITS(x, offset, count) bitfieldExtract(uint(x), int(offset), int(count))
+#define BIT(x, offset) (bitfieldExtract(uint(x), int(offset), 1) != 0u)
+
+uint GetTevOrder(uint stage)
+{
+	uint word = bpmem_tevorder[stage >> 3u][(stage >> 1u) & 3u];
+	return BITS(word, (stage & 1u) * 12u, 12u);
+}
+uint GetTevKSel(uint index)
+{
+	return bpmem_tevksel[index >> 2u][index & 3u];
+}
+)";
+
+void WriteUberShaderConstants(ShaderCode& out)
+{
+	out.Write("%s", s_uber_constants);
+	out.Write("#define UBER_FLAG_EARLY_ZTEST %uu\n", FLAG_EARLY_ZTEST);
+	out.Write("#define UBER_FLAG_LATE_ZTEST %uu\n", FLAG_LATE_ZTEST);
+	out.Write("#define UBER_FLAG_RGBA6_FORMAT %uu\n", FLAG_RGBA6_FORMAT);
+	out.Write("#define UBER_FLAG_DITHER %uu\n", FLAG_DITHER);
+	out.Write("#define UBER_FLAG_ZCOMPLOC_HACK %uu\n\n", FLAG_ZCOMPLOC_HACK);
+}
+
+}  // namespace UberShader
@@ -0,0 +1,31 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/VideoCommon.h"
+
+#define UBERSHADERGEN_BUFFERSIZE 32768
+
+// Ubershaders interpret the TEV/XF state from UberShaderConstants at runtime instead of
+// baking it into the code, so a single shader covers every state. They are slower than
+// the specialized shaders and only drawn with while those are compiled in the background.
+namespace UberShader
+{
+// Bits of UberShaderConstants::flags
+enum : u32
+{
+	FLAG_EARLY_ZTEST = 1 << 0,
+	FLAG_LATE_ZTEST = 1 << 1,
+	FLAG_RGBA6_FORMAT = 1 << 2,
+	FLAG_DITHER = 1 << 3,
+	FLAG_ZCOMPLOC_HACK = 1 << 4,
+};
+
+// Declares the UBERBlock uniform buffer and the accessors for the raw register bitfields.
+void WriteUberShaderConstants(ShaderCode& out);
+
+}  // namespace UberShader
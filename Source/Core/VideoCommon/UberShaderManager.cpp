@@ -0,0 +1,85 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/UberShaderCommon.h"
+#include "VideoCommon/UberShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/XFMemory.h"
+
+alignas(256) UberShaderConstants UberShaderManager::constants;
+bool UberShaderManager::dirty;
+
+void UberShaderManager::Init()
+{
+	constants = {};
+	dirty = true;
+}
+
+void UberShaderManager::Shutdown()
+{}
+
+void UberShaderManager::Dirty()
+{
+	dirty = true;
+}
+
+void UberShaderManager::SetConstants(u32 components)
+{
+	UberShaderConstants state = {};
+	state.genmode = bpmem.genMode.hex;
+	state.alphatest = bpmem.alpha_test.hex;
+	state.fogparam3 = bpmem.fog.c_proj_fsel.hex;
+	state.fogrange = bpmem.fogRange.Base.hex;
+	state.ztex2 = bpmem.ztex2.hex;
+	state.tevindref = bpmem.tevindref.hex;
+
+	if (bpmem.UseEarlyDepthTest())
+		state.flags |= UberShader::FLAG_EARLY_ZTEST;
+	if (bpmem.UseLateDepthTest())
+		state.flags |= UberShader::FLAG_LATE_ZTEST;
+	if (!g_ActiveConfig.bForceTrueColor && bpmem.zcontrol.pixel_format != PEControl::RGB8_Z24)
+	{
+		state.flags |= UberShader::FLAG_RGBA6_FORMAT;
+		if (bpmem.blendmode.dither)
+			state.flags |= UberShader::FLAG_DITHER;
+	}
+	if (bpmem.UseEarlyDepthTest() && bpmem.zmode.updateenable &&
+		!g_ActiveConfig.backend_info.bSupportsEarlyZ && !bpmem.genMode.zfreeze)
+	{
+		state.flags |= UberShader::FLAG_ZCOMPLOC_HACK;
+	}
+
+	state.components = components;
+	state.numcolorchans = xfmem.numChan.numColorChans;
+	state.numtexgens = xfmem.numTexGen.numTexGens;
+	state.dualtextrans = xfmem.dualTexTrans.enabled;
+
+	for (int i = 0; i < 8; i++)
+	{
+		state.tevorder[i] = bpmem.tevorders[i].hex;
+		state.tevksel[i] = bpmem.tevksel[i].hex;
+		state.texgen[i][0] = xfmem.texMtxInfo[i].hex;
+		state.texgen[i][1] = xfmem.postMtxInfo[i].hex;
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		state.combiners[i][0] = bpmem.combiners[i].colorC.hex;
+		state.combiners[i][1] = bpmem.combiners[i].alphaC.hex;
+		state.combiners[i][2] = bpmem.tevind[i].hex;
+	}
+	state.chancontrol[0] = xfmem.color[0].hex;
+	state.chancontrol[1] = xfmem.color[1].hex;
+	state.chancontrol[2] = xfmem.alpha[0].hex;
+	state.chancontrol[3] = xfmem.alpha[1].hex;
+
+	if (memcmp(&state, &constants, sizeof(constants)) != 0)
+	{
+		constants = state;
+		dirty = true;
+	}
+}
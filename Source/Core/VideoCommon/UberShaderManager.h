@@ -0,0 +1,32 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ConstantManager.h"
+
+// Mirrors the TEV/XF state into the constant buffer of the ubershaders.
+// The state is not tracked register by register, the backends only call SetConstants
+// while they draw with the ubershaders.
+class UberShaderManager
+{
+	static bool dirty;
+public:
+	static void Init();
+	static void Dirty();
+	static inline bool IsDirty()
+	{
+		return dirty;
+	}
+	static inline void Clear()
+	{
+		dirty = false;
+	}
+	static void Shutdown();
+
+	static void SetConstants(u32 components);
+
+	alignas(256) static UberShaderConstants constants;
+};
@@ -0,0 +1,563 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/MsgHandler.h"
+
+#include "VideoCommon/DriverDetails.h"
+#include "VideoCommon/UberShaderCommon.h"
+#include "VideoCommon/UberShaderPixel.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace UberShader
+{
+void GetPixelShaderUid(PixelShaderUid& object, const pixel_shader_uid_data& ps_uid_data)
+{
+	object.ClearUID();
+	pixel_ubershader_uid_data& uid_data = object.GetUidData<pixel_ubershader_uid_data>();
+	uid_data.render_mode = ps_uid_data.render_mode;
+	uid_data.per_pixel_depth = ps_uid_data.per_pixel_depth;
+	uid_data.forced_early_z = ps_uid_data.forced_early_z;
+	uid_data.fast_depth_calc = ps_uid_data.fast_depth_calc;
+	uid_data.msaa = ps_uid_data.msaa;
+	uid_data.ssaa = ps_uid_data.ssaa;
+	object.CalculateUIDHash();
+}
+
+// Same math as the integer path of the specialized pixel shaders, see PixelShaderGen.cpp.
+static const char s_pixel_helpers[] = R"(
+int idot(int3 x, int3 y)
+{
+	int3 tmp = x * y;
+	return tmp.x + tmp.y + tmp.z;
+}
+int idot(int4 x, int4 y)
+{
+	int4 tmp = x * y;
+	return tmp.x + tmp.y + tmp.z + tmp.w;
+}
+int iround(float x)
+{
+	return int(round(x));
+}
+int4 iround(float4 x)
+{
+	return int4(round(x));
+}
+int2 BSH(int2 x, int n)
+{
+	return n >= 0 ? (x >> n) : (x << (-n));
+}
+
+const int konst_table[8] = int[8](255, 223, 191, 159, 128, 96, 64, 32);
+const int ind_alpha_mask[4] = int[4](248, 224, 240, 248);
+const int ind_fmt_mask[4] = int[4](255, 31, 15, 7);
+const int ind_wrap_start[8] = int[8](0, 32768, 16384, 8192, 4096, 2048, 1, 1);
+const int bayer[16] = int[16](-7, 1, -5, 3, 5, -3, 7, -1, -4, 4, -6, 2, 8, 0, 6, -2);
+
+int3 GetKonstColor(uint ksel)
+{
+	if (ksel < 8u)
+		return int3(konst_table[ksel]);
+	if (ksel < 12u)
+		return int3(0);
+	if (ksel < 16u)
+		return k[ksel - 12u].rgb;
+	return int3(k[ksel & 3u][(ksel - 16u) >> 2u]);
+}
+int GetKonstAlpha(uint ksel)
+{
+	if (ksel < 8u)
+		return konst_table[ksel];
+	if (ksel < 16u)
+		return 0;
+	return k[ksel & 3u][(ksel - 16u) >> 2u];
+}
+
+int4 Swizzle(uint swap, int4 color)
+{
+	uint ksel0 = GetTevKSel(swap * 2u);
+	uint ksel1 = GetTevKSel(swap * 2u + 1u);
+	return int4(color[BITS(ksel0, 0, 2)], color[BITS(ksel0, 2, 2)],
+	            color[BITS(ksel1, 0, 2)], color[BITS(ksel1, 2, 2)]);
+}
+
+int3 SelectColorInput(int4 s[4], int4 tex, int4 ras, int3 konst, uint index)
+{
+	if (index < 8u)
+		return (index & 1u) == 0u ? s[index >> 1u].rgb : s[index >> 1u].aaa;
+	switch (index)
+	{
+	case 8u: return tex.rgb;
+	case 9u: return tex.aaa;
+	case 10u: return ras.rgb;
+	case 11u: return ras.aaa;
+	case 12u: return int3(255);
+	case 13u: return int3(128);
+	case 14u: return konst;
+	default: return int3(0);
+	}
+}
+int SelectAlphaInput(int4 s[4], int4 tex, int4 ras, int konst, uint index)
+{
+	if (index < 4u)
+		return s[index].a;
+	switch (index)
+	{
+	case 4u: return tex.a;
+	case 5u: return ras.a;
+	case 6u: return konst;
+	default: return 0;
+	}
+}
+
+// (d + bias + lerp(a,b,c)) * scale, in the order the hardware does it.
+int3 TevRegular(int3 a, int3 b, int3 c, int3 d, uint bias, bool sub, uint shift, bool alpha)
+{
+	c += c >> 7;
+	int3 bias_value = int3(bias == 1u ? 128 : (bias == 2u ? -128 : 0));
+	int sl = shift < 3u ? int(shift) : 0;
+	int lb = ((shift == 3u) == alpha) ? (sub ? 127 : 128) : 0;
+	int3 lerp_value = ((((a << 8) + (b - a) * c) << sl) + lb) >> 8;
+	int3 base = (d + bias_value) << sl;
+	int3 result = sub ? (base - lerp_value) : (base + lerp_value);
+	return shift == 3u ? (result >> 1) : result;
+}
+
+int3 TevCompareColor(int4 a, int4 b, int3 c, int3 d, uint cmp)
+{
+	const int3 c16 = int3(1, 256, 0);
+	const int3 c24 = int3(1, 256, 65536);
+	switch (cmp)
+	{
+	case 0u: return d + ((a.r > b.r) ? c : int3(0));
+	case 1u: return d + ((a.r == b.r) ? c : int3(0));
+	case 2u: return d + ((idot(a.rgb, c16) > idot(b.rgb, c16)) ? c : int3(0));
+	case 3u: return d + ((idot(a.rgb, c16) == idot(b.rgb, c16)) ? c : int3(0));
+	case 4u: return d + ((idot(a.rgb, c24) > idot(b.rgb, c24)) ? c : int3(0));
+	case 5u: return d + ((idot(a.rgb, c24) == idot(b.rgb, c24)) ? c : int3(0));
+	case 6u: return d + int3(greaterThan(a.rgb, b.rgb)) * c;
+	default: return d + int3(equal(a.rgb, b.rgb)) * c;
+	}
+}
+int TevCompareAlpha(int4 a, int4 b, int c, int d, uint cmp)
+{
+	const int3 c16 = int3(1, 256, 0);
+	const int3 c24 = int3(1, 256, 65536);
+	switch (cmp)
+	{
+	case 0u: return d + ((a.r > b.r) ? c : 0);
+	case 1u: return d + ((a.r == b.r) ? c : 0);
+	case 2u: return d + ((idot(a.rgb, c16) > idot(b.rgb, c16)) ? c : 0);
+	case 3u: return d + ((idot(a.rgb, c16) == idot(b.rgb, c16)) ? c : 0);
+	case 4u: return d + ((idot(a.rgb, c24) > idot(b.rgb, c24)) ? c : 0);
+	case 5u: return d + ((idot(a.rgb, c24) == idot(b.rgb, c24)) ? c : 0);
+	case 6u: return d + ((a.a > b.a) ? c : 0);
+	default: return d + ((a.a == b.a) ? c : 0);
+	}
+}
+
+bool AlphaCompare(int a, int ref, uint comp)
+{
+	switch (comp)
+	{
+	case 0u: return false;
+	case 1u: return a < ref;
+	case 2u: return a == ref;
+	case 3u: return a <= ref;
+	case 4u: return a > ref;
+	case 5u: return a != ref;
+	case 6u: return a >= ref;
+	default: return true;
+	}
+}
+bool AlphaTest(int a)
+{
+	bool comp0 = AlphaCompare(a, alphaRef.r, BITS(bpmem_alphatest, 16, 3));
+	bool comp1 = AlphaCompare(a, alphaRef.g, BITS(bpmem_alphatest, 19, 3));
+	switch (BITS(bpmem_alphatest, 22, 2))
+	{
+	case 0u: return comp0 && comp1;
+	case 1u: return comp0 || comp1;
+	case 2u: return comp0 != comp1;
+	default: return comp0 == comp1;
+	}
+}
+)";
+
+// Runs every TEV stage from the raw combiner registers, leaving the result in prev and
+// the swizzled texture color of the last stage in tex_t for the z texture.
+static const char s_tev_stages[] = R"(
+	uint num_stages = BITS(bpmem_genmode, 10, 4) + 1u;
+	uint num_texgens = BITS(bpmem_genmode, 0, 4);
+	uint num_ind_stages = BITS(bpmem_genmode, 16, 3);
+
+	float3 uv[8];
+	for (uint i = 0u; i < 8u; i++)
+	{
+		if (i < num_texgens)
+		{
+			uv[i] = tex[i];
+			uv[i].xy = uv[i].xy / ((uv[i].z == 0.0) ? 2.0 : uv[i].z);
+			uv[i].xy = trunc(uv[i].xy * texdim[i].zw);
+		}
+		else
+		{
+			uv[i] = float3(0.0, 0.0, 0.0);
+		}
+	}
+
+	int3 indtex[4];
+	for (uint i = 0u; i < 4u; i++)
+	{
+		indtex[i] = int3(0, 0, 0);
+		if (i >= num_ind_stages)
+			continue;
+		uint texcoord = BITS(bpmem_tevindref, i * 6u + 3u, 3);
+		uint texmap = BITS(bpmem_tevindref, i * 6u, 3);
+		int2 scale = (i & 1u) != 0u ? cindscale[i >> 1u].zw : cindscale[i >> 1u].xy;
+		int2 t_coord = texcoord < num_texgens ? (int2(uv[texcoord].xy) >> scale) : int2(0, 0);
+		indtex[i] = SampleTexture(texmap, t_coord).abg;
+	}
+
+	int4 s[4];
+	s[0] = color[0];
+	s[1] = color[1];
+	s[2] = color[2];
+	s[3] = color[3];
+	int4 col0 = iround(colors_0 * 255.0);
+	int4 col1 = iround(colors_1 * 255.0);
+	int4 tex_t = int4(0, 0, 0, 0);
+	int2 tevcoord = int2(0, 0);
+	int a_bump = 0;
+	uint last_color_dest = 0u;
+	uint last_alpha_dest = 0u;
+
+	for (uint n = 0u; n < num_stages; n++)
+	{
+		uint order = GetTevOrder(n);
+		uint cc = bpmem_combiners[n].x;
+		uint ac = bpmem_combiners[n].y;
+		uint tevind = bpmem_combiners[n].z;
+
+		// HACK to handle cases where the tex gen is not enabled, same as GetPixelShaderUID
+		uint texcoord = BITS(order, 3, 3);
+		if (texcoord >= num_texgens)
+			texcoord = 0u;
+		bool has_texcoord = texcoord < num_texgens;
+
+		// indirect op
+		uint bt = BITS(tevind, 0, 2);
+		if (bt < num_ind_stages)
+		{
+			uint fmt = BITS(tevind, 2, 2);
+			uint bias = BITS(tevind, 4, 3);
+			uint bs = BITS(tevind, 7, 2);
+			uint mid = BITS(tevind, 9, 4);
+			uint sw = BITS(tevind, 13, 3);
+			uint tw = BITS(tevind, 16, 3);
+
+			if (bs != 0u)
+				a_bump = indtex[bt][bs - 1u] & ind_alpha_mask[fmt];
+
+			int2 trans = int2(0, 0);
+			if (mid != 0u)
+			{
+				int3 crd = indtex[bt] & ind_fmt_mask[fmt];
+				int bias_add = fmt == 0u ? -128 : 1;
+				if ((bias & 1u) != 0u)
+					crd.x += bias_add;
+				if ((bias & 2u) != 0u)
+					crd.y += bias_add;
+				if ((bias & 4u) != 0u)
+					crd.z += bias_add;
+
+				if (mid <= 3u)
+				{
+					uint mtx = 2u * (mid - 1u);
+					trans = int2(idot(cindmtx[mtx].xyz, crd), idot(cindmtx[mtx + 1u].xyz, crd)) >> 3;
+					trans = BSH(trans, cindmtx[mtx].w);
+				}
+				else if (mid >= 5u && mid <= 7u && has_texcoord)
+				{
+					trans = int2(uv[texcoord].xy * float2(crd.xx)) >> 8;
+					trans = BSH(trans, cindmtx[2u * (mid - 5u)].w);
+				}
+				else if (mid >= 9u && mid <= 11u && has_texcoord)
+				{
+					trans = int2(uv[texcoord].xy * float2(crd.yy)) >> 8;
+					trans = BSH(trans, cindmtx[2u * (mid - 9u)].w);
+				}
+			}
+
+			int2 wrapped = int2(uv[texcoord].xy);
+			if (sw == 6u)
+				wrapped.x = 0;
+			else if (sw != 0u)
+				wrapped.x = wrapped.x & (ind_wrap_start[sw] - 1);
+			if (tw == 6u)
+				wrapped.y = 0;
+			else if (tw != 0u)
+				wrapped.y = wrapped.y & (ind_wrap_start[tw] - 1);
+
+			if (BIT(tevind, 20))
+				tevcoord += wrapped + trans;
+			else
+				tevcoord = wrapped + trans;
+			// Emulate s24 overflows
+			tevcoord = (tevcoord << 8) >> 8;
+		}
+		else
+		{
+			tevcoord = has_texcoord ? int2(uv[texcoord].xy) : int2(0, 0);
+		}
+
+		int4 tex_color = int4(255, 255, 255, 255);
+		if (BIT(order, 6))
+			tex_color = SampleTexture(BITS(order, 0, 3), tevcoord);
+		tex_t = Swizzle(BITS(ac, 2, 2), tex_color);
+
+		int4 ras;
+		switch (BITS(order, 7, 3))
+		{
+		case 0u: ras = col0; break;
+		case 1u: ras = col1; break;
+		case 5u: ras = int4(a_bump, a_bump, a_bump, a_bump); break;
+		case 6u: ras = int4(a_bump | (a_bump >> 5)); break;
+		default: ras = int4(0, 0, 0, 0); break;
+		}
+		ras = Swizzle(BITS(ac, 0, 2), ras);
+
+		uint ksel = GetTevKSel(n >> 1u);
+		int3 konst_c = GetKonstColor((n & 1u) != 0u ? BITS(ksel, 14, 5) : BITS(ksel, 4, 5));
+		int konst_a = GetKonstAlpha((n & 1u) != 0u ? BITS(ksel, 19, 5) : BITS(ksel, 9, 5));
+
+		int4 tin_a = int4(SelectColorInput(s, tex_t, ras, konst_c, BITS(cc, 12, 4)),
+		                  SelectAlphaInput(s, tex_t, ras, konst_a, BITS(ac, 13, 3))) & 255;
+		int4 tin_b = int4(SelectColorInput(s, tex_t, ras, konst_c, BITS(cc, 8, 4)),
+		                  SelectAlphaInput(s, tex_t, ras, konst_a, BITS(ac, 10, 3))) & 255;
+		int4 tin_c = int4(SelectColorInput(s, tex_t, ras, konst_c, BITS(cc, 4, 4)),
+		                  SelectAlphaInput(s, tex_t, ras, konst_a, BITS(ac, 7, 3))) & 255;
+		int4 tin_d = int4(SelectColorInput(s, tex_t, ras, konst_c, BITS(cc, 0, 4)),
+		                  SelectAlphaInput(s, tex_t, ras, konst_a, BITS(ac, 4, 3)));
+
+		// color combine
+		int3 color_result;
+		uint color_shift = BITS(cc, 20, 2);
+		if (BITS(cc, 16, 2) != 3u)
+			color_result = TevRegular(tin_a.rgb, tin_b.rgb, tin_c.rgb, tin_d.rgb, BITS(cc, 16, 2), BIT(cc, 18), color_shift, false);
+		else
+			color_result = TevCompareColor(tin_a, tin_b, tin_c.rgb, tin_d.rgb, (color_shift << 1) | BITS(cc, 18, 1));
+		color_result = BIT(cc, 19) ? clamp(color_result, 0, 255) : clamp(color_result, -1024, 1023);
+
+		// alpha combine
+		int alpha_result;
+		uint alpha_shift = BITS(ac, 20, 2);
+		if (BITS(ac, 16, 2) != 3u)
+			alpha_result = TevRegular(int3(tin_a.a), int3(tin_b.a), int3(tin_c.a), int3(tin_d.a), BITS(ac, 16, 2), BIT(ac, 18), alpha_shift, true).x;
+		else
+			alpha_result = TevCompareAlpha(tin_a, tin_b, tin_c.a, tin_d.a, (alpha_shift << 1) | BITS(ac, 18, 1));
+		alpha_result = BIT(ac, 19) ? clamp(alpha_result, 0, 255) : clamp(alpha_result, -1024, 1023);
+
+		last_color_dest = BITS(cc, 22, 2);
+		last_alpha_dest = BITS(ac, 22, 2);
+		s[last_color_dest].rgb = color_result;
+		s[last_alpha_dest].a = alpha_result;
+	}
+
+	// The results of the last texenv stage are put onto the screen,
+	// regardless of the used destination register
+	int4 prev = int4(s[last_color_dest].rgb, s[last_alpha_dest].a) & 255;
+)";
+
+void GeneratePixelShaderCode(ShaderCode& out, const pixel_ubershader_uid_data& uid_data, API_TYPE api_type)
+{
+	char* codebuffer = out.GetBuffer();
+	codebuffer[UBERSHADERGEN_BUFFERSIZE - 1] = 0x7C;  // canary
+	const PIXEL_SHADER_RENDER_MODE render_mode = static_cast<PIXEL_SHADER_RENDER_MODE>(uid_data.render_mode);
+	const bool per_pixel_depth = uid_data.per_pixel_depth != 0;
+	const char* depth_sign = api_type == API_OPENGL ? "" : "1.0 - ";
+
+	out.Write("// Pixel UberShader\n");
+	if (api_type == API_VULKAN)
+	{
+		for (u32 i = 0; i < 8; i++)
+			out.Write("SAMPLER_BINDING(%u) uniform sampler2DArray samp%u;\n", i, i);
+	}
+	else
+	{
+		out.Write("SAMPLER_BINDING(0) uniform sampler2DArray samp[8];\n");
+	}
+	out.Write("\n");
+
+	// Same layout as the specialized shaders, the constants are shared.
+	out.Write("UBO_BINDING(std140, 1) uniform PSBlock {\n"
+		"\tint4 " I_COLORS "[4];\n"
+		"\tint4 " I_KCOLORS "[4];\n"
+		"\tint4 " I_ALPHA ";\n"
+		"\tfloat4 " I_TEXDIMS "[8];\n"
+		"\tint4 " I_ZBIAS "[2];\n"
+		"\tint4 " I_INDTEXSCALE "[2];\n"
+		"\tint4 " I_INDTEXMTX "[6];\n"
+		"\tint4 " I_FOGCOLOR ";\n"
+		"\tint4 " I_FOGI ";\n"
+		"\tfloat4 " I_FOGF "[2];\n"
+		"\tfloat4 " I_ZSLOPE ";\n"
+		"\tint4 " I_FLAGS ";\n"
+		"\tfloat4 " I_EFBSCALE ";\n"
+		"};\n");
+	WriteUberShaderConstants(out);
+
+	if (render_mode == PSRM_DUAL_SOURCE_BLEND)
+	{
+		if (DriverDetails::HasBug(DriverDetails::BUG_BROKEN_FRAGMENT_SHADER_INDEX_DECORATION))
+		{
+			out.Write("FRAGMENT_OUTPUT_LOCATION(0) out vec4 ocol0;\n");
+			out.Write("FRAGMENT_OUTPUT_LOCATION(1) out vec4 ocol1;\n");
+		}
+		else
+		{
+			out.Write("FRAGMENT_OUTPUT_LOCATION_INDEXED(0, 0) out vec4 ocol0;\n");
+			out.Write("FRAGMENT_OUTPUT_LOCATION_INDEXED(0, 1) out vec4 ocol1;\n");
+		}
+	}
+	else
+	{
+		out.Write("FRAGMENT_OUTPUT_LOCATION(0) out vec4 ocol0;\n");
+	}
+	if (per_pixel_depth)
+		out.Write("#define depth gl_FragDepth\n");
+
+	const char* qualifier = GetInterpolationQualifier(api_type, uid_data.msaa, uid_data.ssaa, true, true);
+	out.Write("VARYING_LOCATION(0) in VertexData {\n");
+	out.Write("\t%s float4 colors_0;\n", qualifier);
+	out.Write("\t%s float4 colors_1;\n", qualifier);
+	out.Write("\t%s float3 tex[8];\n", qualifier);
+	out.Write("\t%s float4 clipPos;\n", qualifier);
+	if (g_ActiveConfig.backend_info.bSupportsDepthClamp)
+		out.Write("\t%s float2 clipDist;\n", qualifier);
+	out.Write("};\n");
+	if (uid_data.forced_early_z)
+		out.Write("FORCE_EARLY_Z\n");
+	out.Write("%s", s_pixel_helpers);
+
+	// The sampler can't be picked with a variable index from individual bindings.
+	out.Write("int4 SampleTexture(uint texmap, int2 coord)\n{\n");
+	out.Write("\tfloat3 coords = float3(float2(coord) * " I_TEXDIMS "[texmap].xy, 0.0);\n");
+	if (api_type == API_VULKAN)
+	{
+		out.Write("\tswitch (texmap)\n\t{\n");
+		for (u32 i = 0; i < 7; i++)
+			out.Write("\tcase %uu: return iround(255.0 * texture(samp%u, coords));\n", i, i);
+		out.Write("\tdefault: return iround(255.0 * texture(samp7, coords));\n\t}\n");
+	}
+	else
+	{
+		out.Write("\treturn iround(255.0 * texture(samp[texmap], coords));\n");
+	}
+	out.Write("}\n\n");
+
+	out.Write("void main()\n{\n");
+	out.Write("\tfloat4 rawpos = gl_FragCoord;\n");
+
+	// Depth exactly like the specialized shaders (WritePerPixelDepth).
+	out.Write("\tint zCoord;\n");
+	out.Write("\tif (BIT(bpmem_genmode, 19))\n\t{\n");
+	out.Write("\t\tfloat2 screenpos = rawpos.xy * " I_EFBSCALE ".xy;\n");
+	if (api_type == API_OPENGL)
+		out.Write("\t\tscreenpos.y = %i.0 - screenpos.y;\n", EFB_HEIGHT);
+	out.Write("\t\tzCoord = int(" I_ZSLOPE ".z + " I_ZSLOPE ".x * screenpos.x + " I_ZSLOPE ".y * screenpos.y);\n");
+	out.Write("\t}\n\telse\n\t{\n");
+	if (uid_data.fast_depth_calc)
+		out.Write("\t\tzCoord = iround((%srawpos.z) * 16777216.0);\n", depth_sign);
+	else
+		out.Write("\t\tzCoord = " I_ZBIAS "[1].x + iround((clipPos.z / clipPos.w) * float(" I_ZBIAS "[1].y));\n");
+	out.Write("\t}\n");
+	out.Write("\tzCoord = clamp(zCoord, 0, 0xFFFFFF);\n");
+
+	if (render_mode == PSRM_DEPTH_ONLY)
+	{
+		if (per_pixel_depth)
+			out.Write("\tdepth = %s(float(zCoord) / 16777216.0);\n", depth_sign);
+		out.Write("\tocol0 = float4(0.0, 0.0, 0.0, 0.0);\n}\n");
+		if (codebuffer[UBERSHADERGEN_BUFFERSIZE - 1] != 0x7C)
+			PanicAlert("UberShader pixel generator - buffer too small, canary has been eaten!");
+		return;
+	}
+
+	out.Write("%s", s_tev_stages);
+
+	// NOTE: Fragment may not be discarded if alpha test always fails and early depth test is enabled
+	out.Write("\tif (!AlphaTest(prev.a))\n\t{\n");
+	out.Write("\t\tocol0 = float4(0.0, 0.0, 0.0, 0.0);\n");
+	if (render_mode == PSRM_DUAL_SOURCE_BLEND)
+		out.Write("\t\tocol1 = float4(0.0, 0.0, 0.0, 0.0);\n");
+	if (per_pixel_depth)
+		out.Write("\t\tdepth = %s;\n", api_type == API_OPENGL ? "1.0" : "0.0");
+	out.Write("\t\tif ((uber_flags & UBER_FLAG_ZCOMPLOC_HACK) == 0u)\n\t\t{\n");
+	out.Write("\t\t\tdiscard;\n\t\t\treturn;\n\t\t}\n\t}\n");
+
+	// Note: z-textures are not written to depth buffer if early depth test is used
+	if (per_pixel_depth)
+	{
+		out.Write("\tif ((uber_flags & UBER_FLAG_EARLY_ZTEST) != 0u)\n");
+		out.Write("\t\tdepth = %s(float(zCoord) / 16777216.0);\n", depth_sign);
+	}
+	out.Write("\tuint ztex_op = BITS(bpmem_ztex2, 2, 2);\n");
+	out.Write("\tif (ztex_op != 0u)\n\t{\n");
+	out.Write("\t\tzCoord = idot(" I_ZBIAS "[0].xyzw, tex_t.xyzw) + " I_ZBIAS "[1].w + (ztex_op == 1u ? zCoord : 0);\n");
+	out.Write("\t\tzCoord = zCoord & 0xFFFFFF;\n\t}\n");
+	if (per_pixel_depth)
+	{
+		out.Write("\tif ((uber_flags & UBER_FLAG_LATE_ZTEST) != 0u)\n");
+		out.Write("\t\tdepth = %s(float(zCoord) / 16777216.0);\n", depth_sign);
+	}
+
+	if (render_mode == PSRM_ALPHA_PASS)
+	{
+		out.Write("\tprev.a = " I_ALPHA ".a;\n");
+	}
+	else
+	{
+		out.Write("\tuint fog_fsel = BITS(bpmem_fogparam3, 21, 3);\n");
+		out.Write("\tif (fog_fsel != 0u)\n\t{\n");
+		out.Write("\t\tfloat ze;\n");
+		out.Write("\t\tif (!BIT(bpmem_fogparam3, 20))\n");
+		out.Write("\t\t\tze = (" I_FOGF "[1].x * 16777216.0) / float(" I_FOGI ".y - (zCoord >> " I_FOGI ".w));\n");
+		out.Write("\t\telse\n");
+		out.Write("\t\t\tze = " I_FOGF "[1].x * (float(zCoord) / 16777216.0);\n");
+		out.Write("\t\tif (BIT(bpmem_fogrange, 10))\n\t\t{\n");
+		out.Write("\t\t\tfloat x_adjust = (2.0 * (rawpos.x / " I_FOGF "[0].y)) - 1.0 - " I_FOGF "[0].x;\n");
+		out.Write("\t\t\tx_adjust = sqrt(x_adjust * x_adjust + " I_FOGF "[0].z * " I_FOGF "[0].z) / " I_FOGF "[0].z;\n");
+		out.Write("\t\t\tze *= x_adjust;\n\t\t}\n");
+		out.Write("\t\tfloat fog = clamp(ze - " I_FOGF "[1].z, 0.0, 1.0);\n");
+		out.Write("\t\tif (fog_fsel == 4u)\n\t\t\tfog = 1.0 - exp2(-8.0 * fog);\n");
+		out.Write("\t\telse if (fog_fsel == 5u)\n\t\t\tfog = 1.0 - exp2(-8.0 * fog * fog);\n");
+		out.Write("\t\telse if (fog_fsel == 6u)\n\t\t\tfog = exp2(-8.0 * (1.0 - fog));\n");
+		out.Write("\t\telse if (fog_fsel == 7u)\n\t\t{\n\t\t\tfog = 1.0 - fog;\n\t\t\tfog = exp2(-8.0 * fog * fog);\n\t\t}\n");
+		out.Write("\t\tint ifog = iround(fog * 256.0);\n");
+		out.Write("\t\tprev.rgb = (prev.rgb * (256 - ifog) + " I_FOGCOLOR ".rgb * ifog) >> 8;\n");
+		out.Write("\t}\n");
+	}
+
+	out.Write("\tif ((uber_flags & UBER_FLAG_RGBA6_FORMAT) != 0u)\n\t{\n");
+	out.Write("\t\tif ((uber_flags & UBER_FLAG_DITHER) != 0u)\n\t\t{\n");
+	out.Write("\t\t\tint2 ditherindex = int2(rawpos.xy) & 3;\n");
+	out.Write("\t\t\tprev.rgb = prev.rgb + bayer[ditherindex.y * 4 + ditherindex.x];\n\t\t}\n");
+	out.Write("\t\tprev = clamp(prev, 0, 255) & 252;\n\t}\n");
+
+	// Use dual-source color blending to perform dst alpha in a single pass
+	if (render_mode == PSRM_DUAL_SOURCE_BLEND)
+	{
+		out.Write("\tocol1 = float4(prev) * (1.0 / 255.0);\n");
+		out.Write("\tprev.a = " I_ALPHA ".a;\n");
+		out.Write("\tif ((uber_flags & UBER_FLAG_RGBA6_FORMAT) != 0u)\n\t\tprev.a = prev.a & 252;\n");
+	}
+	out.Write("\tocol0 = float4(prev) * (1.0 / 255.0);\n");
+	out.Write("}\n");
+
+	if (codebuffer[UBERSHADERGEN_BUFFERSIZE - 1] != 0x7C)
+		PanicAlert("UberShader pixel generator - buffer too small, canary has been eaten!");
+}
+
+}  // namespace UberShader
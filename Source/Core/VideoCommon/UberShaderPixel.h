@@ -0,0 +1,45 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/VideoCommon.h"
+
+namespace UberShader
+{
+#pragma pack(1)
+// Only the state that can't be read from the registers at runtime goes into the uid,
+// everything else is taken from UberShaderConstants.
+struct pixel_ubershader_uid_data
+{
+	u32 NumValues() const
+	{
+		return sizeof(pixel_ubershader_uid_data);
+	}
+	u32 StartValue() const
+	{
+		return 0;
+	}
+
+	void ClearUnused(){}
+
+	u32 render_mode : 2;
+	u32 per_pixel_depth : 1;
+	u32 forced_early_z : 1;
+	u32 fast_depth_calc : 1;
+	u32 msaa : 1;
+	u32 ssaa : 1;
+	u32 pad : 25;
+};
+#pragma pack()
+typedef ShaderUid<pixel_ubershader_uid_data> PixelShaderUid;
+
+void GetPixelShaderUid(PixelShaderUid& object, const pixel_shader_uid_data& ps_uid_data);
+
+void GeneratePixelShaderCode(ShaderCode& object, const pixel_ubershader_uid_data& uid_data, API_TYPE api_type);
+
+}  // namespace UberShader
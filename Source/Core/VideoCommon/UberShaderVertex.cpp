@@ -0,0 +1,349 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/MsgHandler.h"
+
+#include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/UberShaderCommon.h"
+#include "VideoCommon/UberShaderVertex.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace UberShader
+{
+void GetVertexShaderUid(VertexShaderUid& object, const vertex_shader_uid_data& vs_uid_data)
+{
+	object.ClearUID();
+	vertex_ubershader_uid_data& uid_data = object.GetUidData<vertex_ubershader_uid_data>();
+	uid_data.msaa = vs_uid_data.msaa;
+	uid_data.ssaa = vs_uid_data.ssaa;
+	object.CalculateUIDHash();
+}
+
+// Lighting and texgen of the specialized vertex shaders (LightingShaderGen.h, VertexShaderGen.cpp)
+// with the channel and texgen registers read from the UBERBlock.
+static const char s_vertex_helpers[] = R"(
+bool HasComponent(uint mask)
+{
+	return (xfmem_components & mask) != 0u;
+}
+
+float4 GetRawTex(uint index)
+{
+	switch (index)
+	{
+	case 0u: return float4(tex0, 1.0);
+	case 1u: return float4(tex1, 1.0);
+	case 2u: return float4(tex2, 1.0);
+	case 3u: return float4(tex3, 1.0);
+	case 4u: return float4(tex4, 1.0);
+	case 5u: return float4(tex5, 1.0);
+	case 6u: return float4(tex6, 1.0);
+	default: return float4(tex7, 1.0);
+	}
+}
+
+// Rounded vertex color of a channel, used when the material or ambient comes from the vertex.
+float4 GetVertexColor(uint chan)
+{
+	if (HasComponent(VB_HAS_COL0 << chan))
+		return round((chan == 0u ? color0 : color1) * 255.0);
+	if (HasComponent(VB_HAS_COL0))
+		return round(color0 * 255.0);
+	return float4(255.0, 255.0, 255.0, 255.0);
+}
+
+float4 CalculateLight(uint chan, uint light, float3 pos, float3 _norm0)
+{
+	uint diffusefunc = BITS(chan, 7, 2);
+	uint attnfunc = BITS(chan, 9, 2);
+	uint index = 5u * light;
+	float3 ldir = clights[index + 3u].xyz - pos;
+	float attn;
+	if (attnfunc == 1u)
+	{
+		// LIGHTATTN_SPEC
+		ldir = normalize(ldir);
+		attn = (dot(_norm0, ldir) >= 0.0) ? max(0.0, dot(_norm0, clights[index + 4u].xyz)) : 0.0;
+		float3 distatt = diffusefunc == 0u ? clights[index + 2u].xyz : normalize(clights[index + 2u].xyz);
+		attn = max(0.0, dot(clights[index + 1u].xyz, float3(1.0, attn, attn * attn))) / dot(distatt, float3(1.0, attn, attn * attn));
+	}
+	else if (attnfunc == 3u)
+	{
+		// LIGHTATTN_SPOT
+		float dist2 = dot(ldir, ldir);
+		float dist = sqrt(dist2);
+		ldir = ldir / dist;
+		attn = max(0.0, dot(ldir, clights[index + 4u].xyz));
+		// attn*attn may overflow
+		attn = max(0.0, dot(clights[index + 1u].xyz, float3(1.0, attn, attn * attn))) / dot(clights[index + 2u].xyz, float3(1.0, dist, dist2));
+	}
+	else
+	{
+		// LIGHTATTN_NONE, LIGHTATTN_DIR
+		ldir = normalize(ldir);
+		attn = 1.0;
+		if (length(ldir) == 0.0)
+			ldir = _norm0;
+	}
+
+	if (diffusefunc == 0u)
+		return round(attn * clights[index]);
+	float diffuse = dot(ldir, _norm0);
+	if (diffusefunc == 2u)
+		diffuse = max(0.0, diffuse);
+	return round(attn * diffuse) * clights[index];
+}
+
+float4 CalculateChannel(uint chan, float3 pos, float3 _norm0)
+{
+	uint colorreg = xfmem_chancontrol[chan];
+	uint alphareg = xfmem_chancontrol[chan + 2u];
+	float4 vcol = GetVertexColor(chan);
+
+	float4 mat;
+	mat.rgb = BIT(colorreg, 0) ? vcol.rgb : cmtrl[chan + 2u].rgb;
+	mat.a = BIT(alphareg, 0) ? vcol.a : cmtrl[chan + 2u].a;
+
+	float4 lacc;
+	lacc.rgb = !BIT(colorreg, 1) ? float3(255.0, 255.0, 255.0) : (BIT(colorreg, 6) ? vcol.rgb : cmtrl[chan].rgb);
+	lacc.a = !BIT(alphareg, 1) ? 255.0 : (BIT(alphareg, 6) ? vcol.a : cmtrl[chan].a);
+
+	if (BIT(colorreg, 1))
+	{
+		uint mask = BITS(colorreg, 2, 4) | (BITS(colorreg, 11, 4) << 4u);
+		for (uint i = 0u; i < 8u; i++)
+		{
+			if ((mask & (1u << i)) != 0u)
+				lacc.rgb += CalculateLight(colorreg, i, pos, _norm0).rgb;
+		}
+	}
+	if (BIT(alphareg, 1))
+	{
+		uint mask = BITS(alphareg, 2, 4) | (BITS(alphareg, 11, 4) << 4u);
+		for (uint i = 0u; i < 8u; i++)
+		{
+			if ((mask & (1u << i)) != 0u)
+				lacc.a += CalculateLight(alphareg, i, pos, _norm0).a;
+		}
+	}
+
+	int4 ilacc = clamp(int4(lacc), 0, 255);
+	ilacc += ilacc >> 7;
+	return float4((int4(mat) * ilacc) >> 8) / 255.0;
+}
+)";
+
+static const char s_vertex_main[] = R"(
+	int posmtx = int(vposmtx.x);
+	float4 pos = float4(dot(ctrmtx[posmtx], rawpos), dot(ctrmtx[posmtx + 1], rawpos), dot(ctrmtx[posmtx + 2], rawpos), 1.0);
+
+	int normidx = posmtx >= 32 ? (posmtx - 32) : posmtx;
+	float3 N0 = cnmtx[normidx].xyz, N1 = cnmtx[normidx + 1].xyz, N2 = cnmtx[normidx + 2].xyz;
+	float3 _norm0 = float3(0.0, 0.0, 0.0);
+	float3 _norm1 = float3(0.0, 0.0, 0.0);
+	float3 _norm2 = float3(0.0, 0.0, 0.0);
+	if (HasComponent(VB_HAS_NRM0))
+		_norm0 = normalize(float3(dot(N0, rawnorm0), dot(N1, rawnorm0), dot(N2, rawnorm0)));
+	if (HasComponent(VB_HAS_NRM1))
+		_norm1 = float3(dot(N0, rawnorm1), dot(N1, rawnorm1), dot(N2, rawnorm1));
+	if (HasComponent(VB_HAS_NRM2))
+		_norm2 = float3(dot(N0, rawnorm2), dot(N1, rawnorm2), dot(N2, rawnorm2));
+
+	float4 opos = float4(dot(cproj[0], pos), dot(cproj[1], pos), dot(cproj[2], pos), dot(cproj[3], pos));
+
+	float4 colors_0 = HasComponent(VB_HAS_COL0) ? color0 : float4(1.0, 1.0, 1.0, 1.0);
+	float4 colors_1 = HasComponent(VB_HAS_COL1) ? color1 : colors_0;
+	if (xfmem_numcolorchans > 0u)
+		colors_0 = CalculateChannel(0u, pos.xyz, _norm0);
+	if (xfmem_numcolorchans > 1u)
+		colors_1 = CalculateChannel(1u, pos.xyz, _norm0);
+
+	// transform texcoords
+	float3 otex[8];
+	for (uint i = 0u; i < 8u; i++)
+	{
+		otex[i] = float3(0.0, 0.0, 0.0);
+		if (i >= xfmem_numtexgens)
+			continue;
+
+		uint texMtxInfo = xfmem_texgen[i].x;
+		float4 coord = float4(0.0, 0.0, 1.0, 1.0);
+		uint sourcerow = BITS(texMtxInfo, 7, 5);
+		switch (sourcerow)
+		{
+		case 0u: // XF_SRCGEOM_INROW
+			coord.xyz = rawpos.xyz;
+			break;
+		case 1u: // XF_SRCNORMAL_INROW
+			if (HasComponent(VB_HAS_NRM0))
+				coord.xyz = rawnorm0.xyz;
+			break;
+		case 2u: // XF_SRCCOLORS_INROW
+			break;
+		case 3u: // XF_SRCBINORMAL_T_INROW
+			if (HasComponent(VB_HAS_NRM1))
+				coord.xyz = rawnorm1.xyz;
+			break;
+		case 4u: // XF_SRCBINORMAL_B_INROW
+			if (HasComponent(VB_HAS_NRM2))
+				coord.xyz = rawnorm2.xyz;
+			break;
+		default:
+			if (sourcerow <= 12u && HasComponent(VB_HAS_UV0 << (sourcerow - 5u)))
+				coord.xy = GetRawTex(sourcerow - 5u).xy;
+			break;
+		}
+		// An input form other than ABC1 or AB11 doesn't exist
+		if (!BIT(texMtxInfo, 2))
+			coord.z = 1.0;
+
+		uint texgentype = BITS(texMtxInfo, 4, 3);
+		if (texgentype == 1u)
+		{
+			// XF_TEXGEN_EMBOSS_MAP
+			if (HasComponent(VB_HAS_NRM1 | VB_HAS_NRM2))
+			{
+				// transform the light dir into tangent space
+				float3 eldir = normalize(clights[5u * BITS(texMtxInfo, 15, 3) + 3u].xyz - pos.xyz);
+				otex[i] = otex[BITS(texMtxInfo, 12, 3)] + float3(dot(eldir, _norm1), dot(eldir, _norm2), 0.0);
+			}
+			else
+			{
+				// Even if inputform ABC1 is set, it only uses AB11
+				otex[i] = float3(coord.xy, 1.0);
+			}
+		}
+		else if (texgentype == 2u)
+		{
+			// XF_TEXGEN_COLOR_STRGBC0
+			otex[i] = float3(colors_0.x, colors_0.y, 1.0);
+		}
+		else if (texgentype == 3u)
+		{
+			// XF_TEXGEN_COLOR_STRGBC1
+			otex[i] = float3(colors_1.x, colors_1.y, 1.0);
+		}
+		else
+		{
+			// XF_TEXGEN_REGULAR
+			bool stq = BIT(texMtxInfo, 1);
+			if (HasComponent(VB_HAS_TEXMTXIDX0 << i))
+			{
+				int tmp = int(GetRawTex(i).z);
+				otex[i] = float3(dot(coord, ctrmtx[tmp]), dot(coord, ctrmtx[tmp + 1]), stq ? dot(coord, ctrmtx[tmp + 2]) : 1.0);
+			}
+			else
+			{
+				otex[i] = float3(dot(coord, ctexmtx[3u * i]), dot(coord, ctexmtx[3u * i + 1u]), stq ? dot(coord, ctexmtx[3u * i + 2u]) : 1.0);
+			}
+
+			// When q is 0, the GameCube appears to have a special case
+			if (stq && otex[i].z == 0.0)
+				otex[i].xy = clamp(otex[i].xy, float2(-2.0, -2.0), float2(2.0, 2.0));
+
+			if (xfmem_dualtextrans != 0u)
+			{
+				uint postMtxInfo = xfmem_texgen[i].y;
+				uint postidx = BITS(postMtxInfo, 0, 6);
+				float4 P0 = cpostmtx[postidx & 0x3fu];
+				float4 P1 = cpostmtx[(postidx + 1u) & 0x3fu];
+				float4 P2 = cpostmtx[(postidx + 2u) & 0x3fu];
+				if (BIT(postMtxInfo, 8))
+					otex[i] = normalize(otex[i]);
+				// multiply by postmatrix
+				otex[i] = float3(dot(P0.xyz, otex[i]) + P0.w, dot(P1.xyz, otex[i]) + P1.w, dot(P2.xyz, otex[i]) + P2.w);
+			}
+		}
+	}
+
+	vs.colors_0 = colors_0;
+	vs.colors_1 = colors_1;
+	for (uint i = 0u; i < 8u; i++)
+		vs.tex[i] = otex[i];
+	// clipPos/w needs to be done in pixel shader, not here
+	vs.clipPos = float4(pos.x, pos.y, opos.z, opos.w);
+)";
+
+void GenerateVertexShaderCode(ShaderCode& out, const vertex_ubershader_uid_data& uid_data, API_TYPE api_type)
+{
+	char* codebuffer = out.GetBuffer();
+	codebuffer[UBERSHADERGEN_BUFFERSIZE - 1] = 0x7C;  // canary
+
+	out.Write("// Vertex UberShader\n");
+	out.Write("UBO_BINDING(std140, 2) uniform VSBlock {\n"
+		"\tfloat4 " I_PROJECTION "[4];\n"
+		"\tfloat4 " I_DEPTHPARAMS ";\n"
+		"\tfloat4 " I_VIEWPARAMS ";\n"
+		"\tfloat4 " I_MATERIALS "[4];\n"
+		"\tfloat4 " I_LIGHTS "[40];\n"
+		"\tfloat4 " I_PHONG "[2];\n"
+		"\tfloat4 " I_TEXMATRICES "[24];\n"
+		"\tfloat4 " I_TRANSFORMMATRICES "[64];\n"
+		"\tfloat4 " I_NORMALMATRICES "[32];\n"
+		"\tfloat4 " I_POSTTRANSFORMMATRICES "[64];\n"
+		"\tfloat4 " I_PLOFFSETPARAMS "[13];\n"
+		"};\n");
+	WriteUberShaderConstants(out);
+	out.Write("#define VB_HAS_TEXMTXIDX0 %uu\n", VB_HAS_TEXMTXIDX0);
+	out.Write("#define VB_HAS_NRM0 %uu\n", VB_HAS_NRM0);
+	out.Write("#define VB_HAS_NRM1 %uu\n", VB_HAS_NRM1);
+	out.Write("#define VB_HAS_NRM2 %uu\n", VB_HAS_NRM2);
+	out.Write("#define VB_HAS_COL0 %uu\n", VB_HAS_COL0);
+	out.Write("#define VB_HAS_COL1 %uu\n", VB_HAS_COL1);
+	out.Write("#define VB_HAS_UV0 %uu\n\n", VB_HAS_UV0);
+
+	// Every attribute is declared, the components in the UBERBlock tell which of them are valid.
+	out.Write("ATTRIBUTE_LOCATION(%d) in float4 rawpos;\n", SHADER_POSITION_ATTRIB);
+	out.Write("ATTRIBUTE_LOCATION(%d) in uint4 vposmtx;\n", SHADER_POSMTX_ATTRIB);
+	out.Write("ATTRIBUTE_LOCATION(%d) in float3 rawnorm0;\n", SHADER_NORM0_ATTRIB);
+	out.Write("ATTRIBUTE_LOCATION(%d) in float3 rawnorm1;\n", SHADER_NORM1_ATTRIB);
+	out.Write("ATTRIBUTE_LOCATION(%d) in float3 rawnorm2;\n", SHADER_NORM2_ATTRIB);
+	out.Write("ATTRIBUTE_LOCATION(%d) in float4 color0;\n", SHADER_COLOR0_ATTRIB);
+	out.Write("ATTRIBUTE_LOCATION(%d) in float4 color1;\n", SHADER_COLOR1_ATTRIB);
+	for (int i = 0; i < 8; ++i)
+		out.Write("ATTRIBUTE_LOCATION(%d) in float3 tex%d;\n", SHADER_TEXTURE0_ATTRIB + i, i);
+
+	const char* qualifier = GetInterpolationQualifier(api_type, uid_data.msaa, uid_data.ssaa, false, true);
+	out.Write("VARYING_LOCATION(0) out VertexData {\n");
+	out.Write("\t%s float4 colors_0;\n", qualifier);
+	out.Write("\t%s float4 colors_1;\n", qualifier);
+	out.Write("\t%s float3 tex[8];\n", qualifier);
+	out.Write("\t%s float4 clipPos;\n", qualifier);
+	if (g_ActiveConfig.backend_info.bSupportsDepthClamp)
+		out.Write("\t%s float2 clipDist;\n", qualifier);
+	out.Write("} vs;\n");
+
+	out.Write("%s", s_vertex_helpers);
+	out.Write("void main()\n{\n");
+	out.Write("%s", s_vertex_main);
+
+	if (g_ActiveConfig.backend_info.bSupportsDepthClamp)
+	{
+		// Same clipping as the specialized shaders, see GenerateVertexShader.
+		out.Write("\tfloat clipDepth = opos.z * 0.9999999;\n");
+		out.Write("\tvs.clipDist.x = clipDepth + opos.w;\n");
+		out.Write("\tvs.clipDist.y = -clipDepth;\n");
+		out.Write("\tgl_ClipDistance[0] = vs.clipDist.x;\n");
+		out.Write("\tgl_ClipDistance[1] = vs.clipDist.y;\n");
+	}
+	out.Write("\topos.z = opos.w * " I_DEPTHPARAMS ".x - opos.z * " I_DEPTHPARAMS ".y;\n");
+	if (!g_ActiveConfig.backend_info.bSupportsClipControl)
+		out.Write("\topos.z = opos.z * 2.0 - opos.w;\n");
+	out.Write("\topos.xy *= sign(" I_DEPTHPARAMS ".zw * float2(-1.0, 1.0));\n");
+	out.Write("\topos.xy = opos.xy + opos.w * " I_DEPTHPARAMS ".zw;\n");
+	out.Write("\tif (opos.w == 1.0)\n");
+	out.Write("\t\topos.xy = round(opos.xy * " I_VIEWPARAMS ".xy) * " I_VIEWPARAMS ".zw;\n");
+
+	// Vulkan NDC space has Y pointing down (right-handed NDC space).
+	if (api_type == API_VULKAN)
+		out.Write("\tgl_Position = float4(opos.x, -opos.y, opos.z, opos.w);\n");
+	else
+		out.Write("\tgl_Position = opos;\n");
+	out.Write("}\n");
+
+	if (codebuffer[UBERSHADERGEN_BUFFERSIZE - 1] != 0x7C)
+		PanicAlert("UberShader vertex generator - buffer too small, canary has been eaten!");
+}
+
+}  // namespace UberShader
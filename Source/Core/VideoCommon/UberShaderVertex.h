@@ -0,0 +1,39 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/VideoCommon.h"
+
+namespace UberShader
+{
+#pragma pack(1)
+struct vertex_ubershader_uid_data
+{
+	u32 NumValues() const
+	{
+		return sizeof(vertex_ubershader_uid_data);
+	}
+	u32 StartValue() const
+	{
+		return 0;
+	}
+
+	void ClearUnused(){}
+
+	u32 msaa : 1;
+	u32 ssaa : 1;
+	u32 pad : 30;
+};
+#pragma pack()
+typedef ShaderUid<vertex_ubershader_uid_data> VertexShaderUid;
+
+void GetVertexShaderUid(VertexShaderUid& object, const vertex_shader_uid_data& vs_uid_data);
+
+void GenerateVertexShaderCode(ShaderCode& object, const vertex_ubershader_uid_data& uid_data, API_TYPE api_type);
+
+}  // namespace UberShader
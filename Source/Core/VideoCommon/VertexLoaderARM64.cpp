@@ -2,10 +2,11 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
-#include "VideoCommon/VertexLoaderARM64.h"
 #include "Common/CommonTypes.h"
-#include "VideoCommon/DataReader.h"
+#include "VideoCommon/BoundingBox.h"
+#include "VideoCommon/VertexLoaderARM64.h"
 #include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 
 using namespace Arm64Gen;
 
@@ -17,20 +18,31 @@ constexpr ARM64Reg scratch1_reg = W16;
 constexpr ARM64Reg scratch2_reg = W15;
 constexpr ARM64Reg scratch3_reg = W14;
 constexpr ARM64Reg saved_count = W12;
+constexpr u32 MASKINDEXED = INDEX8 & INDEX16;
 
 constexpr ARM64Reg stride_reg = X11;
 constexpr ARM64Reg arraybase_reg = X10;
 constexpr ARM64Reg scale_reg = X9;
 
-alignas(16) static const float scale_factors[] = {
-	1.0 / (1ULL << 0),  1.0 / (1ULL << 1),  1.0 / (1ULL << 2),  1.0 / (1ULL << 3),
-	1.0 / (1ULL << 4),  1.0 / (1ULL << 5),  1.0 / (1ULL << 6),  1.0 / (1ULL << 7),
-	1.0 / (1ULL << 8),  1.0 / (1ULL << 9),  1.0 / (1ULL << 10), 1.0 / (1ULL << 11),
-	1.0 / (1ULL << 12), 1.0 / (1ULL << 13), 1.0 / (1ULL << 14), 1.0 / (1ULL << 15),
-	1.0 / (1ULL << 16), 1.0 / (1ULL << 17), 1.0 / (1ULL << 18), 1.0 / (1ULL << 19),
-	1.0 / (1ULL << 20), 1.0 / (1ULL << 21), 1.0 / (1ULL << 22), 1.0 / (1ULL << 23),
-	1.0 / (1ULL << 24), 1.0 / (1ULL << 25), 1.0 / (1ULL << 26), 1.0 / (1ULL << 27),
-	1.0 / (1ULL << 28), 1.0 / (1ULL << 29), 1.0 / (1ULL << 30), 1.0 / (1ULL << 31),
+// The scales are loaded once per call, v8-v15 would have to be saved so stay above them.
+constexpr ARM64Reg pos_scale_reg = D16;
+constexpr ARM64Reg normal_scale_reg = D17;
+constexpr ARM64Reg tex_scale_regs[8] = {
+	D18, D19, D20, D21,
+	D22, D23, D24, D25,
+};
+
+// Same layout as in VertexLoaderX64: the position scale, the fixed normal scales by format
+// and the texture coordinate scales. The fractions aren't part of the loader uid, so the
+// position and texture coordinate entries are written by PrepareConversion.
+alignas(16) static float scale_factors[13] = {
+	0.0f,
+	1.0f / (1U << 7),
+	1.0f / (1U << 6),
+	1.0f / (1U << 15),
+	1.0f / (1U << 14),
+	0.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 0.0f,
 };
 
 VertexLoaderARM64::VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_att)
@@ -47,7 +59,7 @@ VertexLoaderARM64::VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_at
 
 void VertexLoaderARM64::GetVertexAddr(int array, u64 attribute, ARM64Reg reg)
 {
-	if (attribute & MASK_INDEXED)
+	if (attribute & MASKINDEXED)
 	{
 		if (attribute == INDEX8)
 		{
@@ -97,9 +109,11 @@ void VertexLoaderARM64::GetVertexAddr(int array, u64 attribute, ARM64Reg reg)
 		ADD(reg, src_reg, m_src_ofs);
 }
 
+// Returns the offset from src_reg of a direct attribute if a load can encode it, otherwise the
+// address is computed into reg and -1 is returned. align is the size of the load in bytes.
 s32 VertexLoaderARM64::GetAddressImm(int array, u64 attribute, Arm64Gen::ARM64Reg reg, u32 align)
 {
-	if (attribute & MASK_INDEXED || (m_src_ofs > 255 && (m_src_ofs & (align - 1))))
+	if (attribute & MASKINDEXED || (m_src_ofs > 255 && (m_src_ofs & (align - 1))))
 		GetVertexAddr(array, attribute, reg);
 	else
 		return m_src_ofs;
@@ -107,34 +121,24 @@ s32 VertexLoaderARM64::GetAddressImm(int array, u64 attribute, Arm64Gen::ARM64Re
 }
 
 int VertexLoaderARM64::ReadVertex(u64 attribute, int format, int count_in, int count_out,
-	bool dequantize, u8 scaling_exponent,
-	AttributeFormat* native_format, s32 offset)
+	bool dequantize, ARM64Reg scaling_register, AttributeFormat* native_format, s32 offset)
 {
 	ARM64Reg coords = count_in == 3 ? Q31 : D31;
-	ARM64Reg scale = count_in == 3 ? Q30 : D30;
 
 	int elem_size = 1 << (format / 2);
 	int load_bytes = elem_size * count_in;
 	int load_size =
 		load_bytes == 1 ? 1 : load_bytes <= 2 ? 2 : load_bytes <= 4 ? 4 : load_bytes <= 8 ? 8 : 16;
-	load_size <<= 3;
-	elem_size <<= 3;
 
+	// The load is never wider than the attribute rounded up to a power of two, so the lanes
+	// past count_in are zero when fewer than three elements are read. Unaligned accesses are
+	// fine for indexed attributes, only the immediate has to be a multiple of the size.
 	if (offset == -1)
-	{
-		if (count_in == 1)
-			m_float_emit.LDR(elem_size, INDEX_UNSIGNED, coords, EncodeRegTo64(scratch1_reg), 0);
-		else
-			m_float_emit.LD1(elem_size, 1, coords, EncodeRegTo64(scratch1_reg));
-	}
+		m_float_emit.LDR(load_size * 8, INDEX_UNSIGNED, coords, EncodeRegTo64(scratch1_reg), 0);
 	else if (offset & (load_size - 1))  // Not aligned - unscaled
-	{
-		m_float_emit.LDUR(load_size, coords, src_reg, offset);
-	}
+		m_float_emit.LDUR(load_size * 8, coords, src_reg, offset);
 	else
-	{
-		m_float_emit.LDR(load_size, INDEX_UNSIGNED, coords, src_reg, offset);
-	}
+		m_float_emit.LDR(load_size * 8, INDEX_UNSIGNED, coords, src_reg, offset);
 
 	if (format != FORMAT_FLOAT)
 	{
@@ -161,11 +165,8 @@ int VertexLoaderARM64::ReadVertex(u64 attribute, int format, int count_in, int c
 
 		m_float_emit.SCVTF(32, coords, coords);
 
-		if (dequantize && scaling_exponent)
-		{
-			m_float_emit.LDR(32, INDEX_UNSIGNED, scale, scale_reg, scaling_exponent * 4);
-			m_float_emit.FMUL(32, coords, coords, scale, 0);
-		}
+		if (dequantize)
+			m_float_emit.FMUL(32, coords, coords, scaling_register, 0);
 	}
 	else
 	{
@@ -185,26 +186,13 @@ int VertexLoaderARM64::ReadVertex(u64 attribute, int format, int count_in, int c
 	else
 	{
 		ADD(EncodeRegTo64(scratch2_reg), dst_reg, m_dst_ofs);
-		m_float_emit.ST1(32, 1, coords, EncodeRegTo64(scratch2_reg));
-	}
-
-	// Z-Freeze
-	if (native_format == &m_native_vtx_decl.position)
-	{
-		CMP(count_reg, 3);
-		FixupBranch dont_store = B(CC_GT);
-		MOVP2R(EncodeRegTo64(scratch2_reg), VertexLoaderManager::position_cache);
-		ADD(EncodeRegTo64(scratch1_reg), EncodeRegTo64(scratch2_reg), EncodeRegTo64(count_reg),
-			ArithOption(EncodeRegTo64(count_reg), ST_LSL, 4));
-		m_float_emit.STUR(write_size, coords, EncodeRegTo64(scratch1_reg), -16);
-		SetJumpTarget(dont_store);
+		m_float_emit.STR(write_size, INDEX_UNSIGNED, coords, EncodeRegTo64(scratch2_reg), 0);
 	}
 
 	native_format->components = count_out;
 	native_format->enable = true;
 	native_format->offset = m_dst_ofs;
-	native_format->type = VAR_FLOAT;
-	native_format->integer = false;
+	native_format->type = FORMAT_FLOAT;
 	m_dst_ofs += sizeof(float) * count_out;
 
 	if (attribute == DIRECT)
@@ -264,7 +252,7 @@ void VertexLoaderARM64::ReadColor(u64 attribute, int format, s32 offset)
 		ORR(scratch1_reg, scratch1_reg, scratch2_reg, ArithOption(scratch2_reg, ST_LSR, 2));
 
 		// A
-		ORR(scratch2_reg, scratch2_reg, 8, 7);  // 0xFF000000
+		ORR(scratch1_reg, scratch1_reg, 8, 7);  // 0xFF000000
 
 		STR(INDEX_UNSIGNED, scratch1_reg, dst_reg, m_dst_ofs);
 		load_bytes = 2;
@@ -312,11 +300,21 @@ void VertexLoaderARM64::ReadColor(u64 attribute, int format, s32 offset)
 		}
 		else
 		{
+			// The word starts one byte early, so the offset check done for the color doesn't hold.
 			offset -= 1;
-			if (offset & 3)  // Not aligned - unscaled
+			if (!(offset & 3))
+			{
+				LDR(INDEX_UNSIGNED, scratch3_reg, src_reg, offset);
+			}
+			else if (offset < 256)
+			{
 				LDUR(scratch3_reg, src_reg, offset);
+			}
 			else
-				LDR(INDEX_UNSIGNED, scratch3_reg, src_reg, offset);
+			{
+				ADD(EncodeRegTo64(scratch1_reg), src_reg, offset);
+				LDR(INDEX_UNSIGNED, scratch3_reg, EncodeRegTo64(scratch1_reg), 0);
+			}
 		}
 
 		REV32(scratch3_reg, scratch3_reg);
@@ -375,51 +373,34 @@ void VertexLoaderARM64::GenerateVertexLoader()
 		m_VtxDesc.Tex4Coord, m_VtxDesc.Tex5Coord, m_VtxDesc.Tex6Coord, m_VtxDesc.Tex7Coord,
 	};
 
-	bool has_tc = false;
-	bool has_tc_scale = false;
-	for (int i = 0; i < 8; i++)
-	{
-		has_tc |= tc[i];
-		has_tc_scale |= !!m_VtxAttr.texCoord[i].Frac;
-	}
-
-	bool need_scale =
-		(m_VtxAttr.ByteDequant && m_VtxAttr.PosFrac) || (has_tc && has_tc_scale) || m_VtxDesc.Normal;
-
 	AlignCode16();
-	if (m_VtxDesc.Position & MASK_INDEXED)
+	if (m_VtxDesc.Position & MASKINDEXED)
 		MOV(skipped_reg, WZR);
 	MOV(saved_count, count_reg);
 
 	MOVP2R(stride_reg, g_main_cp_state.array_strides);
-	MOVP2R(arraybase_reg, VertexLoaderManager::cached_arraybases);
+	MOVP2R(arraybase_reg, cached_arraybases);
 
-	if (need_scale)
-		MOVP2R(scale_reg, scale_factors);
+	// Load the scales into registers outside the main loop
+	MOVP2R(scale_reg, scale_factors);
+	if (m_VtxAttr.PosFormat != FORMAT_FLOAT && m_VtxAttr.ByteDequant)
+		m_float_emit.LDR(32, INDEX_UNSIGNED, pos_scale_reg, scale_reg, 0);
+	if (m_VtxDesc.Normal)
+		m_float_emit.LDR(32, INDEX_UNSIGNED, normal_scale_reg, scale_reg, (m_VtxAttr.NormalFormat + 1) * 4);
+	if (m_VtxAttr.ByteDequant)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			if (tc[i] && m_VtxAttr.texCoord[i].Format != FORMAT_FLOAT)
+				m_float_emit.LDR(32, INDEX_UNSIGNED, tex_scale_regs[i], scale_reg, (5 + i) * 4);
+		}
+	}
 
 	const u8* loop_start = GetCodePtr();
 
 	if (m_VtxDesc.PosMatIdx)
 	{
-		LDRB(INDEX_UNSIGNED, scratch1_reg, src_reg, m_src_ofs);
-		AND(scratch1_reg, scratch1_reg, 0, 5);
-		STR(INDEX_UNSIGNED, scratch1_reg, dst_reg, m_dst_ofs);
-
-		// Z-Freeze
-		CMP(count_reg, 3);
-		FixupBranch dont_store = B(CC_GT);
-		MOVP2R(EncodeRegTo64(scratch2_reg), VertexLoaderManager::position_matrix_index);
-		STR(INDEX_UNSIGNED, scratch1_reg, EncodeRegTo64(scratch2_reg), 0);
-		SetJumpTarget(dont_store);
-
-		m_native_components |= VB_HAS_POSMTXIDX;
-		m_native_vtx_decl.posmtx.components = 4;
-		m_native_vtx_decl.posmtx.enable = true;
-		m_native_vtx_decl.posmtx.offset = m_dst_ofs;
-		m_native_vtx_decl.posmtx.type = VAR_UNSIGNED_BYTE;
-		m_native_vtx_decl.posmtx.integer = true;
-		m_src_ofs += sizeof(u8);
-		m_dst_ofs += sizeof(u32);
+		m_src_ofs++;
 	}
 
 	u32 texmatidx_ofs[8];
@@ -439,20 +420,15 @@ void VertexLoaderARM64::GenerateVertexLoader()
 		int load_bytes = elem_size * (m_VtxAttr.PosElements + 2);
 		int load_size =
 			load_bytes == 1 ? 1 : load_bytes <= 2 ? 2 : load_bytes <= 4 ? 4 : load_bytes <= 8 ? 8 : 16;
-		load_size <<= 3;
 
 		s32 offset =
 			GetAddressImm(ARRAY_POSITION, m_VtxDesc.Position, EncodeRegTo64(scratch1_reg), load_size);
-		int pos_elements = m_VtxAttr.PosElements + 2;
-		ReadVertex(m_VtxDesc.Position, m_VtxAttr.PosFormat, pos_elements, pos_elements,
-			m_VtxAttr.ByteDequant, m_VtxAttr.PosFrac, &m_native_vtx_decl.position, offset);
+		ReadVertex(m_VtxDesc.Position, m_VtxAttr.PosFormat, m_VtxAttr.PosElements + 2, 3,
+			m_VtxAttr.ByteDequant, pos_scale_reg, &m_native_vtx_decl.position, offset);
 	}
 
 	if (m_VtxDesc.Normal)
 	{
-		static const u8 map[8] = { 7, 6, 15, 14 };
-		u8 scaling_exponent = map[m_VtxAttr.NormalFormat];
-
 		s32 offset = -1;
 		for (int i = 0; i < (m_VtxAttr.NormalElements ? 3 : 1); i++)
 		{
@@ -466,7 +442,7 @@ void VertexLoaderARM64::GenerateVertexLoader()
 					load_bytes <= 8 ? 8 : 16;
 
 				offset = GetAddressImm(ARRAY_NORMAL, m_VtxDesc.Normal, EncodeRegTo64(scratch1_reg),
-					load_size << 3);
+					load_size);
 
 				if (offset == -1)
 					ADD(EncodeRegTo64(scratch1_reg), EncodeRegTo64(scratch1_reg), i * elem_size * 3);
@@ -474,7 +450,7 @@ void VertexLoaderARM64::GenerateVertexLoader()
 					offset += i * elem_size * 3;
 			}
 			int bytes_read = ReadVertex(m_VtxDesc.Normal, m_VtxAttr.NormalFormat, 3, 3, true,
-				scaling_exponent, &m_native_vtx_decl.normals[i], offset);
+				normal_scale_reg, &m_native_vtx_decl.normals[i], offset);
 
 			if (offset == -1)
 				ADD(EncodeRegTo64(scratch1_reg), EncodeRegTo64(scratch1_reg), bytes_read);
@@ -490,10 +466,6 @@ void VertexLoaderARM64::GenerateVertexLoader()
 	const u64 col[2] = { m_VtxDesc.Color0, m_VtxDesc.Color1 };
 	for (int i = 0; i < 2; i++)
 	{
-		m_native_vtx_decl.colors[i].components = 4;
-		m_native_vtx_decl.colors[i].type = VAR_UNSIGNED_BYTE;
-		m_native_vtx_decl.colors[i].integer = false;
-
 		if (col[i])
 		{
 			u32 align = 4;
@@ -506,43 +478,35 @@ void VertexLoaderARM64::GenerateVertexLoader()
 			m_native_vtx_decl.colors[i].components = 4;
 			m_native_vtx_decl.colors[i].enable = true;
 			m_native_vtx_decl.colors[i].offset = m_dst_ofs;
-			m_native_vtx_decl.colors[i].type = VAR_UNSIGNED_BYTE;
-			m_native_vtx_decl.colors[i].integer = false;
+			m_native_vtx_decl.colors[i].type = FORMAT_UBYTE;
 			m_dst_ofs += 4;
 		}
 	}
 
 	for (int i = 0; i < 8; i++)
 	{
-		m_native_vtx_decl.texcoords[i].offset = m_dst_ofs;
-		m_native_vtx_decl.texcoords[i].type = VAR_FLOAT;
-		m_native_vtx_decl.texcoords[i].integer = false;
-
 		int elements = m_VtxAttr.texCoord[i].Elements + 1;
 		if (tc[i])
 		{
 			m_native_components |= VB_HAS_UV0 << i;
 
 			int elem_size = 1 << (m_VtxAttr.texCoord[i].Format / 2);
-			int load_bytes = elem_size * (elements + 2);
+			int load_bytes = elem_size * elements;
 			int load_size = load_bytes == 1 ? 1 : load_bytes <= 2 ? 2 : load_bytes <= 4 ?
 				4 :
 				load_bytes <= 8 ? 8 : 16;
-			load_size <<= 3;
 
 			s32 offset =
 				GetAddressImm(ARRAY_TEXCOORD0 + i, tc[i], EncodeRegTo64(scratch1_reg), load_size);
-			u8 scaling_exponent = m_VtxAttr.texCoord[i].Frac;
 			ReadVertex(tc[i], m_VtxAttr.texCoord[i].Format, elements, tm[i] ? 2 : elements,
-				m_VtxAttr.ByteDequant, scaling_exponent, &m_native_vtx_decl.texcoords[i], offset);
+				m_VtxAttr.ByteDequant, tex_scale_regs[i], &m_native_vtx_decl.texcoords[i], offset);
 		}
 		if (tm[i])
 		{
-			m_native_components |= VB_HAS_TEXMTXIDX0 << i;
+			m_native_components |= (VB_HAS_TEXMTXIDX0 | VB_HAS_UV0) << i;
 			m_native_vtx_decl.texcoords[i].components = 3;
 			m_native_vtx_decl.texcoords[i].enable = true;
-			m_native_vtx_decl.texcoords[i].type = VAR_FLOAT;
-			m_native_vtx_decl.texcoords[i].integer = false;
+			m_native_vtx_decl.texcoords[i].type = FORMAT_FLOAT;
 
 			LDRB(INDEX_UNSIGNED, scratch2_reg, src_reg, texmatidx_ofs[i]);
 			m_float_emit.UCVTF(S31, scratch2_reg);
@@ -579,6 +543,24 @@ void VertexLoaderARM64::GenerateVertexLoader()
 		}
 	}
 
+	// The position matrix index is always written, the shaders index with it.
+	if (m_VtxDesc.PosMatIdx)
+	{
+		LDRB(INDEX_UNSIGNED, scratch1_reg, src_reg, 0);
+	}
+	else
+	{
+		MOVP2R(EncodeRegTo64(scratch2_reg), &g_main_cp_state.matrix_index_a);
+		LDR(INDEX_UNSIGNED, scratch1_reg, EncodeRegTo64(scratch2_reg), 0);
+	}
+	AND(scratch1_reg, scratch1_reg, 0, 5);  // 0x3F
+	STR(INDEX_UNSIGNED, scratch1_reg, dst_reg, m_dst_ofs);
+	m_native_vtx_decl.posmtx.components = 4;
+	m_native_vtx_decl.posmtx.enable = true;
+	m_native_vtx_decl.posmtx.offset = m_dst_ofs;
+	m_native_vtx_decl.posmtx.type = FORMAT_UBYTE;
+	m_dst_ofs += sizeof(u32);
+
 	// Prepare for the next vertex.
 	ADD(dst_reg, dst_reg, m_dst_ofs);
 	const u8* cont = GetCodePtr();
@@ -587,7 +569,7 @@ void VertexLoaderARM64::GenerateVertexLoader()
 	SUB(count_reg, count_reg, 1);
 	CBNZ(count_reg, loop_start);
 
-	if (m_VtxDesc.Position & MASK_INDEXED)
+	if (m_VtxDesc.Position & MASKINDEXED)
 	{
 		SUB(W0, saved_count, skipped_reg);
 		RET(X30);
@@ -604,13 +586,41 @@ void VertexLoaderARM64::GenerateVertexLoader()
 
 	FlushIcache();
 
+	m_native_stride = m_dst_ofs;
 	m_VertexSize = m_src_ofs;
-	m_native_vtx_decl.stride = m_dst_ofs;
+	m_native_vtx_decl.stride = m_native_stride;
+}
+
+bool VertexLoaderARM64::EnvironmentIsSupported()
+{
+	return g_ActiveConfig.iBBoxMode == BBoxGPU || !BoundingBox::active;
+}
+
+void VertexLoaderARM64::PrepareConversion(const VertexLoaderParameters &parameters)
+{
+	const VAT &vat = *parameters.VtxAttr;
+	scale_factors[0] = fractionTable[vat.g0.PosFrac];
+	if (m_native_components & VB_HAS_UVALL)
+	{
+		scale_factors[5] = fractionTable[vat.g0.Tex0Frac];
+		scale_factors[6] = fractionTable[vat.g1.Tex1Frac];
+		scale_factors[7] = fractionTable[vat.g1.Tex2Frac];
+		scale_factors[8] = fractionTable[vat.g1.Tex3Frac];
+		scale_factors[9] = fractionTable[vat.g2.Tex4Frac];
+		scale_factors[10] = fractionTable[vat.g2.Tex5Frac];
+		scale_factors[11] = fractionTable[vat.g2.Tex6Frac];
+		scale_factors[12] = fractionTable[vat.g2.Tex7Frac];
+	}
+}
+
+s32 VertexLoaderARM64::ConvertRange(const u8* src, u8* dst, s32 count) const
+{
+	return ((int(*)(const u8* src, u8* dst, int count))region)(src, dst, count);
 }
 
-int VertexLoaderARM64::RunVertices(DataReader src, DataReader dst, int count)
+int VertexLoaderARM64::RunVertices(const VertexLoaderParameters &parameters)
 {
-	m_numLoadedVertices += count;
-	return ((int(*)(u8 * src, u8 * dst, int count))region)(src.GetPointer(), dst.GetPointer(),
-		count);
+	PrepareConversion(parameters);
+	m_numLoadedVertices += parameters.count;
+	return ConvertRange(parameters.source, parameters.destination, parameters.count);
 }
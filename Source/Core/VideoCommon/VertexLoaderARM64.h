@@ -12,10 +12,18 @@ public:
 	VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_att);
 
 protected:
-	std::string GetName() const override { return "VertexLoaderARM64"; }
-	bool IsInitialized() override { return true; }
-	int RunVertices(DataReader src, DataReader dst, int count) override;
-
+	bool IsInitialized() override
+	{
+		return true;
+	}
+	int RunVertices(const VertexLoaderParameters &parameters) override;
+	bool EnvironmentIsSupported() override;
+	bool CanConvertInParallel() const override
+	{
+		return true;
+	}
+	void PrepareConversion(const VertexLoaderParameters &parameters) override;
+	s32 ConvertRange(const u8* src, u8* dst, s32 count) const override;
 private:
 	u32 m_src_ofs = 0;
 	u32 m_dst_ofs = 0;
@@ -23,7 +31,7 @@ private:
 	Arm64Gen::ARM64FloatEmitter m_float_emit;
 	void GetVertexAddr(int array, u64 attribute, Arm64Gen::ARM64Reg reg);
 	s32 GetAddressImm(int array, u64 attribute, Arm64Gen::ARM64Reg reg, u32 align);
-	int ReadVertex(u64 attribute, int format, int count_in, int count_out, bool dequantize, u8 scaling_exponent, AttributeFormat* native_format, s32 offset = -1);
+	int ReadVertex(u64 attribute, int format, int count_in, int count_out, bool dequantize, Arm64Gen::ARM64Reg scaling_register, AttributeFormat* native_format, s32 offset = -1);
 	void ReadColor(u64 attribute, int format, s32 offset);
 	void GenerateVertexLoader();
 };
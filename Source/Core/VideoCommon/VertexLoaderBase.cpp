@@ -17,6 +17,8 @@
 
 #ifdef _M_X86_64
 #include "VideoCommon/VertexLoaderX64.h"
+#elif defined(_M_ARM_64)
+#include "VideoCommon/VertexLoaderARM64.h"
 #endif
 
 TPipelineState g_PipelineState;
@@ -343,6 +345,12 @@ std::unique_ptr<VertexLoaderBase> VertexLoaderBase::CreateVertexLoader(const TVt
 	{
 		loader.reset();
 	}
+#elif defined(_M_ARM_64)
+	loader = std::make_unique<VertexLoaderARM64>(vtx_desc, vtx_attr);
+	if (!loader->IsInitialized())
+	{
+		loader.reset();
+	}
 #endif
 	std::unique_ptr<VertexLoaderBase> fallback = std::make_unique<VertexLoaderCompiled>(vtx_desc, vtx_attr);
 	if (!fallback->IsInitialized())
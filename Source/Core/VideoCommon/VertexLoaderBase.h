@@ -78,6 +78,20 @@ public:
 	}
 	virtual s32 RunVertices(const VertexLoaderParameters &parameters) = 0;
 
+	// Loaders that only touch the source and destination while converting can split a
+	// large draw between several threads. PrepareConversion is called once per draw on the
+	// GPU thread, then ConvertRange may run concurrently on disjoint ranges of the draw.
+	// ConvertRange returns the number of vertices written, skipped vertices are not written.
+	virtual bool CanConvertInParallel() const
+	{
+		return false;
+	}
+	virtual void PrepareConversion(const VertexLoaderParameters &parameters) {}
+	virtual s32 ConvertRange(const u8* src, u8* dst, s32 count) const
+	{
+		return 0;
+	}
+
 	virtual bool IsInitialized() = 0;
 
 	// For debugging / profiling
@@ -14,24 +14,7 @@
 #include "VideoCommon/VideoConfig.h"
 
 // Precompiled Loaders
-#include "VideoCommon/G_G4BP08_pvt.h"
-#include "VideoCommon/G_GB4P51_pvt.h"
-#include "VideoCommon/G_GFZE01_pvt.h"
-#include "VideoCommon/G_GLMP01_pvt.h"
-#include "VideoCommon/G_GM8E01_pvt.h"
-#include "VideoCommon/G_GNUEDA_pvt.h"
-#include "VideoCommon/G_GSAE01_pvt.h"
-#include "VideoCommon/G_GZ2P01_pvt.h"
-#include "VideoCommon/G_RBUP08_pvt.h"
-#include "VideoCommon/G_R5WEA4_pvt.h"
-#include "VideoCommon/G_RMCP01_pvt.h"
-#include "VideoCommon/G_RMGP01_pvt.h"
-#include "VideoCommon/G_RSBP01_pvt.h"
-#include "VideoCommon/G_SDWP18_pvt.h"
-#include "VideoCommon/G_SMNP01_pvt.h"
-#include "VideoCommon/G_SPDE52_pvt.h"
-#include "VideoCommon/G_SPXP41_pvt.h"
-#include "VideoCommon/G_SX4E01_pvt.h"
+#include "VideoCommon/PrecompiledVertexLoaders.h"
 
 typedef std::map<u64, TCompiledLoaderFunction> PrecompiledVertexLoaderMap;
 static PrecompiledVertexLoaderMap s_PrecompiledVertexLoaderMap;
@@ -44,24 +27,7 @@ void VertexLoaderCompiled::Initialize()
 	if (!s_PrecompiledLoadersInitialized)
 	{
 		s_PrecompiledLoadersInitialized = true;
-		G_G4BP08_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_GB4P51_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_GFZE01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_GLMP01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_GM8E01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_GNUEDA_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_GSAE01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_GZ2P01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_R5WEA4_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_RBUP08_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_RMCP01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_RMGP01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_RSBP01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_SDWP18_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_SMNP01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_SPDE52_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_SPXP41_pvt::Initialize(s_PrecompiledVertexLoaderMap);
-		G_SX4E01_pvt::Initialize(s_PrecompiledVertexLoaderMap);
+		RegisterPrecompiledVertexLoaders(s_PrecompiledVertexLoaderMap);
 	}
 }
 
@@ -89,28 +55,33 @@ VertexLoaderCompiled::~VertexLoaderCompiled()
 
 }
 
-s32 VertexLoaderCompiled::RunVertices(const VertexLoaderParameters &parameters)
+void VertexLoaderCompiled::InitializePipelineState(TPipelineState& state, const VAT& vat) const
 {
-	m_numLoadedVertices += parameters.count;
-	const VAT &vat = *parameters.VtxAttr;
 	if (m_native_components & VB_HAS_UVALL)
 	{
-		g_PipelineState.tcScale[0] = fractionTable[vat.g0.Tex0Frac];
-		g_PipelineState.tcScale[1] = fractionTable[vat.g1.Tex1Frac];
-		g_PipelineState.tcScale[2] = fractionTable[vat.g1.Tex2Frac];
-		g_PipelineState.tcScale[3] = fractionTable[vat.g1.Tex3Frac];
-		g_PipelineState.tcScale[4] = fractionTable[vat.g2.Tex4Frac];
-		g_PipelineState.tcScale[5] = fractionTable[vat.g2.Tex5Frac];
-		g_PipelineState.tcScale[6] = fractionTable[vat.g2.Tex6Frac];
-		g_PipelineState.tcScale[7] = fractionTable[vat.g2.Tex7Frac];
+		state.tcScale[0] = fractionTable[vat.g0.Tex0Frac];
+		state.tcScale[1] = fractionTable[vat.g1.Tex1Frac];
+		state.tcScale[2] = fractionTable[vat.g1.Tex2Frac];
+		state.tcScale[3] = fractionTable[vat.g1.Tex3Frac];
+		state.tcScale[4] = fractionTable[vat.g2.Tex4Frac];
+		state.tcScale[5] = fractionTable[vat.g2.Tex5Frac];
+		state.tcScale[6] = fractionTable[vat.g2.Tex6Frac];
+		state.tcScale[7] = fractionTable[vat.g2.Tex7Frac];
 	}
-	g_PipelineState.flags = g_ActiveConfig.iBBoxMode == BBoxCPU && BoundingBox::active ? TPS_USE_BBOX : TPS_NONE;
-	g_PipelineState.stride = m_native_stride;
-	g_PipelineState.skippedVertices = 0;
-	g_PipelineState.posScale = fractionTable[vat.g0.PosFrac];
-	g_PipelineState.curposmtx = g_main_cp_state.matrix_index_a.PosNormalMtxIdx;
+	state.stride = m_native_stride;
+	state.skippedVertices = 0;
+	state.posScale = fractionTable[vat.g0.PosFrac];
+	state.curposmtx = g_main_cp_state.matrix_index_a.PosNormalMtxIdx;
 	for (int i = 0; i < 2; i++)
-		g_PipelineState.colElements[i] = m_VtxAttr.color[i].Elements;
+		state.colElements[i] = m_VtxAttr.color[i].Elements;
+}
+
+s32 VertexLoaderCompiled::RunVertices(const VertexLoaderParameters &parameters)
+{
+	m_numLoadedVertices += parameters.count;
+	const VAT &vat = *parameters.VtxAttr;
+	InitializePipelineState(g_PipelineState, vat);
+	g_PipelineState.flags = g_ActiveConfig.iBBoxMode == BBoxCPU && BoundingBox::active ? TPS_USE_BBOX : TPS_NONE;
 	// Prepare bounding box
 	if (g_ActiveConfig.iBBoxMode == BBoxCPU && BoundingBox::active)
 		BoundingBox::Prepare(vat, parameters.primitive, m_VtxDesc, m_native_vtx_decl);
@@ -120,6 +91,30 @@ s32 VertexLoaderCompiled::RunVertices(const VertexLoaderParameters &parameters)
 	return parameters.count - g_PipelineState.skippedVertices;
 }
 
+bool VertexLoaderCompiled::CanConvertInParallel() const
+{
+	// The CPU bounding box is accumulated in global state.
+	return g_ActiveConfig.iBBoxMode != BBoxCPU || !BoundingBox::active;
+}
+
+void VertexLoaderCompiled::PrepareConversion(const VertexLoaderParameters &parameters)
+{
+	m_conversion_state = TPipelineState();
+	InitializePipelineState(m_conversion_state, *parameters.VtxAttr);
+	m_conversion_state.flags = TPS_NONE;
+}
+
+s32 VertexLoaderCompiled::ConvertRange(const u8* src, u8* dst, s32 count) const
+{
+	// Every range gets its own copy of the state, the loaders read and write through it.
+	TPipelineState state = m_conversion_state;
+	u8* source = const_cast<u8*>(src);
+	state.count = count;
+	state.Initialize(source, source + count * m_VertexSize, dst);
+	m_precompiledfunc(state);
+	return count - state.skippedVertices;
+}
+
 
 void VertexLoaderCompiled::InitializeVertexData()
 {
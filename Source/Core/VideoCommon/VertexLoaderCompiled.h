@@ -17,6 +17,9 @@ public:
 		return true;
 	}
 	s32 RunVertices(const VertexLoaderParameters &parameters) override;
+	bool CanConvertInParallel() const override;
+	void PrepareConversion(const VertexLoaderParameters &parameters) override;
+	s32 ConvertRange(const u8* src, u8* dst, s32 count) const override;
 
 	bool IsInitialized() override
 	{
@@ -26,5 +29,7 @@ private:
 	static bool s_PrecompiledLoadersInitialized;
 	bool m_initialized;
 	TCompiledLoaderFunction m_precompiledfunc;
+	TPipelineState m_conversion_state;
 	void InitializeVertexData();
+	void InitializePipelineState(TPipelineState& state, const VAT& vat) const;
 };
\ No newline at end of file
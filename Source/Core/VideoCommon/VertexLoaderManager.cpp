@@ -3,17 +3,31 @@
 // Refer to the license.txt file included.
 // Modified for Ishiiruka by Tino
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 
 #include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
 
+#include "Common/CPUDetect.h"
+#include "Common/FileUtil.h"
+#include "Common/Thread.h"
 #include "Common/ThreadPool.h"
 #include "Common/StringUtil.h"
 
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -163,6 +177,61 @@ static void DumpLoadersCode()
 	out.close();
 }
 
+// Writes the usage histogram of every loader seen this session to
+// Dump/VertexLoaders/<game id>.txt, adding the counts of previous runs.
+// Tools/gen-vertex-loaders.py turns these files into precompiled loaders.
+static void DumpLoadersProfile()
+{
+	struct profileentry
+	{
+		u32 conf[4];
+		u64 num_verts;
+		std::string name;
+	};
+	std::map<u64, profileentry> entries;
+	std::string dir = File::GetUserPath(D_DUMP_IDX) + "VertexLoaders/";
+	File::CreateFullPath(dir);
+	std::string filename = dir + last_game_code + ".txt";
+	{
+		std::ifstream in(filename);
+		std::string line;
+		while (std::getline(in, line))
+		{
+			if (line.empty() || line[0] == '#')
+				continue;
+			std::istringstream ss(line);
+			u64 hash;
+			profileentry e;
+			ss >> hash >> std::hex >> e.conf[0] >> e.conf[1] >> e.conf[2] >> e.conf[3] >> std::dec >> e.num_verts >> e.name;
+			if (!ss.fail())
+				entries[hash] = e;
+		}
+	}
+	for (VertexLoaderMap::const_iterator iter = s_vertex_loader_map.begin(); iter != s_vertex_loader_map.end(); ++iter)
+	{
+		if (iter->second->m_numLoadedVertices == 0)
+			continue;
+		auto result = entries.emplace(iter->first.GetHash(), profileentry());
+		profileentry& e = result.first->second;
+		if (result.second)
+		{
+			for (u32 i = 0; i < 4; i++)
+				e.conf[i] = iter->first.GetElement(i);
+			e.num_verts = 0;
+			e.name = iter->second->GetName();
+		}
+		e.num_verts += iter->second->m_numLoadedVertices;
+	}
+	std::ofstream out(filename);
+	out << "# hash vid0 vid1 vid2 vid3 num_verts name\n";
+	for (const auto& entry : entries)
+	{
+		const profileentry& e = entry.second;
+		out << entry.first << StringFromFormat(" %08x %08x %08x %08x ", e.conf[0], e.conf[1], e.conf[2], e.conf[3])
+			<< e.num_verts << ' ' << e.name << '\n';
+	}
+}
+
 void AppendListToString(std::string *dest)
 {
 	std::vector<entry> entries;
@@ -184,18 +253,166 @@ void AppendListToString(std::string *dest)
 	}
 }
 
+// Large draws are split into chunks that the GPU thread and a few helper threads convert
+// at the same time. Submission stays on the GPU thread, which waits for all chunks before
+// the indices are generated, so the draw order is unchanged.
+static constexpr s32 PARALLEL_LOAD_MIN_CHUNK_VERTICES = 1024;
+static constexpr u32 PARALLEL_LOAD_MAX_CHUNKS = 32;
+static constexpr int PARALLEL_LOAD_MAX_THREADS = 4;
+
+struct ParallelLoadJob
+{
+	const VertexLoaderBase* loader;
+	const u8* source;
+	u8* destination;
+	s32 count;
+	s32 chunk_size;
+	u32 num_chunks;
+	u32 generation;
+};
+
+static std::vector<std::thread> s_load_threads;
+static std::mutex s_load_lock;
+static std::condition_variable s_load_cv;
+static bool s_load_quit;
+// Guarded by s_load_lock, the helpers take a copy when they wake up.
+static ParallelLoadJob s_load_job;
+// Generation in the upper half, next unclaimed chunk in the lower half, so helpers that wake
+// up late can't claim chunks of a newer draw with the parameters of an older one.
+static std::atomic<u64> s_load_next_chunk;
+static std::atomic<u32> s_load_done_chunks;
+static std::array<s32, PARALLEL_LOAD_MAX_CHUNKS> s_load_written;
+
+static bool ClaimLoadChunk(const ParallelLoadJob& job, u32* chunk)
+{
+	u64 current = s_load_next_chunk.load();
+	while (static_cast<u32>(current >> 32) == job.generation &&
+		static_cast<u32>(current) < job.num_chunks)
+	{
+		if (s_load_next_chunk.compare_exchange_weak(current, current + 1))
+		{
+			*chunk = static_cast<u32>(current);
+			return true;
+		}
+	}
+	return false;
+}
+
+static void RunLoadChunks(const ParallelLoadJob& job)
+{
+	u32 chunk;
+	while (ClaimLoadChunk(job, &chunk))
+	{
+		s32 first = static_cast<s32>(chunk) * job.chunk_size;
+		s32 count = std::min(job.chunk_size, job.count - first);
+		s_load_written[chunk] = job.loader->ConvertRange(
+			job.source + first * job.loader->m_VertexSize,
+			job.destination + first * job.loader->m_native_stride, count);
+		s_load_done_chunks.fetch_add(1);
+	}
+}
+
+static void LoadWorkerThread()
+{
+	Common::SetCurrentThreadName("Vertex loader");
+	u32 last_generation = 0;
+	std::unique_lock<std::mutex> lock(s_load_lock);
+	while (true)
+	{
+		s_load_cv.wait(lock, [&] { return s_load_quit || s_load_job.generation != last_generation; });
+		if (s_load_quit)
+			return;
+
+		ParallelLoadJob job = s_load_job;
+		last_generation = job.generation;
+		lock.unlock();
+		RunLoadChunks(job);
+		lock.lock();
+	}
+}
+
+static s32 RunVerticesParallel(VertexLoaderBase* loader, const VertexLoaderParameters &parameters)
+{
+	loader->PrepareConversion(parameters);
+	loader->m_numLoadedVertices += parameters.count;
+
+	ParallelLoadJob job;
+	job.loader = loader;
+	job.source = parameters.source;
+	job.destination = parameters.destination;
+	job.count = parameters.count;
+	s32 max_chunks = static_cast<s32>(std::min(static_cast<u32>(s_load_threads.size() + 1) * 2, PARALLEL_LOAD_MAX_CHUNKS));
+	job.chunk_size = std::max((job.count + max_chunks - 1) / max_chunks, PARALLEL_LOAD_MIN_CHUNK_VERTICES);
+	job.num_chunks = static_cast<u32>((job.count + job.chunk_size - 1) / job.chunk_size);
+
+	s_load_done_chunks = 0;
+	{
+		std::lock_guard<std::mutex> lock(s_load_lock);
+		job.generation = s_load_job.generation + 1;
+		s_load_job = job;
+		s_load_next_chunk = static_cast<u64>(job.generation) << 32;
+	}
+	s_load_cv.notify_all();
+
+	// Work on the draw ourselves, the helpers only take what is left.
+	RunLoadChunks(job);
+	while (s_load_done_chunks.load() < job.num_chunks)
+		Common::YieldCPU();
+
+	// Skipped vertices leave a gap at the end of their chunk, close them.
+	const s32 stride = loader->m_native_stride;
+	s32 total = s_load_written[0];
+	for (u32 i = 1; i < job.num_chunks; i++)
+	{
+		s32 first = static_cast<s32>(i) * job.chunk_size;
+		if (total != first)
+			memmove(job.destination + total * stride, job.destination + first * stride, s_load_written[i] * stride);
+		total += s_load_written[i];
+	}
+	return total;
+}
+
+static void StartLoadThreads()
+{
+	if (!s_load_threads.empty())
+		return;
+
+	// Leave a core for the CPU and GPU threads each.
+	int count = std::min(cpu_info.logical_cpu_count - 2, PARALLEL_LOAD_MAX_THREADS);
+	s_load_quit = false;
+	for (int i = 0; i < count; i++)
+		s_load_threads.emplace_back(LoadWorkerThread);
+}
+
+static void StopLoadThreads()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_load_lock);
+		s_load_quit = true;
+	}
+	s_load_cv.notify_all();
+	for (std::thread& thread : s_load_threads)
+		thread.join();
+	s_load_threads.clear();
+}
+
 void Init()
 {
 	MarkAllDirty();
 	for (VertexLoaderBase*& vertexLoader : g_main_cp_state.vertex_loaders)
 		vertexLoader = nullptr;
 	last_game_code = SConfig::GetInstance().m_strGameID;
+	StartLoadThreads();
 }
 
 void Shutdown()
 {
+	StopLoadThreads();
 	if (s_vertex_loader_map.size() > 0 && g_ActiveConfig.bDumpVertexLoaders)
+	{
 		DumpLoadersCode();
+		DumpLoadersProfile();
+	}
 	s_vertex_loader_map.clear();
 	s_native_vertex_map.clear();
 }
@@ -305,8 +522,58 @@ bool ConvertVertices(VertexLoaderParameters &parameters, u32 &readsize, u32 &wri
 	g_current_components = loader->m_native_components;
 	g_vertex_manager->PrepareForAdditionalData(parameters.primitive, parameters.count, loader->m_native_stride);
 	parameters.destination = g_vertex_manager->GetCurrentBufferPointer();
-	s32 finalcount = loader->RunVertices(parameters);
+	s32 finalcount;
+	{
+		FrameProfiler::ScopedPass vertex_loading_pass(FrameProfiler::PASS_VERTEX_LOADING);
+		if (g_ActiveConfig.iParallelVertexLoadingThreshold > 0 &&
+			parameters.count >= std::max(g_ActiveConfig.iParallelVertexLoadingThreshold, PARALLEL_LOAD_MIN_CHUNK_VERTICES * 2) &&
+			!s_load_threads.empty() && loader->CanConvertInParallel())
+			finalcount = RunVerticesParallel(loader, parameters);
+		else
+			finalcount = loader->RunVertices(parameters);
+	}
+	writesize = loader->m_native_stride * finalcount;
+	IndexGenerator::AddIndices(parameters.primitive, finalcount);
+	ADDSTAT(stats.thisFrame.numPrims, finalcount);
+	INCSTAT(stats.thisFrame.numPrimitiveJoins);
+	return true;
+}
+
+VertexLoaderBase* GetActiveLoader(VertexLoaderParameters &parameters)
+{
+	if (parameters.needloaderrefresh)
+	{
+		UpdateLoader(parameters);
+		parameters.needloaderrefresh = false;
+	}
+	auto loader = g_main_cp_state.vertex_loaders[parameters.vtx_attr_group];
+	if (!loader->EnvironmentIsSupported())
+	{
+		loader = loader->GetFallback();
+	}
+	return loader;
+}
+
+bool ConvertCachedVertices(VertexLoaderParameters &parameters, const VertexLoaderBase* expected_loader, const u8* data, u32 finalcount, u32 &writesize)
+{
+	VertexLoaderBase* loader = GetActiveLoader(parameters);
+	if (loader != expected_loader)
+		return false;
+	writesize = 0;
+	if (parameters.skip_draw)
+	{
+		return true;
+	}
+	NativeVertexFormat *nativefmt = loader->m_native_vertex_format;
+	if (s_current_vtx_fmt != nullptr && s_current_vtx_fmt != nativefmt)
+	{
+		g_vertex_manager->Flush();
+	}
+	s_current_vtx_fmt = nativefmt;
+	g_current_components = loader->m_native_components;
+	g_vertex_manager->PrepareForAdditionalData(parameters.primitive, parameters.count, loader->m_native_stride);
 	writesize = loader->m_native_stride * finalcount;
+	memcpy(g_vertex_manager->GetCurrentBufferPointer(), data, writesize);
 	IndexGenerator::AddIndices(parameters.primitive, finalcount);
 	ADDSTAT(stats.thisFrame.numPrims, finalcount);
 	INCSTAT(stats.thisFrame.numPrimitiveJoins);
@@ -24,6 +24,13 @@ int GetVertexSize(const VertexLoaderParameters &parameters);
 
 bool ConvertVertices(VertexLoaderParameters &parameters, u32 &readsize, u32 &writesize);
 
+// Used by the display list cache.
+// Returns the loader ConvertVertices would run for the given parameters.
+VertexLoaderBase* GetActiveLoader(VertexLoaderParameters &parameters);
+// Appends vertices previously produced by expected_loader to the vertex buffer.
+// Returns false if the current vertex state no longer selects that loader.
+bool ConvertCachedVertices(VertexLoaderParameters &parameters, const VertexLoaderBase* expected_loader, const u8* data, u32 finalcount, u32 &writesize);
+
 void GetVertexSizeAndComponents(const VertexLoaderParameters &parameters, u32 &vertexsize, u32 &components);
 
 // For debugging
@@ -25,6 +25,14 @@ static const X64Reg count_reg = R10;
 static const X64Reg skipped_reg = R11;
 static const u32 MASKINDEXED = INDEX8 & INDEX16;
 static const X64Reg base_reg = RBX;
+// Only used by the AVX2 loop, which works on two vertices at a time.
+static const X64Reg pair_scratch1 = R12;
+static const X64Reg pair_scratch2 = R13;
+
+static const X64Reg tex_scale_regs[8] = {
+	XMM4, XMM5, XMM6, XMM7,
+	XMM8, XMM9, XMM10, XMM11,
+};
 
 static const u8* memory_base_ptr = (u8*)&g_main_cp_state.array_strides;
 
@@ -49,12 +57,31 @@ static __m128 scale_factors[13] = {
 	_mm_set_ps1(0.0f)
 };
 
+static const __m128i shuffle_lut[5][3] = {
+	{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFF00L),  // 1x u8
+	_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFF01L, 0xFFFFFF00L),  // 2x u8
+	_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFF02L, 0xFFFFFF01L, 0xFFFFFF00L) }, // 3x u8
+	{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0x00FFFFFFL),  // 1x s8
+	_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0x01FFFFFFL, 0x00FFFFFFL),  // 2x s8
+	_mm_set_epi32(0xFFFFFFFFL, 0x02FFFFFFL, 0x01FFFFFFL, 0x00FFFFFFL) }, // 3x s8
+	{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFF0001L),  // 1x u16
+	_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFF0203L, 0xFFFF0001L),  // 2x u16
+	_mm_set_epi32(0xFFFFFFFFL, 0xFFFF0405L, 0xFFFF0203L, 0xFFFF0001L) }, // 3x u16
+	{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0x0001FFFFL),  // 1x s16
+	_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0x0203FFFFL, 0x0001FFFFL),  // 2x s16
+	_mm_set_epi32(0xFFFFFFFFL, 0x0405FFFFL, 0x0203FFFFL, 0x0001FFFFL) }, // 3x s16
+	{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0x00010203L),  // 1x float
+	_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0x04050607L, 0x00010203L),  // 2x float
+	_mm_set_epi32(0xFFFFFFFFL, 0x08090A0BL, 0x04050607L, 0x00010203L) }, // 3x float
+};
+
 VertexLoaderX64::VertexLoaderX64(const TVtxDesc& vtx_desc, const VAT& vtx_att) : VertexLoaderBase(vtx_desc, vtx_att)
 {
 	if (!IsInitialized())
 		return;
 
-	AllocCodeSpace(1024, false);
+	// The AVX2 loop emits the vertex body a second time.
+	AllocCodeSpace(CanLoadPairs() ? 4096 : 1024, false);
 	ClearCodeSpace();
 	GenerateVertexLoader();
 	WriteProtect();
@@ -63,23 +90,28 @@ VertexLoaderX64::VertexLoaderX64(const TVtxDesc& vtx_desc, const VAT& vtx_att) :
 	JitRegister::Register(region, GetCodePtr(), name.c_str());
 }
 
-OpArg VertexLoaderX64::GetVertexAddr(int array, u64 attribute)
+OpArg VertexLoaderX64::GetVertexAddr(int array, u64 attribute, bool second_vertex)
 {
-	OpArg data = MDisp(src_reg, m_src_ofs);
+	// The second vertex of a pair gets its own registers, so both addresses stay live.
+	X64Reg index_reg = second_vertex ? pair_scratch1 : scratch1;
+	X64Reg array_reg = second_vertex ? pair_scratch2 : scratch2;
+	OpArg data = MDisp(src_reg, m_src_ofs + (second_vertex ? m_VertexSize : 0));
 	if (attribute & MASKINDEXED)
 	{
 		int bits = attribute == INDEX8 ? 8 : 16;
-		LoadAndSwap(bits, scratch1, data);
-		m_src_ofs += bits / 8;
-		if (array == ARRAY_POSITION)
+		LoadAndSwap(bits, index_reg, data);
+		if (!second_vertex)
+			m_src_ofs += bits / 8;
+		// The pair loop checks both position indices up front.
+		if (array == ARRAY_POSITION && !m_loading_pair)
 		{
 			CMP(bits, R(scratch1), Imm8(-1));
 			m_skip_vertex = J_CC(CC_E, true);
 		}
 		// TODO: Move cached_arraybases into CPState and use MDisp() relative to a constant register loaded with &g_main_cp_state.
-		IMUL(32, scratch1, MPIC(&g_main_cp_state.array_strides[array]));
-		MOV(64, R(scratch2), MPIC(&cached_arraybases[array]));
-		return MRegSum(scratch1, scratch2);
+		IMUL(32, index_reg, MPIC(&g_main_cp_state.array_strides[array]));
+		MOV(64, R(array_reg), MPIC(&cached_arraybases[array]));
+		return MRegSum(index_reg, array_reg);
 	}
 	else
 	{
@@ -89,24 +121,6 @@ OpArg VertexLoaderX64::GetVertexAddr(int array, u64 attribute)
 
 int VertexLoaderX64::ReadVertex(OpArg data, u64 attribute, int format, int count_in, int count_out, bool dequantize, AttributeFormat* native_format, X64Reg scaling_register)
 {
-	static const __m128i shuffle_lut[5][3] = {
-		{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFF00L),  // 1x u8
-		_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFF01L, 0xFFFFFF00L),  // 2x u8
-		_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFF02L, 0xFFFFFF01L, 0xFFFFFF00L) }, // 3x u8
-		{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0x00FFFFFFL),  // 1x s8
-		_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0x01FFFFFFL, 0x00FFFFFFL),  // 2x s8
-		_mm_set_epi32(0xFFFFFFFFL, 0x02FFFFFFL, 0x01FFFFFFL, 0x00FFFFFFL) }, // 3x s8
-		{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFF0001L),  // 1x u16
-		_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFF0203L, 0xFFFF0001L),  // 2x u16
-		_mm_set_epi32(0xFFFFFFFFL, 0xFFFF0405L, 0xFFFF0203L, 0xFFFF0001L) }, // 3x u16
-		{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0x0001FFFFL),  // 1x s16
-		_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0x0203FFFFL, 0x0001FFFFL),  // 2x s16
-		_mm_set_epi32(0xFFFFFFFFL, 0x0405FFFFL, 0x0203FFFFL, 0x0001FFFFL) }, // 3x s16
-		{ _mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0x00010203L),  // 1x float
-		_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0x04050607L, 0x00010203L),  // 2x float
-		_mm_set_epi32(0xFFFFFFFFL, 0x08090A0BL, 0x04050607L, 0x00010203L) }, // 3x float
-	};
-
 	X64Reg coords = XMM0;
 	int elem_size = 1 << (format / 2);
 	int load_bytes = elem_size * count_in;
@@ -245,6 +259,77 @@ int VertexLoaderX64::ReadVertex(OpArg data, u64 attribute, int format, int count
 	return load_bytes;
 }
 
+int VertexLoaderX64::ReadVertexPair(OpArg data, OpArg second_data, u64 attribute, int format, int count_in, int count_out, bool dequantize, AttributeFormat* native_format, X64Reg scaling_register)
+{
+	int elem_size = 1 << (format / 2);
+	int load_bytes = elem_size * count_in;
+	OpArg dest = MDisp(dst_reg, m_dst_ofs);
+	OpArg second_dest = MDisp(dst_reg, m_dst_ofs + m_native_stride);
+
+	native_format->components = count_out;
+	native_format->enable = true;
+	native_format->offset = m_dst_ofs;
+	native_format->type = FORMAT_FLOAT;
+
+	m_dst_ofs += sizeof(float) * count_out;
+
+	if (attribute == DIRECT)
+		m_src_ofs += load_bytes;
+
+	// Same as the SSSE3 path of ReadVertex, with the first vertex in the lower lane
+	// and the second one in the upper lane. Everything is VEX encoded, the upper
+	// halves are only cleared when leaving the pair loop.
+	for (int i = 0; i < 2; i++)
+	{
+		X64Reg coords = i ? XMM1 : XMM0;
+		OpArg src = i ? second_data : data;
+		if (load_bytes > 8)
+			VMOVDQU(coords, src);
+		else if (load_bytes > 4)
+			VMOVQ_xmm(coords, src);
+		else
+			VMOVD_xmm(coords, src);
+	}
+	VINSERTI128(YMM0, YMM0, R(XMM1), 1);
+
+	VBROADCASTI128(YMM1, MPIC(&shuffle_lut[format][count_in - 1]));
+	VPSHUFB_ymm(YMM0, YMM0, R(YMM1));
+
+	// Sign-extend.
+	if (format == FORMAT_BYTE)
+		VPSRAD_ymm(YMM0, YMM0, 24);
+	if (format == FORMAT_SHORT)
+		VPSRAD_ymm(YMM0, YMM0, 16);
+
+	if (format != FORMAT_FLOAT)
+	{
+		VCVTDQ2PS_ymm(YMM0, R(YMM0));
+
+		if (dequantize)
+			VMULPS_ymm(YMM0, YMM0, R(scaling_register));
+	}
+
+	switch (count_out)
+	{
+	case 1:
+		VEXTRACTI128(R(XMM1), YMM0, 1);
+		VMOVSS(dest, XMM0);
+		VMOVSS(second_dest, XMM1);
+		break;
+	case 2:
+		VEXTRACTI128(R(XMM1), YMM0, 1);
+		VMOVLPS(dest, XMM0);
+		VMOVLPS(second_dest, XMM1);
+		break;
+	case 3:
+		VMOVUPS(dest, XMM0);
+		VEXTRACTI128(second_dest, YMM0, 1);
+		break;
+	}
+
+	return load_bytes;
+}
+
 void VertexLoaderX64::ReadColor(OpArg data, u64 attribute, int format)
 {
 	int load_bytes = 0;
@@ -367,54 +452,17 @@ void VertexLoaderX64::ReadColor(OpArg data, u64 attribute, int format)
 		m_src_ofs += load_bytes;
 }
 
-void VertexLoaderX64::GenerateVertexLoader()
+bool VertexLoaderX64::CanLoadPairs() const
 {
-	BitSet32 regs = { src_reg, dst_reg, scratch1, scratch2, scratch3, count_reg, skipped_reg, base_reg };
-	regs &= ABI_ALL_CALLEE_SAVED;
-	ABI_PushRegistersAndAdjustStack(regs, 0);
-
-	// Backup count since we're going to count it down.
-	PUSH(32, R(ABI_PARAM3));
-
-	// ABI_PARAM3 is one of the lower registers, so free it for scratch2.
-	MOV(32, R(count_reg), R(ABI_PARAM3));
-
-	MOV(64, R(base_reg), R(ABI_PARAM4));
-	// Load Contants into registers outside the main loop to reduce memory overhead
-	if (m_VtxAttr.PosFormat != FORMAT_FLOAT && m_VtxAttr.ByteDequant)
-	{
-		MOVAPD(XMM2, MPIC(&scale_factors[0]));
-	}
-	if (m_VtxDesc.Normal)
-	{
-		MOVAPD(XMM3, MPIC(&scale_factors[m_VtxAttr.NormalFormat + 1]));
-	}
-
-	const u64 tc[8] = {
-		m_VtxDesc.Tex0Coord, m_VtxDesc.Tex1Coord, m_VtxDesc.Tex2Coord, m_VtxDesc.Tex3Coord,
-		m_VtxDesc.Tex4Coord, m_VtxDesc.Tex5Coord, m_VtxDesc.Tex6Coord, m_VtxDesc.Tex7Coord,
-	};
-	const X64Reg treg[8] = {
-		XMM4, XMM5, XMM6, XMM7,
-		XMM8, XMM9, XMM10, XMM11,
-	};
-
-	if (m_VtxAttr.ByteDequant)
-	{
-		for (int i = 0; i < 8; i++)
-		{
-			if (tc[i] && m_VtxAttr.texCoord[i].Format != FORMAT_FLOAT)
-			{
-				MOVAPD(treg[i], MPIC(&scale_factors[5 + i]));
-			}
-		}
-	}
-
-	if (m_VtxDesc.Position & MASKINDEXED)
-		XOR(32, R(skipped_reg), R(skipped_reg));
-
-	const u8* loop_start = GetCodePtr();
+	// Texture matrix indices go through scalar SSE code, those formats are rare enough
+	// to just keep the single vertex loop.
+	return cpu_info.bAVX2 &&
+		!(m_VtxDesc.Tex0MatIdx || m_VtxDesc.Tex1MatIdx || m_VtxDesc.Tex2MatIdx || m_VtxDesc.Tex3MatIdx ||
+			m_VtxDesc.Tex4MatIdx || m_VtxDesc.Tex5MatIdx || m_VtxDesc.Tex6MatIdx || m_VtxDesc.Tex7MatIdx);
+}
 
+void VertexLoaderX64::GenerateVertexBody()
+{
 	if (m_VtxDesc.PosMatIdx)
 	{
 		m_src_ofs++;
@@ -431,22 +479,44 @@ void VertexLoaderX64::GenerateVertexLoader()
 			texmatidx_ofs[i] = m_src_ofs++;
 	}
 
+	OpArg second_data;
+	if (m_loading_pair)
+		second_data = GetVertexAddr(ARRAY_POSITION, m_VtxDesc.Position, true);
 	OpArg data = GetVertexAddr(ARRAY_POSITION, m_VtxDesc.Position);
-	ReadVertex(data, m_VtxDesc.Position, m_VtxAttr.PosFormat, m_VtxAttr.PosElements + 2, 3,
-		m_VtxAttr.ByteDequant, &m_native_vtx_decl.position, XMM2);
+	if (m_loading_pair)
+		ReadVertexPair(data, second_data, m_VtxDesc.Position, m_VtxAttr.PosFormat, m_VtxAttr.PosElements + 2, 3,
+			m_VtxAttr.ByteDequant, &m_native_vtx_decl.position, YMM2);
+	else
+		ReadVertex(data, m_VtxDesc.Position, m_VtxAttr.PosFormat, m_VtxAttr.PosElements + 2, 3,
+			m_VtxAttr.ByteDequant, &m_native_vtx_decl.position, XMM2);
 
 	if (m_VtxDesc.Normal)
 	{
 		for (int i = 0; i < (m_VtxAttr.NormalElements ? 3 : 1); i++)
 		{
+			int elem_size = 1 << (m_VtxAttr.NormalFormat / 2);
 			if (!i || m_VtxAttr.NormalIndex3)
 			{
+				if (m_loading_pair)
+				{
+					second_data = GetVertexAddr(ARRAY_NORMAL, m_VtxDesc.Normal, true);
+					second_data.AddMemOffset(i * elem_size * 3);
+				}
 				data = GetVertexAddr(ARRAY_NORMAL, m_VtxDesc.Normal);
-				int elem_size = 1 << (m_VtxAttr.NormalFormat / 2);
 				data.AddMemOffset(i * elem_size * 3);
 			}
-			data.AddMemOffset(ReadVertex(data, m_VtxDesc.Normal, m_VtxAttr.NormalFormat, 3, 3,
-				true, &m_native_vtx_decl.normals[i], XMM3));
+			if (m_loading_pair)
+			{
+				int load_bytes = ReadVertexPair(data, second_data, m_VtxDesc.Normal, m_VtxAttr.NormalFormat, 3, 3,
+					true, &m_native_vtx_decl.normals[i], YMM3);
+				data.AddMemOffset(load_bytes);
+				second_data.AddMemOffset(load_bytes);
+			}
+			else
+			{
+				data.AddMemOffset(ReadVertex(data, m_VtxDesc.Normal, m_VtxAttr.NormalFormat, 3, 3,
+					true, &m_native_vtx_decl.normals[i], XMM3));
+			}
 		}
 
 		m_native_components |= VB_HAS_NRM0;
@@ -459,6 +529,16 @@ void VertexLoaderX64::GenerateVertexLoader()
 	{
 		if (col[i])
 		{
+			if (m_loading_pair)
+			{
+				// Colors are converted in general purpose registers, one vertex after the other.
+				second_data = GetVertexAddr(ARRAY_COLOR + i, col[i], true);
+				u32 src_ofs = m_src_ofs;
+				m_dst_ofs += m_native_stride;
+				ReadColor(second_data, col[i], m_VtxAttr.color[i].Comp);
+				m_dst_ofs -= m_native_stride;
+				m_src_ofs = src_ofs;
+			}
 			data = GetVertexAddr(ARRAY_COLOR + i, col[i]);
 			ReadColor(data, col[i], m_VtxAttr.color[i].Comp);
 			m_native_components |= VB_HAS_COL0 << i;
@@ -470,14 +550,24 @@ void VertexLoaderX64::GenerateVertexLoader()
 		}
 	}
 
+	const u64 tc[8] = {
+		m_VtxDesc.Tex0Coord, m_VtxDesc.Tex1Coord, m_VtxDesc.Tex2Coord, m_VtxDesc.Tex3Coord,
+		m_VtxDesc.Tex4Coord, m_VtxDesc.Tex5Coord, m_VtxDesc.Tex6Coord, m_VtxDesc.Tex7Coord,
+	};
 	for (int i = 0; i < 8; i++)
 	{
 		int elements = m_VtxAttr.texCoord[i].Elements + 1;
 		if (tc[i])
 		{
+			if (m_loading_pair)
+				second_data = GetVertexAddr(ARRAY_TEXCOORD0 + i, tc[i], true);
 			data = GetVertexAddr(ARRAY_TEXCOORD0 + i, tc[i]);
-			ReadVertex(data, tc[i], m_VtxAttr.texCoord[i].Format, elements, tm[i] ? 2 : elements,
-				m_VtxAttr.ByteDequant, &m_native_vtx_decl.texcoords[i], treg[i]);
+			if (m_loading_pair)
+				ReadVertexPair(data, second_data, tc[i], m_VtxAttr.texCoord[i].Format, elements, elements,
+					m_VtxAttr.ByteDequant, &m_native_vtx_decl.texcoords[i], tex_scale_regs[i]);
+			else
+				ReadVertex(data, tc[i], m_VtxAttr.texCoord[i].Format, elements, tm[i] ? 2 : elements,
+					m_VtxAttr.ByteDequant, &m_native_vtx_decl.texcoords[i], tex_scale_regs[i]);
 			m_native_components |= VB_HAS_UV0 << i;
 		}
 		if (tm[i])
@@ -504,21 +594,83 @@ void VertexLoaderX64::GenerateVertexLoader()
 			}
 		}
 	}
-	if (m_VtxDesc.PosMatIdx)
-	{
-		MOVZX(32, 8, scratch1, MDisp(src_reg, 0));
-	}
-	else
+	// The second vertex of a pair is written first, like the other attributes.
+	for (int i = m_loading_pair ? 1 : 0; i >= 0; i--)
 	{
-		MOV(32, R(scratch1), MPIC(&g_main_cp_state.matrix_index_a));
+		if (m_VtxDesc.PosMatIdx)
+		{
+			MOVZX(32, 8, scratch1, MDisp(src_reg, i * m_VertexSize));
+		}
+		else
+		{
+			MOV(32, R(scratch1), MPIC(&g_main_cp_state.matrix_index_a));
+		}
+		AND(32, R(scratch1), Imm8(0x3F));
+		MOV(32, MDisp(dst_reg, m_dst_ofs + i * m_native_stride), R(scratch1));
 	}
-	AND(32, R(scratch1), Imm8(0x3F));
-	MOV(32, MDisp(dst_reg, m_dst_ofs), R(scratch1));
 	m_native_vtx_decl.posmtx.components = 4;
 	m_native_vtx_decl.posmtx.enable = true;
 	m_native_vtx_decl.posmtx.offset = m_dst_ofs;
 	m_native_vtx_decl.posmtx.type = FORMAT_UBYTE;
 	m_dst_ofs += sizeof(u32);
+}
+
+void VertexLoaderX64::GenerateVertexLoader()
+{
+	bool load_pairs = CanLoadPairs();
+	BitSet32 regs = { src_reg, dst_reg, scratch1, scratch2, scratch3, count_reg, skipped_reg, base_reg };
+	if (load_pairs)
+	{
+		regs[pair_scratch1] = true;
+		regs[pair_scratch2] = true;
+	}
+	regs &= ABI_ALL_CALLEE_SAVED;
+	ABI_PushRegistersAndAdjustStack(regs, 0);
+
+	// Backup count since we're going to count it down.
+	PUSH(32, R(ABI_PARAM3));
+
+	// ABI_PARAM3 is one of the lower registers, so free it for scratch2.
+	MOV(32, R(count_reg), R(ABI_PARAM3));
+
+	MOV(64, R(base_reg), R(ABI_PARAM4));
+	// Load Contants into registers outside the main loop to reduce memory overhead
+	if (m_VtxAttr.PosFormat != FORMAT_FLOAT && m_VtxAttr.ByteDequant)
+	{
+		MOVAPD(XMM2, MPIC(&scale_factors[0]));
+	}
+	if (m_VtxDesc.Normal)
+	{
+		MOVAPD(XMM3, MPIC(&scale_factors[m_VtxAttr.NormalFormat + 1]));
+	}
+
+	const u64 tc[8] = {
+		m_VtxDesc.Tex0Coord, m_VtxDesc.Tex1Coord, m_VtxDesc.Tex2Coord, m_VtxDesc.Tex3Coord,
+		m_VtxDesc.Tex4Coord, m_VtxDesc.Tex5Coord, m_VtxDesc.Tex6Coord, m_VtxDesc.Tex7Coord,
+	};
+
+	if (m_VtxAttr.ByteDequant)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			if (tc[i] && m_VtxAttr.texCoord[i].Format != FORMAT_FLOAT)
+			{
+				MOVAPD(tex_scale_regs[i], MPIC(&scale_factors[5 + i]));
+			}
+		}
+	}
+
+	if (m_VtxDesc.Position & MASKINDEXED)
+		XOR(32, R(skipped_reg), R(skipped_reg));
+
+	// With AVX2 the pair loop runs first, this loop only handles single vertices it can't take.
+	FixupBranch to_pairs;
+	if (load_pairs)
+		to_pairs = J(true);
+
+	const u8* loop_start = GetCodePtr();
+
+	GenerateVertexBody();
 
 	// Prepare for the next vertex.
 
@@ -527,9 +679,18 @@ void VertexLoaderX64::GenerateVertexLoader()
 	ADD(64, R(src_reg), Imm32(m_src_ofs));
 
 	SUB(32, R(count_reg), Imm8(1));
-	J_CC(CC_NZ, loop_start);
+	FixupBranch next_pair;
+	if (load_pairs)
+		next_pair = J_CC(CC_NZ, true);
+	else
+		J_CC(CC_NZ, loop_start);
+
+	m_native_stride = m_dst_ofs;
+	m_VertexSize = m_src_ofs;
+	m_native_vtx_decl.stride = m_native_stride;
 
 	// Get the original count.
+	const u8* loop_exit = GetCodePtr();
 	POP(32, R(ABI_RETURN));
 
 	ABI_PopRegistersAndAdjustStack(regs, 0);
@@ -547,9 +708,87 @@ void VertexLoaderX64::GenerateVertexLoader()
 	{
 		RET();
 	}
-	m_native_stride = m_dst_ofs;
-	m_VertexSize = m_src_ofs;
-	m_native_vtx_decl.stride = m_native_stride;
+
+	if (load_pairs)
+	{
+		SetJumpTarget(to_pairs);
+		SetJumpTarget(next_pair);
+		GeneratePairLoop(loop_start, loop_exit);
+	}
+}
+
+void VertexLoaderX64::GeneratePairLoop(const u8* single_vertex, const u8* loop_exit)
+{
+	CMP(32, R(count_reg), Imm8(2));
+	J_CC(CC_B, single_vertex);
+
+	// VZEROUPPER on the way out of this loop clears the upper lanes, so broadcast the
+	// scale factors again every time we come back.
+	if (m_VtxAttr.PosFormat != FORMAT_FLOAT && m_VtxAttr.ByteDequant)
+	{
+		VBROADCASTF128(YMM2, MPIC(&scale_factors[0]));
+	}
+	if (m_VtxDesc.Normal)
+	{
+		VBROADCASTF128(YMM3, MPIC(&scale_factors[m_VtxAttr.NormalFormat + 1]));
+	}
+
+	const u64 tc[8] = {
+		m_VtxDesc.Tex0Coord, m_VtxDesc.Tex1Coord, m_VtxDesc.Tex2Coord, m_VtxDesc.Tex3Coord,
+		m_VtxDesc.Tex4Coord, m_VtxDesc.Tex5Coord, m_VtxDesc.Tex6Coord, m_VtxDesc.Tex7Coord,
+	};
+	if (m_VtxAttr.ByteDequant)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			if (tc[i] && m_VtxAttr.texCoord[i].Format != FORMAT_FLOAT)
+			{
+				VBROADCASTF128(tex_scale_regs[i], MPIC(&scale_factors[5 + i]));
+			}
+		}
+	}
+
+	const u8* loop_start = GetCodePtr();
+
+	// If either vertex is skipped, let the single vertex loop deal with the first one.
+	FixupBranch skip_first, skip_second;
+	if (m_VtxDesc.Position & MASKINDEXED)
+	{
+		// There are no texture matrix indices here, so only the position matrix index comes first.
+		int bits = m_VtxDesc.Position == INDEX8 ? 8 : 16;
+		u32 index_ofs = m_VtxDesc.PosMatIdx ? 1 : 0;
+		LoadAndSwap(bits, scratch1, MDisp(src_reg, index_ofs));
+		CMP(bits, R(scratch1), Imm8(-1));
+		skip_first = J_CC(CC_E, true);
+		LoadAndSwap(bits, scratch1, MDisp(src_reg, index_ofs + m_VertexSize));
+		CMP(bits, R(scratch1), Imm8(-1));
+		skip_second = J_CC(CC_E, true);
+	}
+
+	m_src_ofs = 0;
+	m_dst_ofs = 0;
+	m_loading_pair = true;
+	GenerateVertexBody();
+	m_loading_pair = false;
+
+	ADD(64, R(dst_reg), Imm32(2 * m_native_stride));
+	ADD(64, R(src_reg), Imm32(2 * m_VertexSize));
+	SUB(32, R(count_reg), Imm8(2));
+	CMP(32, R(count_reg), Imm8(2));
+	J_CC(CC_AE, loop_start);
+
+	VZEROUPPER();
+	TEST(32, R(count_reg), R(count_reg));
+	J_CC(CC_NZ, single_vertex);
+	JMP(loop_exit, true);
+
+	if (m_VtxDesc.Position & MASKINDEXED)
+	{
+		SetJumpTarget(skip_first);
+		SetJumpTarget(skip_second);
+		VZEROUPPER();
+		JMP(single_vertex, true);
+	}
 }
 
 bool VertexLoaderX64::EnvironmentIsSupported()
@@ -557,7 +796,7 @@ bool VertexLoaderX64::EnvironmentIsSupported()
 	return g_ActiveConfig.iBBoxMode == BBoxGPU || !BoundingBox::active;
 }
 
-int VertexLoaderX64::RunVertices(const VertexLoaderParameters &parameters)
+void VertexLoaderX64::PrepareConversion(const VertexLoaderParameters &parameters)
 {
 	const VAT &vat = *parameters.VtxAttr;
 	scale_factors[0] = _mm_set_ps1(fractionTable[vat.g0.PosFrac]);
@@ -572,6 +811,16 @@ int VertexLoaderX64::RunVertices(const VertexLoaderParameters &parameters)
 		scale_factors[11] = _mm_set_ps1(fractionTable[vat.g2.Tex6Frac]);
 		scale_factors[12] = _mm_set_ps1(fractionTable[vat.g2.Tex7Frac]);
 	}
+}
+
+s32 VertexLoaderX64::ConvertRange(const u8* src, u8* dst, s32 count) const
+{
+	return ((int(*)(const u8* src, u8* dst, int count, const void*))region)(src, dst, count, memory_base_ptr);
+}
+
+int VertexLoaderX64::RunVertices(const VertexLoaderParameters &parameters)
+{
+	PrepareConversion(parameters);
 	m_numLoadedVertices += parameters.count;
-	return ((int(*)(const u8* src, u8* dst, int count, const void*))region)(parameters.source, parameters.destination, parameters.count, memory_base_ptr);
+	return ConvertRange(parameters.source, parameters.destination, parameters.count);
 }
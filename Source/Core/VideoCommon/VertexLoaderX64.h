@@ -13,12 +13,24 @@ protected:
 	}
 	int RunVertices(const VertexLoaderParameters &parameters) override;
 	bool EnvironmentIsSupported() override;
+	bool CanConvertInParallel() const override
+	{
+		return true;
+	}
+	void PrepareConversion(const VertexLoaderParameters &parameters) override;
+	s32 ConvertRange(const u8* src, u8* dst, s32 count) const override;
 private:
 	u32 m_src_ofs = 0;
 	u32 m_dst_ofs = 0;
 	Gen::FixupBranch m_skip_vertex;
-	Gen::OpArg GetVertexAddr(int array, u64 attribute);
+	// Set while emitting the AVX2 loop, which converts two vertices per iteration.
+	bool m_loading_pair = false;
+	Gen::OpArg GetVertexAddr(int array, u64 attribute, bool second_vertex = false);
 	int ReadVertex(Gen::OpArg data, u64 attribute, int format, int count_in, int count_out, bool dequantize, AttributeFormat* native_format, Gen::X64Reg scaling_register);
+	int ReadVertexPair(Gen::OpArg data, Gen::OpArg second_data, u64 attribute, int format, int count_in, int count_out, bool dequantize, AttributeFormat* native_format, Gen::X64Reg scaling_register);
 	void ReadColor(Gen::OpArg data, u64 attribute, int format);
+	bool CanLoadPairs() const;
+	void GenerateVertexBody();
+	void GeneratePairLoop(const u8* single_vertex, const u8* loop_exit);
 	void GenerateVertexLoader();
 };
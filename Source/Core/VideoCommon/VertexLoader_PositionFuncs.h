@@ -24,7 +24,7 @@ __forceinline u8* IndexedDataPosition(TPipelineState &pipelinestate)
 	auto const index = pipelinestate.Read<T>();
 	if (index == std::numeric_limits<T>::max())
 	{
-		g_PipelineState.skippedVertices++;
+		pipelinestate.skippedVertices++;
 		pipelinestate.flags |= TPS_SKIP_VERTEX;
 	}
 	return cached_arraybases[ARRAY_POSITION] + (index * g_main_cp_state.array_strides[ARRAY_POSITION]);
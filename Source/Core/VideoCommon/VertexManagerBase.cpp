@@ -6,10 +6,12 @@
 #include <memory>
 
 #include "Common/CommonTypes.h"
+#include "Common/TraceEvents.h"
 #include "Core/ConfigManager.h"
 
 #include "VideoCommon/BPStructs.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/TessellationShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
@@ -23,6 +25,7 @@
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
@@ -134,6 +137,8 @@ std::pair<size_t, size_t> VertexManagerBase::ResetFlushAspectRatioCount()
 
 void VertexManagerBase::DoFlush()
 {
+	FrameProfiler::ScopedPass draw_pass(FrameProfiler::PASS_DRAW);
+	TRACE_SCOPE("VertexManager::Flush");
 	// loading a state will invalidate BP, so check for it
 	NativeVertexFormat* current_vertex_format = VertexLoaderManager::GetCurrentVertexFormat();
 	g_video_backend->CheckInvalidState();
@@ -261,6 +266,7 @@ void VertexManagerBase::DoFlush()
 	if (PerfQueryBase::ShouldEmulate())
 		g_perf_query->EnableQuery(bpmem.zcontrol.early_ztest ? PQG_ZCOMP_ZCOMPLOC : PQG_ZCOMP);
 	g_vertex_manager->vFlush(useDstAlpha);
+	VideoBackendBase::InvalidateEFBPeekTiles();
 	if (PerfQueryBase::ShouldEmulate())
 		g_perf_query->DisableQuery(bpmem.zcontrol.early_ztest ? PQG_ZCOMP_ZCOMPLOC : PQG_ZCOMP);
 
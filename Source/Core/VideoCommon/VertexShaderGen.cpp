@@ -13,6 +13,7 @@
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DriverDetails.h"
+#include "VideoCommon/GeometryShaderGen.h"
 #include "VideoCommon/LightingShaderGen.h"
 #include "VideoCommon/VertexShaderGen.h"
 #include "VideoCommon/VideoConfig.h"
@@ -37,6 +38,7 @@ void GetVertexShaderUID(VertexShaderUid& out, u32 components, const XFMemory &xf
 	}
 	uid_data.pixel_lighting = enable_pl;
 	uid_data.numColorChans = xfr.numChan.numColorChans;
+	uid_data.stereo = g_ActiveConfig.VertexShaderStereoEnabled();
 
 	if ((g_ActiveConfig.backend_info.APIType & API_D3D9) == 0)
 	{
@@ -126,6 +128,16 @@ inline void GenerateVertexShader(ShaderCode& out, const vertex_shader_uid_data&
 	if (!(api_type == API_D3D9))
 		out.Write("};\n");
 
+	if (uid_data.stereo)
+	{
+		// The eye offsets are shared with the geometry shader
+		out.Write("UBO_BINDING(std140, 3) uniform GSBlock {\n"
+			"\tfloat4 " I_STEREOPARAMS";\n"
+			"\tfloat4 " I_LINEPTPARAMS";\n"
+			"\tint4 " I_TEXOFFSET";\n"
+			"};\n");
+	}
+
 	out.Write("struct VS_OUTPUT {\n");
 	GenerateVSOutputMembers<api_type>(out, uid_data.pixel_lighting, uid_data.numTexGens);
 	out.Write("};\n");
@@ -157,6 +169,8 @@ inline void GenerateVertexShader(ShaderCode& out, const vertex_shader_uid_data&
 		{
 			out.Write("VARYING_LOCATION(0) out VertexData {\n");
 			GenerateVSOutputMembers<api_type>(out, uid_data.pixel_lighting, uid_data.numTexGens, GetInterpolationQualifier(api_type, uid_data.msaa, uid_data.ssaa, false, true));
+			if (uid_data.stereo)
+				out.Write("\tflat int layer;\n");
 			out.Write("} vs;\n");
 		}
 		else
@@ -522,6 +536,17 @@ inline void GenerateVertexShader(ShaderCode& out, const vertex_shader_uid_data&
 		}
 	}
 
+	if (uid_data.stereo)
+	{
+		// Each eye is a separate instance of the draw, offset the same way the geometry
+		// shader does it when it duplicates the primitives
+		out.Write("int eye = gl_InstanceID;\n");
+		out.Write("float hoffset = (eye == 0) ? " I_STEREOPARAMS ".x : " I_STEREOPARAMS ".y;\n");
+		out.Write("o.pos.x += hoffset * (o.pos.w - " I_STEREOPARAMS ".z);\n");
+		out.Write("vs.layer = eye;\n");
+		out.Write("gl_Layer = eye;\n");
+	}
+
 	if (api_type == API_OPENGL || api_type == API_VULKAN)
 	{
 		if (g_ActiveConfig.backend_info.bSupportsGeometryShaders || api_type == API_VULKAN)
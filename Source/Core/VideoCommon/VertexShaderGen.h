@@ -80,7 +80,8 @@ struct vertex_shader_uid_data
 	u32 ssaa : 1;
 
 	u32 texMtxInfo_n_projection : 16; // Stored separately to guarantee that the texMtxInfo struct is 8 bits wide
-	u32 pad0 : 16;
+	u32 stereo : 1;
+	u32 pad0 : 15;
 
 	struct
 	{
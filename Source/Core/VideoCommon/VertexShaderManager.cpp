@@ -185,8 +185,8 @@ static void ViewportCorrectionMatrix(Matrix44& result)
 
 void VertexShaderManager::Init()
 {
-	Dirty();
 	m_buffer.Clear();
+	Dirty();
 	memset(&xfmem, 0, sizeof(xfmem));
 	ResetView();
 
@@ -242,6 +242,7 @@ void VertexShaderManager::Dirty()
 
 	s_materials_changed = 15;
 	memset(s_lights_phong, 0, sizeof(s_lights_phong));
+	m_buffer.SetAllDirty();
 }
 
 // Syncs the shader constant buffers with xfmem
@@ -24,6 +24,10 @@ typedef struct _EFBPeekCacheElement
 	u32 DepthFrame;
 }EFBPeekCacheElement;
 
+// Peeks are answered a whole tile at a time, so games that peek many nearby pixels
+// only have to wait for the GPU thread once per tile.
+static const u32 EFB_PEEK_TILE_SIZE = 16;
+
 enum FieldType
 {
 	Odd = 0,
@@ -109,6 +113,9 @@ public:
 
 	void CheckInvalidState();
 
+	// Call from the GPU thread whenever the EFB contents may have changed.
+	static void InvalidateEFBPeekTiles();
+
 protected:
 	void InitializeShared();
 	void ShutdownShared();
@@ -122,6 +129,12 @@ protected:
 	u32 m_EFB_PCache_Divisor;
 	u32 m_EFB_PCache_Life;
 	EFBPeekCacheElement* m_EFB_PCache;
+
+	u32 PeekEFBTile(EFBAccessType type, u32 x, u32 y);
+	// Color and depth values, stored tile by tile, and the EFB generation each tile was read at.
+	std::vector<u32> m_EFB_PeekTiles[2];
+	std::vector<u32> m_EFB_PeekTileGeneration[2];
+	u32 m_EFB_PeekTileAlphaReadMode = 0;
 };
 
 extern std::vector<std::unique_ptr<VideoBackendBase>> g_available_video_backends;
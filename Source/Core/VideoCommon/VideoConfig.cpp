@@ -14,17 +14,30 @@
 #include "Core/Movie.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/ShaderGenCommon.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 
 VideoConfig g_Config;
 VideoConfig g_ActiveConfig;
+static int s_dynamic_efb_scale = SCALE_AUTO;
 
 void UpdateActiveConfig()
 {
 	if (Movie::IsPlayingInput() && Movie::IsConfigSaved())
 		Movie::SetGraphicsConfig();
 	g_ActiveConfig = g_Config;
+	if (s_dynamic_efb_scale != SCALE_AUTO && g_ActiveConfig.bDynamicResolution &&
+		g_ActiveConfig.iEFBScale > s_dynamic_efb_scale)
+	{
+		g_ActiveConfig.iEFBScale = s_dynamic_efb_scale;
+	}
+	InvalidateShaderUIDs();
+}
+
+void SetDynamicEFBScale(int scale)
+{
+	s_dynamic_efb_scale = scale;
 }
 
 VideoConfig::VideoConfig()
@@ -78,8 +91,10 @@ void VideoConfig::Load(const std::string& ini_file)
 	settings->Get("ShowNetPlayPing", &bShowNetPlayPing, false);
 	settings->Get("ShowNetPlayMessages", &bShowNetPlayMessages, false);
 	settings->Get("LogRenderTimeToFile", &bLogRenderTimeToFile, false);
+	settings->Get("LogPassTimesToFile", &bLogPassTimesToFile, false);
 	settings->Get("ShowInputDisplay", &bShowInputDisplay, false);
 	settings->Get("OverlayStats", &bOverlayStats, false);
+	settings->Get("OverlayPassTimes", &bOverlayPassTimes, false);
 	settings->Get("OverlayProjStats", &bOverlayProjStats, false);
 	settings->Get("DumpTextures", &bDumpTextures, 0);
 	settings->Get("DumpVertexLoader", &bDumpVertexLoaders, 0);
@@ -88,13 +103,19 @@ void VideoConfig::Load(const std::string& ini_file)
 	settings->Get("HiresMaterialMapsBuild", &bHiresMaterialMapsBuild, false);
 	settings->Get("ConvertHiresTextures", &bConvertHiresTextures, 0);
 	settings->Get("CacheHiresTextures", &bCacheHiresTextures, 0);
+	settings->Get("HostMemoryBudget", &iHostMemoryBudget, 0);
+	settings->Get("BuildHiresTexturePack", &bBuildHiresTexturePack, false);
 	settings->Get("DumpEFBTarget", &bDumpEFBTarget, 0);
 	settings->Get("DumpFramesAsImages", &bDumpFramesAsImages, 0);
 	settings->Get("FreeLook", &bFreeLook, 0);
 	settings->Get("CompileShaderOnStartup", &bCompileShaderOnStartup, 1);
+	settings->Get("SharedShaderCache", &bSharedShaderCache, true);
+	settings->Get("SharedShaderCacheSizeMB", &iSharedShaderCacheSizeMB, 512);
+	settings->Get("ExportShaderCacheBundle", &bExportShaderCacheBundle, false);
 	settings->Get("UseFFV1", &bUseFFV1, 0);
 	settings->Get("DumpFormat", &sDumpFormat, "avi");
 	settings->Get("DumpCodec", &sDumpCodec, "");
+	settings->Get("DumpEncoder", &sDumpEncoder, "");
 	settings->Get("DumpPath", &sDumpPath, "");
 	settings->Get("BitrateKbps", &iBitrateKbps, 2500);
 	settings->Get("InternalResolutionFrameDumps", &bInternalResolutionFrameDumps, 0);
@@ -115,6 +136,9 @@ void VideoConfig::Load(const std::string& ini_file)
 	settings->Get("FastDepthCalc", &bFastDepthCalc, true);
 	settings->Get("MSAA", &iMultisamples, 1);
 	settings->Get("EFBScale", &iEFBScale, (int)SCALE_2X); // native	
+	settings->Get("DynamicResolution", &bDynamicResolution, false);
+	settings->Get("DynamicResolutionMinScale", &iDynamicResolutionMinScale, (int)SCALE_1X);
+	settings->Get("AdaptiveFrameSkip", &iAdaptiveFrameSkip, 0);
 	settings->Get("TexFmtOverlayEnable", &bTexFmtOverlayEnable, 0);
 	settings->Get("TexFmtOverlayCenter", &bTexFmtOverlayCenter, 0);
 	settings->Get("WireFrame", &bWireFrame, 0);
@@ -134,6 +158,7 @@ void VideoConfig::Load(const std::string& ini_file)
 	settings->Get("EnableValidationLayer", &bEnableValidationLayer, false);
 	settings->Get("BackendMultithreading", &bBackendMultithreading, true);
 	settings->Get("CommandBufferExecuteInterval", &iCommandBufferExecuteInterval, 100);
+	settings->Get("ParallelVertexLoadingThreshold", &iParallelVertexLoadingThreshold, 4096);
 
 	IniFile::Section* enhancements = iniFile.GetOrCreateSection("Enhancements");
 	enhancements->Get("ForceFiltering", &bForceFiltering, 0);
@@ -167,15 +192,21 @@ void VideoConfig::Load(const std::string& ini_file)
 	hacks->Get("EFBFastAccess", &bEFBFastAccess, false);
 	hacks->Get("ForceProgressive", &bForceProgressive, true);
 	hacks->Get("EFBToTextureEnable", &bSkipEFBCopyToRam, true);
+	hacks->Get("DeferEFBCopies", &bDeferEFBCopies, false);
 	hacks->Get("EFBScaledCopy", &bCopyEFBScaled, true);
 	hacks->Get("EFBEmulateFormatChanges", &bEFBEmulateFormatChanges, false);
 	hacks->Get("ForceDualSourceBlend", &bForceDualSourceBlend, false);
 	hacks->Get("FullAsyncShaderCompilation", &bFullAsyncShaderCompilation, true);
 	hacks->Get("WaitForShaderCompilation", &bWaitForShaderCompilation, false);
+	hacks->Get("WaitForTextureDecoding", &bWaitForTextureDecoding, false);
+	hacks->Get("TrackTextureWrites", &bTrackTextureWrites, false);
 	hacks->Get("EnableGPUTextureDecoding", &bEnableGPUTextureDecoding, false);
 	hacks->Get("EnableComputeTextureEncoding", &bEnableComputeTextureEncoding, false);
 	hacks->Get("PredictiveFifo", &bPredictiveFifo, false);
+	hacks->Get("DisplayListCache", &bDisplayListCache, false);
 	hacks->Get("BoundingBoxMode", &iBBoxMode, (int)BBoxMode::BBoxNone);
+	hacks->Get("BBoxAsyncReadback", &bBBoxAsyncReadback, false);
+	hacks->Get("PerfQueriesAsync", &bPerfQueriesAsync, false);
 	hacks->Get("LastStoryEFBToRam", &bLastStoryEFBToRam, false);
 	hacks->Get("ForceLogicOpBlend", &bForceLogicOpBlend, false);
 	hacks->Get("VertexRounding", &bVertexRounding, false);
@@ -276,11 +307,15 @@ void VideoConfig::GameIniLoad()
 			}
 		}
 	}
+	CHECK_SETTING("Video_Settings", "DynamicResolution", bDynamicResolution);
+	CHECK_SETTING("Video_Settings", "DynamicResolutionMinScale", iDynamicResolutionMinScale);
+	CHECK_SETTING("Video_Settings", "AdaptiveFrameSkip", iAdaptiveFrameSkip);
 
 	CHECK_SETTING("Video_Settings", "DisableFog", bDisableFog);
 	CHECK_SETTING("Video_Settings", "EnableOpenCL", bEnableOpenCL);
 	CHECK_SETTING("Video_Settings", "BackendMultithreading", bBackendMultithreading);
 	CHECK_SETTING("Video_Settings", "CommandBufferExecuteInterval", iCommandBufferExecuteInterval);
+	CHECK_SETTING("Video_Settings", "ParallelVertexLoadingThreshold", iParallelVertexLoadingThreshold);
 
 	// These are not overrides, they are per-game stereoscopy parameters, hence no warning
 	iniFile.GetIfExists("Video_Stereoscopy", "StereoConvergence", &iStereoConvergence, 20);
@@ -315,11 +350,15 @@ void VideoConfig::GameIniLoad()
 	CHECK_SETTING("Video_Hacks", "EFBFastAccess", bEFBFastAccess);
 	CHECK_SETTING("Video_Hacks", "ForceProgressive", bForceProgressive);
 	CHECK_SETTING("Video_Hacks", "EFBToTextureEnable", bSkipEFBCopyToRam);
+	CHECK_SETTING("Video_Hacks", "DeferEFBCopies", bDeferEFBCopies);
 	CHECK_SETTING("Video_Hacks", "EFBScaledCopy", bCopyEFBScaled);
 	CHECK_SETTING("Video_Hacks", "EFBEmulateFormatChanges", bEFBEmulateFormatChanges);
 	CHECK_SETTING("Video_Hacks", "BoundingBoxMode", iBBoxMode);
+	CHECK_SETTING("Video_Hacks", "BBoxAsyncReadback", bBBoxAsyncReadback);
+	CHECK_SETTING("Video_Hacks", "PerfQueriesAsync", bPerfQueriesAsync);
 	CHECK_SETTING("Video_Hacks", "LastStoryEFBToRam", bLastStoryEFBToRam);
 	CHECK_SETTING("Video_Hacks", "VertexRounding", bVertexRounding);
+	CHECK_SETTING("Video_Hacks", "DisplayListCache", bDisplayListCache);
 
 	CHECK_SETTING("Video", "ProjectionHack", iPhackvalue[0]);
 	CHECK_SETTING("Video", "PH_SZNear", iPhackvalue[1]);
@@ -330,6 +369,8 @@ void VideoConfig::GameIniLoad()
 	CHECK_SETTING("Video", "PerfQueriesEnable", bPerfQueriesEnable);
 	CHECK_SETTING("Video", "FullAsyncShaderCompilation", bFullAsyncShaderCompilation);
 	CHECK_SETTING("Video", "WaitForShaderCompilation", bWaitForShaderCompilation);
+	CHECK_SETTING("Video", "WaitForTextureDecoding", bWaitForTextureDecoding);
+	CHECK_SETTING("Video", "TrackTextureWrites", bTrackTextureWrites);
 	CHECK_SETTING("Video", "EnableGPUTextureDecoding", bEnableGPUTextureDecoding);
 	CHECK_SETTING("Video", "EnableComputeTextureEncoding", bEnableComputeTextureEncoding);
 	CHECK_SETTING("Video", "PredictiveFifo", bPredictiveFifo);
@@ -339,8 +380,6 @@ void VideoConfig::GameIniLoad()
 
 void VideoConfig::VerifyValidity()
 {
-	// Disable while is unstable
-	bEnableOpenCL = false;
 	// TODO: Check iMaxAnisotropy value
 	if (iAdapter < 0 || iAdapter >((int)backend_info.Adapters.size() - 1))
 		iAdapter = 0;
@@ -424,8 +463,10 @@ void VideoConfig::Save(const std::string& ini_file)
 	settings->Set("ShowNetPlayPing", bShowNetPlayPing);
 	settings->Set("ShowNetPlayMessages", bShowNetPlayMessages);
 	settings->Set("LogRenderTimeToFile", bLogRenderTimeToFile);
+	settings->Set("LogPassTimesToFile", bLogPassTimesToFile);
 	settings->Set("ShowInputDisplay", bShowInputDisplay);
 	settings->Set("OverlayStats", bOverlayStats);
+	settings->Set("OverlayPassTimes", bOverlayPassTimes);
 	settings->Set("OverlayProjStats", bOverlayProjStats);
 	settings->Set("DumpTextures", bDumpTextures);
 	settings->Set("DumpVertexLoader", bDumpVertexLoaders);
@@ -434,14 +475,20 @@ void VideoConfig::Save(const std::string& ini_file)
 	settings->Set("HiresMaterialMapsBuild", bHiresMaterialMapsBuild);
 	settings->Set("ConvertHiresTextures", bConvertHiresTextures);
 	settings->Set("CacheHiresTextures", bCacheHiresTextures);
+	settings->Set("HostMemoryBudget", iHostMemoryBudget);
+	settings->Set("BuildHiresTexturePack", bBuildHiresTexturePack);
 	settings->Set("DumpEFBTarget", bDumpEFBTarget);
 	settings->Set("DumpFramesAsImages", bDumpFramesAsImages);
 	settings->Set("FreeLook", bFreeLook);
 	settings->Set("InternalResolutionFrameDumps", bInternalResolutionFrameDumps);
 	settings->Set("CompileShaderOnStartup", bCompileShaderOnStartup);
+	settings->Set("SharedShaderCache", bSharedShaderCache);
+	settings->Set("SharedShaderCacheSizeMB", iSharedShaderCacheSizeMB);
+	settings->Set("ExportShaderCacheBundle", bExportShaderCacheBundle);
 	settings->Set("UseFFV1", bUseFFV1);
 	settings->Set("DumpFormat", sDumpFormat);
 	settings->Set("DumpCodec", sDumpCodec);
+	settings->Set("DumpEncoder", sDumpEncoder);
 	settings->Set("DumpPath", sDumpPath);
 	settings->Set("BitrateKbps", iBitrateKbps);
 	settings->Set("EnablePixelLighting", bEnablePixelLighting);
@@ -462,6 +509,9 @@ void VideoConfig::Save(const std::string& ini_file)
 	settings->Set("MSAA", iMultisamples);
 	settings->Set("SSAA", bSSAA);
 	settings->Set("EFBScale", iEFBScale);
+	settings->Set("DynamicResolution", bDynamicResolution);
+	settings->Set("DynamicResolutionMinScale", iDynamicResolutionMinScale);
+	settings->Set("AdaptiveFrameSkip", iAdaptiveFrameSkip);
 	settings->Set("TexFmtOverlayEnable", bTexFmtOverlayEnable);
 	settings->Set("TexFmtOverlayCenter", bTexFmtOverlayCenter);
 	settings->Set("Wireframe", bWireFrame);
@@ -481,6 +531,7 @@ void VideoConfig::Save(const std::string& ini_file)
 	settings->Set("EnableValidationLayer", bEnableValidationLayer);
 	settings->Set("BackendMultithreading", bBackendMultithreading);
 	settings->Set("CommandBufferExecuteInterval", iCommandBufferExecuteInterval);
+	settings->Set("ParallelVertexLoadingThreshold", iParallelVertexLoadingThreshold);
 
 	IniFile::Section* enhancements = iniFile.GetOrCreateSection("Enhancements");
 	enhancements->Set("ForceFiltering", bForceFiltering);
@@ -514,15 +565,21 @@ void VideoConfig::Save(const std::string& ini_file)
 	hacks->Set("EFBFastAccess", bEFBFastAccess);
 	hacks->Set("ForceProgressive", bForceProgressive);
 	hacks->Set("EFBToTextureEnable", bSkipEFBCopyToRam);
+	hacks->Set("DeferEFBCopies", bDeferEFBCopies);
 	hacks->Set("EFBScaledCopy", bCopyEFBScaled);
 	hacks->Set("EFBEmulateFormatChanges", bEFBEmulateFormatChanges);
 	hacks->Set("ForceDualSourceBlend", bForceDualSourceBlend);
 	hacks->Set("FullAsyncShaderCompilation", bFullAsyncShaderCompilation);
 	hacks->Set("WaitForShaderCompilation", bWaitForShaderCompilation);
+	hacks->Set("WaitForTextureDecoding", bWaitForTextureDecoding);
+	hacks->Set("TrackTextureWrites", bTrackTextureWrites);
 	hacks->Set("EnableGPUTextureDecoding", bEnableGPUTextureDecoding);
 	hacks->Set("EnableComputeTextureEncoding", bEnableComputeTextureEncoding);
 	hacks->Set("PredictiveFifo", bPredictiveFifo);
+	hacks->Set("DisplayListCache", bDisplayListCache);
 	hacks->Set("BoundingBoxMode", iBBoxMode);
+	hacks->Set("BBoxAsyncReadback", bBBoxAsyncReadback);
+	hacks->Set("PerfQueriesAsync", bPerfQueriesAsync);
 	hacks->Set("LastStoryEFBToRam", bLastStoryEFBToRam);
 	hacks->Set("ForceLogicOpBlend", bForceLogicOpBlend);
 	hacks->Set("VertexRounding", bVertexRounding);
@@ -102,6 +102,12 @@ struct VideoConfig final
 	int iMultisamples;
 	bool bSSAA;
 	int iEFBScale;
+	// Lowers the EFB scale down to iDynamicResolutionMinScale when the GPU can't keep up,
+	// iEFBScale is then the upper bound.
+	bool bDynamicResolution;
+	int iDynamicResolutionMinScale;
+	// Skips drawing frames once presenting falls this many frames behind emulated time, 0 disables
+	int iAdaptiveFrameSkip;
 	bool bForceFiltering;
 	bool bDisableTextureFiltering;
 	int iMaxAnisotropy;
@@ -128,10 +134,12 @@ struct VideoConfig final
 	bool bShowNetPlayMessages;
 	bool bShowInputDisplay;
 	bool bOverlayStats;
+	bool bOverlayPassTimes;
 	bool bOverlayProjStats;
 	bool bTexFmtOverlayEnable;
 	bool bTexFmtOverlayCenter;
 	bool bLogRenderTimeToFile;
+	bool bLogPassTimesToFile;
 
 
 	// Render
@@ -146,10 +154,15 @@ struct VideoConfig final
 	bool bHiresMaterialMapsBuild;
 	bool bConvertHiresTextures;
 	bool bCacheHiresTextures;
+	// Host RAM in MB that the custom texture cache may use, 0 picks a limit from the system RAM
+	int iHostMemoryBudget;
+	bool bBuildHiresTexturePack;
 	bool bDumpEFBTarget;
 	bool bDumpFramesAsImages;
 	bool bUseFFV1;
 	std::string sDumpCodec;
+	// libav encoder name, hardware encoders go here, sDumpCodec is the fallback.
+	std::string sDumpEncoder;
 	std::string sDumpFormat;
 	std::string sDumpPath;
 	bool bInternalResolutionFrameDumps;
@@ -157,6 +170,11 @@ struct VideoConfig final
 	bool bBorderlessFullscreen;
 	int iBitrateKbps;
 	bool bCompileShaderOnStartup;
+	// Programs are also kept in a cache shared by all games, limited to this many MiB.
+	bool bSharedShaderCache;
+	int iSharedShaderCacheSizeMB;
+	// Writes the game's shader caches to a bundle on shutdown, see ShaderCacheBundle.
+	bool bExportShaderCacheBundle;
 
 
 	// Hacks
@@ -164,13 +182,19 @@ struct VideoConfig final
 	bool bEFBFastAccess;
 	bool bForceProgressive;
 	bool bPerfQueriesEnable;
+	// Polling the PE counters returns the last complete values instead of stalling the GPU.
+	bool bPerfQueriesAsync;
 	bool bFullAsyncShaderCompilation;
 	bool bPredictiveFifo;
+	bool bDisplayListCache;
 	bool bWaitForShaderCompilation;
+	bool bWaitForTextureDecoding;
+	bool bTrackTextureWrites;
 	bool bEnableGPUTextureDecoding;
 	bool bEnableComputeTextureEncoding;
 	bool bEFBEmulateFormatChanges;
 	bool bSkipEFBCopyToRam;
+	bool bDeferEFBCopies;
 	bool bCopyEFBScaled;
 	int iSafeTextureCache_ColorSamples;
 	int iPhackvalue[4];
@@ -195,6 +219,8 @@ struct VideoConfig final
 	bool bFastDepthCalc;
 	bool bVertexRounding;
 	int iBBoxMode;
+	// GPU mode, bounding box reads return the last frame's value instead of syncing.
+	bool bBBoxAsyncReadback;
 	//for dx9-backend
 	bool bForceDualSourceBlend;
 	int iLog; // CONF_ bits
@@ -230,6 +256,9 @@ struct VideoConfig final
 	// Currently only supported with Vulkan.
 	int iCommandBufferExecuteInterval;
 
+	// Draws with at least this many vertices are converted on several threads, 0 disables it.
+	int iParallelVertexLoadingThreshold;
+
 	// Static config per API
 	// TODO: Move this out of VideoConfig
 	struct
@@ -260,6 +289,7 @@ struct VideoConfig final
 		bool bSupportsExclusiveFullscreen;
 		bool bSupportsBBox;
 		bool bSupportsGSInstancing; // Needed by GeometryShaderGen, so must stay in VideoCommon
+		bool bSupportsVSLayerOutput; // Needed by VertexShaderGen, so must stay in VideoCommon
 		bool bSupportsPaletteConversion;
 		bool bSupportsClipControl; // Needed by VertexShaderGen, so must stay in VideoCommon
 		bool bSupportsSSAA;
@@ -300,6 +330,12 @@ struct VideoConfig final
 	{
 		return backend_info.bSupportsGPUTextureDecoding && bEnableGPUTextureDecoding;
 	}
+	// Both eyes are drawn by one instanced draw with the vertex shader selecting the layer,
+	// so the geometry shader is only needed for lines, points and wireframe
+	inline bool VertexShaderStereoEnabled() const
+	{
+		return iStereoMode > 0 && backend_info.bSupportsVSLayerOutput && backend_info.bSupportsGeometryShaders;
+	}
 };
 
 extern VideoConfig g_Config;
@@ -307,3 +343,5 @@ extern VideoConfig g_ActiveConfig;
 
 // Called every frame.
 void UpdateActiveConfig();
+// Overrides the EFB scale g_ActiveConfig gets on the next update, SCALE_AUTO clears it.
+void SetDynamicEFBScale(int scale);
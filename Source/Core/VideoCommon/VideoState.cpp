@@ -12,6 +12,7 @@
 #include "VideoCommon/TessellationShaderManager.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/ShaderGenCommon.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
@@ -31,6 +32,9 @@ void VideoCommon_DoState(PointerWrap &p)
 	p.Do(xfmem);
 	p.DoMarker("XF Memory");
 
+	if (p.GetMode() == PointerWrap::MODE_READ)
+		InvalidateShaderUIDs();
+
 	// Texture decoder
 	p.DoArray(texMem);
 	p.DoMarker("texMem");
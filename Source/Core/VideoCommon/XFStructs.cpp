@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "Common/Common.h"
 #include "Core/HW/Memmap.h"
 
@@ -14,6 +16,20 @@
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/ShaderGenCommon.h"
+
+// Games tend to reload the same matrices and registers between draws. Only flush when the
+// incoming data differs from what's already there, so those draws still share a batch.
+static bool XFDataChanged(u32 address, u32 size, u32 dataIndex)
+{
+	const u32* currData = (u32*)&xfmem + address;
+	for (u32 i = 0; i < size; ++i)
+	{
+		if (currData[i] != g_VideoData.Peek<u32>((dataIndex + i) * sizeof(u32)))
+			return true;
+	}
+	return false;
+}
 
 inline void XFMemWritten(u32 transferSize, u32 baseAddress)
 {
@@ -87,7 +103,7 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 		case XFMEM_SETCHAN1_COLOR:
 		case XFMEM_SETCHAN0_ALPHA: // Channel Alpha
 		case XFMEM_SETCHAN1_ALPHA:
-			if (((u32*)&xfmem)[address - 0x1000] != (newValue & 0x7fff))
+			if (((u32*)&xfmem)[address] != (newValue & 0x7fff))
 				g_vertex_manager->Flush();
 			break;
 
@@ -112,10 +128,13 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 		case XFMEM_SETVIEWPORT + 3:
 		case XFMEM_SETVIEWPORT + 4:
 		case XFMEM_SETVIEWPORT + 5:
-			g_vertex_manager->Flush();
-			VertexShaderManager::SetViewportChanged();
-			GeometryShaderManager::SetViewportChanged();
-			PixelShaderManager::SetViewportChanged();
+			if (XFDataChanged(address, std::min<u32>(XFMEM_SETVIEWPORT + 6 - address, transferSize), dataIndex))
+			{
+				g_vertex_manager->Flush();
+				VertexShaderManager::SetViewportChanged();
+				GeometryShaderManager::SetViewportChanged();
+				PixelShaderManager::SetViewportChanged();
+			}
 			nextAddress = XFMEM_SETVIEWPORT + 6;
 			break;
 
@@ -126,9 +145,12 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 		case XFMEM_SETPROJECTION + 4:
 		case XFMEM_SETPROJECTION + 5:
 		case XFMEM_SETPROJECTION + 6:
-			g_vertex_manager->Flush();
-			VertexShaderManager::SetProjectionChanged();
-			GeometryShaderManager::SetProjectionChanged();
+			if (XFDataChanged(address, std::min<u32>(XFMEM_SETPROJECTION + 7 - address, transferSize), dataIndex))
+			{
+				g_vertex_manager->Flush();
+				VertexShaderManager::SetProjectionChanged();
+				GeometryShaderManager::SetProjectionChanged();
+			}
 			nextAddress = XFMEM_SETPROJECTION + 7;
 			break;
 
@@ -145,7 +167,8 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 		case XFMEM_SETTEXMTXINFO + 5:
 		case XFMEM_SETTEXMTXINFO + 6:
 		case XFMEM_SETTEXMTXINFO + 7:
-			g_vertex_manager->Flush();
+			if (XFDataChanged(address, std::min<u32>(XFMEM_SETTEXMTXINFO + 8 - address, transferSize), dataIndex))
+				g_vertex_manager->Flush();
 
 			nextAddress = XFMEM_SETTEXMTXINFO + 8;
 			break;
@@ -158,7 +181,8 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
 		case XFMEM_SETPOSMTXINFO + 5:
 		case XFMEM_SETPOSMTXINFO + 6:
 		case XFMEM_SETPOSMTXINFO + 7:
-			g_vertex_manager->Flush();
+			if (XFDataChanged(address, std::min<u32>(XFMEM_SETPOSMTXINFO + 8 - address, transferSize), dataIndex))
+				g_vertex_manager->Flush();
 
 			nextAddress = XFMEM_SETPOSMTXINFO + 8;
 			break;
@@ -232,13 +256,16 @@ void LoadXFReg(u32 transferSize, u32 baseAddress)
 			transferSize = 0;
 		}
 
-		XFMemWritten(xfMemTransferSize, xfMemBase);
+		if (XFDataChanged(xfMemBase, xfMemTransferSize, 0))
+			XFMemWritten(xfMemTransferSize, xfMemBase);
 		OpcodeDecoder::DataReadU32xFuncs[xfMemTransferSize - 1](&((u32*)&xfmem)[xfMemBase]);
 	}
 
 	// write to XF regs
 	if (transferSize > 0)
 	{
+		// Plain XF memory holds matrices and lights, only the registers go into the UIDs
+		InvalidateShaderUIDs();
 		XFRegWritten(transferSize, baseAddress);
 		OpcodeDecoder::DataReadU32xFuncs[transferSize - 1](&((u32*)&xfmem)[baseAddress]);
 	}
@@ -2123,8 +2123,11 @@ PC_TexFormat TexDecoder_Decode(u8 *dst, const u8 *src, u32 width, u32 height, u3
 {
 	PC_TexFormat retval = PC_TEX_FMT_NONE;
 #ifdef _WIN32
-	retval = TexDecoder_Decode_OpenCL(dst, src,
-		width, height, texformat, tlutaddr, tlutfmt, rgbaOnly);
+	// The texture was created for the format the CPU decoder produces, only the RGBA kernels are
+	// guaranteed to write the same one.
+	if (rgbaOnly)
+		retval = TexDecoder_Decode_OpenCL(dst, src,
+			width, height, texformat, tlutaddr, tlutfmt, rgbaOnly);
 
 	if (retval == PC_TEX_FMT_NONE)
 	{
@@ -0,0 +1,144 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/Analytics.h"
+
+namespace
+{
+// Owned by the test, the reporter owns the backend that fills it.
+struct ReceivedReports
+{
+  std::mutex lock;
+  std::condition_variable cv;
+  std::vector<std::string> reports;
+
+  bool WaitFor(size_t count)
+  {
+    std::unique_lock<std::mutex> lk(lock);
+    return cv.wait_for(lk, std::chrono::seconds(10), [&] { return reports.size() >= count; });
+  }
+};
+
+class TestBackend : public Common::AnalyticsReportingBackend
+{
+public:
+  explicit TestBackend(ReceivedReports* received) : m_received(received) {}
+  void Send(std::string report) override
+  {
+    std::lock_guard<std::mutex> lk(m_received->lock);
+    m_received->reports.push_back(std::move(report));
+    m_received->cv.notify_all();
+  }
+
+private:
+  ReceivedReports* m_received;
+};
+
+Common::AnalyticsReportBuilder MakeReport(s32 thread, s32 index)
+{
+  Common::AnalyticsReportBuilder builder;
+  builder.AddData("thread", thread).AddData("index", index);
+  return builder;
+}
+}
+
+TEST(Analytics, QueuedUntilBackendSet)
+{
+  ReceivedReports received;
+  Common::AnalyticsReporter reporter;
+
+  for (s32 i = 0; i < 10; ++i)
+    reporter.Send(MakeReport(0, i));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  reporter.SetBackend(std::make_unique<TestBackend>(&received));
+
+  ASSERT_TRUE(received.WaitFor(10));
+  std::lock_guard<std::mutex> lk(received.lock);
+  ASSERT_EQ(10u, received.reports.size());
+  for (s32 i = 0; i < 10; ++i)
+    EXPECT_EQ(MakeReport(0, i).Get(), received.reports[i]);
+}
+
+TEST(Analytics, DropsOverCountLimit)
+{
+  ReceivedReports received;
+  Common::AnalyticsReporter reporter;
+
+  for (s32 i = 0; i < 40; ++i)
+    reporter.Send(MakeReport(0, i));
+  reporter.SetBackend(std::make_unique<TestBackend>(&received));
+
+  ASSERT_TRUE(received.WaitFor(25));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::lock_guard<std::mutex> lk(received.lock);
+  ASSERT_EQ(25u, received.reports.size());
+  // The oldest reports are the ones kept
+  for (s32 i = 0; i < 25; ++i)
+    EXPECT_EQ(MakeReport(0, i).Get(), received.reports[i]);
+}
+
+TEST(Analytics, DropsOverByteLimit)
+{
+  ReceivedReports received;
+  Common::AnalyticsReporter reporter;
+
+  const std::string payload(100 * 1024, 'x');
+  for (s32 i = 0; i < 3; ++i)
+    reporter.Send(MakeReport(0, i).AddData("payload", payload));
+  reporter.SetBackend(std::make_unique<TestBackend>(&received));
+
+  ASSERT_TRUE(received.WaitFor(2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::lock_guard<std::mutex> lk(received.lock);
+  EXPECT_EQ(2u, received.reports.size());
+}
+
+TEST(Analytics, ConcurrentSenders)
+{
+  constexpr s32 THREADS = 4;
+  constexpr s32 REPORTS_PER_THREAD = 6;
+
+  // Stays under the count limit, so every report has to arrive exactly once and in the order
+  // its thread sent it.
+  for (int round = 0; round < 50; ++round)
+  {
+    ReceivedReports received;
+    Common::AnalyticsReporter reporter;
+
+    std::vector<std::thread> senders;
+    for (s32 t = 0; t < THREADS; ++t)
+    {
+      senders.emplace_back([&reporter, t] {
+        for (s32 i = 0; i < REPORTS_PER_THREAD; ++i)
+          reporter.Send(MakeReport(t, i));
+      });
+    }
+    for (std::thread& sender : senders)
+      sender.join();
+    reporter.SetBackend(std::make_unique<TestBackend>(&received));
+
+    ASSERT_TRUE(received.WaitFor(THREADS * REPORTS_PER_THREAD));
+    std::lock_guard<std::mutex> lk(received.lock);
+    ASSERT_EQ(static_cast<size_t>(THREADS * REPORTS_PER_THREAD), received.reports.size());
+    for (s32 t = 0; t < THREADS; ++t)
+    {
+      s32 next = 0;
+      for (const std::string& report : received.reports)
+      {
+        if (next < REPORTS_PER_THREAD && report == MakeReport(t, next).Get())
+          ++next;
+      }
+      EXPECT_EQ(REPORTS_PER_THREAD, next) << "thread " << t;
+    }
+  }
+}
@@ -0,0 +1,132 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "Common/FileUtil.h"
+#include "Common/IniFile.h"
+
+namespace
+{
+class IniFileTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = File::CreateTempDir();
+    ASSERT_FALSE(m_dir.empty());
+  }
+  void TearDown() override { File::DeleteDirRecursively(m_dir); }
+
+  IniFile LoadIni(const std::string& contents)
+  {
+    const std::string path = m_dir + "/test.ini";
+    EXPECT_TRUE(File::WriteStringToFile(contents, path));
+    IniFile ini;
+    EXPECT_TRUE(ini.Load(path));
+    return ini;
+  }
+
+  std::string m_dir;
+};
+}
+
+TEST_F(IniFileTest, SectionsAndKeys)
+{
+  IniFile ini = LoadIni("# comment before any section\n"
+                           "[Core]\n"
+                           "CPUThread = True\n"
+                           "Speed=1.5\n"
+                           "Name = \"Some Game\"\n"
+                           "\n"
+                           "[Video]\n"
+                           "EFBScale = 0x00000002\n");
+
+  bool cpu_thread = false;
+  EXPECT_TRUE(ini.GetOrCreateSection("Core")->Get("CPUThread", &cpu_thread));
+  EXPECT_TRUE(cpu_thread);
+  float speed = 0.0f;
+  EXPECT_TRUE(ini.GetOrCreateSection("core")->Get("speed", &speed));
+  EXPECT_EQ(1.5f, speed);
+  std::string name;
+  EXPECT_TRUE(ini.GetOrCreateSection("Core")->Get("Name", &name));
+  EXPECT_EQ("Some Game", name);
+  u32 scale = 0;
+  EXPECT_TRUE(ini.GetOrCreateSection("Video")->Get("EFBScale", &scale));
+  EXPECT_EQ(2u, scale);
+
+  EXPECT_FALSE(ini.Exists("Video", "CPUThread"));
+  std::vector<std::string> keys;
+  EXPECT_FALSE(ini.GetKeys("Audio", &keys));
+}
+
+TEST_F(IniFileTest, LineEndings)
+{
+  IniFile ini = LoadIni("\xEF\xBB\xBF[A]\r\nFirst = 1\r\n[B]\nSecond = two\r\nLast = end");
+
+  int first = 0;
+  EXPECT_TRUE(ini.GetOrCreateSection("A")->Get("First", &first));
+  EXPECT_EQ(1, first);
+  std::string second, last;
+  EXPECT_TRUE(ini.GetOrCreateSection("B")->Get("Second", &second));
+  EXPECT_EQ("two", second);
+  EXPECT_TRUE(ini.GetOrCreateSection("B")->Get("Last", &last));
+  EXPECT_EQ("end", last);
+}
+
+TEST_F(IniFileTest, RawLines)
+{
+  IniFile ini = LoadIni("[OnFrame]\r\n"
+                           "$Infinite Health\r\n"
+                           "0x80001234:dword:0x00000001\r\n"
+                           "*Enabled by default\r\n"
+                           "\r\n"
+                           "+$Other\n");
+
+  std::vector<std::string> lines;
+  EXPECT_TRUE(ini.GetLines("OnFrame", &lines, false));
+  const std::vector<std::string> expected = {"$Infinite Health", "0x80001234:dword:0x00000001",
+                                             "*Enabled by default", "+$Other"};
+  EXPECT_EQ(expected, lines);
+}
+
+TEST_F(IniFileTest, ValueLists)
+{
+  IniFile ini = LoadIni("[Paths]\nList = a, b ,c\nEmpty =\n");
+
+  std::vector<std::string> values;
+  EXPECT_TRUE(ini.GetOrCreateSection("Paths")->Get("List", &values));
+  const std::vector<std::string> expected = {"a", "b", "c"};
+  EXPECT_EQ(expected, values);
+
+  values.clear();
+  EXPECT_FALSE(ini.GetOrCreateSection("Paths")->Get("Empty", &values));
+  EXPECT_TRUE(values.empty());
+}
+
+TEST_F(IniFileTest, EmptyAndMissingFiles)
+{
+  IniFile empty = LoadIni("");
+  std::vector<std::string> keys;
+  EXPECT_FALSE(empty.GetKeys("Core", &keys));
+
+  IniFile missing;
+  EXPECT_FALSE(missing.Load(m_dir + "/missing.ini"));
+}
+
+TEST_F(IniFileTest, KeepCurrentData)
+{
+  IniFile ini = LoadIni("[Core]\nA = 1\nB = 2\n");
+  const std::string path = m_dir + "/overlay.ini";
+  ASSERT_TRUE(File::WriteStringToFile("[Core]\nB = 3\n", path));
+  EXPECT_TRUE(ini.Load(path, true));
+
+  int a = 0, b = 0;
+  EXPECT_TRUE(ini.GetOrCreateSection("Core")->Get("A", &a));
+  EXPECT_TRUE(ini.GetOrCreateSection("Core")->Get("B", &b));
+  EXPECT_EQ(1, a);
+  EXPECT_EQ(3, b);
+}
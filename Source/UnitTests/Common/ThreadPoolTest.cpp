@@ -0,0 +1,128 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Common/ThreadPool.h"
+
+namespace
+{
+bool WaitForCount(const std::atomic<int>& counter, int expected)
+{
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (counter.load() < expected)
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+void CheckParallelCoverage(int lower, int upper, int min_block_size)
+{
+  const int size = upper > lower ? upper - lower : 0;
+  std::unique_ptr<std::atomic<int>[]> hits(new std::atomic<int>[size]);
+  for (int i = 0; i < size; ++i)
+    hits[i] = 0;
+  std::atomic<int> calls(0);
+
+  Common::AsyncWorker::ExecuteParallel([&](int begin, int end) {
+    EXPECT_LE(lower, begin);
+    EXPECT_LT(begin, end);
+    EXPECT_LE(end, upper);
+    for (int i = begin; i < end; ++i)
+      hits[i - lower]++;
+    calls++;
+  }, lower, upper, min_block_size);
+
+  // Every block has to be done by the time ExecuteParallel returns
+  for (int i = 0; i < size; ++i)
+    EXPECT_EQ(1, hits[i].load()) << "index " << lower + i;
+  if (size == 0)
+  {
+    EXPECT_EQ(0, calls.load());
+  }
+}
+}
+
+TEST(ThreadPool, ExecuteParallelCoversRange)
+{
+  CheckParallelCoverage(0, 0, 16);
+  CheckParallelCoverage(5, 3, 16);
+  CheckParallelCoverage(0, 1, 16);
+  CheckParallelCoverage(0, 15, 16);
+  CheckParallelCoverage(0, 1000, 1);
+  CheckParallelCoverage(0, 1000, 16);
+  CheckParallelCoverage(-500, 501, 7);
+  CheckParallelCoverage(3, 100003, 64);
+}
+
+TEST(ThreadPool, ExecuteParallelRepeated)
+{
+  for (int i = 0; i < 200; ++i)
+    CheckParallelCoverage(0, 4096, 32);
+}
+
+TEST(ThreadPool, ExecuteParallelFromSeveralThreads)
+{
+  std::vector<std::thread> callers;
+  for (int t = 0; t < 4; ++t)
+  {
+    callers.emplace_back([] {
+      for (int i = 0; i < 50; ++i)
+        CheckParallelCoverage(0, 2048, 16);
+    });
+  }
+  for (std::thread& caller : callers)
+    caller.join();
+}
+
+TEST(ThreadPool, ExecuteAsyncRunsEveryTask)
+{
+  constexpr int TASKS = 10000;
+  std::atomic<int> done(0);
+  for (int i = 0; i < TASKS; ++i)
+    Common::AsyncWorker::ExecuteAsync([&done] { done++; });
+  EXPECT_TRUE(WaitForCount(done, TASKS));
+  EXPECT_EQ(TASKS, done.load());
+}
+
+TEST(ThreadPool, ExecuteAsyncFromSeveralThreads)
+{
+  constexpr int THREADS = 4;
+  constexpr int TASKS_PER_THREAD = 2500;
+  std::atomic<int> done(0);
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < THREADS; ++t)
+  {
+    producers.emplace_back([&done] {
+      for (int i = 0; i < TASKS_PER_THREAD; ++i)
+        Common::AsyncWorker::ExecuteAsync([&done] { done++; });
+    });
+  }
+  for (std::thread& producer : producers)
+    producer.join();
+
+  EXPECT_TRUE(WaitForCount(done, THREADS * TASKS_PER_THREAD));
+  EXPECT_EQ(THREADS * TASKS_PER_THREAD, done.load());
+}
+
+TEST(ThreadPool, ExecuteAsyncWakesParkedWorkers)
+{
+  std::atomic<int> done(0);
+  for (int i = 0; i < 5; ++i)
+  {
+    // Long enough for the idle workers to park
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    Common::AsyncWorker::ExecuteAsync([&done] { done++; });
+    EXPECT_TRUE(WaitForCount(done, i + 1));
+  }
+}
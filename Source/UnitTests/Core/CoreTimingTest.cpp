@@ -4,9 +4,15 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <functional>
+#include <random>
+#include <tuple>
+#include <vector>
 
+#include "Common/ChunkFile.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -124,6 +130,191 @@ TEST(CoreTiming, SharedSlot)
   EXPECT_EQ(0x1FULL, s_callbacks_ran_flags.to_ullong());
 }
 
+TEST(CoreTiming, LongHorizonOrder)
+{
+  ScopeInit guard;
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", CallbackTemplate<1>);
+  CoreTiming::EventType* cb_c = CoreTiming::RegisterEvent("callbackC", CallbackTemplate<2>);
+  CoreTiming::EventType* cb_d = CoreTiming::RegisterEvent("callbackD", CallbackTemplate<3>);
+  CoreTiming::EventType* cb_e = CoreTiming::RegisterEvent("callbackE", CallbackTemplate<4>);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  // Far enough apart that events have to move from the overflow heap into the timing wheel.
+  // D -> B -> C -> A -> E
+  CoreTiming::ScheduleEvent(1000000, cb_a, CB_IDS[0]);
+  CoreTiming::ScheduleEvent(300000, cb_b, CB_IDS[1]);
+  CoreTiming::ScheduleEvent(300001, cb_c, CB_IDS[2]);
+  CoreTiming::ScheduleEvent(5000, cb_d, CB_IDS[3]);
+  CoreTiming::ScheduleEvent(2000000, cb_e, CB_IDS[4]);
+
+  for (u32 idx : {3, 1, 2, 0, 4})
+  {
+    s_callbacks_ran_flags = 0;
+    s_expected_callback = CB_IDS[idx];
+    s_lateness = 0;
+    while (s_callbacks_ran_flags.none())
+    {
+      PowerPC::ppcState.downcount = 0;
+      CoreTiming::Advance();
+    }
+    EXPECT_EQ(decltype(s_callbacks_ran_flags)().set(idx), s_callbacks_ran_flags);
+  }
+  EXPECT_EQ(MAX_SLICE_LENGTH, PowerPC::ppcState.downcount);
+}
+
+namespace RandomizedOrderTest
+{
+// What a callback saw
+struct Fired
+{
+  int type;
+  u64 userdata;
+  s64 lateness;
+
+  bool operator==(const Fired& other) const
+  {
+    return std::tie(type, userdata, lateness) == std::tie(other.type, other.userdata, other.lateness);
+  }
+};
+
+struct ReferenceEvent
+{
+  s64 time;
+  u64 fifo_order;
+  int type;
+  u64 userdata;
+
+  bool operator>(const ReferenceEvent& other) const
+  {
+    return std::tie(time, fifo_order) > std::tie(other.time, other.fifo_order);
+  }
+};
+
+static std::vector<Fired> s_fired;
+
+template <int IDX>
+static void RecordCallback(u64 userdata, s64 lateness)
+{
+  s_fired.push_back({IDX, userdata, lateness});
+}
+
+static void SaveAndReload()
+{
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  CoreTiming::DoState(p);
+  std::vector<u8> state(reinterpret_cast<size_t>(ptr));
+
+  ptr = state.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  CoreTiming::DoState(p);
+
+  ptr = state.data();
+  p.SetMode(PointerWrap::MODE_READ);
+  CoreTiming::DoState(p);
+}
+}
+
+// Runs random schedules, removals, advances and save state round trips, and checks every
+// callback against a binary heap ordered the same way. The delays reach well past the timing
+// wheel's 64 * 4096 cycle horizon, so events go through the overflow heap too.
+TEST(CoreTiming, RandomizedOrderMatchesHeap)
+{
+  using namespace RandomizedOrderTest;
+
+  ScopeInit guard;
+
+  constexpr int TYPE_COUNT = 4;
+  const std::array<CoreTiming::EventType*, TYPE_COUNT> types{{
+      CoreTiming::RegisterEvent("randomA", RecordCallback<0>),
+      CoreTiming::RegisterEvent("randomB", RecordCallback<1>),
+      CoreTiming::RegisterEvent("randomC", RecordCallback<2>),
+      CoreTiming::RegisterEvent("randomD", RecordCallback<3>),
+  }};
+  constexpr s64 WHEEL_HORIZON = 64 * 4096;
+
+  std::vector<ReferenceEvent> reference;
+  u64 fifo_order = 0;
+  u64 next_userdata = 0;
+  std::mt19937 rng(1234);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  for (int step = 0; step < 200000; ++step)
+  {
+    const u32 op = rng() % 100;
+    if (op < 45)
+    {
+      s64 delay;
+      const u32 range = rng() % 10;
+      if (range < 1)
+        delay = -static_cast<s64>(rng() % 1000);
+      else if (range < 6)
+        delay = rng() % MAX_SLICE_LENGTH;
+      else if (range < 8)
+        delay = rng() % WHEEL_HORIZON;
+      else
+        delay = WHEEL_HORIZON + rng() % (WHEEL_HORIZON * 8);
+      // Some events share a time, fifo order has to break the tie
+      if (!reference.empty() && rng() % 8 == 0)
+        delay = reference[rng() % reference.size()].time - static_cast<s64>(CoreTiming::GetTicks());
+
+      const int type = rng() % TYPE_COUNT;
+      reference.push_back({static_cast<s64>(CoreTiming::GetTicks()) + delay, fifo_order++, type,
+                           next_userdata});
+      std::push_heap(reference.begin(), reference.end(), std::greater<ReferenceEvent>());
+      CoreTiming::ScheduleEvent(delay, types[type], next_userdata++);
+    }
+    else if (op < 48)
+    {
+      const int type = rng() % TYPE_COUNT;
+      reference.erase(std::remove_if(reference.begin(), reference.end(),
+                                     [type](const ReferenceEvent& ev) { return ev.type == type; }),
+                      reference.end());
+      std::make_heap(reference.begin(), reference.end(), std::greater<ReferenceEvent>());
+      CoreTiming::RemoveEvent(types[type]);
+    }
+    else if (op < 50)
+    {
+      SaveAndReload();
+    }
+    else
+    {
+      // Run part of the slice, or all of it
+      if (rng() % 2)
+        PowerPC::ppcState.downcount = 0;
+      else
+        PowerPC::ppcState.downcount = rng() % (std::max(PowerPC::ppcState.downcount, 0) + 1);
+      const s64 now = CoreTiming::g_global_timer + CoreTiming::g_slice_length -
+                      PowerPC::ppcState.downcount;
+
+      std::vector<Fired> expected;
+      while (!reference.empty() && reference.front().time <= now)
+      {
+        const ReferenceEvent& ev = reference.front();
+        expected.push_back({ev.type, ev.userdata, now - ev.time});
+        std::pop_heap(reference.begin(), reference.end(), std::greater<ReferenceEvent>());
+        reference.pop_back();
+      }
+
+      s_fired.clear();
+      CoreTiming::Advance();
+      ASSERT_EQ(now, CoreTiming::g_global_timer);
+      ASSERT_TRUE(expected == s_fired) << "step " << step;
+
+      const s64 expected_slice =
+          reference.empty() ? MAX_SLICE_LENGTH :
+                              std::min<s64>(reference.front().time - now, MAX_SLICE_LENGTH);
+      ASSERT_EQ(expected_slice, PowerPC::ppcState.downcount) << "step " << step;
+    }
+  }
+}
+
 TEST(CoreTiming, PredictableLateness)
 {
   ScopeInit guard;
@@ -0,0 +1,92 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core/IPC_HLE/WII_IPC_HLE_Device_FileIO.h"
+
+TEST(HostIOQueue, RunsInOrder)
+{
+  constexpr int ITEMS = 1000;
+  std::vector<int> order;
+  std::mutex order_lock;
+
+  for (int i = 0; i < ITEMS; ++i)
+  {
+    HLE_IPC_QueueHostIO([&order, &order_lock, i] {
+      std::lock_guard<std::mutex> lk(order_lock);
+      order.push_back(i);
+    });
+  }
+  HLE_IPC_WaitForHostIO();
+
+  std::lock_guard<std::mutex> lk(order_lock);
+  ASSERT_EQ(static_cast<size_t>(ITEMS), order.size());
+  for (int i = 0; i < ITEMS; ++i)
+    EXPECT_EQ(i, order[i]);
+}
+
+TEST(HostIOQueue, WaitWithNothingQueued)
+{
+  HLE_IPC_WaitForHostIO();
+  HLE_IPC_WaitForHostIO();
+}
+
+// The file deleters queue the close on the host IO thread. When queued work holds the last
+// reference, the deleter runs on that thread and must neither deadlock nor get lost.
+TEST(HostIOQueue, WorkReleasingQueueingReference)
+{
+  std::atomic<int> deleted(0);
+  for (int i = 0; i < 100; ++i)
+  {
+    std::shared_ptr<int> file(new int(i), [&deleted](int* ptr) {
+      HLE_IPC_QueueHostIO([&deleted, ptr] {
+        delete ptr;
+        deleted++;
+      });
+    });
+    HLE_IPC_QueueHostIO([file] {});
+  }
+  HLE_IPC_WaitForHostIO();
+  EXPECT_EQ(100, deleted.load());
+}
+
+TEST(HostIOQueue, QueueFromSeveralThreads)
+{
+  constexpr int THREADS = 4;
+  constexpr int ITEMS_PER_THREAD = 500;
+  std::atomic<int> done(0);
+  std::vector<std::vector<int>> order(THREADS);
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < THREADS; ++t)
+  {
+    producers.emplace_back([&done, &order, t] {
+      for (int i = 0; i < ITEMS_PER_THREAD; ++i)
+      {
+        // The queue runs one item at a time, so the vectors need no lock
+        HLE_IPC_QueueHostIO([&done, &order, t, i] {
+          order[t].push_back(i);
+          done++;
+        });
+      }
+    });
+  }
+  for (std::thread& producer : producers)
+    producer.join();
+  HLE_IPC_WaitForHostIO();
+
+  EXPECT_EQ(THREADS * ITEMS_PER_THREAD, done.load());
+  for (int t = 0; t < THREADS; ++t)
+  {
+    ASSERT_EQ(static_cast<size_t>(ITEMS_PER_THREAD), order[t].size());
+    for (int i = 0; i < ITEMS_PER_THREAD; ++i)
+      EXPECT_EQ(i, order[t][i]);
+  }
+}
@@ -0,0 +1,390 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Compares the vertex loader and texture decoder implementations against each other, at the
+// instruction set levels they pick paths for at runtime.
+//
+// Usage: VideoDecoderBenchmark [Dump/VertexLoaders/<game id>.txt]...
+// The vertex loader profiles written by VertexLoaderManager add the formats a game uses most to
+// the synthetic ones.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Timer.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VertexLoader.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexLoaderCompiled.h"
+#if defined(_M_X86_64)
+#include "VideoCommon/VertexLoaderX64.h"
+#elif defined(_M_ARM_64)
+#include "VideoCommon/VertexLoaderARM64.h"
+#endif
+
+static constexpr u64 MEASURE_TIME_US = 250000;
+static constexpr u32 VERTICES_PER_RUN = 32768;
+// Larger than any raw or native vertex
+static constexpr u32 MAX_VERTEX_SIZE = 512;
+static constexpr u32 ARRAY_STRIDE = 64;
+static constexpr u32 TEXTURE_SIZE = 1024;
+static constexpr size_t PROFILE_FORMATS = 10;
+
+struct IsaLevel
+{
+  const char* name;
+  bool ssse3;
+  bool avx2;
+};
+
+// Levels the host does not reach are skipped. SSSE3 includes SSE4.1, AVX2 includes AVX, BMI,
+// FMA and the other extensions of that generation.
+static const IsaLevel s_isa_levels[] = {
+    {"SSE2", false, false}, {"SSSE3", true, false}, {"AVX2", true, true},
+};
+
+static bool SetIsaLevel(const CPUInfo& host, const IsaLevel& level)
+{
+  if ((level.ssse3 && !(host.bSSSE3 && host.bSSE4_1)) || (level.avx2 && !(host.bAVX2 && host.bBMI2)))
+    return false;
+
+  cpu_info = host;
+  cpu_info.bSSSE3 = level.ssse3;
+  cpu_info.bSSE4_1 = level.ssse3;
+  cpu_info.bSSE4_2 &= level.ssse3;
+  cpu_info.bPOPCNT &= level.ssse3;
+  cpu_info.bAVX &= level.avx2;
+  cpu_info.bAVX2 = level.avx2;
+  cpu_info.bBMI1 &= level.avx2;
+  cpu_info.bBMI2 = level.avx2;
+  cpu_info.bFMA &= level.avx2;
+  cpu_info.bFMA4 = false;
+  cpu_info.bLZCNT &= level.avx2;
+  cpu_info.bMOVBE &= level.avx2;
+  return true;
+}
+
+// Returns processed items per second.
+static double Measure(const std::function<u32()>& run)
+{
+  run();
+  u64 items = 0;
+  const u64 start = Common::Timer::GetTimeUs();
+  u64 now;
+  do
+  {
+    items += run();
+    now = Common::Timer::GetTimeUs();
+  } while (now - start < MEASURE_TIME_US);
+  return items * 1000000.0 / (now - start);
+}
+
+static void FillRandom(u8* data, size_t size)
+{
+  std::minstd_rand rng(12345);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<u8>(rng());
+}
+
+struct VertexFormat
+{
+  std::string name;
+  TVtxDesc desc;
+  VAT vat;
+};
+
+static VertexFormat MakeFormat(const std::string& name)
+{
+  VertexFormat format;
+  format.name = name;
+  memset(&format.desc, 0, sizeof(format.desc));
+  memset(&format.vat, 0, sizeof(format.vat));
+  return format;
+}
+
+static std::vector<VertexFormat> GetSyntheticFormats()
+{
+  std::vector<VertexFormat> formats;
+
+  VertexFormat format = MakeFormat("pos dir f32 xyz");
+  format.desc.Position = DIRECT;
+  format.vat.g0.PosElements = 1;
+  format.vat.g0.PosFormat = FORMAT_FLOAT;
+  formats.push_back(format);
+
+  format = MakeFormat("pos dir s16 xyz, col0 dir 8888, tex0 dir s16 st");
+  format.desc.Position = DIRECT;
+  format.vat.g0.PosElements = 1;
+  format.vat.g0.PosFormat = FORMAT_SHORT;
+  format.vat.g0.PosFrac = 8;
+  format.desc.Color0 = DIRECT;
+  format.vat.g0.Color0Elements = 1;
+  format.vat.g0.Color0Comp = FORMAT_32B_8888;
+  format.desc.Tex0Coord = DIRECT;
+  format.vat.g0.Tex0CoordElements = 1;
+  format.vat.g0.Tex0CoordFormat = FORMAT_SHORT;
+  format.vat.g0.Tex0Frac = 10;
+  formats.push_back(format);
+
+  format = MakeFormat("pos i8 s16 xyz, nrm i8 s8, tex0 i8 u16 st");
+  format.desc.Position = INDEX8;
+  format.vat.g0.PosElements = 1;
+  format.vat.g0.PosFormat = FORMAT_SHORT;
+  format.desc.Normal = INDEX8;
+  format.vat.g0.NormalFormat = FORMAT_BYTE;
+  format.desc.Tex0Coord = INDEX8;
+  format.vat.g0.Tex0CoordElements = 1;
+  format.vat.g0.Tex0CoordFormat = FORMAT_USHORT;
+  formats.push_back(format);
+
+  format = MakeFormat("pos i16 f32 xyz, nrm i16 f32, col0 i16 8888, tex0 i16 f32 st");
+  format.desc.Position = INDEX16;
+  format.vat.g0.PosElements = 1;
+  format.vat.g0.PosFormat = FORMAT_FLOAT;
+  format.desc.Normal = INDEX16;
+  format.vat.g0.NormalFormat = FORMAT_FLOAT;
+  format.desc.Color0 = INDEX16;
+  format.vat.g0.Color0Elements = 1;
+  format.vat.g0.Color0Comp = FORMAT_32B_8888;
+  format.desc.Tex0Coord = INDEX16;
+  format.vat.g0.Tex0CoordElements = 1;
+  format.vat.g0.Tex0CoordFormat = FORMAT_FLOAT;
+  formats.push_back(format);
+
+  // Same as LargeFloatVertexSpeed in VertexLoaderTest
+  format = MakeFormat("all attributes i16 f32, matrix indices");
+  format.desc.Hex = 0x1FFFFFFFFull;
+  format.desc.Position = INDEX16;
+  format.desc.Normal = INDEX16;
+  format.desc.Color0 = INDEX16;
+  format.desc.Color1 = INDEX16;
+  format.desc.Tex0Coord = INDEX16;
+  format.desc.Tex1Coord = INDEX16;
+  format.desc.Tex2Coord = INDEX16;
+  format.desc.Tex3Coord = INDEX16;
+  format.desc.Tex4Coord = INDEX16;
+  format.desc.Tex5Coord = INDEX16;
+  format.desc.Tex6Coord = INDEX16;
+  format.desc.Tex7Coord = INDEX16;
+  format.vat.g0.PosElements = 1;
+  format.vat.g0.PosFormat = FORMAT_FLOAT;
+  format.vat.g0.NormalElements = 1;
+  format.vat.g0.NormalFormat = FORMAT_FLOAT;
+  format.vat.g0.Color0Elements = 1;
+  format.vat.g0.Color0Comp = FORMAT_32B_8888;
+  format.vat.g0.Color1Elements = 1;
+  format.vat.g0.Color1Comp = FORMAT_32B_8888;
+  format.vat.g0.Tex0CoordElements = 1;
+  format.vat.g0.Tex0CoordFormat = FORMAT_FLOAT;
+  format.vat.g1.Tex1CoordElements = 1;
+  format.vat.g1.Tex1CoordFormat = FORMAT_FLOAT;
+  format.vat.g1.Tex2CoordElements = 1;
+  format.vat.g1.Tex2CoordFormat = FORMAT_FLOAT;
+  format.vat.g1.Tex3CoordElements = 1;
+  format.vat.g1.Tex3CoordFormat = FORMAT_FLOAT;
+  format.vat.g1.Tex4CoordElements = 1;
+  format.vat.g1.Tex4CoordFormat = FORMAT_FLOAT;
+  format.vat.g2.Tex5CoordElements = 1;
+  format.vat.g2.Tex5CoordFormat = FORMAT_FLOAT;
+  format.vat.g2.Tex6CoordElements = 1;
+  format.vat.g2.Tex6CoordFormat = FORMAT_FLOAT;
+  format.vat.g2.Tex7CoordElements = 1;
+  format.vat.g2.Tex7CoordFormat = FORMAT_FLOAT;
+  formats.push_back(format);
+
+  return formats;
+}
+
+// Reverses VertexLoaderUID, the fractions are not part of it and stay 0.
+static std::vector<VertexFormat> LoadProfileFormats(const std::string& path)
+{
+  struct ProfileEntry
+  {
+    u32 vid[4];
+    u64 num_verts;
+    std::string name;
+  };
+  std::vector<ProfileEntry> entries;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream ss(line);
+    u64 hash;
+    ProfileEntry e;
+    ss >> hash >> std::hex >> e.vid[0] >> e.vid[1] >> e.vid[2] >> e.vid[3] >> std::dec >>
+        e.num_verts >> e.name;
+    if (!ss.fail())
+      entries.push_back(e);
+  }
+  if (entries.empty())
+    fprintf(stderr, "No vertex formats in %s\n", path.c_str());
+
+  std::sort(entries.begin(), entries.end(),
+            [](const ProfileEntry& a, const ProfileEntry& b) { return a.num_verts > b.num_verts; });
+  if (entries.size() > PROFILE_FORMATS)
+    entries.resize(PROFILE_FORMATS);
+
+  std::vector<VertexFormat> formats;
+  for (const ProfileEntry& e : entries)
+  {
+    VertexFormat format = MakeFormat(e.name);
+    format.desc.Hex = (static_cast<u64>(e.vid[0]) << 1) | (e.vid[2] >> 31);
+    format.vat.g0.Hex = e.vid[1];
+    format.vat.g1.Hex = e.vid[2] & 0x7FFFFFFFu;
+    format.vat.g2.Hex = e.vid[3];
+    formats.push_back(format);
+  }
+  return formats;
+}
+
+struct LoaderType
+{
+  const char* name;
+  bool uses_isa_level;
+  std::function<std::unique_ptr<VertexLoaderBase>(const TVtxDesc&, const VAT&)> create;
+};
+
+static std::vector<LoaderType> GetLoaderTypes()
+{
+  std::vector<LoaderType> types;
+  types.push_back({"Generic", false, [](const TVtxDesc& desc, const VAT& vat) {
+                     return std::unique_ptr<VertexLoaderBase>(std::make_unique<VertexLoader>(desc, vat));
+                   }});
+  // Precompiled loaders pick their instruction set once when they are registered
+  types.push_back({"Compiled", false, [](const TVtxDesc& desc, const VAT& vat) {
+                     return std::unique_ptr<VertexLoaderBase>(
+                         std::make_unique<VertexLoaderCompiled>(desc, vat));
+                   }});
+#if defined(_M_X86_64)
+  types.push_back({"X64", true, [](const TVtxDesc& desc, const VAT& vat) {
+                     return std::unique_ptr<VertexLoaderBase>(std::make_unique<VertexLoaderX64>(desc, vat));
+                   }});
+#elif defined(_M_ARM_64)
+  types.push_back({"ARM64", false, [](const TVtxDesc& desc, const VAT& vat) {
+                     return std::unique_ptr<VertexLoaderBase>(
+                         std::make_unique<VertexLoaderARM64>(desc, vat));
+                   }});
+#endif
+  return types;
+}
+
+static void BenchmarkVertexLoaders(const std::vector<VertexFormat>& formats, const CPUInfo& host)
+{
+  std::vector<u8> input(VERTICES_PER_RUN * MAX_VERTEX_SIZE);
+  std::vector<u8> output(VERTICES_PER_RUN * MAX_VERTEX_SIZE);
+  std::vector<u8> arrays(0x10000 * ARRAY_STRIDE);
+  FillRandom(input.data(), input.size());
+  FillRandom(arrays.data(), arrays.size());
+  for (int i = 0; i < 16; i++)
+  {
+    cached_arraybases[i] = arrays.data();
+    g_main_cp_state.array_strides[i] = ARRAY_STRIDE;
+  }
+
+  printf("%-64s %-9s %-6s %12s\n", "Vertex format", "Loader", "ISA", "Mvertices/s");
+  for (const VertexFormat& format : formats)
+  {
+    for (const LoaderType& type : GetLoaderTypes())
+    {
+      for (const IsaLevel& level : s_isa_levels)
+      {
+        if (!type.uses_isa_level && &level != &s_isa_levels[0])
+          break;
+        if (type.uses_isa_level && !SetIsaLevel(host, level))
+          continue;
+
+        std::unique_ptr<VertexLoaderBase> loader = type.create(format.desc, format.vat);
+        cpu_info = host;
+        if (!loader->IsInitialized() || !loader->EnvironmentIsSupported())
+        {
+          printf("%-64s %-9s %-6s %12s\n", format.name.c_str(), type.name, "-", "n/a");
+          continue;
+        }
+
+        VertexLoaderParameters parameters = {};
+        parameters.source = input.data();
+        parameters.destination = output.data();
+        parameters.VtxDesc = &format.desc;
+        parameters.VtxAttr = &format.vat;
+        parameters.buf_size = input.size();
+        parameters.primitive = 0;
+        parameters.count = VERTICES_PER_RUN;
+        const double rate = Measure([&] {
+          loader->RunVertices(parameters);
+          return VERTICES_PER_RUN;
+        });
+        printf("%-64s %-9s %-6s %12.1f\n", format.name.c_str(), type.name,
+               type.uses_isa_level ? level.name : "-", rate / 1000000.0);
+      }
+    }
+  }
+  cpu_info = host;
+}
+
+static void BenchmarkTextureDecoders(const CPUInfo& host)
+{
+  static const std::pair<u32, const char*> texture_formats[] = {
+      {GX_TF_I4, "I4"},         {GX_TF_I8, "I8"},       {GX_TF_IA4, "IA4"}, {GX_TF_IA8, "IA8"},
+      {GX_TF_RGB565, "RGB565"}, {GX_TF_RGB5A3, "RGB5A3"}, {GX_TF_RGBA8, "RGBA8"},
+      {GX_TF_C4, "C4"},         {GX_TF_C8, "C8"},       {GX_TF_C14X2, "C14X2"}, {GX_TF_CMPR, "CMPR"},
+  };
+
+  std::vector<u8> src(TexDecoder_GetTextureSizeInBytes(TEXTURE_SIZE, TEXTURE_SIZE, GX_TF_RGBA8));
+  std::vector<u8> dst(TEXTURE_SIZE * TEXTURE_SIZE * 4);
+  FillRandom(src.data(), src.size());
+  FillRandom(texMem, TMEM_SIZE);
+
+  printf("\n%-10s %-11s %-6s %12s\n", "Texture", "Decoder", "ISA", "Mtexels/s");
+  for (const auto& texture_format : texture_formats)
+  {
+    for (bool rgba_only : {false, true})
+    {
+      // The texture decoder only has SSE2 and SSSE3 paths
+      for (const IsaLevel& level : s_isa_levels)
+      {
+        if (level.avx2 || !SetIsaLevel(host, level))
+          continue;
+        const double rate = Measure([&] {
+          TexDecoder_Decode(dst.data(), src.data(), TEXTURE_SIZE, TEXTURE_SIZE, texture_format.first, 0,
+                            GX_TL_RGB5A3, rgba_only);
+          return TEXTURE_SIZE * TEXTURE_SIZE;
+        });
+        printf("%-10s %-11s %-6s %12.1f\n", texture_format.second, rgba_only ? "DecodeRGBA" : "Decode",
+               level.name, rate / 1000000.0);
+      }
+    }
+  }
+  cpu_info = host;
+}
+
+int main(int argc, char* argv[])
+{
+  const CPUInfo host = cpu_info;
+  printf("%s\n\n", cpu_info.Summarize().c_str());
+
+  std::vector<VertexFormat> formats = GetSyntheticFormats();
+  for (int i = 1; i < argc; i++)
+  {
+    std::vector<VertexFormat> profile_formats = LoadProfileFormats(argv[i]);
+    formats.insert(formats.end(), profile_formats.begin(), profile_formats.end());
+  }
+
+  BenchmarkVertexLoaders(formats, host);
+  BenchmarkTextureDecoders(host);
+  return 0;
+}
@@ -0,0 +1,174 @@
+#! /usr/bin/env python
+
+"""
+gen-vertex-loaders.py [--min-share PERCENT] [--max-loaders N] <profile...>
+
+Generates precompiled vertex loaders from vertex loader profiles.
+
+Profiles are written to Dump/VertexLoaders/<game id>.txt when the
+"DumpVertexLoader" graphics setting is enabled. Every line holds the loader
+hash, the four VertexLoaderUID words, the number of vertices loaded and the
+loader name. Counts from profiles of the same game are added together.
+
+For every game the most used loaders are emitted as
+Source/Core/VideoCommon/G_<game id>_pvt.{h,cpp}. Afterwards the registry
+header PrecompiledVertexLoaders.h and the VideoCommon build files, including
+the MSVC filters, are updated to cover every G_*_pvt.cpp present in the
+directory.
+"""
+
+import argparse
+import collections
+import glob
+import os
+import re
+
+VIDEOCOMMON = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'Source', 'Core', 'VideoCommon')
+
+LICENSE = '''// Copyright 2013 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+'''
+
+Loader = collections.namedtuple('Loader', ['conf', 'name'])
+
+
+def read_profiles(paths):
+    '''Returns {game_id: {hash: [Loader, num_verts]}}.'''
+    games = collections.defaultdict(dict)
+    for path in paths:
+        game_id = os.path.splitext(os.path.basename(path))[0]
+        with open(path) as f:
+            for line in f:
+                fields = line.split()
+                if not fields or fields[0].startswith('#') or len(fields) < 7:
+                    continue
+                h = int(fields[0])
+                conf = tuple(int(x, 16) for x in fields[1:5])
+                entry = games[game_id].setdefault(h, [Loader(conf, fields[6]), 0])
+                entry[1] += int(fields[5])
+    return games
+
+
+def select_loaders(loaders, min_share, max_loaders):
+    total = sum(n for _, n in loaders.values()) or 1
+    ordered = sorted(loaders.items(), key=lambda kv: kv[1][1], reverse=True)
+    selected = [(h, l, n) for h, (l, n) in ordered if n * 100.0 / total >= min_share]
+    return selected[:max_loaders]
+
+
+def write_game(game_id, selected):
+    cls = 'G_%s_pvt' % game_id
+    with open(os.path.join(VIDEOCOMMON, cls + '.h'), 'w') as f:
+        f.write(LICENSE)
+        f.write('// Generated by Tools/gen-vertex-loaders.py\n')
+        f.write('#pragma once\n#include <map>\n#include "VideoCommon/NativeVertexFormat.h"\n')
+        f.write('class %s\n{\npublic:\n' % cls)
+        f.write('\tstatic void Initialize(std::map<u64, TCompiledLoaderFunction> &pvlmap);\n};\n')
+    with open(os.path.join(VIDEOCOMMON, cls + '.cpp'), 'w') as f:
+        f.write(LICENSE + '\n')
+        f.write('#include "VideoCommon/%s.h"\n' % cls)
+        f.write('#include "VideoCommon/VertexLoader_Template.h"\n\n\n\n')
+        f.write('void %s::Initialize(std::map<u64, TCompiledLoaderFunction> &pvlmap)\n{\n' % cls)
+        for h, loader, num_verts in selected:
+            conf = ', '.join('0x%08xu' % c for c in loader.conf)
+            f.write('\t// %s\n// num_verts= %d\n' % (loader.name, num_verts))
+            f.write('#if _M_SSE >= 0x301\n\tif (cpu_info.bSSSE3)\n\t{\n')
+            f.write('\t\tpvlmap[%d] = TemplatedLoader<0x301, %s>;\n' % (h, conf))
+            f.write('\t}\n\telse\n#endif\n\t{\n')
+            f.write('\t\tpvlmap[%d] = TemplatedLoader<0, %s>;\n' % (h, conf))
+            f.write('\t}\n')
+        f.write('}\n')
+
+
+def write_registry(game_ids):
+    with open(os.path.join(VIDEOCOMMON, 'PrecompiledVertexLoaders.h'), 'w') as f:
+        f.write(LICENSE.replace('2013', '2017'))
+        f.write('// Generated by Tools/gen-vertex-loaders.py, do not edit by hand.\n\n')
+        f.write('#pragma once\n#include <map>\n#include "VideoCommon/NativeVertexFormat.h"\n\n')
+        for game_id in game_ids:
+            f.write('#include "VideoCommon/G_%s_pvt.h"\n' % game_id)
+        f.write('\ninline void RegisterPrecompiledVertexLoaders(std::map<u64, TCompiledLoaderFunction> &pvlmap)\n{\n')
+        for game_id in game_ids:
+            f.write('\tG_%s_pvt::Initialize(pvlmap);\n' % game_id)
+        f.write('}\n')
+
+
+def replace_block(text, pattern, make_line, game_ids):
+    '''Replaces the consecutive lines matching pattern with one line per game.'''
+    lines = text.split('\n')
+    matches = [i for i, l in enumerate(lines) if re.search(pattern, l)]
+    if not matches:
+        return text
+    first, last = matches[0], matches[-1]
+    template = lines[first]
+    new = [make_line(template, g) for g in game_ids]
+    return '\n'.join(lines[:first] + new + lines[last + 1:])
+
+
+def replace_filter_items(text, kind, ext, game_ids):
+    '''Replaces the filter items of the generated files with one item per game, in the place of
+    the first one. The items keep the filter and the layout of that one.'''
+    pattern = re.compile(r'([ \t]*)<%s Include="G_\w+_pvt\.%s">(\s*)<Filter>(.*?)</Filter>(\s*)</%s>(\r?\n)'
+                         % (kind, ext, kind))
+    matches = list(pattern.finditer(text))
+    if not matches:
+        return text
+    indent, inner, filter_name, outer, newline = matches[0].groups()
+    new = ''.join('%s<%s Include="G_%s_pvt.%s">%s<Filter>%s</Filter>%s</%s>%s'
+                  % (indent, kind, g, ext, inner, filter_name, outer, kind, newline) for g in game_ids)
+    start = matches[0].start()
+    text = pattern.sub('', text)
+    return text[:start] + new + text[start:]
+
+
+def update_build_files(game_ids):
+    path = os.path.join(VIDEOCOMMON, 'CMakeLists.txt')
+    with open(path) as f:
+        text = f.read()
+    text = replace_block(text, r'^\s*G_\w+_pvt\.cpp$',
+                         lambda t, g: re.sub(r'G_\w+_pvt', 'G_%s_pvt' % g, t), game_ids)
+    with open(path, 'w') as f:
+        f.write(text)
+
+    path = os.path.join(VIDEOCOMMON, 'VideoCommon.vcxproj')
+    with open(path, 'rb') as f:
+        data = f.read().decode('utf-8')
+    for ext in ('cpp', 'h'):
+        data = replace_block(data, r'<Cl\w+ Include="G_\w+_pvt\.%s" />' % ext,
+                             lambda t, g: re.sub(r'G_\w+_pvt', 'G_%s_pvt' % g, t), game_ids)
+    with open(path, 'wb') as f:
+        f.write(data.encode('utf-8'))
+
+    path = os.path.join(VIDEOCOMMON, 'VideoCommon.vcxproj.filters')
+    with open(path, 'rb') as f:
+        data = f.read().decode('utf-8')
+    data = replace_filter_items(data, 'ClCompile', 'cpp', game_ids)
+    data = replace_filter_items(data, 'ClInclude', 'h', game_ids)
+    with open(path, 'wb') as f:
+        f.write(data.encode('utf-8'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split('\n')[2])
+    parser.add_argument('--min-share', type=float, default=0.5,
+                        help='minimum share of the loaded vertices in percent (default 0.5)')
+    parser.add_argument('--max-loaders', type=int, default=64,
+                        help='maximum number of loaders per game (default 64)')
+    parser.add_argument('profiles', nargs='+')
+    args = parser.parse_args()
+
+    for game_id, loaders in sorted(read_profiles(args.profiles).items()):
+        selected = select_loaders(loaders, args.min_share, args.max_loaders)
+        if selected:
+            write_game(game_id, selected)
+            print('%s: %d loaders' % (game_id, len(selected)))
+
+    game_ids = sorted(re.match(r'G_(\w+)_pvt\.cpp', os.path.basename(p)).group(1)
+                      for p in glob.glob(os.path.join(VIDEOCOMMON, 'G_*_pvt.cpp')))
+    write_registry(game_ids)
+    update_build_files(game_ids)
+
+
+if __name__ == '__main__':
+    main()